@@ -26,16 +26,16 @@
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
-void aiger_encode(std::ostream &f, int x)
+void aiger_encode(std::vector<unsigned char> &buffer, int x)
 {
 	log_assert(x >= 0);
 
 	while (x & ~0x7f) {
-		f.put((x & 0x7f) | 0x80);
+		buffer.push_back((x & 0x7f) | 0x80);
 		x = x >> 7;
 	}
 
-	f.put(x);
+	buffer.push_back(x);
 }
 
 struct XAigerWriter
@@ -476,17 +476,28 @@ struct XAigerWriter
 		}
 		else
 		{
+			// Serializing through the ostream costs a virtual call per byte
+			// (or per line), which dominates write time on large AIGs.
+			// Instead, assemble each section in memory and write it in one go.
+			std::string output_lines;
+			char int_buffer[16];
+
 			for (int i = 0; i < aig_obc; i++)
-				f << stringf("%d\n", aig_outputs.at(i));
+				output_lines.append(int_buffer, snprintf(int_buffer, sizeof(int_buffer), "%d\n", aig_outputs.at(i)));
 
 			for (int i = aig_obc; i < aig_obcj; i++)
-				f << stringf("1\n");
+				output_lines += "1\n";
 
 			for (int i = aig_obc; i < aig_obcj; i++)
-				f << stringf("%d\n", aig_outputs.at(i));
+				output_lines.append(int_buffer, snprintf(int_buffer, sizeof(int_buffer), "%d\n", aig_outputs.at(i)));
 
 			for (int i = aig_obcj; i < aig_obcjf; i++)
-				f << stringf("%d\n", aig_outputs.at(i));
+				output_lines.append(int_buffer, snprintf(int_buffer, sizeof(int_buffer), "%d\n", aig_outputs.at(i)));
+
+			f.write(output_lines.data(), output_lines.size());
+
+			std::vector<unsigned char> gate_buffer;
+			gate_buffer.reserve(4*aig_a);
 
 			for (int i = 0; i < aig_a; i++) {
 				int lhs = 2*(aig_i+aig_l+i)+2;
@@ -494,9 +505,11 @@ struct XAigerWriter
 				int rhs1 = aig_gates.at(i).second;
 				int delta0 = lhs - rhs0;
 				int delta1 = rhs0 - rhs1;
-				aiger_encode(f, delta0);
-				aiger_encode(f, delta1);
+				aiger_encode(gate_buffer, delta0);
+				aiger_encode(gate_buffer, delta1);
 			}
+
+			f.write(reinterpret_cast<const char*>(gate_buffer.data()), gate_buffer.size());
 		}
 
 		f << "c";
@@ -508,8 +521,17 @@ struct XAigerWriter
 			};
 			buffer.write((char *) u32_be, sizeof(u32_be));
 		};
-		std::stringstream h_buffer;
-		auto write_h_buffer = std::bind(write_buffer, std::ref(h_buffer), std::placeholders::_1);
+		// the metadata extensions are assembled as packed in-memory tables
+		// and each written out with a single call
+		auto pack_u32 = [](std::string &buffer, unsigned int u32) {
+			typedef unsigned char uchar;
+			char u32_be[4] = {
+				(char) (uchar) (u32 >> 24), (char) (uchar) (u32 >> 16), (char) (uchar) (u32 >> 8), (char) (uchar) u32
+			};
+			buffer.append(u32_be, sizeof(u32_be));
+		};
+		std::string h_buffer;
+		auto write_h_buffer = std::bind(pack_u32, std::ref(h_buffer), std::placeholders::_1);
 		write_h_buffer(1);
 		log_debug("ciNum = %d\n", GetSize(input_bits) + GetSize(ff_list) + GetSize(ci_bits));
 		write_h_buffer(GetSize(input_bits) + GetSize(ff_list) + GetSize(ci_bits));
@@ -522,11 +544,11 @@ struct XAigerWriter
 		log_debug("boxNum = %d\n", GetSize(box_list));
 		write_h_buffer(GetSize(box_list));
 
-		auto write_buffer_float = [](std::stringstream &buffer, float f32) {
-			buffer.write(reinterpret_cast<const char*>(&f32), sizeof(f32));
+		auto pack_f32 = [](std::string &buffer, float f32) {
+			buffer.append(reinterpret_cast<const char*>(&f32), sizeof(f32));
 		};
-		std::stringstream i_buffer;
-		auto write_i_buffer = std::bind(write_buffer_float, std::ref(i_buffer), std::placeholders::_1);
+		std::string i_buffer;
+		auto write_i_buffer = std::bind(pack_f32, std::ref(i_buffer), std::placeholders::_1);
 		for (auto bit : input_bits)
 			write_i_buffer(arrival_times.at(bit, 0));
 		//std::stringstream o_buffer;
@@ -569,13 +591,13 @@ struct XAigerWriter
 				write_h_buffer(box_count++);
 			}
 
-			std::stringstream r_buffer;
-			auto write_r_buffer = std::bind(write_buffer, std::ref(r_buffer), std::placeholders::_1);
+			std::string r_buffer;
+			auto write_r_buffer = std::bind(pack_u32, std::ref(r_buffer), std::placeholders::_1);
 			log_debug("flopNum = %d\n", GetSize(ff_list));
 			write_r_buffer(ff_list.size());
 
-			std::stringstream s_buffer;
-			auto write_s_buffer = std::bind(write_buffer, std::ref(s_buffer), std::placeholders::_1);
+			std::string s_buffer;
+			auto write_s_buffer = std::bind(pack_u32, std::ref(s_buffer), std::placeholders::_1);
 			write_s_buffer(ff_list.size());
 
 			dict<SigSpec, int> clk_to_mergeability;
@@ -606,14 +628,12 @@ struct XAigerWriter
 			}
 
 			f << "r";
-			std::string buffer_str = r_buffer.str();
-			write_buffer(f, buffer_str.size());
-			f.write(buffer_str.data(), buffer_str.size());
+			write_buffer(f, r_buffer.size());
+			f.write(r_buffer.data(), r_buffer.size());
 
 			f << "s";
-			buffer_str = s_buffer.str();
-			write_buffer(f, buffer_str.size());
-			f.write(buffer_str.data(), buffer_str.size());
+			write_buffer(f, s_buffer.size());
+			f.write(s_buffer.data(), s_buffer.size());
 
 			RTLIL::Design *holes_design;
 			auto it = saved_designs.find("$abc9_holes");
@@ -635,14 +655,12 @@ struct XAigerWriter
 		}
 
 		f << "h";
-		std::string buffer_str = h_buffer.str();
-		write_buffer(f, buffer_str.size());
-		f.write(buffer_str.data(), buffer_str.size());
+		write_buffer(f, h_buffer.size());
+		f.write(h_buffer.data(), h_buffer.size());
 
 		f << "i";
-		buffer_str = i_buffer.str();
-		write_buffer(f, buffer_str.size());
-		f.write(buffer_str.data(), buffer_str.size());
+		write_buffer(f, i_buffer.size());
+		f.write(i_buffer.data(), i_buffer.size());
 		//f << "o";
 		//buffer_str = o_buffer.str();
 		//buffer_size_be = to_big_endian(buffer_str.size());
@@ -82,7 +82,7 @@ struct BtorWorker
 	dict<Cell*, Mem*> mem_cells;
 
 	string indent, info_filename;
-	vector<string> info_lines;
+	std::ofstream info_file;
 	dict<int, int> info_clocks;
 
 	struct ywmap_btor_sig {
@@ -113,7 +113,7 @@ struct BtorWorker
 	{
 		va_list ap;
 		va_start(ap, fmt);
-		info_lines.push_back(vstringf(fmt, ap));
+		info_file << vstringf(fmt, ap);
 		va_end(ap);
 	}
 
@@ -1129,8 +1129,9 @@ struct BtorWorker
 				nid = nid4;
 			}
 
+			// no nid_width entry for the nids of the slice-concat chain: only
+			// nids reachable through bit_nid or consts are ever sliced again
 			sig_nid[sig] = nid;
-			nid_width[nid] = width;
 		}
 
 		nid = sig_nid.at(sig);
@@ -1161,8 +1162,12 @@ struct BtorWorker
 	BtorWorker(std::ostream &f, RTLIL::Module *module, bool verbose, bool single_bad, bool cover_mode, bool print_internal_names, string info_filename, string ywmap_filename) :
 			f(f), sigmap(module), module(module), verbose(verbose), single_bad(single_bad), cover_mode(cover_mode), print_internal_names(print_internal_names), info_filename(info_filename)
 	{
-		if (!info_filename.empty())
+		if (!info_filename.empty()) {
+			info_file.open(info_filename.c_str(), std::ofstream::trunc);
+			if (info_file.fail())
+				log_error("Can't open file `%s' for writing: %s\n", info_filename.c_str(), strerror(errno));
 			infof("name %s\n", log_id(module));
+		}
 
 		if (!ywmap_filename.empty())
 			ywmap_json.write_to_file(ywmap_filename);
@@ -1481,13 +1486,7 @@ struct BtorWorker
 				}
 			}
 
-			std::ofstream f;
-			f.open(info_filename.c_str(), std::ofstream::trunc);
-			if (f.fail())
-				log_error("Can't open file `%s' for writing: %s\n", info_filename.c_str(), strerror(errno));
-			for (auto &it : info_lines)
-				f << it;
-			f.close();
+			info_file.close();
 		}
 
 		if (ywmap_json.active())
@@ -714,11 +714,13 @@ bool is_valid_clock(const RTLIL::SigSpec& sig) {
 
 struct CxxrtlWorker {
 	bool split_intf = false;
+	int split_parts = 0;
 	std::string intf_filename;
 	std::string design_ns = "cxxrtl_design";
 	std::string print_output = "std::cout";
 	std::ostream *impl_f = nullptr;
 	std::ostream *intf_f = nullptr;
+	std::vector<std::ostream*> part_fs;
 
 	bool print_wire_types = false;
 	bool print_debug_wire_types = false;
@@ -738,6 +740,8 @@ struct CxxrtlWorker {
 	bool debug_alias = false;
 	bool debug_eval = false;
 
+	bool threads = false;
+
 	std::ostringstream f;
 	std::string indent;
 	int temporary = 0;
@@ -753,6 +757,8 @@ struct CxxrtlWorker {
 	dict<RTLIL::SigBit, bool> bit_has_state;
 	dict<const RTLIL::Module*, pool<std::string>> blackbox_specializations;
 	dict<const RTLIL::Module*, bool> eval_converges;
+	dict<const RTLIL::Module*, std::vector<int>> schedule_batch;
+	dict<const RTLIL::Module*, bool> uses_thread_pool;
 
 	void inc_indent() {
 		indent += "\t";
@@ -2164,6 +2170,65 @@ struct CxxrtlWorker {
 		dec_indent();
 	}
 
+	void dump_eval_node(FlowGraph::Node &node)
+	{
+		switch (node.type) {
+			case FlowGraph::Node::Type::CONNECT:
+				dump_connect(node.connect);
+				break;
+			case FlowGraph::Node::Type::CELL_SYNC:
+				dump_cell_sync(node.cell);
+				break;
+			case FlowGraph::Node::Type::CELL_EVAL:
+				dump_cell_eval(node.cell);
+				break;
+			case FlowGraph::Node::Type::EFFECT_SYNC:
+				dump_cell_effect_sync(node.cells);
+				break;
+			case FlowGraph::Node::Type::PROCESS_CASE:
+				dump_process_case(node.process);
+				break;
+			case FlowGraph::Node::Type::PROCESS_SYNC:
+				dump_process_syncs(node.process);
+				break;
+			case FlowGraph::Node::Type::MEM_RDPORT:
+				dump_mem_rdport(node.mem, node.portidx);
+				break;
+			case FlowGraph::Node::Type::MEM_WRPORTS:
+				dump_mem_wrports(node.mem);
+				break;
+		}
+	}
+
+	void dump_eval_batch(RTLIL::Module *module, size_t batch_begin, size_t batch_end)
+	{
+		std::vector<FlowGraph::Node> &nodes = schedule[module];
+		f << indent << "// " << (batch_end - batch_begin) << " mutually independent nodes evaluated on the thread pool\n";
+		f << indent << "{\n";
+		inc_indent();
+			f << indent << "std::atomic<bool> batch_converged(converged);\n";
+			f << indent << "pool.run(" << (batch_end - batch_begin) << ", [&](size_t task_index) {\n";
+			inc_indent();
+				// shadows the `converged` local of eval(); merged into the shared flag below
+				f << indent << "bool converged = true;\n";
+				f << indent << "switch (task_index) {\n";
+				for (size_t index = batch_begin; index < batch_end; index++) {
+					f << indent << "case " << (index - batch_begin) << ": {\n";
+					inc_indent();
+						dump_eval_node(nodes[index]);
+					dec_indent();
+					f << indent << "} break;\n";
+				}
+				f << indent << "}\n";
+				f << indent << "if (!converged)\n";
+				f << indent << "\tbatch_converged.store(false, std::memory_order_relaxed);\n";
+			dec_indent();
+			f << indent << "});\n";
+			f << indent << "converged = batch_converged.load(std::memory_order_relaxed);\n";
+		dec_indent();
+		f << indent << "}\n";
+	}
+
 	void dump_eval_method(RTLIL::Module *module)
 	{
 		inc_indent();
@@ -2187,33 +2252,20 @@ struct CxxrtlWorker {
 				}
 				for (auto wire : module->wires())
 					dump_wire(wire, /*is_local=*/true);
-				for (auto node : schedule[module]) {
-					switch (node.type) {
-						case FlowGraph::Node::Type::CONNECT:
-							dump_connect(node.connect);
-							break;
-						case FlowGraph::Node::Type::CELL_SYNC:
-							dump_cell_sync(node.cell);
-							break;
-						case FlowGraph::Node::Type::CELL_EVAL:
-							dump_cell_eval(node.cell);
-							break;
-						case FlowGraph::Node::Type::EFFECT_SYNC:
-							dump_cell_effect_sync(node.cells);
-							break;
-						case FlowGraph::Node::Type::PROCESS_CASE:
-							dump_process_case(node.process);
-							break;
-						case FlowGraph::Node::Type::PROCESS_SYNC:
-							dump_process_syncs(node.process);
-							break;
-						case FlowGraph::Node::Type::MEM_RDPORT:
-							dump_mem_rdport(node.mem, node.portidx);
-							break;
-						case FlowGraph::Node::Type::MEM_WRPORTS:
-							dump_mem_wrports(node.mem);
-							break;
+				std::vector<FlowGraph::Node> &nodes = schedule[module];
+				std::vector<int> &batch_ids = schedule_batch[module];
+				for (size_t index = 0; index < nodes.size();) {
+					int batch_id = index < batch_ids.size() ? batch_ids[index] : -1;
+					if (batch_id < 0) {
+						dump_eval_node(nodes[index]);
+						index++;
+						continue;
 					}
+					size_t batch_end = index;
+					while (batch_end < nodes.size() && batch_ids[batch_end] == batch_id)
+						batch_end++;
+					dump_eval_batch(module, index, batch_end);
+					index = batch_end;
 				}
 			}
 			f << indent << "return converged;\n";
@@ -2700,6 +2752,10 @@ struct CxxrtlWorker {
 				}
 				if (has_cells)
 					f << "\n";
+				if (uses_thread_pool.count(module)) {
+					f << indent << "thread_pool pool;\n";
+					f << "\n";
+				}
 				f << indent << mangle(module) << "(interior) {}\n";
 				f << indent << mangle(module) << "() {\n";
 				inc_indent();
@@ -2825,6 +2881,8 @@ struct CxxrtlWorker {
 			f << "#ifdef __cplusplus\n";
 			f << "\n";
 			f << "#include <cxxrtl/cxxrtl.h>\n";
+			if (!uses_thread_pool.empty())
+				f << "#include <cxxrtl/cxxrtl_threads.h>\n";
 			f << "\n";
 			f << "using namespace cxxrtl;\n";
 			f << "\n";
@@ -2840,10 +2898,36 @@ struct CxxrtlWorker {
 			*intf_f << f.str(); f.str("");
 		}
 
-		if (split_intf)
+		// Shard module implementations into separate translation units so that the C++ compiler can be run
+		// on them in parallel and uses less memory per process. Modules are distributed to the least loaded
+		// part, most expensive first; scheduled node count is a good proxy for the amount of generated code.
+		std::vector<std::string> part_impls(split_parts);
+		if (split_parts > 0) {
+			log_assert(split_intf);
+			std::vector<RTLIL::Module*> impl_modules;
+			for (auto module : modules)
+				if (!module->get_bool_attribute(ID(cxxrtl_blackbox)))
+					impl_modules.push_back(module);
+			std::stable_sort(impl_modules.begin(), impl_modules.end(),
+				[&](RTLIL::Module *a, RTLIL::Module *b) {
+					return schedule[a].size() > schedule[b].size();
+				});
+			std::vector<size_t> part_costs(split_parts, 0);
+			for (auto module : impl_modules) {
+				size_t part = std::min_element(part_costs.begin(), part_costs.end()) - part_costs.begin();
+				dump_module_impl(module);
+				part_impls[part] += f.str(); f.str("");
+				part_costs[part] += schedule[module].size() + 1;
+			}
+		}
+
+		if (split_intf) {
 			f << "#include \"" << basename(intf_filename) << "\"\n";
-		else
+		} else {
 			f << "#include <cxxrtl/cxxrtl.h>\n";
+			if (!uses_thread_pool.empty())
+				f << "#include <cxxrtl/cxxrtl_threads.h>\n";
+		}
 		f << "\n";
 		f << "#if defined(CXXRTL_INCLUDE_CAPI_IMPL) || \\\n";
 		f << "    defined(CXXRTL_INCLUDE_VCD_CAPI_IMPL)\n";
@@ -2861,7 +2945,8 @@ struct CxxrtlWorker {
 		for (auto module : modules) {
 			if (!split_intf)
 				dump_module_intf(module);
-			dump_module_impl(module);
+			if (split_parts == 0)
+				dump_module_impl(module);
 		}
 		f << "} // namespace " << design_ns << "\n";
 		f << "\n";
@@ -2878,6 +2963,18 @@ struct CxxrtlWorker {
 		}
 
 		*impl_f << f.str(); f.str("");
+
+		for (int part = 0; part < split_parts; part++) {
+			f << "#include \"" << basename(intf_filename) << "\"\n";
+			f << "\n";
+			f << "using namespace cxxrtl_yosys;\n";
+			f << "\n";
+			f << "namespace " << design_ns << " {\n";
+			f << "\n";
+			f << part_impls[part];
+			f << "} // namespace " << design_ns << "\n";
+			*part_fs[part] << f.str(); f.str("");
+		}
 	}
 
 	// Edge-type sync rules require us to emit edge detectors, which require coordination between
@@ -2905,6 +3002,102 @@ struct CxxrtlWorker {
 		edge_wires.insert(sigbit.wire);
 	}
 
+	// Minimum size for a batch of independent nodes to be dispatched to the thread pool. Forking and joining has
+	// a fixed cost per batch, so narrow batches are better off evaluated serially.
+	static const int MIN_BATCH_SIZE = 32;
+
+	bool is_parallelizable_node(const FlowGraph::Node *node)
+	{
+		// Only plain combinatorial and synchronous logic is evaluated in parallel. Everything with externally
+		// observable behavior (effectful cells, submodule and black box evaluation), memory ports (ports of
+		// the same memory share the memory object), and processes stays on the calling thread, in schedule order.
+		switch (node->type) {
+			case FlowGraph::Node::Type::CONNECT:
+				return true;
+			case FlowGraph::Node::Type::CELL_EVAL:
+				return is_internal_cell(node->cell->type) && !is_effectful_cell(node->cell->type);
+			default:
+				return false;
+		}
+	}
+
+	// Group runs of consecutive, mutually independent, parallelizable scheduled nodes into batches that eval()
+	// dispatches to the thread pool. Two nodes are independent if neither reads or writes a wire the other one
+	// writes; `value<>` writes are chunked, so even writes to disjoint bits of the same wire conflict.
+	void compute_schedule_batches(RTLIL::Module *module, FlowGraph &flow, const std::vector<FlowGraph::Node*> &nodes)
+	{
+		// An inlined wire is computed as a part of every use, so a node using it also reads everything that
+		// the (no longer scheduled) defining node read; collect reads transitively through inlined wires.
+		auto collect_reads = [&](FlowGraph::Node *node, pool<const RTLIL::Wire*> &reads) {
+			std::vector<const RTLIL::Wire*> worklist(flow.node_uses[node].begin(), flow.node_uses[node].end());
+			while (!worklist.empty()) {
+				const RTLIL::Wire *wire = worklist.back();
+				worklist.pop_back();
+				if (reads.count(wire))
+					continue;
+				reads.insert(wire);
+				if (wire_types[wire].type == WireType::INLINE)
+					for (auto def_node : flow.wire_comb_defs[wire])
+						for (auto use_wire : flow.node_uses[def_node])
+							worklist.push_back(use_wire);
+			}
+		};
+
+		std::vector<int> &batch_ids = schedule_batch[module];
+		batch_ids.assign(nodes.size(), -1);
+
+		int batch_id = 0;
+		size_t batch_begin = 0;
+		pool<const RTLIL::Wire*> batch_reads, batch_writes;
+		auto flush_batch = [&](size_t batch_end) {
+			if ((int)(batch_end - batch_begin) < MIN_BATCH_SIZE) {
+				for (size_t i = batch_begin; i < batch_end; i++)
+					batch_ids[i] = -1;
+			} else {
+				uses_thread_pool[module] = true;
+				batch_id++;
+			}
+			batch_begin = batch_end;
+			batch_reads.clear();
+			batch_writes.clear();
+		};
+
+		for (size_t i = 0; i < nodes.size(); i++) {
+			FlowGraph::Node *node = nodes[i];
+			if (!is_parallelizable_node(node)) {
+				flush_batch(i);
+				batch_begin = i + 1;
+				continue;
+			}
+			pool<const RTLIL::Wire*> reads, writes;
+			collect_reads(node, reads);
+			for (auto wire : flow.node_comb_defs[node])
+				writes.insert(wire);
+			for (auto wire : flow.node_sync_defs[node])
+				writes.insert(wire);
+			bool conflict = false;
+			for (auto wire : reads)
+				if (batch_writes.count(wire)) {
+					conflict = true;
+					break;
+				}
+			if (!conflict)
+				for (auto wire : writes)
+					if (batch_writes.count(wire) || batch_reads.count(wire)) {
+						conflict = true;
+						break;
+					}
+			if (conflict)
+				flush_batch(i);
+			batch_ids[i] = batch_id;
+			for (auto wire : reads)
+				batch_reads.insert(wire);
+			for (auto wire : writes)
+				batch_writes.insert(wire);
+		}
+		flush_batch(nodes.size());
+	}
+
 	void analyze_design(RTLIL::Design *design)
 	{
 		bool has_feedback_arcs = false;
@@ -3205,6 +3398,7 @@ struct CxxrtlWorker {
 			// Emit reachable nodes in eval().
 			// Accumulate sync effectful cells per trigger condition.
 			dict<std::pair<RTLIL::SigSpec, RTLIL::Const>, std::vector<const RTLIL::Cell*>> effect_sync_cells;
+			std::vector<FlowGraph::Node*> scheduled_nodes;
 			for (auto node : node_order)
 				if (live_nodes[node]) {
 					if (node->type == FlowGraph::Node::Type::CELL_EVAL &&
@@ -3212,15 +3406,21 @@ struct CxxrtlWorker {
 							node->cell->getParam(ID::TRG_ENABLE).as_bool() &&
 							node->cell->getParam(ID::TRG_WIDTH).as_int() != 0)
 						effect_sync_cells[make_pair(node->cell->getPort(ID::TRG), node->cell->getParam(ID::TRG_POLARITY))].push_back(node->cell);
-					else
+					else {
 						schedule[module].push_back(*node);
+						scheduled_nodes.push_back(node);
+					}
 				}
 
 			for (auto &it : effect_sync_cells) {
 				auto node = flow.add_effect_sync_node(it.second);
 				schedule[module].push_back(*node);
+				scheduled_nodes.push_back(node);
 			}
 
+			if (threads)
+				compute_schedule_batches(module, flow, scheduled_nodes);
+
 			// For maximum performance, the state of the simulation (which is the same as the set of its double buffered
 			// wires, since using a singly buffered wire for any kind of state introduces a race condition) should contain
 			// no wires attached to combinatorial outputs. Feedback wires, by definition, make that impossible. However,
@@ -3636,6 +3836,15 @@ struct CxxrtlBackend : public Backend {
 		log("        of the interface is derived from filename of the implementation.\n");
 		log("        otherwise, interface and implementation are generated together.\n");
 		log("\n");
+		log("    -parts <n>\n");
+		log("        split the implementation into <n> .cc files along module boundaries, so\n");
+		log("        that the C++ compiler can be run on them in parallel and uses less\n");
+		log("        memory per process. requires the -header option. the part files are\n");
+		log("        named by appending `_<index>.cc' to the implementation filename stem,\n");
+		log("        and all of them must be compiled and linked together with the main\n");
+		log("        file. most effective together with -noflatten, which preserves module\n");
+		log("        boundaries in the generated code.\n");
+		log("\n");
 		log("    -namespace <ns-name>\n");
 		log("        place the generated code into namespace <ns-name>. if not specified,\n");
 		log("        \"cxxrtl_design\" is used.\n");
@@ -3645,6 +3854,15 @@ struct CxxrtlBackend : public Backend {
 		log("        must be one of \"std::cout\", \"std::cerr\". if not specified,\n");
 		log("        \"std::cout\" is used. explicitly provided performer overrides this.\n");
 		log("\n");
+		log("    -threads\n");
+		log("        generate a multithreaded simulation. batches of mutually independent\n");
+		log("        netlist nodes are evaluated in parallel on a persistent worker pool\n");
+		log("        sized after the machine (can be overridden with the CXXRTL_THREADS\n");
+		log("        environment variable). effectful cells, memory ports, and submodules\n");
+		log("        are always evaluated on the calling thread, in schedule order. this\n");
+		log("        helps large flattened designs; small designs are usually faster\n");
+		log("        single-threaded.\n");
+		log("\n");
 		log("    -nohierarchy\n");
 		log("        use design hierarchy as-is. in most designs, a top module should be\n");
 		log("        present as it is exposed through the C API and has unbuffered outputs\n");
@@ -3779,10 +3997,20 @@ struct CxxrtlBackend : public Backend {
 				worker.split_intf = true;
 				continue;
 			}
+			if (args[argidx] == "-parts" && argidx+1 < args.size()) {
+				worker.split_parts = std::stoi(args[++argidx]);
+				if (worker.split_parts < 1)
+					log_cmd_error("Invalid number of parts %d.\n", worker.split_parts);
+				continue;
+			}
 			if (args[argidx] == "-namespace" && argidx+1 < args.size()) {
 				worker.design_ns = args[++argidx];
 				continue;
 			}
+			if (args[argidx] == "-threads") {
+				worker.threads = true;
+				continue;
+			}
 			if (args[argidx] == "-print-output" && argidx+1 < args.size()) {
 				worker.print_output = args[++argidx];
 				if (!(worker.print_output == "std::cout" || worker.print_output == "std::cerr")) {
@@ -3858,6 +4086,23 @@ struct CxxrtlBackend : public Backend {
 
 			worker.intf_f = &intf_f;
 		}
+
+		std::vector<std::ofstream> part_files;
+		if (worker.split_parts > 0) {
+			if (!worker.split_intf)
+				log_cmd_error("Option -parts must be used together with -header.\n");
+
+			std::string stem = filename.substr(0, filename.rfind('.'));
+			part_files.resize(worker.split_parts);
+			for (int part = 0; part < worker.split_parts; part++) {
+				std::string part_filename = stem + "_" + std::to_string(part) + ".cc";
+				part_files[part].open(part_filename, std::ofstream::trunc);
+				if (part_files[part].fail())
+					log_cmd_error("Can't open file `%s' for writing: %s\n",
+					              part_filename.c_str(), strerror(errno));
+				worker.part_fs.push_back(&part_files[part]);
+			}
+		}
 		worker.impl_f = f;
 
 		worker.prepare_design(design);
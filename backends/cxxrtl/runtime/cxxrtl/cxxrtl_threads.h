@@ -0,0 +1,147 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2024  Yosys developers
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef CXXRTL_THREADS_H
+#define CXXRTL_THREADS_H
+
+#include <cstdlib>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cxxrtl {
+
+// A persistent fork/join worker pool used by code generated with `write_cxxrtl -threads`. The eval() function of
+// a design partitioned by the backend dispatches batches of mutually independent netlist nodes through run(), which
+// divides them between the pool threads and the calling thread and returns once every node has been evaluated.
+//
+// The pool is deliberately minimal: tasks must not throw (an exception escaping a task terminates the simulation,
+// same as an exception escaping a thread), and run() must not be called reentrantly or concurrently from several
+// threads. Both restrictions are satisfied by construction in the generated code.
+class thread_pool {
+public:
+	// The thread count can be overridden with the CXXRTL_THREADS environment variable, which is useful to pin down
+	// nondeterminism or to share a machine between several simulations. The calling thread is counted, so a pool
+	// of size 1 spawns no threads and runs every task inline.
+	static size_t default_thread_count() {
+		if (const char *env = getenv("CXXRTL_THREADS")) {
+			long count = strtol(env, nullptr, 10);
+			if (count > 0)
+				return (size_t)count;
+		}
+		size_t count = std::thread::hardware_concurrency();
+		return count > 0 ? count : 1;
+	}
+
+	explicit thread_pool(size_t thread_count = default_thread_count()) {
+		for (size_t index = 1; index < thread_count; index++)
+			workers.emplace_back([this, index] { worker_thread(index); });
+	}
+
+	thread_pool(const thread_pool &) = delete;
+	thread_pool &operator=(const thread_pool &) = delete;
+
+	~thread_pool() {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			stop = true;
+		}
+		start_cond.notify_all();
+		for (auto &worker : workers)
+			worker.join();
+	}
+
+	size_t thread_count() const {
+		return workers.size() + 1;
+	}
+
+	// Runs `task(index)` for every index in [0, count), partitioned into contiguous ranges, one per thread, and
+	// returns once all invocations completed. The calling thread evaluates the first range itself, so small counts
+	// and pools of size 1 degenerate to a plain loop.
+	void run(size_t count, const std::function<void(size_t)> &task) {
+		if (count == 0)
+			return;
+		if (workers.empty() || count == 1) {
+			for (size_t index = 0; index < count; index++)
+				task(index);
+			return;
+		}
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			current_task = &task;
+			current_count = count;
+			active = workers.size();
+			generation++;
+		}
+		start_cond.notify_all();
+		run_range(0, count, task);
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			done_cond.wait(lock, [this] { return active == 0; });
+			current_task = nullptr;
+		}
+	}
+
+private:
+	void run_range(size_t slot, size_t count, const std::function<void(size_t)> &task) {
+		size_t begin = count * slot / thread_count();
+		size_t end = count * (slot + 1) / thread_count();
+		for (size_t index = begin; index < end; index++)
+			task(index);
+	}
+
+	void worker_thread(size_t slot) {
+		size_t seen_generation = 0;
+		while (true) {
+			const std::function<void(size_t)> *task;
+			size_t count;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				start_cond.wait(lock, [&] { return stop || generation != seen_generation; });
+				if (stop)
+					return;
+				seen_generation = generation;
+				task = current_task;
+				count = current_count;
+			}
+			run_range(slot, count, *task);
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				if (--active == 0)
+					done_cond.notify_one();
+			}
+		}
+	}
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable start_cond;
+	std::condition_variable done_cond;
+	const std::function<void(size_t)> *current_task = nullptr;
+	size_t current_count = 0;
+	size_t active = 0;
+	size_t generation = 0;
+	bool stop = false;
+};
+
+} // namespace cxxrtl
+
+#endif
@@ -25,6 +25,7 @@
 #include "kernel/sigtools.h"
 #include "kernel/celltypes.h"
 #include "kernel/log.h"
+#include <algorithm>
 #include <string>
 
 USING_YOSYS_NAMESPACE
@@ -356,7 +357,12 @@ struct EdifBackend : public Backend {
 				continue;
 
 			SigMap sigmap(module);
-			std::map<RTLIL::SigSpec, std::set<std::pair<std::string, bool>>> net_join_db;
+
+			// flat list of (net bit, (port reference, is_output)) entries, sorted
+			// once after all references are collected. Appending to the vector is
+			// much cheaper than the tree inserts of a map of sets, and sorting by
+			// SigBit groups the references per net for emission.
+			std::vector<std::pair<RTLIL::SigBit, std::pair<std::string, bool>>> net_refs;
 
 			*f << stringf("    (cell %s\n", EDIF_DEF(module->name));
 			*f << stringf("      (cellType GENERIC)\n");
@@ -442,8 +448,8 @@ struct EdifBackend : public Backend {
 						for (auto &p : wire->attributes)
 							add_prop(p.first, p.second);
 					*f << ")\n";
-					RTLIL::SigSpec sig = sigmap(RTLIL::SigSpec(wire));
-					net_join_db[sig].insert(make_pair(stringf("(portRef %s)", EDIF_REF(wire->name)), wire->port_input));
+					RTLIL::SigBit sig = sigmap(RTLIL::SigBit(wire));
+					net_refs.push_back(make_pair(sig, make_pair(stringf("(portRef %s)", EDIF_REF(wire->name)), wire->port_input)));
 				} else {
 					int b[2];
 					b[wire->upto ? 0 : 1] = wire->start_offset;
@@ -455,8 +461,8 @@ struct EdifBackend : public Backend {
 
 					*f << ")\n";
 					for (int i = 0; i < wire->width; i++) {
-						RTLIL::SigSpec sig = sigmap(RTLIL::SigSpec(wire, i));
-						net_join_db[sig].insert(make_pair(stringf("(portRef (member %s %d))", EDIF_REF(wire->name), lsbidx ? i : GetSize(wire)-i-1), wire->port_input));
+						RTLIL::SigBit sig = sigmap(RTLIL::SigBit(wire, i));
+						net_refs.push_back(make_pair(sig, make_pair(stringf("(portRef (member %s %d))", EDIF_REF(wire->name), lsbidx ? i : GetSize(wire)-i-1), wire->port_input)));
 					}
 				}
 			}
@@ -498,27 +504,44 @@ struct EdifBackend : public Backend {
 								}
 							}
 							if (width == 1)
-								net_join_db[sig[i]].insert(make_pair(stringf("(portRef %s (instanceRef %s))", EDIF_REF(p.first), EDIF_REF(cell->name)), cell->output(p.first)));
+								net_refs.push_back(make_pair(sig[i], make_pair(stringf("(portRef %s (instanceRef %s))", EDIF_REF(p.first), EDIF_REF(cell->name)), cell->output(p.first))));
 							else {
-								net_join_db[sig[i]].insert(make_pair(stringf("(portRef (member %s %d) (instanceRef %s))",
-										EDIF_REF(p.first), member_idx, EDIF_REF(cell->name)), cell->output(p.first)));
+								net_refs.push_back(make_pair(sig[i], make_pair(stringf("(portRef (member %s %d) (instanceRef %s))",
+										EDIF_REF(p.first), member_idx, EDIF_REF(cell->name)), cell->output(p.first))));
 							}
 						}
 				}
 			}
 
-			for (auto &it : net_join_db) {
-				RTLIL::SigBit sig = it.first;
+			std::sort(net_refs.begin(), net_refs.end());
+			net_refs.erase(std::unique(net_refs.begin(), net_refs.end()), net_refs.end());
+
+			// returns the first entry for the given net bit (or net_refs.end())
+			auto net_refs_find = [&](const RTLIL::SigBit &bit) {
+				auto it = std::lower_bound(net_refs.begin(), net_refs.end(), bit,
+						[](const std::pair<RTLIL::SigBit, std::pair<std::string, bool>> &entry, const RTLIL::SigBit &b) { return entry.first < b; });
+				if (it != net_refs.end() && it->first != bit)
+					it = net_refs.end();
+				return it;
+			};
+
+			for (auto net_begin = net_refs.begin(); net_begin != net_refs.end();) {
+				auto net_end = net_begin;
+				while (net_end != net_refs.end() && net_end->first == net_begin->first)
+					++net_end;
+
+				RTLIL::SigBit sig = net_begin->first;
 				if (sig.wire == NULL && sig != RTLIL::State::S0 && sig != RTLIL::State::S1) {
 					if (sig == RTLIL::State::Sx) {
-						for (auto &ref : it.second)
-							log_warning("Exporting x-bit on %s as zero bit.\n", ref.first.c_str());
+						for (auto it = net_begin; it != net_end; ++it)
+							log_warning("Exporting x-bit on %s as zero bit.\n", it->second.first.c_str());
 						sig = RTLIL::State::S0;
 					} else if (sig == RTLIL::State::Sz) {
+						net_begin = net_end;
 						continue;
 					} else {
-						for (auto &ref : it.second)
-							log_error("Don't know how to handle %s on %s.\n", log_signal(sig), ref.first.c_str());
+						for (auto it = net_begin; it != net_end; ++it)
+							log_error("Don't know how to handle %s on %s.\n", log_signal(sig), it->second.first.c_str());
 						log_abort();
 					}
 				}
@@ -534,8 +557,8 @@ struct EdifBackend : public Backend {
 							netname.erase(netname.begin() + i--);
 				}
 				*f << stringf("          (net %s (joined\n", EDIF_DEF(netname));
-				for (auto &ref : it.second)
-					*f << stringf("              %s\n", ref.first.c_str());
+				for (auto it = net_begin; it != net_end; ++it)
+					*f << stringf("              %s\n", it->second.first.c_str());
 				if (sig.wire == NULL) {
 					if (nogndvcc)
 						log_error("Design contains constant nodes (map with \"hilomap\" first).\n");
@@ -549,6 +572,8 @@ struct EdifBackend : public Backend {
 					for (auto &p : sig.wire->attributes)
 						add_prop(p.first, p.second);
 				*f << stringf("\n          )\n");
+
+				net_begin = net_end;
 			}
 
 			for (auto wire : module->wires())
@@ -561,7 +586,11 @@ struct EdifBackend : public Backend {
 					SigBit raw_sig = RTLIL::SigSpec(wire, i);
 					SigBit mapped_sig = sigmap(raw_sig);
 
-					if (raw_sig == mapped_sig || net_join_db.count(mapped_sig) == 0)
+					if (raw_sig == mapped_sig)
+						continue;
+
+					auto refs_begin = net_refs_find(mapped_sig);
+					if (refs_begin == net_refs.end())
 						continue;
 
 					std::string netname = log_signal(raw_sig);
@@ -573,10 +602,9 @@ struct EdifBackend : public Backend {
 					{
 						*f << stringf("          (net %s (joined\n", EDIF_DEF(netname));
 
-						auto &refs = net_join_db.at(mapped_sig);
-						for (auto &ref : refs)
-							if (ref.second)
-								*f << stringf("              %s\n", ref.first.c_str());
+						for (auto it = refs_begin; it != net_refs.end() && it->first == mapped_sig; ++it)
+							if (it->second.second)
+								*f << stringf("              %s\n", it->second.first.c_str());
 						*f << stringf("            )");
 
 						if (attr_properties && raw_sig.wire != NULL)
@@ -225,10 +225,37 @@ struct CxxModule {
 		locals.reserve("next_state");
 		auto node_name = [&](Functional::Node n) { return locals(n.id(), n.name()); };
 		CxxPrintVisitor printVisitor(f, node_name, input_struct, state_struct);
-		for (auto node : ir) {
-			f.print("\t{} {} = ", CxxType(node.sort()).to_string(), node_name(node));
+		auto print_node = [&](Functional::Node node) {
+			f.print("\t{} = ", node_name(node));
 			node.visit(printVisitor);
 			f.print(";\n");
+		};
+		// nodes of equal scheduling level never depend on each other, so each
+		// level can be evaluated in any order or concurrently. levels with enough
+		// nodes are chunked into OpenMP sections; compilers without OpenMP ignore
+		// the pragmas and evaluate the chunks in order.
+		const int min_parallel_nodes = 128;
+		std::vector<int> levels = ir.scheduling_levels();
+		std::vector<std::vector<int>> layers(levels.empty() ? 0 : *std::max_element(levels.begin(), levels.end()) + 1);
+		for (int i = 0; i < ir.size(); i++)
+			layers[levels[i]].push_back(i);
+		for (auto node : ir)
+			f.print("\t{} {};\n", CxxType(node.sort()).to_string(), node_name(node));
+		for (auto &layer : layers) {
+			if (GetSize(layer) >= min_parallel_nodes) {
+				int num_chunks = min(16, GetSize(layer) / (min_parallel_nodes / 2));
+				f.print("\t#pragma omp parallel sections\n\t{{\n");
+				for (int chunk = 0; chunk < num_chunks; chunk++) {
+					f.print("\t#pragma omp section\n\t{{\n");
+					for (int j = GetSize(layer)*chunk/num_chunks; j < GetSize(layer)*(chunk+1)/num_chunks; j++)
+						print_node(ir[layer[j]]);
+					f.print("\t}}\n");
+				}
+				f.print("\t}}\n");
+			} else {
+				for (int j : layer)
+					print_node(ir[j]);
+			}
 		}
 		for (auto state : ir.states())
 			f.print("\tnext_state.{} = {};\n", state_struct[state->name], node_name(state->next_value()));
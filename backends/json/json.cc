@@ -336,6 +336,342 @@ struct JsonWriter
 	}
 };
 
+// Emits the same data model as JsonWriter as a CBOR (RFC 8949) document:
+// maps and arrays for the structure, text strings for names and values that
+// JSON mode writes as strings, and native integers for bit ids and numeric
+// fields. Containers use indefinite-length encoding so no element counting
+// pass is needed. The document starts with the self-describing CBOR tag,
+// which read_json uses to tell binary from text input.
+struct CborWriter
+{
+	std::ostream &f;
+	bool use_selection;
+	bool aig_mode;
+	bool compat_int_mode;
+
+	Design *design;
+	Module *module;
+
+	SigMap sigmap;
+	int sigidcounter;
+	dict<SigBit, int> sigids;
+	pool<Aig> aig_models;
+
+	CborWriter(std::ostream &f, bool use_selection, bool aig_mode, bool compat_int_mode) :
+			f(f), use_selection(use_selection), aig_mode(aig_mode),
+			compat_int_mode(compat_int_mode) { }
+
+	void head(int major, uint64_t value)
+	{
+		if (value < 24) {
+			f.put((char)((major << 5) | value));
+		} else if (value <= 0xff) {
+			f.put((char)((major << 5) | 24));
+			f.put((char)value);
+		} else if (value <= 0xffff) {
+			f.put((char)((major << 5) | 25));
+			for (int i = 8; i >= 0; i -= 8)
+				f.put((char)(value >> i));
+		} else if (value <= 0xffffffff) {
+			f.put((char)((major << 5) | 26));
+			for (int i = 24; i >= 0; i -= 8)
+				f.put((char)(value >> i));
+		} else {
+			f.put((char)((major << 5) | 27));
+			for (int i = 56; i >= 0; i -= 8)
+				f.put((char)(value >> i));
+		}
+	}
+
+	void integer(int64_t value)
+	{
+		if (value < 0)
+			head(1, -(value+1));
+		else
+			head(0, value);
+	}
+
+	void text(const string &str)
+	{
+		head(3, str.size());
+		f.write(str.data(), str.size());
+	}
+
+	void map_begin() { f.put((char)0xbf); }
+	void array_begin() { f.put((char)0x9f); }
+	void end() { f.put((char)0xff); }
+
+	void write_bits(const SigSpec &sig)
+	{
+		array_begin();
+		for (auto bit : sigmap(sig)) {
+			if (bit.wire == nullptr) {
+				if (bit == State::S0) text("0");
+				else if (bit == State::S1) text("1");
+				else if (bit == State::Sz) text("z");
+				else text("x");
+			} else {
+				auto it = sigids.find(bit);
+				if (it == sigids.end())
+					it = sigids.insert(std::make_pair(bit, sigidcounter++)).first;
+				integer(it->second);
+			}
+		}
+		end();
+	}
+
+	void write_parameter_value(const Const &value)
+	{
+		// same value conventions as the JSON text mode, so both formats
+		// round-trip identically through read_json
+		if ((value.flags & RTLIL::ConstFlags::CONST_FLAG_STRING) != 0) {
+			string str = value.decode_string();
+			int state = 0;
+			for (char c : str) {
+				if (state == 0) {
+					if (c == '0' || c == '1' || c == 'x' || c == 'z')
+						state = 0;
+					else if (c == ' ')
+						state = 1;
+					else
+						state = 2;
+				} else if (state == 1 && c != ' ')
+					state = 2;
+			}
+			if (state < 2)
+				str += " ";
+			text(str);
+		} else if (compat_int_mode && GetSize(value) <= 32 && value.is_fully_def()) {
+			if ((value.flags & RTLIL::ConstFlags::CONST_FLAG_SIGNED) != 0)
+				integer(value.as_int());
+			else
+				integer((int64_t)(uint32_t)value.as_int());
+		} else {
+			text(value.as_string());
+		}
+	}
+
+	void write_parameters(const dict<IdString, Const> &parameters)
+	{
+		map_begin();
+		for (auto &param : parameters) {
+			text(RTLIL::unescape_id(param.first));
+			write_parameter_value(param.second);
+		}
+		end();
+	}
+
+	void write_module(Module *module_)
+	{
+		module = module_;
+		log_assert(module->design == design);
+		sigmap.set(module);
+		sigids.clear();
+
+		// reserve 0 and 1 to keep bit ids in sync with the JSON text mode
+		sigidcounter = 2;
+
+		if (module->has_processes())
+			log_error("Module %s contains processes, which are not supported by JSON backend (run `proc` first).\n", log_id(module));
+
+		map_begin();
+
+		text("attributes");
+		write_parameters(module->attributes);
+
+		if (module->parameter_default_values.size()) {
+			text("parameter_default_values");
+			write_parameters(module->parameter_default_values);
+		}
+
+		text("ports");
+		map_begin();
+		for (auto n : module->ports) {
+			Wire *w = module->wire(n);
+			if (use_selection && !module->selected(w))
+				continue;
+			text(RTLIL::unescape_id(n));
+			map_begin();
+			text("direction");
+			text(w->port_input ? w->port_output ? "inout" : "input" : "output");
+			if (w->start_offset) {
+				text("offset");
+				integer(w->start_offset);
+			}
+			if (w->upto) {
+				text("upto");
+				integer(1);
+			}
+			if (w->is_signed) {
+				text("signed");
+				integer(1);
+			}
+			text("bits");
+			write_bits(w);
+			end();
+		}
+		end();
+
+		text("cells");
+		map_begin();
+		for (auto c : module->cells()) {
+			if (use_selection && !module->selected(c))
+				continue;
+			if (c->type == ID($scopeinfo))
+				continue;
+			text(RTLIL::unescape_id(c->name));
+			map_begin();
+			text("hide_name");
+			integer(c->name[0] == '$' ? 1 : 0);
+			text("type");
+			text(RTLIL::unescape_id(c->type));
+			if (aig_mode) {
+				Aig aig(c);
+				if (!aig.name.empty()) {
+					text("model");
+					text(aig.name);
+					aig_models.insert(aig);
+				}
+			}
+			text("parameters");
+			write_parameters(c->parameters);
+			text("attributes");
+			write_parameters(c->attributes);
+			if (c->known()) {
+				text("port_directions");
+				map_begin();
+				for (auto &conn : c->connections()) {
+					text(RTLIL::unescape_id(conn.first));
+					if (c->input(conn.first))
+						text(c->output(conn.first) ? "inout" : "input");
+					else
+						text("output");
+				}
+				end();
+			}
+			text("connections");
+			map_begin();
+			for (auto &conn : c->connections()) {
+				text(RTLIL::unescape_id(conn.first));
+				write_bits(conn.second);
+			}
+			end();
+			end();
+		}
+		end();
+
+		if (!module->memories.empty()) {
+			text("memories");
+			map_begin();
+			for (auto &it : module->memories) {
+				if (use_selection && !module->selected(it.second))
+					continue;
+				text(RTLIL::unescape_id(it.second->name));
+				map_begin();
+				text("hide_name");
+				integer(it.second->name[0] == '$' ? 1 : 0);
+				text("attributes");
+				write_parameters(it.second->attributes);
+				text("width");
+				integer(it.second->width);
+				text("start_offset");
+				integer(it.second->start_offset);
+				text("size");
+				integer(it.second->size);
+				end();
+			}
+			end();
+		}
+
+		text("netnames");
+		map_begin();
+		for (auto w : module->wires()) {
+			if (use_selection && !module->selected(w))
+				continue;
+			text(RTLIL::unescape_id(w->name));
+			map_begin();
+			text("hide_name");
+			integer(w->name[0] == '$' ? 1 : 0);
+			text("bits");
+			write_bits(w);
+			if (w->start_offset) {
+				text("offset");
+				integer(w->start_offset);
+			}
+			if (w->upto) {
+				text("upto");
+				integer(1);
+			}
+			if (w->is_signed) {
+				text("signed");
+				integer(1);
+			}
+			text("attributes");
+			write_parameters(w->attributes);
+			end();
+		}
+		end();
+
+		end();
+	}
+
+	void write_design(Design *design_)
+	{
+		design = design_;
+		design->sort();
+
+		// self-describing CBOR tag (55799)
+		f.put((char)0xd9);
+		f.put((char)0xd9);
+		f.put((char)0xf7);
+
+		map_begin();
+		text("creator");
+		text(yosys_version_str);
+
+		text("modules");
+		map_begin();
+		vector<Module*> modules = use_selection ? design->selected_modules() : design->modules();
+		for (auto mod : modules) {
+			text(RTLIL::unescape_id(mod->name));
+			write_module(mod);
+		}
+		end();
+
+		if (!aig_models.empty()) {
+			text("models");
+			map_begin();
+			for (auto &aig : aig_models) {
+				text(aig.name);
+				array_begin();
+				for (auto &node : aig.nodes) {
+					array_begin();
+					if (node.portbit >= 0) {
+						text(node.inverter ? "nport" : "port");
+						text(log_id(node.portname));
+						integer(node.portbit);
+					} else if (node.left_parent < 0 && node.right_parent < 0) {
+						text(node.inverter ? "true" : "false");
+					} else {
+						text(node.inverter ? "nand" : "and");
+						integer(node.left_parent);
+						integer(node.right_parent);
+					}
+					for (auto &op : node.outports) {
+						text(log_id(op.first));
+						integer(op.second);
+					}
+					end();
+				}
+				end();
+			}
+			end();
+		}
+
+		end();
+	}
+};
+
 struct JsonBackend : public Backend {
 	JsonBackend() : Backend("json", "write design to a JSON file") { }
 	void help() override
@@ -353,6 +689,11 @@ struct JsonBackend : public Backend {
 		log("        emit 32-bit or smaller fully-defined parameter values directly\n");
 		log("        as JSON numbers (for compatibility with old parsers)\n");
 		log("\n");
+		log("    -binary\n");
+		log("        emit a binary CBOR (RFC 8949) document with the same structure as\n");
+		log("        the JSON output. This is much smaller and faster to parse for large\n");
+		log("        designs. The read_json command detects this format automatically.\n");
+		log("\n");
 		log("\n");
 		log("The general syntax of the JSON output created by this command is as follows:\n");
 		log("\n");
@@ -597,6 +938,7 @@ struct JsonBackend : public Backend {
 	{
 		bool aig_mode = false;
 		bool compat_int_mode = false;
+		bool binary_mode = false;
 
 		size_t argidx;
 		for (argidx = 1; argidx < args.size(); argidx++)
@@ -609,14 +951,23 @@ struct JsonBackend : public Backend {
 				compat_int_mode = true;
 				continue;
 			}
+			if (args[argidx] == "-binary") {
+				binary_mode = true;
+				continue;
+			}
 			break;
 		}
-		extra_args(f, filename, args, argidx);
+		extra_args(f, filename, args, argidx, binary_mode);
 
 		log_header(design, "Executing JSON backend.\n");
 
-		JsonWriter json_writer(*f, false, aig_mode, compat_int_mode);
-		json_writer.write_design(design);
+		if (binary_mode) {
+			CborWriter cbor_writer(*f, false, aig_mode, compat_int_mode);
+			cbor_writer.write_design(design);
+		} else {
+			JsonWriter json_writer(*f, false, aig_mode, compat_int_mode);
+			json_writer.write_design(design);
+		}
 	}
 } JsonBackend;
 
@@ -329,7 +329,85 @@ void RTLIL_BACKEND::dump_module(std::ostream &f, std::string indent, RTLIL::Modu
 		}
 	}
 
-	if (print_body)
+	// For partial selections the generic body loops below scan every object
+	// in the module, which makes interactive `dump c:<cell>` style commands
+	// on multi-million-object designs take seconds for a handful of lines of
+	// output. When the active selection lists the selected members of this
+	// module explicitly, enumerate that (typically tiny) list instead and
+	// resolve the objects by name. The members are emitted per category in
+	// name order, which matches the design->sort() order used by write_rtlil.
+	const pool<RTLIL::IdString> *selected_members = nullptr;
+	if (print_body && only_selected && !design->selected_whole_module(module->name)) {
+		auto members_it = design->selection().selected_members.find(module->name);
+		if (members_it != design->selection().selected_members.end())
+			selected_members = &members_it->second;
+	}
+
+	if (selected_members != nullptr)
+	{
+		std::vector<RTLIL::IdString> member_names(selected_members->begin(), selected_members->end());
+		std::sort(member_names.begin(), member_names.end(), RTLIL::sort_by_id_str());
+
+		// wire, memory, cell and process names are separate namespaces; a
+		// member name can resolve in more than one of them, just like the
+		// generic loops can select the same name in each category
+		std::vector<RTLIL::Wire*> sel_wires;
+		std::vector<RTLIL::Memory*> sel_memories;
+		std::vector<RTLIL::Cell*> sel_cells;
+		std::vector<RTLIL::Process*> sel_procs;
+		for (auto &name : member_names) {
+			if (RTLIL::Wire *wire = module->wire(name))
+				sel_wires.push_back(wire);
+			auto mem_it = module->memories.find(name);
+			if (mem_it != module->memories.end())
+				sel_memories.push_back(mem_it->second);
+			if (RTLIL::Cell *cell = module->cell(name))
+				sel_cells.push_back(cell);
+			auto proc_it = module->processes.find(name);
+			if (proc_it != module->processes.end())
+				sel_procs.push_back(proc_it->second);
+		}
+
+		for (auto wire : sel_wires) {
+			f << stringf("\n");
+			dump_wire(f, indent + "  ", wire);
+		}
+		for (auto memory : sel_memories) {
+			f << stringf("\n");
+			dump_memory(f, indent + "  ", memory);
+		}
+		for (auto cell : sel_cells) {
+			f << stringf("\n");
+			dump_cell(f, indent + "  ", cell);
+		}
+		for (auto proc : sel_procs) {
+			f << stringf("\n");
+			dump_proc(f, indent + "  ", proc);
+		}
+
+		pool<RTLIL::Wire*> sel_wire_pool;
+		for (auto wire : sel_wires)
+			sel_wire_pool.insert(wire);
+
+		bool first_conn_line = true;
+		for (auto it = module->connections().begin(); it != module->connections().end(); ++it) {
+			bool show_conn = false;
+			RTLIL::SigSpec sigs = it->first;
+			sigs.append(it->second);
+			for (auto &c : sigs.chunks()) {
+				if (c.wire == NULL || !sel_wire_pool.count(c.wire))
+					continue;
+				show_conn = true;
+			}
+			if (show_conn) {
+				if (first_conn_line)
+					f << stringf("\n");
+				dump_conn(f, indent + "  ", it->first, it->second);
+				first_conn_line = false;
+			}
+		}
+	}
+	else if (print_body)
 	{
 		for (auto it : module->wires())
 			if (!only_selected || design->selected(module, it)) {
@@ -452,7 +530,19 @@ struct RTLILBackend : public Backend {
 		}
 		extra_args(f, filename, args, argidx);
 
-		design->sort();
+		if (selected) {
+			// sorting keeps the output stable, but only modules whose body
+			// is dumped from the object dicts need it: partially selected
+			// modules are emitted from the (name-sorted) selection member
+			// list, so a tiny selection doesn't pay for sorting the whole
+			// design
+			design->scratchpad.sort();
+			design->modules_.sort(RTLIL::sort_by_id_str());
+			for (auto module : design->modules())
+				if (design->selected_whole_module(module->name))
+					module->sort();
+		} else
+			design->sort();
 
 		log("Output filename: %s\n", filename.c_str());
 		*f << stringf("# Generated by %s\n", yosys_version_str);
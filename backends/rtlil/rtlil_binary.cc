@@ -0,0 +1,293 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ *  ---
+ *
+ *  Writer for the binary RTLIL checkpoint format. See rtlil_binary.h for
+ *  the file layout. The design body is serialized into a memory buffer
+ *  first so that the string table (which is only complete after the body
+ *  has been visited) can be emitted before the body.
+ *
+ */
+
+#include "rtlil_binary.h"
+#include "kernel/yosys.h"
+
+USING_YOSYS_NAMESPACE
+YOSYS_NAMESPACE_BEGIN
+
+struct BinaryWriter
+{
+	std::vector<unsigned char> body;
+	idict<std::string> strings;
+
+	void write_u8(unsigned char v)
+	{
+		body.push_back(v);
+	}
+
+	void write_uint(uint64_t v)
+	{
+		while (v >= 0x80) {
+			body.push_back(0x80 | (v & 0x7f));
+			v >>= 7;
+		}
+		body.push_back(v);
+	}
+
+	void write_int(int64_t v)
+	{
+		write_uint((uint64_t(v) << 1) ^ uint64_t(v >> 63));
+	}
+
+	void write_name(const RTLIL::IdString &name)
+	{
+		write_uint(strings(name.str()));
+	}
+
+	void write_const(const RTLIL::Const &data)
+	{
+		write_uint(data.flags);
+		write_uint(data.bits.size());
+
+		bool packed = true;
+		for (auto bit : data.bits)
+			if (bit != State::S0 && bit != State::S1) {
+				packed = false;
+				break;
+			}
+
+		if (packed) {
+			write_u8(RTLIL_BINARY::CONST_PACKED);
+			unsigned char byte = 0;
+			for (size_t i = 0; i < data.bits.size(); i++) {
+				if (data.bits[i] == State::S1)
+					byte |= 1 << (i % 8);
+				if (i % 8 == 7 || i+1 == data.bits.size()) {
+					write_u8(byte);
+					byte = 0;
+				}
+			}
+		} else {
+			write_u8(RTLIL_BINARY::CONST_STATES);
+			for (auto bit : data.bits)
+				write_u8(bit);
+		}
+	}
+
+	void write_sigspec(const RTLIL::SigSpec &sig)
+	{
+		write_uint(sig.chunks().size());
+		for (auto &chunk : sig.chunks()) {
+			if (chunk.wire != nullptr) {
+				write_u8(RTLIL_BINARY::CHUNK_WIRE);
+				write_name(chunk.wire->name);
+				write_uint(chunk.offset);
+				write_uint(chunk.width);
+			} else {
+				write_u8(RTLIL_BINARY::CHUNK_CONST);
+				write_const(RTLIL::Const(chunk.data));
+			}
+		}
+	}
+
+	void write_attributes(const dict<RTLIL::IdString, RTLIL::Const> &attributes)
+	{
+		write_uint(attributes.size());
+		for (auto &it : attributes) {
+			write_name(it.first);
+			write_const(it.second);
+		}
+	}
+
+	void write_wire(const RTLIL::Wire *wire)
+	{
+		write_name(wire->name);
+		write_uint(wire->width);
+		write_int(wire->start_offset);
+		write_uint(wire->port_id);
+		write_u8((wire->port_input ? 1 : 0) | (wire->port_output ? 2 : 0) |
+				(wire->upto ? 4 : 0) | (wire->is_signed ? 8 : 0));
+		write_attributes(wire->attributes);
+	}
+
+	void write_memory(const RTLIL::Memory *memory)
+	{
+		write_name(memory->name);
+		write_uint(memory->width);
+		write_int(memory->start_offset);
+		write_uint(memory->size);
+		write_attributes(memory->attributes);
+	}
+
+	void write_cell(const RTLIL::Cell *cell)
+	{
+		write_name(cell->name);
+		write_name(cell->type);
+		write_attributes(cell->attributes);
+		write_uint(cell->parameters.size());
+		for (auto &it : cell->parameters) {
+			write_name(it.first);
+			write_const(it.second);
+		}
+		write_uint(cell->connections().size());
+		for (auto &it : cell->connections()) {
+			write_name(it.first);
+			write_sigspec(it.second);
+		}
+	}
+
+	void write_case(const RTLIL::CaseRule *cs)
+	{
+		write_attributes(cs->attributes);
+		write_uint(cs->compare.size());
+		for (auto &sig : cs->compare)
+			write_sigspec(sig);
+		write_uint(cs->actions.size());
+		for (auto &it : cs->actions) {
+			write_sigspec(it.first);
+			write_sigspec(it.second);
+		}
+		write_uint(cs->switches.size());
+		for (auto sw : cs->switches) {
+			write_attributes(sw->attributes);
+			write_sigspec(sw->signal);
+			write_uint(sw->cases.size());
+			for (auto c : sw->cases)
+				write_case(c);
+		}
+	}
+
+	void write_process(const RTLIL::Process *proc)
+	{
+		write_name(proc->name);
+		write_attributes(proc->attributes);
+		write_case(&proc->root_case);
+		write_uint(proc->syncs.size());
+		for (auto sync : proc->syncs) {
+			write_u8(sync->type);
+			write_sigspec(sync->signal);
+			write_uint(sync->actions.size());
+			for (auto &it : sync->actions) {
+				write_sigspec(it.first);
+				write_sigspec(it.second);
+			}
+			write_uint(sync->mem_write_actions.size());
+			for (auto &it : sync->mem_write_actions) {
+				write_name(it.memid);
+				write_attributes(it.attributes);
+				write_sigspec(it.address);
+				write_sigspec(it.data);
+				write_sigspec(it.enable);
+				write_const(it.priority_mask);
+			}
+		}
+	}
+
+	void write_module(RTLIL::Module *module)
+	{
+		write_name(module->name);
+		write_attributes(module->attributes);
+
+		write_uint(module->avail_parameters.size());
+		for (const auto &p : module->avail_parameters) {
+			write_name(p);
+			auto it = module->parameter_default_values.find(p);
+			write_u8(it != module->parameter_default_values.end() ? 1 : 0);
+			if (it != module->parameter_default_values.end())
+				write_const(it->second);
+		}
+
+		write_uint(module->wires().size());
+		for (auto wire : module->wires())
+			write_wire(wire);
+
+		write_uint(module->memories.size());
+		for (auto &it : module->memories)
+			write_memory(it.second);
+
+		write_uint(module->cells().size());
+		for (auto cell : module->cells())
+			write_cell(cell);
+
+		write_uint(module->processes.size());
+		for (auto &it : module->processes)
+			write_process(it.second);
+
+		write_uint(module->connections().size());
+		for (auto &it : module->connections()) {
+			write_sigspec(it.first);
+			write_sigspec(it.second);
+		}
+	}
+
+	void write_design(std::ostream &f, RTLIL::Design *design)
+	{
+		write_uint(autoidx);
+		write_uint(design->modules().size());
+		for (auto module : design->modules())
+			write_module(module);
+
+		f.write(RTLIL_BINARY::magic, 8);
+		uint32_t version = RTLIL_BINARY::format_version;
+		for (int i = 0; i < 4; i++)
+			f.put((version >> (8*i)) & 0xff);
+
+		std::vector<unsigned char> strtab;
+		body.swap(strtab);
+		write_uint(strings.size());
+		for (int i = 0; i < GetSize(strings); i++) {
+			write_uint(strings[i].size());
+			for (char c : strings[i])
+				body.push_back(c);
+		}
+		body.swap(strtab);
+
+		f.write((const char*)strtab.data(), strtab.size());
+		f.write((const char*)body.data(), body.size());
+	}
+};
+
+struct RTLILBinBackend : public Backend {
+	RTLILBinBackend() : Backend("rtlil_bin", "write design to binary RTLIL file") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    write_rtlil_bin [filename]\n");
+		log("\n");
+		log("Write the current design to a binary RTLIL file. The binary format stores\n");
+		log("the same information as the text format written by 'write_rtlil' but is\n");
+		log("much faster to write and (with 'read_rtlil_bin') to read back, which makes\n");
+		log("it suitable for large checkpoints between synthesis stages. It is a\n");
+		log("versioned internal format and not guaranteed to be stable across yosys\n");
+		log("versions; use 'write_rtlil' for long-term storage.\n");
+		log("\n");
+	}
+	void execute(std::ostream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		log_header(design, "Executing binary RTLIL backend.\n");
+		extra_args(f, filename, args, 1, /*bin_output=*/true);
+
+		log("Output filename: %s\n", filename.c_str());
+
+		BinaryWriter writer;
+		writer.write_design(*f, design);
+	}
+} RTLILBinBackend;
+
+YOSYS_NAMESPACE_END
@@ -0,0 +1,64 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ *  ---
+ *
+ *  Shared constants for the binary RTLIL checkpoint format used by
+ *  write_rtlil_bin (backends/rtlil/rtlil_binary.cc) and read_rtlil_bin
+ *  (frontends/rtlil/rtlil_binary.cc).
+ *
+ *  File layout (all multi-byte scalars are unsigned LEB128 varints,
+ *  signed values use zigzag encoding, except for the fixed 32-bit
+ *  little-endian version field):
+ *
+ *    magic[8]  "YosysBin"
+ *    u32le     format version
+ *    varint    string table size N, then N x (varint length, raw bytes)
+ *    body      autoidx, module count, modules (see the .cc files)
+ *
+ *  All names (IdStrings) in the body are varint indices into the string
+ *  table, so each distinct name is stored and interned exactly once.
+ */
+
+#ifndef RTLIL_BINARY_H
+#define RTLIL_BINARY_H
+
+#include "kernel/yosys.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+namespace RTLIL_BINARY
+{
+	static const char magic[9] = "YosysBin";
+	static const uint32_t format_version = 1;
+
+	// chunk tags in serialized sigspecs
+	enum : unsigned char {
+		CHUNK_WIRE = 0,
+		CHUNK_CONST = 1,
+	};
+
+	// payload tags in serialized consts
+	enum : unsigned char {
+		CONST_PACKED = 0, // only 0/1 bits, packed 8 per byte, LSB first
+		CONST_STATES = 1, // one RTLIL::State byte per bit
+	};
+}
+
+YOSYS_NAMESPACE_END
+
+#endif
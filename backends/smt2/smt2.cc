@@ -23,7 +23,9 @@
 #include "kernel/celltypes.h"
 #include "kernel/log.h"
 #include "kernel/mem.h"
+#include "backends/rtlil/rtlil_backend.h"
 #include "libs/json11/json11.hpp"
+#include "libs/sha1/sha1.h"
 #include <string>
 
 USING_YOSYS_NAMESPACE
@@ -1705,6 +1707,22 @@ struct Smt2Backend : public Backend {
 		log("        emit a `; yosys-smt2-solver-option` directive for yosys-smtbmc to write\n");
 		log("        the given option as a `(set-option ...)` command in the SMT-LIBv2.\n");
 		log("\n");
+		log("    -incremental <cache_dir>\n");
+		log("        cache the SMT-LIBv2 fragment of each module in <cache_dir>, keyed by a\n");
+		log("        digest of the module contents, the options that affect the encoding,\n");
+		log("        and the digests of its submodules. on later runs, modules whose digest\n");
+		log("        is unchanged are spliced from the cache instead of being re-encoded,\n");
+		log("        so only the changed parts of the design pay the encoding cost. the\n");
+		log("        output file is identical to a run without this option. stale cache\n");
+		log("        entries are not removed automatically.\n");
+		log("\n");
+		log("The generated functions are pure, so the emitted file can also be used in an\n");
+		log("incremental solver session: assert the fixed parts of the problem once, and\n");
+		log("wrap the per-step assertions in `(push 1)` ... `(pop 1)` instead of restarting\n");
+		log("the solver with a re-generated problem for every step configuration. the\n");
+		log("yosys-smtbmc --incremental mode drives a session like this over a single\n");
+		log("solver process.\n");
+		log("\n");
 		log("[1] For more information on SMT-LIBv2 visit http://smt-lib.org/ or read David\n");
 		log("R. Cok's tutorial: https://smtlib.github.io/jSMTLIB/SMTLIBTutorial.pdf\n");
 		log("\n");
@@ -1759,6 +1777,7 @@ struct Smt2Backend : public Backend {
 		std::ifstream template_f;
 		bool bvmode = true, memmode = true, wiresmode = false, verbose = false, statebv = false, statedt = false;
 		bool forallmode = false;
+		std::string cache_dir;
 		dict<std::string, std::string> solver_options;
 
 		log_header(design, "Executing SMT2 backend.\n");
@@ -1813,10 +1832,17 @@ struct Smt2Backend : public Backend {
 				argidx += 2;
 				continue;
 			}
+			if (args[argidx] == "-incremental" && argidx+1 < args.size()) {
+				cache_dir = args[++argidx];
+				continue;
+			}
 			break;
 		}
 		extra_args(f, filename, args, argidx);
 
+		if (!cache_dir.empty() && !create_directory(cache_dir))
+			log_error("Can't create cache directory `%s'.\n", cache_dir.c_str());
+
 		if (template_f.is_open()) {
 			std::string line;
 			while (std::getline(template_f, line)) {
@@ -1892,22 +1918,92 @@ struct Smt2Backend : public Backend {
 				log_error("Forall-exists problems are only supported in -stbv or -stdt mode.\n");
 		}
 
+		dict<IdString, std::string> module_digests;
+
 		for (auto module : sorted_modules)
 		{
+			// In incremental mode each module is identified by a digest over its RTLIL contents, the options
+			// that affect the encoding, and the digests of the modules it instantiates (a change in a submodule
+			// interface changes the encoding of its parents). The digest stays the same between runs iff the
+			// emitted SMT-LIBv2 fragment would, so fragments are cached content-addressed by it.
+			std::string cache_path;
+			if (!cache_dir.empty()) {
+				std::ostringstream digest_data;
+				RTLIL_BACKEND::dump_module(digest_data, "", module, design, /*only_selected=*/false);
+				digest_data << stringf("|opts %d %d %d %d %d %d\n", bvmode, memmode, wiresmode, statebv, statedt, forallmode);
+				for (auto cell : module->cells())
+					if (module_digests.count(cell->type))
+						digest_data << stringf("|dep %s %s\n", cell->type.c_str(), module_digests.at(cell->type).c_str());
+				std::string digest = sha1(digest_data.str());
+				module_digests[module->name] = digest;
+				cache_path = cache_dir + "/" + digest + ".smt2";
+			}
+
 			if (module->get_blackbox_attribute() && !module->has_attribute(ID::smtlib2_module))
 				continue;
 
 			if (module->has_processes_warn())
 				continue;
 
+			if (module == topmod) {
+				topmod_id = log_id(module->name);
+				std::replace(topmod_id.begin(), topmod_id.end(), '\\', '/');
+			}
+
+			if (!cache_path.empty()) {
+				std::ifstream cache_f(cache_path);
+				if (cache_f.is_open()) {
+					log("Reusing cached SMT-LIBv2 representation of module %s.\n", log_id(module));
+					// metadata directives carry the information parents need that would otherwise
+					// be produced as a side effect of encoding this module
+					const std::string directive = "; yosys-smt2-cache ";
+					std::string line;
+					while (std::getline(cache_f, line)) {
+						if (line.compare(0, directive.size(), directive) != 0) {
+							*f << line << '\n';
+							continue;
+						}
+						std::string payload = line.substr(directive.size());
+						if (payload.compare(0, 11, "stbv-width ") == 0) {
+							mod_stbv_width[module->name] = atoi(payload.c_str() + 11);
+						} else if (payload.compare(0, 4, "clk ") == 0 && GetSize(payload) > 7) {
+							auto &entry = mod_clk_cache[module->name][RTLIL::IdString(payload.substr(7))];
+							entry.first = payload[4] == 'p';
+							entry.second = payload[5] == 'n';
+						} else {
+							log_error("Invalid cache directive in `%s': %s\n", cache_path.c_str(), line.c_str());
+						}
+					}
+					continue;
+				}
+			}
+
 			log("Creating SMT-LIBv2 representation of module %s.\n", log_id(module));
 
 			Smt2Worker worker(module, bvmode, memmode, wiresmode, verbose, statebv, statedt, forallmode, mod_stbv_width, mod_clk_cache);
 			worker.run();
-			worker.write(*f);
 
-			if (module == topmod)
-				topmod_id = worker.get_id(module);
+			if (cache_path.empty()) {
+				worker.write(*f);
+			} else {
+				std::ostringstream fragment;
+				worker.write(fragment);
+
+				std::ostringstream metadata;
+				if (statebv)
+					metadata << stringf("; yosys-smt2-cache stbv-width %d\n", mod_stbv_width.at(module->name));
+				if (mod_clk_cache.count(module->name))
+					for (auto &it : mod_clk_cache.at(module->name))
+						metadata << stringf("; yosys-smt2-cache clk %c%c %s\n",
+								it.second.first ? 'p' : '-', it.second.second ? 'n' : '-', it.first.c_str());
+
+				std::ofstream cache_f(cache_path, std::ofstream::trunc);
+				if (cache_f.fail())
+					log_error("Can't open cache file `%s' for writing: %s\n", cache_path.c_str(), strerror(errno));
+				cache_f << metadata.str() << fragment.str();
+
+				*f << fragment.str();
+			}
 		}
 
 		if (topmod)
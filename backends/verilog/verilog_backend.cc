@@ -28,7 +28,9 @@
 #include "kernel/ff.h"
 #include "kernel/mem.h"
 #include "kernel/fmt.h"
+#include "libs/sha1/sha1.h"
 #include <string>
+#include <fstream>
 #include <sstream>
 #include <set>
 #include <map>
@@ -36,17 +38,22 @@
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
+// configuration set in execute() and read-only while modules are dumped
 bool verbose, norename, noattr, attr2comment, noexpr, nodec, nohex, nostr, extmem, defparam, decimal, siminit, systemverilog, simple_lhs, noparallelcase;
-int auto_name_counter, auto_name_offset, auto_name_digits, extmem_counter;
-dict<RTLIL::IdString, int> auto_name_map;
-std::set<RTLIL::IdString> reg_wires;
 std::string auto_prefix, extmem_prefix;
-
-RTLIL::Module *active_module;
-dict<RTLIL::SigBit, RTLIL::State> active_initdata;
-SigMap active_sigmap;
+int extmem_counter;
 IdString initial_id;
 
+// per-module dump state, reset by dump_module(); thread_local so that
+// independent modules can be dumped concurrently on the worker pool
+thread_local int auto_name_counter, auto_name_offset, auto_name_digits;
+thread_local dict<RTLIL::IdString, int> auto_name_map;
+thread_local std::set<RTLIL::IdString> reg_wires;
+
+thread_local RTLIL::Module *active_module;
+thread_local dict<RTLIL::SigBit, RTLIL::State> active_initdata;
+thread_local SigMap active_sigmap;
+
 void reset_auto_counter_id(RTLIL::IdString id, bool may_rename)
 {
 	const char *str = id.c_str();
@@ -210,11 +217,11 @@ void dump_const(std::ostream &f, const RTLIL::Const &data, int width = -1, int o
 					val |= 1 << (i - offset);
 			}
 			if (decimal)
-				f << stringf("%d", val);
+				f << val;
 			else if (set_signed && val < 0)
-				f << stringf("-32'sd%u", -val);
+				f << "-32'sd" << -(int64_t)val;
 			else
-				f << stringf("32'%sd%u", set_signed ? "s" : "", val);
+				f << "32'" << (set_signed ? "s" : "") << 'd' << (uint32_t)val;
 		} else {
 	dump_hex:
 			if (nohex)
@@ -265,49 +272,49 @@ void dump_const(std::ostream &f, const RTLIL::Const &data, int width = -1, int o
 				int val = 8*(bit_3 - '0') + 4*(bit_2 - '0') + 2*(bit_1 - '0') + (bit_0 - '0');
 				hex_digits.push_back(val < 10 ? '0' + val : 'a' + val - 10);
 			}
-			f << stringf("%d'%sh", width, set_signed ? "s" : "");
+			f << width << '\'' << (set_signed ? "sh" : "h");
 			for (int i = GetSize(hex_digits)-1; i >= 0; i--)
 				f << hex_digits[i];
 		}
 		if (0) {
 	dump_bin:
-			f << stringf("%d'%sb", width, set_signed ? "s" : "");
+			f << width << '\'' << (set_signed ? "sb" : "b");
 			if (width == 0)
-				f << stringf("0");
+				f << '0';
 			for (int i = offset+width-1; i >= offset; i--) {
 				log_assert(i < (int)data.bits.size());
 				switch (data.bits[i]) {
-				case State::S0: f << stringf("0"); break;
-				case State::S1: f << stringf("1"); break;
-				case RTLIL::Sx: f << stringf("x"); break;
-				case RTLIL::Sz: f << stringf("z"); break;
-				case RTLIL::Sa: f << stringf("?"); break;
+				case State::S0: f << '0'; break;
+				case State::S1: f << '1'; break;
+				case RTLIL::Sx: f << 'x'; break;
+				case RTLIL::Sz: f << 'z'; break;
+				case RTLIL::Sa: f << '?'; break;
 				case RTLIL::Sm: log_error("Found marker state in final netlist.");
 				}
 			}
 		}
 	} else {
 		if ((data.flags & RTLIL::CONST_FLAG_REAL) == 0)
-			f << stringf("\"");
+			f << '"';
 		std::string str = data.decode_string();
 		for (size_t i = 0; i < str.size(); i++) {
 			if (str[i] == '\n')
-				f << stringf("\\n");
+				f << "\\n";
 			else if (str[i] == '\t')
-				f << stringf("\\t");
+				f << "\\t";
 			else if (str[i] < 32)
 				f << stringf("\\%03o", str[i]);
 			else if (str[i] == '"')
-				f << stringf("\\\"");
+				f << "\\\"";
 			else if (str[i] == '\\')
-				f << stringf("\\\\");
+				f << "\\\\";
 			else if (str[i] == '/' && escape_comment && i > 0 && str[i-1] == '*')
-				f << stringf("\\/");
+				f << "\\/";
 			else
 				f << str[i];
 		}
 		if ((data.flags & RTLIL::CONST_FLAG_REAL) == 0)
-			f << stringf("\"");
+			f << '"';
 	}
 }
 
@@ -337,21 +344,19 @@ void dump_sigchunk(std::ostream &f, const RTLIL::SigChunk &chunk, bool no_decima
 		dump_const(f, chunk.data, chunk.width, chunk.offset, no_decimal);
 	} else {
 		if (chunk.width == chunk.wire->width && chunk.offset == 0) {
-			f << stringf("%s", id(chunk.wire->name).c_str());
+			f << id(chunk.wire->name);
 		} else if (chunk.width == 1) {
 			if (chunk.wire->upto)
-				f << stringf("%s[%d]", id(chunk.wire->name).c_str(), (chunk.wire->width - chunk.offset - 1) + chunk.wire->start_offset);
+				f << id(chunk.wire->name) << '[' << (chunk.wire->width - chunk.offset - 1) + chunk.wire->start_offset << ']';
 			else
-				f << stringf("%s[%d]", id(chunk.wire->name).c_str(), chunk.offset + chunk.wire->start_offset);
+				f << id(chunk.wire->name) << '[' << chunk.offset + chunk.wire->start_offset << ']';
 		} else {
 			if (chunk.wire->upto)
-				f << stringf("%s[%d:%d]", id(chunk.wire->name).c_str(),
-						(chunk.wire->width - (chunk.offset + chunk.width - 1) - 1) + chunk.wire->start_offset,
-						(chunk.wire->width - chunk.offset - 1) + chunk.wire->start_offset);
+				f << id(chunk.wire->name) << '[' << (chunk.wire->width - (chunk.offset + chunk.width - 1) - 1) + chunk.wire->start_offset
+						<< ':' << (chunk.wire->width - chunk.offset - 1) + chunk.wire->start_offset << ']';
 			else
-				f << stringf("%s[%d:%d]", id(chunk.wire->name).c_str(),
-						(chunk.offset + chunk.width - 1) + chunk.wire->start_offset,
-						chunk.offset + chunk.wire->start_offset);
+				f << id(chunk.wire->name) << '[' << (chunk.offset + chunk.width - 1) + chunk.wire->start_offset
+						<< ':' << chunk.offset + chunk.wire->start_offset << ']';
 		}
 	}
 }
@@ -366,13 +371,13 @@ void dump_sigspec(std::ostream &f, const RTLIL::SigSpec &sig)
 	if (sig.is_chunk()) {
 		dump_sigchunk(f, sig.as_chunk());
 	} else {
-		f << stringf("{ ");
+		f << "{ ";
 		for (auto it = sig.chunks().rbegin(); it != sig.chunks().rend(); ++it) {
 			if (it != sig.chunks().rbegin())
-				f << stringf(", ");
+				f << ", ";
 			dump_sigchunk(f, *it, true);
 		}
-		f << stringf(" }");
+		f << " }";
 	}
 }
 
@@ -2461,6 +2466,13 @@ struct VerilogBackend : public Backend {
 		log("        only write selected modules. modules must be selected entirely or\n");
 		log("        not at all.\n");
 		log("\n");
+		log("    -split <dirname>\n");
+		log("        instead of a single output file, write one file per module into the\n");
+		log("        given directory, plus a manifest.txt listing digest, file name and\n");
+		log("        module name. files whose content digest matches the previous\n");
+		log("        emission are left untouched, so downstream tools that track file\n");
+		log("        timestamps only see the modules that actually changed.\n");
+		log("\n");
 		log("    -v\n");
 		log("        verbose output (print new names of all renamed wires and cells)\n");
 		log("\n");
@@ -2493,6 +2505,7 @@ struct VerilogBackend : public Backend {
 
 		bool blackboxes = false;
 		bool selected = false;
+		std::string split_dir;
 
 		auto_name_map.clear();
 		reg_wires.clear();
@@ -2569,13 +2582,23 @@ struct VerilogBackend : public Backend {
 				simple_lhs = true;
 				continue;
 			}
+			if (arg == "-split" && argidx+1 < args.size()) {
+				split_dir = args[++argidx];
+				continue;
+			}
 			if (arg == "-v") {
 				verbose = true;
 				continue;
 			}
 			break;
 		}
-		extra_args(f, filename, args, argidx);
+		if (!split_dir.empty()) {
+			if (argidx != args.size())
+				cmd_error(args, argidx, "Extra argument or option not allowed in -split mode.");
+			if (extmem)
+				log_cmd_error("Options -extmem and -split are exclusive.\n");
+		} else
+			extra_args(f, filename, args, argidx);
 		if (extmem)
 		{
 			if (filename == "<stdout>")
@@ -2593,7 +2616,10 @@ struct VerilogBackend : public Backend {
 
 		design->sort();
 
-		*f << stringf("/* Generated by %s */\n", yosys_version_str);
+		if (split_dir.empty())
+			*f << stringf("/* Generated by %s */\n", yosys_version_str);
+
+		std::vector<RTLIL::Module*> dump_queue;
 		for (auto module : design->modules()) {
 			if (module->get_blackbox_attribute() != blackboxes)
 				continue;
@@ -2602,8 +2628,127 @@ struct VerilogBackend : public Backend {
 					log_cmd_error("Can't handle partially selected module %s!\n", log_id(module->name));
 				continue;
 			}
-			log("Dumping module `%s'.\n", module->name.c_str());
-			dump_module(*f, "", module);
+			dump_queue.push_back(module);
+		}
+
+		if (!split_dir.empty())
+		{
+			// Digests of the previous emission, keyed by file name. The
+			// manifest line format is "<sha1> <filename> <modulename>".
+			dict<std::string, std::string> old_digests;
+			std::string manifest_path = split_dir + "/manifest.txt";
+			std::ifstream old_manifest(manifest_path.c_str());
+			std::string line;
+			while (std::getline(old_manifest, line)) {
+				size_t pos1 = line.find(' ');
+				size_t pos2 = pos1 == std::string::npos ? pos1 : line.find(' ', pos1+1);
+				if (pos2 == std::string::npos)
+					continue;
+				old_digests[line.substr(pos1+1, pos2-pos1-1)] = line.substr(0, pos1);
+			}
+			old_manifest.close();
+
+			pool<std::string> used_filenames;
+			std::vector<std::string> manifest_lines;
+			int num_written = 0, num_unchanged = 0;
+
+			for (auto module : dump_queue)
+			{
+				log("Dumping module `%s'.\n", module->name.c_str());
+
+				std::ostringstream buf;
+				buf << stringf("/* Generated by %s */\n", yosys_version_str);
+				dump_module(buf, "", module);
+				std::string text = buf.str();
+				std::string digest = sha1(text);
+
+				std::string file_name;
+				for (char c : RTLIL::unescape_id(module->name))
+					file_name += ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') ||
+							('0' <= c && c <= '9') || c == '_' ? c : '_';
+				while (used_filenames.count(file_name + ".v"))
+					file_name += "_";
+				file_name += ".v";
+				used_filenames.insert(file_name);
+
+				std::string file_path = split_dir + "/" + file_name;
+				auto it = old_digests.find(file_name);
+				bool unchanged = it != old_digests.end() && it->second == digest &&
+						std::ifstream(file_path.c_str()).good();
+
+				if (unchanged) {
+					num_unchanged++;
+				} else {
+					std::ofstream of(file_path.c_str(), std::ofstream::trunc);
+					if (of.fail())
+						log_error("Can't open output file `%s' for writing: %s\n",
+								file_path.c_str(), strerror(errno));
+					of << text;
+					yosys_output_files.insert(file_path);
+					num_written++;
+				}
+
+				manifest_lines.push_back(digest + " " + file_name + " " + module->name.str());
+			}
+
+			std::ofstream new_manifest(manifest_path.c_str(), std::ofstream::trunc);
+			if (new_manifest.fail())
+				log_error("Can't open manifest file `%s' for writing: %s\n",
+						manifest_path.c_str(), strerror(errno));
+			for (auto &manifest_line : manifest_lines)
+				new_manifest << manifest_line << "\n";
+			yosys_output_files.insert(manifest_path);
+
+			log("Wrote %d modules to `%s' (%d unchanged and left untouched).\n",
+					num_written, split_dir.c_str(), num_unchanged);
+
+			auto_name_map.clear();
+			reg_wires.clear();
+			return;
+		}
+
+#ifdef YOSYS_THREADSAFE_IDS
+		// Modules are independent of each other once the per-module name
+		// scan in dump_module() has run, so they can be emitted into
+		// per-module buffers on the worker pool and written out in order.
+		// This needs thread-safe IdStrings (the default non-atomic refcounts
+		// would race when workers copy the same id). Modules with RTLIL
+		// processes stay on the calling thread: dumping them allocates a
+		// fresh id via NEW_ID and can emit warnings, neither of which is
+		// allowed on pool workers. -extmem writes side files through shared
+		// state and -v logs per renamed object, so both force serial mode.
+		ThreadPool &pool = ThreadPool::get();
+		if (pool.num_threads() > 1 && !extmem && !verbose)
+		{
+			std::vector<std::string> buffers(GetSize(dump_queue));
+			std::vector<bool> on_pool(GetSize(dump_queue));
+			for (int i = 0; i < GetSize(dump_queue); i++)
+				on_pool[i] = dump_queue[i]->processes.empty();
+
+			pool.parallel_for(GetSize(dump_queue), [&](int i) {
+				if (!on_pool[i])
+					return;
+				std::ostringstream buf;
+				dump_module(buf, "", dump_queue[i]);
+				buffers[i] = buf.str();
+			});
+
+			for (int i = 0; i < GetSize(dump_queue); i++) {
+				log("Dumping module `%s'.\n", dump_queue[i]->name.c_str());
+				if (on_pool[i]) {
+					*f << buffers[i];
+					std::string().swap(buffers[i]);
+				} else
+					dump_module(*f, "", dump_queue[i]);
+			}
+		}
+		else
+#endif
+		{
+			for (auto module : dump_queue) {
+				log("Dumping module `%s'.\n", module->name.c_str());
+				dump_module(*f, "", module);
+			}
 		}
 
 		auto_name_map.clear();
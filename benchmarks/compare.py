@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+#
+# Compares a benchmark run against a baseline, both as written by the pass
+# profiler (YOSYS_PASS_PROFILE, see kernel/register.cc). Per-pass wall times
+# are aggregated over the top-level records of each scenario and the run
+# fails when the scenario total or any single pass regresses by more than
+# the threshold. Short passes below MIN_NS are ignored for the per-pass
+# check, they are all jitter.
+
+import json
+import sys
+
+MIN_NS = 50_000_000  # 50 ms
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    per_pass = {}
+    total = 0
+    for record in data["records"]:
+        if record["depth"] != 0:
+            continue
+        per_pass[record["pass"]] = per_pass.get(record["pass"], 0) + record["wall_ns"]
+        total += record["wall_ns"]
+    return per_pass, total
+
+
+def main():
+    if len(sys.argv) != 5:
+        print("usage: compare.py <scenario> <baseline.json> <current.json> <threshold-percent>")
+        sys.exit(2)
+
+    scenario, baseline_path, current_path, threshold = sys.argv[1:5]
+    threshold = float(threshold)
+
+    base_passes, base_total = load(baseline_path)
+    cur_passes, cur_total = load(current_path)
+
+    failed = False
+
+    def check(name, base_ns, cur_ns):
+        nonlocal failed
+        if base_ns <= 0:
+            return
+        delta = 100.0 * (cur_ns - base_ns) / base_ns
+        marker = ""
+        if delta > threshold and max(base_ns, cur_ns) >= MIN_NS:
+            marker = "  <-- REGRESSION"
+            failed = True
+        print("  %-30s %10.1f ms -> %10.1f ms  (%+6.1f%%)%s"
+              % (name, base_ns / 1e6, cur_ns / 1e6, delta, marker))
+
+    print("%s (threshold %.0f%%):" % (scenario, threshold))
+    for name in sorted(set(base_passes) | set(cur_passes)):
+        check(name, base_passes.get(name, 0), cur_passes.get(name, 0))
+    check("TOTAL", base_total, cur_total)
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+#
+# Deterministic generator for the benchmark design corpus. The designs are
+# synthetic but shaped like the workloads that dominate real flows: a wide
+# random logic netlist (parser and opt pressure), a deep ALU pipeline
+# (wreduce/share/techmap pressure) and a register-file heavy design (memory
+# and FF mapping pressure). Everything is derived from a fixed seed so two
+# checkouts generate byte-identical corpora; scale with BENCH_SCALE (default
+# 1, roughly linear in design size).
+
+import os
+import sys
+
+
+class XorShift:
+    def __init__(self, seed):
+        self.state = seed & 0xffffffff or 1
+
+    def next(self, limit):
+        x = self.state
+        x ^= (x << 13) & 0xffffffff
+        x ^= x >> 17
+        x ^= (x << 5) & 0xffffffff
+        self.state = x
+        return x % limit
+
+
+def gen_random_logic(f, num_wires, rng):
+    print("module random_logic(input [31:0] in_a, input [31:0] in_b, output [31:0] out);", file=f)
+    wires = ["in_a[%d]" % i for i in range(32)] + ["in_b[%d]" % i for i in range(32)]
+    ops = ["&", "|", "^"]
+    for i in range(num_wires):
+        a = wires[rng.next(len(wires))]
+        b = wires[rng.next(len(wires))]
+        op = ops[rng.next(len(ops))]
+        inv = "~" if rng.next(4) == 0 else ""
+        print("  wire n%d = %s(%s %s %s);" % (i, inv, a, op, b), file=f)
+        wires.append("n%d" % i)
+    outs = ", ".join(wires[-32:])
+    print("  assign out = { %s };" % outs, file=f)
+    print("endmodule", file=f)
+
+
+def gen_alu_pipeline(f, depth, rng):
+    print("module alu_pipeline(input clk, input [63:0] in_a, input [63:0] in_b,", file=f)
+    print("    input [1:0] mode, output reg [63:0] out);", file=f)
+    prev_a, prev_b = "in_a", "in_b"
+    for i in range(depth):
+        print("  reg [63:0] sa%d, sb%d;" % (i, i), file=f)
+        print("  always @(posedge clk) begin", file=f)
+        if rng.next(2):
+            print("    sa%d <= %s + %s;" % (i, prev_a, prev_b), file=f)
+        else:
+            print("    sa%d <= %s - (%s >> %d);" % (i, prev_a, prev_b, rng.next(8)), file=f)
+        print("    sb%d <= mode[0] ? %s * 17 : {%s[31:0], %s[63:32]};" % (i, prev_b, prev_b, prev_a), file=f)
+        print("  end", file=f)
+        prev_a, prev_b = "sa%d" % i, "sb%d" % i
+    print("  always @(posedge clk)", file=f)
+    print("    out <= mode[1] ? %s : %s;" % (prev_a, prev_b), file=f)
+    print("endmodule", file=f)
+
+
+def gen_regfiles(f, num_files, rng):
+    print("module regfiles(input clk, input we, input [7:0] waddr, input [7:0] raddr,", file=f)
+    print("    input [31:0] wdata, output [31:0] rdata);", file=f)
+    outs = []
+    for i in range(num_files):
+        depth = 1 << (4 + rng.next(5))
+        print("  reg [31:0] mem%d [0:%d];" % (i, depth - 1), file=f)
+        print("  reg [31:0] q%d;" % i, file=f)
+        print("  always @(posedge clk) begin", file=f)
+        print("    if (we) mem%d[waddr %% %d] <= wdata ^ %d;" % (i, depth, rng.next(1 << 16)), file=f)
+        print("    q%d <= mem%d[raddr %% %d];" % (i, i, depth), file=f)
+        print("  end", file=f)
+        outs.append("q%d" % i)
+    print("  assign rdata = %s;" % " ^ ".join(outs), file=f)
+    print("endmodule", file=f)
+
+
+def main():
+    outdir = sys.argv[1] if len(sys.argv) > 1 else "corpus"
+    scale = int(os.environ.get("BENCH_SCALE", "1"))
+    os.makedirs(outdir, exist_ok=True)
+
+    with open(os.path.join(outdir, "random_logic.v"), "w") as f:
+        gen_random_logic(f, 20000 * scale, XorShift(12345))
+    with open(os.path.join(outdir, "alu_pipeline.v"), "w") as f:
+        gen_alu_pipeline(f, 100 * scale, XorShift(23456))
+    with open(os.path.join(outdir, "regfiles.v"), "w") as f:
+        gen_regfiles(f, 20 * scale, XorShift(34567))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,69 @@
+#!/usr/bin/env bash
+#
+# Benchmark harness: runs the pinned scenarios in scenarios/*.ys against the
+# generated corpus, records per-pass wall times via the JSON pass profiler
+# (YOSYS_PASS_PROFILE) and diffs the result against baseline/. Invoked as
+# `make bench` from the top level.
+#
+#   run-bench.sh [-u] [-t <percent>]
+#
+#     -u            update baseline/ from this run instead of comparing
+#     -t <percent>  per-pass/total regression threshold (default 20)
+#
+# Tunables via environment: YOSYS (binary, default ../yosys), BENCH_SCALE
+# (corpus size multiplier, default 1). The corpus is deterministic, so the
+# baseline only needs regenerating when scenarios or BENCH_SCALE change.
+
+set -e
+
+YOSYS=${YOSYS:-../yosys}
+threshold=20
+update_baseline=false
+
+OPTIND=1
+while getopts "ut:" opt; do
+    case "$opt" in
+        u) update_baseline=true ;;
+        t) threshold="$OPTARG" ;;
+    esac
+done
+shift "$((OPTIND-1))"
+
+if [ ! -x "$YOSYS" ]; then
+    echo "$0: Error: yosys binary '$YOSYS' not found (build it first or set YOSYS=...)."
+    exit 1
+fi
+
+python3 gen-corpus.py corpus
+
+mkdir -p out
+rc=0
+for scenario_script in scenarios/*.ys; do
+    scenario=$(basename "$scenario_script" .ys)
+    echo "Running scenario $scenario ..."
+    if ! YOSYS_PASS_PROFILE="out/$scenario.json" "$YOSYS" -qq -s "$scenario_script"; then
+        echo "$0: Error: scenario $scenario failed."
+        exit 1
+    fi
+
+    if $update_baseline; then
+        continue
+    fi
+    if [ ! -f "baseline/$scenario.json" ]; then
+        echo "  (no baseline for $scenario, run with -u to record one)"
+        continue
+    fi
+    python3 compare.py "$scenario" "baseline/$scenario.json" "out/$scenario.json" "$threshold" || rc=1
+done
+
+if $update_baseline; then
+    mkdir -p baseline
+    cp out/*.json baseline/
+    echo "Baseline updated from this run."
+    exit 0
+fi
+
+if [ $rc -ne 0 ]; then
+    echo "BENCHMARK REGRESSION DETECTED (threshold ${threshold}%)."
+fi
+exit $rc
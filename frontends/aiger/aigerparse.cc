@@ -257,6 +257,8 @@ end_of_header:
 
 	log_debug("M=%u I=%u L=%u O=%u A=%u B=%u C=%u J=%u F=%u\n", M, I, L, O, A, B, C, J, F);
 
+	wire_cache.assign(2*(M+1), nullptr);
+
 	line_count = 1;
 	piNum = 0;
 	flopNum = 0;
@@ -273,12 +275,14 @@ end_of_header:
 		module->connect(n0, State::S0);
 
 	// Parse footer (symbol table, comments, etc.)
+	// After a binary AND section the remaining bytes live in buffered_footer
+	std::istream &fs = using_buffered_footer ? static_cast<std::istream&>(buffered_footer) : f;
 	unsigned l1;
 	std::string s;
-	for (int c = f.peek(); c != EOF; c = f.peek(), ++line_count) {
+	for (int c = fs.peek(); c != EOF; c = fs.peek(), ++line_count) {
 		if (c == 'i' || c == 'l' || c == 'o' || c == 'b') {
-			f.ignore(1);
-			if (!(f >> l1 >> s))
+			fs.ignore(1);
+			if (!(fs >> l1 >> s))
 				log_error("Line %u cannot be interpreted as a symbol entry!\n", line_count);
 
 			if ((c == 'i' && l1 > inputs.size()) || (c == 'l' && l1 > latches.size()) || (c == 'o' && l1 > outputs.size()))
@@ -307,17 +311,17 @@ end_of_header:
 			// TODO
 		}
 		else if (c == 'c') {
-			f.ignore(1);
-			if (f.peek() == '\r')
-				f.ignore(1);
-			if (f.peek() == '\n')
+			fs.ignore(1);
+			if (fs.peek() == '\r')
+				fs.ignore(1);
+			if (fs.peek() == '\n')
 				break;
 			// Else constraint (TODO)
 		}
 		else
 			log_error("Line %u: cannot interpret first character '%c'!\n", line_count, c);
 next:
-		std::getline(f, line); // Ignore up to start of next line
+		std::getline(fs, line); // Ignore up to start of next line
 	}
 
 	post_process();
@@ -337,6 +341,19 @@ static uint32_t parse_xaiger_literal(std::istream &f)
 }
 
 RTLIL::Wire* AigerReader::createWireIfNotExists(RTLIL::Module *module, unsigned literal)
+{
+	// valid literals are bounded by 2*M+1, so almost every lookup is served
+	// from the cache without re-building the wire name
+	if (literal < wire_cache.size()) {
+		RTLIL::Wire *&cached = wire_cache[literal];
+		if (!cached)
+			cached = lookupOrCreateWire(module, literal);
+		return cached;
+	}
+	return lookupOrCreateWire(module, literal);
+}
+
+RTLIL::Wire* AigerReader::lookupOrCreateWire(RTLIL::Module *module, unsigned literal)
 {
 	const unsigned variable = literal >> 1;
 	const bool invert = literal & 1;
@@ -385,6 +402,8 @@ void AigerReader::parse_xaiger()
 
 	log_debug("M=%u I=%u L=%u O=%u A=%u\n", M, I, L, O, A);
 
+	wire_cache.assign(2*(M+1), nullptr);
+
 	line_count = 1;
 	piNum = 0;
 	flopNum = 0;
@@ -400,32 +419,35 @@ void AigerReader::parse_xaiger()
 	if (n0)
 		module->connect(n0, State::S0);
 
-	int c = f.get();
+	// After a binary AND section the remaining bytes live in buffered_footer
+	std::istream &fs = using_buffered_footer ? static_cast<std::istream&>(buffered_footer) : f;
+
+	int c = fs.get();
 	if (c != 'c')
 		log_error("Line %u: cannot interpret first character '%c'!\n", line_count, c);
-	if (f.peek() == '\n')
-		f.get();
+	if (fs.peek() == '\n')
+		fs.get();
 
 	// Parse footer (symbol table, comments, etc.)
 	std::string s;
-	for (int c = f.get(); c != EOF; c = f.get()) {
+	for (int c = fs.get(); c != EOF; c = fs.get()) {
 		// XAIGER extensions
 		if (c == 'm') {
-			uint32_t dataSize = parse_xaiger_literal(f);
-			uint32_t lutNum = parse_xaiger_literal(f);
-			uint32_t lutSize = parse_xaiger_literal(f);
+			uint32_t dataSize = parse_xaiger_literal(fs);
+			uint32_t lutNum = parse_xaiger_literal(fs);
+			uint32_t lutSize = parse_xaiger_literal(fs);
 			log_debug("m: dataSize=%u lutNum=%u lutSize=%u\n", dataSize, lutNum, lutSize);
 			ConstEvalAig ce(module);
 			for (unsigned i = 0; i < lutNum; ++i) {
-				uint32_t rootNodeID = parse_xaiger_literal(f);
-				uint32_t cutLeavesM = parse_xaiger_literal(f);
+				uint32_t rootNodeID = parse_xaiger_literal(fs);
+				uint32_t cutLeavesM = parse_xaiger_literal(fs);
 				log_debug2("rootNodeID=%d cutLeavesM=%d\n", rootNodeID, cutLeavesM);
 				RTLIL::Wire *output_sig = module->wire(stringf("$aiger%d$%d", aiger_autoidx, rootNodeID));
 				log_assert(output_sig);
 				uint32_t nodeID;
 				RTLIL::SigSpec input_sig;
 				for (unsigned j = 0; j < cutLeavesM; ++j) {
-					nodeID = parse_xaiger_literal(f);
+					nodeID = parse_xaiger_literal(fs);
 					log_debug2("\t%u\n", nodeID);
 					if (nodeID == 0) {
 						log_debug("\tLUT '$lut$aiger%d$%d' input %d is constant!\n", aiger_autoidx, rootNodeID, cutLeavesM);
@@ -457,47 +479,47 @@ void AigerReader::parse_xaiger()
 			}
 		}
 		else if (c == 'r') {
-			uint32_t dataSize = parse_xaiger_literal(f);
-			flopNum = parse_xaiger_literal(f);
+			uint32_t dataSize = parse_xaiger_literal(fs);
+			flopNum = parse_xaiger_literal(fs);
 			log_debug("flopNum = %u\n", flopNum);
 			log_assert(dataSize == (flopNum+1) * sizeof(uint32_t));
 			mergeability.reserve(flopNum);
 			for (unsigned i = 0; i < flopNum; i++)
-				mergeability.emplace_back(parse_xaiger_literal(f));
+				mergeability.emplace_back(parse_xaiger_literal(fs));
 		}
 		else if (c == 's') {
-			uint32_t dataSize = parse_xaiger_literal(f);
-			flopNum = parse_xaiger_literal(f);
+			uint32_t dataSize = parse_xaiger_literal(fs);
+			flopNum = parse_xaiger_literal(fs);
 			log_assert(dataSize == (flopNum+1) * sizeof(uint32_t));
 			initial_state.reserve(flopNum);
 			for (unsigned i = 0; i < flopNum; i++)
-				initial_state.emplace_back(parse_xaiger_literal(f));
+				initial_state.emplace_back(parse_xaiger_literal(fs));
 		}
 		else if (c == 'n') {
-			parse_xaiger_literal(f);
-			f >> s;
+			parse_xaiger_literal(fs);
+			fs >> s;
 			log_debug("n: '%s'\n", s.c_str());
 		}
 		else if (c == 'h') {
-			f.ignore(sizeof(uint32_t));
-			uint32_t version = parse_xaiger_literal(f);
+			fs.ignore(sizeof(uint32_t));
+			uint32_t version = parse_xaiger_literal(fs);
 			log_assert(version == 1);
-			uint32_t ciNum = parse_xaiger_literal(f);
+			uint32_t ciNum = parse_xaiger_literal(fs);
 			log_debug("ciNum = %u\n", ciNum);
-			uint32_t coNum = parse_xaiger_literal(f);
+			uint32_t coNum = parse_xaiger_literal(fs);
 			log_debug("coNum = %u\n", coNum);
-			piNum = parse_xaiger_literal(f);
+			piNum = parse_xaiger_literal(fs);
 			log_debug("piNum = %u\n", piNum);
-			uint32_t poNum = parse_xaiger_literal(f);
+			uint32_t poNum = parse_xaiger_literal(fs);
 			log_debug("poNum = %u\n", poNum);
-			uint32_t boxNum = parse_xaiger_literal(f);
+			uint32_t boxNum = parse_xaiger_literal(fs);
 			log_debug("boxNum = %u\n", boxNum);
 			for (unsigned i = 0; i < boxNum; i++) {
-				uint32_t boxInputs = parse_xaiger_literal(f);
-				uint32_t boxOutputs = parse_xaiger_literal(f);
-				uint32_t boxUniqueId = parse_xaiger_literal(f);
+				uint32_t boxInputs = parse_xaiger_literal(fs);
+				uint32_t boxOutputs = parse_xaiger_literal(fs);
+				uint32_t boxUniqueId = parse_xaiger_literal(fs);
 				log_assert(boxUniqueId > 0);
-				uint32_t oldBoxNum = parse_xaiger_literal(f);
+				uint32_t oldBoxNum = parse_xaiger_literal(fs);
 				RTLIL::Cell* cell = module->addCell(stringf("$box%u", oldBoxNum), stringf("$__boxid%u", boxUniqueId));
 				cell->setPort(ID(i), SigSpec(State::S0, boxInputs));
 				cell->setPort(ID(o), SigSpec(State::S0, boxOutputs));
@@ -506,8 +528,8 @@ void AigerReader::parse_xaiger()
 			}
 		}
 		else if (c == 'a' || c == 'i' || c == 'o' || c == 's') {
-			uint32_t dataSize = parse_xaiger_literal(f);
-			f.ignore(dataSize);
+			uint32_t dataSize = parse_xaiger_literal(fs);
+			fs.ignore(dataSize);
 			log_debug("ignoring '%c'\n", c);
 		}
 		else {
@@ -638,12 +660,18 @@ void AigerReader::parse_aiger_ascii()
 	}
 }
 
-static unsigned parse_next_delta_literal(std::istream &f, unsigned ref)
+static unsigned parse_next_delta_literal(const unsigned char *&p, const unsigned char *end, unsigned ref, unsigned line_count)
 {
 	unsigned x = 0, i = 0;
 	unsigned char ch;
-	while ((ch = f.get()) & 0x80)
+	for (;;) {
+		if (p == end)
+			log_error("Line %u: unexpected end of file in AND section!\n", line_count);
+		ch = *p++;
+		if (!(ch & 0x80))
+			break;
 		x |= (ch & 0x7f) << (7 * i++);
+	}
 	return ref - (x | (ch << (7 * i)));
 }
 
@@ -748,10 +776,26 @@ void AigerReader::parse_aiger_binary()
 		std::getline(f, line); // Ignore up to start of next line
 
 	// Parse AND
+	// Decoding the delta-encoded literals through the istream costs a
+	// virtual call per byte, which dominates parse time on large AIGs.
+	// Instead, read the remainder of the file into memory in one go, decode
+	// the AND section from the buffer, and hand whatever follows it back to
+	// the footer parser through buffered_footer.
+	std::string buffer;
+	char chunk[65536];
+	int rc;
+	while ((rc = readsome(f, chunk, sizeof(chunk))) > 0)
+		buffer.append(chunk, rc);
+
+	const unsigned char *begin = reinterpret_cast<const unsigned char*>(buffer.data());
+	const unsigned char *p = begin, *end = begin + buffer.size();
+
+	module->reserve(M+1, A);
+
 	l1 = (I+L+1) << 1;
 	for (unsigned i = 0; i < A; ++i, ++line_count, l1 += 2) {
-		l2 = parse_next_delta_literal(f, l1);
-		l3 = parse_next_delta_literal(f, l2);
+		l2 = parse_next_delta_literal(p, end, l1, line_count);
+		l3 = parse_next_delta_literal(p, end, l2, line_count);
 
 		log_debug2("%d %d %d is an AND\n", l1, l2, l3);
 		log_assert(!(l1 & 1));
@@ -760,6 +804,9 @@ void AigerReader::parse_aiger_binary()
 		RTLIL::Wire *i2_wire = createWireIfNotExists(module, l3);
 		module->addAndGate("$and" + o_wire->name.str(), i1_wire, i2_wire, o_wire);
 	}
+
+	buffered_footer.str(buffer.substr(p - begin));
+	using_buffered_footer = true;
 }
 
 void AigerReader::post_process()
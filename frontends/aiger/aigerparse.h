@@ -47,6 +47,16 @@ struct AigerReader
     std::vector<RTLIL::Cell*> boxes;
     std::vector<int> mergeability, initial_state;
 
+    // wires indexed by literal, so the hot parsing paths don't have to
+    // re-build the wire name and look it up in the module for every literal
+    std::vector<RTLIL::Wire*> wire_cache;
+
+    // the binary AND section is decoded from an in-memory buffer that is
+    // filled by reading the stream to its end; whatever follows the AND
+    // section is handed back to the footer parsers through this stream
+    std::istringstream buffered_footer;
+    bool using_buffered_footer = false;
+
     AigerReader(RTLIL::Design *design, std::istream &f, RTLIL::IdString module_name, RTLIL::IdString clk_name, std::string map_filename, bool wideports);
     void parse_aiger();
     void parse_xaiger();
@@ -55,6 +65,7 @@ struct AigerReader
     void post_process();
 
     RTLIL::Wire* createWireIfNotExists(RTLIL::Module *module, unsigned literal);
+    RTLIL::Wire* lookupOrCreateWire(RTLIL::Module *module, unsigned literal);
 };
 
 YOSYS_NAMESPACE_END
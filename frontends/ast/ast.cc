@@ -29,8 +29,11 @@
 
 #include "kernel/yosys.h"
 #include "libs/sha1/sha1.h"
+#include "backends/rtlil/rtlil_binary.h"
 #include "ast.h"
 
+#include <fstream>
+
 YOSYS_NAMESPACE_BEGIN
 
 using namespace AST;
@@ -39,6 +42,7 @@ using namespace AST_INTERNAL;
 // instantiate global variables (public API)
 namespace AST {
 	std::string current_filename;
+	std::string elaboration_cache_dir;
 	void (*set_line_num)(int) = NULL;
 	int (*get_line_num)() = NULL;
 }
@@ -48,7 +52,7 @@ namespace AST_INTERNAL {
 	bool flag_nodisplay, flag_dump_ast1, flag_dump_ast2, flag_no_dump_ptr, flag_dump_vlog1, flag_dump_vlog2, flag_dump_rtlil, flag_nolatches, flag_nomeminit;
 	bool flag_nomem2reg, flag_mem2reg, flag_noblackbox, flag_lib, flag_nowb, flag_noopt, flag_icells, flag_pwires, flag_autowire;
 	AstNode *current_ast, *current_ast_mod;
-	std::map<std::string, AstNode*> current_scope;
+	dict<std::string, AstNode*> current_scope;
 	const dict<RTLIL::SigBit, RTLIL::SigBit> *genRTLIL_subst_ptr = NULL;
 	RTLIL::SigSpec ignoreThisSignalsInInitial;
 	AstNode *current_always, *current_top_block, *current_block, *current_block_child;
@@ -197,6 +201,53 @@ bool AstNode::get_bool_attribute(RTLIL::IdString id)
 	return attr->integer != 0;
 }
 
+// block pool backing AstNode::operator new/delete (see ast.h for rationale);
+// the frontend is single-threaded, so no locking is needed. Blocks are never
+// returned to the system: they stay on the free list for reuse, which also
+// avoids any static destruction order issues with nodes owned by long-lived
+// AstModules.
+namespace {
+	union AstNodeSlot {
+		AstNodeSlot *next;
+		alignas(AstNode) unsigned char storage[sizeof(AstNode)];
+	};
+	AstNodeSlot *astnode_free_list = nullptr;
+}
+
+void *AstNode::operator new(size_t size)
+{
+	if (size != sizeof(AstNode))
+		return ::operator new(size);
+
+	if (astnode_free_list == nullptr) {
+		const int block_size = 4096;
+		AstNodeSlot *block = static_cast<AstNodeSlot*>(::operator new(block_size * sizeof(AstNodeSlot)));
+		for (int i = 0; i < block_size; i++) {
+			block[i].next = astnode_free_list;
+			astnode_free_list = &block[i];
+		}
+	}
+
+	AstNodeSlot *slot = astnode_free_list;
+	astnode_free_list = slot->next;
+	return slot;
+}
+
+void AstNode::operator delete(void *ptr, size_t size)
+{
+	if (ptr == nullptr)
+		return;
+
+	if (size != sizeof(AstNode)) {
+		::operator delete(ptr);
+		return;
+	}
+
+	AstNodeSlot *slot = static_cast<AstNodeSlot*>(ptr);
+	slot->next = astnode_free_list;
+	astnode_free_list = slot;
+}
+
 // create new node (AstNode constructor)
 // (the optional child arguments make it easier to create AST trees)
 AstNode::AstNode(AstNodeType type, AstNode *child1, AstNode *child2, AstNode *child3, AstNode *child4)
@@ -1036,7 +1087,7 @@ RTLIL::Const AstNode::realAsConst(int width)
 #else
 	if (!std::isfinite(v)) {
 #endif
-		result.bits = std::vector<RTLIL::State>(width, RTLIL::State::Sx);
+		result = RTLIL::Const(RTLIL::State::Sx, width);
 	} else {
 		bool is_negative = v < 0;
 		if (is_negative)
@@ -1230,6 +1281,18 @@ static RTLIL::Module *process_module(RTLIL::Design *design, AstNode *ast, bool d
 				ast->input_error("Attribute `%s' with non-constant value!\n", attr.first.c_str());
 			module->attributes[attr.first] = attr.second->asAttrConst();
 		}
+		// pre-size the module's wire and cell tables; the AST node counts are
+		// only a lower bound (genRTLIL() creates additional helper wires and
+		// cells), but they cover the bulk of large generated modules
+		int num_wires = 0, num_cells = 0;
+		for (const AstNode *node : ast->children) {
+			if (node->type == AST_WIRE)
+				num_wires++;
+			else if (node->type == AST_CELL)
+				num_cells++;
+		}
+		module->reserve(num_wires, num_cells);
+
 		for (size_t i = 0; i < ast->children.size(); i++) {
 			AstNode *node = ast->children[i];
 			if (node->type == AST_WIRE || node->type == AST_MEMORY)
@@ -1371,7 +1434,7 @@ void AST::process(RTLIL::Design *design, AstNode *ast, bool nodisplay, bool dump
 	ast->fixup_hierarchy_flags(true);
 
 	log_assert(current_ast->type == AST_DESIGN);
-	for (AstNode *child : current_ast->children)
+	for (AstNode *&child : current_ast->children)
 	{
 		if (child->type == AST_MODULE || child->type == AST_INTERFACE)
 		{
@@ -1428,7 +1491,15 @@ void AST::process(RTLIL::Design *design, AstNode *ast, bool nodisplay, bool dump
 				}
 			}
 
-			process_module(design, child, defer_local);
+			if (defer_local) {
+				// the stored AST is all that is kept of a deferred module, so
+				// hand the child node to the AstModule directly instead of
+				// cloning it only for the original to be deleted along with
+				// the design AST
+				process_module(design, child, defer_local, child);
+				child = nullptr;
+			} else
+				process_module(design, child, defer_local);
 			current_ast_mod = nullptr;
 		}
 		else if (child->type == AST_PACKAGE) {
@@ -1451,6 +1522,10 @@ void AST::process(RTLIL::Design *design, AstNode *ast, bool nodisplay, bool dump
 			current_scope.clear();
 		}
 	}
+
+	// drop the entries of deferred modules whose AST ownership was transferred
+	current_ast->children.erase(std::remove(current_ast->children.begin(),
+			current_ast->children.end(), nullptr), current_ast->children.end());
 }
 
 // AstModule destructor
@@ -1719,7 +1794,180 @@ RTLIL::IdString AstModule::derive(RTLIL::Design *design, const dict<RTLIL::IdStr
 	return modname;
 }
 
+// ---- on-disk elaboration cache -------------------------------------------
+//
+// When AST::elaboration_cache_dir is set (via `hierarchy -cache <dir>`),
+// AstModule::derive() stores each elaborated specialization as a binary RTLIL
+// file named after a digest of the module AST (including source locations,
+// so stale src attributes cannot leak out of the cache), the parameter
+// values, the elaboration flags and the yosys version. A later run that
+// derives the same specialization from unchanged source loads the RTLIL
+// instead of re-running simplify and genRTLIL. Cached loads produce plain
+// RTLIL::Modules without a stored AST, so only the parameters-only derive
+// path (no interfaces, which need later AST reprocessing) uses the cache.
+
+static void elab_cache_hash(uint64_t &h, const void *data, size_t len)
+{
+	const unsigned char *p = (const unsigned char*)data;
+	for (size_t i = 0; i < len; i++)
+		h = (h ^ p[i]) * 0x100000001b3ull;
+}
+
+static void elab_cache_hash_int(uint64_t &h, int64_t value)
+{
+	elab_cache_hash(h, &value, sizeof(value));
+}
+
+static void elab_cache_hash_string(uint64_t &h, const std::string &str)
+{
+	elab_cache_hash_int(h, GetSize(str));
+	elab_cache_hash(h, str.data(), str.size());
+}
+
+static std::string serialize_param_value(const RTLIL::Const &val);
+
+static void elab_cache_hash_node(uint64_t &h, const AstNode *node)
+{
+	elab_cache_hash_int(h, node->type);
+	elab_cache_hash_string(h, node->str);
+
+	elab_cache_hash_int(h, GetSize(node->bits));
+	for (auto bit : node->bits)
+		elab_cache_hash_int(h, bit);
+
+	uint32_t flags = 0;
+	for (bool flag : {node->is_input, node->is_output, node->is_reg, node->is_logic,
+			node->is_signed, node->is_string, node->is_wand, node->is_wor,
+			node->range_valid, node->range_swapped, node->is_unsized,
+			node->is_custom_type, node->is_enum})
+		flags = (flags << 1) | (flag ? 1 : 0);
+	elab_cache_hash_int(h, flags);
+
+	elab_cache_hash_int(h, node->port_id);
+	elab_cache_hash_int(h, node->range_left);
+	elab_cache_hash_int(h, node->range_right);
+	elab_cache_hash_int(h, node->unpacked_dimensions);
+	elab_cache_hash_int(h, node->integer);
+	elab_cache_hash(h, &node->realvalue, sizeof(node->realvalue));
+
+	elab_cache_hash_int(h, GetSize(node->dimensions));
+	for (auto &dim : node->dimensions) {
+		elab_cache_hash_int(h, dim.range_right);
+		elab_cache_hash_int(h, dim.range_width);
+		elab_cache_hash_int(h, dim.range_swapped);
+	}
+
+	elab_cache_hash_string(h, node->filename);
+	elab_cache_hash_int(h, node->location.first_line);
+	elab_cache_hash_int(h, node->location.first_column);
+	elab_cache_hash_int(h, node->location.last_line);
+	elab_cache_hash_int(h, node->location.last_column);
+
+	// sort attributes by name: the map is keyed by IdString index, which is
+	// not stable across runs
+	std::vector<std::pair<std::string, const AstNode*>> attrs;
+	for (auto &attr : node->attributes)
+		attrs.emplace_back(attr.first.str(), attr.second);
+	std::sort(attrs.begin(), attrs.end());
+	elab_cache_hash_int(h, GetSize(attrs));
+	for (auto &attr : attrs) {
+		elab_cache_hash_string(h, attr.first);
+		elab_cache_hash_node(h, attr.second);
+	}
+
+	elab_cache_hash_int(h, GetSize(node->children));
+	for (auto child : node->children)
+		elab_cache_hash_node(h, child);
+}
+
+static uint64_t elab_cache_key(const AstModule *mod, const dict<RTLIL::IdString, RTLIL::Const> &parameters, const std::string &modname)
+{
+	uint64_t h = 0xcbf29ce484222325ull;
+	elab_cache_hash_string(h, "YosysElabCache1");
+	elab_cache_hash_string(h, yosys_version_str);
+	elab_cache_hash_string(h, modname);
+
+	uint32_t flags = 0;
+	for (bool flag : {mod->nolatches, mod->nomeminit, mod->nomem2reg, mod->mem2reg,
+			mod->noblackbox, mod->lib, mod->nowb, mod->noopt, mod->icells,
+			mod->pwires, mod->autowire})
+		flags = (flags << 1) | (flag ? 1 : 0);
+	elab_cache_hash_int(h, flags);
+
+	std::vector<std::pair<std::string, std::string>> params;
+	for (auto &param : parameters)
+		params.emplace_back(param.first.str(), serialize_param_value(param.second));
+	std::sort(params.begin(), params.end());
+	elab_cache_hash_int(h, GetSize(params));
+	for (auto &param : params) {
+		elab_cache_hash_string(h, param.first);
+		elab_cache_hash_string(h, param.second);
+	}
+
+	elab_cache_hash_node(h, mod->ast);
+	return h;
+}
+
+static std::string elab_cache_path(uint64_t key)
+{
+	return elaboration_cache_dir + stringf("/%016llx.ilbin", (unsigned long long)key);
+}
+
+static bool elab_cache_load(RTLIL::Design *design, const std::string &modname, uint64_t key)
+{
+	std::string path = elab_cache_path(key);
+
+	// check the file header here: an unreadable, truncated or foreign file
+	// is a cache miss, not an error
+	std::ifstream header_check(path.c_str(), std::ifstream::binary);
+	char magic[8];
+	header_check.read(magic, sizeof(magic));
+	if (header_check.gcount() != sizeof(magic) || memcmp(magic, RTLIL_BINARY::magic, sizeof(magic)) != 0)
+		return false;
+	header_check.close();
+
+	RTLIL::Design cache_design;
+	Frontend::frontend_call(&cache_design, nullptr, path, "rtlil_bin");
+
+	RTLIL::Module *module = cache_design.module(RTLIL::IdString(modname));
+	if (module == nullptr)
+		return false;
+
+	cache_design.modules_.erase(module->name);
+	design->add(module);
+	return true;
+}
+
+static void elab_cache_save(RTLIL::Module *module, uint64_t key)
+{
+	std::string path = elab_cache_path(key);
+	std::string tmp_path = path + ".new";
+
+	// open the output here so an unwritable cache directory quietly
+	// disables saving instead of aborting the run
+	std::ofstream f(tmp_path.c_str(), std::ofstream::binary | std::ofstream::trunc);
+	if (f.fail())
+		return;
+
+	RTLIL::Design cache_design;
+	cache_design.add(module->clone());
+	Backend::backend_call(&cache_design, &f, tmp_path, "rtlil_bin");
+	f.close();
+
+	if (f.fail() || std::rename(tmp_path.c_str(), path.c_str()) != 0)
+		std::remove(tmp_path.c_str());
+}
+
 // create a new parametric module (when needed) and return the name of the generated module - without support for interfaces
+//
+// Derivations for distinct parameter sets are logically independent, but they
+// must run serially on the main thread: process_module() drives the full AST
+// simplifier, which works through the frontend's global state (current_ast,
+// current_ast_mod, the loadconfig() flags), mutates the design, logs, and
+// creates IdStrings — all of which the kernel ThreadPool forbids in workers.
+// The derived-name memo in derive_common() and the elaboration cache
+// (elaboration_cache_dir) are the supported ways of cutting repeated
+// elaboration cost instead.
 RTLIL::IdString AstModule::derive(RTLIL::Design *design, const dict<RTLIL::IdString, RTLIL::Const> &parameters, bool /*mayfail*/)
 {
 	bool quiet = lib || attributes.count(ID::blackbox) || attributes.count(ID::whitebox);
@@ -1728,9 +1976,21 @@ RTLIL::IdString AstModule::derive(RTLIL::Design *design, const dict<RTLIL::IdStr
 	std::string modname = derive_common(design, parameters, &new_ast, quiet);
 
 	if (!design->has(modname) && new_ast) {
-		new_ast->str = modname;
-		process_module(design, new_ast, false, NULL, quiet);
-		design->module(modname)->check();
+		uint64_t cache_key = 0;
+		bool cache_hit = false;
+		if (!elaboration_cache_dir.empty()) {
+			cache_key = elab_cache_key(this, parameters, modname);
+			cache_hit = elab_cache_load(design, modname, cache_key);
+			if (cache_hit && !quiet)
+				log("Loaded cached elaboration of module `%s'.\n", modname.c_str());
+		}
+		if (!cache_hit) {
+			new_ast->str = modname;
+			process_module(design, new_ast, false, NULL, quiet);
+			design->module(modname)->check();
+			if (!elaboration_cache_dir.empty())
+				elab_cache_save(design->module(modname), cache_key);
+		}
 	} else if (!quiet) {
 		log("Found cached RTLIL representation for module `%s'.\n", modname.c_str());
 	}
@@ -1773,6 +2033,18 @@ std::string AST::derived_module_name(std::string stripped_name, const std::vecto
 		return "$paramod" + stripped_name + para_info;
 }
 
+// Design-level memo of derived module names, keyed by the source module name
+// and the parameter binding. It is deliberately not a member of AstModule:
+// `hierarchy -libdir` and deferred reprocessing replace the AstModule object,
+// and a member cache would be lost with it while the already derived
+// specializations stay in the design. Entries only short-circuit the
+// parameter collection and name serialization below; the design->has() check
+// keeps them safe against removed modules, and the $paramod naming scheme
+// guarantees that a module of the cached name is the right specialization.
+// The parameter binding is the innermost key so lookups can pass the caller's
+// dict by reference instead of copying it into a composite key.
+static std::map<const RTLIL::Design*, dict<RTLIL::IdString, dict<dict<RTLIL::IdString, RTLIL::Const>, std::string>>> derived_names_cache;
+
 // create a new parametric module (when needed) and return the name of the generated module
 std::string AstModule::derive_common(RTLIL::Design *design, const dict<RTLIL::IdString, RTLIL::Const> &parameters, AstNode **new_ast_out, bool quiet)
 {
@@ -1782,6 +2054,12 @@ std::string AstModule::derive_common(RTLIL::Design *design, const dict<RTLIL::Id
 	if (stripped_name.compare(0, 9, "$abstract") == 0)
 		stripped_name = stripped_name.substr(9);
 
+	// a derivation that already produced a module in the design is free
+	auto &module_cache = derived_names_cache[design][name];
+	auto cache_it = module_cache.find(parameters);
+	if (cache_it != module_cache.end() && design->has(cache_it->second))
+		return cache_it->second;
+
 	int para_counter = 0;
 	std::vector<std::pair<RTLIL::IdString, RTLIL::Const>> named_parameters;
 	for (const auto child : ast->children) {
@@ -1808,6 +2086,8 @@ std::string AstModule::derive_common(RTLIL::Design *design, const dict<RTLIL::Id
 	if (parameters.size()) // not named_parameters to cover hierarchical defparams
 		modname = derived_module_name(stripped_name, named_parameters);
 
+	module_cache[parameters] = modname;
+
 	if (design->has(modname))
 		return modname;
 
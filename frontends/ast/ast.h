@@ -233,6 +233,15 @@ namespace AST
 		bool in_lvalue_from_above;
 		bool in_param_from_above;
 
+		// AstNodes are allocated from a dedicated block pool: elaboration
+		// creates and deletes enormous numbers of fixed-size nodes (clone()
+		// in simplify alone accounts for most of them), so carving nodes out
+		// of large blocks and recycling deleted nodes through a free list
+		// bounds the allocator overhead per node. Destructors run normally;
+		// the blocks themselves are retained for reuse.
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr, size_t size);
+
 		// creating and deleting nodes
 		AstNode(AstNodeType type = AST_NONE, AstNode *child1 = nullptr, AstNode *child2 = nullptr, AstNode *child3 = nullptr, AstNode *child4 = nullptr);
 		AstNode *clone() const;
@@ -403,6 +412,12 @@ namespace AST
 		void loadconfig() const;
 	};
 
+	// when non-empty, AstModule::derive() keeps an on-disk cache of
+	// elaborated modules (binary RTLIL files keyed by a digest of the module
+	// AST and the parameter values) in this directory, set by the
+	// `hierarchy -cache <dir>` option
+	extern std::string elaboration_cache_dir;
+
 	// this must be set by the language frontend before parsing the sources
 	// the AstNode constructor then uses current_filename and get_line_num()
 	// to initialize the filename and linenum properties of new nodes
@@ -440,7 +455,7 @@ namespace AST_INTERNAL
 	extern bool flag_nodisplay, flag_dump_ast1, flag_dump_ast2, flag_no_dump_ptr, flag_dump_rtlil, flag_nolatches, flag_nomeminit;
 	extern bool flag_nomem2reg, flag_mem2reg, flag_lib, flag_noopt, flag_icells, flag_pwires, flag_autowire;
 	extern AST::AstNode *current_ast, *current_ast_mod;
-	extern std::map<std::string, AST::AstNode*> current_scope;
+	extern dict<std::string, AST::AstNode*> current_scope;
 	extern const dict<RTLIL::SigBit, RTLIL::SigBit> *genRTLIL_subst_ptr;
 	extern RTLIL::SigSpec ignoreThisSignalsInInitial;
 	extern AST::AstNode *current_always, *current_top_block, *current_block, *current_block_child;
@@ -28,7 +28,7 @@ YOSYS_NAMESPACE_BEGIN
 
 typedef void (*ffi_fptr) ();
 
-static ffi_fptr resolve_fn (std::string symbol_name)
+static ffi_fptr resolve_fn_uncached (const std::string &symbol_name)
 {
 	if (symbol_name.find(':') != std::string::npos)
 	{
@@ -64,64 +64,147 @@ static ffi_fptr resolve_fn (std::string symbol_name)
 	log_error("unable to resolve '%s'.\n", symbol_name.c_str());
 }
 
+static ffi_fptr resolve_fn (const std::string &symbol_name)
+{
+	// resolving a symbol searches every loaded plugin with dlsym; constant
+	// folding can call the same function millions of times, so cache the
+	// result (the set of loaded plugins is assumed to be stable while the
+	// AST is elaborated)
+	static dict<std::string, ffi_fptr> cache;
+	auto it = cache.find(symbol_name);
+	if (it != cache.end())
+		return it->second;
+	ffi_fptr fptr = resolve_fn_uncached(symbol_name);
+	cache[symbol_name] = fptr;
+	return fptr;
+}
+
+// an ffi_cif keeps a pointer into its argument type array, so both are kept
+// together and cached per call signature
+struct dpi_prepared_cif {
+	std::vector<ffi_type*> types;
+	ffi_cif cif;
+};
+
+static dpi_prepared_cif *prepare_cif(const std::string &rtype, const std::vector<std::string> &argtypes)
+{
+	static dict<std::string, std::unique_ptr<dpi_prepared_cif>> cache;
+
+	std::string sig = rtype;
+	for (auto &argtype : argtypes) {
+		sig += ',';
+		sig += argtype;
+	}
+
+	auto it = cache.find(sig);
+	if (it != cache.end())
+		return it->second.get();
+
+	std::unique_ptr<dpi_prepared_cif> pcif(new dpi_prepared_cif);
+	pcif->types.resize(argtypes.size() + 1);
+
+	for (int i = 0; i < GetSize(argtypes); i++) {
+		if (argtypes[i] == "real")
+			pcif->types[i] = &ffi_type_double;
+		else if (argtypes[i] == "shortreal")
+			pcif->types[i] = &ffi_type_double;
+		else if (argtypes[i] == "integer")
+			pcif->types[i] = &ffi_type_sint32;
+		else if (argtypes[i] == "chandle")
+			pcif->types[i] = &ffi_type_pointer;
+		else
+			log_error("invalid argtype '%s' for argument %d.\n", argtypes[i].c_str(), i);
+	}
+
+	if (rtype == "integer")
+		pcif->types[argtypes.size()] = &ffi_type_slong;
+	else if (rtype == "shortreal")
+		pcif->types[argtypes.size()] = &ffi_type_float;
+	else if (rtype == "real")
+		pcif->types[argtypes.size()] = &ffi_type_double;
+	else if (rtype == "chandle")
+		pcif->types[argtypes.size()] = &ffi_type_pointer;
+	else
+		log_error("invalid rtype '%s'.\n", rtype.c_str());
+
+	int status = ffi_prep_cif(&pcif->cif, FFI_DEFAULT_ABI, argtypes.size(), pcif->types[argtypes.size()], pcif->types.data());
+	if (status != FFI_OK)
+		log_error("ffi_prep_cif failed: status %d.\n", status);
+
+	dpi_prepared_cif *result = pcif.get();
+	cache[sig] = std::move(pcif);
+	return result;
+}
+
 AST::AstNode *AST::dpi_call(const std::string &rtype, const std::string &fname, const std::vector<std::string> &argtypes, const std::vector<AstNode*> &args)
 {
 	AST::AstNode *newNode = nullptr;
 	union { double f64; float f32; int32_t i32; void *ptr; } value_store [args.size() + 1];
-	ffi_type *types [args.size() + 1];
 	void *values [args.size() + 1];
-	ffi_cif cif;
-	int status;
 
 	log("Calling DPI function `%s' and returning `%s':\n", fname.c_str(), rtype.c_str());
 
 	log_assert(GetSize(args) == GetSize(argtypes));
+
+	// memoization key: function name, return type and the marshalled
+	// argument values; constant folding already assumes DPI functions are
+	// pure (their result replaces the call expression), so a repeated
+	// invocation with the same argument values can reuse the stored result
+	std::string memo_key = fname;
+	memo_key += '\0';
+	memo_key += rtype;
+
 	for (int i = 0; i < GetSize(args); i++) {
+		memo_key += '\0';
+		memo_key += argtypes[i];
+		memo_key += '\0';
 		if (argtypes[i] == "real") {
 			log("  arg %d (%s): %f\n", i, argtypes[i].c_str(), args[i]->asReal(args[i]->is_signed));
 			value_store[i].f64 = args[i]->asReal(args[i]->is_signed);
 			values[i] = &value_store[i].f64;
-			types[i] = &ffi_type_double;
+			memo_key.append(reinterpret_cast<const char*>(&value_store[i].f64), sizeof(double));
 		} else if (argtypes[i] == "shortreal") {
 			log("  arg %d (%s): %f\n", i, argtypes[i].c_str(), args[i]->asReal(args[i]->is_signed));
 			value_store[i].f32 = args[i]->asReal(args[i]->is_signed);
 			values[i] = &value_store[i].f32;
-			types[i] = &ffi_type_double;
+			memo_key.append(reinterpret_cast<const char*>(&value_store[i].f32), sizeof(float));
 		} else if (argtypes[i] == "integer") {
 			log("  arg %d (%s): %lld\n", i, argtypes[i].c_str(), (long long)args[i]->asInt(args[i]->is_signed));
 			value_store[i].i32 = args[i]->asInt(args[i]->is_signed);
 			values[i] = &value_store[i].i32;
-			types[i] = &ffi_type_sint32;
+			memo_key.append(reinterpret_cast<const char*>(&value_store[i].i32), sizeof(int32_t));
 		} else if (argtypes[i] == "chandle") {
 			log("  arg %d (%s): %llx\n", i, argtypes[i].c_str(), (unsigned long long)args[i]->asInt(false));
 			value_store[i].ptr = (void *)args[i]->asInt(args[i]->is_signed);
 			values[i] = &value_store[i].ptr;
-			types[i] = &ffi_type_pointer;
+			memo_key.append(reinterpret_cast<const char*>(&value_store[i].ptr), sizeof(void*));
 		} else {
 			log_error("invalid argtype '%s' for argument %d.\n", argtypes[i].c_str(), i);
 		}
 	}
 
+	static dict<std::string, AstNode*> memo_cache;
+	auto memo_it = memo_cache.find(memo_key);
+	if (memo_it != memo_cache.end()) {
+		log("  using cached return value\n");
+		return memo_it->second->clone();
+	}
+
+	dpi_prepared_cif *pcif = prepare_cif(rtype, argtypes);
+
         if (rtype == "integer") {
-                types[args.size()] = &ffi_type_slong;
                 values[args.size()] = &value_store[args.size()].i32;
         } else if (rtype == "shortreal") {
-                types[args.size()] = &ffi_type_float;
                 values[args.size()] = &value_store[args.size()].f32;
         } else if (rtype == "real") {
-                types[args.size()] = &ffi_type_double;
                 values[args.size()] = &value_store[args.size()].f64;
         } else if (rtype == "chandle") {
-                types[args.size()] = &ffi_type_pointer;
                 values[args.size()] = &value_store[args.size()].ptr;
         } else {
                 log_error("invalid rtype '%s'.\n", rtype.c_str());
         }
 
-        if ((status = ffi_prep_cif(&cif, FFI_DEFAULT_ABI, args.size(), types[args.size()], types)) != FFI_OK)
-                log_error("ffi_prep_cif failed: status %d.\n", status);
-
-        ffi_call(&cif, resolve_fn(fname.c_str()), values[args.size()], values);
+        ffi_call(&pcif->cif, resolve_fn(fname), values[args.size()], values);
 
 	if (rtype == "real") {
 		newNode = new AstNode(AST_REALVALUE);
@@ -143,6 +226,8 @@ AST::AstNode *AST::dpi_call(const std::string &rtype, const std::string &fname,
 		log("  return integer: %lld\n", (long long)newNode->asInt(true));
 	}
 
+	memo_cache[memo_key] = newNode->clone();
+
 	return newNode;
 }
 
@@ -446,6 +446,10 @@ struct AST_INTERNAL::ProcessGenerator
 		}
 
 		outputSignals = RTLIL::SigSpec(subst_lvalue_from);
+
+		// processes from unrolled generate blocks repeat the same signals
+		// thousands of times; share their storage right away
+		proc->intern();
 	}
 
 	void remove_unwanted_lvalue_bits(RTLIL::SigSpec &lhs, RTLIL::SigSpec &rhs)
@@ -1102,7 +1102,7 @@ bool AstNode::simplify(bool const_fold, int stage, int width_hint, bool sign_hin
 		std::set<std::string> existing;
 		int counter = 0;
 		label_genblks(existing, counter);
-		std::map<std::string, AstNode*> this_wire_scope;
+		dict<std::string, AstNode*> this_wire_scope;
 		for (size_t i = 0; i < children.size(); i++) {
 			AstNode *node = children[i];
 
@@ -5285,7 +5285,7 @@ bool AstNode::replace_variables(std::map<std::string, AstNode::varinfo_t> &varia
 // attempt to statically evaluate a functions with all-const arguments
 AstNode *AstNode::eval_const_function(AstNode *fcall, bool must_succeed)
 {
-	std::map<std::string, AstNode*> backup_scope = current_scope;
+	dict<std::string, AstNode*> backup_scope = current_scope;
 	std::map<std::string, AstNode::varinfo_t> variables;
 	std::vector<AstNode*> to_delete;
 	AstNode *block = new AstNode(AST_BLOCK);
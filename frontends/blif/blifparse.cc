@@ -25,7 +25,6 @@ const int lut_input_plane_limit = 12;
 
 static bool read_next_line(char *&buffer, size_t &buffer_size, int &line_count, std::istream &f)
 {
-	string strbuf;
 	int buffer_len = 0;
 	buffer[0] = 0;
 
@@ -45,13 +44,22 @@ static bool read_next_line(char *&buffer, size_t &buffer_size, int &line_count,
 			if (buffer_len > 0 && buffer[buffer_len-1] == '\\')
 				buffer[--buffer_len] = 0;
 			line_count++;
-			if (!std::getline(f, strbuf))
-				return false;
-			while (buffer_size-buffer_len < strbuf.size()+1) {
+			// read the line directly into the buffer instead of going
+			// through a temporary std::string, which would allocate once
+			// per input line
+			size_t pos = buffer_len;
+			for (;;) {
+				f.getline(buffer+pos, buffer_size-pos);
+				if (!f.fail())
+					break;
+				if (f.gcount() == 0)
+					return false;
+				// line did not fit: clear failbit, grow, keep reading
+				pos += f.gcount();
+				f.clear(f.rdstate() & ~std::ios::failbit);
 				buffer_size *= 2;
 				buffer = (char*)realloc(buffer, buffer_size);
 			}
-			strcpy(buffer+buffer_len, strbuf.c_str());
 		} else
 			return true;
 	}
@@ -94,28 +102,36 @@ void parse_blif(RTLIL::Design *design, std::istream &f, IdString dff_name, bool
 	std::string err_reason;
 	int blif_maxnum = 0, sopmode = -1;
 
-	auto blif_wire = [&](const std::string &wire_name) -> Wire*
+	// reused across calls to blif_wire to avoid allocating a std::string
+	// for every token on the hot .names/.latch/.gate paths
+	std::string esc_buffer;
+
+	auto blif_wire = [&](const char *wire_name) -> Wire*
 	{
 		if (wire_name[0] == '$')
 		{
-			for (int i = 0; i+1 < GetSize(wire_name); i++)
+			for (int i = 0; wire_name[i] && wire_name[i+1]; i++)
 			{
 				if (wire_name[i] != '$')
 					continue;
 
 				int len = 0;
-				while (i+len+1 < GetSize(wire_name) && '0' <= wire_name[i+len+1] && wire_name[i+len+1] <= '9')
+				while ('0' <= wire_name[i+len+1] && wire_name[i+len+1] <= '9')
 					len++;
 
 				if (len > 0) {
-					string num_str = wire_name.substr(i+1, len);
-					int num = atoi(num_str.c_str()) & 0x0fffffff;
+					int num = atoi(wire_name + i+1) & 0x0fffffff;
 					blif_maxnum = std::max(blif_maxnum, num);
 				}
 			}
 		}
 
-		IdString wire_id = RTLIL::escape_id(wire_name);
+		esc_buffer.clear();
+		if (wire_name[0] != 0 && wire_name[0] != '\\' && wire_name[0] != '$')
+			esc_buffer += '\\';
+		esc_buffer += wire_name;
+
+		IdString wire_id(esc_buffer);
 		Wire *wire = module->wire(wire_id);
 
 		if (wire == nullptr)
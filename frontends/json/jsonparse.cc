@@ -30,6 +30,12 @@ struct JsonNode
 	dict<string, JsonNode*> data_dict;
 	vector<string> data_dict_keys;
 
+	JsonNode()
+	{
+		type = 0;
+		data_number = 0;
+	}
+
 	JsonNode(std::istream &f)
 	{
 		type = 0;
@@ -242,6 +248,241 @@ struct JsonNode
 	}
 };
 
+// streaming variant of the JsonNode dict parser: 'f' must be positioned at a
+// JSON dict, and 'on_member' is called once per member with the stream
+// positioned at the member's value, which it must consume. This way the
+// caller decides per member how much of the tree to hold in memory.
+static void json_parse_dict_stream(std::istream &f, const char *what, const std::function<void(string)> &on_member)
+{
+	while (1)
+	{
+		int ch = f.get();
+
+		if (ch == EOF)
+			log_error("Unexpected EOF in JSON file.\n");
+
+		if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n')
+			continue;
+
+		if (ch != '{')
+			log_error("JSON %s node is not a dictionary.\n", what);
+
+		break;
+	}
+
+	while (1)
+	{
+		int ch = f.get();
+
+		if (ch == EOF)
+			log_error("Unexpected EOF in JSON file.\n");
+
+		if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == ',')
+			continue;
+
+		if (ch == '}')
+			break;
+
+		f.unget();
+		JsonNode key(f);
+
+		if (key.type != 'S')
+			log_error("Unexpected non-string key in JSON dict.\n");
+
+		while (1)
+		{
+			ch = f.get();
+
+			if (ch == EOF)
+				log_error("Unexpected EOF in JSON file.\n");
+
+			if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == ':')
+				continue;
+
+			f.unget();
+			break;
+		}
+
+		on_member(std::move(key.data_string));
+	}
+}
+
+// CBOR (RFC 8949) support for files written by `write_json -binary`. The
+// decoder builds the same JsonNode trees as the text parser, so everything
+// downstream of the parsing stage is shared between both formats.
+
+static int cbor_get(std::istream &f)
+{
+	int ch = f.get();
+	if (ch == EOF)
+		log_error("Unexpected EOF in CBOR file.\n");
+	return ch;
+}
+
+static uint64_t cbor_argument(std::istream &f, int info)
+{
+	if (info < 24)
+		return info;
+	if (info > 27)
+		log_error("Unsupported CBOR additional information value %d.\n", info);
+	uint64_t value = 0;
+	for (int i = 0; i < (1 << (info - 24)); i++)
+		value = (value << 8) | cbor_get(f);
+	return value;
+}
+
+// reads the initial byte of a data item, skipping any tags; returns the major
+// type and stores the additional information bits in 'info'
+static int cbor_head(std::istream &f, int &info)
+{
+	int ch = cbor_get(f);
+	while ((ch >> 5) == 6) {
+		cbor_argument(f, ch & 31);
+		ch = cbor_get(f);
+	}
+	info = ch & 31;
+	return ch >> 5;
+}
+
+static void cbor_read_chunk(std::istream &f, int info, string &s)
+{
+	uint64_t len = cbor_argument(f, info);
+	size_t pos = s.size();
+	s.resize(pos + len);
+	f.read(&s[pos], len);
+	if ((uint64_t)f.gcount() != len)
+		log_error("Unexpected EOF in CBOR string.\n");
+}
+
+static void cbor_parse_string(std::istream &f, int major, int info, string &s)
+{
+	if (info != 31) {
+		cbor_read_chunk(f, info, s);
+		return;
+	}
+
+	// indefinite-length string: a concatenation of definite-length chunks
+	while (1) {
+		int ch = cbor_get(f);
+		if (ch == 0xff)
+			break;
+		if ((ch >> 5) != major || (ch & 31) == 31)
+			log_error("Invalid chunk in indefinite-length CBOR string.\n");
+		cbor_read_chunk(f, ch & 31, s);
+	}
+}
+
+static void cbor_parse_node(std::istream &f, JsonNode &node);
+
+static JsonNode *cbor_parse_new_node(std::istream &f)
+{
+	JsonNode *node = new JsonNode;
+	cbor_parse_node(f, *node);
+	return node;
+}
+
+static void cbor_parse_dict_member(std::istream &f, JsonNode &node)
+{
+	JsonNode key;
+	cbor_parse_node(f, key);
+
+	if (key.type != 'S')
+		log_error("Unexpected non-string key in CBOR dict.\n");
+
+	node.data_dict[key.data_string] = cbor_parse_new_node(f);
+	node.data_dict_keys.push_back(key.data_string);
+}
+
+static void cbor_parse_node(std::istream &f, JsonNode &node)
+{
+	int info;
+	int major = cbor_head(f, info);
+
+	switch (major)
+	{
+	case 0:
+		node.type = 'N';
+		node.data_number = cbor_argument(f, info);
+		break;
+
+	case 1:
+		node.type = 'N';
+		node.data_number = -1 - (int64_t)cbor_argument(f, info);
+		break;
+
+	case 2:
+	case 3:
+		node.type = 'S';
+		cbor_parse_string(f, major, info, node.data_string);
+		break;
+
+	case 4:
+		node.type = 'A';
+		if (info == 31) {
+			while (f.peek() != 0xff)
+				node.data_array.push_back(cbor_parse_new_node(f));
+			cbor_get(f);
+		} else {
+			uint64_t len = cbor_argument(f, info);
+			for (uint64_t i = 0; i < len; i++)
+				node.data_array.push_back(cbor_parse_new_node(f));
+		}
+		break;
+
+	case 5:
+		node.type = 'D';
+		if (info == 31) {
+			while (f.peek() != 0xff)
+				cbor_parse_dict_member(f, node);
+			cbor_get(f);
+		} else {
+			uint64_t len = cbor_argument(f, info);
+			for (uint64_t i = 0; i < len; i++)
+				cbor_parse_dict_member(f, node);
+		}
+		break;
+
+	case 7:
+		if (info == 20 || info == 21) {
+			node.type = 'N';
+			node.data_number = (info == 21);
+			break;
+		}
+		log_error("Unsupported CBOR simple or floating-point value (info %d).\n", info);
+
+	default:
+		log_abort();
+	}
+}
+
+// CBOR counterpart to json_parse_dict_stream
+static void cbor_parse_dict_stream(std::istream &f, const char *what, const std::function<void(string)> &on_member)
+{
+	int info;
+	if (cbor_head(f, info) != 5)
+		log_error("CBOR %s node is not a dictionary.\n", what);
+
+	if (info == 31) {
+		while (f.peek() != 0xff) {
+			JsonNode key;
+			cbor_parse_node(f, key);
+			if (key.type != 'S')
+				log_error("Unexpected non-string key in CBOR dict.\n");
+			on_member(std::move(key.data_string));
+		}
+		cbor_get(f);
+	} else {
+		uint64_t len = cbor_argument(f, info);
+		for (uint64_t i = 0; i < len; i++) {
+			JsonNode key;
+			cbor_parse_node(f, key);
+			if (key.type != 'S')
+				log_error("Unexpected non-string key in CBOR dict.\n");
+			on_member(std::move(key.data_string));
+		}
+	}
+}
+
 Const json_parse_attr_param_value(JsonNode *node)
 {
 	Const value;
@@ -630,6 +871,9 @@ struct JsonFrontend : public Frontend {
 		log("Load modules from a JSON file into the current design See \"help write_json\"\n");
 		log("for a description of the file format.\n");
 		log("\n");
+		log("Binary CBOR files created with \"write_json -binary\" are detected and read\n");
+		log("automatically.\n");
+		log("\n");
 	}
 	void execute(std::istream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) override
 	{
@@ -644,23 +888,41 @@ struct JsonFrontend : public Frontend {
 			// }
 			break;
 		}
-		extra_args(f, filename, args, argidx);
-
-		JsonNode root(*f);
-
-		if (root.type != 'D')
-			log_error("JSON root node is not a dictionary.\n");
+		extra_args(f, filename, args, argidx, /*bin_input=*/true);
 
-		if (root.data_dict.count("modules") != 0)
+		// files written by `write_json -binary` start with the self-describing
+		// CBOR tag; text JSON can never start with that byte
+		if (f->peek() == 0xd9)
 		{
-			JsonNode *modules = root.data_dict.at("modules");
-
-			if (modules->type != 'D')
-				log_error("JSON modules node is not a dictionary.\n");
-
-			for (auto &it : modules->data_dict)
-				json_import(design, it.first, it.second);
+			cbor_parse_dict_stream(*f, "root", [&](string key) {
+				if (key == "modules") {
+					cbor_parse_dict_stream(*f, "modules", [&](string modname) {
+						JsonNode node;
+						cbor_parse_node(*f, node);
+						json_import(design, modname, &node);
+					});
+				} else {
+					// parse and discard other root members (creator etc.)
+					JsonNode node;
+					cbor_parse_node(*f, node);
+				}
+			});
+			return;
 		}
+
+		// stream the root and modules dicts instead of building a DOM of the
+		// whole file, so only one module's JSON is in memory at a time
+		json_parse_dict_stream(*f, "root", [&](string key) {
+			if (key == "modules") {
+				json_parse_dict_stream(*f, "modules", [&](string modname) {
+					JsonNode node(*f);
+					json_import(design, modname, &node);
+				});
+			} else {
+				// parse and discard other root members (creator etc.)
+				JsonNode node(*f);
+			}
+		});
 	}
 } JsonFrontend;
 
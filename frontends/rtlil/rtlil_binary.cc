@@ -0,0 +1,389 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ *  ---
+ *
+ *  Reader for the binary RTLIL checkpoint format written by
+ *  write_rtlil_bin. See backends/rtlil/rtlil_binary.h for the file
+ *  layout. The whole file is loaded into memory in one read and then
+ *  decoded by bumping a pointer through the buffer, so loading a
+ *  checkpoint is I/O-bound rather than parse-bound.
+ *
+ */
+
+#include "backends/rtlil/rtlil_binary.h"
+#include "kernel/register.h"
+#include "kernel/log.h"
+
+USING_YOSYS_NAMESPACE
+YOSYS_NAMESPACE_BEGIN
+
+struct BinaryReader
+{
+	const unsigned char *p, *end;
+	std::vector<RTLIL::IdString> names;
+	RTLIL::Module *module = nullptr;
+
+	BinaryReader(const unsigned char *data, size_t size) : p(data), end(data + size) { }
+
+	void need(size_t n)
+	{
+		if (size_t(end - p) < n)
+			log_error("Unexpected end of binary RTLIL file.\n");
+	}
+
+	unsigned char read_u8()
+	{
+		need(1);
+		return *p++;
+	}
+
+	uint64_t read_uint()
+	{
+		uint64_t v = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			unsigned char byte = read_u8();
+			v |= uint64_t(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0)
+				return v;
+		}
+		log_error("Invalid varint in binary RTLIL file.\n");
+	}
+
+	int64_t read_int()
+	{
+		uint64_t v = read_uint();
+		return int64_t(v >> 1) ^ -int64_t(v & 1);
+	}
+
+	RTLIL::IdString read_name()
+	{
+		uint64_t index = read_uint();
+		if (index >= names.size())
+			log_error("Invalid string table index in binary RTLIL file.\n");
+		return names[index];
+	}
+
+	RTLIL::Const read_const()
+	{
+		RTLIL::Const data;
+		data.flags = read_uint();
+		uint64_t width = read_uint();
+		unsigned char tag = read_u8();
+		data.bits.reserve(width);
+
+		if (tag == RTLIL_BINARY::CONST_PACKED) {
+			unsigned char byte = 0;
+			for (uint64_t i = 0; i < width; i++) {
+				if (i % 8 == 0)
+					byte = read_u8();
+				data.bits.push_back((byte >> (i % 8)) & 1 ? State::S1 : State::S0);
+			}
+		} else if (tag == RTLIL_BINARY::CONST_STATES) {
+			for (uint64_t i = 0; i < width; i++) {
+				unsigned char bit = read_u8();
+				if (bit > State::Sm)
+					log_error("Invalid state value in binary RTLIL file.\n");
+				data.bits.push_back(RTLIL::State(bit));
+			}
+		} else
+			log_error("Invalid const encoding in binary RTLIL file.\n");
+
+		return data;
+	}
+
+	RTLIL::SigSpec read_sigspec()
+	{
+		RTLIL::SigSpec sig;
+		uint64_t nchunks = read_uint();
+		for (uint64_t i = 0; i < nchunks; i++) {
+			unsigned char tag = read_u8();
+			if (tag == RTLIL_BINARY::CHUNK_WIRE) {
+				RTLIL::IdString name = read_name();
+				int offset = read_uint();
+				int width = read_uint();
+				RTLIL::Wire *wire = module->wire(name);
+				if (wire == nullptr)
+					log_error("Invalid wire reference %s in binary RTLIL file.\n", log_id(name));
+				sig.append(RTLIL::SigChunk(wire, offset, width));
+			} else if (tag == RTLIL_BINARY::CHUNK_CONST) {
+				sig.append(read_const());
+			} else
+				log_error("Invalid sigspec chunk in binary RTLIL file.\n");
+		}
+		return sig;
+	}
+
+	void read_attributes(dict<RTLIL::IdString, RTLIL::Const> &attributes)
+	{
+		uint64_t count = read_uint();
+		for (uint64_t i = 0; i < count; i++) {
+			RTLIL::IdString name = read_name();
+			attributes[name] = read_const();
+		}
+	}
+
+	void read_wire()
+	{
+		RTLIL::IdString name = read_name();
+		int width = read_uint();
+		RTLIL::Wire *wire = module->addWire(name, width);
+		wire->start_offset = read_int();
+		wire->port_id = read_uint();
+		unsigned char flags = read_u8();
+		wire->port_input = (flags & 1) != 0;
+		wire->port_output = (flags & 2) != 0;
+		wire->upto = (flags & 4) != 0;
+		wire->is_signed = (flags & 8) != 0;
+		read_attributes(wire->attributes);
+	}
+
+	void read_memory()
+	{
+		RTLIL::Memory *memory = new RTLIL::Memory;
+		memory->name = read_name();
+		memory->width = read_uint();
+		memory->start_offset = read_int();
+		memory->size = read_uint();
+		read_attributes(memory->attributes);
+		module->memories[memory->name] = memory;
+	}
+
+	void read_cell()
+	{
+		RTLIL::IdString name = read_name();
+		RTLIL::IdString type = read_name();
+		RTLIL::Cell *cell = module->addCell(name, type);
+		read_attributes(cell->attributes);
+		uint64_t nparams = read_uint();
+		for (uint64_t i = 0; i < nparams; i++) {
+			RTLIL::IdString param = read_name();
+			cell->parameters[param] = read_const();
+		}
+		uint64_t nconns = read_uint();
+		for (uint64_t i = 0; i < nconns; i++) {
+			RTLIL::IdString port = read_name();
+			cell->setPort(port, read_sigspec());
+		}
+	}
+
+	void read_case(RTLIL::CaseRule *cs)
+	{
+		read_attributes(cs->attributes);
+		uint64_t ncompare = read_uint();
+		for (uint64_t i = 0; i < ncompare; i++)
+			cs->compare.push_back(read_sigspec());
+		uint64_t nactions = read_uint();
+		for (uint64_t i = 0; i < nactions; i++) {
+			RTLIL::SigSpec first = read_sigspec();
+			cs->actions.push_back(RTLIL::SigSig(first, read_sigspec()));
+		}
+		uint64_t nswitches = read_uint();
+		for (uint64_t i = 0; i < nswitches; i++) {
+			RTLIL::SwitchRule *sw = new RTLIL::SwitchRule;
+			cs->switches.push_back(sw);
+			read_attributes(sw->attributes);
+			sw->signal = read_sigspec();
+			uint64_t ncases = read_uint();
+			for (uint64_t j = 0; j < ncases; j++) {
+				RTLIL::CaseRule *c = new RTLIL::CaseRule;
+				sw->cases.push_back(c);
+				read_case(c);
+			}
+		}
+	}
+
+	void read_process()
+	{
+		RTLIL::Process *proc = module->addProcess(read_name());
+		read_attributes(proc->attributes);
+		read_case(&proc->root_case);
+		uint64_t nsyncs = read_uint();
+		for (uint64_t i = 0; i < nsyncs; i++) {
+			RTLIL::SyncRule *sync = new RTLIL::SyncRule;
+			proc->syncs.push_back(sync);
+			unsigned char type = read_u8();
+			if (type > RTLIL::STi)
+				log_error("Invalid sync type in binary RTLIL file.\n");
+			sync->type = RTLIL::SyncType(type);
+			sync->signal = read_sigspec();
+			uint64_t nactions = read_uint();
+			for (uint64_t j = 0; j < nactions; j++) {
+				RTLIL::SigSpec first = read_sigspec();
+				sync->actions.push_back(RTLIL::SigSig(first, read_sigspec()));
+			}
+			uint64_t nmemwr = read_uint();
+			for (uint64_t j = 0; j < nmemwr; j++) {
+				RTLIL::MemWriteAction action;
+				action.memid = read_name();
+				read_attributes(action.attributes);
+				action.address = read_sigspec();
+				action.data = read_sigspec();
+				action.enable = read_sigspec();
+				action.priority_mask = read_const();
+				sync->mem_write_actions.push_back(std::move(action));
+			}
+		}
+	}
+
+	void read_module(RTLIL::Design *design, bool flag_nooverwrite, bool flag_overwrite)
+	{
+		RTLIL::IdString name = read_name();
+		bool skip = false;
+
+		if (design->has(name)) {
+			RTLIL::Module *existing = design->module(name);
+			if (flag_overwrite || existing->get_blackbox_attribute()) {
+				design->remove(existing);
+			} else if (flag_nooverwrite) {
+				log("Ignoring re-definition of module %s.\n", log_id(name));
+				skip = true;
+			} else
+				log_error("Re-definition of module %s.\n", log_id(name));
+		}
+
+		module = design->addModule(skip ? RTLIL::IdString(stringf("$readbin_skip$%d", autoidx++)) : name);
+
+		read_attributes(module->attributes);
+
+		uint64_t nparams = read_uint();
+		for (uint64_t i = 0; i < nparams; i++) {
+			RTLIL::IdString param = read_name();
+			module->avail_parameters(param);
+			if (read_u8())
+				module->parameter_default_values[param] = read_const();
+		}
+
+		uint64_t nwires = read_uint();
+		for (uint64_t i = 0; i < nwires; i++)
+			read_wire();
+
+		uint64_t nmems = read_uint();
+		for (uint64_t i = 0; i < nmems; i++)
+			read_memory();
+
+		uint64_t ncells = read_uint();
+		for (uint64_t i = 0; i < ncells; i++)
+			read_cell();
+
+		uint64_t nprocs = read_uint();
+		for (uint64_t i = 0; i < nprocs; i++)
+			read_process();
+
+		uint64_t nconns = read_uint();
+		for (uint64_t i = 0; i < nconns; i++) {
+			RTLIL::SigSpec first = read_sigspec();
+			module->connect(first, read_sigspec());
+		}
+
+		module->fixup_ports();
+
+		if (skip)
+			design->remove(module);
+		module = nullptr;
+	}
+
+	void read_design(RTLIL::Design *design, bool flag_nooverwrite, bool flag_overwrite)
+	{
+		need(12);
+		if (memcmp(p, RTLIL_BINARY::magic, 8) != 0)
+			log_error("Not a binary RTLIL file (bad magic).\n");
+		p += 8;
+		uint32_t version = 0;
+		for (int i = 0; i < 4; i++)
+			version |= uint32_t(*p++) << (8*i);
+		if (version != RTLIL_BINARY::format_version)
+			log_error("Unsupported binary RTLIL format version %u (expected %u).\n",
+					(unsigned)version, (unsigned)RTLIL_BINARY::format_version);
+
+		uint64_t nstrings = read_uint();
+		names.reserve(nstrings);
+		for (uint64_t i = 0; i < nstrings; i++) {
+			uint64_t len = read_uint();
+			need(len);
+			names.push_back(RTLIL::IdString(std::string((const char*)p, len)));
+			p += len;
+		}
+
+		autoidx = max(autoidx, (int)read_uint());
+
+		uint64_t nmodules = read_uint();
+		for (uint64_t i = 0; i < nmodules; i++)
+			read_module(design, flag_nooverwrite, flag_overwrite);
+	}
+};
+
+struct RTLILBinFrontend : public Frontend {
+	RTLILBinFrontend() : Frontend("rtlil_bin", "read modules from binary RTLIL file") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    read_rtlil_bin [filename]\n");
+		log("\n");
+		log("Load modules from a binary RTLIL file (written by 'write_rtlil_bin') into\n");
+		log("the current design. The file is loaded in one read and decoded in memory,\n");
+		log("which is much faster than parsing the text RTLIL format.\n");
+		log("\n");
+		log("    -nooverwrite\n");
+		log("        ignore re-definitions of modules. (the default behavior is to\n");
+		log("        create an error message if the existing module is not a blackbox\n");
+		log("        module, and overwrite the existing module if it is a blackbox module.)\n");
+		log("\n");
+		log("    -overwrite\n");
+		log("        overwrite existing modules with the same name\n");
+		log("\n");
+	}
+	void execute(std::istream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		bool flag_nooverwrite = false;
+		bool flag_overwrite = false;
+
+		log_header(design, "Executing binary RTLIL frontend.\n");
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++) {
+			std::string arg = args[argidx];
+			if (arg == "-nooverwrite") {
+				flag_nooverwrite = true;
+				flag_overwrite = false;
+				continue;
+			}
+			if (arg == "-overwrite") {
+				flag_nooverwrite = false;
+				flag_overwrite = true;
+				continue;
+			}
+			break;
+		}
+		extra_args(f, filename, args, argidx, /*bin_input=*/true);
+
+		log("Input filename: %s\n", filename.c_str());
+
+		std::string buffer;
+		{
+			char chunk[65536];
+			while (f->read(chunk, sizeof(chunk)) || f->gcount())
+				buffer.append(chunk, f->gcount());
+		}
+
+		BinaryReader reader((const unsigned char*)buffer.data(), buffer.size());
+		reader.read_design(design, flag_nooverwrite, flag_overwrite);
+	}
+} RTLILBinFrontend;
+
+YOSYS_NAMESPACE_END
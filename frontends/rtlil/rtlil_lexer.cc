@@ -0,0 +1,321 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ *  ---
+ *
+ *  A very simple and straightforward frontend for the RTLIL text
+ *  representation.
+ *
+ *  This is a hand-written scanner that replaces the flex lexer the RTLIL
+ *  frontend used to have. It reads the whole input into one buffer up front
+ *  and scans it in place, which avoids flex's per-token buffer management and
+ *  makes read_rtlil on large checkpoint files considerably faster. The token
+ *  language is unchanged; the functions below keep the names of their
+ *  flex-generated predecessors so the bison parser and the frontend driver
+ *  need no changes.
+ *
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include "frontends/rtlil/rtlil_frontend.h"
+#include "rtlil_parser.tab.hh"
+
+USING_YOSYS_NAMESPACE
+
+namespace {
+
+std::string lexer_buffer;
+size_t lexer_pos = 0;
+int lexer_lineno = 1;
+
+bool is_digit(char c)
+{
+	return '0' <= c && c <= '9';
+}
+
+// characters allowed in a \name or $name identifier after the first one
+bool is_id_char(char c)
+{
+	return c != ' ' && c != '\t' && c != '\r' && c != '\n';
+}
+
+// digits allowed in the bits part of a TOK_VALUE constant
+bool is_value_digit(char c)
+{
+	return c == '0' || c == '1' || c == 'x' || c == 'z' || c == 'm' || c == '-';
+}
+
+char *token_strndup(const char *p, size_t len)
+{
+	char *s = (char*)malloc(len + 1);
+	memcpy(s, p, len);
+	s[len] = 0;
+	return s;
+}
+
+bool kw(const char *p, size_t len, const char *keyword)
+{
+	return strlen(keyword) == len && memcmp(p, keyword, len) == 0;
+}
+
+// map a run of lowercase letters to its keyword token, or TOK_INVALID
+int lookup_keyword(const char *p, size_t len)
+{
+	switch (p[0])
+	{
+	case 'a':
+		if (kw(p, len, "assign")) return TOK_ASSIGN;
+		if (kw(p, len, "attribute")) return TOK_ATTRIBUTE;
+		if (kw(p, len, "always")) return TOK_ALWAYS;
+		if (kw(p, len, "autoidx")) return TOK_AUTOIDX;
+		break;
+	case 'c':
+		if (kw(p, len, "cell")) return TOK_CELL;
+		if (kw(p, len, "connect")) return TOK_CONNECT;
+		if (kw(p, len, "case")) return TOK_CASE;
+		break;
+	case 'e':
+		if (kw(p, len, "end")) return TOK_END;
+		if (kw(p, len, "edge")) return TOK_EDGE;
+		break;
+	case 'g':
+		if (kw(p, len, "global")) return TOK_GLOBAL;
+		break;
+	case 'h':
+		if (kw(p, len, "high")) return TOK_HIGH;
+		break;
+	case 'i':
+		if (kw(p, len, "input")) return TOK_INPUT;
+		if (kw(p, len, "inout")) return TOK_INOUT;
+		if (kw(p, len, "init")) return TOK_INIT;
+		break;
+	case 'l':
+		if (kw(p, len, "low")) return TOK_LOW;
+		break;
+	case 'm':
+		if (kw(p, len, "module")) return TOK_MODULE;
+		if (kw(p, len, "memory")) return TOK_MEMORY;
+		if (kw(p, len, "memwr")) return TOK_MEMWR;
+		break;
+	case 'n':
+		if (kw(p, len, "negedge")) return TOK_NEGEDGE;
+		break;
+	case 'o':
+		if (kw(p, len, "output")) return TOK_OUTPUT;
+		if (kw(p, len, "offset")) return TOK_OFFSET;
+		break;
+	case 'p':
+		if (kw(p, len, "parameter")) return TOK_PARAMETER;
+		if (kw(p, len, "process")) return TOK_PROCESS;
+		if (kw(p, len, "posedge")) return TOK_POSEDGE;
+		break;
+	case 'r':
+		if (kw(p, len, "real")) return TOK_REAL;
+		break;
+	case 's':
+		if (kw(p, len, "switch")) return TOK_SWITCH;
+		if (kw(p, len, "sync")) return TOK_SYNC;
+		if (kw(p, len, "signed")) return TOK_SIGNED;
+		if (kw(p, len, "size")) return TOK_SIZE;
+		break;
+	case 'u':
+		if (kw(p, len, "update")) return TOK_UPDATE;
+		if (kw(p, len, "upto")) return TOK_UPTO;
+		break;
+	case 'w':
+		if (kw(p, len, "wire")) return TOK_WIRE;
+		if (kw(p, len, "width")) return TOK_WIDTH;
+		break;
+	}
+	return TOK_INVALID;
+}
+
+// unescape a string body (the characters between the quotes), using the same
+// escape sequences as the old flex action: \n, \t, one- to three-digit octal
+// escapes, and \<char> for everything else
+char *unescape_string(const char *p, size_t len)
+{
+	char *str = (char*)malloc(len + 1);
+	size_t i = 0, j = 0;
+	while (i < len) {
+		char c = p[i++];
+		if (c == '\\' && i < len) {
+			c = p[i++];
+			if (c == 'n')
+				c = '\n';
+			else if (c == 't')
+				c = '\t';
+			else if ('0' <= c && c <= '7') {
+				int value = c - '0';
+				if (i < len && '0' <= p[i] && p[i] <= '7')
+					value = value * 8 + (p[i++] - '0');
+				if (i < len && '0' <= p[i] && p[i] <= '7')
+					value = value * 8 + (p[i++] - '0');
+				c = value;
+			}
+		}
+		str[j++] = c;
+	}
+	str[j] = 0;
+	return str;
+}
+
+} /* anonymous namespace */
+
+int rtlil_frontend_yylex(void)
+{
+	const char *buf = lexer_buffer.data();
+	size_t size = lexer_buffer.size();
+
+	for (;;)
+	{
+		if (lexer_pos >= size)
+			return 0;
+
+		char ch = buf[lexer_pos];
+
+		if (ch == ' ' || ch == '\t') {
+			lexer_pos++;
+			continue;
+		}
+
+		if (ch == '\r' || ch == '\n') {
+			while (lexer_pos < size && (buf[lexer_pos] == '\r' || buf[lexer_pos] == '\n')) {
+				if (buf[lexer_pos] == '\n')
+					lexer_lineno++;
+				lexer_pos++;
+			}
+			return TOK_EOL;
+		}
+
+		if (ch == '#') {
+			while (lexer_pos < size && buf[lexer_pos] != '\n')
+				lexer_pos++;
+			continue;
+		}
+
+		if ('a' <= ch && ch <= 'z') {
+			size_t start = lexer_pos;
+			while (lexer_pos < size && 'a' <= buf[lexer_pos] && buf[lexer_pos] <= 'z')
+				lexer_pos++;
+			return lookup_keyword(buf + start, lexer_pos - start);
+		}
+
+		if (ch == '\\' || ch == '$') {
+			size_t start = lexer_pos++;
+			while (lexer_pos < size && is_id_char(buf[lexer_pos]))
+				lexer_pos++;
+			if (lexer_pos - start < 2)
+				return ch;
+			rtlil_frontend_yylval.string = token_strndup(buf + start, lexer_pos - start);
+			return TOK_ID;
+		}
+
+		if (is_digit(ch) || (ch == '-' && lexer_pos + 1 < size && is_digit(buf[lexer_pos + 1])))
+		{
+			size_t start = lexer_pos;
+			if (ch == '-')
+				lexer_pos++;
+			while (lexer_pos < size && is_digit(buf[lexer_pos]))
+				lexer_pos++;
+
+			if (ch != '-' && lexer_pos < size && buf[lexer_pos] == '\'') {
+				lexer_pos++;
+				if (lexer_pos < size && buf[lexer_pos] == 's')
+					lexer_pos++;
+				while (lexer_pos < size && is_value_digit(buf[lexer_pos]))
+					lexer_pos++;
+				rtlil_frontend_yylval.string = token_strndup(buf + start, lexer_pos - start);
+				return TOK_VALUE;
+			}
+
+			std::string digits(buf + start, lexer_pos - start);
+			char *end = nullptr;
+			errno = 0;
+			long value = strtol(digits.c_str(), &end, 10);
+			log_assert(end == digits.c_str() + digits.size());
+			if (errno == ERANGE)
+				return TOK_INVALID; // literal out of range of long
+			if (value < INT_MIN || value > INT_MAX)
+				return TOK_INVALID; // literal out of range of int (relevant mostly for LP64 platforms)
+			rtlil_frontend_yylval.integer = value;
+			return TOK_INT;
+		}
+
+		if (ch == '"') {
+			size_t start = ++lexer_pos;
+			bool has_raw_newline = false;
+			while (lexer_pos < size && buf[lexer_pos] != '"') {
+				if (buf[lexer_pos] == '\n') {
+					// the flex scanner had no rule for raw newlines in
+					// strings, so they were never part of the token
+					lexer_lineno++;
+					has_raw_newline = true;
+					lexer_pos++;
+					continue;
+				}
+				if (buf[lexer_pos] == '\\' && lexer_pos + 1 < size && buf[lexer_pos + 1] != '\n')
+					lexer_pos++;
+				lexer_pos++;
+			}
+			if (!has_raw_newline) {
+				rtlil_frontend_yylval.string = unescape_string(buf + start, lexer_pos - start);
+			} else {
+				std::string body;
+				for (size_t i = start; i < lexer_pos; i++)
+					if (buf[i] != '\n')
+						body += buf[i];
+				rtlil_frontend_yylval.string = unescape_string(body.data(), body.size());
+			}
+			if (lexer_pos < size)
+				lexer_pos++; // skip the closing quote
+			return TOK_STRING;
+		}
+
+		lexer_pos++;
+		return ch;
+	}
+}
+
+void rtlil_frontend_yyrestart(FILE*)
+{
+	// read the whole input up front; the istream to read is picked up from
+	// RTLIL_FRONTEND::lexin, just like the YY_INPUT of the old flex scanner
+	lexer_buffer.clear();
+	char buffer[65536];
+	int rc;
+	while ((rc = readsome(*RTLIL_FRONTEND::lexin, buffer, sizeof(buffer))) > 0)
+		lexer_buffer.append(buffer, rc);
+	lexer_pos = 0;
+	lexer_lineno = 1;
+}
+
+int rtlil_frontend_yylex_destroy(void)
+{
+	// release the input buffer
+	std::string().swap(lexer_buffer);
+	lexer_pos = 0;
+	return 0;
+}
+
+int rtlil_frontend_yyget_lineno(void)
+{
+	return lexer_lineno;
+}
@@ -420,10 +420,15 @@ constant:
 			is_signed = true;
 			ep++;
 		}
-		std::list<RTLIL::State> bits;
-		while (*ep != 0) {
+		const char *digits_end = ep + strlen(ep);
+		$$ = new RTLIL::Const;
+		std::vector<RTLIL::State> &bits = $$->bits;
+		bits.reserve(width);
+		// the digits are written msb first; fill the bit vector lsb first
+		// from the end, dropping any digits beyond the given width
+		for (const char *p = digits_end; p != ep && (int)bits.size() < width; ) {
 			RTLIL::State bit = RTLIL::Sx;
-			switch (*ep) {
+			switch (*--p) {
 			case '0': bit = RTLIL::S0; break;
 			case '1': bit = RTLIL::S1; break;
 			case 'x': bit = RTLIL::Sx; break;
@@ -431,23 +436,18 @@ constant:
 			case '-': bit = RTLIL::Sa; break;
 			case 'm': bit = RTLIL::Sm; break;
 			}
-			bits.push_front(bit);
-			ep++;
+			bits.push_back(bit);
 		}
-
-		if (bits.size() == 0)
+		if (bits.empty())
 			bits.push_back(RTLIL::Sx);
-		while ((int)bits.size() < width) {
+		if ((int)bits.size() < width) {
 			RTLIL::State bit = bits.back();
 			if (bit == RTLIL::S1)
 				bit = RTLIL::S0;
-			bits.push_back(bit);
+			bits.resize(width, bit);
 		}
-		while ((int)bits.size() > width)
-			bits.pop_back();
-		$$ = new RTLIL::Const;
-		for (auto it = bits.begin(); it != bits.end(); it++)
-			$$->bits.push_back(*it);
+		if ((int)bits.size() > width)
+			bits.resize(width);
 		if (is_signed) {
 			$$->flags |= RTLIL::CONST_FLAG_SIGNED;
 		}
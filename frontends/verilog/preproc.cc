@@ -385,22 +385,32 @@ void define_map_t::log() const
 	}
 }
 
-static void input_file(std::istream &f, std::string filename)
+static std::string read_stream(std::istream &f)
 {
-	char buffer[513];
+	std::string text;
+	char buffer[65536];
 	int rc;
 
+	while ((rc = readsome(f, buffer, sizeof(buffer))) > 0)
+		text.append(buffer, rc);
+	return text;
+}
+
+static void input_text(std::string text, std::string filename)
+{
 	insert_input("");
 	auto it = input_buffer.begin();
 
 	input_buffer.insert(it, "`file_push \"" + filename + "\"\n");
-	while ((rc = readsome(f, buffer, sizeof(buffer)-1)) > 0) {
-		buffer[rc] = 0;
-		input_buffer.insert(it, buffer);
-	}
+	input_buffer.insert(it, std::move(text));
 	input_buffer.insert(it, "\n`file_pop\n");
 }
 
+static void input_file(std::istream &f, std::string filename)
+{
+	input_text(read_stream(f), filename);
+}
+
 // Read tokens to get one argument (either a macro argument at a callsite or a default argument in a
 // macro definition). Writes the argument to dest. Returns true if we finished with ')' (the end of
 // the argument list); false if we finished with ','.
@@ -535,6 +545,421 @@ static bool try_expand_macro(define_map_t &defines, macro_arg_stack_t &macro_arg
 	return true;
 }
 
+// =============================================================================
+// Include-file preprocessing cache
+//
+// Large designs tend to `include the same big headers (register maps and the
+// like) from every compilation unit, and re-tokenizing and re-expanding them
+// each time is pure overhead. Successfully preprocessed include files are
+// therefore cached, keyed on a hash of the resolved path, the file contents,
+// the complete macro state at the point of inclusion and the sv_mode flag. A
+// cache hit replays the recorded output and side effects (macro definitions
+// added or removed, the `resetall effect on default_nettype_wire and the list
+// of files read) without re-running the tokenizer. Captures that end in a
+// state we cannot replay safely (unbalanced `ifdef levels, macro expansion in
+// flight) are simply discarded.
+//
+// The in-memory cache lives for the lifetime of the yosys process. Setting
+// the YOSYS_VERILOG_PREPROC_CACHE environment variable to a directory
+// additionally persists entries on disk so that sharded runs over the same
+// sources can share them; corrupt or mismatched cache files are ignored.
+// =============================================================================
+
+// set of `define/`undef changes between two snapshots of a define map
+struct define_delta_t
+{
+	std::vector<std::pair<std::string, define_body_t>> changed;
+	std::vector<std::string> removed;
+};
+
+struct preproc_cache_entry_t
+{
+	std::string output;
+	define_delta_t defines_delta, global_delta;
+	// `resetall inside the include sets default_nettype_wire; only replay
+	// the value if the include actually touched it.
+	bool nettype_touched = false;
+	bool nettype_value = true;
+	// files opened while processing the include (nested `includes)
+	std::vector<std::string> input_files;
+};
+
+static std::map<uint64_t, preproc_cache_entry_t> preproc_cache;
+
+// state for an include file currently being processed on a cache miss
+struct pending_capture_t
+{
+	uint64_t key;
+	size_t filename_stack_size;
+	std::list<std::string>::iterator output_begin;
+	int ifdef_fail_level, ifdef_pass_level;
+	std::map<std::string, define_body_t> defines_snapshot, global_snapshot;
+	preproc_cache_entry_t entry;
+};
+
+static std::vector<pending_capture_t> pending_captures;
+
+static const char *preproc_cache_dir()
+{
+	const char *dir = getenv("YOSYS_VERILOG_PREPROC_CACHE");
+	if (dir == nullptr || dir[0] == 0)
+		return nullptr;
+	return dir;
+}
+
+static void preproc_cache_hash(uint64_t &h, const void *data, size_t len)
+{
+	const unsigned char *p = (const unsigned char*)data;
+	for (size_t i = 0; i < len; i++) {
+		h ^= p[i];
+		h *= 0x100000001b3ull;
+	}
+}
+
+static void preproc_cache_hash_int(uint64_t &h, uint64_t value)
+{
+	unsigned char buf[8];
+	for (int i = 0; i < 8; i++)
+		buf[i] = (value >> (8*i)) & 0xff;
+	preproc_cache_hash(h, buf, sizeof(buf));
+}
+
+static void preproc_cache_hash_string(uint64_t &h, const std::string &str)
+{
+	preproc_cache_hash_int(h, str.size());
+	preproc_cache_hash(h, str.data(), str.size());
+}
+
+static uint64_t preproc_cache_key(const std::string &path, const std::string &content, const define_map_t &defines)
+{
+	uint64_t h = 0xcbf29ce484222325ull;
+	preproc_cache_hash_string(h, "YsVppC01");
+	preproc_cache_hash_string(h, yosys_version_str);
+	preproc_cache_hash_string(h, path);
+	preproc_cache_hash_string(h, content);
+	preproc_cache_hash_int(h, sv_mode ? 1 : 0);
+	// std::map iterates in name order, so this is stable across runs
+	for (auto &pr : defines.defines) {
+		const define_body_t &body = *pr.second;
+		preproc_cache_hash_string(h, pr.first);
+		preproc_cache_hash_string(h, body.body);
+		preproc_cache_hash_int(h, body.has_args ? 1 : 0);
+		preproc_cache_hash_int(h, body.args.args.size());
+		for (auto &arg : body.args.args) {
+			preproc_cache_hash_string(h, arg.name);
+			preproc_cache_hash_int(h, arg.has_default ? 1 : 0);
+			preproc_cache_hash_string(h, arg.default_value);
+		}
+	}
+	return h;
+}
+
+static std::map<std::string, define_body_t> snapshot_defines(const define_map_t &map)
+{
+	std::map<std::string, define_body_t> snapshot;
+	for (auto &pr : map.defines)
+		snapshot.emplace(pr.first, *pr.second);
+	return snapshot;
+}
+
+static bool same_define_body(const define_body_t &a, const define_body_t &b)
+{
+	if (a.body != b.body || a.has_args != b.has_args)
+		return false;
+	if (a.args.args.size() != b.args.args.size())
+		return false;
+	for (size_t i = 0; i < a.args.args.size(); i++) {
+		const macro_arg_t &aa = a.args.args[i], &ba = b.args.args[i];
+		if (aa.name != ba.name || aa.has_default != ba.has_default || aa.default_value != ba.default_value)
+			return false;
+	}
+	return true;
+}
+
+static define_delta_t diff_defines(const std::map<std::string, define_body_t> &snapshot, const define_map_t &now)
+{
+	define_delta_t delta;
+	for (auto &pr : now.defines) {
+		auto it = snapshot.find(pr.first);
+		if (it == snapshot.end() || !same_define_body(it->second, *pr.second))
+			delta.changed.push_back(std::make_pair(pr.first, *pr.second));
+	}
+	for (auto &pr : snapshot)
+		if (now.defines.count(pr.first) == 0)
+			delta.removed.push_back(pr.first);
+	return delta;
+}
+
+static void apply_define_delta(define_map_t &map, const define_delta_t &delta)
+{
+	for (auto &pr : delta.changed)
+		map.add(pr.first, pr.second);
+	for (auto &name : delta.removed)
+		map.erase(name);
+}
+
+// register a file read by the preprocessor, both globally and with any
+// include captures currently in flight (so that replaying an outer include
+// still reports the files its nested includes read)
+static void record_input_file(const std::string &filename)
+{
+	yosys_input_files.insert(filename);
+	for (auto &capture : pending_captures)
+		capture.entry.input_files.push_back(filename);
+}
+
+// --- on-disk cache files ---
+
+static const char preproc_cache_magic[9] = "YsVppC01";
+
+static void preproc_cache_write_int(std::ostream &f, uint32_t value)
+{
+	unsigned char buf[4];
+	for (int i = 0; i < 4; i++)
+		buf[i] = (value >> (8*i)) & 0xff;
+	f.write((const char*)buf, sizeof(buf));
+}
+
+static void preproc_cache_write_string(std::ostream &f, const std::string &str)
+{
+	preproc_cache_write_int(f, str.size());
+	f.write(str.data(), str.size());
+}
+
+static void preproc_cache_write_body(std::ostream &f, const define_body_t &body)
+{
+	preproc_cache_write_string(f, body.body);
+	preproc_cache_write_int(f, body.has_args ? 1 : 0);
+	preproc_cache_write_int(f, body.args.args.size());
+	for (auto &arg : body.args.args) {
+		preproc_cache_write_string(f, arg.name);
+		preproc_cache_write_int(f, arg.has_default ? 1 : 0);
+		preproc_cache_write_string(f, arg.default_value);
+	}
+}
+
+static void preproc_cache_write_delta(std::ostream &f, const define_delta_t &delta)
+{
+	preproc_cache_write_int(f, delta.changed.size());
+	for (auto &pr : delta.changed) {
+		preproc_cache_write_string(f, pr.first);
+		preproc_cache_write_body(f, pr.second);
+	}
+	preproc_cache_write_int(f, delta.removed.size());
+	for (auto &name : delta.removed)
+		preproc_cache_write_string(f, name);
+}
+
+static std::string preproc_cache_file_path(const char *dir, uint64_t key)
+{
+	return stringf("%s/%016llx.vppcache", dir, (unsigned long long)key);
+}
+
+static void preproc_cache_save(const char *dir, uint64_t key, const preproc_cache_entry_t &entry)
+{
+	std::string path = preproc_cache_file_path(dir, key);
+	std::string tmp_path = path + ".new";
+
+	std::ofstream f(tmp_path.c_str(), std::ofstream::trunc | std::ofstream::binary);
+	if (f.fail())
+		return;
+
+	f.write(preproc_cache_magic, 8);
+	preproc_cache_write_string(f, entry.output);
+	preproc_cache_write_delta(f, entry.defines_delta);
+	preproc_cache_write_delta(f, entry.global_delta);
+	preproc_cache_write_int(f, (entry.nettype_touched ? 1 : 0) | (entry.nettype_value ? 2 : 0));
+	preproc_cache_write_int(f, entry.input_files.size());
+	for (auto &fn : entry.input_files)
+		preproc_cache_write_string(f, fn);
+	f.close();
+
+	// atomic rename so concurrent jobs sharing a cache directory never
+	// observe partially written files
+	if (f.fail() || rename(tmp_path.c_str(), path.c_str()) != 0)
+		remove(tmp_path.c_str());
+}
+
+struct PreprocCacheReader
+{
+	const char *p, *end;
+
+	bool read_raw(void *data, size_t len)
+	{
+		if (len > (size_t)(end - p))
+			return false;
+		memcpy(data, p, len);
+		p += len;
+		return true;
+	}
+
+	bool read_int(uint32_t &value)
+	{
+		unsigned char buf[4];
+		if (!read_raw(buf, sizeof(buf)))
+			return false;
+		value = buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+		return true;
+	}
+
+	bool read_string(std::string &str)
+	{
+		uint32_t len;
+		if (!read_int(len) || len > (size_t)(end - p))
+			return false;
+		str.assign(p, len);
+		p += len;
+		return true;
+	}
+
+	bool read_delta(define_delta_t &delta)
+	{
+		uint32_t num_changed;
+		if (!read_int(num_changed))
+			return false;
+		for (uint32_t i = 0; i < num_changed; i++) {
+			std::string name, body;
+			uint32_t has_args, num_args;
+			arg_map_t args;
+			if (!read_string(name) || !read_string(body) || !read_int(has_args) || !read_int(num_args))
+				return false;
+			for (uint32_t k = 0; k < num_args; k++) {
+				std::string arg_name, default_value;
+				uint32_t has_default;
+				if (!read_string(arg_name) || !read_int(has_default) || !read_string(default_value))
+					return false;
+				args.add_arg(arg_name, has_default ? default_value.c_str() : nullptr);
+			}
+			delta.changed.push_back(std::make_pair(name, define_body_t(body, has_args ? &args : nullptr)));
+		}
+		uint32_t num_removed;
+		if (!read_int(num_removed))
+			return false;
+		for (uint32_t i = 0; i < num_removed; i++) {
+			std::string name;
+			if (!read_string(name))
+				return false;
+			delta.removed.push_back(name);
+		}
+		return true;
+	}
+};
+
+static bool preproc_cache_load(const std::string &path, preproc_cache_entry_t &entry)
+{
+	std::ifstream f(path.c_str(), std::ifstream::binary);
+	if (f.fail())
+		return false;
+
+	std::stringstream buffer;
+	buffer << f.rdbuf();
+	std::string data = buffer.str();
+	if (f.bad())
+		return false;
+
+	PreprocCacheReader reader;
+	reader.p = data.data();
+	reader.end = data.data() + data.size();
+
+	char magic[8];
+	if (!reader.read_raw(magic, 8) || memcmp(magic, preproc_cache_magic, 8) != 0)
+		return false;
+
+	uint32_t nettype_flags, num_files;
+	if (!reader.read_string(entry.output))
+		return false;
+	if (!reader.read_delta(entry.defines_delta) || !reader.read_delta(entry.global_delta))
+		return false;
+	if (!reader.read_int(nettype_flags) || !reader.read_int(num_files))
+		return false;
+	entry.nettype_touched = (nettype_flags & 1) != 0;
+	entry.nettype_value = (nettype_flags & 2) != 0;
+	for (uint32_t i = 0; i < num_files; i++) {
+		std::string fn;
+		if (!reader.read_string(fn))
+			return false;
+		entry.input_files.push_back(fn);
+	}
+	return reader.p == reader.end;
+}
+
+// --- cache operations used by the main loop ---
+
+static const preproc_cache_entry_t *preproc_cache_find(uint64_t key)
+{
+	auto it = preproc_cache.find(key);
+	if (it != preproc_cache.end())
+		return &it->second;
+
+	if (const char *dir = preproc_cache_dir()) {
+		preproc_cache_entry_t entry;
+		if (preproc_cache_load(preproc_cache_file_path(dir, key), entry))
+			return &(preproc_cache[key] = std::move(entry));
+	}
+	return nullptr;
+}
+
+static void preproc_cache_replay(const preproc_cache_entry_t *entry, define_map_t &defines, define_map_t &global_defines_cache)
+{
+	output_code.push_back(entry->output);
+	apply_define_delta(defines, entry->defines_delta);
+	apply_define_delta(global_defines_cache, entry->global_delta);
+	if (entry->nettype_touched) {
+		default_nettype_wire = entry->nettype_value;
+		// propagate into enclosing captures, as if `resetall had been
+		// processed directly
+		for (auto &capture : pending_captures) {
+			capture.entry.nettype_touched = true;
+			capture.entry.nettype_value = entry->nettype_value;
+		}
+	}
+	for (auto &fn : entry->input_files)
+		record_input_file(fn);
+}
+
+static void begin_include_capture(uint64_t key, size_t filename_stack_size, int ifdef_fail_level, int ifdef_pass_level,
+		const define_map_t &defines, const define_map_t &global_defines_cache)
+{
+	pending_capture_t capture;
+	capture.key = key;
+	capture.filename_stack_size = filename_stack_size;
+	capture.ifdef_fail_level = ifdef_fail_level;
+	capture.ifdef_pass_level = ifdef_pass_level;
+	capture.defines_snapshot = snapshot_defines(defines);
+	capture.global_snapshot = snapshot_defines(global_defines_cache);
+	// boundary node: output emitted while the capture is active accumulates
+	// here and in nodes appended after it
+	output_code.push_back(std::string());
+	capture.output_begin = std::prev(output_code.end());
+	pending_captures.push_back(std::move(capture));
+}
+
+static void finish_include_capture(const define_map_t &defines, const define_map_t &global_defines_cache,
+		int ifdef_fail_level, int ifdef_pass_level, const macro_arg_stack_t &macro_arg_stack)
+{
+	pending_capture_t capture = std::move(pending_captures.back());
+	pending_captures.pop_back();
+
+	// discard captures whose effects we cannot replay exactly: unbalanced
+	// conditionals or a macro expansion spanning the include boundary
+	if (ifdef_fail_level != capture.ifdef_fail_level || ifdef_pass_level != capture.ifdef_pass_level)
+		return;
+	if (!macro_arg_stack.empty())
+		return;
+
+	for (auto it = capture.output_begin; it != output_code.end(); ++it)
+		capture.entry.output += *it;
+	// input_text() appended "\n`file_pop\n" to the include text; the final
+	// newline is still unread at this point, so account for it here
+	capture.entry.output += "\n";
+	capture.entry.defines_delta = diff_defines(capture.defines_snapshot, defines);
+	capture.entry.global_delta = diff_defines(capture.global_snapshot, global_defines_cache);
+
+	if (const char *dir = preproc_cache_dir())
+		preproc_cache_save(dir, capture.key, capture.entry);
+	preproc_cache[capture.key] = std::move(capture.entry);
+}
+
 // Read the arguments for a `define preprocessor directive with formal arguments. This is called
 // just after reading the token containing "(". Returns the number of newlines to emit afterwards to
 // keep line numbers in sync, together with the map from argument name to data (pos and default
@@ -772,8 +1197,21 @@ frontend_verilog_preproc(std::istream                 &f,
 	output_code.clear();
 	input_buffer.clear();
 	input_buffer_charp = 0;
+	pending_captures.clear();
+
+	std::string text = read_stream(f);
 
-	input_file(f, filename);
+	// Fast path for preprocessor-free input, e.g. large generated netlists:
+	// if the text contains no directives or macro uses (no '`' anywhere), no
+	// one-line comments (the tokenizer below rewrites those into /* */ form
+	// so that the lexer's legacy hot comment rules can see them) and no CR
+	// characters (which it strips), then running it through the tokenizer
+	// would reproduce it unchanged, so pass it through as-is.
+	if (text.find('`') == std::string::npos && text.find("//") == std::string::npos &&
+			text.find('\r') == std::string::npos)
+		return "`file_push \"" + filename + "\"\n" + text + "\n`file_pop\n";
+
+	input_text(std::move(text), filename);
 
 	while (!input_buffer.empty())
 	{
@@ -911,9 +1349,23 @@ frontend_verilog_preproc(std::istream                 &f,
 			}
 			if (ff.fail()) {
 				output_code.push_back("`file_notfound " + fn);
+			} else if (macro_arg_stack.empty()) {
+				record_input_file(fixed_fn);
+				std::string content = read_stream(ff);
+				uint64_t key = preproc_cache_key(fixed_fn, content, defines);
+				if (const preproc_cache_entry_t *entry = preproc_cache_find(key)) {
+					preproc_cache_replay(entry, defines, global_defines_cache);
+				} else {
+					begin_include_capture(key, filename_stack.size(), ifdef_fail_level,
+							ifdef_pass_level, defines, global_defines_cache);
+					input_text(std::move(content), fixed_fn);
+				}
 			} else {
+				// a macro expansion is in flight; its argument bindings
+				// could leak into the expansion of this file, so process
+				// it without involving the cache
 				input_file(ff, fixed_fn);
-				yosys_input_files.insert(fixed_fn);
+				record_input_file(fixed_fn);
 			}
 			continue;
 		}
@@ -933,6 +1385,9 @@ frontend_verilog_preproc(std::istream                 &f,
 			output_code.push_back(tok);
 			filename = filename_stack.back();
 			filename_stack.pop_back();
+			if (!pending_captures.empty() && pending_captures.back().filename_stack_size == filename_stack.size())
+				finish_include_capture(defines, global_defines_cache, ifdef_fail_level,
+						ifdef_pass_level, macro_arg_stack);
 			continue;
 		}
 
@@ -962,6 +1417,10 @@ frontend_verilog_preproc(std::istream                 &f,
 
 		if (tok == "`resetall") {
 			default_nettype_wire = true;
+			for (auto &capture : pending_captures) {
+				capture.entry.nettype_touched = true;
+				capture.entry.nettype_value = true;
+			}
 			continue;
 		}
 
@@ -979,14 +1438,24 @@ frontend_verilog_preproc(std::istream                 &f,
 		if (try_expand_macro(defines, macro_arg_stack, tok))
 			continue;
 
-		output_code.push_back(tok);
+		// appending to the last chunk instead of always starting a new one
+		// keeps the output list short (most tokens just pass through)
+		if (output_code.empty())
+			output_code.push_back(tok);
+		else
+			output_code.back() += tok;
 	}
 
 	if (ifdef_fail_level > 0 || ifdef_pass_level > 0) {
 		log_error("Unterminated preprocessor conditional!\n");
 	}
 
+	size_t output_size = 0;
+	for (auto &str : output_code)
+		output_size += str.size();
+
 	std::string output;
+	output.reserve(output_size);
 	for (auto &str : output_code)
 		output += str;
 
@@ -40,6 +40,16 @@ using namespace VERILOG_FRONTEND;
 static std::vector<std::string> verilog_defaults;
 static std::list<std::vector<std::string>> verilog_defaults_stack;
 
+// a read-only streambuf over an existing string, used to hand the preprocessed
+// source to the lexer without copying it again the way std::istringstream would
+struct StringViewBuf : public std::streambuf
+{
+	StringViewBuf(std::string &str) {
+		char *p = &str[0];
+		setg(p, p, p + str.size());
+	}
+};
+
 static void error_on_dpi_function(AST::AstNode *node)
 {
 	if (node->type == AST::AST_DPI_FUNCTION)
@@ -483,12 +493,16 @@ struct VerilogFrontend : public Frontend {
 
 		lexin = f;
 		std::string code_after_preproc;
+		std::unique_ptr<StringViewBuf> preproc_buf;
+		std::unique_ptr<std::istream> preproc_stream;
 
 		if (!flag_nopp) {
 			code_after_preproc = frontend_verilog_preproc(*f, filename, defines_map, *design->verilog_defines, include_dirs);
 			if (flag_ppdump)
 				log("-- Verilog code after preprocessor --\n%s-- END OF DUMP --\n", code_after_preproc.c_str());
-			lexin = new std::istringstream(code_after_preproc);
+			preproc_buf.reset(new StringViewBuf(code_after_preproc));
+			preproc_stream.reset(new std::istream(preproc_buf.get()));
+			lexin = preproc_stream.get();
 		}
 
 		// make package typedefs available to parser
@@ -526,9 +540,6 @@ struct VerilogFrontend : public Frontend {
 				flag_nomeminit, flag_nomem2reg, flag_mem2reg, flag_noblackbox, lib_mode, flag_nowb, flag_noopt, flag_icells, flag_pwires, flag_nooverwrite, flag_overwrite, flag_defer, default_nettype_wire);
 
 
-		if (!flag_nopp)
-			delete lexin;
-
 		// only the previous and new global type maps remain
 		log_assert(user_type_stack.size() == 2);
 		user_type_stack.clear();
@@ -97,6 +97,40 @@ static RTLIL::Const big2const(const BigInteger &val, int result_len, int undef_b
 	return result;
 }
 
+// Two-bit packed representation of a Const used for word-parallel bitwise
+// operations: bit i of ones/zeros is set iff the state is S1/S0. A bit set
+// in neither word is undefined (Sx, Sz, ...) and produces Sx in the result,
+// matching the per-bit logic_*() functions below.
+static void pack_const(const RTLIL::Const &arg, int width, std::vector<uint64_t> &ones, std::vector<uint64_t> &zeros)
+{
+	int words = (width + 63) / 64;
+	ones.assign(words, 0);
+	zeros.assign(words, 0);
+
+	int n = min(width, GetSize(arg));
+	for (int i = 0; i < n; i++) {
+		RTLIL::State s = arg.bits[i];
+		if (s == RTLIL::State::S1)
+			ones[i / 64] |= uint64_t(1) << (i % 64);
+		else if (s == RTLIL::State::S0)
+			zeros[i / 64] |= uint64_t(1) << (i % 64);
+	}
+	for (int i = n; i < width; i++)
+		zeros[i / 64] |= uint64_t(1) << (i % 64);
+}
+
+static RTLIL::Const unpack_const(const std::vector<uint64_t> &ones, const std::vector<uint64_t> &zeros, int width)
+{
+	RTLIL::Const result(RTLIL::State::Sx, width);
+	for (int i = 0; i < width; i++) {
+		if ((ones[i / 64] >> (i % 64)) & 1)
+			result.bits[i] = RTLIL::State::S1;
+		else if ((zeros[i / 64] >> (i % 64)) & 1)
+			result.bits[i] = RTLIL::State::S0;
+	}
+	return result;
+}
+
 static RTLIL::State logic_and(RTLIL::State a, RTLIL::State b)
 {
 	if (a == RTLIL::State::S0) return RTLIL::State::S0;
@@ -150,7 +184,35 @@ RTLIL::Const RTLIL::const_not(const RTLIL::Const &arg1, const RTLIL::Const&, boo
 	return result;
 }
 
-static RTLIL::Const logic_wrapper(RTLIL::State(*logic_func)(RTLIL::State, RTLIL::State),
+// word-parallel versions of the logic_*() functions above, operating on 64
+// packed states per step (r1/r0 are the ones/zeros words of the result)
+static void word_logic_and(uint64_t a1, uint64_t a0, uint64_t b1, uint64_t b0, uint64_t &r1, uint64_t &r0)
+{
+	r1 = a1 & b1;
+	r0 = a0 | b0;
+}
+
+static void word_logic_or(uint64_t a1, uint64_t a0, uint64_t b1, uint64_t b0, uint64_t &r1, uint64_t &r0)
+{
+	r1 = a1 | b1;
+	r0 = a0 & b0;
+}
+
+static void word_logic_xor(uint64_t a1, uint64_t a0, uint64_t b1, uint64_t b0, uint64_t &r1, uint64_t &r0)
+{
+	uint64_t def = (a1 | a0) & (b1 | b0);
+	r1 = (a1 ^ b1) & def;
+	r0 = ~(a1 ^ b1) & def;
+}
+
+static void word_logic_xnor(uint64_t a1, uint64_t a0, uint64_t b1, uint64_t b0, uint64_t &r1, uint64_t &r0)
+{
+	uint64_t def = (a1 | a0) & (b1 | b0);
+	r1 = ~(a1 ^ b1) & def;
+	r0 = (a1 ^ b1) & def;
+}
+
+static RTLIL::Const logic_wrapper(void(*word_func)(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t&, uint64_t&),
 		RTLIL::Const arg1, RTLIL::Const arg2, bool signed1, bool signed2, int result_len = -1)
 {
 	if (result_len < 0)
@@ -159,34 +221,35 @@ static RTLIL::Const logic_wrapper(RTLIL::State(*logic_func)(RTLIL::State, RTLIL:
 	extend_u0(arg1, result_len, signed1);
 	extend_u0(arg2, result_len, signed2);
 
-	RTLIL::Const result(RTLIL::State::Sx, result_len);
-	for (size_t i = 0; i < size_t(result_len); i++) {
-		RTLIL::State a = i < arg1.bits.size() ? arg1.bits[i] : RTLIL::State::S0;
-		RTLIL::State b = i < arg2.bits.size() ? arg2.bits[i] : RTLIL::State::S0;
-		result.bits[i] = logic_func(a, b);
-	}
+	std::vector<uint64_t> a1, a0, b1, b0;
+	pack_const(arg1, result_len, a1, a0);
+	pack_const(arg2, result_len, b1, b0);
 
-	return result;
+	std::vector<uint64_t> r1(a1.size()), r0(a1.size());
+	for (size_t i = 0; i < a1.size(); i++)
+		word_func(a1[i], a0[i], b1[i], b0[i], r1[i], r0[i]);
+
+	return unpack_const(r1, r0, result_len);
 }
 
 RTLIL::Const RTLIL::const_and(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
-	return logic_wrapper(logic_and, arg1, arg2, signed1, signed2, result_len);
+	return logic_wrapper(word_logic_and, arg1, arg2, signed1, signed2, result_len);
 }
 
 RTLIL::Const RTLIL::const_or(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
-	return logic_wrapper(logic_or, arg1, arg2, signed1, signed2, result_len);
+	return logic_wrapper(word_logic_or, arg1, arg2, signed1, signed2, result_len);
 }
 
 RTLIL::Const RTLIL::const_xor(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
-	return logic_wrapper(logic_xor, arg1, arg2, signed1, signed2, result_len);
+	return logic_wrapper(word_logic_xor, arg1, arg2, signed1, signed2, result_len);
 }
 
 RTLIL::Const RTLIL::const_xnor(const RTLIL::Const &arg1, const RTLIL::Const &arg2, bool signed1, bool signed2, int result_len)
 {
-	return logic_wrapper(logic_xnor, arg1, arg2, signed1, signed2, result_len);
+	return logic_wrapper(word_logic_xnor, arg1, arg2, signed1, signed2, result_len);
 }
 
 static RTLIL::Const logic_reduce_wrapper(RTLIL::State initial, RTLIL::State(*logic_func)(RTLIL::State, RTLIL::State), const RTLIL::Const &arg1, int result_len)
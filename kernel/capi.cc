@@ -0,0 +1,191 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/yosys.h"
+#include "kernel/capi.h"
+
+#include <deque>
+
+USING_YOSYS_NAMESPACE
+
+// The dump owns copies of all name strings (in a deque, so the addresses
+// handed out in the flat arrays stay stable) and is independent of the
+// design once built.
+struct yosys_capi_module_dump
+{
+	std::deque<std::string> strings;
+	std::vector<yosys_capi_wire> wires;
+	std::vector<yosys_capi_cell> cells;
+	std::vector<yosys_capi_conn> conns;
+	std::vector<yosys_capi_bit> bits;
+
+	const char *intern(const RTLIL::IdString &id)
+	{
+		strings.push_back(id.str());
+		return strings.back().c_str();
+	}
+};
+
+static RTLIL::Module *capi_find_module(const char *module_name)
+{
+	RTLIL::Design *design = yosys_get_design();
+	if (design == nullptr || module_name == nullptr)
+		return nullptr;
+	return design->module(RTLIL::escape_id(module_name));
+}
+
+extern "C" {
+
+uint32_t yosys_capi_version(void)
+{
+	return YOSYS_CAPI_VERSION;
+}
+
+yosys_capi_module_dump *yosys_capi_dump_module(const char *module_name)
+{
+	RTLIL::Module *module = capi_find_module(module_name);
+	if (module == nullptr)
+		return nullptr;
+
+	yosys_capi_module_dump *dump = new yosys_capi_module_dump;
+
+	dict<RTLIL::Wire*, int32_t> wire_index;
+	dump->wires.reserve(GetSize(module->wires_));
+	for (auto wire : module->wires()) {
+		wire_index[wire] = GetSize(dump->wires);
+		yosys_capi_wire entry;
+		entry.name = dump->intern(wire->name);
+		entry.width = wire->width;
+		entry.port_id = wire->port_id;
+		entry.port_input = wire->port_input;
+		entry.port_output = wire->port_output;
+		dump->wires.push_back(entry);
+	}
+
+	dump->cells.reserve(GetSize(module->cells_));
+	for (auto cell : module->cells()) {
+		yosys_capi_cell entry;
+		entry.name = dump->intern(cell->name);
+		entry.type = dump->intern(cell->type);
+		entry.first_conn = GetSize(dump->conns);
+		entry.num_conns = GetSize(cell->connections());
+		for (auto &conn : cell->connections()) {
+			yosys_capi_conn port;
+			port.port = dump->intern(conn.first);
+			port.first_bit = GetSize(dump->bits);
+			port.num_bits = GetSize(conn.second);
+			for (auto &bit : conn.second.bits()) {
+				yosys_capi_bit b;
+				if (bit.wire != nullptr) {
+					b.wire = wire_index.at(bit.wire);
+					b.offset = bit.offset;
+				} else {
+					b.wire = -1;
+					switch (bit.data) {
+					case RTLIL::State::S0: b.offset = YOSYS_CAPI_STATE_0; break;
+					case RTLIL::State::S1: b.offset = YOSYS_CAPI_STATE_1; break;
+					case RTLIL::State::Sz: b.offset = YOSYS_CAPI_STATE_Z; break;
+					case RTLIL::State::Sa: b.offset = YOSYS_CAPI_STATE_A; break;
+					default: b.offset = YOSYS_CAPI_STATE_X; break;
+					}
+				}
+				dump->bits.push_back(b);
+			}
+			dump->conns.push_back(port);
+		}
+		dump->cells.push_back(entry);
+	}
+
+	return dump;
+}
+
+void yosys_capi_dump_free(yosys_capi_module_dump *dump)
+{
+	delete dump;
+}
+
+const yosys_capi_wire *yosys_capi_dump_wires(const yosys_capi_module_dump *dump, size_t *count)
+{
+	*count = dump->wires.size();
+	return dump->wires.data();
+}
+
+const yosys_capi_cell *yosys_capi_dump_cells(const yosys_capi_module_dump *dump, size_t *count)
+{
+	*count = dump->cells.size();
+	return dump->cells.data();
+}
+
+const yosys_capi_conn *yosys_capi_dump_conns(const yosys_capi_module_dump *dump, size_t *count)
+{
+	*count = dump->conns.size();
+	return dump->conns.data();
+}
+
+const yosys_capi_bit *yosys_capi_dump_bits(const yosys_capi_module_dump *dump, size_t *count)
+{
+	*count = dump->bits.size();
+	return dump->bits.data();
+}
+
+size_t yosys_capi_selected_modules(const char **names, size_t max_names)
+{
+	RTLIL::Design *design = yosys_get_design();
+	if (design == nullptr)
+		return 0;
+
+	size_t total = 0;
+	for (auto module : design->selected_modules()) {
+		if (total < max_names)
+			names[total] = module->name.c_str();
+		total++;
+	}
+	return total;
+}
+
+size_t yosys_capi_set_attributes(const char *module_name, const yosys_capi_attr_write *writes, size_t num_writes)
+{
+	RTLIL::Module *module = capi_find_module(module_name);
+	if (module == nullptr)
+		return 0;
+
+	size_t applied = 0;
+	for (size_t i = 0; i < num_writes; i++) {
+		if (writes[i].object == nullptr || writes[i].attribute == nullptr || writes[i].value == nullptr)
+			continue;
+
+		RTLIL::IdString obj_name = RTLIL::escape_id(writes[i].object);
+		dict<RTLIL::IdString, RTLIL::Const> *attributes;
+		if (RTLIL::Cell *cell = module->cell(obj_name))
+			attributes = &cell->attributes;
+		else if (RTLIL::Wire *wire = module->wire(obj_name))
+			attributes = &wire->attributes;
+		else
+			continue;
+
+		std::string value = writes[i].value;
+		bool is_number = !value.empty() && value.find_first_not_of("0123456789") == std::string::npos;
+		(*attributes)[RTLIL::escape_id(writes[i].attribute)] =
+				is_number ? RTLIL::Const(atoi(value.c_str()), 32) : RTLIL::Const(value);
+		applied++;
+	}
+	return applied;
+}
+
+} /* extern "C" */
@@ -0,0 +1,117 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ *  ---
+ *
+ *  Versioned C ABI for plugins that only need to read (and lightly annotate)
+ *  the current design. Unlike linking against kernel/yosys.h, this interface
+ *  is a plain C function/struct surface: it does not change layout with
+ *  kernel refactorings, so plugins built against it keep working across
+ *  yosys versions that report the same YOSYS_CAPI_VERSION.
+ *
+ *  The accessors are bulk by design. One yosys_capi_dump_module() call
+ *  flattens a whole module into four flat arrays (wires, cells, connections,
+ *  signal bits) owned by the dump object, so analysis plugins iterate plain
+ *  arrays instead of crossing the ABI boundary per object. All pointers
+ *  handed out stay valid until the dump is freed, independent of later
+ *  design mutations.
+ *
+ *  Name strings are the exact RTLIL identifiers (public names keep their
+ *  leading backslash); lookups accept unescaped public names too.
+ */
+
+#ifndef YOSYS_CAPI_H
+#define YOSYS_CAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YOSYS_CAPI_VERSION 1
+
+/* returns the YOSYS_CAPI_VERSION the running yosys was built with */
+uint32_t yosys_capi_version(void);
+
+/* constant bit states used in yosys_capi_bit.offset when wire < 0 */
+enum {
+	YOSYS_CAPI_STATE_0 = 0,
+	YOSYS_CAPI_STATE_1 = 1,
+	YOSYS_CAPI_STATE_X = 2,
+	YOSYS_CAPI_STATE_Z = 3,
+	YOSYS_CAPI_STATE_A = 4,
+};
+
+typedef struct {
+	int32_t wire;   /* index into the dump's wire array, or -1 for a constant */
+	int32_t offset; /* bit offset in the wire, or a YOSYS_CAPI_STATE_* value */
+} yosys_capi_bit;
+
+typedef struct {
+	const char *name;
+	int32_t width;
+	int32_t port_id; /* 1-based port position, 0 if not a port */
+	uint8_t port_input, port_output;
+} yosys_capi_wire;
+
+typedef struct {
+	const char *port;
+	uint32_t first_bit, num_bits; /* range in the dump's bit array, MSB last */
+} yosys_capi_conn;
+
+typedef struct {
+	const char *name;
+	const char *type;
+	uint32_t first_conn, num_conns; /* range in the dump's connection array */
+} yosys_capi_cell;
+
+typedef struct yosys_capi_module_dump yosys_capi_module_dump;
+
+/* flattens the named module of the current design; NULL if there is none */
+yosys_capi_module_dump *yosys_capi_dump_module(const char *module_name);
+void yosys_capi_dump_free(yosys_capi_module_dump *dump);
+
+const yosys_capi_wire *yosys_capi_dump_wires(const yosys_capi_module_dump *dump, size_t *count);
+const yosys_capi_cell *yosys_capi_dump_cells(const yosys_capi_module_dump *dump, size_t *count);
+const yosys_capi_conn *yosys_capi_dump_conns(const yosys_capi_module_dump *dump, size_t *count);
+const yosys_capi_bit *yosys_capi_dump_bits(const yosys_capi_module_dump *dump, size_t *count);
+
+/* writes up to max_names selected module names into names[], returns the
+ * total number of selected modules (call with max_names = 0 to size the
+ * buffer); the strings stay valid as long as the modules exist */
+size_t yosys_capi_selected_modules(const char **names, size_t max_names);
+
+/* bulk mutation submission: applies all attribute writes of one batch to
+ * the named module's cells and wires in a single call. A value consisting
+ * only of decimal digits is stored as a 32-bit integer constant, everything
+ * else as a string constant. Returns the number of writes applied; writes
+ * naming unknown objects are skipped. */
+typedef struct {
+	const char *object;    /* cell or wire name */
+	const char *attribute; /* attribute name */
+	const char *value;
+} yosys_capi_attr_write;
+
+size_t yosys_capi_set_attributes(const char *module_name, const yosys_capi_attr_write *writes, size_t num_writes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -469,3 +469,39 @@ bool YOSYS_NAMESPACE_PREFIX AbstractCellEdgesDatabase::add_edges_from_cell(RTLIL
 	return false;
 }
 
+PRIVATE_NAMESPACE_BEGIN
+
+struct RecordingCellEdgesDatabase : AbstractCellEdgesDatabase
+{
+	std::vector<CellEdgesCache::Edge> &edges;
+	RecordingCellEdgesDatabase(std::vector<CellEdgesCache::Edge> &edges) : edges(edges) { }
+
+	void add_edge(RTLIL::Cell *, RTLIL::IdString from_port, int from_bit, RTLIL::IdString to_port, int to_bit, int delay) override {
+		edges.push_back({from_port, to_port, from_bit, to_bit, delay});
+	}
+};
+
+PRIVATE_NAMESPACE_END
+
+bool YOSYS_NAMESPACE_PREFIX CellEdgesCache::add_edges_from_cell(AbstractCellEdgesDatabase *db, RTLIL::Cell *cell)
+{
+	Key key;
+	key.type = cell->type;
+	key.parameters = cell->parameters;
+	for (auto &conn : cell->connections())
+		key.port_widths[conn.first] = GetSize(conn.second);
+
+	auto it = cache.find(key);
+	if (it == cache.end()) {
+		CachedEdges entry;
+		RecordingCellEdgesDatabase recorder(entry.edges);
+		entry.found = recorder.add_edges_from_cell(cell);
+		it = cache.insert(std::make_pair(std::move(key), std::move(entry))).first;
+	}
+
+	for (auto &e : it->second.edges)
+		db->add_edge(cell, e.from_port, e.from_bit, e.to_port, e.to_bit, e.delay);
+
+	return it->second.found;
+}
+
@@ -58,6 +58,47 @@ struct RevCellEdgesDatabase : AbstractCellEdgesDatabase
 	}
 };
 
+// Memoizes the port-bit edge sets produced by add_edges_from_cell(). The
+// generated edges only depend on the cell type, the cell parameters and the
+// port widths, so for netlists with many identical cell instances (e.g.
+// unrolled datapaths) the edge set is computed once per distinct
+// (type, parameters, port widths) tuple and replayed from the cache for
+// all other instances.
+struct CellEdgesCache
+{
+	struct Edge {
+		RTLIL::IdString from_port, to_port;
+		int from_bit, to_bit, delay;
+	};
+
+	// drop-in replacement for db->add_edges_from_cell(cell)
+	bool add_edges_from_cell(AbstractCellEdgesDatabase *db, RTLIL::Cell *cell);
+
+	void clear() { cache.clear(); }
+
+private:
+	struct Key {
+		RTLIL::IdString type;
+		dict<RTLIL::IdString, RTLIL::Const> parameters;
+		dict<RTLIL::IdString, int> port_widths;
+
+		bool operator==(const Key &other) const {
+			return type == other.type && parameters == other.parameters && port_widths == other.port_widths;
+		}
+
+		unsigned int hash() const {
+			return mkhash(type.hash(), mkhash(parameters.hash(), port_widths.hash()));
+		}
+	};
+
+	struct CachedEdges {
+		bool found;
+		std::vector<Edge> edges;
+	};
+
+	dict<Key, CachedEdges> cache;
+};
+
 YOSYS_NAMESPACE_END
 
 #endif
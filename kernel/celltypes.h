@@ -46,6 +46,10 @@ struct CellTypes
 
 	void setup(RTLIL::Design *design = NULL)
 	{
+		// one bucket for each of the ~250 built-in types, so the repeated
+		// setup_type() calls below do not rehash the table while filling it
+		cell_types.reserve(256);
+
 		if (design)
 			setup_design(design);
 
@@ -59,7 +63,7 @@ struct CellTypes
 	void setup_type(RTLIL::IdString type, const pool<RTLIL::IdString> &inputs, const pool<RTLIL::IdString> &outputs, bool is_evaluable = false)
 	{
 		CellType ct = {type, inputs, outputs, is_evaluable};
-		cell_types[ct.type] = ct;
+		cell_types[type] = std::move(ct);
 	}
 
 	void setup_module(RTLIL::Module *module)
@@ -0,0 +1,198 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/conehash.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+// splitmix64 finalizer: cheap, well distributed, and the output depends on
+// all input bits, which matters because the inputs below are often small
+// integers.
+static inline uint64_t mix64(uint64_t v)
+{
+	v += 0x9e3779b97f4a7c15;
+	v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9;
+	v = (v ^ (v >> 27)) * 0x94d049bb133111eb;
+	return v ^ (v >> 31);
+}
+
+static inline uint64_t mix64(uint64_t a, uint64_t b)
+{
+	return mix64(a ^ mix64(b));
+}
+
+static bool is_commutative(const RTLIL::IdString &type)
+{
+	return type.in(ID($and), ID($or), ID($xor), ID($xnor), ID($add), ID($mul),
+			ID($eq), ID($ne), ID($eqx), ID($nex), ID($logic_and), ID($logic_or),
+			ID($_AND_), ID($_OR_), ID($_XOR_), ID($_XNOR_), ID($_NAND_), ID($_NOR_));
+}
+
+ConeHash::ConeHash(RTLIL::Module *module) : module(module), sigmap(module)
+{
+	rebuild();
+}
+
+void ConeHash::rebuild()
+{
+	sigmap.set(module);
+	drivers.clear();
+	readers.clear();
+	bit_cache.clear();
+	in_progress.clear();
+
+	for (auto cell : module->cells())
+	for (auto &conn : cell->connections()) {
+		if (cell->output(conn.first)) {
+			for (int i = 0; i < GetSize(conn.second); i++) {
+				RTLIL::SigBit bit = sigmap(conn.second[i]);
+				if (bit.wire != nullptr)
+					drivers[bit] = driver_t{cell, conn.first, i};
+			}
+		}
+		if (cell->input(conn.first))
+			for (auto bit : sigmap(conn.second))
+				if (bit.wire != nullptr)
+					readers[bit].insert(cell);
+	}
+}
+
+uint64_t ConeHash::hash_leaf(const RTLIL::SigBit &bit)
+{
+	if (bit.wire == nullptr)
+		return mix64(0x636f6e7374, bit.data);
+	if (bit.wire->port_input)
+		return mix64(mix64(0x706f7274, bit.wire->port_id), bit.offset);
+	return mix64(bit.wire->name.hash(), bit.offset);
+}
+
+uint64_t ConeHash::hash_bit(RTLIL::SigBit bit, int max_depth)
+{
+	bit = sigmap(bit);
+
+	if (bit.wire == nullptr || max_depth == 0)
+		return hash_leaf(bit);
+
+	auto it = drivers.find(bit);
+	if (it == drivers.end())
+		return hash_leaf(bit);
+
+	bool cacheable = max_depth < 0;
+
+	if (cacheable) {
+		auto cached = bit_cache.find(bit);
+		if (cached != bit_cache.end())
+			return cached->second;
+
+		// Cut combinational loops at the point of re-entry. The loop bit is
+		// hashed as a leaf, so all bits on a loop still get well-defined
+		// (and consistent) signatures.
+		if (in_progress.count(bit))
+			return hash_leaf(bit);
+		in_progress.insert(bit);
+	}
+
+	uint64_t h = hash_cell_worker(it->second.cell, max_depth < 0 ? -1 : max_depth - 1);
+	h = mix64(h, it->second.port.hash());
+	h = mix64(h, it->second.offset);
+
+	if (cacheable) {
+		in_progress.erase(bit);
+		bit_cache[bit] = h;
+	}
+	return h;
+}
+
+uint64_t ConeHash::hash_sig(const RTLIL::SigSpec &sig, int max_depth)
+{
+	uint64_t h = mix64(GetSize(sig));
+	for (auto &bit : sig)
+		h = mix64(h, hash_bit(bit, max_depth));
+	return h;
+}
+
+uint64_t ConeHash::hash_cell_worker(RTLIL::Cell *cell, int max_depth)
+{
+	uint64_t h = mix64(cell->type.hash());
+
+	std::vector<uint64_t> param_hashes;
+	for (auto &param : cell->parameters)
+		param_hashes.push_back(mix64(param.first.hash(), param.second.hash()));
+	std::sort(param_hashes.begin(), param_hashes.end());
+	for (uint64_t ph : param_hashes)
+		h = mix64(h, ph);
+
+	bool commutative = is_commutative(cell->type);
+	std::vector<uint64_t> commutative_operands;
+
+	for (auto &conn : cell->connections()) {
+		if (!cell->input(conn.first))
+			continue;
+		uint64_t sh = hash_sig(conn.second, max_depth);
+		if (commutative && conn.first.in(ID::A, ID::B)) {
+			commutative_operands.push_back(sh);
+			continue;
+		}
+		h = mix64(h, mix64(conn.first.hash(), sh));
+	}
+
+	std::sort(commutative_operands.begin(), commutative_operands.end());
+	for (uint64_t sh : commutative_operands)
+		h = mix64(h, sh);
+
+	return h;
+}
+
+uint64_t ConeHash::hash_cell(RTLIL::Cell *cell, int max_depth)
+{
+	return hash_cell_worker(cell, max_depth);
+}
+
+void ConeHash::invalidate(RTLIL::Cell *cell)
+{
+	std::vector<RTLIL::Cell*> queue = { cell };
+	pool<RTLIL::Cell*> visited = { cell };
+
+	while (!queue.empty()) {
+		RTLIL::Cell *c = queue.back();
+		queue.pop_back();
+		for (auto &conn : c->connections()) {
+			if (!c->output(conn.first))
+				continue;
+			for (auto bit : sigmap(conn.second)) {
+				if (bit.wire == nullptr || !bit_cache.erase(bit))
+					continue;
+				for (auto reader : readers[bit])
+					if (visited.insert(reader).second)
+						queue.push_back(reader);
+			}
+		}
+	}
+}
+
+void ConeHash::invalidate(RTLIL::SigBit bit)
+{
+	bit = sigmap(bit);
+	if (bit.wire == nullptr || !bit_cache.erase(bit))
+		return;
+	for (auto reader : readers[bit])
+		invalidate(reader);
+}
+
+YOSYS_NAMESPACE_END
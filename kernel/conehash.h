@@ -0,0 +1,84 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef CONEHASH_H
+#define CONEHASH_H
+
+#include "kernel/yosys.h"
+#include "kernel/sigtools.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+// Canonical structural signatures over the SigMap'd netlist of one module.
+//
+// A cone signature of a bit folds together the cell types, parameters and
+// input cones that the bit (transitively) depends on. Two bits with the same
+// signature drive structurally identical logic up to the leaves of the cone;
+// different signatures guarantee structural difference, equal signatures are
+// a strong (but, as with any hash, not conclusive) indication of a match, so
+// callers use the signature as a bucket key and confirm with their own
+// equality check. Operands of commutative cells are normalized, so e.g.
+// `a & b` and `b & a` hash alike.
+//
+// Leaves are constants, module input ports (hashed by port position, so the
+// signatures are comparable across modules) and undriven or dangling wires
+// (hashed by name). Combinational loops are cut at the point of re-entry.
+//
+// Full-depth signatures are cached; use invalidate() after editing a cell or
+// re-driving a wire to keep a long-lived instance consistent instead of
+// rebuilding it. Depth-limited queries (max_depth >= 0 counts cell levels,
+// with 0 hashing the bit as a leaf) bypass the cache.
+struct ConeHash
+{
+	RTLIL::Module *module;
+	SigMap sigmap;
+
+	ConeHash(RTLIL::Module *module);
+
+	uint64_t hash_bit(RTLIL::SigBit bit, int max_depth = -1);
+	uint64_t hash_sig(const RTLIL::SigSpec &sig, int max_depth = -1);
+	uint64_t hash_cell(RTLIL::Cell *cell, int max_depth = -1);
+
+	// Drop the cached signatures of everything in the fan-out of the given
+	// cell or bit, including the cell resp. the bit itself.
+	void invalidate(RTLIL::Cell *cell);
+	void invalidate(RTLIL::SigBit bit);
+
+	// Drop all cached signatures and re-index the module.
+	void rebuild();
+
+private:
+	struct driver_t {
+		RTLIL::Cell *cell;
+		RTLIL::IdString port;
+		int offset;
+	};
+
+	dict<RTLIL::SigBit, driver_t> drivers;
+	dict<RTLIL::SigBit, pool<RTLIL::Cell*>> readers;
+	dict<RTLIL::SigBit, uint64_t> bit_cache;
+	pool<RTLIL::SigBit> in_progress;
+
+	uint64_t hash_leaf(const RTLIL::SigBit &bit);
+	uint64_t hash_cell_worker(RTLIL::Cell *cell, int max_depth);
+};
+
+YOSYS_NAMESPACE_END
+
+#endif
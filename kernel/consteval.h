@@ -38,7 +38,16 @@ struct ConstEval
 	std::vector<SigMap> stack;
 	RTLIL::State defaultval;
 
-	ConstEval(RTLIL::Module *module, RTLIL::State defaultval = RTLIL::State::Sm) : module(module), assign_map(module), defaultval(defaultval)
+	// Optional memoization of per-cell evaluation results, keyed on the cell
+	// and its (fully evaluated) input values. The cache survives clear() and
+	// push()/pop(), so exhaustive evaluation of the same logic cone under many
+	// input assignments (truth table enumeration etc.) only computes each
+	// distinct (cell, input values) pair once. The cache is discarded when the
+	// module's change_count() moves, i.e. when the netlist was modified.
+	bool eval_cache_enabled = false;
+
+	ConstEval(RTLIL::Module *module, RTLIL::State defaultval = RTLIL::State::Sm) :
+			module(module), assign_map(module), defaultval(defaultval), eval_cache_change_count(module->change_count())
 	{
 		CellTypes ct;
 		ct.setup_internals();
@@ -351,6 +360,33 @@ struct ConstEval
 			if (sig_d.size() > 0 && !eval(sig_d, undef, cell))
 				return false;
 
+			if (eval_cache_enabled)
+			{
+				if (module->change_count() != eval_cache_change_count) {
+					eval_cache.clear();
+					eval_cache_change_count = module->change_count();
+				}
+
+				EvalCacheKey key;
+				key.cell = cell;
+				key.inputs = sig_a.as_const();
+				for (auto &sig : {sig_b, sig_c, sig_d})
+					for (auto bit : sig.as_const().bits)
+						key.inputs.bits.push_back(bit);
+
+				auto it = eval_cache.find(key);
+				if (it == eval_cache.end()) {
+					bool eval_err = false;
+					RTLIL::Const eval_ret = CellTypes::eval(cell, sig_a.as_const(), sig_b.as_const(), sig_c.as_const(), sig_d.as_const(), &eval_err);
+					if (eval_err)
+						return false;
+					it = eval_cache.emplace(std::move(key), std::move(eval_ret)).first;
+				}
+
+				set(sig_y, it->second);
+				return true;
+			}
+
 			bool eval_err = false;
 			RTLIL::Const eval_ret = CellTypes::eval(cell, sig_a.as_const(), sig_b.as_const(), sig_c.as_const(), sig_d.as_const(), &eval_err);
 
@@ -418,6 +454,24 @@ struct ConstEval
 		RTLIL::SigSpec undef;
 		return eval(sig, undef);
 	}
+
+private:
+	struct EvalCacheKey
+	{
+		RTLIL::Cell *cell;
+		RTLIL::Const inputs;
+
+		bool operator==(const EvalCacheKey &other) const {
+			return cell == other.cell && inputs == other.inputs;
+		}
+
+		unsigned int hash() const {
+			return mkhash(hashlib::hash_ptr_ops::hash(cell), inputs.hash());
+		}
+	};
+
+	dict<EvalCacheKey, RTLIL::Const> eval_cache;
+	uint64_t eval_cache_change_count;
 };
 
 YOSYS_NAMESPACE_END
@@ -2,14 +2,42 @@
 
 USING_YOSYS_NAMESPACE
 
+// Module costs recurse into the hierarchy, so a change anywhere can affect
+// any cached module cost. The cache is checked against a digest over the
+// per-module change counters and dropped wholesale when the design moved;
+// mutations that bypass the Module/Cell API are not detected.
+void CellCosts::validate_mod_cost_cache()
+{
+	if (design_ == nullptr)
+		return;
+	uint64_t digest = 0xcbf29ce484222325ull;
+	auto mix = [&digest](uint64_t value) {
+		digest = (digest ^ value) * 0x100000001b3ull;
+	};
+	for (auto mod : design_->modules()) {
+		mix(mod->name.hash());
+		mix(mod->change_count());
+	}
+	if (digest != design_digest_) {
+		mod_cost_cache_.clear();
+		design_digest_ = digest;
+	}
+}
+
 unsigned int CellCosts::get(RTLIL::Module *mod)
+{
+	validate_mod_cost_cache();
+	return do_get(mod);
+}
+
+unsigned int CellCosts::do_get(RTLIL::Module *mod)
 {
 	if (mod_cost_cache_.count(mod->name))
 		return mod_cost_cache_.at(mod->name);
 
 	unsigned int module_cost = 1;
 	for (auto c : mod->cells()) {
-		unsigned int new_cost = module_cost + get(c);
+		unsigned int new_cost = module_cost + do_get(c);
 		module_cost = new_cost >= module_cost ? new_cost : INT_MAX;
 	}
 
@@ -17,6 +45,18 @@ unsigned int CellCosts::get(RTLIL::Module *mod)
 	return module_cost;
 }
 
+std::vector<std::pair<RTLIL::Cell*, unsigned int>> CellCosts::get_selected()
+{
+	log_assert(design_ != nullptr);
+	validate_mod_cost_cache();
+
+	std::vector<std::pair<RTLIL::Cell*, unsigned int>> result;
+	for (auto mod : design_->selected_modules())
+		for (auto cell : mod->selected_cells())
+			result.push_back({cell, do_get(cell)});
+	return result;
+}
+
 static unsigned int y_coef(RTLIL::IdString type)
 {
 	if (
@@ -136,15 +176,44 @@ unsigned int port_width_sum(RTLIL::Cell *cell)
 
 unsigned int CellCosts::get(RTLIL::Cell *cell)
 {
+	// the module cost cache only needs revalidating when the query can
+	// reach it, i.e. for cells instantiating a module of the design
+	if (design_ && design_->module(cell->type) && cell->parameters.empty())
+		validate_mod_cost_cache();
+	return do_get(cell);
+}
 
+unsigned int CellCosts::do_get(RTLIL::Cell *cell)
+{
 	// simple 1-bit cells
 	if (cmos_gate_cost().count(cell->type))
 		return 1;
 
 	if (design_ && design_->module(cell->type) && cell->parameters.empty()) {
 		log_debug("%s is a module, recurse\n", cell->name.c_str());
-		return get(design_->module(cell->type));
-	} else if (RTLIL::builtin_ff_cell_types().count(cell->type)) {
+		return do_get(design_->module(cell->type));
+	}
+
+	// everything below depends only on the cell type and parameters, so
+	// the result is memoized under a (type, parameter-hash) key; the hash
+	// combines commutatively to be independent of insertion order
+	unsigned int param_hash = 0;
+	for (auto &param : cell->parameters)
+		param_hash += mkhash(param.first.hash(), param.second.hash());
+	std::pair<RTLIL::IdString, unsigned int> key(cell->type, param_hash);
+
+	auto it = cell_cost_cache_.find(key);
+	if (it != cell_cost_cache_.end())
+		return it->second;
+
+	unsigned int cost = compute(cell);
+	cell_cost_cache_[key] = cost;
+	return cost;
+}
+
+unsigned int CellCosts::compute(RTLIL::Cell *cell)
+{
+	if (RTLIL::builtin_ff_cell_types().count(cell->type)) {
 		log_assert(cell->hasPort(ID::Q) && "Weird flip flop");
 		log_debug("%s is ff\n", cell->name.c_str());
 		return cell->getParam(ID::WIDTH).as_int();
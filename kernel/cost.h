@@ -29,8 +29,18 @@ struct CellCosts
 
 	private:
 	dict<RTLIL::IdString, int> mod_cost_cache_;
+	// memoized per-(type, parameter-hash) costs; the gate-level cost of a
+	// cell only depends on its type and parameters, and ranking loops (e.g.
+	// share, abc ordering) see the same few combinations over and over
+	dict<std::pair<RTLIL::IdString, unsigned int>, unsigned int> cell_cost_cache_;
+	uint64_t design_digest_ = 0;
 	Design *design_ = nullptr;
 
+	unsigned int compute(RTLIL::Cell *cell);
+	unsigned int do_get(RTLIL::Cell *cell);
+	unsigned int do_get(RTLIL::Module *mod);
+	void validate_mod_cost_cache();
+
 	public:
 	CellCosts(RTLIL::Design *design) : design_(design) { }
 
@@ -92,6 +102,10 @@ struct CellCosts
 	// Sum up the cell costs of all cells in the module
 	// and all its submodules recursively
 	unsigned int get(RTLIL::Module *mod);
+	// Bulk costing: cost every selected cell of every selected module in
+	// one call. The packed result is meant for ranking loops that would
+	// otherwise call get() per cell.
+	std::vector<std::pair<RTLIL::Cell*, unsigned int>> get_selected();
 };
 
 YOSYS_NAMESPACE_END
@@ -313,6 +313,10 @@ int main(int argc, char **argv)
 		printf("    -m module_file\n");
 		printf("        load the specified module (aka plugin)\n");
 		printf("\n");
+		printf("    -j num_threads\n");
+		printf("        size of the worker thread pool used by parallelized passes\n");
+		printf("        (0 = number of hardware threads, which is also the default)\n");
+		printf("\n");
 		printf("    -X\n");
 		printf("        enable tracing of core data structure changes. for debugging\n");
 		printf("\n");
@@ -379,7 +383,7 @@ int main(int argc, char **argv)
 	}
 
 	int opt;
-	while ((opt = getopt(argc, argv, "MXAQTVCSgm:f:Hh:b:o:p:l:L:qv:tds:c:W:w:e:r:D:P:E:x:B:")) != -1)
+	while ((opt = getopt(argc, argv, "MXAQTVCSgm:f:Hh:b:o:p:l:L:qv:tds:c:W:w:e:r:D:P:E:x:B:j:")) != -1)
 	{
 		switch (opt)
 		{
@@ -461,6 +465,9 @@ int main(int argc, char **argv)
 		case 'd':
 			timing_details = true;
 			break;
+		case 'j':
+			ThreadPool::set_num_threads(atoi(optarg));
+			break;
 		case 's':
 			scriptfile = optarg;
 			scriptfile_tcl = false;
@@ -652,6 +652,23 @@ void DriverMap::connect_undirected(DriveBitId a_id, DriveBitId b_id)
 
 void DriverMap::add(Module *module)
 {
+	// Bulk-build path: pre-size the sparse id maps and the union-find from a
+	// cheap counting pass so the scan below doesn't grow them incrementally.
+	// The ids for a wire or port are allocated for the full width on first
+	// touch, so summing widths gives the final id count.
+	int num_ports = 0;
+	int num_bits = 1 + (int)State::Sm;
+	for (auto wire : module->wires())
+		num_bits += wire->width;
+	for (auto cell : module->cells()) {
+		num_ports += GetSize(cell->connections());
+		for (auto const &conn : cell->connections())
+			num_bits += conn.second.size();
+	}
+	wire_offsets.reserve(GetSize(module->wires_));
+	port_offsets.reserve(num_ports);
+	same_driver.reserve(num_bits);
+
 	for (auto const &conn : module->connections())
 		add(conn.first, conn.second);
 
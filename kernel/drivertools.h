@@ -1325,6 +1325,67 @@ private:
 		// TODO configurable
 		return wire->has_attribute(ID(keep));
 	}
+
+	friend struct DriverMapMonitor;
+};
+
+// Keeps a DriverMap live across additive module mutations while it is in
+// scope, following the same pattern as SigMapMonitor: new connections and
+// newly connected cell ports are added to the map incrementally. The map
+// has no way to retract information, so destructive changes (rewiring an
+// already connected port, blackouting the module) mark the map as stale;
+// consumers should check stale() and rebuild when it is set.
+struct DriverMapMonitor : RTLIL::Monitor
+{
+	DriverMap &drivermap;
+	RTLIL::Module *module;
+	bool stale = false;
+
+	DriverMapMonitor(DriverMap &drivermap, RTLIL::Module *module) : drivermap(drivermap), module(module)
+	{
+		module->monitors.insert(this);
+	}
+
+	~DriverMapMonitor()
+	{
+		module->monitors.erase(this);
+	}
+
+	void notify_connect(RTLIL::Cell *cell, const RTLIL::IdString &port, const RTLIL::SigSpec &old_sig, const RTLIL::SigSpec &sig) override
+	{
+		if (cell->module != module || stale)
+			return;
+		if (!old_sig.empty()) {
+			stale = true;
+			return;
+		}
+		drivermap.add_port(cell, port, sig);
+	}
+
+	void notify_connect(RTLIL::Module *mod, const RTLIL::SigSig &sigsig) override
+	{
+		if (mod == module && !stale)
+			drivermap.add(sigsig.first, sigsig.second);
+	}
+
+	void notify_connect(RTLIL::Module *mod, const std::vector<RTLIL::SigSig> &sigsig_vec) override
+	{
+		if (mod == module && !stale)
+			for (auto &sigsig : sigsig_vec)
+				drivermap.add(sigsig.first, sigsig.second);
+	}
+
+	void notify_blackout(RTLIL::Module *mod) override
+	{
+		if (mod == module)
+			stale = true;
+	}
+
+	void notify_module_del(RTLIL::Module *mod) override
+	{
+		if (mod == module)
+			stale = true;
+	}
 };
 
 YOSYS_NAMESPACE_END
@@ -25,42 +25,96 @@
 
 YOSYS_NAMESPACE_BEGIN
 
+// Caches, per module, the list of wires carrying an \init attribute, so that
+// code rebuilding a FfInitVals for the same module many times (e.g. once per
+// iteration of a fixpoint loop) only pays for a full wire scan when the module
+// actually changed.  An entry is considered valid as long as the module's
+// change_count() matches the snapshot taken when the entry was built; any
+// structural modification made through the RTLIL::Module interface invalidates
+// it automatically.  Note that writing \init attributes directly (bypassing
+// FfInitVals::set_init on a FfInitVals bound to this cache) does not bump the
+// change count -- code doing that while a cache is live must call invalidate()
+// for the affected module.  The cache must not outlive the modules it has
+// entries for.
+struct FfInitValsCache
+{
+	struct ModuleEntry {
+		uint64_t change_count;
+		std::vector<RTLIL::Wire*> init_wires;
+	};
+
+	dict<RTLIL::Module*, ModuleEntry, hash_ptr_ops> entries;
+
+	void invalidate(RTLIL::Module *module)
+	{
+		entries.erase(module);
+	}
+
+	void clear()
+	{
+		entries.clear();
+	}
+};
+
 struct FfInitVals
 {
 	const SigMap *sigmap;
 	dict<SigBit, std::pair<State,SigBit>> initbits;
+	FfInitValsCache *cache = nullptr;
 
-	void set(const SigMap *sigmap_, RTLIL::Module *module)
+	void add_wire(RTLIL::Wire *wire)
 	{
-		sigmap = sigmap_;
-		initbits.clear();
-		for (auto wire : module->wires())
+		if (wire->attributes.count(ID::init) == 0)
+			return;
+
+		SigSpec wirebits = (*sigmap)(wire);
+		Const initval = wire->attributes.at(ID::init);
+
+		for (int i = 0; i < GetSize(wirebits) && i < GetSize(initval); i++)
 		{
-			if (wire->attributes.count(ID::init) == 0)
+			SigBit bit = wirebits[i];
+			State val = initval[i];
+
+			if (val != State::S0 && val != State::S1 && bit.wire != nullptr)
 				continue;
 
-			SigSpec wirebits = (*sigmap)(wire);
-			Const initval = wire->attributes.at(ID::init);
+			if (initbits.count(bit)) {
+				if (initbits.at(bit).first != val)
+					log_error("Conflicting init values for signal %s (%s = %s != %s).\n",
+							log_signal(bit), log_signal(SigBit(wire, i)),
+							log_signal(val), log_signal(initbits.at(bit).first));
+				continue;
+			}
 
-			for (int i = 0; i < GetSize(wirebits) && i < GetSize(initval); i++)
-			{
-				SigBit bit = wirebits[i];
-				State val = initval[i];
+			initbits[bit] = std::make_pair(val,SigBit(wire,i));
+		}
+	}
 
-				if (val != State::S0 && val != State::S1 && bit.wire != nullptr)
-					continue;
+	void set(const SigMap *sigmap_, RTLIL::Module *module, FfInitValsCache *cache_ = nullptr)
+	{
+		sigmap = sigmap_;
+		cache = cache_;
+		initbits.clear();
 
-				if (initbits.count(bit)) {
-					if (initbits.at(bit).first != val)
-						log_error("Conflicting init values for signal %s (%s = %s != %s).\n",
-								log_signal(bit), log_signal(SigBit(wire, i)),
-								log_signal(val), log_signal(initbits.at(bit).first));
-					continue;
-				}
+		if (cache == nullptr) {
+			for (auto wire : module->wires())
+				add_wire(wire);
+			return;
+		}
 
-				initbits[bit] = std::make_pair(val,SigBit(wire,i));
-			}
+		auto it = cache->entries.find(module);
+		if (it == cache->entries.end() || it->second.change_count != module->change_count()) {
+			auto &entry = cache->entries[module];
+			entry.change_count = module->change_count();
+			entry.init_wires.clear();
+			for (auto wire : module->wires())
+				if (wire->attributes.count(ID::init))
+					entry.init_wires.push_back(wire);
+			it = cache->entries.find(module);
 		}
+
+		for (auto wire : it->second.init_wires)
+			add_wire(wire);
 	}
 
 	RTLIL::State operator()(RTLIL::SigBit bit) const
@@ -100,6 +154,11 @@ struct FfInitVals
 			Const cval(State::Sx, GetSize(abit.wire));
 			cval[abit.offset] = val;
 			abit.wire->attributes[ID::init] = cval;
+			if (cache != nullptr) {
+				auto it3 = cache->entries.find(abit.wire->module);
+				if (it3 != cache->entries.end())
+					it3->second.init_wires.push_back(abit.wire);
+			}
 		}
 	}
 
@@ -195,7 +195,7 @@ static void reconstruct_clb_attimes(void *user_data, uint64_t pnt_time, fstHandl
 	ptr->reconstruct_callback_attimes(pnt_time, pnt_facidx, pnt_value, plen);
 }
 
-void FstData::reconstruct_callback_attimes(uint64_t pnt_time, fstHandle pnt_facidx, const unsigned char *pnt_value, uint32_t /* plen */)
+void FstData::reconstruct_callback_attimes(uint64_t pnt_time, fstHandle pnt_facidx, const unsigned char *pnt_value, uint32_t plen)
 {
 	if (pnt_time > end_time || !pnt_value) return;
 	// if we are past the timestamp
@@ -210,7 +210,9 @@ void FstData::reconstruct_callback_attimes(uint64_t pnt_time, fstHandle pnt_faci
 	}
 
 	if (pnt_time > past_time) {
-		past_data = last_data;
+		// All changes of the previous timestamp are committed in
+		// last_data now, so the saved pre-change values can be dropped.
+		past_values.clear();
 		past_time = pnt_time;
 	}
 
@@ -221,7 +223,7 @@ void FstData::reconstruct_callback_attimes(uint64_t pnt_time, fstHandle pnt_faci
 		} else {
 			if (is_clock) {
 				std::string val = std::string((const char *)pnt_value);
-				std::string prev = past_data[pnt_facidx];
+				const std::string &prev = pastValueOf(pnt_facidx);
 				if ((prev!="1" && val=="1") || (prev!="0" && val=="0")) {
 					callback(last_time);
 					last_time = pnt_time;
@@ -229,8 +231,12 @@ void FstData::reconstruct_callback_attimes(uint64_t pnt_time, fstHandle pnt_faci
 			}
 		}
 	}
-	// always update last_data
-	last_data[pnt_facidx] =  std::string((const char *)pnt_value);
+	// always update last_data, saving the previous value so that
+	// valueOf() keeps reporting the state as of the last callback time
+	auto &slot = last_data[pnt_facidx];
+	if (!past_values.count(pnt_facidx))
+		past_values[pnt_facidx] = slot;
+	slot.assign((const char *)pnt_value, plen);
 }
 
 void FstData::reconstructAllAtTimes(std::vector<fstHandle> &signal, uint64_t start, uint64_t end, CallbackFunction cb)
@@ -241,7 +247,7 @@ void FstData::reconstructAllAtTimes(std::vector<fstHandle> &signal, uint64_t sta
 	end_time = end;
 	last_data.clear();
 	last_time = start_time;
-	past_data.clear();
+	past_values.clear();
 	past_time = start_time;
 	all_samples = clk_signals.empty();
 
@@ -249,16 +255,32 @@ void FstData::reconstructAllAtTimes(std::vector<fstHandle> &signal, uint64_t sta
 	fstReaderSetFacProcessMaskAll(ctx);
 	fstReaderIterBlocks2(ctx, reconstruct_clb_attimes, reconstruct_clb_varlen_attimes, this, nullptr);
 	if (last_time!=end_time) {
-		past_data = last_data;
+		past_values.clear();
 		callback(last_time);
 	}
-	past_data = last_data;
+	past_values.clear();
 	callback(end_time);
 }
 
+const std::string &FstData::pastValueOf(fstHandle signal)
+{
+	static const std::string empty;
+	auto it = past_values.find(signal);
+	if (it != past_values.end())
+		return it->second;
+	auto it_last = last_data.find(signal);
+	if (it_last != last_data.end())
+		return it_last->second;
+	return empty;
+}
+
 std::string FstData::valueOf(fstHandle signal)
 {
-	if (past_data.find(signal) == past_data.end())
+	auto it = past_values.find(signal);
+	if (it != past_values.end())
+		return it->second;
+	auto it_last = last_data.find(signal);
+	if (it_last == last_data.end())
 		log_error("Signal id %d not found\n", (int)signal);
-	return past_data[signal];
+	return it_last->second;
 }
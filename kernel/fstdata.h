@@ -65,9 +65,15 @@ private:
 	std::map<fstHandle, FstVar> handle_to_var;
 	std::map<std::string, fstHandle> name_to_handle;
 	std::map<std::string, dict<int, fstHandle>> memory_to_handle;
+	const std::string &pastValueOf(fstHandle signal);
+
 	std::map<fstHandle, std::string> last_data;
 	uint64_t last_time;
-	std::map<fstHandle, std::string> past_data;
+	// Pre-change values of the handles that changed since past_time.
+	// Overlaid over last_data this reconstructs the state as of the last
+	// callback time, without copying the whole value map on every
+	// timestamp of the trace.
+	std::map<fstHandle, std::string> past_values;
 	uint64_t past_time;
 	double timescale;
 	std::string timescale_str;
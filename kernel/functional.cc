@@ -734,7 +734,7 @@ void IR::topological_sort() {
     Graph::SccAdaptor compute_graph_scc(_graph);
     bool scc = false;
     std::vector<int> perm;
-    TopoSortedSccs toposort(compute_graph_scc, [&](int *begin, int *end) {
+    ParallelTopoSortedSccs toposort(compute_graph_scc, [&](int *begin, int *end) {
         perm.insert(perm.end(), begin, end);
         if (end > begin + 1)
         {
@@ -747,18 +747,35 @@ void IR::topological_sort() {
             scc = true;
         }
     });
+	std::vector<int> roots;
 	for(const auto &[name, state]: _states)
 		if(state.has_next_value())
-			toposort.process(state.next_value().id());
+			roots.push_back(state.next_value().id());
 	for(const auto &[name, output]: _outputs)
 		if(output.has_value())
-			toposort.process(output.value().id());
+			roots.push_back(output.value().id());
+	toposort.process(roots);
 	// any nodes untouched by this point are dead code and will be removed by permute
     _graph.permute(perm);
     if(scc) log_error("The design contains combinational loops. This is not supported by the functional backend. "
 		"Try `scc -select; simplemap; select -clear` to avoid this error.\n");
 }
 
+std::vector<int> IR::scheduling_levels() const {
+    std::vector<int> levels(_graph.size(), 0);
+    for (int i = 0; i < _graph.size(); ++i)
+    {
+        auto ref = _graph[i];
+        int level = 0;
+        for (auto it = ref.arg_indices_cbegin(); it != ref.arg_indices_cend(); ++it) {
+            log_assert(*it < i);
+            level = max(level, levels[*it] + 1);
+        }
+        levels[i] = level;
+    }
+    return levels;
+}
+
 static IdString merge_name(IdString a, IdString b) {
 	if(a[0] == '$' && b[0] == '\\')
 		return b;
@@ -252,6 +252,11 @@ namespace Functional {
 		int size() const { return _graph.size(); }
 		Node operator[](int i);
 		void topological_sort();
+		// returns for every node the length of the longest path leading to it from
+		// a node without arguments (requires a topologically sorted graph). nodes of
+		// equal level never depend on each other, so the levels form a layered
+		// schedule that backends can use to evaluate nodes in parallel
+		std::vector<int> scheduling_levels() const;
 		void forward_buf();
 		IRInput const& input(IdString name, IdString kind) const { return _inputs.at({name, kind}); }
 		IRInput const& input(IdString name) const { return input(name, ID($input)); }
@@ -537,7 +542,8 @@ namespace Functional {
 			return add(Fn::memory_write, mem.sort(), {mem, addr, data});
 		}
 		Node constant(RTLIL::Const value) {
-			return add(IR::NodeData(Fn::constant, std::move(value)), Sort(value.size()), {});
+			Sort sort(value.size());
+			return add(IR::NodeData(Fn::constant, std::move(value)), sort, {});
 		}
 		Node create_pending(int width) {
 			return add(Fn::buf, Sort(width), {});
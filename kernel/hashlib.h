@@ -24,6 +24,13 @@ namespace hashlib {
 const int hashtable_size_trigger = 2;
 const int hashtable_size_factor = 3;
 
+// Containers with at most this many entries don't allocate a hashtable and
+// are searched linearly instead (with a full-hash pre-compare, so keys are
+// rarely compared). The bulk of all dicts in a netlist are tiny -- attribute
+// and parameter maps, per-cell connections -- and skipping the hashtable
+// halves their allocation count and saves ~100 bytes each.
+const int hashtable_linear_threshold = 8;
+
 // The XOR version of DJB2
 inline unsigned int mkhash(unsigned int a, unsigned int b) {
 	return ((a << 5) + a) ^ b;
@@ -257,10 +264,11 @@ class dict
 	{
 		std::pair<K, T> udata;
 		int next;
+		unsigned int hash;
 
 		entry_t() { }
-		entry_t(const std::pair<K, T> &udata, int next) : udata(udata), next(next) { }
-		entry_t(std::pair<K, T> &&udata, int next) : udata(std::move(udata)), next(next) { }
+		entry_t(const std::pair<K, T> &udata, int next, unsigned int hash) : udata(udata), next(next), hash(hash) { }
+		entry_t(std::pair<K, T> &&udata, int next, unsigned int hash) : udata(std::move(udata)), next(next), hash(hash) { }
 		bool operator<(const entry_t &other) const { return udata.first < other.udata.first; }
 	};
 
@@ -276,12 +284,18 @@ class dict
 	}
 #endif
 
+	// do_hash() returns the full (unreduced) hash of a key; the bucket in
+	// the hashtable is derived from it with do_slot(). Entries remember
+	// their full hash, so chain probing can skip expensive key comparisons
+	// and rehashing never hashes a key twice.
 	int do_hash(const K &key) const
 	{
-		unsigned int hash = 0;
-		if (!hashtable.empty())
-			hash = ops.hash(key) % (unsigned int)(hashtable.size());
-		return hash;
+		return (int)ops.hash(key);
+	}
+
+	int do_slot(int hash) const
+	{
+		return (int)((unsigned int)hash % (unsigned int)hashtable.size());
 	}
 
 	void do_rehash()
@@ -291,23 +305,33 @@ class dict
 
 		for (int i = 0; i < int(entries.size()); i++) {
 			do_assert(-1 <= entries[i].next && entries[i].next < int(entries.size()));
-			int hash = do_hash(entries[i].udata.first);
-			entries[i].next = hashtable[hash];
-			hashtable[hash] = i;
+			int slot = do_slot(entries[i].hash);
+			entries[i].next = hashtable[slot];
+			hashtable[slot] = i;
 		}
 	}
 
 	int do_erase(int index, int hash)
 	{
 		do_assert(index < int(entries.size()));
-		if (hashtable.empty() || index < 0)
+		if (index < 0)
 			return 0;
 
-		int k = hashtable[hash];
+		if (hashtable.empty()) {
+			// linear mode: no chains to fix up
+			int back_idx = entries.size()-1;
+			if (index != back_idx)
+				entries[index] = std::move(entries[back_idx]);
+			entries.pop_back();
+			return 1;
+		}
+
+		int slot = do_slot(hash);
+		int k = hashtable[slot];
 		do_assert(0 <= k && k < int(entries.size()));
 
 		if (k == index) {
-			hashtable[hash] = entries[index].next;
+			hashtable[slot] = entries[index].next;
 		} else {
 			while (entries[k].next != index) {
 				k = entries[k].next;
@@ -320,7 +344,7 @@ class dict
 
 		if (index != back_idx)
 		{
-			int back_hash = do_hash(entries[back_idx].udata.first);
+			int back_hash = do_slot(entries[back_idx].hash);
 
 			k = hashtable[back_hash];
 			do_assert(0 <= k && k < int(entries.size()));
@@ -348,17 +372,19 @@ class dict
 
 	int do_lookup(const K &key, int &hash) const
 	{
-		if (hashtable.empty())
+		if (hashtable.empty()) {
+			for (int i = 0; i < int(entries.size()); i++)
+				if (entries[i].hash == (unsigned int)hash && ops.cmp(entries[i].udata.first, key))
+					return i;
 			return -1;
+		}
 
-		if (entries.size() * hashtable_size_trigger > hashtable.size()) {
+		if (entries.size() * hashtable_size_trigger > hashtable.size())
 			((dict*)this)->do_rehash();
-			hash = do_hash(key);
-		}
 
-		int index = hashtable[hash];
+		int index = hashtable[do_slot(hash)];
 
-		while (index >= 0 && !ops.cmp(entries[index].udata.first, key)) {
+		while (index >= 0 && !(entries[index].hash == (unsigned int)hash && ops.cmp(entries[index].udata.first, key))) {
 			index = entries[index].next;
 			do_assert(-1 <= index && index < int(entries.size()));
 		}
@@ -369,12 +395,13 @@ class dict
 	int do_insert(const K &key, int &hash)
 	{
 		if (hashtable.empty()) {
-			entries.emplace_back(std::pair<K, T>(key, T()), -1);
-			do_rehash();
-			hash = do_hash(key);
+			entries.emplace_back(std::pair<K, T>(key, T()), -1, (unsigned int)hash);
+			if (int(entries.size()) > hashtable_linear_threshold)
+				do_rehash();
 		} else {
-			entries.emplace_back(std::pair<K, T>(key, T()), hashtable[hash]);
-			hashtable[hash] = entries.size() - 1;
+			int slot = do_slot(hash);
+			entries.emplace_back(std::pair<K, T>(key, T()), hashtable[slot], (unsigned int)hash);
+			hashtable[slot] = entries.size() - 1;
 		}
 		return entries.size() - 1;
 	}
@@ -382,12 +409,13 @@ class dict
 	int do_insert(const std::pair<K, T> &value, int &hash)
 	{
 		if (hashtable.empty()) {
-			entries.emplace_back(value, -1);
-			do_rehash();
-			hash = do_hash(value.first);
+			entries.emplace_back(value, -1, (unsigned int)hash);
+			if (int(entries.size()) > hashtable_linear_threshold)
+				do_rehash();
 		} else {
-			entries.emplace_back(value, hashtable[hash]);
-			hashtable[hash] = entries.size() - 1;
+			int slot = do_slot(hash);
+			entries.emplace_back(value, hashtable[slot], (unsigned int)hash);
+			hashtable[slot] = entries.size() - 1;
 		}
 		return entries.size() - 1;
 	}
@@ -395,13 +423,13 @@ class dict
 	int do_insert(std::pair<K, T> &&rvalue, int &hash)
 	{
 		if (hashtable.empty()) {
-			auto key = rvalue.first;
-			entries.emplace_back(std::forward<std::pair<K, T>>(rvalue), -1);
-			do_rehash();
-			hash = do_hash(key);
+			entries.emplace_back(std::forward<std::pair<K, T>>(rvalue), -1, (unsigned int)hash);
+			if (int(entries.size()) > hashtable_linear_threshold)
+				do_rehash();
 		} else {
-			entries.emplace_back(std::forward<std::pair<K, T>>(rvalue), hashtable[hash]);
-			hashtable[hash] = entries.size() - 1;
+			int slot = do_slot(hash);
+			entries.emplace_back(std::forward<std::pair<K, T>>(rvalue), hashtable[slot], (unsigned int)hash);
+			hashtable[slot] = entries.size() - 1;
 		}
 		return entries.size() - 1;
 	}
@@ -463,7 +491,8 @@ public:
 	dict(const dict &other)
 	{
 		entries = other.entries;
-		do_rehash();
+		if (int(entries.size()) > hashtable_linear_threshold)
+			do_rehash();
 	}
 
 	dict(dict &&other)
@@ -473,7 +502,10 @@ public:
 
 	dict &operator=(const dict &other) {
 		entries = other.entries;
-		do_rehash();
+		if (int(entries.size()) > hashtable_linear_threshold)
+			do_rehash();
+		else
+			hashtable.clear(); // back to linear mode; a stale table would shadow the new entries
 		return *this;
 	}
 
@@ -658,7 +690,8 @@ public:
 	void sort(Compare comp = Compare())
 	{
 		std::sort(entries.begin(), entries.end(), [comp](const entry_t &a, const entry_t &b){ return comp(b.udata.first, a.udata.first); });
-		do_rehash();
+		if (!hashtable.empty())
+			do_rehash();
 	}
 
 	void swap(dict &other)
@@ -715,10 +748,11 @@ protected:
 	{
 		K udata;
 		int next;
+		unsigned int hash;
 
 		entry_t() { }
-		entry_t(const K &udata, int next) : udata(udata), next(next) { }
-		entry_t(K &&udata, int next) : udata(std::move(udata)), next(next) { }
+		entry_t(const K &udata, int next, unsigned int hash) : udata(udata), next(next), hash(hash) { }
+		entry_t(K &&udata, int next, unsigned int hash) : udata(std::move(udata)), next(next), hash(hash) { }
 	};
 
 	std::vector<int> hashtable;
@@ -733,12 +767,18 @@ protected:
 	}
 #endif
 
+	// do_hash() returns the full (unreduced) hash of a key; the bucket in
+	// the hashtable is derived from it with do_slot(). Entries remember
+	// their full hash, so chain probing can skip expensive key comparisons
+	// and rehashing never hashes a key twice.
 	int do_hash(const K &key) const
 	{
-		unsigned int hash = 0;
-		if (!hashtable.empty())
-			hash = ops.hash(key) % (unsigned int)(hashtable.size());
-		return hash;
+		return (int)ops.hash(key);
+	}
+
+	int do_slot(int hash) const
+	{
+		return (int)((unsigned int)hash % (unsigned int)hashtable.size());
 	}
 
 	void do_rehash()
@@ -748,21 +788,31 @@ protected:
 
 		for (int i = 0; i < int(entries.size()); i++) {
 			do_assert(-1 <= entries[i].next && entries[i].next < int(entries.size()));
-			int hash = do_hash(entries[i].udata);
-			entries[i].next = hashtable[hash];
-			hashtable[hash] = i;
+			int slot = do_slot(entries[i].hash);
+			entries[i].next = hashtable[slot];
+			hashtable[slot] = i;
 		}
 	}
 
 	int do_erase(int index, int hash)
 	{
 		do_assert(index < int(entries.size()));
-		if (hashtable.empty() || index < 0)
+		if (index < 0)
 			return 0;
 
-		int k = hashtable[hash];
+		if (hashtable.empty()) {
+			// linear mode: no chains to fix up
+			int back_idx = entries.size()-1;
+			if (index != back_idx)
+				entries[index] = std::move(entries[back_idx]);
+			entries.pop_back();
+			return 1;
+		}
+
+		int slot = do_slot(hash);
+		int k = hashtable[slot];
 		if (k == index) {
-			hashtable[hash] = entries[index].next;
+			hashtable[slot] = entries[index].next;
 		} else {
 			while (entries[k].next != index) {
 				k = entries[k].next;
@@ -775,7 +825,7 @@ protected:
 
 		if (index != back_idx)
 		{
-			int back_hash = do_hash(entries[back_idx].udata);
+			int back_hash = do_slot(entries[back_idx].hash);
 
 			k = hashtable[back_hash];
 			if (k == back_idx) {
@@ -801,17 +851,19 @@ protected:
 
 	int do_lookup(const K &key, int &hash) const
 	{
-		if (hashtable.empty())
+		if (hashtable.empty()) {
+			for (int i = 0; i < int(entries.size()); i++)
+				if (entries[i].hash == (unsigned int)hash && ops.cmp(entries[i].udata, key))
+					return i;
 			return -1;
+		}
 
-		if (entries.size() * hashtable_size_trigger > hashtable.size()) {
+		if (entries.size() * hashtable_size_trigger > hashtable.size())
 			((pool*)this)->do_rehash();
-			hash = do_hash(key);
-		}
 
-		int index = hashtable[hash];
+		int index = hashtable[do_slot(hash)];
 
-		while (index >= 0 && !ops.cmp(entries[index].udata, key)) {
+		while (index >= 0 && !(entries[index].hash == (unsigned int)hash && ops.cmp(entries[index].udata, key))) {
 			index = entries[index].next;
 			do_assert(-1 <= index && index < int(entries.size()));
 		}
@@ -822,12 +874,13 @@ protected:
 	int do_insert(const K &value, int &hash)
 	{
 		if (hashtable.empty()) {
-			entries.emplace_back(value, -1);
-			do_rehash();
-			hash = do_hash(value);
+			entries.emplace_back(value, -1, (unsigned int)hash);
+			if (int(entries.size()) > hashtable_linear_threshold)
+				do_rehash();
 		} else {
-			entries.emplace_back(value, hashtable[hash]);
-			hashtable[hash] = entries.size() - 1;
+			int slot = do_slot(hash);
+			entries.emplace_back(value, hashtable[slot], (unsigned int)hash);
+			hashtable[slot] = entries.size() - 1;
 		}
 		return entries.size() - 1;
 	}
@@ -835,12 +888,13 @@ protected:
 	int do_insert(K &&rvalue, int &hash)
 	{
 		if (hashtable.empty()) {
-			entries.emplace_back(std::forward<K>(rvalue), -1);
-			do_rehash();
-			hash = do_hash(rvalue);
+			entries.emplace_back(std::forward<K>(rvalue), -1, (unsigned int)hash);
+			if (int(entries.size()) > hashtable_linear_threshold)
+				do_rehash();
 		} else {
-			entries.emplace_back(std::forward<K>(rvalue), hashtable[hash]);
-			hashtable[hash] = entries.size() - 1;
+			int slot = do_slot(hash);
+			entries.emplace_back(std::forward<K>(rvalue), hashtable[slot], (unsigned int)hash);
+			hashtable[slot] = entries.size() - 1;
 		}
 		return entries.size() - 1;
 	}
@@ -898,7 +952,8 @@ public:
 	pool(const pool &other)
 	{
 		entries = other.entries;
-		do_rehash();
+		if (int(entries.size()) > hashtable_linear_threshold)
+			do_rehash();
 	}
 
 	pool(pool &&other)
@@ -908,7 +963,10 @@ public:
 
 	pool &operator=(const pool &other) {
 		entries = other.entries;
-		do_rehash();
+		if (int(entries.size()) > hashtable_linear_threshold)
+			do_rehash();
+		else
+			hashtable.clear(); // back to linear mode; a stale table would shadow the new entries
 		return *this;
 	}
 
@@ -1020,7 +1078,8 @@ public:
 	void sort(Compare comp = Compare())
 	{
 		std::sort(entries.begin(), entries.end(), [comp](const entry_t &a, const entry_t &b){ return comp(b.udata, a.udata); });
-		do_rehash();
+		if (!hashtable.empty())
+			do_rehash();
 	}
 
 	K pop()
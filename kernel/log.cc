@@ -35,6 +35,10 @@
 #include <stdarg.h>
 #include <vector>
 #include <list>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 YOSYS_NAMESPACE_BEGIN
 
@@ -65,14 +69,19 @@ int log_make_debug = 0;
 int log_force_debug = 0;
 int log_debug_suppressed = 0;
 
-vector<int> header_count;
-vector<char*> log_id_cache;
-vector<shared_str> string_buf;
-int string_buf_index = -1;
+// Thread-local so captured execution on pool workers (see log_capture_begin())
+// can use log_id()/log_signal() and log_header() without touching the main
+// thread's bookkeeping. Only the main thread's instances are ever cleared by
+// log_push()/log_pop(); the worker-side log_id_cache is cleared when a capture
+// ends.
+thread_local vector<int> header_count;
+thread_local vector<char*> log_id_cache;
+thread_local vector<shared_str> string_buf;
+thread_local int string_buf_index = -1;
 
 static struct timeval initial_tv = { 0, 0 };
 static bool next_print_log = false;
-static int log_newline_count = 0;
+static thread_local int log_newline_count = 0;
 
 static void log_id_cache_clear()
 {
@@ -81,6 +90,97 @@ static void log_id_cache_clear()
 	log_id_cache.clear();
 }
 
+// The asynchronous log backend moves the actual fputs()/ostream writes to a
+// dedicated writer thread, so verbose passes are not stalled on log file I/O.
+// Formatting, the log hasher, scratchpad copies and the warning regexes all
+// stay on the calling thread since they feed global logger state. Each queued
+// chunk carries a snapshot of the sinks it was logged to, so the usual
+// push/pop games with log_files (e.g. around warnings) remain correct.
+struct log_writer_chunk_t {
+	std::string text;
+	std::vector<FILE*> files;
+	std::vector<std::ostream*> streams;
+};
+
+static std::thread log_writer_thread;
+static std::mutex log_writer_mutex;
+static std::condition_variable log_writer_wake, log_writer_space, log_writer_done;
+static std::deque<log_writer_chunk_t> log_writer_queue;
+static size_t log_writer_queued_bytes = 0;
+static bool log_writer_busy = false, log_writer_exit = false;
+static bool log_async_active = false;
+
+// Backpressure limit: a producer that outruns the writer by more than this
+// many buffered bytes blocks until the writer catches up.
+static const size_t log_writer_max_bytes = 1024*1024;
+
+static void log_writer_main()
+{
+	std::unique_lock<std::mutex> lock(log_writer_mutex);
+	while (1) {
+		if (log_writer_queue.empty()) {
+			if (log_writer_exit)
+				return;
+			log_writer_done.notify_all();
+			log_writer_wake.wait(lock);
+			continue;
+		}
+		log_writer_chunk_t chunk = std::move(log_writer_queue.front());
+		log_writer_queue.pop_front();
+		log_writer_queued_bytes -= chunk.text.size();
+		log_writer_busy = true;
+		log_writer_space.notify_all();
+		lock.unlock();
+		for (auto f : chunk.files)
+			fputs(chunk.text.c_str(), f);
+		for (auto f : chunk.streams)
+			*f << chunk.text;
+		lock.lock();
+		log_writer_busy = false;
+	}
+}
+
+// Hand one already formatted chunk of log output to all current log sinks,
+// either directly or via the writer thread.
+static void log_emit(const std::string &text)
+{
+	if (!log_async_active) {
+		for (auto f : log_files)
+			fputs(text.c_str(), f);
+		for (auto f : log_streams)
+			*f << text;
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(log_writer_mutex);
+	while (log_writer_queued_bytes > log_writer_max_bytes)
+		log_writer_space.wait(lock);
+	log_writer_queue.push_back({text, log_files, log_streams});
+	log_writer_queued_bytes += text.size();
+	log_writer_wake.notify_one();
+}
+
+void log_set_async(bool enable)
+{
+	if (enable == log_async_active)
+		return;
+
+	if (enable) {
+		log_writer_exit = false;
+		log_writer_thread = std::thread(log_writer_main);
+		log_async_active = true;
+	} else {
+		log_flush();
+		{
+			std::lock_guard<std::mutex> lock(log_writer_mutex);
+			log_writer_exit = true;
+		}
+		log_writer_wake.notify_one();
+		log_writer_thread.join();
+		log_async_active = false;
+	}
+}
+
 #if defined(_WIN32) && !defined(__MINGW32__)
 // this will get time information and return it in timeval, simulating gettimeofday()
 int gettimeofday(struct timeval *tv, struct timezone *tz)
@@ -101,6 +201,22 @@ int gettimeofday(struct timeval *tv, struct timezone *tz)
 }
 #endif
 
+static thread_local std::string *log_capture_buffer = nullptr;
+
+void log_capture_begin(std::string *buffer)
+{
+	log_capture_buffer = buffer;
+}
+
+void log_capture_end()
+{
+	log_capture_buffer = nullptr;
+
+	// Pool workers are long-lived and never reach log_push()/log_pop(), so
+	// drop the lifetime-extension caches here instead.
+	log_id_cache_clear();
+}
+
 void logv(const char *format, va_list ap)
 {
 	while (format[0] == '\n' && format[1] != 0) {
@@ -111,6 +227,11 @@ void logv(const char *format, va_list ap)
 	if (log_make_debug && !ys_debug(1))
 		return;
 
+	if (log_capture_buffer != nullptr) {
+		*log_capture_buffer += vstringf(format, ap);
+		return;
+	}
+
 	std::string str = vstringf(format, ap);
 
 	if (str.empty())
@@ -153,18 +274,10 @@ void logv(const char *format, va_list ap)
 		if (!strcmp(format, "%s") && str.back() == '\n')
 			next_print_log = true;
 
-		for (auto f : log_files)
-			fputs(time_str.c_str(), f);
-
-		for (auto f : log_streams)
-			*f << time_str;
+		log_emit(time_str);
 	}
 
-	for (auto f : log_files)
-		fputs(str.c_str(), f);
-
-	for (auto f : log_streams)
-		*f << str;
+	log_emit(str);
 
 	RTLIL::Design *design = yosys_get_design();
 	if (design != nullptr)
@@ -207,6 +320,15 @@ void logv_header(RTLIL::Design *design, const char *format, va_list ap)
 {
 	bool pop_errfile = false;
 
+	if (log_capture_buffer != nullptr) {
+		// Captured execution: emit the header text only. Header numbering,
+		// the -v errfile duplication and -hdump are features of the main
+		// thread's logger state.
+		log_spacer();
+		logv(format, ap);
+		return;
+	}
+
 	log_spacer();
 	if (header_count.size() > 0)
 		header_count.back()++;
@@ -252,6 +374,20 @@ static void logv_warning_with_prefix(const char *prefix,
 		if (std::regex_search(message, re))
 			suppressed = true;
 
+	if (log_capture_buffer != nullptr && !suppressed) {
+		// Captured execution: the -nowarn and -werror regexes are read-only
+		// and still honored, but the dedup set, -expect bookkeeping and the
+		// errfile push stay with the main thread. Counters are updated
+		// atomically so `stat`-style totals remain correct.
+		for (auto &re : log_werror_regexes)
+			if (std::regex_search(message, re))
+				log_error("%s",  message.c_str());
+		log("%s%s", prefix, message.c_str());
+		__atomic_add_fetch(&log_warnings_count, 1, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&log_warnings_count_noexpect, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
 	if (suppressed)
 	{
 		log("Suppressed %s%s", prefix, message.c_str());
@@ -334,6 +470,17 @@ void log_file_info(const std::string &filename, int lineno,
 static void logv_error_with_prefix(const char *prefix,
                                    const char *format, va_list ap)
 {
+	if (log_capture_buffer != nullptr) {
+		// A captured execution is about to abort: replay what it logged so
+		// far before the error message, so the context (e.g. a dump of the
+		// failing design) is not lost with the capture buffer.
+		std::string captured;
+		captured.swap(*log_capture_buffer);
+		log_capture_end();
+		if (!captured.empty())
+			log("%s", captured.c_str());
+	}
+
 #ifdef EMSCRIPTEN
 	auto backup_log_files = log_files;
 #endif
@@ -596,6 +743,11 @@ void log_reset_stack()
 
 void log_flush()
 {
+	if (log_async_active) {
+		std::unique_lock<std::mutex> lock(log_writer_mutex);
+		log_writer_done.wait(lock, []{ return log_writer_queue.empty() && !log_writer_busy; });
+	}
+
 	for (auto f : log_files)
 		fflush(f);
 
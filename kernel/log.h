@@ -189,6 +189,20 @@ void log_backtrace(const char *prefix, int levels);
 void log_reset_stack();
 void log_flush();
 
+// Redirect all plain log() output of the current thread into *buffer until
+// log_capture_end() is called. This makes log() legal on pool worker threads:
+// the text is only formatted into the thread-local buffer and the caller
+// replays it (through log()) once the worker is done, so the hasher, the
+// -W/-expect regexes and the log files all see it in a deterministic order.
+// Warnings and errors are not supported while capturing.
+void log_capture_begin(std::string *buffer);
+void log_capture_end();
+
+// Enable or disable the asynchronous log backend. When enabled, writes to the
+// log files and streams happen on a dedicated writer thread and log_flush()
+// blocks until the writer has drained its queue. See "logger -async".
+void log_set_async(bool enable);
+
 struct LogExpectedItem
 {
 	LogExpectedItem(const std::regex &pat, int expected) :
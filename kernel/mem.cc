@@ -432,13 +432,27 @@ void Mem::coalesce_inits() {
 		}
 		MemInit new_init;
 		new_init.addr = caddr;
-		new_init.data = cdata;
+		new_init.data = std::move(cdata);
 		new_init.en = Const(State::S1, width);
-		inits.push_back(new_init);
+		inits.push_back(std::move(new_init));
 	}
 }
 
 Const Mem::get_init_data() const {
+	// Fast path for the common case of one init covering the whole array
+	// (e.g. a ROM image): hand out the data without first materializing
+	// an all-x array and overwriting it word by word.
+	int valid_inits = 0;
+	const MemInit *single_init = nullptr;
+	for (auto &init : inits) {
+		if (init.removed)
+			continue;
+		valid_inits++;
+		single_init = &init;
+	}
+	if (valid_inits == 1 && single_init->addr.as_int() == start_offset &&
+			GetSize(single_init->data) == width * size && single_init->en.is_fully_ones())
+		return single_init->data;
 	Const init_data(State::Sx, width * size);
 	for (auto &init : inits) {
 		if (init.removed)
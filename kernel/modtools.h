@@ -74,7 +74,7 @@ struct ModIndex : public RTLIL::Monitor
 
 	SigMap sigmap;
 	RTLIL::Module *module;
-	std::map<RTLIL::SigBit, SigBitInfo> database;
+	dict<RTLIL::SigBit, SigBitInfo> database;
 	int auto_reload_counter;
 	bool auto_reload_module;
 
@@ -109,6 +109,16 @@ struct ModIndex : public RTLIL::Monitor
 		}
 
 		database.clear();
+
+		size_t db_size_estimate = 0;
+		for (auto wire : module->wires())
+			if (wire->port_input || wire->port_output)
+				db_size_estimate += GetSize(wire);
+		for (auto cell : module->cells())
+			for (auto &conn : cell->connections())
+				db_size_estimate += GetSize(conn.second);
+		database.reserve(db_size_estimate);
+
 		for (auto wire : module->wires())
 			if (wire->port_input || wire->port_output)
 				for (int i = 0; i < GetSize(wire); i++) {
@@ -214,9 +224,32 @@ struct ModIndex : public RTLIL::Monitor
 		}
 	}
 
-	void notify_connect(RTLIL::Module *mod, const std::vector<RTLIL::SigSig>&) override
+	void notify_connect(RTLIL::Module *mod, const std::vector<RTLIL::SigSig> &sigsig_vec) override
 	{
 		log_assert(module == mod);
+
+		if (auto_reload_module)
+			return;
+
+		// this notification is sent before the module's connection list is
+		// replaced. if the new list just appends to the old one, index the
+		// appended connections incrementally instead of scheduling a full
+		// rebuild of the database.
+		const std::vector<RTLIL::SigSig> &old_conns = mod->connections();
+		if (GetSize(sigsig_vec) >= GetSize(old_conns)) {
+			bool is_append = true;
+			for (int i = 0; i < GetSize(old_conns); i++)
+				if (!(sigsig_vec[i] == old_conns[i])) {
+					is_append = false;
+					break;
+				}
+			if (is_append) {
+				for (int i = GetSize(old_conns); i < GetSize(sigsig_vec); i++)
+					notify_connect(mod, sigsig_vec[i]);
+				return;
+			}
+		}
+
 		auto_reload_module = true;
 	}
 
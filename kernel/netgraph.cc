@@ -0,0 +1,164 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/netgraph.h"
+#include "kernel/sigtools.h"
+#include "kernel/celltypes.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+NetGraph::NetGraph(RTLIL::Module *module) : module(module), change_count(module->change_count())
+{
+	SigMap sigmap(module);
+
+	cells.reserve(GetSize(module->cells_));
+	for (auto cell : module->cells()) {
+		cell_index[cell] = GetSize(cells);
+		cells.push_back(cell);
+	}
+
+	dict<RTLIL::SigBit, int> driver;
+	pool<RTLIL::SigBit> seq_bits;
+	for (auto cell : module->cells())
+	for (auto &conn : cell->connections())
+		if (cell->output(conn.first)) {
+			bool breaks_level = yosys_celltypes.cell_known(cell->type) &&
+					(conn.first.in(ID::Q, ID::CTRL_OUT, ID::RD_DATA) ||
+					 (cell->type.in(ID($memrd), ID($memrd_v2)) && conn.first == ID::DATA));
+			for (auto bit : sigmap(conn.second))
+				if (bit.wire != nullptr) {
+					driver[bit] = cell_index.at(cell);
+					if (breaks_level)
+						seq_bits.insert(bit);
+				}
+		}
+
+	std::vector<std::pair<int, int>> edges, comb_edges;
+	for (auto cell : module->cells()) {
+		int reader = cell_index.at(cell);
+		for (auto &conn : cell->connections())
+			if (cell->input(conn.first))
+				for (auto bit : sigmap(conn.second)) {
+					auto it = driver.find(bit);
+					if (it != driver.end()) {
+						edges.push_back({it->second, reader});
+						if (!seq_bits.count(bit))
+							comb_edges.push_back({it->second, reader});
+					}
+				}
+	}
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+	std::sort(comb_edges.begin(), comb_edges.end());
+	comb_edges.erase(std::unique(comb_edges.begin(), comb_edges.end()), comb_edges.end());
+
+	int num_nodes = GetSize(cells);
+	int num_edges = GetSize(edges);
+
+	// edges are sorted by (driver, reader), so the fanout array is simply
+	// the reader column and the row pointers come from counting
+	fanout_ptr.assign(num_nodes+1, 0);
+	fanout.resize(num_edges);
+	for (int i = 0; i < num_edges; i++) {
+		fanout_ptr[edges[i].first+1]++;
+		fanout[i] = edges[i].second;
+	}
+	for (int i = 0; i < num_nodes; i++)
+		fanout_ptr[i+1] += fanout_ptr[i];
+
+	// fanin is the transpose; filling in edge order keeps each row sorted
+	fanin_ptr.assign(num_nodes+1, 0);
+	for (auto &edge : edges)
+		fanin_ptr[edge.second+1]++;
+	for (int i = 0; i < num_nodes; i++)
+		fanin_ptr[i+1] += fanin_ptr[i];
+	std::vector<int> cursor(fanin_ptr.begin(), fanin_ptr.end()-1);
+	fanin.resize(num_edges);
+	for (auto &edge : edges)
+		fanin[cursor[edge.second]++] = edge.first;
+
+	// levelization over the combinational edges (Kahn's algorithm on a
+	// temporary CSR of the comb_edges subset)
+	std::vector<int> comb_ptr(num_nodes+1, 0), comb_adj(GetSize(comb_edges));
+	std::vector<int> indegree(num_nodes, 0);
+	for (int i = 0; i < GetSize(comb_edges); i++) {
+		comb_ptr[comb_edges[i].first+1]++;
+		comb_adj[i] = comb_edges[i].second;
+		indegree[comb_edges[i].second]++;
+	}
+	for (int i = 0; i < num_nodes; i++)
+		comb_ptr[i+1] += comb_ptr[i];
+
+	level.assign(num_nodes, -1);
+	height.assign(num_nodes, -1);
+	order.reserve(num_nodes);
+
+	for (int i = 0; i < num_nodes; i++)
+		if (indegree[i] == 0) {
+			order.push_back(i);
+			level[i] = 0;
+		}
+
+	for (int pos = 0; pos < GetSize(order); pos++) {
+		int node = order[pos];
+		for (int k = comb_ptr[node]; k < comb_ptr[node+1]; k++) {
+			int next = comb_adj[k];
+			if (level[next] < level[node]+1)
+				level[next] = level[node]+1;
+			if (--indegree[next] == 0)
+				order.push_back(next);
+		}
+	}
+
+	// cells that never became ready are on (or only reachable through) a
+	// combinational loop; drop the partial levels they accumulated
+	for (int i = 0; i < num_nodes; i++)
+		if (indegree[i] > 0)
+			level[i] = -1;
+
+	max_level = 0;
+	for (int node : order)
+		max_level = max(max_level, level[node]);
+
+	for (int pos = GetSize(order)-1; pos >= 0; pos--) {
+		int node = order[pos], h = 0;
+		for (int k = comb_ptr[node]; k < comb_ptr[node+1]; k++) {
+			int next = comb_adj[k];
+			if (height[next] >= 0 && h < height[next]+1)
+				h = height[next]+1;
+		}
+		height[node] = h;
+	}
+}
+
+static std::map<RTLIL::Module*, std::unique_ptr<NetGraph>> netgraph_cache;
+
+const NetGraph &NetGraph::get(RTLIL::Module *module)
+{
+	if (netgraph_cache.count(module) == 0 && GetSize(netgraph_cache) > 1000)
+		netgraph_cache.clear();
+
+	std::unique_ptr<NetGraph> &slot = netgraph_cache[module];
+	if (!slot || slot->change_count != module->change_count() ||
+			GetSize(slot->cells) != GetSize(module->cells_))
+		slot.reset(new NetGraph(module));
+	return *slot;
+}
+
+YOSYS_NAMESPACE_END
@@ -0,0 +1,79 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef NETGRAPH_H
+#define NETGRAPH_H
+
+#include "kernel/yosys.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+// Flat CSR (compressed sparse row) snapshot of a module's cell-level
+// connectivity, for read-only graph analyses (topological orders, SCC and
+// reachability searches, levelization, timing traversals). Building
+// adjacency from the cell connections costs a dict lookup per signal bit;
+// doing that once and traversing plain int arrays afterwards lets the
+// actual analysis run cache-linear.
+//
+// Nodes are the module's cells, numbered in iteration order. There is one
+// edge per distinct (driver cell, reader cell) pair, derived from the
+// SigMap-resolved bits of the input/output port connections; a cell reading
+// its own output yields a self-edge. Constants and module ports produce no
+// edges.
+struct NetGraph
+{
+	RTLIL::Module *module;
+	uint64_t change_count;
+
+	std::vector<RTLIL::Cell*> cells;    // node id -> cell
+	dict<RTLIL::Cell*, int> cell_index; // cell -> node id
+
+	// the fanout node ids of node i are fanout[fanout_ptr[i]] up to
+	// fanout[fanout_ptr[i+1]], sorted ascending; fanin is the transpose
+	std::vector<int> fanout_ptr, fanout;
+	std::vector<int> fanin_ptr, fanin;
+
+	// Levelization of the combinational part of the graph. Edges leaving
+	// register Q outputs, FSM CTRL_OUT ports and memory read data ports do
+	// not propagate levels (the same breaks torder applies by default), so
+	// level[i] is the longest combinational fanin path of cell i, starting
+	// at 0 for cells with no combinational fanin, and height[i] is the
+	// longest combinational fanout path; max_level - level[i] - height[i]
+	// is a unit-delay slack. Cells on a combinational loop (or reachable
+	// only through one) have level and height -1, do not appear in order,
+	// and paths through them are ignored.
+	std::vector<int> order;         // topological order of the acyclic part
+	std::vector<int> level, height; // per node; -1 on combinational loops
+	int max_level;
+
+	bool has_comb_loops() const { return GetSize(order) != GetSize(cells); }
+
+	NetGraph(RTLIL::Module *module);
+
+	// On-demand cached snapshot, rebuilt when the module's change counter
+	// moved since it was taken (mutations that bypass the Module/Cell API
+	// are not detected). The returned reference stays valid until the next
+	// get() call for the same module. Not safe to call from pool workers;
+	// those should construct their own NetGraph instead.
+	static const NetGraph &get(RTLIL::Module *module);
+};
+
+YOSYS_NAMESPACE_END
+
+#endif
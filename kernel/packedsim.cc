@@ -0,0 +1,196 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/packedsim.h"
+#include "kernel/cellaigs.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+static inline uint64_t splitmix64(uint64_t &seed)
+{
+	uint64_t v = (seed += 0x9e3779b97f4a7c15);
+	v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9;
+	v = (v ^ (v >> 27)) * 0x94d049bb133111eb;
+	return v ^ (v >> 31);
+}
+
+int PackedSim::slot_of(const RTLIL::SigBit &bit)
+{
+	auto it = slot_index.find(bit);
+	if (it != slot_index.end())
+		return it->second;
+
+	int slot = GetSize(values);
+	values.push_back(0);
+	defined.push_back(false);
+	slot_bits.push_back(bit);
+	slot_index[bit] = slot;
+	return slot;
+}
+
+uint32_t PackedSim::literal_of(const RTLIL::SigBit &bit)
+{
+	if (bit.wire == nullptr)
+		return bit.data == RTLIL::State::S1 ? 1 : 0;
+	return 2*slot_of(bit);
+}
+
+PackedSim::PackedSim(RTLIL::Module *module) : module(module), sigmap(module)
+{
+	// slot 0 is the constant zero
+	values.push_back(0);
+	defined.push_back(true);
+	slot_bits.push_back(RTLIL::SigBit());
+
+	dict<RTLIL::SigBit, RTLIL::Cell*> driver;
+	for (auto cell : module->cells())
+	for (auto &conn : cell->connections())
+		if (cell->output(conn.first))
+			for (auto bit : sigmap(conn.second))
+				if (bit.wire != nullptr)
+					driver[bit] = cell;
+
+	dict<RTLIL::Cell*, std::vector<RTLIL::Cell*>> deps;
+	for (auto cell : module->cells()) {
+		auto &vec = deps[cell];
+		for (auto &conn : cell->connections())
+			if (cell->input(conn.first))
+				for (auto bit : sigmap(conn.second)) {
+					auto it = driver.find(bit);
+					if (it != driver.end() && it->second != cell)
+						vec.push_back(it->second);
+				}
+	}
+
+	// Levelize: iterative depth-first postorder over the cell dependency
+	// graph. Back edges (combinational loops) are simply not followed, so
+	// the cut bits read the value of the previous run() -- effectively one
+	// more free bit per loop.
+	dict<RTLIL::Cell*, int> state;
+	std::vector<RTLIL::Cell*> order;
+	order.reserve(GetSize(module->cells_));
+
+	for (auto root : module->cells()) {
+		if (state[root] != 0)
+			continue;
+		std::vector<std::pair<RTLIL::Cell*, size_t>> stack;
+		stack.push_back({root, 0});
+		state[root] = 1;
+		while (!stack.empty()) {
+			auto &frame = stack.back();
+			auto &vec = deps[frame.first];
+			if (frame.second < vec.size()) {
+				RTLIL::Cell *next = vec[frame.second++];
+				if (state[next] == 0) {
+					state[next] = 1;
+					stack.push_back({next, 0});
+				}
+			} else {
+				state[frame.first] = 2;
+				order.push_back(frame.first);
+				stack.pop_back();
+			}
+		}
+	}
+
+	for (auto cell : order)
+	{
+		Aig aig(cell);
+		if (aig.name.empty()) {
+			// no AIG model (flip-flops, memories, blackboxes, ...): the
+			// outputs stay free bits
+			continue;
+		}
+
+		// The node list of an Aig is in topological order, so a single
+		// forward walk assigns every node a literal over the slot array.
+		std::vector<uint32_t> node_lit(GetSize(aig.nodes));
+		for (int i = 0; i < GetSize(aig.nodes); i++)
+		{
+			const AigNode &node = aig.nodes[i];
+			uint32_t lit;
+
+			if (!node.portname.empty()) {
+				RTLIL::SigBit bit = sigmap(cell->getPort(node.portname)[node.portbit]);
+				lit = literal_of(bit) ^ (node.inverter ? 1 : 0);
+			} else if (node.left_parent < 0) {
+				lit = node.inverter ? 1 : 0;
+			} else {
+				int slot = GetSize(values);
+				values.push_back(0);
+				defined.push_back(true);
+				slot_bits.push_back(RTLIL::SigBit());
+				ops.push_back(op_t{(uint32_t)slot, node_lit[node.left_parent], node_lit[node.right_parent]});
+				lit = 2*slot + (node.inverter ? 1 : 0);
+			}
+			node_lit[i] = lit;
+
+			for (auto &outport : node.outports) {
+				RTLIL::SigBit bit = sigmap(cell->getPort(outport.first)[outport.second]);
+				if (bit.wire == nullptr)
+					continue;
+				int slot = slot_of(bit);
+				defined[slot] = true;
+				ops.push_back(op_t{(uint32_t)slot, lit, lit});
+			}
+		}
+	}
+}
+
+void PackedSim::set_value(RTLIL::SigBit bit, uint64_t word)
+{
+	bit = sigmap(bit);
+	if (bit.wire != nullptr)
+		values[slot_of(bit)] = word;
+}
+
+void PackedSim::randomize(uint64_t &seed)
+{
+	for (int slot = 0; slot < GetSize(values); slot++)
+		if (!defined[slot])
+			values[slot] = splitmix64(seed);
+}
+
+void PackedSim::run()
+{
+	values[0] = 0;
+	uint64_t *v = values.data();
+	for (auto &op : ops)
+		v[op.dst] = (v[op.a >> 1] ^ (op.a & 1 ? ~uint64_t(0) : uint64_t(0))) &
+				(v[op.b >> 1] ^ (op.b & 1 ? ~uint64_t(0) : uint64_t(0)));
+}
+
+uint64_t PackedSim::get_value(RTLIL::SigBit bit)
+{
+	bit = sigmap(bit);
+	if (bit.wire == nullptr)
+		return bit.data == RTLIL::State::S1 ? ~uint64_t(0) : uint64_t(0);
+	return values[slot_of(bit)];
+}
+
+std::vector<RTLIL::SigBit> PackedSim::free_bits() const
+{
+	std::vector<RTLIL::SigBit> result;
+	for (int slot = 0; slot < GetSize(values); slot++)
+		if (!defined[slot] && slot_bits[slot].wire != nullptr)
+			result.push_back(slot_bits[slot]);
+	return result;
+}
+
+YOSYS_NAMESPACE_END
@@ -0,0 +1,90 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef PACKEDSIM_H
+#define PACKEDSIM_H
+
+#include "kernel/yosys.h"
+#include "kernel/sigtools.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+// Packed random simulation over the combinational logic of one module, 64
+// patterns per word. The netlist is lowered through the cell AIGs from
+// kernel/cellaigs.cc into one flat, levelized array of two-input AND
+// operations with complemented-edge literals, so a full evaluation is a
+// single tight loop over that array -- intended as a cheap refutation and
+// signature oracle in front of SAT: most non-equivalences fall to a handful
+// of random words in microseconds.
+//
+// Free bits (module inputs, flip-flop outputs, outputs of cells without an
+// AIG model, and combinational loop cut points) keep whatever value was
+// assigned to them; everything else is recomputed by run(). Typical use:
+//
+//     PackedSim sim(module);
+//     sim.randomize(seed);
+//     sim.run();
+//     if (sim.get_value(a) != sim.get_value(b))
+//         ...refuted, no SAT call needed...
+struct PackedSim
+{
+	RTLIL::Module *module;
+	SigMap sigmap;
+
+	PackedSim(RTLIL::Module *module);
+
+	// Assign a pattern word to a bit (meaningful for free bits; driven bits
+	// are overwritten by the next run()).
+	void set_value(RTLIL::SigBit bit, uint64_t word);
+
+	// Assign fresh random words to all free bits. The seed is advanced, so
+	// repeated calls yield fresh stimulus and a caller-fixed start value
+	// makes the whole session reproducible.
+	void randomize(uint64_t &seed);
+
+	// Evaluate the node array in level order.
+	void run();
+
+	// 64 parallel values of the bit, valid after run(). Constant bits
+	// evaluate to their constant (x/z as 0).
+	uint64_t get_value(RTLIL::SigBit bit);
+
+	// All free design bits, for callers that drive stimulus themselves.
+	std::vector<RTLIL::SigBit> free_bits() const;
+
+private:
+	// op semantics: values[dst] = eval(a) & eval(b), where a literal 2*n+c
+	// reads slot n, complemented if c is set. Slot 0 is constant zero.
+	struct op_t {
+		uint32_t dst, a, b;
+	};
+
+	std::vector<op_t> ops;
+	std::vector<uint64_t> values;
+	std::vector<bool> defined;
+	dict<RTLIL::SigBit, int> slot_index;
+	std::vector<RTLIL::SigBit> slot_bits;
+
+	int slot_of(const RTLIL::SigBit &bit);
+	uint32_t literal_of(const RTLIL::SigBit &bit);
+};
+
+YOSYS_NAMESPACE_END
+
+#endif
@@ -25,17 +25,25 @@ std::vector<int> QuickConeSat::importSig(SigSpec sig)
 {
 	sig = modwalker.sigmap(sig);
 	for (auto bit : sig)
-		bits_queue.insert(bit);
+		queue_bit(bit);
 	return satgen.importSigSpec(sig);
 }
 
 int QuickConeSat::importSigBit(SigBit bit)
 {
 	bit = modwalker.sigmap(bit);
-	bits_queue.insert(bit);
+	queue_bit(bit);
 	return satgen.importSigBit(bit);
 }
 
+void QuickConeSat::queue_bit(SigBit bit)
+{
+	if (!seen_bits.count(bit)) {
+		seen_bits.insert(bit);
+		bits_queue.insert(bit);
+	}
+}
+
 void QuickConeSat::prepare()
 {
 	while (!bits_queue.empty())
@@ -60,12 +68,15 @@ void QuickConeSat::prepare()
 		{
 			if (imported_cells.count(pbit.cell))
 				continue;
-			if (cell_complexity(pbit.cell) > max_cell_complexity)
+			auto it = complexity_cache.find(pbit.cell->type);
+			if (it == complexity_cache.end())
+				it = complexity_cache.insert(std::make_pair(pbit.cell->type, cell_complexity(pbit.cell))).first;
+			if (it->second > max_cell_complexity)
 				continue;
 			if (max_cell_outs && GetSize(modwalker.cell_outputs[pbit.cell]) > max_cell_outs)
 				continue;
-			auto &inputs = modwalker.cell_inputs[pbit.cell];
-			bits_queue.insert(inputs.begin(), inputs.end());
+			for (auto bit : modwalker.cell_inputs[pbit.cell])
+				queue_bit(bit);
 			satgen.importCell(pbit.cell);
 			imported_cells.insert(pbit.cell);
 		}
@@ -55,6 +55,14 @@ struct QuickConeSat {
 	pool<RTLIL::Cell*> imported_cells;
 	pool<RTLIL::Wire*> imported_onehot;
 	pool<RTLIL::SigBit> bits_queue;
+	// Bits whose input cone was already walked (or rejected by the effort
+	// knobs).  Long-lived instances answer many queries over overlapping
+	// cones; such bits are not queued or walked a second time.  For this
+	// reason the effort knobs should be configured before the first
+	// prepare() call and left alone afterwards.
+	pool<RTLIL::SigBit> seen_bits;
+	// cell_complexity() only depends on the cell type.
+	dict<RTLIL::IdString, int> complexity_cache;
 
 	QuickConeSat(ModWalker &modwalker) : modwalker(modwalker), ez(), satgen(ez.get(), &modwalker.sigmap) {}
 
@@ -69,6 +77,9 @@ struct QuickConeSat {
 
 	// Returns the "complexity level" of a given cell.
 	static int cell_complexity(RTLIL::Cell *cell);
+
+private:
+	void queue_bit(RTLIL::SigBit bit);
 };
 
 YOSYS_NAMESPACE_END
@@ -19,12 +19,25 @@
 
 #include "kernel/yosys.h"
 #include "kernel/satgen.h"
+#include "libs/ezsat/ezipasir.h"
 
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
 
+#if defined(__linux__)
+#  include <malloc.h>
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#  if defined(__has_include)
+#    if __has_include(<linux/perf_event.h>)
+#      include <linux/perf_event.h>
+#      define YOSYS_HAS_PERF_EVENT
+#    endif
+#  endif
+#endif
+
 #ifdef YOSYS_ENABLE_ZLIB
 #include <zlib.h>
 
@@ -84,13 +97,35 @@ PRIVATE_NAMESPACE_END
 
 #endif
 
+PRIVATE_NAMESPACE_BEGIN
+
+/*
+An std::ofstream with a large user-space buffer. Backends write their output
+in many small pieces, and with the default filebuf size (typically 8 KiB) a
+large netlist write spends a significant share of its time crossing into the
+kernel. A 1 MiB buffer batches those writes; the buffer is a member so it
+stays alive until the base class destructor has flushed and closed the file
+(members are destroyed after base classes).
+*/
+class buffered_ofstream : public std::ofstream {
+	std::vector<char> buffer;
+public:
+	buffered_ofstream() : buffer(1024*1024)
+	{
+		// must be done before the file is opened to take effect
+		rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+	}
+};
+
+PRIVATE_NAMESPACE_END
+
 YOSYS_NAMESPACE_BEGIN
 
 #define MAX_REG_COUNT 1000
 
 bool echo_mode = false;
 Pass *first_queued_pass;
-Pass *current_pass;
+thread_local Pass *current_pass;
 
 std::map<std::string, Frontend*> frontend_register;
 std::map<std::string, Pass*> pass_register;
@@ -98,6 +133,188 @@ std::map<std::string, Backend*> backend_register;
 
 std::vector<std::string> Frontend::next_args;
 
+// Optional pass profiler. When the environment variable YOSYS_PASS_PROFILE
+// is set to a filename, every command invocation is recorded -- wall time,
+// resident set size and peak-RSS delta, net heap allocation delta, hardware
+// cache-miss/branch-miss counts where perf_event_open is available, the
+// SigSpec copy/move split of the mutation API (see RTLIL::copy_stats), and
+// the allocation call/byte counts from the global allocator hooks (see
+// alloc_stats in kernel/yosys_common.h) -- and the records are dumped to
+// that file as JSON when the pass system shuts down, so CI runs can trend
+// synthesis performance per commit. Independently, YOSYS_ALLOC_WARN_MB=<N>
+// makes every command that allocates more than <N> MiB emit a warning, so
+// allocation regressions show up in CI logs without a profile file.
+struct PassProfiler
+{
+	bool enabled = false;
+	std::string filename;
+	int depth = 0;
+	int cache_miss_fd = -1, branch_miss_fd = -1;
+
+	// per-pass allocation warning threshold (YOSYS_ALLOC_WARN_MB), 0 = off
+	int64_t alloc_warn_bytes = 0;
+
+	struct Record {
+		std::string pass;
+		int depth;
+		int64_t wall_ns;
+		int64_t rss_delta_kb, peak_rss_delta_kb, heap_delta_bytes;
+		int64_t cache_misses, branch_misses;
+		int64_t sig_copies, sig_moves;
+		int64_t alloc_calls, alloc_bytes;
+	};
+	std::vector<Record> records;
+
+	// Passes may be invoked from pool workers (see test_cell's parallel soak
+	// loop); the record list and the depth counter are shared.
+	std::mutex mutex;
+
+	PassProfiler()
+	{
+		// the allocation warning threshold works with or without a profile
+		// file, so allocation regressions can fail noisy CI runs on their own
+		const char *warn_env = getenv("YOSYS_ALLOC_WARN_MB");
+		if (warn_env != nullptr && atoll(warn_env) > 0) {
+			alloc_warn_bytes = atoll(warn_env) * 1024 * 1024;
+			alloc_stats.enabled = true;
+		}
+
+		const char *env = getenv("YOSYS_PASS_PROFILE");
+		if (env == nullptr || *env == 0)
+			return;
+		enabled = true;
+		filename = env;
+		// also switch on the SigSpec copy/move and allocation accounting in
+		// the kernel, so the records show which passes copy where they could
+		// move and which ones churn the allocator
+		RTLIL::copy_stats.enabled = true;
+		alloc_stats.enabled = true;
+	#ifdef YOSYS_HAS_PERF_EVENT
+		cache_miss_fd = open_counter(PERF_COUNT_HW_CACHE_MISSES);
+		branch_miss_fd = open_counter(PERF_COUNT_HW_BRANCH_MISSES);
+	#endif
+	}
+
+	~PassProfiler()
+	{
+	#ifdef YOSYS_HAS_PERF_EVENT
+		if (cache_miss_fd >= 0)
+			close(cache_miss_fd);
+		if (branch_miss_fd >= 0)
+			close(branch_miss_fd);
+	#endif
+	}
+
+#ifdef YOSYS_HAS_PERF_EVENT
+	static int open_counter(uint64_t config)
+	{
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = config;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+	}
+#endif
+
+	// -1 means the counter is unavailable (no permission, no hardware, or
+	// not on linux)
+	static int64_t read_counter(int fd)
+	{
+	#ifdef YOSYS_HAS_PERF_EVENT
+		uint64_t value;
+		if (fd >= 0 && read(fd, &value, sizeof(value)) == sizeof(value))
+			return value;
+	#endif
+		return -1;
+	}
+
+	static void read_rss_kb(int64_t &rss_kb, int64_t &peak_rss_kb)
+	{
+		rss_kb = peak_rss_kb = 0;
+	#if defined(__linux__)
+		std::ifstream f("/proc/self/status");
+		std::string line;
+		while (std::getline(f, line)) {
+			if (line.compare(0, 6, "VmRSS:") == 0)
+				rss_kb = atoll(line.c_str() + 6);
+			else if (line.compare(0, 6, "VmHWM:") == 0)
+				peak_rss_kb = atoll(line.c_str() + 6);
+		}
+	#endif
+	}
+
+	static int64_t read_heap_bytes()
+	{
+	#if defined(__linux__) && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+		struct mallinfo2 info = mallinfo2();
+		return info.uordblks;
+	#else
+		return 0;
+	#endif
+	}
+
+	void dump()
+	{
+		if (!enabled || records.empty())
+			return;
+
+		std::ofstream f(filename.c_str(), std::ofstream::trunc);
+		if (f.fail()) {
+			log_warning("Can't open pass profile file `%s' for writing.\n", filename.c_str());
+			return;
+		}
+
+		f << "{\n";
+		f << stringf("  \"generator\": \"yosys\",\n");
+		f << stringf("  \"version\": \"%s\",\n", yosys_version_str);
+		f << "  \"records\": [\n";
+		for (int i = 0; i < GetSize(records); i++) {
+			const Record &r = records[i];
+			f << stringf("    {\"pass\": \"%s\", \"depth\": %d, \"wall_ns\": %lld, "
+					"\"rss_delta_kb\": %lld, \"peak_rss_delta_kb\": %lld, \"heap_delta_bytes\": %lld, "
+					"\"cache_misses\": %lld, \"branch_misses\": %lld, "
+					"\"sig_copies\": %lld, \"sig_moves\": %lld, "
+					"\"alloc_calls\": %lld, \"alloc_bytes\": %lld}%s\n",
+					r.pass.c_str(), r.depth, (long long)r.wall_ns,
+					(long long)r.rss_delta_kb, (long long)r.peak_rss_delta_kb, (long long)r.heap_delta_bytes,
+					(long long)r.cache_misses, (long long)r.branch_misses,
+					(long long)r.sig_copies, (long long)r.sig_moves,
+					(long long)r.alloc_calls, (long long)r.alloc_bytes,
+					i+1 < GetSize(records) ? "," : "");
+		}
+		f << "  ]\n";
+		f << "}\n";
+
+		records.clear();
+	}
+};
+
+static PassProfiler pass_profiler;
+
+// The per-pass invocation statistics are plain ints; when Pass::call() can run
+// on pool workers the updates must not race. Mirrors the autoidx handling in
+// kernel/yosys.cc.
+static inline void pass_counter_add(int &counter, int n)
+{
+#ifdef YOSYS_THREADSAFE_IDS
+	__atomic_fetch_add(&counter, n, __ATOMIC_RELAXED);
+#else
+	counter += n;
+#endif
+}
+
+static inline void pass_counter_add(int64_t &counter, int64_t n)
+{
+#ifdef YOSYS_THREADSAFE_IDS
+	__atomic_fetch_add(&counter, n, __ATOMIC_RELAXED);
+#else
+	counter += n;
+#endif
+}
+
 Pass::Pass(std::string name, std::string short_help) : pass_name(name), short_help(short_help)
 {
 	next_queued_pass = first_queued_pass;
@@ -127,6 +344,8 @@ void Pass::init_register()
 
 void Pass::done_register()
 {
+	pass_profiler.dump();
+
 	for (auto &it : pass_register)
 		it.second->on_shutdown();
 
@@ -151,11 +370,28 @@ Pass::~Pass()
 Pass::pre_post_exec_state_t Pass::pre_execute()
 {
 	pre_post_exec_state_t state;
-	call_counter++;
+	pass_counter_add(call_counter, 1);
 	state.begin_ns = PerformanceTimer::query();
 	state.parent_pass = current_pass;
 	current_pass = this;
 	clear_flags();
+
+	if (pass_profiler.enabled) {
+		std::lock_guard<std::mutex> lock(pass_profiler.mutex);
+		pass_profiler.depth++;
+		PassProfiler::read_rss_kb(state.prof_rss_kb, state.prof_peak_rss_kb);
+		state.prof_heap_bytes = PassProfiler::read_heap_bytes();
+		state.prof_cache_misses = PassProfiler::read_counter(pass_profiler.cache_miss_fd);
+		state.prof_branch_misses = PassProfiler::read_counter(pass_profiler.branch_miss_fd);
+		state.prof_sig_copies = RTLIL::copy_stats.sig_copies;
+		state.prof_sig_moves = RTLIL::copy_stats.sig_moves;
+	}
+
+	if (alloc_stats.enabled) {
+		state.prof_alloc_calls = alloc_stats.alloc_calls;
+		state.prof_alloc_bytes = alloc_stats.alloc_bytes;
+	}
+
 	return state;
 }
 
@@ -165,10 +401,46 @@ void Pass::post_execute(Pass::pre_post_exec_state_t state)
 	log_suppressed();
 
 	int64_t time_ns = PerformanceTimer::query() - state.begin_ns;
-	runtime_ns += time_ns;
+	pass_counter_add(runtime_ns, time_ns);
 	current_pass = state.parent_pass;
 	if (current_pass)
-		current_pass->runtime_ns -= time_ns;
+		pass_counter_add(current_pass->runtime_ns, -time_ns);
+
+	// like the other profile metrics, the allocation deltas of nested
+	// invocations include their children
+	int64_t alloc_calls = 0, alloc_bytes = 0;
+	if (alloc_stats.enabled) {
+		alloc_calls = alloc_stats.alloc_calls - state.prof_alloc_calls;
+		alloc_bytes = alloc_stats.alloc_bytes - state.prof_alloc_bytes;
+		if (pass_profiler.alloc_warn_bytes != 0 && alloc_bytes > pass_profiler.alloc_warn_bytes)
+			log_warning("Pass `%s' allocated %.1f MiB in %lld calls (YOSYS_ALLOC_WARN_MB is %lld).\n",
+					pass_name.c_str(), alloc_bytes / (1024.0 * 1024.0), (long long)alloc_calls,
+					(long long)(pass_profiler.alloc_warn_bytes / (1024 * 1024)));
+	}
+
+	if (pass_profiler.enabled) {
+		PassProfiler::Record record;
+		record.pass = pass_name;
+		record.wall_ns = time_ns;
+		int64_t rss_kb, peak_rss_kb;
+		PassProfiler::read_rss_kb(rss_kb, peak_rss_kb);
+		record.rss_delta_kb = rss_kb - state.prof_rss_kb;
+		record.peak_rss_delta_kb = peak_rss_kb - state.prof_peak_rss_kb;
+		record.heap_delta_bytes = PassProfiler::read_heap_bytes() - state.prof_heap_bytes;
+		int64_t cache_misses = PassProfiler::read_counter(pass_profiler.cache_miss_fd);
+		record.cache_misses = cache_misses >= 0 && state.prof_cache_misses >= 0 ?
+				cache_misses - state.prof_cache_misses : -1;
+		int64_t branch_misses = PassProfiler::read_counter(pass_profiler.branch_miss_fd);
+		record.branch_misses = branch_misses >= 0 && state.prof_branch_misses >= 0 ?
+				branch_misses - state.prof_branch_misses : -1;
+		record.sig_copies = RTLIL::copy_stats.sig_copies - state.prof_sig_copies;
+		record.sig_moves = RTLIL::copy_stats.sig_moves - state.prof_sig_moves;
+		record.alloc_calls = alloc_calls;
+		record.alloc_bytes = alloc_bytes;
+		std::lock_guard<std::mutex> lock(pass_profiler.mutex);
+		record.depth = --pass_profiler.depth;
+		pass_profiler.records.push_back(std::move(record));
+	}
 }
 
 void Pass::help()
@@ -294,6 +566,60 @@ void Pass::call(RTLIL::Design *design, std::string command)
 	call(design, args);
 }
 
+void ModulePass::execute(std::vector<std::string> args, RTLIL::Design *design)
+{
+	prepare(args, design);
+
+	std::vector<RTLIL::Module*> modules = design->selected_modules();
+
+	bool use_pool = false;
+#ifdef YOSYS_THREADSAFE_IDS
+	use_pool = parallel_safe && GetSize(modules) > 1 && design->monitors.empty() &&
+			ThreadPool::get().num_threads() > 1;
+#endif
+
+	if (use_pool) {
+		std::vector<std::string> captured_logs(GetSize(modules));
+		ThreadPool::get().parallel_for(GetSize(modules), [&](int i) {
+			log_capture_begin(&captured_logs[i]);
+			try {
+				execute_module(modules[i]);
+			} catch (...) {
+				log_capture_end();
+				throw;
+			}
+			log_capture_end();
+		});
+		for (auto &text : captured_logs)
+			if (!text.empty())
+				log("%s", text.c_str());
+	} else {
+		for (auto module : modules)
+			execute_module(module);
+	}
+
+	finish(design);
+}
+
+// Evaluates Pass::trigger_celltypes() for Pass::call(): true iff any module
+// in the design contains a cell of one of the given types. A $mem trigger
+// also matches unpacked memories kept in module->memories.
+static bool design_has_trigger_celltypes(RTLIL::Design *design, const std::vector<RTLIL::IdString> &types)
+{
+	pool<RTLIL::IdString> type_pool;
+	for (auto &type : types)
+		type_pool.insert(type);
+
+	for (auto module : design->modules()) {
+		if (!module->memories.empty() && type_pool.count(ID($mem)))
+			return true;
+		for (auto &it : module->cells_)
+			if (type_pool.count(it.second->type))
+				return true;
+	}
+	return false;
+}
+
 void Pass::call(RTLIL::Design *design, std::vector<std::string> args)
 {
 	if (args.size() == 0 || args[0][0] == '#' || args[0][0] == ':')
@@ -312,6 +638,12 @@ void Pass::call(RTLIL::Design *design, std::vector<std::string> args)
 	if (pass_register[args[0]]->experimental_flag)
 		log_experimental("%s", args[0].c_str());
 
+	std::vector<RTLIL::IdString> triggers = pass_register[args[0]]->trigger_celltypes();
+	if (!triggers.empty() && !design_has_trigger_celltypes(design, triggers)) {
+		log("Skipping pass `%s': none of its trigger cell types are present in the design.\n", args[0].c_str());
+		return;
+	}
+
 	size_t orig_sel_stack_pos = design->selection_stack.size();
 	auto state = pass_register[args[0]]->pre_execute();
 	pass_register[args[0]]->execute(args, design);
@@ -417,6 +749,14 @@ void ScriptPass::run_nocheck(std::string command, std::string info)
 	}
 }
 
+void ScriptPass::run_concurrent(const std::vector<std::string> &commands, std::string info)
+{
+	if (active_design == nullptr && !info.empty())
+		log("        %s\n", info.c_str());
+	for (auto &command : commands)
+		run(command);
+}
+
 void ScriptPass::run_script(RTLIL::Design *design, std::string run_from, std::string run_to)
 {
 	help_mode = false;
@@ -687,7 +1027,7 @@ void Backend::extra_args(std::ostream *&f, std::string &filename, std::vector<st
 			log_cmd_error("Yosys is compiled without zlib support, unable to write gzip output.\n");
 #endif
 		} else {
-			std::ofstream *ff = new std::ofstream;
+			std::ofstream *ff = new buffered_ofstream;
 			ff->open(filename.c_str(), bin_output ? (std::ofstream::trunc | std::ofstream::binary) : std::ofstream::trunc);
 			yosys_output_files.insert(filename);
 			if (ff->fail()) {
@@ -991,6 +1331,82 @@ struct MinisatSatSolver : public SatSolver {
 	}
 } MinisatSatSolver;
 
+struct IpasirSatSolver : public SatSolver {
+	std::string library;
+	IpasirSatSolver(const std::string &name, const std::string &library) : SatSolver(name), library(library) { }
+	ezSAT *create() override {
+		ezIpasir *ez = new ezIpasir(library);
+		if (ez->failed())
+			log_error("Can't initialize IPASIR solver from `%s': %s\n", library.c_str(), ez->error().c_str());
+		return ez;
+	}
+};
+
+struct SatsolverPass : public Pass {
+	SatsolverPass() : Pass("satsolver", "set the SAT solver used by SAT-based passes") { }
+	void help() override
+	{
+		log("\n");
+		log("    satsolver [name]\n");
+		log("\n");
+		log("Without argument, list the registered SAT solver backends. With a name\n");
+		log("argument, select the backend used by all ezSAT-based passes (sat, freduce,\n");
+		log("qbfsat, opt_share, memory_share, ...).\n");
+		log("\n");
+		log("\n");
+		log("    satsolver -ipasir <filename> [name]\n");
+		log("\n");
+		log("Load a shared library implementing the IPASIR incremental SAT interface\n");
+		log("(e.g. cadical or kissat built as a shared library), register it under the\n");
+		log("given name (default: ipasir) and select it. This requires a build with\n");
+		log("plugin support.\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design*) override
+	{
+		if (GetSize(args) == 1) {
+			for (auto s = yosys_satsolver_list; s != nullptr; s = s->next)
+				log("%s%s\n", s->name.c_str(), s == yosys_satsolver ? " (active)" : "");
+			return;
+		}
+
+		if (args[1] == "-ipasir")
+		{
+			if (GetSize(args) < 3 || GetSize(args) > 4)
+				cmd_error(args, GetSize(args)-1, "Invalid number of arguments.");
+
+			std::string filename = args[2];
+			rewrite_filename(filename);
+			std::string name = GetSize(args) == 4 ? args[3] : "ipasir";
+
+			for (auto s = yosys_satsolver_list; s != nullptr; s = s->next)
+				if (s->name == name)
+					log_cmd_error("A SAT solver backend `%s' is already registered.\n", name.c_str());
+
+			ezIpasir probe(filename);
+			if (probe.failed())
+				log_cmd_error("Can't load IPASIR solver `%s': %s\n", filename.c_str(), probe.error().c_str());
+			log("Loaded IPASIR solver `%s' (%s) as backend `%s'.\n", filename.c_str(), probe.signature().c_str(), name.c_str());
+
+			// stays registered (and the library loaded) until exit, like plugins
+			yosys_satsolver = new IpasirSatSolver(name, filename);
+			return;
+		}
+
+		if (GetSize(args) != 2)
+			cmd_error(args, 2, "Unexpected argument.");
+
+		for (auto s = yosys_satsolver_list; s != nullptr; s = s->next)
+			if (s->name == args[1]) {
+				yosys_satsolver = s;
+				log("Using SAT solver backend `%s'.\n", s->name.c_str());
+				return;
+			}
+
+		log_cmd_error("No SAT solver backend `%s' registered.\n", args[1].c_str());
+	}
+} SatsolverPass;
+
 struct LicensePass : public Pass {
 	LicensePass() : Pass("license", "print license terms") { }
 	void help() override
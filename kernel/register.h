@@ -43,9 +43,25 @@ struct Pass
 		experimental_flag = true;
 	}
 
+	// Passes whose work is triggered exclusively by specific cell types can
+	// override this to declare them. Pass::call() then skips the pass with a
+	// short log note when no module in the design contains any of the trigger
+	// types, so fixed script sequences (e.g. synth flows) don't pay the full
+	// pass cost on designs where a whole stage is a guaranteed no-op. Only
+	// declare triggers whose absence makes the pass a no-op for every
+	// combination of options. As a special case a $mem trigger also matches
+	// modules with unpacked memories (non-empty module->memories).
+	virtual std::vector<RTLIL::IdString> trigger_celltypes() { return {}; }
+
 	struct pre_post_exec_state_t {
 		Pass *parent_pass;
 		int64_t begin_ns;
+		// baseline readings for the pass profiler (see YOSYS_PASS_PROFILE
+		// in register.cc); only filled in when profiling is enabled
+		int64_t prof_rss_kb = 0, prof_peak_rss_kb = 0, prof_heap_bytes = 0;
+		int64_t prof_cache_misses = 0, prof_branch_misses = 0;
+		int64_t prof_sig_copies = 0, prof_sig_moves = 0;
+		int64_t prof_alloc_calls = 0, prof_alloc_bytes = 0;
 	};
 
 	pre_post_exec_state_t pre_execute();
@@ -87,10 +103,58 @@ struct ScriptPass : Pass
 	bool check_label(std::string label, std::string info = std::string());
 	void run(std::string command, std::string info = std::string());
 	void run_nocheck(std::string command, std::string info = std::string());
+
+	// Declares that the given commands are mutually independent: they touch
+	// disjoint parts of the design and their results do not depend on the
+	// order they run in. The current runner still executes them in order --
+	// Pass::call() leans on process-global state (the selection stack, log
+	// headers, autoidx, the IdString table in default builds), so overlapping
+	// whole pass invocations is not sound yet -- but scripts can already
+	// declare the independence here instead of hard-coding an order, and
+	// gain the overlap when the runner learns to exploit it.
+	void run_concurrent(const std::vector<std::string> &commands, std::string info = std::string());
 	void run_script(RTLIL::Design *design, std::string run_from = std::string(), std::string run_to = std::string());
 	void help_script();
 };
 
+// Base class for passes whose work is independent per module. Deriving from
+// ModulePass instead of Pass declares module-local behavior: the framework
+// iterates the selected modules itself, and for passes constructed with
+// parallel_safe = true it dispatches the per-module work across the thread
+// pool with per-module log capture, replaying the captured output in module
+// order so the log stays deterministic.
+//
+// Parallel dispatch only happens in builds with thread-safe IdString
+// refcounts (ENABLE_THREADSAFE_IDS) and on designs without monitors; in all
+// other cases the modules are processed sequentially, so deriving from this
+// class never changes behavior, only enables the framework to schedule.
+//
+// The contract for parallel_safe passes is the worker rule set from
+// kernel/yosys.h relaxed to module granularity: execute_module() may freely
+// mutate its own module, but must not touch other modules or design-wide
+// state, must allocate private names via NEW_ID or module->uniquify()
+// instead of plain autoidx++, and must not call log_warning()/log_error()
+// (plain log() is fine; it is captured and replayed by the framework).
+struct ModulePass : Pass
+{
+	bool parallel_safe;
+
+	ModulePass(std::string name, std::string short_help = "** document me **", bool parallel_safe = false) :
+			Pass(name, short_help), parallel_safe(parallel_safe) { }
+
+	// called once with the command arguments: parse options, call
+	// extra_args(), do design-wide setup
+	virtual void prepare(std::vector<std::string> args, RTLIL::Design *design) = 0;
+
+	// called for every selected module, possibly concurrently (see above)
+	virtual void execute_module(RTLIL::Module *module) = 0;
+
+	// called once after all modules are done (report results, cleanup)
+	virtual void finish(RTLIL::Design *) { }
+
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override final;
+};
+
 struct Frontend : Pass
 {
 	// for reading of here documents
@@ -27,17 +27,26 @@
 
 #include <string.h>
 #include <algorithm>
+#include <utility>
 
 YOSYS_NAMESPACE_BEGIN
 
 bool RTLIL::IdString::destruct_guard_ok = false;
 RTLIL::IdString::destruct_guard_t RTLIL::IdString::destruct_guard;
+#ifdef YOSYS_THREADSAFE_IDS
+std::atomic<RTLIL::IdString::IdChunk*> RTLIL::IdString::global_id_chunks_[RTLIL::IdString::id_chunk_count_];
+int RTLIL::IdString::global_id_count_;
+std::mutex RTLIL::IdString::global_id_mutex_;
+dict<char*, int, hash_cstr_ops> RTLIL::IdString::global_id_index_;
+std::vector<int> RTLIL::IdString::global_free_idx_list_;
+#else
 std::vector<char*> RTLIL::IdString::global_id_storage_;
 dict<char*, int, hash_cstr_ops> RTLIL::IdString::global_id_index_;
 #ifndef YOSYS_NO_IDS_REFCNT
 std::vector<int> RTLIL::IdString::global_refcount_storage_;
 std::vector<int> RTLIL::IdString::global_free_idx_list_;
 #endif
+#endif
 #ifdef YOSYS_USE_STICKY_IDS
 int RTLIL::IdString::last_created_idx_[8];
 int RTLIL::IdString::last_created_idx_ptr_;
@@ -49,6 +58,8 @@ int RTLIL::IdString::last_created_idx_ptr_;
 
 dict<std::string, std::string> RTLIL::constpad;
 
+RTLIL::CopyStats RTLIL::copy_stats;
+
 const pool<IdString> &RTLIL::builtin_ff_cell_types() {
 	static const pool<IdString> res = {
 		ID($sr),
@@ -927,6 +938,9 @@ RTLIL::Module::Module()
 	design = nullptr;
 	refcount_wires_ = 0;
 	refcount_cells_ = 0;
+	change_count_ = 0;
+	wires_by_address_change_count_ = 0;
+	cells_by_address_change_count_ = 0;
 
 #ifdef WITH_PYTHON
 	RTLIL::Module::get_all_modules()->insert(std::pair<unsigned int, RTLIL::Module*>(hashidx_, this));
@@ -936,11 +950,11 @@ RTLIL::Module::Module()
 RTLIL::Module::~Module()
 {
 	for (auto &pr : wires_)
-		delete pr.second;
+		pr.second->~Wire();
 	for (auto &pr : memories)
 		delete pr.second;
 	for (auto &pr : cells_)
-		delete pr.second;
+		pr.second->~Cell();
 	for (auto &pr : processes)
 		delete pr.second;
 	for (auto binding : bindings_)
@@ -971,7 +985,7 @@ void RTLIL::Module::makeblackbox()
 	memories.clear();
 
 	for (auto it = cells_.begin(); it != cells_.end(); ++it)
-		delete it->second;
+		freeCell(it->second);
 	cells_.clear();
 
 	for (auto it = processes.begin(); it != processes.end(); ++it)
@@ -982,6 +996,7 @@ void RTLIL::Module::makeblackbox()
 
 	remove(delwires);
 	set_bool_attribute(ID::blackbox);
+	bump_change_count();
 }
 
 void RTLIL::Module::expand_interfaces(RTLIL::Design *, const dict<RTLIL::IdString, RTLIL::Module *> &)
@@ -2093,6 +2108,32 @@ RTLIL::Module *RTLIL::Module::clone() const
 	return new_mod;
 }
 
+const std::vector<RTLIL::Wire*> &RTLIL::Module::wires_by_address()
+{
+	if (wires_by_address_change_count_ != change_count_ || GetSize(wires_by_address_cache_) != GetSize(wires_)) {
+		wires_by_address_cache_.clear();
+		wires_by_address_cache_.reserve(wires_.size());
+		for (auto &it : wires_)
+			wires_by_address_cache_.push_back(it.second);
+		std::sort(wires_by_address_cache_.begin(), wires_by_address_cache_.end());
+		wires_by_address_change_count_ = change_count_;
+	}
+	return wires_by_address_cache_;
+}
+
+const std::vector<RTLIL::Cell*> &RTLIL::Module::cells_by_address()
+{
+	if (cells_by_address_change_count_ != change_count_ || GetSize(cells_by_address_cache_) != GetSize(cells_)) {
+		cells_by_address_cache_.clear();
+		cells_by_address_cache_.reserve(cells_.size());
+		for (auto &it : cells_)
+			cells_by_address_cache_.push_back(it.second);
+		std::sort(cells_by_address_cache_.begin(), cells_by_address_cache_.end());
+		cells_by_address_change_count_ = change_count_;
+	}
+	return cells_by_address_cache_;
+}
+
 bool RTLIL::Module::has_memories() const
 {
 	return !memories.empty();
@@ -2144,6 +2185,7 @@ void RTLIL::Module::add(RTLIL::Wire *wire)
 	log_assert(refcount_wires_ == 0);
 	wires_[wire->name] = wire;
 	wire->module = this;
+	bump_change_count();
 }
 
 void RTLIL::Module::add(RTLIL::Cell *cell)
@@ -2153,6 +2195,7 @@ void RTLIL::Module::add(RTLIL::Cell *cell)
 	log_assert(refcount_cells_ == 0);
 	cells_[cell->name] = cell;
 	cell->module = this;
+	bump_change_count();
 }
 
 void RTLIL::Module::add(RTLIL::Process *process)
@@ -2161,6 +2204,7 @@ void RTLIL::Module::add(RTLIL::Process *process)
 	log_assert(count_id(process->name) == 0);
 	processes[process->name] = process;
 	process->module = this;
+	bump_change_count();
 }
 
 void RTLIL::Module::add(RTLIL::Binding *binding)
@@ -2172,6 +2216,7 @@ void RTLIL::Module::add(RTLIL::Binding *binding)
 void RTLIL::Module::remove(const pool<RTLIL::Wire*> &wires)
 {
 	log_assert(refcount_wires_ == 0);
+	sigspec_intern_.clear();
 
 	struct DeleteWireWorker
 	{
@@ -2203,8 +2248,11 @@ void RTLIL::Module::remove(const pool<RTLIL::Wire*> &wires)
 	for (auto &it : wires) {
 		log_assert(wires_.count(it->name) != 0);
 		wires_.erase(it->name);
-		delete it;
+		freeWire(it);
 	}
+
+	if (!wires.empty())
+		bump_change_count();
 }
 
 void RTLIL::Module::remove(RTLIL::Cell *cell)
@@ -2215,7 +2263,8 @@ void RTLIL::Module::remove(RTLIL::Cell *cell)
 	log_assert(cells_.count(cell->name) != 0);
 	log_assert(refcount_cells_ == 0);
 	cells_.erase(cell->name);
-	delete cell;
+	freeCell(cell);
+	bump_change_count();
 }
 
 void RTLIL::Module::remove(RTLIL::Process *process)
@@ -2223,12 +2272,14 @@ void RTLIL::Module::remove(RTLIL::Process *process)
 	log_assert(processes.count(process->name) != 0);
 	processes.erase(process->name);
 	delete process;
+	bump_change_count();
 }
 
 void RTLIL::Module::rename(RTLIL::Wire *wire, RTLIL::IdString new_name)
 {
 	log_assert(wires_[wire->name] == wire);
 	log_assert(refcount_wires_ == 0);
+	sigspec_intern_.clear();
 	wires_.erase(wire->name);
 	wire->name = new_name;
 	add(wire);
@@ -2259,6 +2310,7 @@ void RTLIL::Module::swap_names(RTLIL::Wire *w1, RTLIL::Wire *w2)
 	log_assert(wires_[w1->name] == w1);
 	log_assert(wires_[w2->name] == w2);
 	log_assert(refcount_wires_ == 0);
+	sigspec_intern_.clear();
 
 	wires_.erase(w1->name);
 	wires_.erase(w2->name);
@@ -2267,6 +2319,7 @@ void RTLIL::Module::swap_names(RTLIL::Wire *w1, RTLIL::Wire *w2)
 
 	wires_[w1->name] = w1;
 	wires_[w2->name] = w2;
+	bump_change_count();
 }
 
 void RTLIL::Module::swap_names(RTLIL::Cell *c1, RTLIL::Cell *c2)
@@ -2282,6 +2335,7 @@ void RTLIL::Module::swap_names(RTLIL::Cell *c1, RTLIL::Cell *c2)
 
 	cells_[c1->name] = c1;
 	cells_[c2->name] = c2;
+	bump_change_count();
 }
 
 RTLIL::IdString RTLIL::Module::uniquify(RTLIL::IdString name)
@@ -2319,6 +2373,18 @@ static bool fixup_ports_compare(const RTLIL::Wire *a, const RTLIL::Wire *b)
 }
 
 void RTLIL::Module::connect(const RTLIL::SigSig &conn)
+{
+	copy_stats.account_copy();
+	do_connect(RTLIL::SigSig(conn));
+}
+
+void RTLIL::Module::connect(RTLIL::SigSig &&conn)
+{
+	copy_stats.account_move();
+	do_connect(std::move(conn));
+}
+
+void RTLIL::Module::do_connect(RTLIL::SigSig &&conn)
 {
 	for (auto mon : monitors)
 		mon->notify_connect(this, conn);
@@ -2336,7 +2402,7 @@ void RTLIL::Module::connect(const RTLIL::SigSig &conn)
 				new_conn.second.append(conn.second[i]);
 			}
 		if (GetSize(new_conn.first))
-			connect(new_conn);
+			do_connect(std::move(new_conn));
 		return;
 	}
 
@@ -2346,12 +2412,41 @@ void RTLIL::Module::connect(const RTLIL::SigSig &conn)
 	}
 
 	log_assert(GetSize(conn.first) == GetSize(conn.second));
-	connections_.push_back(conn);
+	connections_.push_back(std::move(conn));
+	intern(connections_.back().first);
+	intern(connections_.back().second);
+	bump_change_count();
+}
+
+// Deduplicate the storage of a SigSpec against other connection values in
+// this module. On post-flatten designs the same multi-chunk signals show up
+// in thousands of cell connections; interning makes all of them share one
+// refcounted chunk buffer.
+void RTLIL::Module::intern(RTLIL::SigSpec &sig)
+{
+	// single-chunk specs live in SigSpec's inline storage and carry no
+	// shared heap buffer, so there is nothing to deduplicate
+	sig.pack();
+	if (GetSize(sig.chunks_) < 2)
+		return;
+
+	if (GetSize(sigspec_intern_) > 1000000)
+		sigspec_intern_.clear();
+
+	auto it = sigspec_intern_.insert(sig).first;
+	sig = *it;
 }
 
 void RTLIL::Module::connect(const RTLIL::SigSpec &lhs, const RTLIL::SigSpec &rhs)
 {
-	connect(RTLIL::SigSig(lhs, rhs));
+	copy_stats.account_copy();
+	do_connect(RTLIL::SigSig(lhs, rhs));
+}
+
+void RTLIL::Module::connect(RTLIL::SigSpec &&lhs, RTLIL::SigSpec &&rhs)
+{
+	copy_stats.account_move();
+	do_connect(RTLIL::SigSig(std::move(lhs), std::move(rhs)));
 }
 
 void RTLIL::Module::new_connections(const std::vector<RTLIL::SigSig> &new_conn)
@@ -2371,6 +2466,7 @@ void RTLIL::Module::new_connections(const std::vector<RTLIL::SigSig> &new_conn)
 	}
 
 	connections_ = new_conn;
+	bump_change_count();
 }
 
 const std::vector<RTLIL::SigSig> &RTLIL::Module::connections() const
@@ -2380,26 +2476,100 @@ const std::vector<RTLIL::SigSig> &RTLIL::Module::connections() const
 
 void RTLIL::Module::fixup_ports()
 {
+	// The wire scan is unavoidable: the port flags are public members that
+	// passes write directly, so there is no hook that could maintain a
+	// reliable dirty flag. Keep the scan read-mostly instead -- skip the
+	// port_id stores that would not change anything (so clean cache lines
+	// stay clean on big modules), pre-size the scratch vector from the
+	// previous port count, and skip the sort when the order already holds.
 	std::vector<RTLIL::Wire*> all_ports;
+	all_ports.reserve(ports.size() + 16);
 
 	for (auto &w : wires_)
 		if (w.second->port_input || w.second->port_output)
 			all_ports.push_back(w.second);
-		else
+		else if (w.second->port_id != 0)
 			w.second->port_id = 0;
 
-	std::sort(all_ports.begin(), all_ports.end(), fixup_ports_compare);
+	if (!std::is_sorted(all_ports.begin(), all_ports.end(), fixup_ports_compare))
+		std::sort(all_ports.begin(), all_ports.end(), fixup_ports_compare);
 
 	ports.clear();
+	ports.reserve(all_ports.size());
 	for (size_t i = 0; i < all_ports.size(); i++) {
 		ports.push_back(all_ports[i]->name);
-		all_ports[i]->port_id = i+1;
+		if (all_ports[i]->port_id != (int)i+1)
+			all_ports[i]->port_id = i+1;
+	}
+
+	bump_change_count();
+}
+
+void RTLIL::Module::make_port(RTLIL::Wire *wire, bool port_input, bool port_output)
+{
+	bool was_port = wire->port_id != 0;
+	bool is_port = port_input || port_output;
+	wire->port_input = port_input;
+	wire->port_output = port_output;
+
+	if (was_port != is_port) {
+		if (is_port) {
+			wire->port_id = GetSize(ports) + 1;
+			ports.push_back(wire->name);
+		} else {
+			int idx = wire->port_id - 1;
+			log_assert(idx >= 0 && idx < GetSize(ports) && ports[idx] == wire->name);
+			ports.erase(ports.begin() + idx);
+			wire->port_id = 0;
+			for (int i = idx; i < GetSize(ports); i++)
+				wires_.at(ports[i])->port_id = i+1;
+		}
+	}
+
+	bump_change_count();
+}
+
+RTLIL::Wire *RTLIL::Module::allocWire()
+{
+	if (!spare_wire_slots_.empty()) {
+		void *slot = spare_wire_slots_.back();
+		spare_wire_slots_.pop_back();
+		return new (slot) RTLIL::Wire;
 	}
+	return new (object_arena_.alloc(sizeof(RTLIL::Wire))) RTLIL::Wire;
+}
+
+RTLIL::Cell *RTLIL::Module::allocCell()
+{
+	if (!spare_cell_slots_.empty()) {
+		void *slot = spare_cell_slots_.back();
+		spare_cell_slots_.pop_back();
+		return new (slot) RTLIL::Cell;
+	}
+	return new (object_arena_.alloc(sizeof(RTLIL::Cell))) RTLIL::Cell;
+}
+
+void RTLIL::Module::freeWire(RTLIL::Wire *wire)
+{
+	wire->~Wire();
+	spare_wire_slots_.push_back(wire);
+}
+
+void RTLIL::Module::freeCell(RTLIL::Cell *cell)
+{
+	cell->~Cell();
+	spare_cell_slots_.push_back(cell);
+}
+
+void RTLIL::Module::reserve(int extra_wires, int extra_cells)
+{
+	wires_.reserve(wires_.size() + extra_wires);
+	cells_.reserve(cells_.size() + extra_cells);
 }
 
 RTLIL::Wire *RTLIL::Module::addWire(RTLIL::IdString name, int width)
 {
-	RTLIL::Wire *wire = new RTLIL::Wire;
+	RTLIL::Wire *wire = allocWire();
 	wire->name = name;
 	wire->width = width;
 	add(wire);
@@ -2422,7 +2592,7 @@ RTLIL::Wire *RTLIL::Module::addWire(RTLIL::IdString name, const RTLIL::Wire *oth
 
 RTLIL::Cell *RTLIL::Module::addCell(RTLIL::IdString name, RTLIL::IdString type)
 {
-	RTLIL::Cell *cell = new RTLIL::Cell;
+	RTLIL::Cell *cell = allocCell();
 	cell->name = name;
 	cell->type = type;
 	add(cell);
@@ -2447,6 +2617,7 @@ RTLIL::Memory *RTLIL::Module::addMemory(RTLIL::IdString name, const RTLIL::Memor
 	mem->size = other->size;
 	mem->attributes = other->attributes;
 	memories[mem->name] = mem;
+	bump_change_count();
 	return mem;
 }
 
@@ -3537,10 +3708,23 @@ void RTLIL::Cell::unsetPort(const RTLIL::IdString& portname)
 		}
 
 		connections_.erase(conn_it);
+		module->bump_change_count();
 	}
 }
 
-void RTLIL::Cell::setPort(const RTLIL::IdString& portname, RTLIL::SigSpec signal)
+void RTLIL::Cell::setPort(const RTLIL::IdString& portname, const RTLIL::SigSpec &signal)
+{
+	copy_stats.account_copy();
+	do_setPort(portname, RTLIL::SigSpec(signal));
+}
+
+void RTLIL::Cell::setPort(const RTLIL::IdString& portname, RTLIL::SigSpec &&signal)
+{
+	copy_stats.account_move();
+	do_setPort(portname, std::move(signal));
+}
+
+void RTLIL::Cell::do_setPort(const RTLIL::IdString& portname, RTLIL::SigSpec &&signal)
 {
 	auto r = connections_.insert(portname);
 	auto conn_it = r.first;
@@ -3559,7 +3743,9 @@ void RTLIL::Cell::setPort(const RTLIL::IdString& portname, RTLIL::SigSpec signal
 		log_backtrace("-X- ", yosys_xtrace-1);
 	}
 
+	module->intern(signal);
 	conn_it->second = std::move(signal);
+	module->bump_change_count();
 }
 
 const RTLIL::SigSpec &RTLIL::Cell::getPort(const RTLIL::IdString& portname) const
@@ -3613,11 +3799,15 @@ bool RTLIL::Cell::hasParam(const RTLIL::IdString& paramname) const
 void RTLIL::Cell::unsetParam(const RTLIL::IdString& paramname)
 {
 	parameters.erase(paramname);
+	if (module)
+		module->bump_change_count();
 }
 
 void RTLIL::Cell::setParam(const RTLIL::IdString& paramname, RTLIL::Const value)
 {
 	parameters[paramname] = std::move(value);
+	if (module)
+		module->bump_change_count();
 }
 
 const RTLIL::Const &RTLIL::Cell::getParam(const RTLIL::IdString& paramname) const
@@ -3959,6 +4149,17 @@ RTLIL::SigSpec::SigSpec(const std::vector<RTLIL::SigChunk> &chunks)
 	check();
 }
 
+RTLIL::SigSpec::SigSpec(const RTLIL::SigChunkVec &chunks)
+{
+	cover("kernel.rtlil.sigspec.init.chunkvec");
+
+	width_ = 0;
+	hash_ = 0;
+	for (const auto &c : chunks)
+		append(c);
+	check();
+}
+
 RTLIL::SigSpec::SigSpec(const std::vector<RTLIL::SigBit> &bits)
 {
 	cover("kernel.rtlil.sigspec.init.stdvec_bits");
@@ -4049,7 +4250,7 @@ void RTLIL::SigSpec::unpack() const
 	log_assert(that->bits_.empty());
 
 	that->bits_.reserve(that->width_);
-	for (auto &c : that->chunks_)
+	for (const auto &c : std::as_const(that->chunks_))
 		for (int i = 0; i < c.width; i++)
 			that->bits_.emplace_back(c, i);
 
@@ -4068,7 +4269,7 @@ void RTLIL::SigSpec::updhash() const
 	that->pack();
 
 	that->hash_ = mkhash_init;
-	for (auto &c : that->chunks_)
+	for (const auto &c : std::as_const(that->chunks_))
 		if (c.wire == NULL) {
 			for (auto &v : c.data)
 				that->hash_ = mkhash(that->hash_, v);
@@ -4413,7 +4614,7 @@ void RTLIL::SigSpec::remove_const()
 	{
 		cover("kernel.rtlil.sigspec.remove_const.packed");
 
-		std::vector<RTLIL::SigChunk> new_chunks;
+		RTLIL::SigChunkVec new_chunks;
 		new_chunks.reserve(GetSize(chunks_));
 
 		width_ = 0;
@@ -4507,6 +4708,8 @@ void RTLIL::SigSpec::append(const RTLIL::SigSpec &signal)
 	if (signal.width_ == 0)
 		return;
 
+	copy_stats.account_copy();
+
 	if (width_ == 0) {
 		*this = signal;
 		return;
@@ -4541,6 +4744,52 @@ void RTLIL::SigSpec::append(const RTLIL::SigSpec &signal)
 	check();
 }
 
+void RTLIL::SigSpec::append(RTLIL::SigSpec &&signal)
+{
+	if (signal.width_ == 0)
+		return;
+
+	copy_stats.account_move();
+
+	if (width_ == 0) {
+		*this = std::move(signal);
+		return;
+	}
+
+	cover("kernel.rtlil.sigspec.append_move");
+
+	if (packed() != signal.packed()) {
+		pack();
+		signal.pack();
+	}
+
+	// same chunk merging as the copying overload above, except that chunks
+	// that survive as-is are moved in, stealing their constant data vectors
+	// (SigChunkVec detaches first, so a shared buffer is never mutated)
+	if (packed())
+		for (auto &other_c : signal.chunks_)
+		{
+			auto &my_last_c = chunks_.back();
+			if (my_last_c.wire == NULL && other_c.wire == NULL) {
+				auto &this_data = my_last_c.data;
+				auto &other_data = other_c.data;
+				this_data.insert(this_data.end(), other_data.begin(), other_data.end());
+				my_last_c.width += other_c.width;
+			} else
+			if (my_last_c.wire == other_c.wire && my_last_c.offset + my_last_c.width == other_c.offset) {
+				my_last_c.width += other_c.width;
+			} else
+				chunks_.push_back(std::move(other_c));
+		}
+	else
+		bits_.insert(bits_.end(), std::make_move_iterator(signal.bits_.begin()),
+				std::make_move_iterator(signal.bits_.end()));
+
+	width_ += signal.width_;
+	signal = RTLIL::SigSpec();
+	check();
+}
+
 void RTLIL::SigSpec::append(const RTLIL::SigBit &bit)
 {
 	if (packed())
@@ -4703,6 +4952,11 @@ bool RTLIL::SigSpec::operator ==(const RTLIL::SigSpec &other) const
 	pack();
 	other.pack();
 
+	// copy-on-write copies share their chunk storage, so equal buffers of
+	// equal width always describe the same signal
+	if (static_cast<const SigChunkVec&>(chunks_).begin() == static_cast<const SigChunkVec&>(other.chunks_).begin())
+		return true;
+
 	if (chunks_.size() != other.chunks_.size())
 		return false;
 
@@ -5230,6 +5484,21 @@ RTLIL::Process::~Process()
 		delete *it;
 }
 
+// Deduplicate the signal storage of this process against the module-level
+// intern pool (see Module::intern()). Unrolled generate-for loops emit
+// thousands of structurally identical case/switch trees before proc runs;
+// letting them share one refcounted chunk buffer per distinct multi-chunk
+// signal cuts the front-end memory peak on generate-heavy designs. The
+// shared buffers are copy-on-write, so in-place mutation by the proc
+// passes stays safe.
+void RTLIL::Process::intern()
+{
+	if (module == nullptr)
+		return;
+	auto functor = [this](RTLIL::SigSpec &sig) { module->intern(sig); };
+	rewrite_sigspecs(functor);
+}
+
 RTLIL::Process *RTLIL::Process::clone() const
 {
 	RTLIL::Process *new_proc = new RTLIL::Process;
@@ -23,6 +23,11 @@
 #include "kernel/yosys_common.h"
 #include "kernel/yosys.h"
 
+#ifdef YOSYS_THREADSAFE_IDS
+#include <atomic>
+#include <mutex>
+#endif
+
 YOSYS_NAMESPACE_BEGIN
 
 namespace RTLIL
@@ -54,16 +59,19 @@ namespace RTLIL
 		CONST_FLAG_REAL   = 4   // only used for parameters
 	};
 
+	struct ConstBits;
 	struct Const;
 	struct AttrObject;
 	struct Selection;
 	struct Monitor;
+	struct ObjectArena;
 	struct Design;
 	struct Module;
 	struct Wire;
 	struct Memory;
 	struct Cell;
 	struct SigChunk;
+	struct SigChunkVec;
 	struct SigBit;
 	struct SigSpecIterator;
 	struct SigSpecConstIterator;
@@ -77,6 +85,36 @@ namespace RTLIL
 
 	typedef std::pair<SigSpec, SigSpec> SigSig;
 
+	// Copy/move accounting for the SigSpec-heavy mutation API
+	// (Module::connect(), Cell::setPort(), SigSpec::append()). Each of these
+	// now comes in a copying (const-ref) and a moving (rvalue-ref) overload;
+	// the counters record which one was taken, so the per-pass deltas
+	// reported by the pass profiler (see YOSYS_PASS_PROFILE in
+	// kernel/register.cc) show which passes still push their temporaries
+	// through the copying path. Counting is only active while the profiler
+	// is enabled, so the hot mutators pay a single predicted branch
+	// otherwise.
+	struct CopyStats
+	{
+		bool enabled = false;
+		int64_t sig_copies = 0;
+		int64_t sig_moves = 0;
+
+		void account(int64_t &counter) {
+			if (!enabled)
+				return;
+		#ifdef YOSYS_THREADSAFE_IDS
+			__atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED);
+		#else
+			counter++;
+		#endif
+		}
+		void account_copy() { account(sig_copies); }
+		void account_move() { account(sig_moves); }
+	};
+
+	extern CopyStats copy_stats;
+
 	struct IdString
 	{
 		#undef YOSYS_XTRACE_GET_PUT
@@ -92,6 +130,34 @@ namespace RTLIL
 			~destruct_guard_t() { destruct_guard_ok = false; }
 		} destruct_guard;
 
+	#ifdef YOSYS_THREADSAFE_IDS
+		// With YOSYS_THREADSAFE_IDS (see ENABLE_THREADSAFE_IDS in the
+		// Makefile) ids live in chunked storage published through atomic
+		// pointers and carry atomic refcounts. Copying, destroying and
+		// reading IdStrings is lock-free on any thread; only interning new
+		// strings and freeing dead ids take the global mutex.
+		static constexpr int id_chunk_bits_ = 12;
+		static constexpr int id_chunk_count_ = 1 << (30 - id_chunk_bits_);
+		struct IdChunk {
+			char *names_[1 << id_chunk_bits_] = { };
+			std::atomic<int> refcounts_[1 << id_chunk_bits_] = { };
+		};
+		static std::atomic<IdChunk*> global_id_chunks_[id_chunk_count_];
+		static int global_id_count_;
+		static std::mutex global_id_mutex_;
+		static dict<char*, int, hash_cstr_ops> global_id_index_;
+		static std::vector<int> global_free_idx_list_;
+
+		static inline IdChunk &id_chunk(int idx) {
+			return *global_id_chunks_[idx >> id_chunk_bits_].load(std::memory_order_acquire);
+		}
+		static inline char *id_name(int idx) {
+			return id_chunk(idx).names_[idx & ((1 << id_chunk_bits_) - 1)];
+		}
+		static inline std::atomic<int> &id_refcount(int idx) {
+			return id_chunk(idx).refcounts_[idx & ((1 << id_chunk_bits_) - 1)];
+		}
+	#else
 		static std::vector<char*> global_id_storage_;
 		static dict<char*, int, hash_cstr_ops> global_id_index_;
 	#ifndef YOSYS_NO_IDS_REFCNT
@@ -99,6 +165,11 @@ namespace RTLIL
 		static std::vector<int> global_free_idx_list_;
 	#endif
 
+		static inline char *id_name(int idx) {
+			return global_id_storage_.at(idx);
+		}
+	#endif
+
 	#ifdef YOSYS_USE_STICKY_IDS
 		static int last_created_idx_ptr_;
 		static int last_created_idx_[8];
@@ -132,6 +203,101 @@ namespace RTLIL
 		#endif
 		}
 
+	#ifdef YOSYS_THREADSAFE_IDS
+		static inline int get_reference(int idx)
+		{
+			if (idx)
+				id_refcount(idx).fetch_add(1, std::memory_order_relaxed);
+			return idx;
+		}
+
+		static int get_reference(const char *p)
+		{
+			log_assert(destruct_guard_ok);
+
+			if (!p[0])
+				return 0;
+
+			std::lock_guard<std::mutex> guard(global_id_mutex_);
+
+			auto it = global_id_index_.find((char*)p);
+			if (it != global_id_index_.end()) {
+				id_refcount(it->second).fetch_add(1, std::memory_order_relaxed);
+				return it->second;
+			}
+
+			log_assert(p[0] == '$' || p[0] == '\\');
+			log_assert(p[1] != 0);
+			for (const char *c = p; *c; c++)
+				if ((unsigned)*c <= (unsigned)' ')
+					log_error("Found control character or space (0x%02x) in string '%s' which is not allowed in RTLIL identifiers\n", *c, p);
+
+			if (global_id_count_ == 0) {
+				global_id_chunks_[0].store(new IdChunk, std::memory_order_release);
+				id_chunk(0).names_[0] = (char*)"";
+				global_id_index_[id_name(0)] = 0;
+				global_id_count_ = 1;
+			}
+
+			int idx;
+			if (global_free_idx_list_.empty()) {
+				log_assert(global_id_count_ < 0x40000000);
+				idx = global_id_count_++;
+				if ((idx & ((1 << id_chunk_bits_) - 1)) == 0)
+					global_id_chunks_[idx >> id_chunk_bits_].store(new IdChunk, std::memory_order_release);
+			} else {
+				idx = global_free_idx_list_.back();
+				global_free_idx_list_.pop_back();
+			}
+
+			IdChunk &chunk = id_chunk(idx);
+			chunk.names_[idx & ((1 << id_chunk_bits_) - 1)] = strdup(p);
+			chunk.refcounts_[idx & ((1 << id_chunk_bits_) - 1)].store(1, std::memory_order_relaxed);
+			global_id_index_[id_name(idx)] = idx;
+
+			if (yosys_xtrace) {
+				log("#X# New IdString '%s' with index %d.\n", p, idx);
+				log_backtrace("-X- ", yosys_xtrace-1);
+			}
+
+			return idx;
+		}
+
+		// pre-size the global id tables for an expected number of ids, so
+		// bulk interning (e.g. the built-in ids at startup) does not grow
+		// and rehash the lookup structures repeatedly
+		static inline void reserve_storage(int expected)
+		{
+			std::lock_guard<std::mutex> lock(global_id_mutex_);
+			global_id_index_.reserve(expected);
+		}
+
+		static inline void put_reference(int idx)
+		{
+			// put_reference() may be called from destructors after the
+			// global storage destructors have been run. in this case we
+			// simply do nothing.
+			if (!destruct_guard_ok || !idx)
+				return;
+
+			if (id_refcount(idx).fetch_sub(1, std::memory_order_acq_rel) != 1)
+				return;
+
+			std::lock_guard<std::mutex> guard(global_id_mutex_);
+
+			// the id may have been resurrected by a concurrent intern of the
+			// same string, or already freed by a racing put_reference()
+			int off = idx & ((1 << id_chunk_bits_) - 1);
+			IdChunk &chunk = id_chunk(idx);
+			if (chunk.refcounts_[off].load(std::memory_order_relaxed) != 0 || chunk.names_[off] == nullptr)
+				return;
+
+			global_id_index_.erase(chunk.names_[off]);
+			free(chunk.names_[off]);
+			chunk.names_[off] = nullptr;
+			global_free_idx_list_.push_back(idx);
+		}
+	#else
 		static inline int get_reference(int idx)
 		{
 			if (idx) {
@@ -221,6 +387,18 @@ namespace RTLIL
 			return idx;
 		}
 
+		// pre-size the global id tables for an expected number of ids, so
+		// bulk interning (e.g. the built-in ids at startup) does not grow
+		// and rehash the lookup structures repeatedly
+		static inline void reserve_storage(int expected)
+		{
+			global_id_storage_.reserve(expected);
+		#ifndef YOSYS_NO_IDS_REFCNT
+			global_refcount_storage_.reserve(expected);
+		#endif
+			global_id_index_.reserve(expected);
+		}
+
 	#ifndef YOSYS_NO_IDS_REFCNT
 		static inline void put_reference(int idx)
 		{
@@ -258,6 +436,7 @@ namespace RTLIL
 	#else
 		static inline void put_reference(int) { }
 	#endif
+	#endif // !YOSYS_THREADSAFE_IDS
 
 		// the actual IdString object is just is a single int
 
@@ -286,11 +465,11 @@ namespace RTLIL
 		}
 
 		inline const char *c_str() const {
-			return global_id_storage_.at(index_);
+			return id_name(index_);
 		}
 
 		inline std::string str() const {
-			return std::string(global_id_storage_.at(index_));
+			return std::string(id_name(index_));
 		}
 
 		inline bool operator<(const IdString &rhs) const {
@@ -653,12 +832,138 @@ namespace RTLIL
 		pool<T> to_pool() const { return *this; }
 		std::vector<T> to_vector() const { return *this; }
 	};
+
+	template<typename T>
+	struct SelectedObjIterator : public RTLIL::ObjIterator<T>
+	{
+		const RTLIL::Module *module;
+
+		SelectedObjIterator() : module(nullptr) { }
+
+		SelectedObjIterator(const RTLIL::Module *module, dict<RTLIL::IdString, T> *list_p, int *refcount_p) :
+				RTLIL::ObjIterator<T>(list_p, refcount_p), module(module) {
+			skip_unselected();
+		}
+
+		// defined below, after RTLIL::Module is complete
+		void skip_unselected();
+
+		inline SelectedObjIterator<T>& operator++() {
+			RTLIL::ObjIterator<T>::operator++();
+			skip_unselected();
+			return *this;
+		}
+	};
+
+	// Like the selected_wires()/selected_cells() vectors, but iterating the
+	// module in-place. Do not add or remove objects while iterating.
+	template<typename T>
+	struct SelectedObjRange
+	{
+		const RTLIL::Module *module;
+		dict<RTLIL::IdString, T> *list_p;
+		int *refcount_p;
+
+		SelectedObjRange(const RTLIL::Module *module, decltype(list_p) list_p, int *refcount_p) :
+				module(module), list_p(list_p), refcount_p(refcount_p) { }
+		RTLIL::SelectedObjIterator<T> begin() { return RTLIL::SelectedObjIterator<T>(module, list_p, refcount_p); }
+		RTLIL::SelectedObjIterator<T> end() { return RTLIL::SelectedObjIterator<T>(); }
+	};
+};
+
+// Copy-on-write storage for the bits of an RTLIL::Const. Copying a Const only
+// bumps a reference count, so parameter and attribute dicts (and with them
+// cell clones and module derivations) no longer deep-copy identical WIDTH and
+// INIT values over and over. The buffer is cloned on the first mutating
+// access while it is shared; every non-const accessor counts as mutating,
+// including the conversion to std::vector<State>&, so existing code that
+// takes a reference into the bits keeps its exclusive-buffer semantics. The
+// interface is the subset of std::vector<State> that the code base uses on
+// Const::bits.
+struct RTLIL::ConstBits
+{
+	typedef std::vector<RTLIL::State> bitvec;
+	typedef bitvec::iterator iterator;
+	typedef bitvec::const_iterator const_iterator;
+	typedef RTLIL::State value_type;
+
+	std::shared_ptr<bitvec> store_;
+
+	ConstBits() {}
+	ConstBits(const bitvec &bits) { if (!bits.empty()) store_ = std::make_shared<bitvec>(bits); }
+	ConstBits(bitvec &&bits) { if (!bits.empty()) store_ = std::make_shared<bitvec>(std::move(bits)); }
+
+	ConstBits &operator=(const bitvec &bits) { store_ = bits.empty() ? nullptr : std::make_shared<bitvec>(bits); return *this; }
+	ConstBits &operator=(bitvec &&bits) { store_ = bits.empty() ? nullptr : std::make_shared<bitvec>(std::move(bits)); return *this; }
+
+	const bitvec &rd() const {
+		static const bitvec empty_vec;
+		return store_ ? *store_ : empty_vec;
+	}
+
+	bitvec &wr() {
+		if (!store_)
+			store_ = std::make_shared<bitvec>();
+		else if (store_.use_count() > 1)
+			store_ = std::make_shared<bitvec>(*store_);
+		return *store_;
+	}
+
+	// move the bits out, leaving this empty
+	bitvec release() {
+		if (!store_)
+			return bitvec();
+		bitvec result = store_.use_count() > 1 ? *store_ : std::move(*store_);
+		store_ = nullptr;
+		return result;
+	}
+
+	operator const bitvec &() const { return rd(); }
+	operator bitvec &() { return wr(); }
+
+	size_t size() const { return rd().size(); }
+	bool empty() const { return rd().empty(); }
+	size_t capacity() const { return rd().capacity(); }
+
+	const_iterator begin() const { return rd().begin(); }
+	const_iterator end() const { return rd().end(); }
+	iterator begin() { return wr().begin(); }
+	iterator end() { return wr().end(); }
+
+	const RTLIL::State &at(size_t idx) const { return rd().at(idx); }
+	RTLIL::State &at(size_t idx) { return wr().at(idx); }
+	const RTLIL::State &operator[](size_t idx) const { return rd()[idx]; }
+	RTLIL::State &operator[](size_t idx) { return wr()[idx]; }
+	const RTLIL::State &front() const { return rd().front(); }
+	RTLIL::State &front() { return wr().front(); }
+	const RTLIL::State &back() const { return rd().back(); }
+	RTLIL::State &back() { return wr().back(); }
+
+	void reserve(size_t n) { if (n) wr().reserve(n); }
+	void clear() { store_ = nullptr; }
+	void resize(size_t n) { if (n == 0) store_ = nullptr; else wr().resize(n); }
+	void resize(size_t n, RTLIL::State bit) { if (n == 0) store_ = nullptr; else wr().resize(n, bit); }
+	void push_back(RTLIL::State bit) { wr().push_back(bit); }
+	void emplace_back(RTLIL::State bit) { wr().push_back(bit); }
+	void pop_back() { wr().pop_back(); }
+
+	// Iterator arguments always come from a non-const accessor on the same
+	// object, which has already detached the buffer, so wr() here never
+	// invalidates them.
+	template<typename... Args>
+	iterator insert(const_iterator pos, Args&&... args) { return wr().insert(pos, std::forward<Args>(args)...); }
+	iterator erase(const_iterator pos) { return wr().erase(pos); }
+	iterator erase(const_iterator first, const_iterator last) { return wr().erase(first, last); }
+
+	bool operator ==(const ConstBits &other) const { return store_ == other.store_ || rd() == other.rd(); }
+	bool operator !=(const ConstBits &other) const { return !(*this == other); }
+	bool operator <(const ConstBits &other) const { return store_ != other.store_ && rd() < other.rd(); }
 };
 
 struct RTLIL::Const
 {
 	int flags;
-	std::vector<RTLIL::State> bits;
+	RTLIL::ConstBits bits;
 
 	Const() : flags(RTLIL::CONST_FLAG_NONE) {}
 	Const(const std::string &str);
@@ -668,6 +973,11 @@ struct RTLIL::Const
 	Const(const std::vector<bool> &bits);
 	Const(const RTLIL::Const &c) = default;
 	RTLIL::Const &operator =(const RTLIL::Const &other) = default;
+	// Moving matters for large constants (e.g. memory init data): the
+	// user-declared copy operations above would otherwise suppress the
+	// implicit move operations and silently deep-copy the bits vector.
+	Const(RTLIL::Const &&c) = default;
+	RTLIL::Const &operator =(RTLIL::Const &&other) = default;
 
 	bool operator <(const RTLIL::Const &other) const;
 	bool operator ==(const RTLIL::Const &other) const;
@@ -760,7 +1070,7 @@ struct RTLIL::SigChunk
 
 	SigChunk() : wire(nullptr), width(0), offset(0) {}
 	SigChunk(const RTLIL::Const &value) : wire(nullptr), data(value.bits), width(GetSize(data)), offset(0) {}
-	SigChunk(RTLIL::Const &&value) : wire(nullptr), data(std::move(value.bits)), width(GetSize(data)), offset(0) {}
+	SigChunk(RTLIL::Const &&value) : wire(nullptr), data(value.bits.release()), width(GetSize(data)), offset(0) {}
 	SigChunk(RTLIL::Wire *wire) : wire(wire), width(GetSize(wire)), offset(0) {}
 	SigChunk(RTLIL::Wire *wire, int offset, int width = 1) : wire(wire), width(width), offset(offset) {}
 	SigChunk(const std::string &str) : SigChunk(RTLIL::Const(str)) {}
@@ -778,6 +1088,273 @@ struct RTLIL::SigChunk
 	bool operator !=(const RTLIL::SigChunk &other) const;
 };
 
+// Small-buffer vector holding the chunks of a SigSpec. The vast majority of
+// SigSpecs consist of a single chunk (a whole wire, a wire slice or a
+// constant), so the first chunk is stored in-place and heap storage is only
+// allocated for multi-chunk specs. The interface is the subset of
+// std::vector<SigChunk> that the kernel and the passes actually use.
+struct RTLIL::SigChunkVec
+{
+	typedef RTLIL::SigChunk value_type;
+	typedef RTLIL::SigChunk *iterator;
+	typedef const RTLIL::SigChunk *const_iterator;
+
+private:
+	// heap storage is refcounted and copy-on-write: copying a multi-chunk
+	// SigSpec only bumps a refcount, and any mutating access detaches first.
+	// Buffers can be shared across modules (addCell from another module,
+	// clone, flatten), so in thread-safe builds the refcount updates use
+	// atomic builtins -- gated parallel consumers copy and drop references
+	// to the same buffer concurrently even when they never mutate the spec.
+	struct alignas(RTLIL::SigChunk) Buffer {
+		int refcount;
+
+		void addref() {
+		#ifdef YOSYS_THREADSAFE_IDS
+			__atomic_fetch_add(&refcount, 1, __ATOMIC_RELAXED);
+		#else
+			refcount++;
+		#endif
+		}
+
+		// drop one reference, returning true iff it was the last one
+		bool subref() {
+		#ifdef YOSYS_THREADSAFE_IDS
+			return __atomic_sub_fetch(&refcount, 1, __ATOMIC_ACQ_REL) == 0;
+		#else
+			return --refcount == 0;
+		#endif
+		}
+
+		bool shared() const {
+		#ifdef YOSYS_THREADSAFE_IDS
+			return __atomic_load_n(&refcount, __ATOMIC_RELAXED) > 1;
+		#else
+			return refcount > 1;
+		#endif
+		}
+
+		RTLIL::SigChunk *chunks() { return reinterpret_cast<RTLIL::SigChunk*>(this+1); }
+	};
+
+	// always constructed (and empty whenever it is not the active single
+	// chunk), so every path the compiler sees starts from an initialized
+	// object; a union member left unconstructed for empty specs trips
+	// -Wmaybe-uninitialized at -O3 when the destructor inlines into users
+	RTLIL::SigChunk inline_chunk_;
+	RTLIL::SigChunk *data_;
+	int size_, capacity_;
+
+	bool is_inline() const { return data_ == &inline_chunk_; }
+	Buffer *buffer() const { return reinterpret_cast<Buffer*>(data_) - 1; }
+	bool is_shared() const { return !is_inline() && buffer()->shared(); }
+
+	static Buffer *alloc_buffer(int capacity) {
+		static_assert(sizeof(Buffer) % alignof(RTLIL::SigChunk) == 0, "buffer header breaks chunk alignment");
+		Buffer *buf = static_cast<Buffer*>(::operator new(sizeof(Buffer) + capacity*sizeof(RTLIL::SigChunk)));
+		buf->refcount = 1;
+		return buf;
+	}
+
+	// drop our reference and reset to the empty inline state
+	void release() {
+		if (is_inline()) {
+			if (size_)
+				inline_chunk_ = RTLIL::SigChunk();
+		} else {
+			Buffer *buf = buffer();
+			if (buf->subref()) {
+				for (int i = 0; i < size_; i++)
+					data_[i].~SigChunk();
+				::operator delete(buf);
+			}
+			data_ = &inline_chunk_;
+		}
+		size_ = 0;
+		capacity_ = 1;
+	}
+
+	// move to a fresh unshared buffer of the given capacity
+	void reallocate(int new_capacity) {
+		Buffer *new_buf = alloc_buffer(new_capacity);
+		RTLIL::SigChunk *new_data = new_buf->chunks();
+		bool unique = !is_shared();
+		for (int i = 0; i < size_; i++) {
+			if (unique)
+				new (new_data+i) RTLIL::SigChunk(std::move(data_[i]));
+			else
+				new (new_data+i) RTLIL::SigChunk(data_[i]);
+		}
+		int old_size = size_;
+		release();
+		data_ = new_data;
+		size_ = old_size;
+		capacity_ = new_capacity;
+	}
+
+	void detach() {
+		if (is_shared())
+			reallocate(capacity_);
+	}
+
+	// make the buffer unshared with room for at least min_capacity chunks
+	void make_room(int min_capacity) {
+		if (capacity_ < min_capacity || is_shared())
+			reallocate(max(min_capacity, 2*capacity_));
+	}
+
+	void init_from(const SigChunkVec &other) {
+		if (other.is_inline()) {
+			if (other.size_) {
+				inline_chunk_ = other.data_[0];
+				size_ = 1;
+			}
+		} else {
+			data_ = other.data_;
+			size_ = other.size_;
+			capacity_ = other.capacity_;
+			buffer()->addref();
+		}
+	}
+
+public:
+	SigChunkVec() : data_(&inline_chunk_), size_(0), capacity_(1) { }
+
+	SigChunkVec(const SigChunkVec &other) : SigChunkVec() {
+		init_from(other);
+	}
+
+	SigChunkVec(SigChunkVec &&other) : SigChunkVec() {
+		if (other.is_inline()) {
+			if (other.size_) {
+				inline_chunk_ = std::move(other.data_[0]);
+				size_ = 1;
+			}
+			other.release();
+		} else {
+			data_ = other.data_;
+			size_ = other.size_;
+			capacity_ = other.capacity_;
+			other.data_ = &other.inline_chunk_;
+			other.size_ = 0;
+			other.capacity_ = 1;
+		}
+	}
+
+	SigChunkVec &operator=(const SigChunkVec &other) {
+		if (this != &other) {
+			release();
+			init_from(other);
+		}
+		return *this;
+	}
+
+	SigChunkVec &operator=(SigChunkVec &&other) {
+		if (this != &other) {
+			release();
+			swap(other);
+		}
+		return *this;
+	}
+
+	~SigChunkVec() { release(); }
+
+	// true iff this and other share the same heap buffer
+	bool shares_storage(const SigChunkVec &other) const {
+		return !is_inline() && data_ == other.data_;
+	}
+
+	// instrumentation hooks for memory accounting (see the memstat pass):
+	// identity of the heap buffer (nullptr for inline storage) and the
+	// number of heap bytes it occupies, including the refcount header
+	const void *heap_buffer() const {
+		return is_inline() ? nullptr : static_cast<const void*>(buffer());
+	}
+	size_t heap_buffer_bytes() const {
+		return is_inline() ? 0 : sizeof(Buffer) + capacity_*sizeof(RTLIL::SigChunk);
+	}
+
+	void reserve(int new_capacity) {
+		if (new_capacity > capacity_)
+			make_room(new_capacity);
+	}
+
+	void push_back(const RTLIL::SigChunk &chunk) {
+		make_room(size_+1);
+		if (is_inline())
+			inline_chunk_ = chunk;
+		else
+			new (data_+size_) RTLIL::SigChunk(chunk);
+		size_++;
+	}
+
+	void push_back(RTLIL::SigChunk &&chunk) {
+		make_room(size_+1);
+		if (is_inline())
+			inline_chunk_ = std::move(chunk);
+		else
+			new (data_+size_) RTLIL::SigChunk(std::move(chunk));
+		size_++;
+	}
+
+	template<typename... Args>
+	RTLIL::SigChunk &emplace_back(Args&&... args) {
+		make_room(size_+1);
+		if (is_inline())
+			inline_chunk_ = RTLIL::SigChunk(std::forward<Args>(args)...);
+		else
+			new (data_+size_) RTLIL::SigChunk(std::forward<Args>(args)...);
+		return data_[size_++];
+	}
+
+	void pop_back() {
+		detach();
+		if (is_inline()) {
+			inline_chunk_ = RTLIL::SigChunk();
+			size_ = 0;
+		} else {
+			data_[--size_].~SigChunk();
+		}
+	}
+
+	void clear() { release(); }
+
+	void swap(SigChunkVec &other) {
+		if (is_inline() || other.is_inline()) {
+			SigChunkVec tmp(std::move(other));
+			other = std::move(*this);
+			*this = std::move(tmp);
+		} else {
+			std::swap(data_, other.data_);
+			std::swap(size_, other.size_);
+			std::swap(capacity_, other.capacity_);
+		}
+	}
+
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	RTLIL::SigChunk &operator[](int index) { detach(); return data_[index]; }
+	const RTLIL::SigChunk &operator[](int index) const { return data_[index]; }
+	RTLIL::SigChunk &at(int index) { log_assert(index >= 0 && index < size_); detach(); return data_[index]; }
+	const RTLIL::SigChunk &at(int index) const { log_assert(index >= 0 && index < size_); return data_[index]; }
+	RTLIL::SigChunk &front() { detach(); return data_[0]; }
+	const RTLIL::SigChunk &front() const { return data_[0]; }
+	RTLIL::SigChunk &back() { detach(); return data_[size_-1]; }
+	const RTLIL::SigChunk &back() const { return data_[size_-1]; }
+
+	iterator begin() { detach(); return data_; }
+	iterator end() { detach(); return data_+size_; }
+	const_iterator begin() const { return data_; }
+	const_iterator end() const { return data_+size_; }
+	std::reverse_iterator<iterator> rbegin() { return std::reverse_iterator<iterator>(end()); }
+	std::reverse_iterator<iterator> rend() { return std::reverse_iterator<iterator>(begin()); }
+	std::reverse_iterator<const_iterator> rbegin() const { return std::reverse_iterator<const_iterator>(end()); }
+	std::reverse_iterator<const_iterator> rend() const { return std::reverse_iterator<const_iterator>(begin()); }
+
+	operator std::vector<RTLIL::SigChunk>() const { return std::vector<RTLIL::SigChunk>(begin(), end()); }
+};
+
 struct RTLIL::SigBit
 {
 	RTLIL::Wire *wire;
@@ -844,7 +1421,7 @@ struct RTLIL::SigSpec
 private:
 	int width_;
 	unsigned long hash_;
-	std::vector<RTLIL::SigChunk> chunks_; // LSB at index 0
+	RTLIL::SigChunkVec chunks_; // LSB at index 0
 	std::vector<RTLIL::SigBit> bits_; // LSB at index 0
 
 	void pack() const;
@@ -879,6 +1456,7 @@ public:
 	SigSpec(RTLIL::State bit, int width = 1);
 	SigSpec(const RTLIL::SigBit &bit, int width = 1);
 	SigSpec(const std::vector<RTLIL::SigChunk> &chunks);
+	SigSpec(const RTLIL::SigChunkVec &chunks);
 	SigSpec(const std::vector<RTLIL::SigBit> &bits);
 	SigSpec(const pool<RTLIL::SigBit> &bits);
 	SigSpec(const std::set<RTLIL::SigBit> &bits);
@@ -889,7 +1467,7 @@ public:
 		return hash_;
 	}
 
-	inline const std::vector<RTLIL::SigChunk> &chunks() const { pack(); return chunks_; }
+	inline const RTLIL::SigChunkVec &chunks() const { pack(); return chunks_; }
 	inline const std::vector<RTLIL::SigBit> &bits() const { inline_unpack(); return bits_; }
 
 	inline int size() const { return width_; }
@@ -940,6 +1518,7 @@ public:
 	RTLIL::SigBit msb() const { log_assert(width_); return (*this)[width_ - 1]; };
 
 	void append(const RTLIL::SigSpec &signal);
+	void append(RTLIL::SigSpec &&signal);
 	inline void append(Wire *wire) { append(RTLIL::SigSpec(wire)); }
 	inline void append(const RTLIL::SigChunk &chunk) { append(RTLIL::SigSpec(chunk)); }
 	inline void append(const RTLIL::Const &const_) { append(RTLIL::SigSpec(const_)); }
@@ -991,7 +1570,7 @@ public:
 	static bool parse_sel(RTLIL::SigSpec &sig, RTLIL::Design *design, RTLIL::Module *module, std::string str);
 	static bool parse_rhs(const RTLIL::SigSpec &lhs, RTLIL::SigSpec &sig, RTLIL::Module *module, std::string str);
 
-	operator std::vector<RTLIL::SigChunk>() const { return chunks(); }
+	operator std::vector<RTLIL::SigChunk>() const { auto &c = chunks(); return std::vector<RTLIL::SigChunk>(c.begin(), c.end()); }
 	operator std::vector<RTLIL::SigBit>() const { return bits(); }
 	const RTLIL::SigBit &at(int offset, const RTLIL::SigBit &defval) { return offset < width_ ? (*this)[offset] : defval; }
 
@@ -1054,6 +1633,43 @@ struct RTLIL::Monitor
 	virtual void notify_blackout(RTLIL::Module*) { }
 };
 
+// Chunked bump allocator backing the wires and cells owned by a module. All
+// chunks are released at once when the arena is destroyed, so tearing down a
+// module costs one free() per chunk instead of one per object. The memory of
+// individually removed objects is recycled through free lists kept by the
+// module.
+struct RTLIL::ObjectArena
+{
+	std::vector<void*> chunks_;
+	size_t chunk_fill_ = 0, chunk_capacity_ = 0, total_capacity_ = 0;
+
+	ObjectArena() { }
+	ObjectArena(const ObjectArena&) = delete;
+	void operator=(const ObjectArena&) = delete;
+
+	~ObjectArena() {
+		for (void *chunk : chunks_)
+			::operator delete(chunk);
+	}
+
+	void *alloc(size_t size) {
+		size = (size + 15) & ~size_t(15);
+		if (chunk_fill_ + size > chunk_capacity_) {
+			chunk_capacity_ = max(size, chunks_.empty() ? size_t(16*1024) : min(2*chunk_capacity_, size_t(1024*1024)));
+			chunks_.push_back(::operator new(chunk_capacity_));
+			total_capacity_ += chunk_capacity_;
+			chunk_fill_ = 0;
+		}
+		void *ptr = static_cast<char*>(chunks_.back()) + chunk_fill_;
+		chunk_fill_ += size;
+		return ptr;
+	}
+
+	size_t allocated_bytes() const {
+		return total_capacity_ - (chunk_capacity_ - chunk_fill_);
+	}
+};
+
 // Forward declaration; defined in preproc.h.
 struct define_map_t;
 
@@ -1074,6 +1690,17 @@ struct RTLIL::Design
 
 	std::vector<RTLIL::Selection> selection_stack;
 	dict<RTLIL::IdString, RTLIL::Selection> selection_vars;
+
+	// Named selection expressions created by `select -setexpr`. The cached
+	// result set is kept in selection_vars under the same name and gets
+	// re-evaluated when 'digest' no longer matches the design (see the
+	// digest handling in passes/cmds/select.cc).
+	struct SelectionExpr {
+		std::string expr;
+		uint64_t digest = 0;
+		bool valid = false;
+	};
+	dict<RTLIL::IdString, SelectionExpr> selection_exprs;
 	std::string selected_active_module;
 
 	Design();
@@ -1169,6 +1796,29 @@ protected:
 	void add(RTLIL::Cell *cell);
 	void add(RTLIL::Process *process);
 
+	// wires and cells are bump-allocated from the arena; removed objects are
+	// destroyed in place and their slots kept for reuse by addWire()/addCell()
+	RTLIL::ObjectArena object_arena_;
+	std::vector<void*> spare_wire_slots_, spare_cell_slots_;
+
+	// hash-consing cache used by intern(); invalidated whenever wires are
+	// removed or renamed, since cached entries reference wires by pointer
+	pool<RTLIL::SigSpec> sigspec_intern_;
+	RTLIL::Wire *allocWire();
+	RTLIL::Cell *allocCell();
+	void freeWire(RTLIL::Wire *wire);
+	void freeCell(RTLIL::Cell *cell);
+
+	// shared worker behind the connect() overload pair
+	void do_connect(RTLIL::SigSig &&conn);
+
+	// lazily rebuilt caches behind wires_by_address()/cells_by_address(),
+	// revalidated against change_count()
+	std::vector<RTLIL::Wire*> wires_by_address_cache_;
+	std::vector<RTLIL::Cell*> cells_by_address_cache_;
+	uint64_t wires_by_address_change_count_;
+	uint64_t cells_by_address_change_count_;
+
 public:
 	RTLIL::Design *design;
 	pool<RTLIL::Monitor*> monitors;
@@ -1176,6 +1826,21 @@ public:
 	int refcount_wires_;
 	int refcount_cells_;
 
+	// Monotonically increasing counter, bumped by every structural mutation
+	// that goes through the Module/Cell API (add/remove/rename of objects,
+	// connect(), setPort(), setParam(), fixup_ports(), ...). Passes can
+	// snapshot change_count() and later compare it to detect in O(1) whether
+	// the module was modified in between, e.g. to decide if cached results
+	// derived from the module are still valid. Direct manipulation of public
+	// members (attributes, wire flags, cells_, ...) is not tracked.
+	uint64_t change_count_;
+	uint64_t change_count() const { return change_count_; }
+	void bump_change_count() { change_count_++; }
+
+	// bytes currently handed out by the arena backing this module's wires
+	// and cells (instrumentation hook for the memstat pass)
+	size_t object_arena_bytes() const { return object_arena_.allocated_bytes(); }
+
 	dict<RTLIL::IdString, RTLIL::Wire*> wires_;
 	dict<RTLIL::IdString, RTLIL::Cell*> cells_;
 
@@ -1202,13 +1867,23 @@ public:
 	virtual void makeblackbox();
 
 	void connect(const RTLIL::SigSig &conn);
+	void connect(RTLIL::SigSig &&conn);
 	void connect(const RTLIL::SigSpec &lhs, const RTLIL::SigSpec &rhs);
+	void connect(RTLIL::SigSpec &&lhs, RTLIL::SigSpec &&rhs);
+	void intern(RTLIL::SigSpec &sig);
 	void new_connections(const std::vector<RTLIL::SigSig> &new_conn);
 	const std::vector<RTLIL::SigSig> &connections() const;
 
 	std::vector<RTLIL::IdString> ports;
 	void fixup_ports();
 
+	// Incremental alternative to fixup_ports() for changing a single wire:
+	// sets the wire's port flags and maintains the ports vector and port_id
+	// numbering directly, in O(#ports) instead of a full wire scan. Only
+	// valid while the port bookkeeping is otherwise consistent, i.e. no
+	// other wire's port flags were modified since the last fixup_ports().
+	void make_port(RTLIL::Wire *wire, bool port_input, bool port_output);
+
 	template<typename T> void rewrite_sigspecs(T &functor);
 	template<typename T> void rewrite_sigspecs2(T &functor);
 	void cloneInto(RTLIL::Module *new_mod) const;
@@ -1248,6 +1923,24 @@ public:
 	RTLIL::ObjRange<RTLIL::Wire*> wires() { return RTLIL::ObjRange<RTLIL::Wire*>(&wires_, &refcount_wires_); }
 	RTLIL::ObjRange<RTLIL::Cell*> cells() { return RTLIL::ObjRange<RTLIL::Cell*>(&cells_, &refcount_cells_); }
 
+	// zero-copy variants of selected_wires()/selected_cells(); only valid
+	// while the module is not modified
+	RTLIL::SelectedObjRange<RTLIL::Wire*> selected_wires_view() { return RTLIL::SelectedObjRange<RTLIL::Wire*>(this, &wires_, &refcount_wires_); }
+	RTLIL::SelectedObjRange<RTLIL::Cell*> selected_cells_view() { return RTLIL::SelectedObjRange<RTLIL::Cell*>(this, &cells_, &refcount_cells_); }
+
+	// All wires/cells sorted by object address. Since objects are
+	// bump-allocated from the module's arena this approximates allocation
+	// order and clusters the sweep's memory accesses, which measurably helps
+	// cache hit rates in passes that touch every object. The vectors are
+	// rebuilt lazily and revalidated via change_count(), so repeated sweeps
+	// between structural modifications don't pay for re-sorting. The order is
+	// only stable within one process: callers must not let it influence
+	// anything that is written out or any generated names, and like
+	// change_count() itself the cache does not see direct manipulation of
+	// the public wires_/cells_ dicts.
+	const std::vector<RTLIL::Wire*> &wires_by_address();
+	const std::vector<RTLIL::Cell*> &cells_by_address();
+
 	void add(RTLIL::Binding *binding);
 
 	// Removing wires is expensive. If you have to remove wires, remove them all at once.
@@ -1265,6 +1958,11 @@ public:
 	RTLIL::IdString uniquify(RTLIL::IdString name);
 	RTLIL::IdString uniquify(RTLIL::IdString name, int &index);
 
+	// pre-size the wire and cell tables for a known number of upcoming
+	// addWire()/addCell() calls, so that bulk construction (e.g. elaborating
+	// a large generated module) does not rehash them repeatedly on the way up
+	void reserve(int extra_wires, int extra_cells);
+
 	RTLIL::Wire *addWire(RTLIL::IdString name, int width = 1);
 	RTLIL::Wire *addWire(RTLIL::IdString name, const RTLIL::Wire *other);
 
@@ -1557,6 +2255,9 @@ protected:
 	Cell();
 	~Cell();
 
+	// shared worker behind the setPort() overload pair
+	void do_setPort(const RTLIL::IdString &portname, RTLIL::SigSpec &&signal);
+
 public:
 	// do not simply copy cells
 	Cell(RTLIL::Cell &other) = delete;
@@ -1571,7 +2272,8 @@ public:
 	// access cell ports
 	bool hasPort(const RTLIL::IdString &portname) const;
 	void unsetPort(const RTLIL::IdString &portname);
-	void setPort(const RTLIL::IdString &portname, RTLIL::SigSpec signal);
+	void setPort(const RTLIL::IdString &portname, const RTLIL::SigSpec &signal);
+	void setPort(const RTLIL::IdString &portname, RTLIL::SigSpec &&signal);
 	const RTLIL::SigSpec &getPort(const RTLIL::IdString &portname) const;
 	const dict<RTLIL::IdString, RTLIL::SigSpec> &connections() const;
 
@@ -1673,6 +2375,8 @@ public:
 	RTLIL::CaseRule root_case;
 	std::vector<RTLIL::SyncRule*> syncs;
 
+	void intern();
+
 	template<typename T> void rewrite_sigspecs(T &functor);
 	template<typename T> void rewrite_sigspecs2(T &functor);
 	RTLIL::Process *clone() const;
@@ -1709,6 +2413,12 @@ inline unsigned int RTLIL::SigBit::hash() const {
 	return data;
 }
 
+template<typename T>
+inline void RTLIL::SelectedObjIterator<T>::skip_unselected() {
+	while (this->list_p != nullptr && !module->selected(this->it->second))
+		RTLIL::ObjIterator<T>::operator++();
+}
+
 inline RTLIL::SigBit &RTLIL::SigSpecIterator::operator*() const {
 	return (*sig_p)[index];
 }
@@ -24,54 +24,91 @@
 
 YOSYS_NAMESPACE_BEGIN
 
+// Set of non-const SigBits. Stored as one bit mask per wire (a hash/bitset
+// hybrid): membership costs a single pointer hash plus a bit test, and the
+// memory footprint is one dict entry per wire plus one bit per wire bit,
+// instead of a 16-byte hash entry per member bit.
 struct SigPool
 {
-	struct bitDef_t : public std::pair<RTLIL::Wire*, int> {
-		bitDef_t() : std::pair<RTLIL::Wire*, int>(NULL, 0) { }
-		bitDef_t(const RTLIL::SigBit &bit) : std::pair<RTLIL::Wire*, int>(bit.wire, bit.offset) { }
-		unsigned int hash() const { return first->name.hash() + second; }
-	};
-
-	pool<bitDef_t> bits;
+	dict<RTLIL::Wire*, std::vector<bool>, hash_ptr_ops> bits;
+	size_t entries = 0;
 
 	void clear()
 	{
 		bits.clear();
+		entries = 0;
+	}
+
+	void insert(const RTLIL::SigBit &bit)
+	{
+		std::vector<bool> &mask = bits[bit.wire];
+		if (GetSize(mask) <= bit.offset)
+			mask.resize(max(bit.wire->width, bit.offset + 1));
+		if (!mask[bit.offset]) {
+			mask[bit.offset] = true;
+			entries++;
+		}
+	}
+
+	void erase(const RTLIL::SigBit &bit)
+	{
+		auto it = bits.find(bit.wire);
+		if (it == bits.end() || bit.offset >= GetSize(it->second))
+			return;
+		if (it->second[bit.offset]) {
+			it->second[bit.offset] = false;
+			entries--;
+		}
 	}
 
 	void add(const RTLIL::SigSpec &sig)
 	{
 		for (auto &bit : sig)
 			if (bit.wire != NULL)
-				bits.insert(bit);
+				insert(bit);
 	}
 
 	void add(const SigPool &other)
 	{
-		for (auto &bit : other.bits)
-			bits.insert(bit);
+		for (auto &it : other.bits) {
+			std::vector<bool> &mask = bits[it.first];
+			if (GetSize(mask) < GetSize(it.second))
+				mask.resize(GetSize(it.second));
+			for (int i = 0; i < GetSize(it.second); i++)
+				if (it.second[i] && !mask[i]) {
+					mask[i] = true;
+					entries++;
+				}
+		}
 	}
 
 	void del(const RTLIL::SigSpec &sig)
 	{
 		for (auto &bit : sig)
 			if (bit.wire != NULL)
-				bits.erase(bit);
+				erase(bit);
 	}
 
 	void del(const SigPool &other)
 	{
-		for (auto &bit : other.bits)
-			bits.erase(bit);
+		for (auto &it : other.bits) {
+			auto this_it = bits.find(it.first);
+			if (this_it == bits.end())
+				continue;
+			for (int i = 0; i < GetSize(it.second) && i < GetSize(this_it->second); i++)
+				if (it.second[i] && this_it->second[i]) {
+					this_it->second[i] = false;
+					entries--;
+				}
+		}
 	}
 
 	void expand(const RTLIL::SigSpec &from, const RTLIL::SigSpec &to)
 	{
 		log_assert(GetSize(from) == GetSize(to));
 		for (int i = 0; i < GetSize(from); i++) {
-			bitDef_t bit_from(from[i]), bit_to(to[i]);
-			if (bit_from.first != NULL && bit_to.first != NULL && bits.count(bit_from) > 0)
-				bits.insert(bit_to);
+			if (from[i].wire != NULL && to[i].wire != NULL && check(from[i]))
+				insert(to[i]);
 		}
 	}
 
@@ -79,7 +116,7 @@ struct SigPool
 	{
 		RTLIL::SigSpec result;
 		for (auto &bit : sig)
-			if (bit.wire != NULL && bits.count(bit))
+			if (bit.wire != NULL && check(bit))
 				result.append(bit);
 		return result;
 	}
@@ -88,20 +125,23 @@ struct SigPool
 	{
 		RTLIL::SigSpec result;
 		for (auto &bit : sig)
-			if (bit.wire != NULL && bits.count(bit) == 0)
+			if (bit.wire != NULL && !check(bit))
 				result.append(bit);
 		return result;
 	}
 
 	bool check(const RTLIL::SigBit &bit) const
 	{
-		return bit.wire != NULL && bits.count(bit);
+		if (bit.wire == NULL)
+			return false;
+		auto it = bits.find(bit.wire);
+		return it != bits.end() && bit.offset < GetSize(it->second) && it->second[bit.offset];
 	}
 
 	bool check_any(const RTLIL::SigSpec &sig) const
 	{
 		for (auto &bit : sig)
-			if (bit.wire != NULL && bits.count(bit))
+			if (check(bit))
 				return true;
 		return false;
 	}
@@ -109,29 +149,33 @@ struct SigPool
 	bool check_all(const RTLIL::SigSpec &sig) const
 	{
 		for (auto &bit : sig)
-			if (bit.wire != NULL && bits.count(bit) == 0)
+			if (bit.wire != NULL && !check(bit))
 				return false;
 		return true;
 	}
 
 	RTLIL::SigSpec export_one() const
 	{
-		for (auto &bit : bits)
-			return RTLIL::SigSpec(bit.first, bit.second);
+		for (auto &it : bits)
+			for (int i = 0; i < GetSize(it.second); i++)
+				if (it.second[i])
+					return RTLIL::SigSpec(it.first, i);
 		return RTLIL::SigSpec();
 	}
 
 	RTLIL::SigSpec export_all() const
 	{
 		pool<RTLIL::SigBit> sig;
-		for (auto &bit : bits)
-			sig.insert(RTLIL::SigBit(bit.first, bit.second));
+		for (auto &it : bits)
+			for (int i = 0; i < GetSize(it.second); i++)
+				if (it.second[i])
+					sig.insert(RTLIL::SigBit(it.first, i));
 		return sig;
 	}
 
 	size_t size() const
 	{
-		return bits.size();
+		return entries;
 	}
 };
 
@@ -140,70 +184,179 @@ struct SigSet
 {
 	static_assert(!std::is_same<Compare,void>::value, "Default value for `Compare' class not found for SigSet<T>. Please specify.");
 
-	struct bitDef_t : public std::pair<RTLIL::Wire*, int> {
-		bitDef_t() : std::pair<RTLIL::Wire*, int>(NULL, 0) { }
-		bitDef_t(const RTLIL::SigBit &bit) : std::pair<RTLIL::Wire*, int>(bit.wire, bit.offset) { }
-		unsigned int hash() const { return first->name.hash() + second; }
+	// Most bits only have one or two entries (e.g. in a driver index), so the
+	// bucket keeps its values inline in a sorted vector and only promotes to
+	// a std::set when it grows past a threshold. This avoids allocating a
+	// red-black tree node per (bit, value) pair.
+	struct bucket_t
+	{
+		static constexpr int promote_threshold = 8;
+
+		std::vector<T> small_values; // sorted by Compare while big == nullptr
+		std::unique_ptr<std::set<T, Compare>> big;
+
+		bucket_t() { }
+		bucket_t(bucket_t &&other) = default;
+		bucket_t &operator=(bucket_t &&other) = default;
+		bucket_t(const bucket_t &other) : small_values(other.small_values) {
+			if (other.big)
+				big.reset(new std::set<T, Compare>(*other.big));
+		}
+		bucket_t &operator=(const bucket_t &other) {
+			small_values = other.small_values;
+			big.reset(other.big ? new std::set<T, Compare>(*other.big) : nullptr);
+			return *this;
+		}
+
+		static bool equal(const T &a, const T &b) {
+			Compare cmp;
+			return !cmp(a, b) && !cmp(b, a);
+		}
+
+		void insert(const T &value)
+		{
+			if (big) {
+				big->insert(value);
+				return;
+			}
+			auto it = std::lower_bound(small_values.begin(), small_values.end(), value, Compare());
+			if (it != small_values.end() && equal(*it, value))
+				return;
+			if (GetSize(small_values) < promote_threshold) {
+				small_values.insert(it, value);
+				return;
+			}
+			big.reset(new std::set<T, Compare>(small_values.begin(), small_values.end()));
+			small_values.clear();
+			small_values.shrink_to_fit();
+			big->insert(value);
+		}
+
+		template<typename Iter>
+		void insert(Iter first, Iter last)
+		{
+			for (; first != last; ++first)
+				insert(*first);
+		}
+
+		void erase(const T &value)
+		{
+			if (big) {
+				big->erase(value);
+				return;
+			}
+			auto it = std::lower_bound(small_values.begin(), small_values.end(), value, Compare());
+			if (it != small_values.end() && equal(*it, value))
+				small_values.erase(it);
+		}
+
+		template<typename Iter>
+		void erase(Iter first, Iter last)
+		{
+			for (; first != last; ++first)
+				erase(*first);
+		}
+
+		void clear()
+		{
+			small_values.clear();
+			big.reset();
+		}
+
+		bool empty() const
+		{
+			return big ? big->empty() : small_values.empty();
+		}
+
+		size_t size() const
+		{
+			return big ? big->size() : small_values.size();
+		}
+
+		int count(const T &value) const
+		{
+			if (big)
+				return big->count(value);
+			auto it = std::lower_bound(small_values.begin(), small_values.end(), value, Compare());
+			return it != small_values.end() && equal(*it, value) ? 1 : 0;
+		}
+
+		// copy the values (in Compare order) into a std::set, pool or similar
+		template<typename Container>
+		void copy_into(Container &result) const
+		{
+			if (big)
+				result.insert(big->begin(), big->end());
+			else
+				result.insert(small_values.begin(), small_values.end());
+		}
 	};
 
-	dict<bitDef_t, std::set<T, Compare>> bits;
+	// bits are keyed by a single 64-bit word: a small per-set wire id in the
+	// upper half, the bit offset in the lower half. This halves the key
+	// memory compared to the old (Wire*, offset) pairs and avoids hashing
+	// through the wire name.
+	dict<uint64_t, bucket_t> bits;
+	idict<RTLIL::Wire*, 0, hash_ptr_ops> wire_ids;
+
+	uint64_t bit_key(const RTLIL::SigBit &bit)
+	{
+		return ((uint64_t)wire_ids(bit.wire) << 32) | (uint32_t)bit.offset;
+	}
 
 	void clear()
 	{
 		bits.clear();
+		wire_ids.clear();
 	}
 
 	void insert(const RTLIL::SigSpec &sig, T data)
 	{
 		for (const auto &bit : sig)
 			if (bit.wire != NULL)
-				bits[bit].insert(data);
+				bits[bit_key(bit)].insert(data);
 	}
 
 	void insert(const RTLIL::SigSpec& sig, const std::set<T> &data)
 	{
 		for (const auto &bit : sig)
 			if (bit.wire != NULL)
-				bits[bit].insert(data.begin(), data.end());
+				bits[bit_key(bit)].insert(data.begin(), data.end());
 	}
 
 	void erase(const RTLIL::SigSpec& sig)
 	{
 		for (const auto &bit : sig)
 			if (bit.wire != NULL)
-				bits[bit].clear();
+				bits[bit_key(bit)].clear();
 	}
 
 	void erase(const RTLIL::SigSpec &sig, T data)
 	{
 		for (const auto &bit : sig)
 			if (bit.wire != NULL)
-				bits[bit].erase(data);
+				bits[bit_key(bit)].erase(data);
 	}
 
 	void erase(const RTLIL::SigSpec &sig, const std::set<T> &data)
 	{
 		for (const auto &bit : sig)
 			if (bit.wire != NULL)
-				bits[bit].erase(data.begin(), data.end());
+				bits[bit_key(bit)].erase(data.begin(), data.end());
 	}
 
 	void find(const RTLIL::SigSpec &sig, std::set<T> &result)
 	{
 		for (const auto &bit : sig)
-			if (bit.wire != NULL) {
-				auto &data = bits[bit];
-				result.insert(data.begin(), data.end());
-			}
+			if (bit.wire != NULL)
+				bits[bit_key(bit)].copy_into(result);
 	}
 
 	void find(const RTLIL::SigSpec &sig, pool<T> &result)
 	{
 		for (const auto &bit : sig)
-			if (bit.wire != NULL) {
-				auto &data = bits[bit];
-				result.insert(data.begin(), data.end());
-			}
+			if (bit.wire != NULL)
+				bits[bit_key(bit)].copy_into(result);
 	}
 
 	std::set<T> find(const RTLIL::SigSpec &sig)
@@ -216,8 +369,11 @@ struct SigSet
 	bool has(const RTLIL::SigSpec &sig)
 	{
 		for (auto &bit : sig)
-			if (bit.wire != NULL && bits.count(bit))
-				return true;
+			if (bit.wire != NULL) {
+				int wire_id = wire_ids.at(bit.wire, -1);
+				if (wire_id >= 0 && bits.count(((uint64_t)wire_id << 32) | (uint32_t)bit.offset))
+					return true;
+			}
 		return false;
 	}
 };
@@ -352,6 +508,80 @@ struct SigMap
 				sig.append(bit);
 		return sig;
 	}
+
+	// Remove all bits of the given wires from the database, preserving the
+	// equivalences between the remaining bits. Together with add() this
+	// allows keeping one SigMap alive across module mutations instead of
+	// rebuilding it with set(). This rebuilds the union-find in O(database
+	// size), so if multiple wires are to be removed, remove them all at once.
+	void invalidate(const pool<RTLIL::Wire*> &wires)
+	{
+		mfp<RTLIL::SigBit> new_database;
+		new_database.reserve(GetSize(database));
+
+		dict<int, int> new_leader; // old group representative index -> new index of first survivor
+
+		for (int i = 0; i < GetSize(database); i++)
+		{
+			const RTLIL::SigBit &bit = database[i];
+			if (bit.wire != nullptr && wires.count(bit.wire))
+				continue;
+
+			int new_idx = new_database(bit);
+			auto it = new_leader.insert(std::make_pair(database.ifind(i), new_idx));
+			if (!it.second)
+				new_database.imerge(new_idx, it.first->second);
+		}
+
+		// keep the representative of each group stable: the old
+		// representative wins if it survived, otherwise a constant member
+		// is promoted as in add()
+		for (auto &it : new_leader) {
+			const RTLIL::SigBit &repr = database[it.first];
+			if (repr.wire == nullptr || wires.count(repr.wire) == 0)
+				new_database.promote(repr);
+		}
+
+		database.swap(new_database);
+	}
+
+	void invalidate(RTLIL::Wire *wire)
+	{
+		pool<RTLIL::Wire*> wires = { wire };
+		invalidate(wires);
+	}
+};
+
+// Keeps a SigMap in sync with its module while it is in scope: connections
+// made while the monitor is installed are added to the map incrementally.
+// Wire removals still have to be reported through SigMap::invalidate().
+struct SigMapMonitor : RTLIL::Monitor
+{
+	SigMap &sigmap;
+	RTLIL::Module *module;
+
+	SigMapMonitor(SigMap &sigmap, RTLIL::Module *module) : sigmap(sigmap), module(module)
+	{
+		module->monitors.insert(this);
+	}
+
+	~SigMapMonitor()
+	{
+		module->monitors.erase(this);
+	}
+
+	void notify_connect(RTLIL::Module *mod, const RTLIL::SigSig &sigsig) override
+	{
+		if (mod == module)
+			sigmap.add(sigsig.first, sigsig.second);
+	}
+
+	void notify_connect(RTLIL::Module *mod, const std::vector<RTLIL::SigSig> &sigsig_vec) override
+	{
+		if (mod == module)
+			for (auto &sigsig : sigsig_vec)
+				sigmap.add(sigsig.first, sigsig.second);
+	}
 };
 
 YOSYS_NAMESPACE_END
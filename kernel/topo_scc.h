@@ -68,6 +68,7 @@ private:
         std::sort(edges.begin(), edges.end());
         auto last = std::unique(edges.begin(), edges.end());
         edges.erase(last, edges.end());
+        computed = true;
         auto edge = edges.begin();
         auto edge_end = edges.end();
         int range_begin = 0;
@@ -158,6 +159,7 @@ private:
         std::sort(edges.begin(), edges.end());
         auto last = std::unique(edges.begin(), edges.end());
         edges.erase(last, edges.end());
+        computed = true;
         auto edge = edges.begin();
         auto edge_end = edges.end();
         int range_begin = 0;
@@ -352,6 +354,199 @@ public:
     }
 };
 
+// Multicore variant of TopoSortedSccs for large graphs. It works on the same
+// graph interfaces (IntGraph, SigCellGraph, the functional backend's
+// SccAdaptor) and invokes the component callback with the same contract: the
+// callback runs on the calling thread, one component at a time, and a
+// component is only emitted after all components it has edges to.
+//
+// Strategy: the bulk of a netlist graph is acyclic, so we first peel nodes
+// whose successors have all been emitted (a level-synchronous Kahn sweep,
+// with each level processed in parallel via the ThreadPool). Only the nodes
+// that reach a cycle survive the peeling; those are handed to the serial
+// Tarjan engine above, which skips already-emitted nodes via their dfs_index.
+// For small graphs or a single-threaded pool this degrades to the serial
+// engine outright.
+//
+// Unlike the serial engine there is no incremental process(node) API: roots
+// are passed in one batch, as emission can only start once the full set of
+// live nodes is known.
+template<typename G, typename ComponentCallback>
+class ParallelTopoSortedSccs
+{
+    typedef typename G::node_enumerator node_enumerator;
+    typedef typename G::successor_enumerator successor_enumerator;
+    typedef typename G::node_type node_type;
+
+    static constexpr int parallel_threshold = 4096;
+
+    G &graph;
+    ComponentCallback component;
+
+public:
+    ParallelTopoSortedSccs(G &graph, ComponentCallback component)
+    : graph(graph), component(component) {}
+
+    // process the whole graph
+    ParallelTopoSortedSccs &process_all()
+    {
+        run(nullptr);
+        return *this;
+    }
+
+    // process all nodes that are reachable from the given root nodes
+    ParallelTopoSortedSccs &process(std::vector<node_type> const &roots)
+    {
+        run(&roots);
+        return *this;
+    }
+
+private:
+    void run(std::vector<node_type> const *roots)
+    {
+        std::vector<node_type> nodes;
+        {
+            node_enumerator en = graph.enumerate_nodes();
+            while (!en.finished())
+                nodes.push_back(en.next());
+        }
+        int n = GetSize(nodes);
+
+        ThreadPool &pool = ThreadPool::get();
+        if (n < parallel_threshold || pool.num_threads() == 1) {
+            TopoSortedSccs<G, ComponentCallback> toposort(graph, component);
+            if (roots == nullptr)
+                toposort.process_all();
+            else
+                for (node_type root : *roots)
+                    toposort.process(root);
+            return;
+        }
+
+        // assign dense ids, temporarily stored in the dfs_index slots so the
+        // parallel phase below can map successor nodes back to ids
+        for (int i = 0; i < n; i++)
+            graph.dfs_index(nodes[i]) = i;
+
+        // forward adjacency in CSR form, built in parallel
+        std::vector<int> succ_begin(n + 1, 0);
+        pool.parallel_for(n, [&](int i) {
+            int count = 0;
+            successor_enumerator en = graph.enumerate_successors(nodes[i]);
+            while (!en.finished())
+                en.next(), count++;
+            succ_begin[i + 1] = count;
+        });
+        for (int i = 0; i < n; i++)
+            succ_begin[i + 1] += succ_begin[i];
+        std::vector<int> succ(succ_begin[n]);
+        pool.parallel_for(n, [&](int i) {
+            int at = succ_begin[i];
+            successor_enumerator en = graph.enumerate_successors(nodes[i]);
+            while (!en.finished())
+                succ[at++] = graph.dfs_index(en.next());
+        });
+
+        // reverse adjacency in CSR form
+        std::vector<int> pred_begin(n + 1, 0);
+        for (int i : succ)
+            pred_begin[i + 1]++;
+        for (int i = 0; i < n; i++)
+            pred_begin[i + 1] += pred_begin[i];
+        std::vector<int> pred(succ_begin[n]);
+        {
+            std::vector<std::atomic<int>> slot(n);
+            for (int i = 0; i < n; i++)
+                slot[i].store(pred_begin[i], std::memory_order_relaxed);
+            pool.parallel_for(n, [&](int i) {
+                for (int k = succ_begin[i]; k != succ_begin[i + 1]; k++)
+                    pred[slot[succ[k]].fetch_add(1, std::memory_order_relaxed)] = i;
+            });
+        }
+
+        // restrict to the nodes reachable from the roots (level-synchronous
+        // parallel BFS); without roots everything is live
+        std::vector<std::atomic<unsigned char>> live(n);
+        std::vector<int> frontier, next_frontier(n);
+        std::atomic<int> cursor;
+        if (roots == nullptr) {
+            for (int i = 0; i < n; i++)
+                live[i].store(1, std::memory_order_relaxed);
+        } else {
+            for (int i = 0; i < n; i++)
+                live[i].store(0, std::memory_order_relaxed);
+            for (node_type root : *roots) {
+                int id = graph.dfs_index(root);
+                if (!live[id].exchange(1, std::memory_order_relaxed))
+                    frontier.push_back(id);
+            }
+            while (!frontier.empty()) {
+                cursor.store(0, std::memory_order_relaxed);
+                pool.parallel_for(GetSize(frontier), [&](int fi) {
+                    int node = frontier[fi];
+                    for (int k = succ_begin[node]; k != succ_begin[node + 1]; k++) {
+                        int s = succ[k];
+                        if (!live[s].exchange(1, std::memory_order_relaxed))
+                            next_frontier[cursor.fetch_add(1, std::memory_order_relaxed)] = s;
+                    }
+                });
+                frontier.assign(next_frontier.begin(), next_frontier.begin() + cursor.load(std::memory_order_relaxed));
+            }
+        }
+
+        // peel live nodes whose successors have all been peeled; every peeled
+        // node is a singleton SCC and the peel order is a valid emission order
+        std::vector<std::atomic<int>> remaining_out(n);
+        pool.parallel_for(n, [&](int i) {
+            remaining_out[i].store(succ_begin[i + 1] - succ_begin[i], std::memory_order_relaxed);
+        });
+        std::vector<int> order;
+        order.reserve(n);
+        frontier.clear();
+        for (int i = 0; i < n; i++)
+            if (live[i].load(std::memory_order_relaxed) && succ_begin[i] == succ_begin[i + 1])
+                frontier.push_back(i);
+        while (!frontier.empty()) {
+            order.insert(order.end(), frontier.begin(), frontier.end());
+            cursor.store(0, std::memory_order_relaxed);
+            pool.parallel_for(GetSize(frontier), [&](int fi) {
+                int node = frontier[fi];
+                for (int k = pred_begin[node]; k != pred_begin[node + 1]; k++) {
+                    int p = pred[k];
+                    if (remaining_out[p].fetch_sub(1, std::memory_order_relaxed) == 1)
+                        if (live[p].load(std::memory_order_relaxed))
+                            next_frontier[cursor.fetch_add(1, std::memory_order_relaxed)] = p;
+                }
+            });
+            frontier.assign(next_frontier.begin(), next_frontier.begin() + cursor.load(std::memory_order_relaxed));
+        }
+
+        // restore the dfs_index contract of the serial engine: -1 for nodes
+        // that were not processed yet (including unreachable ones), INT_MAX
+        // for emitted ones
+        std::vector<bool> peeled(n, false);
+        for (int id : order)
+            peeled[id] = true;
+        for (int i = 0; i < n; i++)
+            graph.dfs_index(nodes[i]) = peeled[i] ? INT_MAX : -1;
+
+        for (int id : order) {
+            node_type node = nodes[id];
+            component(&node, &node + 1);
+            graph.dfs_index(nodes[id]) = INT_MAX;
+        }
+
+        // what survives the peeling reaches a cycle; hand it to the serial
+        // Tarjan engine, which skips the already emitted nodes
+        TopoSortedSccs<G, ComponentCallback> toposort(graph, component);
+        if (roots == nullptr)
+            toposort.process_all();
+        else
+            for (node_type root : *roots)
+                toposort.process(root);
+    }
+};
+
 YOSYS_NAMESPACE_END
 
 #endif
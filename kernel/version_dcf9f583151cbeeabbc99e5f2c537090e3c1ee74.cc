@@ -0,0 +1 @@
+namespace Yosys { extern const char *yosys_version_str; const char *yosys_version_str="Yosys 0.45+106 (git sha1 dcf9f583151cbeeabbc99e5f2c537090e3c1ee74, g++ 12.2.0-14+deb12u1 -fPIC -O3)"; }
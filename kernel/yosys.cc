@@ -93,6 +93,8 @@ bool memhasher_active = false;
 uint32_t memhasher_rng = 123456;
 std::vector<void*> memhasher_store;
 
+AllocStats alloc_stats;
+
 std::string yosys_share_dirname;
 std::string yosys_abc_executable;
 
@@ -540,6 +542,204 @@ std::string escape_filename_spaces(const std::string& filename)
 	return out;
 }
 
+// NEW_ID may be called concurrently from parallel_safe module passes (see
+// ModulePass in kernel/register.h). Parallel dispatch only exists in
+// YOSYS_THREADSAFE_IDS builds, so only those pay for the atomic increment.
+static inline int autoidx_fetch_add()
+{
+#ifdef YOSYS_THREADSAFE_IDS
+	return __atomic_fetch_add(&autoidx, 1, __ATOMIC_RELAXED);
+#else
+	return autoidx++;
+#endif
+}
+
+// Deterministic NEW_ID naming inside parallel_for() batches: every batch
+// takes a single autoidx value as its base and every work item numbers its
+// ids as <base>.<item>.<n>, so the generated names only depend on the batch
+// and the work item, never on how the items were interleaved across threads.
+// A single-threaded run of the same batch produces identical names. Outside
+// a batch, ids are numbered from the plain autoidx counter as before.
+static thread_local int new_id_batch_base = -1;
+static thread_local int new_id_batch_item = 0;
+static thread_local int new_id_batch_count = 0;
+
+static inline void new_id_scope_enter(int base, int item)
+{
+	new_id_batch_base = base;
+	new_id_batch_item = item;
+	new_id_batch_count = 0;
+}
+
+static inline void new_id_scope_leave()
+{
+	new_id_batch_base = -1;
+}
+
+static ThreadPool *thread_pool_singleton = nullptr;
+static int thread_pool_requested_threads = 0;
+
+// serializes nested parallel_for() calls (see header)
+static thread_local bool thread_pool_busy = false;
+
+ThreadPool &ThreadPool::get()
+{
+	if (thread_pool_singleton == nullptr)
+	{
+		int num_threads = thread_pool_requested_threads;
+
+		if (num_threads <= 0) {
+			const char *env = getenv("YOSYS_NUM_THREADS");
+			if (env != nullptr)
+				num_threads = atoi(env);
+		}
+
+		if (num_threads <= 0)
+			num_threads = std::thread::hardware_concurrency();
+
+		thread_pool_singleton = new ThreadPool(max(num_threads, 1));
+	}
+	return *thread_pool_singleton;
+}
+
+void ThreadPool::set_num_threads(int num_threads)
+{
+	thread_pool_requested_threads = num_threads;
+	destroy();
+}
+
+void ThreadPool::destroy()
+{
+	delete thread_pool_singleton;
+	thread_pool_singleton = nullptr;
+}
+
+ThreadPool::ThreadPool(int num_threads_arg)
+{
+	job_next = 0;
+	for (int i = 0; i < num_threads_arg-1; i++)
+		workers.emplace_back([this]() { worker_main(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		shutdown_workers = true;
+	}
+	work_cv.notify_all();
+	for (auto &worker : workers)
+		worker.join();
+}
+
+void ThreadPool::run_chunks(const std::function<void(int)> &fn, int count)
+{
+	int chunk_size = max(1, count / (8 * num_threads()));
+	while (true) {
+		int begin = job_next.fetch_add(chunk_size);
+		if (begin >= count)
+			break;
+		int end = min(begin + chunk_size, count);
+		try {
+			for (int index = begin; index < end; index++) {
+				new_id_scope_enter(job_id_base, index);
+				fn(index);
+			}
+		} catch (...) {
+			std::unique_lock<std::mutex> lock(mutex);
+			if (!job_exception)
+				job_exception = std::current_exception();
+			// make the remaining workers skip to the end of the index space
+			job_next.store(count);
+			break;
+		}
+	}
+	new_id_scope_leave();
+}
+
+void ThreadPool::worker_main()
+{
+	uint64_t seen_generation = 0;
+	while (true)
+	{
+		const std::function<void(int)> *fn;
+		int count;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			work_cv.wait(lock, [&]() { return shutdown_workers || job_generation != seen_generation; });
+			if (shutdown_workers)
+				return;
+			seen_generation = job_generation;
+			fn = job_fn;
+			count = job_count;
+		}
+
+		// mark the worker as busy so a parallel_for() called from inside
+		// the work function runs serially instead of deadlocking
+		thread_pool_busy = true;
+		run_chunks(*fn, count);
+		thread_pool_busy = false;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (--job_running == 0)
+				done_cv.notify_one();
+		}
+	}
+}
+
+void ThreadPool::parallel_for(int count, const std::function<void(int)> &fn)
+{
+	if (count <= 0)
+		return;
+
+	// nested calls run serially inside the current work item and keep
+	// numbering their ids from the enclosing item's scope
+	if (thread_pool_busy) {
+		for (int index = 0; index < count; index++)
+			fn(index);
+		return;
+	}
+
+	if (workers.empty() || count == 1) {
+		int id_base = autoidx_fetch_add();
+		for (int index = 0; index < count; index++) {
+			new_id_scope_enter(id_base, index);
+			fn(index);
+		}
+		new_id_scope_leave();
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		job_fn = &fn;
+		job_count = count;
+		job_next = 0;
+		job_id_base = autoidx_fetch_add();
+		job_running = GetSize(workers);
+		job_exception = nullptr;
+		job_generation++;
+	}
+	work_cv.notify_all();
+
+	thread_pool_busy = true;
+	run_chunks(fn, count);
+	thread_pool_busy = false;
+
+	std::exception_ptr exception;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		done_cv.wait(lock, [&]() { return job_running == 0; });
+		job_fn = nullptr;
+		exception = job_exception;
+		job_exception = nullptr;
+	}
+
+	if (exception)
+		std::rethrow_exception(exception);
+}
+
 bool already_setup = false;
 
 void yosys_setup()
@@ -550,6 +750,16 @@ void yosys_setup()
 	init_share_dirname();
 	init_abc_executable_name();
 
+	constexpr int num_constids = 0
+#define X(_id) +1
+#include "kernel/constids.inc"
+#undef X
+	;
+
+	// headroom for the ids interned right after startup (cell types from
+	// celltypes.h, port/parameter names from the frontends, ...)
+	IdString::reserve_storage(2*num_constids + 1000);
+
 #define X(_id) RTLIL::ID::_id = "\\" # _id;
 #include "kernel/constids.inc"
 #undef X
@@ -580,6 +790,9 @@ void yosys_shutdown()
 		return;
 	already_shutdown = true;
 	log_pop();
+	log_set_async(false);
+
+	ThreadPool::destroy();
 
 	Pass::done_register();
 
@@ -634,7 +847,11 @@ RTLIL::IdString new_id(std::string file, int line, std::string func)
 	if (pos != std::string::npos)
 		func = func.substr(pos+1);
 
-	return stringf("$auto$%s:%d:%s$%d", file.c_str(), line, func.c_str(), autoidx++);
+	if (new_id_batch_base >= 0)
+		return format_cat("$auto$", file, ':', line, ':', func, '$',
+				new_id_batch_base, '.', new_id_batch_item, '.', new_id_batch_count++);
+
+	return format_cat("$auto$", file, ':', line, ':', func, '$', autoidx_fetch_add());
 }
 
 RTLIL::IdString new_id_suffix(std::string file, int line, std::string func, std::string suffix)
@@ -651,7 +868,11 @@ RTLIL::IdString new_id_suffix(std::string file, int line, std::string func, std:
 	if (pos != std::string::npos)
 		func = func.substr(pos+1);
 
-	return stringf("$auto$%s:%d:%s$%s$%d", file.c_str(), line, func.c_str(), suffix.c_str(), autoidx++);
+	if (new_id_batch_base >= 0)
+		return format_cat("$auto$", file, ':', line, ':', func, '$', suffix, '$',
+				new_id_batch_base, '.', new_id_batch_item, '.', new_id_batch_count++);
+
+	return format_cat("$auto$", file, ':', line, ':', func, '$', suffix, '$', autoidx_fetch_add());
 }
 
 RTLIL::Design *yosys_get_design()
@@ -824,11 +1045,154 @@ static int tcl_yosys_cmd(ClientData, Tcl_Interp *interp, int argc, const char *a
 	return TCL_OK;
 }
 
+// Direct in-process query interface for Tcl scripts. Unlike the 'yosys'
+// command these subcommands do not go through command-string parsing, Pass
+// dispatch or the log machinery: they read the current design directly and
+// return batched results as Tcl lists, so scripts issuing many small queries
+// (attribute reads, stat probes, connectivity walks) are not dominated by
+// parse/dispatch overhead.
+//
+//   yosys_query modules                          selected module names
+//   yosys_query stat <module>                    {wires N cells N memories N processes N}
+//   yosys_query cells <module> [<pattern>]       {name type} per matching cell
+//   yosys_query wires <module> [<pattern>]       {name width} per matching wire
+//   yosys_query attrs <module> [<objname>]       {attr value} pairs of the module
+//                                                or of one of its cells/wires
+//   yosys_query attr <module> <objname> <attr>   single attribute value ("" if unset)
+//   yosys_query conns <module> <cell>            {port signal} pairs
+static int tcl_yosys_query_cmd(ClientData, Tcl_Interp *interp, int argc, const char *argv[])
+{
+	auto tcl_error = [&](const std::string &msg) {
+		Tcl_SetObjResult(interp, Tcl_NewStringObj(msg.data(), msg.size()));
+		return TCL_ERROR;
+	};
+	auto append_str = [&](Tcl_Obj *list, const std::string &str) {
+		Tcl_ListObjAppendElement(interp, list, Tcl_NewStringObj(str.data(), str.size()));
+	};
+	auto const_str = [](const RTLIL::Const &value) -> std::string {
+		if (value.flags & RTLIL::CONST_FLAG_STRING)
+			return value.decode_string();
+		if (GetSize(value) <= 32 && value.is_fully_def())
+			return stringf("%d", value.as_int());
+		return value.as_string();
+	};
+
+	RTLIL::Design *design = yosys_get_design();
+
+	if (argc < 2)
+		return tcl_error("Usage: yosys_query <subcommand> [args] (see kernel/yosys.cc).");
+
+	std::string subcmd = argv[1];
+
+	if (subcmd == "modules") {
+		Tcl_Obj *result = Tcl_NewListObj(0, nullptr);
+		for (auto module : design->selected_modules())
+			append_str(result, RTLIL::unescape_id(module->name));
+		Tcl_SetObjResult(interp, result);
+		return TCL_OK;
+	}
+
+	if (argc < 3)
+		return tcl_error("Missing module name argument.");
+
+	RTLIL::Module *module = design->module(RTLIL::escape_id(argv[2]));
+	if (module == nullptr)
+		return tcl_error(stringf("No module '%s' in current design.", argv[2]));
+
+	if (subcmd == "stat") {
+		Tcl_Obj *result = Tcl_NewListObj(0, nullptr);
+		append_str(result, "wires");
+		Tcl_ListObjAppendElement(interp, result, Tcl_NewLongObj(GetSize(module->wires())));
+		append_str(result, "cells");
+		Tcl_ListObjAppendElement(interp, result, Tcl_NewLongObj(GetSize(module->cells())));
+		append_str(result, "memories");
+		Tcl_ListObjAppendElement(interp, result, Tcl_NewLongObj(GetSize(module->memories)));
+		append_str(result, "processes");
+		Tcl_ListObjAppendElement(interp, result, Tcl_NewLongObj(GetSize(module->processes)));
+		Tcl_SetObjResult(interp, result);
+		return TCL_OK;
+	}
+
+	if (subcmd == "cells" || subcmd == "wires") {
+		const char *pattern = argc > 3 ? argv[3] : nullptr;
+		Tcl_Obj *result = Tcl_NewListObj(0, nullptr);
+		if (subcmd == "cells") {
+			for (auto cell : module->cells()) {
+				std::string name = RTLIL::unescape_id(cell->name);
+				if (pattern != nullptr && !patmatch(pattern, name.c_str()))
+					continue;
+				Tcl_Obj *entry = Tcl_NewListObj(0, nullptr);
+				append_str(entry, name);
+				append_str(entry, RTLIL::unescape_id(cell->type));
+				Tcl_ListObjAppendElement(interp, result, entry);
+			}
+		} else {
+			for (auto wire : module->wires()) {
+				std::string name = RTLIL::unescape_id(wire->name);
+				if (pattern != nullptr && !patmatch(pattern, name.c_str()))
+					continue;
+				Tcl_Obj *entry = Tcl_NewListObj(0, nullptr);
+				append_str(entry, name);
+				Tcl_ListObjAppendElement(interp, entry, Tcl_NewLongObj(wire->width));
+				Tcl_ListObjAppendElement(interp, result, entry);
+			}
+		}
+		Tcl_SetObjResult(interp, result);
+		return TCL_OK;
+	}
+
+	if (subcmd == "attrs" || subcmd == "attr") {
+		const dict<RTLIL::IdString, RTLIL::Const> *attributes = &module->attributes;
+		if (argc > 3) {
+			RTLIL::IdString obj_name = RTLIL::escape_id(argv[3]);
+			if (RTLIL::Cell *cell = module->cell(obj_name))
+				attributes = &cell->attributes;
+			else if (RTLIL::Wire *wire = module->wire(obj_name))
+				attributes = &wire->attributes;
+			else
+				return tcl_error(stringf("No cell or wire '%s' in module '%s'.", argv[3], argv[2]));
+		}
+		if (subcmd == "attr") {
+			if (argc < 5)
+				return tcl_error("Usage: yosys_query attr <module> <objname> <attr>.");
+			auto it = attributes->find(RTLIL::escape_id(argv[4]));
+			std::string value = it != attributes->end() ? const_str(it->second) : "";
+			Tcl_SetObjResult(interp, Tcl_NewStringObj(value.data(), value.size()));
+			return TCL_OK;
+		}
+		Tcl_Obj *result = Tcl_NewListObj(0, nullptr);
+		for (auto &attr : *attributes) {
+			append_str(result, RTLIL::unescape_id(attr.first));
+			append_str(result, const_str(attr.second));
+		}
+		Tcl_SetObjResult(interp, result);
+		return TCL_OK;
+	}
+
+	if (subcmd == "conns") {
+		if (argc < 4)
+			return tcl_error("Usage: yosys_query conns <module> <cell>.");
+		RTLIL::Cell *cell = module->cell(RTLIL::escape_id(argv[3]));
+		if (cell == nullptr)
+			return tcl_error(stringf("No cell '%s' in module '%s'.", argv[3], argv[2]));
+		Tcl_Obj *result = Tcl_NewListObj(0, nullptr);
+		for (auto &conn : cell->connections()) {
+			append_str(result, RTLIL::unescape_id(conn.first));
+			append_str(result, log_signal(conn.second));
+		}
+		Tcl_SetObjResult(interp, result);
+		return TCL_OK;
+	}
+
+	return tcl_error(stringf("Unknown yosys_query subcommand '%s'.", subcmd.c_str()));
+}
+
 int yosys_tcl_iterp_init(Tcl_Interp *interp)
 {
 	if (Tcl_Init(interp)!=TCL_OK)
 		log_warning("Tcl_Init() call failed - %s\n",Tcl_ErrnoMsg(Tcl_GetErrno()));
 	Tcl_CreateCommand(interp, "yosys", tcl_yosys_cmd, NULL, NULL);
+	Tcl_CreateCommand(interp, "yosys_query", tcl_yosys_query_cmd, NULL, NULL);
 	return TCL_OK ;
 }
 
@@ -1583,3 +1947,48 @@ struct ScriptCmdPass : public Pass {
 } ScriptCmdPass;
 
 YOSYS_NAMESPACE_END
+
+// Global allocator hooks feeding Yosys::alloc_stats (see kernel/yosys_common.h).
+// The default nothrow, sized and aligned-fallback forms all forward to these
+// four functions, so replacing them covers every plain allocation in the
+// process. The replacements must be allocator-complete pairs: new uses
+// malloc(), so delete must use free().
+
+void *operator new(std::size_t size)
+{
+	YOSYS_NAMESPACE_PREFIX alloc_stats.account_alloc(size);
+	void *p;
+	while ((p = malloc(size ? size : 1)) == nullptr) {
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr)
+			throw std::bad_alloc();
+		handler();
+	}
+	return p;
+}
+
+void *operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+	YOSYS_NAMESPACE_PREFIX alloc_stats.account_free();
+	free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+	operator delete(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	operator delete(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+	operator delete(p);
+}
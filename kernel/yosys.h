@@ -45,6 +45,11 @@
 #include "kernel/rtlil.h"
 #include "kernel/register.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 YOSYS_NAMESPACE_BEGIN
 
 void yosys_setup();
@@ -69,6 +74,75 @@ const char *create_prompt(RTLIL::Design *design, int recursion_counter);
 std::vector<std::string> glob_filename(const std::string &filename_pattern);
 void rewrite_filename(std::string &filename);
 
+// Process-wide worker thread pool for passes that want to parallelize
+// CPU-bound per-cell or per-module work. Workers pull chunks of the index
+// space from a shared atomic counter, so load balances automatically across
+// items of very different cost.
+//
+// Rules for code running on pool workers:
+//
+//  - RTLIL must be treated as strictly read-only. Do not create, remove or
+//    rename wires/cells/modules, do not call connect()/setPort()/setParam()
+//    or anything else that dispatches monitor notifications.
+//  - Do not copy or construct IdStrings (including via SigSpec/SigBit
+//    temporaries that are not already interned) unless yosys was built with
+//    ENABLE_THREADSAFE_IDS: the default IdString refcounts are not atomic.
+//    Passing IdStrings by const reference and comparing them is fine.
+//  - Do not call log()/log_error() from workers; the log machinery is not
+//    thread-safe. Collect per-item results and report from the caller.
+//  - Queries that mutate shared caches (e.g. SigMap lookups do path
+//    compression) must be guarded by the caller or done upfront.
+//
+// Exceptions thrown by a work function are caught on the worker, and the
+// first one is re-thrown from parallel_for() on the calling thread.
+struct ThreadPool
+{
+	// returns the singleton pool, creating it on first use with the size
+	// configured via set_num_threads(), $YOSYS_NUM_THREADS, or the number
+	// of hardware threads (in that order of preference)
+	static ThreadPool &get();
+
+	// configures the pool size (0 = pick automatically). When the pool was
+	// already created it is torn down and rebuilt; must not be called while
+	// a parallel_for() is in flight.
+	static void set_num_threads(int num_threads);
+
+	// joins all workers and destroys the pool (called from yosys_shutdown)
+	static void destroy();
+
+	int num_threads() const { return GetSize(workers) + 1; }
+
+	// runs fn(index) for all 0 <= index < count and returns when every call
+	// has finished; the calling thread participates in the work. Nested
+	// calls from inside a work function run serially.
+	void parallel_for(int count, const std::function<void(int)> &fn);
+
+	// convenience wrapper: runs fn(item) for every item in the container
+	template<typename T, typename F>
+	void parallel_for_each(std::vector<T> &items, F fn) {
+		parallel_for(GetSize(items), [&](int index) { fn(items[index]); });
+	}
+
+	~ThreadPool();
+
+private:
+	ThreadPool(int num_threads_arg);
+	void run_chunks(const std::function<void(int)> &fn, int count);
+	void worker_main();
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable work_cv, done_cv;
+	const std::function<void(int)> *job_fn = nullptr;
+	std::atomic<int> job_next;
+	int job_count = 0;
+	int job_id_base = 0;
+	int job_running = 0;
+	uint64_t job_generation = 0;
+	std::exception_ptr job_exception;
+	bool shutdown_workers = false;
+};
+
 void run_pass(std::string command, RTLIL::Design *design = nullptr);
 bool run_frontend(std::string filename, std::string command, RTLIL::Design *design = nullptr, std::string *from_to_label = nullptr);
 void run_backend(std::string filename, std::string command, RTLIL::Design *design = nullptr);
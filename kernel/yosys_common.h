@@ -264,6 +264,40 @@ void memhasher_do();
 extern bool memhasher_active;
 inline void memhasher() { if (memhasher_active) memhasher_do(); }
 
+// Process-wide allocation accounting fed by the global operator new/delete
+// replacements in kernel/yosys.cc. Pass::pre_execute()/post_execute() in
+// kernel/register.cc snapshot the counters to attribute allocation calls and
+// requested bytes to the active command, for the pass profiler records
+// (YOSYS_PASS_PROFILE) and the per-pass allocation warning threshold
+// (YOSYS_ALLOC_WARN_MB). Counting is only active when one of those is
+// enabled, so the default cost per allocation is a single predicted branch.
+struct AllocStats
+{
+	bool enabled = false;
+	int64_t alloc_calls = 0;
+	int64_t alloc_bytes = 0;
+	int64_t free_calls = 0;
+
+	void account(int64_t &counter, int64_t n) {
+		if (!enabled)
+			return;
+	#ifdef YOSYS_THREADSAFE_IDS
+		__atomic_fetch_add(&counter, n, __ATOMIC_RELAXED);
+	#else
+		counter += n;
+	#endif
+	}
+	void account_alloc(size_t size) {
+		account(alloc_calls, 1);
+		account(alloc_bytes, (int64_t)size);
+	}
+	void account_free() {
+		account(free_calls, 1);
+	}
+};
+
+extern AllocStats alloc_stats;
+
 void yosys_banner();
 int ceil_log2(int x) YS_ATTRIBUTE(const);
 
@@ -324,6 +358,44 @@ inline std::string stringf(const char *fmt, ...)
 	return string;
 }
 
+// Typed alternative to stringf() for hot formatting paths (ID generation,
+// netlist emission). There is no format string to scan at run time: the
+// layout is fixed at compile time by the overloads the arguments select, and
+// all pieces are appended directly to the result buffer, bypassing
+// vsnprintf() entirely.
+inline void format_append_one(std::string &str, const char *v) { str += v; }
+inline void format_append_one(std::string &str, const std::string &v) { str += v; }
+inline void format_append_one(std::string &str, char v) { str += v; }
+inline void format_append_one(std::string &str, unsigned long long v)
+{
+	char buf[20], *p = buf + sizeof(buf);
+	do { *--p = '0' + v % 10; v /= 10; } while (v);
+	str.append(p, buf + sizeof(buf) - p);
+}
+inline void format_append_one(std::string &str, long long v)
+{
+	if (v < 0) {
+		str += '-';
+		format_append_one(str, -(unsigned long long)v);
+	} else
+		format_append_one(str, (unsigned long long)v);
+}
+inline void format_append_one(std::string &str, int v) { format_append_one(str, (long long)v); }
+inline void format_append_one(std::string &str, unsigned v) { format_append_one(str, (unsigned long long)v); }
+inline void format_append_one(std::string &str, long v) { format_append_one(str, (long long)v); }
+inline void format_append_one(std::string &str, unsigned long v) { format_append_one(str, (unsigned long long)v); }
+
+template<typename... Args>
+inline void format_append(std::string &str, const Args &...args) { (format_append_one(str, args), ...); }
+
+template<typename... Args>
+inline std::string format_cat(const Args &...args)
+{
+	std::string str;
+	format_append(str, args...);
+	return str;
+}
+
 int readsome(std::istream &f, char *s, int n);
 std::string next_token(std::string &text, const char *sep = " \t\r\n", bool long_strings = false);
 std::vector<std::string> split_tokens(const std::string &text, const char *sep = " \t\r\n");
@@ -20,6 +20,10 @@
 #include "kernel/yw.h"
 #include "libs/json11/json11.hpp"
 
+#ifdef YOSYS_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
 USING_YOSYS_NAMESPACE
 
 // Use the same formatting as witness.py uses
@@ -103,16 +107,256 @@ static std::vector<IdString> get_path(const json11::Json &json)
 	return result;
 }
 
+// Incremental scanner for witness JSON files. The header members (everything
+// except the "steps" array) are small and their raw text is handed to json11,
+// while the steps are decoded one frame at a time, so the JSON DOM of a
+// multi-million-cycle trace is never materialized in memory.
+struct YwJsonScanner
+{
+	std::istream &f;
+	const std::string &filename;
+
+	YwJsonScanner(std::istream &f, const std::string &filename) : f(f), filename(filename) {}
+
+	void parse_error(const std::string &msg)
+	{
+		log_error("Failed to parse `%s`: %s\n", filename.c_str(), msg.c_str());
+	}
+
+	int get()
+	{
+		int c = f.get();
+		if (c == EOF)
+			parse_error("unexpected end of file");
+		return c;
+	}
+
+	void skip_whitespace()
+	{
+		int c;
+		while ((c = f.peek()) == ' ' || c == '\t' || c == '\n' || c == '\r')
+			f.get();
+	}
+
+	// returns the next non-whitespace character without consuming it
+	int peek()
+	{
+		skip_whitespace();
+		int c = f.peek();
+		if (c == EOF)
+			parse_error("unexpected end of file");
+		return c;
+	}
+
+	void expect(char c)
+	{
+		if (peek() != c)
+			parse_error(stringf("expected '%c'", c));
+		f.get();
+	}
+
+	// reads a string token, appending its raw text (including quotes and
+	// escapes) to *raw and/or its unescaped value to *value
+	void parse_string(std::string *raw, std::string *value)
+	{
+		expect('"');
+		if (raw != nullptr)
+			raw->push_back('"');
+		while (1) {
+			int c = get();
+			if (raw != nullptr)
+				raw->push_back(c);
+			if (c == '"')
+				break;
+			if (c == '\\') {
+				int e = get();
+				if (raw != nullptr)
+					raw->push_back(e);
+				if (value != nullptr)
+					switch (e) {
+					case '"': case '\\': case '/': value->push_back(e); break;
+					case 'b': value->push_back('\b'); break;
+					case 'f': value->push_back('\f'); break;
+					case 'n': value->push_back('\n'); break;
+					case 'r': value->push_back('\r'); break;
+					case 't': value->push_back('\t'); break;
+					default: parse_error("unsupported escape sequence");
+					}
+			} else if (value != nullptr)
+				value->push_back(c);
+		}
+	}
+
+	// skips one value of any type, appending its raw text to *raw when given
+	void parse_value(std::string *raw)
+	{
+		int c = peek();
+		if (c == '"') {
+			parse_string(raw, nullptr);
+			return;
+		}
+		if (c == '{' || c == '[') {
+			char close = c == '{' ? '}' : ']';
+			f.get();
+			if (raw != nullptr)
+				raw->push_back(c);
+			if (peek() == close) {
+				f.get();
+				if (raw != nullptr)
+					raw->push_back(close);
+				return;
+			}
+			while (1) {
+				if (c == '{') {
+					parse_string(raw, nullptr);
+					expect(':');
+					if (raw != nullptr)
+						raw->push_back(':');
+				}
+				parse_value(raw);
+				int sep = peek();
+				f.get();
+				if (raw != nullptr)
+					raw->push_back(sep);
+				if (sep == close)
+					break;
+				if (sep != ',')
+					parse_error(stringf("expected ',' or '%c'", close));
+			}
+			return;
+		}
+		// number, true, false or null
+		int size = 0;
+		while ((c = f.peek()) != EOF && c != ',' && c != '}' && c != ']' &&
+				c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+			f.get();
+			if (raw != nullptr)
+				raw->push_back(c);
+			size++;
+		}
+		if (size == 0)
+			parse_error("unexpected character");
+	}
+};
+
+void ReadWitness::append_step(const std::string &bits)
+{
+	for (char c : bits) {
+		if (c != '0' && c != '1' && c != 'x' && c != '?')
+			log_error("Failed to parse `%s`: Invalid bit '%c' value for step %d\n", filename.c_str(), c, GetSize(steps));
+	}
+
+	// pack two bits per character, four characters per byte
+	std::string packed((bits.size() + 3) / 4, '\0');
+	for (int i = 0; i < GetSize(bits); i++) {
+		int code = 0;
+		switch (bits[i]) {
+			case '0': code = 0; break;
+			case '1': code = 1; break;
+			case 'x': code = 2; break;
+			case '?': code = 3; break;
+		}
+		packed[i >> 2] |= code << ((i & 3) * 2);
+	}
+
+	bool compressed = false;
+#ifdef YOSYS_ENABLE_ZLIB
+	if (GetSize(packed) > 64) {
+		uLongf dest_len = compressBound(packed.size());
+		std::string buf(dest_len, '\0');
+		if (compress2((Bytef *)&buf[0], &dest_len, (const Bytef *)packed.data(), packed.size(), Z_BEST_SPEED) == Z_OK &&
+				dest_len < packed.size()) {
+			buf.resize(dest_len);
+			packed = std::move(buf);
+			compressed = true;
+		}
+	}
+#endif
+
+	Step step;
+	step.packed_bits = std::move(packed);
+	step.num_bits = GetSize(bits);
+	step.compressed = compressed;
+	steps.push_back(std::move(step));
+}
+
 ReadWitness::ReadWitness(const std::string &filename) :
 	filename(filename)
 {
 	std::ifstream f(filename.c_str());
 	if (f.fail() || GetSize(filename) == 0)
 		log_error("Cannot open file `%s`\n", filename.c_str());
-	std::stringstream buf;
-	buf << f.rdbuf();
+
+	YwJsonScanner scanner(f, filename);
+	std::string header = "{";
+	bool first_member = true;
+
+	scanner.expect('{');
+	if (scanner.peek() == '}') {
+		f.get();
+	} else while (1) {
+		std::string raw_key, key;
+		scanner.parse_string(&raw_key, &key);
+		scanner.expect(':');
+		if (key == "steps") {
+			scanner.expect('[');
+			if (scanner.peek() == ']') {
+				f.get();
+			} else while (1) {
+				std::string bits;
+				bool has_bits = false;
+				scanner.expect('{');
+				if (scanner.peek() == '}') {
+					f.get();
+				} else while (1) {
+					std::string step_key;
+					scanner.parse_string(nullptr, &step_key);
+					scanner.expect(':');
+					if (step_key == "bits" && scanner.peek() == '"') {
+						scanner.parse_string(nullptr, &bits);
+						has_bits = true;
+					} else
+						scanner.parse_value(nullptr);
+					int sep = scanner.peek();
+					f.get();
+					if (sep == '}')
+						break;
+					if (sep != ',')
+						scanner.parse_error("expected ',' or '}'");
+				}
+				if (!has_bits)
+					log_error("Failed to parse `%s`: Expected string as bits value for step %d\n", filename.c_str(), GetSize(steps));
+				append_step(bits);
+				int sep = scanner.peek();
+				f.get();
+				if (sep == ']')
+					break;
+				if (sep != ',')
+					scanner.parse_error("expected ',' or ']'");
+			}
+		} else {
+			if (!first_member)
+				header += ',';
+			first_member = false;
+			header += raw_key;
+			header += ':';
+			scanner.parse_value(&header);
+		}
+		int sep = scanner.peek();
+		f.get();
+		if (sep == '}')
+			break;
+		if (sep != ',')
+			scanner.parse_error("expected ',' or '}'");
+	}
+	header += '}';
+
+	scanner.skip_whitespace();
+	if (f.peek() != EOF)
+		scanner.parse_error("unexpected trailing data");
+
 	std::string err;
-	json11::Json json = json11::Json::parse(buf.str(), err);
+	json11::Json json = json11::Json::parse(header, err);
 	if (!err.empty())
 		log_error("Failed to parse `%s`: %s\n", filename.c_str(), err.c_str());
 
@@ -165,24 +409,45 @@ ReadWitness::ReadWitness(const std::string &filename) :
 		signals.push_back(signal);
 	}
 
-	for (auto &step_json : json["steps"].array_items()) {
-		Step step;
-		if (!step_json["bits"].is_string())
-			log_error("Failed to parse `%s`: Expected string as bits value for step %d\n", filename.c_str(), GetSize(steps));
-		step.bits = step_json["bits"].string_value();
-		for (char c : step.bits) {
-			if (c != '0' && c != '1' && c != 'x' && c != '?')
-				log_error("Failed to parse `%s`: Invalid bit '%c' value for step %d\n", filename.c_str(), c, GetSize(steps));
-		}
-		steps.push_back(step);
+}
+
+const std::string &ReadWitness::get_step_bits(int t) const
+{
+	log_assert(t >= 0 && t < GetSize(steps));
+
+	if (unpacked_cache_step == t)
+		return unpacked_cache;
+
+	const Step &step = steps[t];
+	const std::string *packed = &step.packed_bits;
+
+#ifdef YOSYS_ENABLE_ZLIB
+	std::string inflated;
+	if (step.compressed) {
+		inflated.resize((step.num_bits + 3) / 4);
+		uLongf dest_len = inflated.size();
+		if (uncompress((Bytef *)&inflated[0], &dest_len, (const Bytef *)step.packed_bits.data(), step.packed_bits.size()) != Z_OK ||
+				dest_len != inflated.size())
+			log_error("Failed to decompress step %d of `%s`\n", t, filename.c_str());
+		packed = &inflated;
 	}
+#else
+	log_assert(!step.compressed);
+#endif
+
+	unpacked_cache.resize(step.num_bits);
+	for (int i = 0; i < step.num_bits; i++)
+		unpacked_cache[i] = "01x?"[((unsigned char)(*packed)[i >> 2] >> ((i & 3) * 2)) & 3];
+	unpacked_cache_step = t;
+
+	return unpacked_cache;
 }
 
 RTLIL::Const ReadWitness::get_bits(int t, int bits_offset, int width) const
 {
 	log_assert(t >= 0 && t < GetSize(steps));
 
-	const std::string &bits = steps[t].bits;
+	const std::string &bits = get_step_bits(t);
 
 	RTLIL::Const result(State::Sa, width);
 	result.bits.reserve(width);
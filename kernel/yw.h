@@ -83,7 +83,12 @@ struct ReadWitness
 	};
 
 	struct Step {
-		std::string bits;
+		// the step's bit string packed two bits per "01x?" character and
+		// deflate-compressed when that saves space. Use get_step_bits() to
+		// access the unpacked character representation of a step.
+		std::string packed_bits;
+		int num_bits;
+		bool compressed;
 	};
 
 	std::string filename;
@@ -94,6 +99,15 @@ struct ReadWitness
 	ReadWitness(const std::string &filename);
 
 	RTLIL::Const get_bits(int t, int bits_offset, int width) const;
+	const std::string &get_step_bits(int t) const;
+
+private:
+	void append_step(const std::string &bits);
+
+	// unpacked bits of the most recently accessed step, so that sequential
+	// replay decodes each frame only once
+	mutable std::string unpacked_cache;
+	mutable int unpacked_cache_step = -1;
 };
 
 template<typename D, typename T>
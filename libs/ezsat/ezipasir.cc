@@ -0,0 +1,149 @@
+/*
+ *  ezSAT -- A simple and easy to use CNF generator for SAT solvers
+ *
+ *  Copyright (C) 2013  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "ezipasir.h"
+
+#ifdef YOSYS_ENABLE_PLUGINS
+#  include <dlfcn.h>
+#endif
+
+ezIpasir::ezIpasir(const std::string &library) :
+		soHandle(NULL), ipasirSolver(NULL), fn_signature(NULL), fn_init(NULL), fn_release(NULL),
+		fn_add(NULL), fn_assume(NULL), fn_solve(NULL), fn_val(NULL), fn_set_terminate(NULL),
+		libraryName(library), timeoutDeadline(0)
+{
+#ifdef YOSYS_ENABLE_PLUGINS
+	soHandle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+	if (soHandle == NULL) {
+		const char *err = dlerror();
+		errorMessage = err != NULL ? err : "dlopen() failed";
+		return;
+	}
+
+	struct { const char *name; void **slot; } symbols[] = {
+		{ "ipasir_signature", (void**)&fn_signature },
+		{ "ipasir_init", (void**)&fn_init },
+		{ "ipasir_release", (void**)&fn_release },
+		{ "ipasir_add", (void**)&fn_add },
+		{ "ipasir_assume", (void**)&fn_assume },
+		{ "ipasir_solve", (void**)&fn_solve },
+		{ "ipasir_val", (void**)&fn_val },
+		{ "ipasir_set_terminate", (void**)&fn_set_terminate },
+	};
+
+	for (auto &sym : symbols) {
+		*sym.slot = dlsym(soHandle, sym.name);
+		if (*sym.slot == NULL) {
+			errorMessage = std::string("missing symbol ") + sym.name;
+			return;
+		}
+	}
+
+	solverSignature = fn_signature();
+#else
+	errorMessage = "dynamic loading of IPASIR solvers requires a build with plugin support";
+#endif
+}
+
+ezIpasir::~ezIpasir()
+{
+#ifdef YOSYS_ENABLE_PLUGINS
+	if (ipasirSolver != NULL)
+		fn_release(ipasirSolver);
+	if (soHandle != NULL)
+		dlclose(soHandle);
+#endif
+}
+
+void ezIpasir::clear()
+{
+	if (ipasirSolver != NULL) {
+		fn_release(ipasirSolver);
+		ipasirSolver = NULL;
+	}
+	ezSAT::clear();
+}
+
+int ezIpasir::terminateCallback(void *state)
+{
+	ezIpasir *that = (ezIpasir*)state;
+	return that->timeoutDeadline != 0 && clock() > that->timeoutDeadline ? 1 : 0;
+}
+
+bool ezIpasir::solver(const std::vector<int> &modelExpressions, std::vector<bool> &modelValues, const std::vector<int> &assumptions)
+{
+	preSolverCallback();
+
+	solverTimoutStatus = false;
+
+	if (failed())
+		return false;
+
+	std::vector<int> extraClauses, modelIdx;
+
+	for (auto id : assumptions)
+		extraClauses.push_back(bind(id));
+	for (auto id : modelExpressions)
+		modelIdx.push_back(bind(id));
+
+	if (ipasirSolver == NULL)
+		ipasirSolver = fn_init();
+
+	// ezSAT CNF literals are signed 1-based variable indices, which is
+	// exactly the DIMACS convention IPASIR uses. No renaming needed.
+	std::vector<std::vector<int>> cnf;
+	consumeCnf(cnf);
+
+	for (auto &clause : cnf) {
+		for (auto idx : clause)
+			fn_add(ipasirSolver, idx);
+		fn_add(ipasirSolver, 0);
+	}
+
+	for (auto idx : extraClauses)
+		fn_assume(ipasirSolver, idx);
+
+	timeoutDeadline = solverTimeout > 0 ? clock() + clock_t(solverTimeout) * CLOCKS_PER_SEC : 0;
+	fn_set_terminate(ipasirSolver, this, terminateCallback);
+
+	int result = fn_solve(ipasirSolver);
+
+	if (result != 10) {
+		if (result != 20)
+			solverTimoutStatus = true;
+		return false;
+	}
+
+	modelValues.clear();
+	modelValues.resize(modelIdx.size());
+
+	for (size_t i = 0; i < modelIdx.size(); i++)
+	{
+		int idx = modelIdx[i];
+		bool refvalue = true;
+
+		if (idx < 0)
+			idx = -idx, refvalue = false;
+
+		int32_t value = fn_val(ipasirSolver, idx);
+		modelValues[i] = value != 0 && (value > 0) == refvalue;
+	}
+
+	return true;
+}
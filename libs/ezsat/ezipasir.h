@@ -0,0 +1,68 @@
+/*
+ *  ezSAT -- A simple and easy to use CNF generator for SAT solvers
+ *
+ *  Copyright (C) 2013  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef EZIPASIR_H
+#define EZIPASIR_H
+
+#include "ezsat.h"
+#include <stdint.h>
+#include <time.h>
+
+// Backend for external solver libraries implementing the IPASIR incremental
+// SAT interface (cadical, kissat, lingeling, ...). The shared library is
+// loaded with dlopen() at construction time and stays open for the lifetime
+// of this object. Construction can fail (library not found, symbols missing,
+// dynamic loading not available); callers must check failed() before use.
+
+class ezIpasir : public ezSAT
+{
+private:
+	void *soHandle;
+	void *ipasirSolver;
+
+	const char *(*fn_signature)();
+	void *(*fn_init)();
+	void (*fn_release)(void *solver);
+	void (*fn_add)(void *solver, int32_t lit);
+	void (*fn_assume)(void *solver, int32_t lit);
+	int (*fn_solve)(void *solver);
+	int32_t (*fn_val)(void *solver, int32_t lit);
+	void (*fn_set_terminate)(void *solver, void *state, int (*terminate)(void *state));
+
+	std::string libraryName;
+	std::string solverSignature;
+	std::string errorMessage;
+
+	clock_t timeoutDeadline;
+	static int terminateCallback(void *state);
+
+public:
+	ezIpasir(const std::string &library);
+	virtual ~ezIpasir();
+
+	bool failed() const { return !errorMessage.empty(); }
+	const std::string &error() const { return errorMessage; }
+	const std::string &signature() const { return solverSignature; }
+	const std::string &library() const { return libraryName; }
+
+	virtual void clear();
+	virtual bool solver(const std::vector<int> &modelExpressions, std::vector<bool> &modelValues, const std::vector<int> &assumptions);
+};
+
+#endif
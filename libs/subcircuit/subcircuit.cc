@@ -288,7 +288,21 @@ class SubCircuit::SolverWorker
 {
 	// basic internal data structures
 
-	typedef std::vector<std::map<int, int>> adjMatrix_t;
+	// One row of the adjacency structure: the (neighbour index, edge type)
+	// pairs for one node, sorted by neighbour index. The rows are built once
+	// per graph and only read afterwards; the flat sorted layout avoids the
+	// pointer chasing of per-node std::maps in the innermost matching loops.
+	typedef std::vector<std::pair<int, int>> adjRow_t;
+	typedef std::vector<adjRow_t> adjMatrix_t;
+
+	// returns the edge type for the given neighbour, or -1 if not adjacent
+	static int adjLookup(const adjRow_t &row, int neighbour)
+	{
+		auto it = std::lower_bound(row.begin(), row.end(), std::pair<int, int>(neighbour, 0));
+		if (it == row.end() || it->first != neighbour)
+			return -1;
+		return it->second;
+	}
 
 	struct GraphData {
 		std::string graphId;
@@ -305,11 +319,13 @@ class SubCircuit::SolverWorker
 		my_printf("\n");
 		for (int i = 0; i < int(matrix.size()); i++) {
 			my_printf("%5d:", i);
-			for (int j = 0; j < int(matrix.size()); j++)
-				if (matrix.at(i).count(j) == 0)
+			for (int j = 0; j < int(matrix.size()); j++) {
+				int edgeType = adjLookup(matrix.at(i), j);
+				if (edgeType < 0)
 					my_printf("%5s", "-");
 				else
-					my_printf("%5d", matrix.at(i).at(j));
+					my_printf("%5d", edgeType);
+			}
 			my_printf("\n");
 		}
 	}
@@ -655,7 +671,10 @@ class SubCircuit::SolverWorker
 	{
 		std::map<DiEdge, int> edgeTypesMap;
 		std::vector<DiEdge> edgeTypes;
-		std::map<std::pair<int, int>, bool> compareCache;
+
+		// memoized compare() results, indexed [needleEdgeType][haystackEdgeType]
+		// (-1 = not computed yet); grown on demand
+		std::vector<std::vector<signed char>> compareCache;
 
 		void add(const Graph &graph, adjMatrix_t &adjMatrix, const std::string &graphId, Solver *userSolver)
 		{
@@ -671,22 +690,28 @@ class SubCircuit::SolverWorker
 				it.second.userAnnotation = userSolver->userAnnotateEdge(graphId, fromNode.nodeId, fromNode.userData, toNode.nodeId, toNode.userData);
 			}
 
+			// `edges` is iterated in (from, to) key order, so the adjacency
+			// rows are built already sorted by neighbour index.
 			for (const auto &it : edges) {
 				if (edgeTypesMap.count(it.second) == 0) {
 					edgeTypesMap[it.second] = edgeTypes.size();
 					edgeTypes.push_back(it.second);
 				}
-				adjMatrix[it.first.first][it.first.second] = edgeTypesMap[it.second];
+				adjMatrix[it.first.first].push_back(std::pair<int, int>(it.first.second, edgeTypesMap[it.second]));
 			}
 		}
 
 		bool compare(int needleEdge, int haystackEdge, const std::map<std::string, std::set<std::set<std::string>>> &swapPorts,
 				const std::map<std::string, std::set<std::map<std::string, std::string>>> &swapPermutations)
 		{
-			std::pair<int, int> key(needleEdge, haystackEdge);
-			if (!compareCache.count(key))
-				compareCache[key] = edgeTypes.at(needleEdge).compare(edgeTypes.at(haystackEdge), swapPorts, swapPermutations);
-			return compareCache[key];
+			if (int(compareCache.size()) <= needleEdge)
+				compareCache.resize(needleEdge+1);
+			std::vector<signed char> &row = compareCache[needleEdge];
+			if (int(row.size()) <= haystackEdge)
+				row.resize(haystackEdge+1, -1);
+			if (row[haystackEdge] < 0)
+				row[haystackEdge] = edgeTypes.at(needleEdge).compare(edgeTypes.at(haystackEdge), swapPorts, swapPermutations) ? 1 : 0;
+			return row[haystackEdge] != 0;
 		}
 
 		bool compare(int needleEdge, int haystackEdge, const std::map<std::string, std::string> &mapFromPorts, const std::map<std::string, std::set<std::set<std::string>>> &swapPorts,
@@ -887,9 +912,9 @@ class SubCircuit::SolverWorker
 			int needleNeighbour = it_needle.first;
 			int needleEdgeType = it_needle.second;
 
-			for (int haystackNeighbour : enumerationMatrix[needleNeighbour])
-				if (haystack.adjMatrix.at(j).count(haystackNeighbour) > 0) {
-					int haystackEdgeType = haystack.adjMatrix.at(j).at(haystackNeighbour);
+			for (int haystackNeighbour : enumerationMatrix[needleNeighbour]) {
+				int haystackEdgeType = adjLookup(haystack.adjMatrix.at(j), haystackNeighbour);
+				if (haystackEdgeType >= 0) {
 					if (diCache.compare(needleEdgeType, haystackEdgeType, swapPorts, swapPermutations)) {
 						const Graph::Node &needleFromNode = needle.graph.nodes[i];
 						const Graph::Node &needleToNode = needle.graph.nodes[needleNeighbour];
@@ -900,6 +925,7 @@ class SubCircuit::SolverWorker
 							goto found_match;
 					}
 				}
+			}
 
 			return false;
 		found_match:;
@@ -980,8 +1006,8 @@ class SubCircuit::SolverWorker
 			assert(enumerationMatrix[needleNeighbour].size() == 1);
 			int haystackNeighbour = *enumerationMatrix[needleNeighbour].begin();
 
-			assert(haystack.adjMatrix.at(idxHaystack).count(haystackNeighbour) > 0);
-			int haystackEdgeType = haystack.adjMatrix.at(idxHaystack).at(haystackNeighbour);
+			int haystackEdgeType = adjLookup(haystack.adjMatrix.at(idxHaystack), haystackNeighbour);
+			assert(haystackEdgeType >= 0);
 			if (!diCache.compare(needleEdgeType, haystackEdgeType, currentCandidate, swapPorts, swapPermutations))
 				return false;
 		}
@@ -1063,8 +1089,8 @@ class SubCircuit::SolverWorker
 					assert(enumerationMatrix[needleNeighbour].size() == 1);
 					int haystackNeighbour = *enumerationMatrix[needleNeighbour].begin();
 
-					assert(haystack.adjMatrix.at(j).count(haystackNeighbour) > 0);
-					int haystackEdgeType = haystack.adjMatrix.at(j).at(haystackNeighbour);
+					int haystackEdgeType = adjLookup(haystack.adjMatrix.at(j), haystackNeighbour);
+					assert(haystackEdgeType >= 0);
 
 					std::set<std::map<std::string, std::string>> &candidates =
 							i == needleNeighbour ? thisCandidates : portmapCandidates[needleNeighbour];
@@ -92,21 +92,34 @@ struct BugpointPass : public Pass {
 		log("    -runner \"<prefix>\"\n");
 		log("        child process wrapping command, e.g., \"timeout 30\", or valgrind.\n");
 		log("\n");
+		log("    -jobs <N>\n");
+		log("        test up to N candidate simplifications in concurrent child processes.\n");
+		log("        the crashing candidate with the lowest index wins, so the produced\n");
+		log("        testcase is the same as with a sequential run. (default = 1)\n");
+		log("\n");
 	}
 
-	bool run_yosys(RTLIL::Design *design, string runner, string yosys_cmd, string yosys_arg)
+	void write_testcase(RTLIL::Design *design, string label)
 	{
 		design->sort();
 
-		std::ofstream f("bugpoint-case.il");
+		std::ofstream f(label + ".il");
 		RTLIL_BACKEND::dump_design(f, design, /*only_selected=*/false, /*flag_m=*/true, /*flag_n=*/false);
 		f.close();
+	}
+
+	string yosys_cmdline(string runner, string yosys_cmd, string yosys_arg, string label)
+	{
+		return stringf("%s %s -qq -L %s.log %s %s.il", runner.c_str(), yosys_cmd.c_str(), label.c_str(), yosys_arg.c_str(), label.c_str());
+	}
 
-		string yosys_cmdline = stringf("%s %s -qq -L bugpoint-case.log %s bugpoint-case.il", runner.c_str(), yosys_cmd.c_str(), yosys_arg.c_str());
-		return run_command(yosys_cmdline) == 0;
+	bool run_yosys(RTLIL::Design *design, string runner, string yosys_cmd, string yosys_arg, string label = "bugpoint-case")
+	{
+		write_testcase(design, label);
+		return run_command(yosys_cmdline(runner, yosys_cmd, yosys_arg, label)) == 0;
 	}
 
-	bool check_logfile(string grep)
+	bool check_logfile(string grep, string label = "bugpoint-case")
 	{
 		if (grep.empty())
 			return true;
@@ -114,7 +127,7 @@ struct BugpointPass : public Pass {
 		if (grep.size() > 2 && grep.front() == '"' && grep.back() == '"')
 			grep = grep.substr(1, grep.size() - 2);
 
-		std::ifstream f("bugpoint-case.log");
+		std::ifstream f(label + ".log");
 		while (!f.eof())
 		{
 			string line;
@@ -400,6 +413,7 @@ struct BugpointPass : public Pass {
 	void execute(std::vector<std::string> args, RTLIL::Design *design) override
 	{
 		string yosys_cmd = "yosys", yosys_arg, grep, runner;
+		int jobs = 1;
 		bool fast = false, clean = false;
 		bool modules = false, ports = false, cells = false, connections = false, processes = false, assigns = false, updates = false, wires = false, has_part = false;
 
@@ -485,6 +499,10 @@ struct BugpointPass : public Pass {
 				}
 				continue;
 			}
+			if (args[argidx] == "-jobs" && argidx + 1 < args.size()) {
+				jobs = max(1, atoi(args[++argidx].c_str()));
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
@@ -517,36 +535,80 @@ struct BugpointPass : public Pass {
 		bool found_something = false, stage2 = false;
 		while (true)
 		{
-			if (RTLIL::Design *simplified = simplify_something(crashing_design, seed, stage2, modules, ports, cells, connections, processes, assigns, updates, wires))
+			// speculatively produce up to <jobs> candidates from the same base
+			// design, for seeds seed, seed+1, ... (candidate generation and the
+			// cleanup passes have to stay on this thread; only the child
+			// processes run concurrently)
+			std::vector<RTLIL::Design*> candidates;
+			for (int i = 0; i < jobs; i++)
 			{
-				simplified = clean_design(simplified, fast, /*do_delete=*/true);
+				int candidate_seed = seed + i;
+				RTLIL::Design *simplified = simplify_something(crashing_design, candidate_seed, stage2, modules, ports, cells, connections, processes, assigns, updates, wires);
+				if (simplified == nullptr)
+					break;
+				candidates.push_back(clean_design(simplified, fast, /*do_delete=*/true));
+			}
 
-				bool crashes;
-				if (clean)
+			if (!candidates.empty())
+			{
+				std::vector<string> labels, cmdlines;
+				for (int i = 0; i < GetSize(candidates); i++)
 				{
-					RTLIL::Design *testcase = clean_design(simplified);
-					crashes = !run_yosys(testcase, runner, yosys_cmd, yosys_arg);
-					delete testcase;
+					labels.push_back(GetSize(candidates) == 1 ? "bugpoint-case" : stringf("bugpoint-case-%d", i));
+					if (clean)
+					{
+						RTLIL::Design *testcase = clean_design(candidates[i]);
+						write_testcase(testcase, labels[i]);
+						delete testcase;
+					}
+					else
+					{
+						write_testcase(candidates[i], labels[i]);
+					}
+					cmdlines.push_back(yosys_cmdline(runner, yosys_cmd, yosys_arg, labels[i]));
+				}
+
+				std::vector<int> results(GetSize(candidates));
+				if (GetSize(candidates) == 1)
+				{
+					results[0] = run_command(cmdlines[0]);
 				}
 				else
 				{
-					crashes = !run_yosys(simplified, runner, yosys_cmd, yosys_arg);
+					std::vector<std::thread> threads;
+					for (int i = 0; i < GetSize(cmdlines); i++)
+						threads.emplace_back([&results, &cmdlines, i]() { results[i] = run_command(cmdlines[i]); });
+					for (auto &thread : threads)
+						thread.join();
 				}
 
-				if (crashes && check_logfile(grep))
+				// adopting the crashing candidate with the lowest seed makes the
+				// result identical to testing the candidates one at a time
+				int crashing_idx = -1;
+				for (int i = 0; i < GetSize(candidates); i++)
+					if (results[i] != 0 && check_logfile(grep, labels[i])) {
+						crashing_idx = i;
+						break;
+					}
+
+				if (crashing_idx >= 0)
 				{
 					log("Testcase crashes.\n");
 					if (crashing_design != design)
 						delete crashing_design;
-					crashing_design = simplified;
+					crashing_design = candidates[crashing_idx];
+					candidates[crashing_idx] = nullptr;
+					seed += crashing_idx;
 					found_something = true;
 				}
 				else
 				{
 					log("Testcase does not crash.\n");
-					delete simplified;
-					seed++;
+					seed += GetSize(candidates);
 				}
+
+				for (auto candidate : candidates)
+					delete candidate;
 			}
 			else
 			{
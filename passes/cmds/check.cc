@@ -26,6 +26,19 @@
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
+// Modules that came out of a check run without problems, together with the
+// change counter and option set at that time. Scripts run check between
+// stages as a safety net; while a module's change counter has not moved
+// since it was last found clean, re-checking it with the same options can
+// only reproduce the same (empty) report, so it is skipped. Mutations that
+// bypass the Module/Cell API do not bump the counter and are not detected;
+// use 'check -full' to force a complete re-check.
+struct CleanCheck {
+	uint64_t change_count;
+	int options;
+};
+static std::map<RTLIL::Design*, dict<RTLIL::IdString, CleanCheck>> clean_check_cache;
+
 struct CheckPass : public Pass {
 	CheckPass() : Pass("check", "check for obvious problems in the design") { }
 	void help() override
@@ -59,6 +72,12 @@ struct CheckPass : public Pass {
 		log("    -assert\n");
 		log("        produce a runtime error if any problems are found in the current design\n");
 		log("\n");
+		log("    -full\n");
+		log("        re-check all selected modules. By default modules that were found\n");
+		log("        clean by a previous check run with the same options and have not been\n");
+		log("        modified since are skipped. (Modifications that bypass the RTLIL API\n");
+		log("        are not detected; use this option when in doubt.)\n");
+		log("\n");
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) override
 	{
@@ -68,6 +87,7 @@ struct CheckPass : public Pass {
 		bool mapped = false;
 		bool allow_tbuf = false;
 		bool assert_mode = false;
+		bool full_mode = false;
 
 		size_t argidx;
 		for (argidx = 1; argidx < args.size(); argidx++) {
@@ -91,14 +111,35 @@ struct CheckPass : public Pass {
 				assert_mode = true;
 				continue;
 			}
+			if (args[argidx] == "-full") {
+				full_mode = true;
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
 
 		log_header(design, "Executing CHECK pass (checking for obvious problems).\n");
 
+		int options = (noinit ? 1 : 0) | (initdrv ? 2 : 0) | (mapped ? 4 : 0) | (allow_tbuf ? 8 : 0);
+
+		if (clean_check_cache.count(design) == 0 && GetSize(clean_check_cache) > 1000)
+			clean_check_cache.clear();
+		dict<RTLIL::IdString, CleanCheck> &clean_cache = clean_check_cache[design];
+
 		for (auto module : design->selected_whole_modules_warn())
 		{
+			if (!full_mode) {
+				auto it = clean_cache.find(module->name);
+				if (it != clean_cache.end() && it->second.change_count == module->change_count() &&
+						it->second.options == options) {
+					log("Skipping module %s (unchanged since last clean check).\n", log_id(module));
+					continue;
+				}
+			}
+
+			int module_start_counter = counter;
+
 			log("Checking module %s...\n", log_id(module));
 
 			SigMap sigmap(module);
@@ -154,6 +195,7 @@ struct CheckPass : public Pass {
 			struct CircuitEdgesDatabase : AbstractCellEdgesDatabase {
 				TopoSort<std::pair<RTLIL::IdString, int>> &topo;
 				SigMap sigmap;
+				CellEdgesCache edges_cache;
 
 				CircuitEdgesDatabase(TopoSort<std::pair<RTLIL::IdString, int>> &topo, SigMap &sigmap)
 					: topo(topo), sigmap(sigmap) {}
@@ -172,7 +214,7 @@ struct CheckPass : public Pass {
 				}
 
 				bool add_edges_from_cell(Cell *cell) {
-					if (AbstractCellEdgesDatabase::add_edges_from_cell(cell))
+					if (edges_cache.add_edges_from_cell(this, cell))
 						return true;
 
 					// We don't have accurate cell edges, do the fallback of all input-output pairs
@@ -372,6 +414,11 @@ struct CheckPass : public Pass {
 					counter++;
 				}
 			}
+
+			if (counter == module_start_counter)
+				clean_cache[module->name] = CleanCheck{module->change_count(), options};
+			else
+				clean_cache.erase(module->name);
 		}
 
 		log("Found and reported %d problems.\n", counter);
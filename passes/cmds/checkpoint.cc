@@ -0,0 +1,267 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/yosys.h"
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+// Incremental design snapshots for interactive what-if exploration. Unlike
+// `design -push`, which copies the whole design, a checkpoint only clones
+// the modules whose change counter moved since the previous checkpoint and
+// shares the stored clones of everything else, so marks on a big design are
+// cheap once the first one exists. Undo likewise only replaces the modules
+// that actually diverged from the mark.
+
+struct DesignCheckpoint
+{
+	struct ModuleSnap {
+		std::shared_ptr<RTLIL::Module> module; // detached clone
+		RTLIL::Module *live_module = nullptr;  // live object the clone was taken from
+		uint64_t change_count = 0;             // live counter when snapped
+	};
+	dict<RTLIL::IdString, ModuleSnap> modules;
+};
+
+struct CheckpointStacks
+{
+	std::vector<DesignCheckpoint> undo_stack;
+	std::unique_ptr<DesignCheckpoint> redo_snap;
+};
+
+static std::map<RTLIL::Design*, CheckpointStacks> checkpoint_state;
+
+static DesignCheckpoint take_snapshot(RTLIL::Design *design, const DesignCheckpoint *prev, int &cloned, int &shared)
+{
+	DesignCheckpoint cp;
+	for (auto module : design->modules()) {
+		DesignCheckpoint::ModuleSnap snap;
+		const DesignCheckpoint::ModuleSnap *old_snap = nullptr;
+		if (prev != nullptr) {
+			auto it = prev->modules.find(module->name);
+			if (it != prev->modules.end())
+				old_snap = &it->second;
+		}
+		// the change counter restarts when a module is deleted and
+		// re-created under the same name, so an equal counter is only
+		// trusted when it belongs to the very object that was snapped
+		if (old_snap != nullptr && old_snap->live_module == module &&
+				old_snap->change_count == module->change_count()) {
+			snap = *old_snap;
+			shared++;
+		} else {
+			snap.module.reset(module->clone());
+			snap.live_module = module;
+			snap.change_count = module->change_count();
+			cloned++;
+		}
+		cp.modules[module->name] = snap;
+	}
+	return cp;
+}
+
+static void restore_snapshot(RTLIL::Design *design, DesignCheckpoint &cp, int &restored, int &removed)
+{
+	std::vector<RTLIL::Module*> doomed;
+	for (auto module : design->modules())
+		if (cp.modules.count(module->name) == 0)
+			doomed.push_back(module);
+	for (auto module : doomed) {
+		design->remove(module);
+		removed++;
+	}
+
+	for (auto &it : cp.modules) {
+		RTLIL::Module *live = design->module(it.first);
+		if (live != nullptr && live == it.second.live_module && live->change_count() == it.second.change_count)
+			continue;
+		if (live != nullptr)
+			design->remove(live);
+		RTLIL::Module *module = it.second.module->clone();
+		design->add(module);
+		// the restored module now matches the snapshot; track the fresh
+		// object and counter so later undos and checkpoints see it as
+		// unchanged
+		it.second.live_module = module;
+		it.second.change_count = module->change_count();
+		restored++;
+	}
+}
+
+struct CheckpointPass : public Pass {
+	CheckpointPass() : Pass("checkpoint", "create an in-memory design checkpoint") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    checkpoint [-pop] [-list]\n");
+		log("\n");
+		log("Push an in-memory snapshot of the current design onto the checkpoint stack.\n");
+		log("The `undo' command later brings the design back to the most recent checkpoint,\n");
+		log("which is much faster than re-reading a design file after a destructive\n");
+		log("experiment.\n");
+		log("\n");
+		log("Checkpoints are incremental: only modules modified (through the Module/Cell\n");
+		log("API) since the previous checkpoint are cloned, all other modules share the\n");
+		log("already stored clones. The first checkpoint therefore clones every module;\n");
+		log("later ones are cheap.\n");
+		log("\n");
+		log("    -pop\n");
+		log("        discard the most recent checkpoint instead of creating one\n");
+		log("\n");
+		log("    -list\n");
+		log("        list the checkpoints held for this design\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		bool pop_mode = false, list_mode = false;
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++) {
+			if (args[argidx] == "-pop") {
+				pop_mode = true;
+				continue;
+			}
+			if (args[argidx] == "-list") {
+				list_mode = true;
+				continue;
+			}
+			break;
+		}
+		if (argidx != args.size())
+			cmd_error(args, argidx, "Extra argument.");
+
+		CheckpointStacks &stacks = checkpoint_state[design];
+
+		if (list_mode) {
+			log("%d checkpoints on stack.\n", GetSize(stacks.undo_stack));
+			for (int i = 0; i < GetSize(stacks.undo_stack); i++)
+				log("  checkpoint %d: %d modules\n", i, GetSize(stacks.undo_stack[i].modules));
+			return;
+		}
+
+		if (pop_mode) {
+			if (stacks.undo_stack.empty())
+				log_cmd_error("No checkpoint to pop.\n");
+			stacks.undo_stack.pop_back();
+			stacks.redo_snap.reset();
+			log("Popped checkpoint, %d left on stack.\n", GetSize(stacks.undo_stack));
+			return;
+		}
+
+		int cloned = 0, shared = 0;
+		const DesignCheckpoint *prev = stacks.undo_stack.empty() ? nullptr : &stacks.undo_stack.back();
+		stacks.undo_stack.push_back(take_snapshot(design, prev, cloned, shared));
+		stacks.redo_snap.reset();
+		log("Created checkpoint %d: %d modules cloned, %d shared with previous checkpoint.\n",
+				GetSize(stacks.undo_stack)-1, cloned, shared);
+	}
+} CheckpointPass;
+
+struct UndoPass : public Pass {
+	UndoPass() : Pass("undo", "restore the design to the last checkpoint") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    undo [-pop]\n");
+		log("\n");
+		log("Bring the design back to the state of the most recent checkpoint (see the\n");
+		log("`checkpoint' command). Only modules that diverged from the checkpoint are\n");
+		log("replaced. The checkpoint stays on the stack, so a later `undo' returns to\n");
+		log("the same mark again; the undone state can be recovered with `redo' until\n");
+		log("the next `checkpoint' or `undo'.\n");
+		log("\n");
+		log("    -pop\n");
+		log("        also discard the checkpoint after restoring it\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		bool pop_mode = false;
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++) {
+			if (args[argidx] == "-pop") {
+				pop_mode = true;
+				continue;
+			}
+			break;
+		}
+		if (argidx != args.size())
+			cmd_error(args, argidx, "Extra argument.");
+
+		CheckpointStacks &stacks = checkpoint_state[design];
+		if (stacks.undo_stack.empty())
+			log_cmd_error("No checkpoint to undo to.\n");
+
+		DesignCheckpoint &cp = stacks.undo_stack.back();
+
+		// stash the state being discarded so `redo' can bring it back;
+		// modules that already match the checkpoint share its clones
+		int redo_cloned = 0, redo_shared = 0;
+		stacks.redo_snap.reset(new DesignCheckpoint(take_snapshot(design, &cp, redo_cloned, redo_shared)));
+
+		int restored = 0, removed = 0;
+		restore_snapshot(design, cp, restored, removed);
+		log("Restored checkpoint %d: %d modules replaced, %d removed.\n",
+				GetSize(stacks.undo_stack)-1, restored, removed);
+
+		if (pop_mode)
+			stacks.undo_stack.pop_back();
+	}
+} UndoPass;
+
+struct RedoPass : public Pass {
+	RedoPass() : Pass("redo", "restore the design state discarded by `undo'") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    redo\n");
+		log("\n");
+		log("Bring back the design state that the last `undo' discarded. Running `redo'\n");
+		log("again toggles back, so undo/redo can be used to flip between the two states\n");
+		log("for comparison.\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		size_t argidx = 1;
+		if (argidx != args.size())
+			cmd_error(args, argidx, "Extra argument.");
+
+		CheckpointStacks &stacks = checkpoint_state[design];
+		if (!stacks.redo_snap)
+			log_cmd_error("No undone state to redo.\n");
+
+		std::unique_ptr<DesignCheckpoint> target(std::move(stacks.redo_snap));
+
+		// stash the current state so another `redo' toggles back again
+		int cloned = 0, shared = 0;
+		stacks.redo_snap.reset(new DesignCheckpoint(take_snapshot(design, target.get(), cloned, shared)));
+
+		int restored = 0, removed = 0;
+		restore_snapshot(design, *target, restored, removed);
+		log("Restored undone state: %d modules replaced, %d removed.\n", restored, removed);
+	}
+} RedoPass;
+
+PRIVATE_NAMESPACE_END
@@ -0,0 +1,121 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/yosys.h"
+#include "kernel/conehash.h"
+#include "backends/rtlil/rtlil_backend.h"
+#include "libs/sha1/sha1.h"
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+struct ChecksumPass : public Pass {
+	ChecksumPass() : Pass("checksum", "print structural checksums of the design") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    checksum [options] [selection]\n");
+		log("\n");
+		log("Print a stable checksum per selected module plus one for the whole selection,\n");
+		log("for cheap flow integrity and reproducibility checks. The default digest is the\n");
+		log("SHA1 of the module's RTLIL serialization, computed in memory, so it matches\n");
+		log("exactly what `write_rtlil` would emit for that module.\n");
+		log("\n");
+		log("    -canonical\n");
+		log("        digest the netlist structure via cone signatures instead of the\n");
+		log("        serialization. insensitive to names of internal wires and cells\n");
+		log("        (e.g. $auto$ noise from different tool runs) and to declaration\n");
+		log("        order; sensitive to ports, parameters and the logic itself.\n");
+		log("        processes and memories are only hashed by count in this mode,\n");
+		log("        so run it on netlists (after proc/memory).\n");
+		log("\n");
+		log("The design-level digest is also stored in the scratchpad as\n");
+		log("`checksum.design`.\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		bool canonical = false;
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++) {
+			if (args[argidx] == "-canonical") {
+				canonical = true;
+				continue;
+			}
+			break;
+		}
+		extra_args(args, argidx, design);
+
+		log_header(design, "Executing CHECKSUM pass (print structural checksums).\n");
+
+		std::vector<RTLIL::Module*> modules = design->selected_modules();
+		std::sort(modules.begin(), modules.end(),
+				[](RTLIL::Module *a, RTLIL::Module *b) { return a->name < b->name; });
+
+		SHA1 design_hasher;
+
+		for (auto module : modules)
+		{
+			std::string digest;
+
+			if (canonical) {
+				ConeHash hasher(module);
+
+				// Output and inout port cones in port order pin down the
+				// visible function; the wrapping sum over all cell
+				// signatures makes the internal structure part of the
+				// digest without depending on iteration order or names.
+				uint64_t h = 0;
+				std::vector<RTLIL::Wire*> ports;
+				for (auto wire : module->wires())
+					if (wire->port_output)
+						ports.push_back(wire);
+				std::sort(ports.begin(), ports.end(),
+						[](RTLIL::Wire *a, RTLIL::Wire *b) { return a->port_id < b->port_id; });
+				for (auto wire : ports)
+					for (int i = 0; i < wire->width; i++)
+						h = h*0x2545f4914f6cdd1d + hasher.hash_bit(RTLIL::SigBit(wire, i));
+
+				uint64_t cell_sum = 0;
+				for (auto cell : module->cells())
+					cell_sum += hasher.hash_cell(cell);
+				h = h*0x2545f4914f6cdd1d + cell_sum;
+				h = h*0x2545f4914f6cdd1d + GetSize(module->processes);
+				h = h*0x2545f4914f6cdd1d + GetSize(module->memories);
+
+				digest = stringf("%016llx", (unsigned long long)h);
+			} else {
+				std::ostringstream buf;
+				RTLIL_BACKEND::dump_module(buf, "", module, design, false);
+				digest = sha1(buf.str());
+			}
+
+			log("checksum %s %s\n", digest.c_str(), log_id(module));
+			design_hasher.update(digest + " " + module->name.str() + "\n");
+		}
+
+		std::string design_digest = design_hasher.final();
+		log("checksum-design %s\n", design_digest.c_str());
+		design->scratchpad_set_string("checksum.design", design_digest);
+	}
+} ChecksumPass;
+
+PRIVATE_NAMESPACE_END
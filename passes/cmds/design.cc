@@ -21,6 +21,16 @@
 #include "frontends/verilog/preproc.h"
 #include "frontends/ast/ast.h"
 
+#if !defined(_WIN32) && !defined(EMSCRIPTEN)
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <errno.h>
+#  include <string.h>
+#  define YOSYS_HAS_SHM_TRANSPORT
+#endif
+
 YOSYS_NAMESPACE_BEGIN
 
 std::map<std::string, RTLIL::Design*> saved_designs;
@@ -103,6 +113,20 @@ struct DesignPass : public Pass {
 		log("\n");
 		log("Delete the design previously saved under the given name.\n");
 		log("\n");
+		log("\n");
+		log("    design -export-shm <name>\n");
+		log("\n");
+		log("Write the whole current design to the named POSIX shared memory object in the\n");
+		log("binary RTLIL format (see 'write_rtlil_bin'), so a cooperating yosys process on\n");
+		log("the same machine can pick it up without going through the filesystem.\n");
+		log("\n");
+		log("\n");
+		log("    design -import-shm <name> [-unlink]\n");
+		log("\n");
+		log("Read modules from the named shared memory object, as written by -export-shm in\n");
+		log("a cooperating yosys process, into the current design. With -unlink the shared\n");
+		log("memory object is removed after reading.\n");
+		log("\n");
 
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) override
@@ -114,8 +138,10 @@ struct DesignPass : public Pass {
 		bool push_copy_mode = false;
 		bool pop_mode = false;
 		bool import_mode = false;
+		bool shm_unlink_mode = false;
 		RTLIL::Design *copy_from_design = NULL, *copy_to_design = NULL;
 		std::string save_name, load_name, as_name, delete_name;
+		std::string export_shm_name, import_shm_name;
 		std::vector<RTLIL::Module*> copy_src_modules;
 
 		if (!design)
@@ -198,6 +224,20 @@ struct DesignPass : public Pass {
 				as_name = args[++argidx];
 				continue;
 			}
+			if (!got_mode && args[argidx] == "-export-shm" && argidx+1 < args.size()) {
+				got_mode = true;
+				export_shm_name = args[++argidx];
+				continue;
+			}
+			if (!got_mode && args[argidx] == "-import-shm" && argidx+1 < args.size()) {
+				got_mode = true;
+				import_shm_name = args[++argidx];
+				continue;
+			}
+			if (!import_shm_name.empty() && args[argidx] == "-unlink") {
+				shm_unlink_mode = true;
+				continue;
+			}
 			if (!got_mode && args[argidx] == "-delete" && argidx+1 < args.size()) {
 				got_mode = true;
 				delete_name = args[++argidx];
@@ -256,6 +296,71 @@ struct DesignPass : public Pass {
 		if (pop_mode && pushed_designs.empty())
 			log_cmd_error("No pushed designs.\n");
 
+#ifdef YOSYS_HAS_SHM_TRANSPORT
+		if (!export_shm_name.empty())
+		{
+			std::string shm_name = export_shm_name[0] == '/' ? export_shm_name : "/" + export_shm_name;
+
+			std::ostringstream buf;
+			Backend::backend_call(design, &buf, "<shm:" + shm_name + ">", "write_rtlil_bin");
+			std::string data = buf.str();
+
+			int fd = shm_open(shm_name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0600);
+			if (fd < 0)
+				log_cmd_error("Can't create shared memory object '%s': %s\n", shm_name.c_str(), strerror(errno));
+			if (ftruncate(fd, data.size()) != 0) {
+				close(fd);
+				shm_unlink(shm_name.c_str());
+				log_cmd_error("Can't resize shared memory object '%s': %s\n", shm_name.c_str(), strerror(errno));
+			}
+			void *map = mmap(nullptr, data.size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (map == MAP_FAILED) {
+				close(fd);
+				shm_unlink(shm_name.c_str());
+				log_cmd_error("Can't map shared memory object '%s': %s\n", shm_name.c_str(), strerror(errno));
+			}
+			memcpy(map, data.data(), data.size());
+			munmap(map, data.size());
+			close(fd);
+
+			log("Exported design (%zu bytes) to shared memory object '%s'.\n", data.size(), shm_name.c_str());
+		}
+
+		if (!import_shm_name.empty())
+		{
+			std::string shm_name = import_shm_name[0] == '/' ? import_shm_name : "/" + import_shm_name;
+
+			int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+			if (fd < 0)
+				log_cmd_error("Can't open shared memory object '%s': %s\n", shm_name.c_str(), strerror(errno));
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0) {
+				close(fd);
+				log_cmd_error("Shared memory object '%s' is empty or unreadable.\n", shm_name.c_str());
+			}
+			void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (map == MAP_FAILED) {
+				close(fd);
+				log_cmd_error("Can't map shared memory object '%s': %s\n", shm_name.c_str(), strerror(errno));
+			}
+
+			// feed the mapping to the frontend in place, without copying
+			struct shm_streambuf : public std::streambuf {
+				shm_streambuf(char *base, size_t size) { setg(base, base, base + size); }
+			} stream_buf((char*)map, st.st_size);
+			std::istream stream(&stream_buf);
+			Frontend::frontend_call(design, &stream, "<shm:" + shm_name + ">", "read_rtlil_bin");
+
+			munmap(map, st.st_size);
+			close(fd);
+			if (shm_unlink_mode)
+				shm_unlink(shm_name.c_str());
+		}
+#else
+		if (!export_shm_name.empty() || !import_shm_name.empty())
+			log_cmd_error("Shared memory design transport is not supported on this platform.\n");
+#endif
+
 		if (import_mode)
 		{
 			std::string prefix = RTLIL::escape_id(as_name);
@@ -343,8 +448,18 @@ struct DesignPass : public Pass {
 		{
 			RTLIL::Design *design_copy = new RTLIL::Design;
 
-			for (auto mod : design->modules())
-				design_copy->add(mod->clone());
+			if (push_mode || reset_mode) {
+				// the current design is cleared right after -push and -stash,
+				// so transfer the modules instead of cloning them
+				for (auto mod : design->modules().to_vector()) {
+					for (auto mon : design->monitors)
+						mon->notify_module_del(mod);
+					design->modules_.erase(mod->name);
+					design_copy->add(mod);
+				}
+			} else
+				for (auto mod : design->modules())
+					design_copy->add(mod->clone());
 
 			design_copy->selection_stack = design->selection_stack;
 			design_copy->selection_vars = design->selection_vars;
@@ -388,8 +503,18 @@ struct DesignPass : public Pass {
 		{
 			RTLIL::Design *saved_design = pop_mode ? pushed_designs.back() : saved_designs.at(load_name);
 
-			for (auto mod : saved_design->modules())
-				design->add(mod->clone());
+			if (pop_mode)
+				// the popped design is deleted right below, so transfer
+				// the modules instead of cloning them
+				for (auto mod : saved_design->modules().to_vector()) {
+					for (auto mon : saved_design->monitors)
+						mon->notify_module_del(mod);
+					saved_design->modules_.erase(mod->name);
+					design->add(mod);
+				}
+			else
+				for (auto mod : saved_design->modules())
+					design->add(mod->clone());
 
 			design->selection_stack = saved_design->selection_stack;
 			design->selection_vars = saved_design->selection_vars;
@@ -411,5 +536,100 @@ struct DesignPass : public Pass {
 	}
 } DesignPass;
 
+struct ForeachDesignPass : public Pass {
+	ForeachDesignPass() : Pass("foreach-design", "run a command on multiple saved designs") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    foreach-design [-j <num_jobs>] <name_pattern> [<name_pattern>..] -do <command>\n");
+		log("\n");
+		log("Run the given command on every design saved with 'design -save' whose name\n");
+		log("matches one of the given patterns ('*' and '?' wildcards are supported). The\n");
+		log("command is executed directly on the saved designs in place, without copying\n");
+		log("them into the current design, so e.g. N parameterizations of one design can\n");
+		log("be processed by one yosys process, sharing all process-wide caches (parsed\n");
+		log("liberty/techmap libraries, abc9 box/lut libraries, ...) instead of reloading\n");
+		log("them in N separate processes.\n");
+		log("\n");
+		log("    -j <num_jobs>\n");
+		log("        declare that the per-design runs are independent and may be overlapped\n");
+		log("        with the given concurrency. The current runner still executes them in\n");
+		log("        order -- Pass::call() leans on process-global state (log headers, the\n");
+		log("        current pass pointer, the IdString table in default builds), so\n");
+		log("        overlapping whole command invocations is not sound yet -- but scripts\n");
+		log("        can already declare the independence and gain the overlap when the\n");
+		log("        runner learns to exploit it.\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		int num_jobs = 1;
+		std::vector<std::string> patterns, command;
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++) {
+			if (args[argidx] == "-j" && argidx+1 < args.size()) {
+				num_jobs = max(1, atoi(args[++argidx].c_str()));
+				continue;
+			}
+			if (args[argidx] == "-do") {
+				command.assign(args.begin() + argidx + 1, args.end());
+				argidx = args.size();
+				break;
+			}
+			patterns.push_back(args[argidx]);
+		}
+
+		if (patterns.empty())
+			log_cmd_error("No saved design names given.\n");
+		if (command.empty())
+			log_cmd_error("Missing or empty -do <command>.\n");
+
+		// saved_designs is name-sorted, so the run order is deterministic
+		// independent of the pattern order
+		std::vector<std::string> names;
+		pool<std::string> names_seen;
+		for (auto &it : saved_designs) {
+			for (auto &pattern : patterns)
+				if (patmatch(pattern.c_str(), it.first.c_str())) {
+					if (names_seen.insert(it.first).second)
+						names.push_back(it.first);
+					break;
+				}
+		}
+		for (auto &pattern : patterns) {
+			bool found = false;
+			for (auto &name : names)
+				if (patmatch(pattern.c_str(), name.c_str()))
+					found = true;
+			if (!found)
+				log_cmd_error("No saved design matches `%s'.\n", pattern.c_str());
+		}
+
+		if (num_jobs > 1)
+			log("Note: running the %d per-design jobs in order (see 'help foreach-design').\n", GetSize(names));
+
+		for (auto &name : names) {
+			// the command itself may save or delete designs; only the
+			// snapshot of matching names is fixed up front
+			auto it = saved_designs.find(name);
+			if (it == saved_designs.end()) {
+				log_warning("Saved design `%s' was deleted while iterating, skipping.\n", name.c_str());
+				continue;
+			}
+			log_header(design, "Running command on saved design `%s'.\n", name.c_str());
+			log_push();
+			// join the tokens and go through the string form of Pass::call,
+			// so quoted multi-command arguments ("opt; stat") work
+			std::string command_str;
+			for (auto &tok : command)
+				command_str += (command_str.empty() ? "" : " ") + tok;
+			Pass::call(it->second, command_str);
+			log_pop();
+		}
+	}
+} ForeachDesignPass;
+
 YOSYS_NAMESPACE_END
 
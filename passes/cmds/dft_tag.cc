@@ -39,32 +39,30 @@ struct DftTagWorker {
 	SigMap &sigmap;
 	FfInitVals initvals;
 
-	struct tag_set {
-		int index = 0;
-
-		tag_set(int index = 0) : index(index) {}
-
-		bool operator<(const tag_set &other) const { return index < other.index; }
-		bool operator==(const tag_set &other) const { return index == other.index; }
-
-		unsigned int hash() const { return hash_ops<int>::hash(index); }
-
-		bool empty() const { return index == 0; }
-	};
-
-	idict<pool<IdString>> tag_sets;
-
-	pool<IdString> tmp_tag_set;
-	dict<std::pair<tag_set, tag_set>, tag_set> tag_set_union_cache;
-
-	dict<SigBit, tag_set> tagged_signals;
+	// All tags are registered (from $set_tag cells) before propagation
+	// starts, so every tag has a fixed index and the tag set of a net can be
+	// stored as tag_words packed 64-bit words instead of an interned
+	// pool<IdString>.
+	idict<IdString> tag_ids;
+	int tag_words = 0;
+
+	// bit_tags[bit_ids.at(bit) * tag_words + w] holds tags 64*w .. 64*w+63
+	idict<SigBit> bit_ids;
+	std::vector<uint64_t> bit_tags;
+	std::vector<uint64_t> tmp_tags;
 
 	dict<IdString, pool<IdString>> tag_groups;
 	dict<IdString, IdString> group_of_tag;
 	pool<IdString> all_tags;
 
+	// flat worklist over the cell array used during propagation
+	std::vector<Cell *> cell_list;
+	dict<Cell *, int> cell_id;
+	std::vector<bool> cell_pending;
+	std::vector<int> worklist;
+
+	// cycle detection in emit_tag_signals
 	pool<Cell *> pending_cells;
-	std::deque<Cell *> pending_cell_queue;
 
 	dict<std::pair<IdString, SigBit>, SigBit> tag_signals;
 
@@ -78,7 +76,6 @@ struct DftTagWorker {
 	{
 		modwalker.setup(module);
 		initvals.set(&modwalker.sigmap, module);
-		tag_sets(tmp_tag_set);
 	}
 
 	void resolve_overwrites()
@@ -153,113 +150,156 @@ struct DftTagWorker {
 		}
 	}
 
-	const pool<IdString> &tag_pool(tag_set set) { return tag_sets[set.index]; }
+	void register_tag(IdString tag)
+	{
+		if (all_tags.insert(tag).second) {
+			auto group_sep = tag.str().find(':');
+			IdString tag_group = group_sep != std::string::npos ? tag.str().substr(0, group_sep) : tag;
+			tag_groups[tag_group].insert(tag);
+			group_of_tag[tag] = tag_group;
+			tag_ids(tag);
+		}
+	}
+
+	// returns the packed tag planes of a (sigmapped) bit, creating them on
+	// first use. The pointer is invalidated by the next tag_planes call.
+	uint64_t *tag_planes(SigBit bit)
+	{
+		int index = bit_ids(bit);
+		if (GetSize(bit_tags) < (index + 1) * tag_words)
+			bit_tags.resize((index + 1) * tag_words);
+		return bit_tags.data() + index * tag_words;
+	}
 
-	tag_set singleton(IdString tag)
+	bool has_tag(IdString tag, SigBit bit)
 	{
-		tmp_tag_set.clear();
-		tmp_tag_set.emplace(tag);
-		return tag_sets(tmp_tag_set);
+		sigmap.apply(bit);
+		if (!tag_ids.count(tag) || !bit_ids.count(bit))
+			return false;
+		int tag_index = tag_ids.at(tag);
+		return (bit_tags[bit_ids.at(bit) * tag_words + tag_index / 64] >> (tag_index % 64)) & 1;
 	}
 
-	tag_set merge(tag_set a, tag_set b)
+	bool any_tags(const SigSpec &sig)
 	{
-		if (b < a)
-			std::swap(a, b);
-		if (a.empty() || a == b)
-			return b;
-		auto found = tag_set_union_cache.find(std::make_pair(a, b));
-		if (found == tag_set_union_cache.end()) {
-			tmp_tag_set.clear();
-			auto &a_tags = tag_pool(a);
-			auto &b_tags = tag_pool(b);
-			tmp_tag_set.insert(a_tags.begin(), a_tags.end());
-			tmp_tag_set.insert(b_tags.begin(), b_tags.end());
-			tag_set result = tag_sets(tmp_tag_set);
-			tag_set_union_cache.emplace(std::make_pair(a, b), result);
-			return result;
+		for (auto bit : sigmap(sig)) {
+			if (!bit_ids.count(bit))
+				continue;
+			const uint64_t *planes = &bit_tags[bit_ids.at(bit) * tag_words];
+			for (int i = 0; i < tag_words; i++)
+				if (planes[i])
+					return true;
 		}
-		return found->second;
+		return false;
 	}
 
-	tag_set tags(SigBit bit)
+	void gather_tags(SigBit bit, std::vector<uint64_t> &mask)
 	{
 		sigmap.apply(bit);
-		auto found = tagged_signals.find(bit);
-		if (found != tagged_signals.end())
-			return found->second;
-		return tag_set();
+		if (!bit_ids.count(bit))
+			return;
+		const uint64_t *planes = &bit_tags[bit_ids.at(bit) * tag_words];
+		for (int i = 0; i < tag_words; i++)
+			mask[i] |= planes[i];
 	}
 
-	tag_set tags(SigSpec sig)
+	void gather_input_tags(Cell *cell, std::vector<uint64_t> &mask)
 	{
-		tag_set result;
-		for (auto bit : sig)
-			result = merge(result, tags(bit));
-		return result;
+		for (auto &conn : cell->connections())
+			if (cell->input(conn.first))
+				for (auto bit : sigmap(conn.second))
+					gather_tags(bit, mask);
 	}
 
-	tag_set tags(Cell *cell)
+	static bool mask_empty(const std::vector<uint64_t> &mask)
 	{
-		tag_set result;
-		for (auto &conn : cell->connections()) {
-			if (cell->input(conn.first))
-				result = merge(result, tags(conn.second));
-		}
-		return result;
+		for (uint64_t word : mask)
+			if (word)
+				return false;
+		return true;
 	}
 
-	void add_tags(SigBit bit, tag_set new_tags)
+	void add_tags(SigBit bit, const std::vector<uint64_t> &mask)
 	{
 		sigmap.apply(bit);
-		auto &tags = tagged_signals[bit];
-		tag_set merged_tags = merge(tags, new_tags);
-		if (merged_tags == tags)
+		uint64_t *planes = tag_planes(bit);
+		uint64_t changed = 0;
+		for (int i = 0; i < tag_words; i++) {
+			changed |= mask[i] & ~planes[i];
+			planes[i] |= mask[i];
+		}
+		if (!changed)
 			return;
-		tags = merged_tags;
 		auto it = modwalker.signal_consumers.find(bit);
 		if (it == modwalker.signal_consumers.end())
 			return;
 		for (auto &consumer : it->second)
-			if (pending_cells.insert(consumer.cell).second)
-				pending_cell_queue.push_back(consumer.cell);
+			enqueue_cell(consumer.cell);
 	}
 
-	void add_tags(SigSpec sig, tag_set new_tags)
+	void add_tags(SigSpec sig, const std::vector<uint64_t> &mask)
 	{
 		for (auto bit : sigmap(sig))
-			add_tags(bit, new_tags);
+			add_tags(bit, mask);
 	}
 
-	void add_tags(Cell *cell, tag_set new_tags)
+	void add_tags(Cell *cell, const std::vector<uint64_t> &mask)
 	{
 		for (auto &conn : cell->connections())
 			if (cell->output(conn.first))
-				add_tags(conn.second, new_tags);
+				add_tags(conn.second, mask);
 	}
 
 	void forward_tags(SigSpec dst, SigSpec src)
 	{
 		log_assert(GetSize(dst) == GetSize(src));
-		for (int i = 0; i < GetSize(dst); i++)
-			add_tags(dst[i], tags(src[i]));
+		for (int i = 0; i < GetSize(dst); i++) {
+			tmp_tags.assign(tag_words, 0);
+			gather_tags(src[i], tmp_tags);
+			if (!mask_empty(tmp_tags))
+				add_tags(dst[i], tmp_tags);
+		}
+	}
+
+	void enqueue_cell(Cell *cell)
+	{
+		auto found = cell_id.find(cell);
+		if (found == cell_id.end())
+			return;
+		if (!cell_pending[found->second]) {
+			cell_pending[found->second] = true;
+			worklist.push_back(found->second);
+		}
 	}
 
 	void propagate_tags()
 	{
+		// register all tags up front so the packed representation has a
+		// fixed layout during the sweep ($set_tag is the only tag source)
+		for (auto cell : module->cells())
+			if (cell->type == ID($set_tag))
+				register_tag(stringf("\\%s", cell->getParam(ID::TAG).decode_string().c_str()));
+
+		tag_words = (GetSize(tag_ids) + 63) / 64;
+
 		for (auto cell : module->cells()) {
-			if (cell->type == ID($set_tag)) {
-				pending_cells.insert(cell);
-				pending_cell_queue.push_back(cell);
-			}
+			cell_id[cell] = GetSize(cell_list);
+			cell_list.push_back(cell);
 		}
+		cell_pending.assign(GetSize(cell_list), false);
 
-		while (!pending_cell_queue.empty()) {
-			Cell *cell = pending_cell_queue.front();
-			pending_cell_queue.pop_front();
-			pending_cells.erase(cell);
+		for (int i = 0; i < GetSize(cell_list); i++)
+			if (cell_list[i]->type == ID($set_tag)) {
+				cell_pending[i] = true;
+				worklist.push_back(i);
+			}
+
+		while (!worklist.empty()) {
+			int id = worklist.back();
+			worklist.pop_back();
+			cell_pending[id] = false;
 
-			propagate_tags(cell);
+			propagate_tags(cell_list[id]);
 		}
 	}
 
@@ -273,7 +313,7 @@ struct DftTagWorker {
 		if (found != tag_signals.end())
 			return found->second;
 
-		if (!tag_pool(tags(bit)).count(tag))
+		if (!has_tag(tag, bit))
 			return State::S0; // Statically known to not have this tag
 
 		// TODO handle module inputs
@@ -332,7 +372,7 @@ struct DftTagWorker {
 		sigmap.apply(bit);
 		sigmap.apply(tag_bit);
 
-		if (!tag_pool(tags(bit)).count(tag))
+		if (!has_tag(tag, bit))
 			return;
 
 		auto key = std::make_pair(tag, bit);
@@ -372,17 +412,14 @@ struct DftTagWorker {
 	{
 		if (cell->type == ID($set_tag)) {
 			IdString tag = stringf("\\%s", cell->getParam(ID::TAG).decode_string().c_str());
-			if (all_tags.insert(tag).second) {
-				auto group_sep = tag.str().find(':');
-				IdString tag_group = group_sep != std::string::npos ? tag.str().substr(0, group_sep) : tag;
-				tag_groups[tag_group].insert(tag);
-				group_of_tag[tag] = tag_group;
-			}
+			int tag_index = tag_ids.at(tag);
 
 			auto &sig_y = cell->getPort(ID::Y);
 			auto &sig_a = cell->getPort(ID::A);
 			// TODO handle constant set/clr masks
-			add_tags(sig_y, singleton(tag));
+			tmp_tags.assign(tag_words, 0);
+			tmp_tags[tag_index / 64] |= uint64_t(1) << (tag_index % 64);
+			add_tags(sig_y, tmp_tags);
 			forward_tags(sig_y, sig_a);
 			return;
 		}
@@ -446,13 +483,17 @@ struct DftTagWorker {
 		)) {
 			auto &sig_y = cell->getPort(ID::Y);
 
-			add_tags(sig_y[0], tags(cell));
+			tmp_tags.assign(tag_words, 0);
+			gather_input_tags(cell, tmp_tags);
+			add_tags(sig_y[0], tmp_tags);
 			return;
 		}
 
 
 		// Fallback, propagate tags from all inputs to all outputs
-		add_tags(cell, tags(cell));
+		tmp_tags.assign(tag_words, 0);
+		gather_input_tags(cell, tmp_tags);
+		add_tags(cell, tmp_tags);
 
 		if (cell->type.in(
 			ID($_AND_), ID($_OR_), ID($_NAND_), ID($_NOR_), ID($_ANDNOT_), ID($_ORNOT_),
@@ -689,7 +730,7 @@ struct DftTagWorker {
 			FfData ff(&initvals, cell);
 			// TODO handle some more variants
 			if ((ff.has_clk || ff.has_gclk) && !ff.has_ce && !ff.has_aload && !ff.has_srst && !ff.has_arst && !ff.has_sr) {
-				if (ff.has_clk && !tags(ff.sig_clk).empty())
+				if (ff.has_clk && any_tags(ff.sig_clk))
 					log_warning("Tags on CLK input ignored for %s (%s)\n", log_id(cell), log_id(cell->type));
 
 				int width = ff.width;
@@ -765,7 +806,14 @@ struct DftTagWorker {
 					public_wires.push_back(wire);
 
 			for (auto wire : public_wires) {
-				for (auto tag : tag_pool(tags(SigSpec(wire)))) {
+				tmp_tags.assign(tag_words, 0);
+				for (auto bit : sigmap(SigSpec(wire)))
+					gather_tags(bit, tmp_tags);
+
+				for (int tag_index = 0; tag_index < GetSize(tag_ids); tag_index++) {
+					if (!((tmp_tags[tag_index / 64] >> (tag_index % 64)) & 1))
+						continue;
+					IdString tag = tag_ids[tag_index];
 					auto tag_sig = tag_signal(tag, SigSpec(wire));
 					if (tag_sig.is_fully_zero())
 						continue;
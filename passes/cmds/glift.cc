@@ -31,6 +31,7 @@ private:
 	bool opt_create_precise_model = false, opt_create_imprecise_model = false, opt_create_instrumented_model = false;
 	bool opt_taintconstants = false, opt_keepoutputs = false, opt_simplecostmodel = false, opt_nocostmodel = false;
 	bool opt_instrumentmore = false;
+	int opt_taintwidth = 1;
 	std::vector<RTLIL::Wire *> new_taint_outputs;
 	std::vector<std::pair<RTLIL::SigSpec, RTLIL::IdString>> meta_mux_selects;
 	RTLIL::Module *module = nullptr;
@@ -46,16 +47,17 @@ private:
 		log_assert(sig.is_wire() || sig.is_fully_const());
 		log_assert(sig.is_wire() || sig.is_fully_const());
 
-		//Get a SigSpec for the corresponding taint signal for the cell port, creating one if necessary:
+		//Get a SigSpec for the corresponding taint signal for the cell port, creating one if necessary.
+		//With -taint-width each taint signal is a word of independent taint label lanes.
 		if (sig.is_wire()) {
 			RTLIL::Wire *w = module->wire(sig.as_wire()->name.str() + "_t");
-			if (w == nullptr) w = module->addWire(sig.as_wire()->name.str() + "_t", 1);
+			if (w == nullptr) w = module->addWire(sig.as_wire()->name.str() + "_t", opt_taintwidth);
 			ret = w;
 		}
 		else if (sig.is_fully_const() && opt_taintconstants)
-			ret = RTLIL::State::S1;
+			ret = RTLIL::Const(RTLIL::State::S1, opt_taintwidth);
 		else if (sig.is_fully_const())
-			ret = RTLIL::State::S0;
+			ret = RTLIL::Const(RTLIL::State::S0, opt_taintwidth);
 		else
 			log_cmd_error("Cell port SigSpec has unexpected type.\n");
 
@@ -68,13 +70,22 @@ private:
 		return ret;
 	}
 
+	//Replicate a single-bit signal derived from the design data into one copy
+	//per taint lane, so word-wide shadow cells can combine it with taint words.
+	RTLIL::SigSpec lanes(const RTLIL::SigSpec &sig) {
+		if (opt_taintwidth == 1)
+			return sig;
+		log_assert(GetSize(sig) == 1);
+		return RTLIL::SigSpec(sig[0], opt_taintwidth);
+	}
+
 	void add_precise_GLIFT_logic(const RTLIL::Cell *cell, RTLIL::SigSpec &port_a, RTLIL::SigSpec &port_a_taint, RTLIL::SigSpec &port_b, RTLIL::SigSpec &port_b_taint, RTLIL::SigSpec &port_y_taint) {
 		//AKA AN2_SH2 or OR2_SH2
 		bool is_and = cell->type.in(ID($_AND_), ID($_NAND_));
 		RTLIL::SigSpec n_port_a = module->LogicNot(cell->name.str() + "_t_1_1", port_a, false, cell->get_src_attribute());
 		RTLIL::SigSpec n_port_b = module->LogicNot(cell->name.str() + "_t_1_2", port_b, false, cell->get_src_attribute());
-		auto subexpr1 = module->And(cell->name.str() + "_t_1_3", is_and? port_a : n_port_a, port_b_taint, false, cell->get_src_attribute());
-		auto subexpr2 = module->And(cell->name.str() + "_t_1_4", is_and? port_b : n_port_b, port_a_taint, false, cell->get_src_attribute());
+		auto subexpr1 = module->And(cell->name.str() + "_t_1_3", lanes(is_and? port_a : n_port_a), port_b_taint, false, cell->get_src_attribute());
+		auto subexpr2 = module->And(cell->name.str() + "_t_1_4", lanes(is_and? port_b : n_port_b), port_a_taint, false, cell->get_src_attribute());
 		auto subexpr3 = module->And(cell->name.str() + "_t_1_5", port_a_taint, port_b_taint, false, cell->get_src_attribute());
 		auto subexpr4 = module->Or(cell->name.str() + "_t_1_6", subexpr1, subexpr2, false, cell->get_src_attribute());
 		module->addOr(cell->name.str() + "_t_1_7", subexpr4, subexpr3, port_y_taint, false, cell->get_src_attribute());
@@ -84,7 +95,7 @@ private:
 		//AKA AN2_SH3 or OR2_SH3
 		bool is_and = cell->type.in(ID($_AND_), ID($_NAND_));
 		RTLIL::SigSpec n_port_a = module->LogicNot(cell->name.str() + "_t_2_1", port_a, false, cell->get_src_attribute());
-		auto subexpr1 = module->And(cell->name.str() + "_t_2_2", is_and? port_b : n_port_a, is_and? port_a_taint : port_b_taint, false, cell->get_src_attribute());
+		auto subexpr1 = module->And(cell->name.str() + "_t_2_2", lanes(is_and? port_b : n_port_a), is_and? port_a_taint : port_b_taint, false, cell->get_src_attribute());
 		module->addOr(cell->name.str() + "_t_2_3", is_and? port_b_taint : port_a_taint, subexpr1, port_y_taint, false, cell->get_src_attribute());
 	}
 
@@ -92,7 +103,7 @@ private:
 		//AKA AN2_SH4 or OR2_SH4
 		bool is_and = cell->type.in(ID($_AND_), ID($_NAND_));
 		RTLIL::SigSpec n_port_b = module->LogicNot(cell->name.str() + "_t_3_1", port_b, false, cell->get_src_attribute());
-		auto subexpr1 = module->And(cell->name.str() + "_t_3_2", is_and? port_a : n_port_b, is_and? port_b_taint : port_a_taint, false, cell->get_src_attribute());
+		auto subexpr1 = module->And(cell->name.str() + "_t_3_2", lanes(is_and? port_a : n_port_b), is_and? port_b_taint : port_a_taint, false, cell->get_src_attribute());
 		module->addOr(cell->name.str() + "_t_3_3", is_and? port_a_taint : port_b_taint, subexpr1, port_y_taint, false, cell->get_src_attribute());
 	}
 
@@ -110,11 +121,11 @@ private:
 	}
 
 	void add_imprecise_GLIFT_logic_6(RTLIL::SigSpec &port_y_taint) {
-		module->connect(port_y_taint, RTLIL::Const(1, 1));
+		module->connect(port_y_taint, RTLIL::Const(RTLIL::State::S1, opt_taintwidth));
 	}
 
 	void add_imprecise_GLIFT_logic_7(RTLIL::SigSpec &port_y_taint) {
-		module->connect(port_y_taint, RTLIL::Const(0, 1));
+		module->connect(port_y_taint, RTLIL::Const(RTLIL::State::S0, opt_taintwidth));
 	}
 
 	void add_precise_GLIFT_mux(const RTLIL::Cell *cell, RTLIL::SigSpec &port_a, RTLIL::SigSpec &port_a_taint, RTLIL::SigSpec &port_b, RTLIL::SigSpec &port_b_taint, RTLIL::SigSpec &port_s, RTLIL::SigSpec &port_s_taint, RTLIL::SigSpec &port_y_taint) {
@@ -122,12 +133,12 @@ private:
 		RTLIL::SigSpec n_port_a = module->LogicNot(cell->name.str() + "_t_4_1", port_a, false, cell->get_src_attribute());
 		RTLIL::SigSpec n_port_b = module->LogicNot(cell->name.str() + "_t_4_2", port_b, false, cell->get_src_attribute());
 		RTLIL::SigSpec n_port_s = module->LogicNot(cell->name.str() + "_t_4_3", port_s, false, cell->get_src_attribute());
-		auto subexpr1 = module->And(cell->name.str() + "_t_4_4", port_s, port_a_taint, false, cell->get_src_attribute());
-		auto subexpr2 = module->And(cell->name.str() + "_t_4_5", n_port_s, port_b_taint, false, cell->get_src_attribute());
+		auto subexpr1 = module->And(cell->name.str() + "_t_4_4", lanes(port_s), port_a_taint, false, cell->get_src_attribute());
+		auto subexpr2 = module->And(cell->name.str() + "_t_4_5", lanes(n_port_s), port_b_taint, false, cell->get_src_attribute());
 		auto subexpr3 = module->And(cell->name.str() + "_t_4_6", n_port_a, port_b, false, cell->get_src_attribute());
-		auto subexpr4 = module->And(cell->name.str() + "_t_4_7", subexpr3, port_s_taint, false, cell->get_src_attribute());
+		auto subexpr4 = module->And(cell->name.str() + "_t_4_7", lanes(subexpr3), port_s_taint, false, cell->get_src_attribute());
 		auto subexpr5 = module->And(cell->name.str() + "_t_4_8", port_a, n_port_b, false, cell->get_src_attribute());
-		auto subexpr6 = module->And(cell->name.str() + "_t_4_9", subexpr5, port_s_taint, false, cell->get_src_attribute());
+		auto subexpr6 = module->And(cell->name.str() + "_t_4_9", lanes(subexpr5), port_s_taint, false, cell->get_src_attribute());
 		auto subexpr7 = module->And(cell->name.str() + "_t_4_10", port_a_taint, port_s_taint, false, cell->get_src_attribute());
 		auto subexpr8 = module->And(cell->name.str() + "_t_4_11", port_b_taint, port_s_taint, false, cell->get_src_attribute());
 		auto subexpr9  = module->Or(cell->name.str() + "_t_4_12", subexpr1, subexpr2, false, cell->get_src_attribute());
@@ -183,6 +194,11 @@ private:
 
 		std::vector<RTLIL::SigSig> connections(module->connections());
 
+		//Shadow logic multiplies the design size by a roughly constant factor,
+		//so pre-size the wire/cell tables for the coming burst of additions.
+		int shadow_factor = opt_create_instrumented_model ? (opt_instrumentmore ? 24 : 14) : 8;
+		module->reserve(shadow_factor * GetSize(module->cells_), shadow_factor * GetSize(module->cells_));
+
 		for(auto &cell : module->cells().to_vector()) {
 			if (!cell->type.in({ID($_AND_), ID($_NAND_), ID($_OR_), ID($_NOR_), ID($_XOR_), ID($_XNOR_), ID($_MUX_), ID($_NMUX_), ID($_NOT_), ID($anyconst), ID($allconst), ID($assume), ID($assert)}) && module->design->module(cell->type) == nullptr) {
 				log_cmd_error("Unsupported cell type \"%s\" found.  Run `techmap` first.\n", cell->type.c_str());
@@ -207,7 +223,7 @@ private:
 					int num_versions = opt_instrumentmore? 8 : 4;
 
 					for (auto i = 1; i <= num_versions; ++i)
-						taint_version.emplace_back(RTLIL::SigSpec(module->addWire(stringf("%s_y%d", cell->name.c_str(), i), 1)));
+						taint_version.emplace_back(RTLIL::SigSpec(module->addWire(stringf("%s_y%d", cell->name.c_str(), i), opt_taintwidth)));
 
 					for (auto i = 0; i < num_versions; ++i) {
 						switch(i) {
@@ -272,7 +288,7 @@ private:
 					log_assert(exp2(select_width) == num_versions);
 
 					for (auto i = 1; i <= num_versions; ++i)
-						taint_version.emplace_back(RTLIL::SigSpec(module->addWire(stringf("%s_y%d", cell->name.c_str(), i), 1)));
+						taint_version.emplace_back(RTLIL::SigSpec(module->addWire(stringf("%s_y%d", cell->name.c_str(), i), opt_taintwidth)));
 
 					for (auto i = 0; i < num_versions; ++i) {
 						switch(i) {
@@ -406,7 +422,7 @@ private:
 	}
 
 public:
-	GliftWorker(RTLIL::Module *_module, bool _is_top_module, bool _opt_create_precise_model, bool _opt_create_imprecise_model, bool _opt_create_instrumented_model, bool _opt_taintconstants, bool _opt_keepoutputs, bool _opt_simplecostmodel, bool _opt_nocostmodel, bool _opt_instrumentmore) {
+	GliftWorker(RTLIL::Module *_module, bool _is_top_module, bool _opt_create_precise_model, bool _opt_create_imprecise_model, bool _opt_create_instrumented_model, bool _opt_taintconstants, bool _opt_keepoutputs, bool _opt_simplecostmodel, bool _opt_nocostmodel, bool _opt_instrumentmore, int _opt_taintwidth) {
 		module = _module;
 		is_top_module = _is_top_module;
 		opt_create_precise_model = _opt_create_precise_model;
@@ -417,6 +433,7 @@ public:
 		opt_simplecostmodel = _opt_simplecostmodel;
 		opt_nocostmodel = _opt_nocostmodel;
 		opt_instrumentmore = _opt_instrumentmore;
+		opt_taintwidth = _opt_taintwidth;
 
 		create_glift_logic();
 	}
@@ -513,6 +530,12 @@ struct GliftPass : public Pass {
 		log("    Only applicable in combination with `-create-instrumented-model`.\n");
 		log("    (default: do not add more versions of taint tracking logic.\n");
 		log("\n");
+		log("  -taint-width <width>\n");
+		log("    Track <width> independent taint labels at once. Taint signals become\n");
+		log("    <width>-bit words and the shadow logic is built from word-wide cells with\n");
+		log("    one lane per label, instead of duplicating the whole shadow network per\n");
+		log("    label. (default: 1)\n");
+		log("\n");
 	}
 
 	void execute(std::vector<std::string> args, RTLIL::Design *design) override
@@ -520,6 +543,7 @@ struct GliftPass : public Pass {
 		bool opt_create_precise_model = false, opt_create_imprecise_model = false, opt_create_instrumented_model = false;
 		bool opt_taintconstants = false, opt_keepoutputs = false, opt_simplecostmodel = false, opt_nocostmodel = false;
 		bool opt_instrumentmore = false;
+		int opt_taintwidth = 1;
 		log_header(design, "Executing GLIFT pass (creating and manipulating GLIFT models).\n");
 		std::vector<std::string>::size_type argidx;
 
@@ -556,12 +580,18 @@ struct GliftPass : public Pass {
 				opt_instrumentmore = true;
 				continue;
 			}
+			if (args[argidx] == "-taint-width" && argidx+1 < args.size()) {
+				opt_taintwidth = atoi(args[++argidx].c_str());
+				continue;
+			}
 			break;
 		}
 		if(!opt_create_precise_model && !opt_create_imprecise_model && !opt_create_instrumented_model)
 			log_cmd_error("No command provided.  See help for usage.\n");
 		if(static_cast<int>(opt_create_precise_model) + static_cast<int>(opt_create_imprecise_model) + static_cast<int>(opt_create_instrumented_model) != 1)
 			log_cmd_error("Only one command may be specified.  See help for usage.\n");
+		if(opt_taintwidth < 1)
+			log_cmd_error("The `-taint-width` option requires a positive width.\n");
 		if(opt_simplecostmodel && opt_nocostmodel)
 			log_cmd_error("Only one of `-simple-cost-model` and `-no-cost-model` may be specified. See help for usage.\n");
 		if((opt_simplecostmodel || opt_nocostmodel) && !opt_create_instrumented_model)
@@ -595,7 +625,7 @@ struct GliftPass : public Pass {
 
 		for (auto i = 0; i < GetSize(topo_modules.sorted); ++i) {
 			RTLIL::Module *module = topo_modules.sorted[i];
-			GliftWorker(module, !non_top_modules[module->name], opt_create_precise_model, opt_create_imprecise_model, opt_create_instrumented_model, opt_taintconstants, opt_keepoutputs, opt_simplecostmodel, opt_nocostmodel, opt_instrumentmore);
+			GliftWorker(module, !non_top_modules[module->name], opt_create_precise_model, opt_create_imprecise_model, opt_create_instrumented_model, opt_taintconstants, opt_keepoutputs, opt_simplecostmodel, opt_nocostmodel, opt_instrumentmore, opt_taintwidth);
 		}
 	}
 } GliftPass;
@@ -40,6 +40,12 @@ struct LoggerPass : public Pass {
 		log("    -[no]stderr\n");
 		log("        enable/disable logging errors to stderr.\n");
 		log("\n");
+		log("    -[no]async\n");
+		log("        enable/disable the asynchronous log backend. Log messages are still\n");
+		log("        formatted by the logging command, but the writes to the log files are\n");
+		log("        done by a dedicated writer thread, so verbose commands do not stall\n");
+		log("        on log file I/O.\n");
+		log("\n");
 		log("    -warn regex\n");
 		log("        print a warning for all log messages matching the regex.\n");
 		log("\n");
@@ -97,6 +103,16 @@ struct LoggerPass : public Pass {
 				log("Disabled loggint errors to stderr.\n");
 				continue;
 			}
+			if (args[argidx] == "-async") {
+				log_set_async(true);
+				log("Enabled asynchronous log backend.\n");
+				continue;
+			}
+			if (args[argidx] == "-noasync") {
+				log_set_async(false);
+				log("Disabled asynchronous log backend.\n");
+				continue;
+			}
 			if (args[argidx] == "-warn" && argidx+1 < args.size()) {
 				std::string pattern = args[++argidx];
 				if (pattern.front() == '\"' && pattern.back() == '\"') pattern = pattern.substr(1, pattern.size() - 2);		
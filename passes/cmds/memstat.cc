@@ -0,0 +1,167 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/yosys.h"
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+struct MemstatWorker
+{
+	// copy-on-write SigSpec chunk buffers already attributed to an earlier
+	// spec, so shared storage is only counted once
+	pool<const void*, hash_ptr_ops> seen_buffers;
+
+	size_t total_wires = 0, total_cells = 0, total_conns = 0;
+	size_t total_attrs = 0, total_sigspecs = 0, total_arena = 0;
+
+	size_t const_bytes(const RTLIL::Const &data)
+	{
+		return data.bits.capacity() * sizeof(RTLIL::State);
+	}
+
+	size_t attr_bytes(const dict<RTLIL::IdString, RTLIL::Const> &attributes)
+	{
+		size_t bytes = attributes.size() *
+				(sizeof(std::pair<RTLIL::IdString, RTLIL::Const>) + 2*sizeof(int));
+		for (auto &it : attributes)
+			bytes += const_bytes(it.second);
+		return bytes;
+	}
+
+	size_t sigspec_bytes(const RTLIL::SigSpec &sig)
+	{
+		size_t bytes = 0;
+		const RTLIL::SigChunkVec &chunks = sig.chunks();
+
+		const void *buf = chunks.heap_buffer();
+		if (buf != nullptr) {
+			if (!seen_buffers.insert(buf).second)
+				return 0;
+			bytes += chunks.heap_buffer_bytes();
+		}
+
+		for (auto &chunk : chunks)
+			bytes += chunk.data.capacity() * sizeof(RTLIL::State);
+		return bytes;
+	}
+
+	void report_module(RTLIL::Module *module)
+	{
+		size_t wire_bytes = 0, cell_bytes = 0, conn_bytes = 0;
+		size_t attrs_bytes = 0, sig_bytes = 0;
+
+		attrs_bytes += attr_bytes(module->attributes);
+
+		for (auto wire : module->wires()) {
+			wire_bytes += sizeof(RTLIL::Wire);
+			attrs_bytes += attr_bytes(wire->attributes);
+		}
+
+		for (auto &it : module->memories) {
+			wire_bytes += sizeof(RTLIL::Memory);
+			attrs_bytes += attr_bytes(it.second->attributes);
+		}
+
+		for (auto cell : module->cells()) {
+			cell_bytes += sizeof(RTLIL::Cell);
+			cell_bytes += cell->connections().size() *
+					(sizeof(std::pair<RTLIL::IdString, RTLIL::SigSpec>) + 2*sizeof(int));
+			attrs_bytes += attr_bytes(cell->attributes);
+			attrs_bytes += attr_bytes(cell->parameters);
+			for (auto &conn : cell->connections())
+				sig_bytes += sigspec_bytes(conn.second);
+		}
+
+		conn_bytes += module->connections().capacity() * sizeof(RTLIL::SigSig);
+		for (auto &conn : module->connections()) {
+			sig_bytes += sigspec_bytes(conn.first);
+			sig_bytes += sigspec_bytes(conn.second);
+		}
+
+		size_t arena_bytes = module->object_arena_bytes();
+		size_t module_total = wire_bytes + cell_bytes + conn_bytes + attrs_bytes + sig_bytes;
+
+		log("\n");
+		log("=== %s ===\n", log_id(module->name));
+		log("\n");
+		log("   wires:      %10.2f MiB (%d wires, %d memories)\n",
+				wire_bytes / 1024.0 / 1024.0, GetSize(module->wires()), GetSize(module->memories));
+		log("   cells:      %10.2f MiB (%d cells)\n",
+				cell_bytes / 1024.0 / 1024.0, GetSize(module->cells()));
+		log("   connections:%10.2f MiB (%d connections)\n",
+				conn_bytes / 1024.0 / 1024.0, GetSize(module->connections()));
+		log("   attributes: %10.2f MiB\n", attrs_bytes / 1024.0 / 1024.0);
+		log("   sigspecs:   %10.2f MiB\n", sig_bytes / 1024.0 / 1024.0);
+		log("   total:      %10.2f MiB\n", module_total / 1024.0 / 1024.0);
+		log("   arena:      %10.2f MiB (backs the wires and cells above)\n",
+				arena_bytes / 1024.0 / 1024.0);
+
+		total_wires += wire_bytes;
+		total_cells += cell_bytes;
+		total_conns += conn_bytes;
+		total_attrs += attrs_bytes;
+		total_sigspecs += sig_bytes;
+		total_arena += arena_bytes;
+	}
+};
+
+struct MemstatPass : public Pass {
+	MemstatPass() : Pass("memstat", "print estimated memory usage per module") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    memstat [selection]\n");
+		log("\n");
+		log("Print an estimate of the heap memory used by each selected module, broken\n");
+		log("down into wires, cells, connections, attributes (incl. cell parameters) and\n");
+		log("SigSpec chunk storage. Shared copy-on-write SigSpec buffers are counted\n");
+		log("once. The numbers are estimates of the dominant allocations, not an exact\n");
+		log("account of every container's overhead; use them to find out which modules\n");
+		log("and structures dominate memory, e.g. before setting ulimits or picking\n");
+		log("targets for memory-reduction work.\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		log_header(design, "Executing MEMSTAT pass (printing memory usage).\n");
+		extra_args(args, 1, design);
+
+		MemstatWorker worker;
+		for (auto module : design->selected_modules())
+			worker.report_module(module);
+
+		size_t design_total = worker.total_wires + worker.total_cells + worker.total_conns +
+				worker.total_attrs + worker.total_sigspecs;
+
+		log("\n");
+		log("=== design totals ===\n");
+		log("\n");
+		log("   wires:      %10.2f MiB\n", worker.total_wires / 1024.0 / 1024.0);
+		log("   cells:      %10.2f MiB\n", worker.total_cells / 1024.0 / 1024.0);
+		log("   connections:%10.2f MiB\n", worker.total_conns / 1024.0 / 1024.0);
+		log("   attributes: %10.2f MiB\n", worker.total_attrs / 1024.0 / 1024.0);
+		log("   sigspecs:   %10.2f MiB\n", worker.total_sigspecs / 1024.0 / 1024.0);
+		log("   total:      %10.2f MiB\n", design_total / 1024.0 / 1024.0);
+		log("   arena:      %10.2f MiB\n", worker.total_arena / 1024.0 / 1024.0);
+	}
+} MemstatPass;
+
+PRIVATE_NAMESPACE_END
@@ -20,7 +20,6 @@
 #include "kernel/yosys.h"
 #include "kernel/sigtools.h"
 
-#undef LOG_MATRICES
 #undef PYPLOT_EDGES
 
 USING_YOSYS_NAMESPACE
@@ -211,14 +210,19 @@ struct QwpWorker
 		// AA = A' * A
 		// Ay = A' * y
 		//
-		// M := [AA Ay]
+		// AA is a graph Laplacian plus a strictly positive diagonal, i.e.
+		// symmetric positive definite and as sparse as the netlist. Instead
+		// of materializing it as a dense matrix we keep it in CSR form and
+		// solve "AA*x = Ay" (least squares fit for "A*x = y") with
+		// Jacobi-preconditioned conjugate gradient.
 
 		if (config.verbose)
 			log("> System size: %d^2\n", GetSize(nodes));
 
-		// Row major order
-		int N = GetSize(nodes), N1 = N+1;
-		vector<double> M(N * N1);
+		int N = GetSize(nodes);
+
+		vector<double> diag(N);
+		vector<double> rhs_vec(N);
 
 		if (config.verbose)
 			log("> Edge constraints: %d\n", GetSize(edges));
@@ -226,18 +230,35 @@ struct QwpWorker
 		// Edge constraints:
 		//   A[i,:] := [ 0 0 .... 0 weight 0 ... 0 -weight 0 ... 0 0], y[i] := 0
 		//
-		// i.e. nonzero columns in A[i,:] at the two node indices.
+		// i.e. nonzero columns in A[i,:] at the two node indices. In AA each
+		// edge contributes weight^2 to both diagonal entries and -weight^2 to
+		// the two symmetric off-diagonal entries.
+		vector<int> row_begin(N+1);
+		for (auto &edge : edges) {
+			row_begin[edge.first.first + 1]++;
+			row_begin[edge.first.second + 1]++;
+		}
+		for (int i = 0; i < N; i++)
+			row_begin[i+1] += row_begin[i];
+
+		vector<int> cols(row_begin[N]);
+		vector<double> vals(row_begin[N]);
+		vector<int> cursor(row_begin.begin(), row_begin.end()-1);
+
 		for (auto &edge : edges)
 		{
 			int idx1 = edge.first.first;
 			int idx2 = edge.first.second;
 			double weight = edge.second * (1.0 + xorshift32() * 1e-3);
 
-			M[idx1 + idx1*N1] += weight * weight;
-			M[idx2 + idx2*N1] += weight * weight;
+			diag[idx1] += weight * weight;
+			diag[idx2] += weight * weight;
 
-			M[idx1 + idx2*N1] += -weight * weight;
-			M[idx2 + idx1*N1] += -weight * weight;
+			cols[cursor[idx1]] = idx2;
+			vals[cursor[idx1]++] = -weight * weight;
+
+			cols[cursor[idx2]] = idx1;
+			vals[cursor[idx2]++] = -weight * weight;
 		}
 
 		if (config.verbose)
@@ -261,98 +282,85 @@ struct QwpWorker
 				weight = 1e3;
 			weight *= (1.0 + xorshift32() * 1e-3);
 
-			M[idx + idx*N1] += weight * weight;
-			M[N + idx*N1] += rhs * weight * weight;
+			diag[idx] += weight * weight;
+			rhs_vec[idx] += rhs * weight * weight;
 		}
 
-#ifdef LOG_MATRICES
-		log("\n");
-		for (int i = 0; i < N; i++) {
-			for (int j = 0; j < N+1; j++)
-				log(" %10.2e", M[(N+1)*i + j]);
-			log("\n");
-		}
-#endif
-
 		if (config.verbose)
 			log("> Solving\n");
 
-		// Solve "AA*x = Ay"
-		// (least squares fit for "A*x = y")
-		//
-		// Using gaussian elimination to get M := [Id x]
-
-		vector<int> pivot_cache;
-		vector<int> queue;
-
-		for (int i = 0; i < N; i++)
-			queue.push_back(i);
+		// rows of the matrix-vector product are independent, so for large
+		// systems they are computed on the worker pool; the result does not
+		// depend on the number of threads
+		ThreadPool &pool = ThreadPool::get();
+		bool use_pool = N >= 4096 && pool.num_threads() > 1;
+
+		auto spmv = [&](const vector<double> &v, vector<double> &out) {
+			auto row = [&](int i) {
+				double acc = diag[i] * v[i];
+				for (int k = row_begin[i]; k != row_begin[i+1]; k++)
+					acc += vals[k] * v[cols[k]];
+				out[i] = acc;
+			};
+			if (use_pool)
+				pool.parallel_for(N, row);
+			else
+				for (int i = 0; i < N; i++)
+					row(i);
+		};
 
-		// gaussian elimination
+		// start from the current node positions, which are already a
+		// reasonable guess on all but the first recursion level
+		vector<double> x(N), resid(N), z(N), p(N), Ap(N);
 		for (int i = 0; i < N; i++)
-		{
-			if (config.verbose && N > 15 && ((i+1) % (N/15)) == 0)
-				log("> Solved %d%%: %d/%d\n", (100*(i+1))/N, i+1, N);
-
-			// find best row
-			int best_row = queue.front();
-			int best_row_queue_idx = 0;
-			double best_row_absval = 0;
-
-			for (int k = 0; k < GetSize(queue); k++) {
-				int row = queue[k];
-				double absval = fabs(M[i + row*N1]);
-				if (absval > best_row_absval) {
-					best_row = row;
-					best_row_queue_idx = k;
-					best_row_absval = absval;
-				}
-			}
+			x[i] = alt_mode ? nodes[i].alt_pos : nodes[i].pos;
 
-			int row = best_row;
-			pivot_cache.push_back(row);
-
-			queue[best_row_queue_idx] = queue.back();
-			queue.pop_back();
+		spmv(x, Ap);
+		double rz = 0;
+		for (int i = 0; i < N; i++) {
+			resid[i] = rhs_vec[i] - Ap[i];
+			z[i] = resid[i] / diag[i];
+			p[i] = z[i];
+			rz += resid[i] * z[i];
+		}
 
-			// normalize row
-			for (int k = i+1; k < N1; k++)
-				M[k + row*N1] /= M[i + row*N1];
-			M[i + row*N1] = 1.0;
+		double rz_init = rz;
+		int iter = 0, max_iter = min(N, 10000);
 
-			// elimination
-			for (int other_row : queue) {
-				double d = M[i + other_row*N1];
-				for (int k = i+1; k < N1; k++)
-					M[k + other_row*N1] -= d*M[k + row*N1];
-				M[i + other_row*N1] = 0.0;
+		while (iter < max_iter && rz > 1e-12 * rz_init && rz > 0)
+		{
+			spmv(p, Ap);
+
+			double pAp = 0;
+			for (int i = 0; i < N; i++)
+				pAp += p[i] * Ap[i];
+			if (!(pAp > 0))
+				break;
+
+			double step = rz / pAp;
+			for (int i = 0; i < N; i++) {
+				x[i] += step * p[i];
+				resid[i] -= step * Ap[i];
 			}
-		}
 
-		if (config.verbose)
-			log("> Solved\n");
+			double rz_next = 0;
+			for (int i = 0; i < N; i++) {
+				z[i] = resid[i] / diag[i];
+				rz_next += resid[i] * z[i];
+			}
 
-		log_assert(queue.empty());
-		log_assert(GetSize(pivot_cache) == N);
+			double beta = rz_next / rz;
+			rz = rz_next;
+			for (int i = 0; i < N; i++)
+				p[i] = z[i] + beta * p[i];
 
-		// back substitution
-		for (int i = N-1; i >= 0; i--)
-		for (int j = i+1; j < N; j++)
-		{
-			int row = pivot_cache[i];
-			int other_row = pivot_cache[j];
-			M[N + row*N1] -= M[j + row*N1] * M[N + other_row*N1];
-			M[j + row*N1] = 0.0;
+			iter++;
+			if (config.verbose && (iter % 100) == 0)
+				log("> CG iteration %d, rel. residual %.2e\n", iter, rz / rz_init);
 		}
 
-#ifdef LOG_MATRICES
-		log("\n");
-		for (int i = 0; i < N; i++) {
-			for (int j = 0; j < N+1; j++)
-				log(" %10.2e", M[(N+1)*i + j]);
-			log("\n");
-		}
-#endif
+		if (config.verbose)
+			log("> Solved after %d CG iterations\n", iter);
 
 		if (config.verbose)
 			log("> Update nodes\n");
@@ -360,7 +368,7 @@ struct QwpWorker
 		// update node positions
 		for (int i = 0; i < N; i++)
 		{
-			double v = M[(N+1)*i + N];
+			double v = x[i];
 			double c = alt_mode ? alt_midpos : midpos;
 			double r = alt_mode ? alt_radius : radius;
 
@@ -804,8 +812,9 @@ struct QwpPass : public Pass {
 		log("    -v\n");
 		log("        Verbose solver output for profiling or debugging\n");
 		log("\n");
-		log("Note: This implementation of a quadratic wirelength placer uses exact\n");
-		log("dense matrix operations. It is only a toy-placer for small circuits.\n");
+		log("Note: This implementation of a quadratic wirelength placer uses a sparse\n");
+		log("conjugate gradient solver. It is only a toy-placer that calculates\n");
+		log("a rough initial placement.\n");
 		log("\n");
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) override
@@ -24,6 +24,7 @@
 #include "kernel/register.h"
 #include "kernel/celltypes.h"
 #include "kernel/sigtools.h"
+#include "kernel/topo_scc.h"
 #include "kernel/log.h"
 #include <stdlib.h>
 #include <stdio.h>
@@ -31,17 +32,21 @@
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
+// The worker runs on a pool thread (one per module), so it must not call
+// log() or modify the design; found SCCs are collected in sccList and
+// reported from the main thread via report().
 struct SccWorker
 {
 	RTLIL::Design *design;
 	RTLIL::Module *module;
 	SigMap sigmap;
-	CellTypes ct, specifyCells;
+	const CellTypes &ct, &specifyCells;
 
 	pool<RTLIL::Cell*> workQueue;
 	dict<RTLIL::Cell*, pool<RTLIL::Cell*>> cellToNextCell;
 	dict<RTLIL::Cell*, RTLIL::SigSpec> cellToPrevSig, cellToNextSig;
 
+	// state of the depth-limited legacy search (only used with -max_depth)
 	dict<RTLIL::Cell*, std::pair<int, int>> cellLabels;
 	dict<RTLIL::Cell*, int> cellDepth;
 	pool<RTLIL::Cell*> cellsOnStack;
@@ -83,49 +88,23 @@ struct SccWorker
 			}
 			else
 			{
-				log("Found an SCC:");
 				pool<RTLIL::Cell*> scc;
 				while (cellsOnStack.count(cell) > 0) {
 					RTLIL::Cell *c = cellStack.back();
 					cellStack.pop_back();
 					cellsOnStack.erase(c);
-					log(" %s", RTLIL::id2cstr(c->name));
 					cell2scc[c] = sccList.size();
 					scc.insert(c);
 				}
 				sccList.push_back(scc);
-				log("\n");
 			}
 		}
 	}
 
-	SccWorker(RTLIL::Design *design, RTLIL::Module *module, bool nofeedbackMode, bool allCellTypes, bool specifyMode, int maxDepth) :
-			design(design), module(module), sigmap(module)
+	SccWorker(RTLIL::Design *design, RTLIL::Module *module, const CellTypes &ct, const CellTypes &specifyCells,
+			bool nofeedbackMode, bool allCellTypes, int maxDepth) :
+			design(design), module(module), sigmap(module), ct(ct), specifyCells(specifyCells)
 	{
-		if (module->processes.size() > 0) {
-			log("Skipping module %s as it contains processes (run 'proc' pass first).\n", module->name.c_str());
-			return;
-		}
-
-		if (allCellTypes) {
-			ct.setup(design);
-		} else {
-			ct.setup_internals();
-			ct.setup_stdcells();
-		}
-
-		// Discover boxes with specify rules in them, for special handling.
-		if (specifyMode) {
-			for (auto mod : design->modules())
-				if (mod->get_blackbox_attribute(false))
-					for (auto cell : mod->cells())
-						if (cell->type == ID($specify2))
-						{
-							specifyCells.setup_module(mod);
-							break;
-						}
-		}
-
 		SigPool selectedSignals;
 		SigSet<RTLIL::Cell*> sigToNextCells;
 
@@ -154,14 +133,20 @@ struct SccWorker
 					if (subcell->type != ID($specify2))
 						continue;
 
-					for (auto bit : subcell->getPort(ID::SRC))
+					// take copies of the ports: iterating them directly would
+					// lazily unpack the box module's stored SigSpecs in place,
+					// and the box is shared between all workers
+					RTLIL::SigSpec src_sig = subcell->getPort(ID::SRC);
+					RTLIL::SigSpec dst_sig = subcell->getPort(ID::DST);
+
+					for (auto bit : src_sig)
 					{
 						if (!bit.wire || !cell->hasPort(bit.wire->name))
 							continue;
 						inputSignals.append(sigmap(cell->getPort(bit.wire->name)));
 					}
 
-					for (auto bit : subcell->getPort(ID::DST))
+					for (auto bit : dst_sig)
 					{
 						if (!bit.wire || !cell->hasPort(bit.wire->name))
 							continue;
@@ -201,26 +186,65 @@ struct SccWorker
 			sigToNextCells.find(cellToNextSig[cell], cellToNextCell[cell]);
 
 			if (!nofeedbackMode && cellToNextCell[cell].count(cell)) {
-				log("Found an SCC:");
 				pool<RTLIL::Cell*> scc;
-				log(" %s", RTLIL::id2cstr(cell->name));
 				cell2scc[cell] = sccList.size();
 				scc.insert(cell);
 				sccList.push_back(scc);
-				log("\n");
 			}
 		}
 
-		labelCounter = 0;
-		cellLabels.clear();
+		if (maxDepth >= 0)
+		{
+			// the shared engine has no notion of a depth limit, so -max_depth
+			// still uses the legacy depth-limited search
+			labelCounter = 0;
+			cellLabels.clear();
+
+			while (!workQueue.empty())
+			{
+				RTLIL::Cell *cell = *workQueue.begin();
+				log_assert(cellStack.size() == 0);
+				cellDepth.clear();
 
-		while (!workQueue.empty())
+				run(cell, 0, maxDepth);
+			}
+		}
+		else
 		{
-			RTLIL::Cell *cell = *workQueue.begin();
-			log_assert(cellStack.size() == 0);
-			cellDepth.clear();
+			std::vector<RTLIL::Cell*> cellByIndex(workQueue.begin(), workQueue.end());
+			dict<RTLIL::Cell*, int> cellToIndex;
+			for (int i = 0; i < GetSize(cellByIndex); i++)
+				cellToIndex[cellByIndex[i]] = i;
+
+			IntGraph graph;
+			for (int i = 0; i < GetSize(cellByIndex); i++)
+				for (auto nextCell : cellToNextCell[cellByIndex[i]])
+					if (nextCell != cellByIndex[i])
+						graph.add_edge(i, cellToIndex.at(nextCell));
+
+			// single-cell components are either loop-free or direct feedback
+			// (already handled above), so only multi-cell components count
+			ParallelTopoSortedSccs(graph, [&](int *begin, int *end) {
+				if (end - begin < 2)
+					return;
+				pool<RTLIL::Cell*> scc;
+				for (int *it = begin; it != end; ++it) {
+					RTLIL::Cell *c = cellByIndex[*it];
+					cell2scc[c] = sccList.size();
+					scc.insert(c);
+				}
+				sccList.push_back(scc);
+			}).process_all();
+		}
+	}
 
-			run(cell, 0, maxDepth);
+	void report()
+	{
+		for (auto &scc : sccList) {
+			log("Found an SCC:");
+			for (auto cell : scc)
+				log(" %s", RTLIL::id2cstr(cell->name));
+			log("\n");
 		}
 
 		log("Found %d SCCs in module %s.\n", int(sccList.size()), RTLIL::id2cstr(module->name));
@@ -343,9 +367,62 @@ struct SccPass : public Pass {
 		RTLIL::Selection newSelection(false);
 		int scc_counter = 0;
 
-		for (auto mod : design->selected_modules())
+		CellTypes ct, specifyCells;
+
+		if (allCellTypes) {
+			ct.setup(design);
+		} else {
+			ct.setup_internals();
+			ct.setup_stdcells();
+		}
+
+		// Discover boxes with specify rules in them, for special handling.
+		if (specifyMode) {
+			for (auto mod : design->modules())
+				if (mod->get_blackbox_attribute(false))
+					for (auto cell : mod->cells())
+						if (cell->type == ID($specify2))
+						{
+							specifyCells.setup_module(mod);
+							break;
+						}
+		}
+
+		std::vector<RTLIL::Module*> modules;
+		for (auto mod : design->selected_modules()) {
+			if (mod->processes.size() > 0) {
+				log("Skipping module %s as it contains processes (run 'proc' pass first).\n", mod->name.c_str());
+				continue;
+			}
+			modules.push_back(mod);
+		}
+
+		// The per-module graph construction is not strictly read-only: the
+		// sigmap and the port accesses lazily unpack module-stored SigSpecs,
+		// and copying SigSpecs updates shared chunk-buffer refcounts. Both
+		// are only safe to overlap in builds with thread-safe refcounts, so
+		// the pool dispatch follows the same gating as ModulePass. All
+		// reporting and annotation happens below on this thread.
+		std::vector<std::unique_ptr<SccWorker>> workers(modules.size());
+
+		bool use_pool = false;
+#ifdef YOSYS_THREADSAFE_IDS
+		use_pool = GetSize(modules) > 1 && design->monitors.empty() &&
+				ThreadPool::get().num_threads() > 1;
+#endif
+
+		if (use_pool)
+			ThreadPool::get().parallel_for(GetSize(modules), [&](int i) {
+				workers[i].reset(new SccWorker(design, modules[i], ct, specifyCells, nofeedbackMode, allCellTypes, maxDepth));
+			});
+		else
+			for (int i = 0; i < GetSize(modules); i++)
+				workers[i].reset(new SccWorker(design, modules[i], ct, specifyCells, nofeedbackMode, allCellTypes, maxDepth));
+
+		for (auto &worker_ptr : workers)
 		{
-			SccWorker worker(design, mod, nofeedbackMode, allCellTypes, specifyMode, maxDepth);
+			SccWorker &worker = *worker_ptr;
+			worker.report();
 
 			if (!setAttr.empty())
 			{
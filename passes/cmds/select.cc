@@ -30,6 +30,27 @@ using RTLIL::id2cstr;
 
 static std::vector<RTLIL::Selection> work_stack;
 
+// Re-evaluate a named selection expression if the design changed since its
+// cached result set was computed (defined below select_stmt)
+static void select_expr_update(RTLIL::Design *design, RTLIL::IdString set_name);
+
+// Digest of the design state a cached selection result depends on. Uses the
+// per-module change counters, so mutations that bypass the Module/Cell API
+// (e.g. attribute-only changes) are not detected.
+static uint64_t design_selection_digest(RTLIL::Design *design)
+{
+	uint64_t digest = 0xcbf29ce484222325ull;
+	auto mix = [&digest](uint64_t value) {
+		digest = (digest ^ value) * 0x100000001b3ull;
+	};
+	for (auto mod : design->modules()) {
+		mix(mod->name.hash());
+		mix(mod->change_count());
+	}
+	mix(std::hash<std::string>{}(design->selected_active_module));
+	return digest;
+}
+
 static bool match_ids(RTLIL::IdString id, const std::string &pattern)
 {
 	if (id == pattern)
@@ -54,6 +75,88 @@ static bool match_ids(RTLIL::IdString id, const std::string &pattern)
 	return false;
 }
 
+// Sorted per-module name indexes for prefix-bounded wildcard selections.
+// A selection like `w:core/alu*` used to run patmatch() over every wire in
+// the module; instead the names are kept sorted (with the leading '\'
+// stripped), the pattern's literal prefix selects one contiguous range via
+// binary search, and only that range is tested, so matching costs
+// O(log n + matches). The index is rebuilt lazily whenever the module's
+// change counter moves; like the selection digest above, mutations that
+// bypass the Module/Cell API are not detected.
+struct NameIndex
+{
+	uint64_t change_count = 0;
+	RTLIL::IdString module_name;
+	std::vector<std::pair<std::string, RTLIL::IdString>> wire_names, cell_names;
+};
+
+static dict<RTLIL::Module*, NameIndex> name_index_cache;
+
+static void name_index_add(std::vector<std::pair<std::string, RTLIL::IdString>> &index, RTLIL::IdString name)
+{
+	const char *c = name.c_str();
+	index.emplace_back(*c == '\\' ? c+1 : c, name);
+}
+
+static const NameIndex &get_name_index(RTLIL::Module *mod)
+{
+	if (name_index_cache.count(mod) == 0 && GetSize(name_index_cache) > 1000)
+		name_index_cache.clear();
+
+	NameIndex &index = name_index_cache[mod];
+	if (index.module_name == mod->name && index.change_count == mod->change_count() &&
+			GetSize(index.wire_names) == GetSize(mod->wires_) && GetSize(index.cell_names) == GetSize(mod->cells_))
+		return index;
+
+	index.change_count = mod->change_count();
+	index.module_name = mod->name;
+	index.wire_names.clear();
+	index.cell_names.clear();
+	index.wire_names.reserve(GetSize(mod->wires_));
+	index.cell_names.reserve(GetSize(mod->cells_));
+	for (auto wire : mod->wires())
+		name_index_add(index.wire_names, wire->name);
+	for (auto cell : mod->cells())
+		name_index_add(index.cell_names, cell->name);
+	std::sort(index.wire_names.begin(), index.wire_names.end());
+	std::sort(index.cell_names.begin(), index.cell_names.end());
+	return index;
+}
+
+// Literal prefix of a patmatch() pattern, usable for bounding the index
+// search. Returns false for patterns that cannot be bounded: a leading
+// wildcard, or '$' patterns, which may also match private names through the
+// last-segment rule in match_ids().
+static bool pattern_literal_prefix(const std::string &pattern, std::string &prefix)
+{
+	size_t from = (!pattern.empty() && pattern[0] == '\\') ? 1 : 0;
+	size_t to = pattern.find_first_of("*?[", from);
+	prefix = pattern.substr(from, (to == std::string::npos ? pattern.size() : to) - from);
+	return !prefix.empty() && prefix[0] != '$';
+}
+
+// Call visit(name) for every indexed name matching the pattern, testing
+// only the names in the pattern's literal-prefix range where possible.
+template <typename F>
+static void visit_matching_names(const std::vector<std::pair<std::string, RTLIL::IdString>> &index,
+		const std::string &pattern, F visit)
+{
+	std::string prefix;
+	size_t begin = 0, end = index.size();
+	if (pattern_literal_prefix(pattern, prefix)) {
+		begin = std::lower_bound(index.begin(), index.end(), prefix,
+				[](const std::pair<std::string, RTLIL::IdString> &a, const std::string &b) {
+					return a.first < b;
+				}) - index.begin();
+		end = begin;
+		while (end < index.size() && index[end].first.compare(0, prefix.size(), prefix) == 0)
+			end++;
+	}
+	for (size_t i = begin; i != end; i++)
+		if (match_ids(index[i].second, pattern))
+			visit(index[i].second);
+}
+
 static bool match_attr_val(const RTLIL::Const &value, const std::string &pattern, char match_op)
 {
 	if (match_op == 0)
@@ -413,6 +516,20 @@ namespace {
 		char mode;
 		std::set<RTLIL::IdString> cell_types, port_names;
 	};
+
+	// Connectivity index for one expand operation. The rule and mode checks
+	// are baked in at build time, so each expansion level only has to walk
+	// the neighbourhood of the objects added by the previous level instead of
+	// re-scanning all cells of all modules (important for `%ci*` etc., where
+	// the number of levels can be large).
+	struct expand_index_t {
+		// wire name -> wire names connected via module connections
+		dict<RTLIL::IdString, pool<RTLIL::IdString>> wire2wires;
+		// wire name -> names of cells selectable from that wire
+		dict<RTLIL::IdString, pool<RTLIL::IdString>> wire2cells;
+		// cell name -> names of wires selectable from that cell
+		dict<RTLIL::IdString, pool<RTLIL::IdString>> cell2wires;
+	};
 }
 
 static int parse_comma_list(std::set<RTLIL::IdString> &tokens, const std::string &str, size_t pos, std::string stopchar)
@@ -431,70 +548,86 @@ static int parse_comma_list(std::set<RTLIL::IdString> &tokens, const std::string
 	}
 }
 
-static int select_op_expand(RTLIL::Design *design, RTLIL::Selection &lhs, std::vector<expand_rule_t> &rules, std::set<RTLIL::IdString> &limits, int max_objects, char mode, CellTypes &ct, bool eval_only)
+static void build_expand_index(RTLIL::Module *mod, expand_index_t &index, std::vector<expand_rule_t> &rules, char mode, CellTypes &ct, bool eval_only)
 {
-	int sel_objects = 0;
 	bool is_input, is_output;
-	for (auto mod : design->modules())
-	{
-		if (lhs.selected_whole_module(mod->name) || !lhs.selected_module(mod->name))
-			continue;
 
-		std::set<RTLIL::Wire*> selected_wires;
-		auto selected_members = lhs.selected_members[mod->name];
-
-		for (auto wire : mod->wires())
-			if (lhs.selected_member(mod->name, wire->name) && limits.count(wire->name) == 0)
-				selected_wires.insert(wire);
+	for (auto &conn : mod->connections())
+	{
+		std::vector<RTLIL::SigBit> conn_lhs = conn.first.to_sigbit_vector();
+		std::vector<RTLIL::SigBit> conn_rhs = conn.second.to_sigbit_vector();
 
-		for (auto &conn : mod->connections())
-		{
-			std::vector<RTLIL::SigBit> conn_lhs = conn.first.to_sigbit_vector();
-			std::vector<RTLIL::SigBit> conn_rhs = conn.second.to_sigbit_vector();
+		for (size_t i = 0; i < conn_lhs.size(); i++) {
+			if (conn_lhs[i].wire == nullptr || conn_rhs[i].wire == nullptr)
+				continue;
+			if (mode != 'i')
+				index.wire2wires[conn_rhs[i].wire->name].insert(conn_lhs[i].wire->name);
+			if (mode != 'o')
+				index.wire2wires[conn_lhs[i].wire->name].insert(conn_rhs[i].wire->name);
+		}
+	}
 
-			for (size_t i = 0; i < conn_lhs.size(); i++) {
-				if (conn_lhs[i].wire == nullptr || conn_rhs[i].wire == nullptr)
-					continue;
-				if (mode != 'i' && selected_wires.count(conn_rhs[i].wire) && selected_members.count(conn_lhs[i].wire->name) == 0)
-					lhs.selected_members[mod->name].insert(conn_lhs[i].wire->name), sel_objects++, max_objects--;
-				if (mode != 'o' && selected_wires.count(conn_lhs[i].wire) && selected_members.count(conn_rhs[i].wire->name) == 0)
-					lhs.selected_members[mod->name].insert(conn_rhs[i].wire->name), sel_objects++, max_objects--;
-			}
+	for (auto cell : mod->cells())
+	for (auto &conn : cell->connections())
+	{
+		char last_mode = '-';
+		if (eval_only && !yosys_celltypes.cell_evaluable(cell->type))
+			goto exclude_match;
+		for (auto &rule : rules) {
+			last_mode = rule.mode;
+			if (rule.cell_types.size() > 0 && rule.cell_types.count(cell->type) == 0)
+				continue;
+			if (rule.port_names.size() > 0 && rule.port_names.count(conn.first) == 0)
+				continue;
+			if (rule.mode == '+')
+				goto include_match;
+			else
+				goto exclude_match;
 		}
+		if (last_mode == '+')
+			goto exclude_match;
+	include_match:
+		is_input = mode == 'x' || ct.cell_input(cell->type, conn.first);
+		is_output = mode == 'x' || ct.cell_output(cell->type, conn.first);
+		for (auto &chunk : conn.second.chunks())
+			if (chunk.wire != nullptr) {
+				if (mode == 'x' || (mode == 'i' && is_output) || (mode == 'o' && is_input))
+					index.wire2cells[chunk.wire->name].insert(cell->name);
+				if (mode == 'x' || (mode == 'i' && is_input) || (mode == 'o' && is_output))
+					index.cell2wires[cell->name].insert(chunk.wire->name);
+			}
+	exclude_match:;
+	}
+}
 
-		for (auto cell : mod->cells())
-		for (auto &conn : cell->connections())
+static int select_op_expand(RTLIL::Selection &lhs, dict<RTLIL::IdString, expand_index_t> &index,
+		dict<RTLIL::IdString, pool<RTLIL::IdString>> &frontier, std::set<RTLIL::IdString> &limits, int max_objects)
+{
+	int sel_objects = 0;
+	for (auto &it : frontier)
+	{
+		expand_index_t &mod_index = index.at(it.first);
+		auto &members = lhs.selected_members[it.first];
+		pool<RTLIL::IdString> next_frontier;
+
+		for (auto &name : it.second)
 		{
-			char last_mode = '-';
-			if (eval_only && !yosys_celltypes.cell_evaluable(cell->type))
-				goto exclude_match;
-			for (auto &rule : rules) {
-				last_mode = rule.mode;
-				if (rule.cell_types.size() > 0 && rule.cell_types.count(cell->type) == 0)
-					continue;
-				if (rule.port_names.size() > 0 && rule.port_names.count(conn.first) == 0)
+			if (limits.count(name))
+				continue;
+			for (auto map_p : {&mod_index.wire2wires, &mod_index.wire2cells, &mod_index.cell2wires}) {
+				auto found = map_p->find(name);
+				if (found == map_p->end())
 					continue;
-				if (rule.mode == '+')
-					goto include_match;
-				else
-					goto exclude_match;
+				for (auto &other : found->second)
+					if (max_objects != 0 && members.count(other) == 0) {
+						members.insert(other);
+						next_frontier.insert(other);
+						sel_objects++, max_objects--;
+					}
 			}
-			if (last_mode == '+')
-				goto exclude_match;
-		include_match:
-			is_input = mode == 'x' || ct.cell_input(cell->type, conn.first);
-			is_output = mode == 'x' || ct.cell_output(cell->type, conn.first);
-			for (auto &chunk : conn.second.chunks())
-				if (chunk.wire != nullptr) {
-					if (max_objects != 0 && selected_wires.count(chunk.wire) > 0 && selected_members.count(cell->name) == 0)
-						if (mode == 'x' || (mode == 'i' && is_output) || (mode == 'o' && is_input))
-							lhs.selected_members[mod->name].insert(cell->name), sel_objects++, max_objects--;
-					if (max_objects != 0 && selected_members.count(cell->name) > 0 && limits.count(cell->name) == 0 && selected_members.count(chunk.wire->name) == 0)
-						if (mode == 'x' || (mode == 'i' && is_input) || (mode == 'o' && is_output))
-							lhs.selected_members[mod->name].insert(chunk.wire->name), sel_objects++, max_objects--;
-				}
-		exclude_match:;
 		}
+
+		it.second.swap(next_frontier);
 	}
 
 	return sel_objects;
@@ -555,6 +688,7 @@ static void select_op_expand(RTLIL::Design *design, const std::string &arg, char
 				std::string str = arg.substr(pos, endpos-pos);
 				if (str[0] == '@') {
 					str = RTLIL::escape_id(str.substr(1));
+					select_expr_update(design, str);
 					if (design->selection_vars.count(str) > 0) {
 						for (auto i1 : design->selection_vars.at(str).selected_members)
 						for (auto i2 : i1.second)
@@ -593,8 +727,20 @@ static void select_op_expand(RTLIL::Design *design, const std::string &arg, char
 	}
 #endif
 
+	// Index the modules with a partial selection once; the per-level expansion
+	// then only visits the neighbourhood of the newly selected objects.
+	dict<RTLIL::IdString, expand_index_t> index;
+	dict<RTLIL::IdString, pool<RTLIL::IdString>> frontier;
+	for (auto mod : design->modules()) {
+		if (work_stack.back().selected_whole_module(mod->name) || !work_stack.back().selected_module(mod->name))
+			continue;
+		build_expand_index(mod, index[mod->name], rules, mode, ct, eval_only);
+		for (auto &member : work_stack.back().selected_members[mod->name])
+			frontier[mod->name].insert(member);
+	}
+
 	while (levels-- > 0 && rem_objects != 0) {
-		int num_objects = select_op_expand(design, work_stack.back(), rules, limits, rem_objects, mode, ct, eval_only);
+		int num_objects = select_op_expand(work_stack.back(), index, frontier, limits, rem_objects);
 		if (num_objects == 0)
 			break;
 		rem_objects -= num_objects;
@@ -758,6 +904,7 @@ static void select_stmt(RTLIL::Design *design, std::string arg, bool disable_emp
 
 	if (arg[0] == '@') {
 		std::string set_name = RTLIL::escape_id(arg.substr(1));
+		select_expr_update(design, set_name);
 		if (design->selection_vars.count(set_name) > 0)
 			work_stack.push_back(design->selection_vars[set_name]);
 		else
@@ -829,24 +976,28 @@ static void select_stmt(RTLIL::Design *design, std::string arg, bool disable_emp
 		}
 
 		if (arg_memb.compare(0, 2, "w:") == 0) {
-			for (auto wire : mod->wires())
-				if (match_ids(wire->name, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(wire->name);
+			visit_matching_names(get_name_index(mod).wire_names, arg_memb.substr(2), [&](RTLIL::IdString name) {
+				sel.selected_members[mod->name].insert(name);
+			});
 		} else
 		if (arg_memb.compare(0, 2, "i:") == 0) {
-			for (auto wire : mod->wires())
-				if (wire->port_input && match_ids(wire->name, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(wire->name);
+			visit_matching_names(get_name_index(mod).wire_names, arg_memb.substr(2), [&](RTLIL::IdString name) {
+				if (mod->wire(name)->port_input)
+					sel.selected_members[mod->name].insert(name);
+			});
 		} else
 		if (arg_memb.compare(0, 2, "o:") == 0) {
-			for (auto wire : mod->wires())
-				if (wire->port_output && match_ids(wire->name, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(wire->name);
+			visit_matching_names(get_name_index(mod).wire_names, arg_memb.substr(2), [&](RTLIL::IdString name) {
+				if (mod->wire(name)->port_output)
+					sel.selected_members[mod->name].insert(name);
+			});
 		} else
 		if (arg_memb.compare(0, 2, "x:") == 0) {
-			for (auto wire : mod->wires())
-				if ((wire->port_input || wire->port_output) && match_ids(wire->name, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(wire->name);
+			visit_matching_names(get_name_index(mod).wire_names, arg_memb.substr(2), [&](RTLIL::IdString name) {
+				RTLIL::Wire *wire = mod->wire(name);
+				if (wire->port_input || wire->port_output)
+					sel.selected_members[mod->name].insert(name);
+			});
 		} else
 		if (arg_memb.compare(0, 2, "s:") == 0) {
 			size_t delim = arg_memb.substr(2).find(':');
@@ -871,9 +1022,9 @@ static void select_stmt(RTLIL::Design *design, std::string arg, bool disable_emp
 					sel.selected_members[mod->name].insert(it.first);
 		} else
 		if (arg_memb.compare(0, 2, "c:") == 0) {
-			for (auto cell : mod->cells())
-				if (match_ids(cell->name, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(cell->name);
+			visit_matching_names(get_name_index(mod).cell_names, arg_memb.substr(2), [&](RTLIL::IdString name) {
+				sel.selected_members[mod->name].insert(name);
+			});
 		} else
 		if (arg_memb.compare(0, 2, "t:") == 0) {
 			for (auto cell : mod->cells())
@@ -907,21 +1058,19 @@ static void select_stmt(RTLIL::Design *design, std::string arg, bool disable_emp
 			std::string orig_arg_memb = arg_memb;
 			if (arg_memb.compare(0, 2, "n:") == 0)
 				arg_memb = arg_memb.substr(2);
-			for (auto wire : mod->wires())
-				if (match_ids(wire->name, arg_memb)) {
-					sel.selected_members[mod->name].insert(wire->name);
-					arg_memb_found[orig_arg_memb] = true;
-				}
+			visit_matching_names(get_name_index(mod).wire_names, arg_memb, [&](RTLIL::IdString name) {
+				sel.selected_members[mod->name].insert(name);
+				arg_memb_found[orig_arg_memb] = true;
+			});
 			for (auto &it : mod->memories)
 				if (match_ids(it.first, arg_memb)) {
 					sel.selected_members[mod->name].insert(it.first);
 					arg_memb_found[orig_arg_memb] = true;
 				}
-			for (auto cell : mod->cells())
-				if (match_ids(cell->name, arg_memb)) {
-					sel.selected_members[mod->name].insert(cell->name);
-					arg_memb_found[orig_arg_memb] = true;
-				}
+			visit_matching_names(get_name_index(mod).cell_names, arg_memb, [&](RTLIL::IdString name) {
+				sel.selected_members[mod->name].insert(name);
+				arg_memb_found[orig_arg_memb] = true;
+			});
 			for (auto &it : mod->processes)
 				if (match_ids(it.first, arg_memb)) {
 					sel.selected_members[mod->name].insert(it.first);
@@ -969,6 +1118,50 @@ static std::string describe_selection_for_assert(RTLIL::Design *design, RTLIL::S
 	return desc;
 }
 
+static void select_expr_update(RTLIL::Design *design, RTLIL::IdString set_name)
+{
+	if (design->selection_exprs.count(set_name) == 0)
+		return;
+
+	uint64_t digest = design_selection_digest(design);
+	if (design->selection_exprs[set_name].valid && design->selection_exprs[set_name].digest == digest &&
+			design->selection_vars.count(set_name))
+		return;
+
+	static pool<RTLIL::IdString> busy;
+	if (busy.count(set_name))
+		log_cmd_error("Recursive evaluation of selection expression @%s.\n", RTLIL::unescape_id(set_name).c_str());
+	busy.insert(set_name);
+
+	std::string expr = design->selection_exprs[set_name].expr;
+	std::vector<RTLIL::Selection> saved_stack;
+	saved_stack.swap(work_stack);
+
+	try {
+		for (auto &token : split_tokens(expr))
+			select_stmt(design, token, true);
+		while (work_stack.size() > 1) {
+			select_op_union(design, work_stack.front(), work_stack.back());
+			work_stack.pop_back();
+		}
+	} catch (...) {
+		work_stack.swap(saved_stack);
+		busy.erase(set_name);
+		throw;
+	}
+
+	if (work_stack.empty())
+		design->selection_vars[set_name] = RTLIL::Selection(false);
+	else
+		design->selection_vars[set_name] = work_stack.back();
+
+	work_stack.swap(saved_stack);
+	busy.erase(set_name);
+
+	design->selection_exprs[set_name].digest = digest;
+	design->selection_exprs[set_name].valid = true;
+}
+
 PRIVATE_NAMESPACE_END
 YOSYS_NAMESPACE_BEGIN
 
@@ -1027,7 +1220,7 @@ struct SelectPass : public Pass {
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
 		log("\n");
-		log("    select [ -add | -del | -set <name> ] {-read <filename> | <selection>}\n");
+		log("    select [ -add | -del | -set <name> | -setexpr <name> ] {-read <filename> | <selection>}\n");
 		log("    select [ -unset <name> ]\n");
 		log("    select [ <assert_option> ] {-read <filename> | <selection>}\n");
 		log("    select [ -list | -write <filename> | -count | -clear ]\n");
@@ -1051,6 +1244,14 @@ struct SelectPass : public Pass {
 		log("        under the given name (see @<name> below). to save the current selection,\n");
 		log("        use \"select -set <name> %%\"\n");
 		log("\n");
+		log("    -setexpr <name>\n");
+		log("        like -set, but also remember the selection expression itself. when the\n");
+		log("        named selection is used (see @<name> below) after the design changed,\n");
+		log("        the expression is re-evaluated and the stored result is updated, so\n");
+		log("        the same @<name> can be passed to many commands without re-evaluating\n");
+		log("        an unchanged selection each time. changes that bypass the Module/Cell\n");
+		log("        API (e.g. attribute updates) do not trigger a re-evaluation.\n");
+		log("\n");
 		log("    -unset <name>\n");
 		log("        do not modify the current selection. instead remove a previously saved\n");
 		log("        selection under the given name (see @<name> below).\n");
@@ -1272,7 +1473,7 @@ struct SelectPass : public Pass {
 		int assert_max = -1;
 		int assert_min = -1;
 		std::string write_file, read_file;
-		std::string set_name, unset_name, sel_str;
+		std::string set_name, setexpr_name, unset_name, sel_str;
 
 		work_stack.clear();
 
@@ -1348,6 +1549,10 @@ struct SelectPass : public Pass {
 				set_name = RTLIL::escape_id(args[++argidx]);
 				continue;
 			}
+			if (arg == "-setexpr" && argidx+1 < args.size()) {
+				setexpr_name = RTLIL::escape_id(args[++argidx]);
+				continue;
+			}
 			if (arg == "-unset" && argidx+1 < args.size()) {
 				unset_name = RTLIL::escape_id(args[++argidx]);
 				continue;
@@ -1404,11 +1609,14 @@ struct SelectPass : public Pass {
 		if ((list_mode || !write_file.empty() || count_mode) && common_flagset_tally)
 			log_cmd_error("Options -list, -write and -count can not be combined with %s.\n", common_flagset);
 
-		if (!set_name.empty() && (list_mode || !write_file.empty() || count_mode || !unset_name.empty() || common_flagset_tally))
-			log_cmd_error("Option -set can not be combined with -list, -write, -count, -unset, %s.\n", common_flagset);
+		if (!set_name.empty() && (list_mode || !write_file.empty() || count_mode || !unset_name.empty() || !setexpr_name.empty() || common_flagset_tally))
+			log_cmd_error("Option -set can not be combined with -list, -write, -count, -unset, -setexpr, %s.\n", common_flagset);
+
+		if (!setexpr_name.empty() && (list_mode || !write_file.empty() || count_mode || !unset_name.empty() || !read_file.empty() || common_flagset_tally))
+			log_cmd_error("Option -setexpr can not be combined with -list, -write, -count, -unset, -read, %s.\n", common_flagset);
 
-		if (!unset_name.empty() && (list_mode || !write_file.empty() || count_mode || !set_name.empty() || common_flagset_tally))
-			log_cmd_error("Option -unset can not be combined with -list, -write, -count, -set, %s.\n", common_flagset);
+		if (!unset_name.empty() && (list_mode || !write_file.empty() || count_mode || !set_name.empty() || !setexpr_name.empty() || common_flagset_tally))
+			log_cmd_error("Option -unset can not be combined with -list, -write, -count, -set, -setexpr, %s.\n", common_flagset);
 
 		if (work_stack.size() == 0 && got_module) {
 			RTLIL::Selection sel;
@@ -1582,12 +1790,31 @@ struct SelectPass : public Pass {
 				design->selection_vars[set_name] = RTLIL::Selection(false);
 			else
 				design->selection_vars[set_name] = work_stack.back();
+			design->selection_exprs.erase(set_name);
+			return;
+		}
+
+		if (!setexpr_name.empty())
+		{
+			if (sel_str.empty())
+				log_cmd_error("Option -setexpr requires a selection expression.\n");
+			if (work_stack.size() == 0)
+				design->selection_vars[setexpr_name] = RTLIL::Selection(false);
+			else
+				design->selection_vars[setexpr_name] = work_stack.back();
+			auto &entry = design->selection_exprs[setexpr_name];
+			entry.expr = sel_str.substr(1);
+			entry.digest = design_selection_digest(design);
+			entry.valid = true;
 			return;
 		}
 
 		if (!unset_name.empty())
 		{
-			if (!design->selection_vars.erase(unset_name))
+			bool found = design->selection_vars.erase(unset_name) != 0;
+			if (design->selection_exprs.erase(unset_name))
+				found = true;
+			if (!found)
 				log_error("Selection '%s' does not exist!\n", unset_name.c_str());
 			return;
 		}
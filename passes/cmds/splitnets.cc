@@ -27,7 +27,7 @@ PRIVATE_NAMESPACE_BEGIN
 
 struct SplitnetsWorker
 {
-	std::map<RTLIL::Wire*, std::vector<RTLIL::SigBit>> splitmap;
+	dict<RTLIL::Wire*, std::vector<RTLIL::SigBit>, hash_ptr_ops> splitmap;
 
 	void append_wire(RTLIL::Module *module, RTLIL::Wire *wire, int offset, int width, std::string format)
 	{
@@ -87,6 +87,16 @@ struct SplitnetsWorker
 
 	void operator()(RTLIL::SigSpec &sig)
 	{
+		// don't unpack signals that reference none of the split wires
+		bool found = false;
+		for (auto &chunk : sig.chunks())
+			if (chunk.wire != nullptr && splitmap.count(chunk.wire) > 0) {
+				found = true;
+				break;
+			}
+		if (!found)
+			return;
+
 		for (auto &bit : sig)
 			if (splitmap.count(bit.wire) > 0)
 				bit = splitmap.at(bit.wire).at(bit.offset);
@@ -172,7 +182,7 @@ struct SplitnetsPass : public Pass {
 			{
 				CellTypes ct(design);
 
-				std::map<RTLIL::Wire*, std::set<int>> split_wires_at;
+				dict<RTLIL::Wire*, std::set<int>, hash_ptr_ops> split_wires_at;
 
 				for (auto c : module->cells())
 				for (auto &p : c->connections())
@@ -195,6 +205,11 @@ struct SplitnetsPass : public Pass {
 					}
 				}
 
+				int new_wire_count = 0;
+				for (auto &it : split_wires_at)
+					new_wire_count += GetSize(it.second) + 1;
+				module->reserve(new_wire_count, 0);
+
 				for (auto &it : split_wires_at) {
 					int cursor = 0;
 					for (int next_cursor : it.second) {
@@ -211,6 +226,11 @@ struct SplitnetsPass : public Pass {
 						worker.splitmap[wire] = std::vector<RTLIL::SigBit>();
 				}
 
+				int new_wire_count = 0;
+				for (auto &it : worker.splitmap)
+					new_wire_count += it.first->width;
+				module->reserve(new_wire_count, 0);
+
 				for (auto &it : worker.splitmap)
 					for (int i = 0; i < it.first->width; i++)
 						worker.append_wire(module, it.first, i, 1, format);
@@ -89,8 +89,13 @@ struct statdata_t
 		STAT_NUMERIC_MEMBERS
 	#undef X
 
-		for (auto wire : mod->selected_wires())
+		// all results are aggregates in id-sorted maps, so the sweeps are free
+		// to use the cache-friendly address order
+		for (auto wire : mod->wires_by_address())
 		{
+			if (!design->selected(mod, wire))
+				continue;
+
 			if (wire->port_input || wire->port_output) {
 				num_ports++;
 				num_port_bits += wire->width;
@@ -112,8 +117,11 @@ struct statdata_t
 			num_memory_bits += it.second->width * it.second->size;
 		}
 
-		for (auto cell : mod->selected_cells())
+		for (auto cell : mod->cells_by_address())
 		{
+			if (!design->selected(mod, cell))
+				continue;
+
 			RTLIL::IdString cell_type = cell->type;
 
 			if (width_mode)
@@ -327,6 +335,19 @@ struct statdata_t
 	}
 };
 
+// Per-module statistics cache. Keyed on the module's instance hash (unique
+// per Module object) and name, validated against the module's change counter
+// and the option/liberty configuration the entry was computed with. Only
+// wholly selected modules are cached; mutations that bypass the Module/Cell
+// API (e.g. direct width or attribute writes) are not tracked by the change
+// counter and hence not detected.
+struct stat_cache_entry_t {
+	uint64_t change_count;
+	std::string config;
+	statdata_t data;
+};
+static dict<std::pair<unsigned int, RTLIL::IdString>, stat_cache_entry_t> stat_cache;
+
 statdata_t hierarchy_worker(std::map<RTLIL::IdString, statdata_t> &mod_stat, RTLIL::IdString mod, int level, bool quiet = false)
 {
 	statdata_t mod_data = mod_stat.at(mod);
@@ -353,7 +374,7 @@ void read_liberty_cellarea(dict<IdString, cell_area_t> &cell_area, string libert
 	yosys_input_files.insert(liberty_file);
 	if (f.fail())
 		log_cmd_error("Can't open liberty file `%s': %s\n", liberty_file.c_str(), strerror(errno));
-	LibertyParser libparser(f);
+	LibertyParser libparser(f, liberty_file);
 	f.close();
 
 	for (auto cell : libparser.ast->children)
@@ -399,6 +420,13 @@ struct StatPass : public Pass {
 		log("        output the statistics in a machine-readable JSON format.\n");
 		log("        this is output to the console; use \"tee\" to output to a file.\n");
 		log("\n");
+		log("    -qor <filename>\n");
+		log("        append one JSON line with the aggregated statistics of this invocation\n");
+		log("        to the given file, for stage-by-stage QoR tracking in scripts.\n");
+		log("\n");
+		log("Per-module statistics are cached between invocations and only recomputed for\n");
+		log("modules that changed, so calling 'stat' after every stage stays cheap.\n");
+		log("\n");
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) override
 	{
@@ -406,7 +434,7 @@ struct StatPass : public Pass {
 		RTLIL::Module *top_mod = nullptr;
 		std::map<RTLIL::IdString, statdata_t> mod_stat;
 		dict<IdString, cell_area_t> cell_area;
-		string techname;
+		string techname, qor_file, liberty_sig;
 
 		size_t argidx;
 		for (argidx = 1; argidx < args.size(); argidx++)
@@ -419,6 +447,7 @@ struct StatPass : public Pass {
 				string liberty_file = args[++argidx];
 				rewrite_filename(liberty_file);
 				read_liberty_cellarea(cell_area, liberty_file);
+				liberty_sig += " " + liberty_file;
 				continue;
 			}
 			if (args[argidx] == "-tech" && argidx+1 < args.size()) {
@@ -435,6 +464,11 @@ struct StatPass : public Pass {
 				json_mode = true;
 				continue;
 			}
+			if (args[argidx] == "-qor" && argidx+1 < args.size()) {
+				qor_file = args[++argidx];
+				rewrite_filename(qor_file);
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
@@ -461,7 +495,20 @@ struct StatPass : public Pass {
 				if (mod->get_bool_attribute(ID::top))
 					top_mod = mod;
 
-			statdata_t data(design, mod, width_mode, cell_area, techname);
+			statdata_t data;
+			bool whole_module = design->selected_whole_module(mod->name);
+			std::string cache_config = techname + (width_mode ? " -width" : "") + liberty_sig;
+			auto cache_key = std::pair<unsigned int, RTLIL::IdString>(mod->hash(), mod->name);
+			auto cached = stat_cache.find(cache_key);
+
+			if (whole_module && cached != stat_cache.end() && cached->second.change_count == mod->change_count() &&
+					cached->second.config == cache_config) {
+				data = cached->second.data;
+			} else {
+				data = statdata_t(design, mod, width_mode, cell_area, techname);
+				if (whole_module)
+					stat_cache[cache_key] = stat_cache_entry_t{mod->change_count(), cache_config, data};
+			}
 			mod_stat[mod->name] = data;
 
 			if (json_mode) {
@@ -516,6 +563,40 @@ struct StatPass : public Pass {
 			log("}\n");
 		}
 
+		if (!qor_file.empty())
+		{
+			statdata_t qor_data;
+			if (top_mod != nullptr && mod_stat.count(top_mod->name))
+				qor_data = hierarchy_worker(mod_stat, top_mod->name, 0, /*quiet=*/true);
+			else
+				for (auto &it : mod_stat)
+					qor_data = qor_data + it.second;
+
+			std::ofstream f(qor_file, std::ofstream::app);
+			yosys_output_files.insert(qor_file);
+			if (f.fail())
+				log_error("Can't open '%s' for appending: %s\n", qor_file.c_str(), strerror(errno));
+
+			std::stringstream invocation;
+			std::copy(args.begin(), args.end(), std::ostream_iterator<std::string>(invocation, " "));
+
+			json11::Json::object entry;
+			entry["invocation"] = invocation.str();
+			if (top_mod != nullptr)
+				entry["top"] = log_id(top_mod->name);
+		#define X(_name) entry[#_name] = (int)qor_data._name;
+			STAT_INT_MEMBERS
+		#undef X
+			if (qor_data.area != 0)
+				entry["area"] = qor_data.area;
+			json11::Json::object by_type;
+			for (auto &it : qor_data.num_cells_by_type)
+				if (it.second)
+					by_type[log_id(it.first)] = (int)it.second;
+			entry["num_cells_by_type"] = by_type;
+			f << json11::Json(entry).dump() << std::endl;
+		}
+
 		log("\n");
 	}
 } StatPass;
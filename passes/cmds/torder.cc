@@ -19,6 +19,7 @@
 
 #include "kernel/yosys.h"
 #include "kernel/celltypes.h"
+#include "kernel/netgraph.h"
 #include "kernel/sigtools.h"
 #include "kernel/utils.h"
 
@@ -70,6 +71,19 @@ struct TorderPass : public Pass {
 		{
 			log("module %s\n", log_id(module));
 
+			// The default configuration applies the same level breaks as
+			// the cached NetGraph levelization, so its precomputed order
+			// can be printed directly. Loops fall through to the TopoSort
+			// path below, which enumerates the cells on each loop.
+			if (stop_db.empty() && !noautostop && design->selected_whole_module(module->name)) {
+				const NetGraph &graph = NetGraph::get(module);
+				if (!graph.has_comb_loops()) {
+					for (int node : graph.order)
+						log("  cell %s\n", log_id(graph.cells[node]));
+					continue;
+				}
+			}
+
 			SigMap sigmap(module);
 			dict<SigBit, pool<IdString>> bit_drivers, bit_users;
 			TopoSort<IdString, RTLIL::sort_by_id_str> toposort;
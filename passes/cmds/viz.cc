@@ -481,6 +481,34 @@ struct Graph {
 				last_section_header = p;
 			};
 
+			// The pairwise tag-comparison scans below dominate the runtime on
+			// large graphs. The graph is read-only between updates, so the
+			// scans can run on the thread pool, with per-chunk buffers of
+			// found pairs that are queued in deterministic order afterwards.
+			// With a single thread the scan order matches the serial code.
+			typedef std::vector<std::pair<int, int>> found_pairs_t;
+			auto parallel_pairs = [&](const std::function<void(GraphNode*, found_pairs_t&)> &visit)
+			{
+				ThreadPool &pool = ThreadPool::get();
+				if (pool.num_threads() == 1 || GetSize(nonterm_nodes) < 64) {
+					found_pairs_t found;
+					for (auto g : nonterm_nodes)
+						visit(g, found);
+					for (auto &p : found)
+						queue(node(p.first), node(p.second));
+					return;
+				}
+				int num_chunks = pool.num_threads();
+				std::vector<found_pairs_t> found(num_chunks);
+				pool.parallel_for(num_chunks, [&](int chunk) {
+					for (int i = chunk; i < GetSize(nonterm_nodes); i += num_chunks)
+						visit(nonterm_nodes[i], found[chunk]);
+				});
+				for (auto &chunk_found : found)
+					for (auto &p : chunk_found)
+						queue(node(p.first), node(p.second));
+			};
+
 			{
 				header("Any nodes with identical connections");
 				typedef pair<pool<GraphNode*, hash_ptr_ops>, pool<GraphNode*, hash_ptr_ops>> node_conn_t;
@@ -497,65 +525,65 @@ struct Graph {
 
 			if (!term) {
 				header("Source-Sink with identical tags");
-				for (auto g : nonterm_nodes) {
+				parallel_pairs([](GraphNode *g, found_pairs_t &found) {
 					for (auto n : g->downstream()) {
 						if (n->terminal) continue;
-						if (g->tags() == n->tags()) queue(g, n);
+						if (g->tags() == n->tags()) found.emplace_back(g->index, n->index);
 					}
-				}
+				});
 
 				header("Sibblings with identical tags");
-				for (auto g : nonterm_nodes) {
+				parallel_pairs([](GraphNode *g, found_pairs_t &found) {
 					auto process_conns = [&](const pool<GraphNode*, hash_ptr_ops> &stream) {
-						dict<std::vector<int>, pool<GraphNode*, hash_ptr_ops>> nodes_by_tags;
+						dict<std::vector<int>, std::vector<GraphNode*>> nodes_by_tags;
 						for (auto n : stream) {
 							if (n->terminal) continue;
 							std::vector<int> key;
 							for (auto kv : n->tags())
 								key.push_back(kv.first), key.push_back(kv.second);
 							auto &entry = nodes_by_tags[key];
-							for (auto m : entry) queue(n, m);
-							entry.insert(n);
+							for (auto m : entry) found.emplace_back(n->index, m->index);
+							entry.push_back(n);
 						}
 					};
 					process_conns(g->upstream());
 					process_conns(g->downstream());
-				}
+				});
 			}
 
 			if (!candidates.empty() || effort < 2) goto execute;
 
 			if (!term) {
 				header("Nodes with single fan-out and compatible tags");
-				for (auto g : nonterm_nodes) {
-					if (GetSize(g->downstream()) != 1) continue;
+				parallel_pairs([this](GraphNode *g, found_pairs_t &found) {
+					if (GetSize(g->downstream()) != 1) return;
 					auto n = *g->downstream().begin();
-					if (!n->terminal && compare_tags(g, n, true)) queue(g, n);
-				}
+					if (!n->terminal && compare_tags(g, n, true)) found.emplace_back(g->index, n->index);
+				});
 
 				header("Nodes with single fan-in and compatible tags");
-				for (auto g : nonterm_nodes) {
-					if (GetSize(g->upstream()) != 1) continue;
+				parallel_pairs([this](GraphNode *g, found_pairs_t &found) {
+					if (GetSize(g->upstream()) != 1) return;
 					auto n = *g->upstream().begin();
-					if (!n->terminal && compare_tags(g, n, true)) queue(g, n);
-				}
+					if (!n->terminal && compare_tags(g, n, true)) found.emplace_back(g->index, n->index);
+				});
 			}
 
 			if (!candidates.empty() || effort < 3) goto execute;
 
 			if (!term) {
 				header("Connected nodes with similar tags (strict)");
-				for (auto g : nonterm_nodes) {
+				parallel_pairs([this](GraphNode *g, found_pairs_t &found) {
 					for (auto n : g->downstream())
-						if (!n->terminal && compare_tags(g, n, true) > config.similar_thresh) queue(g, n);
-				}
+						if (!n->terminal && compare_tags(g, n, true) > config.similar_thresh) found.emplace_back(g->index, n->index);
+				});
 			}
 
 			if (!candidates.empty() || effort < 4) goto execute;
 
 			if (!term) {
 				header("Sibblings with similar tags (strict)");
-				for (auto g : nonterm_nodes) {
+				parallel_pairs([this](GraphNode *g, found_pairs_t &found) {
 					auto process_conns = [&](const pool<GraphNode*, hash_ptr_ops> &stream) {
 						std::vector<GraphNode*> nodes;
 						for (auto n : stream)
@@ -563,28 +591,28 @@ struct Graph {
 						for (int i = 0; i < GetSize(nodes); i++)
 							for (int j = 0; j < i; j++)
 								if (compare_tags(nodes[i], nodes[j], true) > config.similar_thresh)
-									queue(nodes[i], nodes[j]);
+									found.emplace_back(nodes[i]->index, nodes[j]->index);
 					};
 					process_conns(g->upstream());
 					process_conns(g->downstream());
-				}
+				});
 			}
 
 			if (!candidates.empty() || effort < 5) goto execute;
 
 			if (!term) {
 				header("Connected nodes with similar tags (non-strict)");
-				for (auto g : nonterm_nodes) {
+				parallel_pairs([this](GraphNode *g, found_pairs_t &found) {
 					for (auto n : g->downstream())
-						if (!n->terminal && compare_tags(g, n, false) > config.similar_thresh) queue(g, n);
-				}
+						if (!n->terminal && compare_tags(g, n, false) > config.similar_thresh) found.emplace_back(g->index, n->index);
+				});
 			}
 
 			if (!candidates.empty() || effort < 6) goto execute;
 
 			if (!term) {
 				header("Sibblings with similar tags (non-strict)");
-				for (auto g : nonterm_nodes) {
+				parallel_pairs([this](GraphNode *g, found_pairs_t &found) {
 					auto process_conns = [&](const pool<GraphNode*, hash_ptr_ops> &stream) {
 						std::vector<GraphNode*> nodes;
 						for (auto n : stream)
@@ -592,11 +620,11 @@ struct Graph {
 						for (int i = 0; i < GetSize(nodes); i++)
 							for (int j = 0; j < i; j++)
 								if (compare_tags(nodes[i], nodes[j], false) > config.similar_thresh)
-									queue(nodes[i], nodes[j]);
+									found.emplace_back(nodes[i]->index, nodes[j]->index);
 					};
 					process_conns(g->upstream());
 					process_conns(g->downstream());
-				}
+				});
 			}
 
 			if (!candidates.empty() || effort < 7) goto execute;
@@ -618,17 +646,17 @@ struct Graph {
 
 			if (!term) {
 				header("Connected nodes with similar tags (lax)");
-				for (auto g : nonterm_nodes) {
+				parallel_pairs([this](GraphNode *g, found_pairs_t &found) {
 					for (auto n : g->downstream())
-						if (!n->terminal && compare_tags(g, n, false)) queue(g, n);
-				}
+						if (!n->terminal && compare_tags(g, n, false)) found.emplace_back(g->index, n->index);
+				});
 			}
 
 			if (!candidates.empty() || effort < 9) goto execute;
 
 			if (!term) {
 				header("Sibblings with similar tags (lax)");
-				for (auto g : nonterm_nodes) {
+				parallel_pairs([this](GraphNode *g, found_pairs_t &found) {
 					auto process_conns = [&](const pool<GraphNode*, hash_ptr_ops> &stream) {
 						std::vector<GraphNode*> nodes;
 						for (auto n : stream)
@@ -636,11 +664,11 @@ struct Graph {
 						for (int i = 0; i < GetSize(nodes); i++)
 							for (int j = 0; j < i; j++)
 								if (compare_tags(nodes[i], nodes[j], false))
-									queue(nodes[i], nodes[j]);
+									found.emplace_back(nodes[i]->index, nodes[j]->index);
 					};
 					process_conns(g->upstream());
 					process_conns(g->downstream());
-				}
+				});
 			}
 
 		execute:
@@ -29,6 +29,22 @@
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
+// During simulation-mismatch hunts xprop is typically re-run after small
+// edits. The transformation consumes the cells it encodes, so there is no
+// per-cell marker to test on a re-run; instead we remember per module (keyed
+// by instance hash and name, like the stat cache) the change counter right
+// after a transformation. A wholly selected module whose counter and options
+// still match was transformed by a previous run in this session and is
+// skipped. Mutations that bypass the Module/Cell API are not tracked by the
+// change counter, but such edits also invalidate any x-encoding anyway.
+struct xprop_cache_entry_t
+{
+	uint64_t change_count;
+	std::string config;
+};
+
+static dict<std::pair<unsigned int, RTLIL::IdString>, xprop_cache_entry_t> xprop_done_cache;
+
 struct XpropOptions
 {
 	bool split_inputs = false;
@@ -1151,6 +1167,10 @@ struct XpropPass : public Pass {
 		log("        Add assertions checking that the encoding used by this pass never\n");
 		log("        produces x values within the encoded signals.\n");
 		log("\n");
+		log("When xprop is re-run in the same session, wholly selected modules that were\n");
+		log("already transformed with the same options and have not been modified since are\n");
+		log("skipped.\n");
+		log("\n");
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) override
 	{
@@ -1216,7 +1236,22 @@ struct XpropPass : public Pass {
 		Pass::call(design, "demuxmap");
 		log_pop();
 
+		std::string config = stringf("%d%d%d%d%d%d%d%d%d", options.split_inputs, options.split_outputs,
+				options.split_public, options.assume_encoding, options.assert_encoding,
+				options.assume_def_inputs, options.required, options.formal, options.debug_asserts);
+
 		for (auto module : design->selected_modules()) {
+			bool whole_module = design->selected_whole_module(module->name);
+			auto cache_key = std::pair<unsigned int, RTLIL::IdString>(module->hash(), module->name);
+
+			auto cache_it = xprop_done_cache.find(cache_key);
+			if (whole_module && cache_it != xprop_done_cache.end() &&
+					cache_it->second.change_count == module->change_count() &&
+					cache_it->second.config == config) {
+				log("Skipping module %s: unchanged since previous xprop run.\n", log_id(module));
+				continue;
+			}
+
 			if (options.assume_def_inputs) {
 				for (auto port : module->ports) {
 					auto wire = module->wire(port);
@@ -1241,6 +1276,10 @@ struct XpropPass : public Pass {
 			log_debug("Encode remaining signals.\n");
 			worker.encode_remaining();
 
+			if (whole_module)
+				xprop_done_cache[cache_key] = {module->change_count(), config};
+			else
+				xprop_done_cache.erase(cache_key);
 		}
 	}
 } XpropPass;
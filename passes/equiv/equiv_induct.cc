@@ -42,11 +42,12 @@ struct EquivInductWorker
 	pool<Cell*> cell_warn_cache;
 	SigPool undriven_signals;
 
-	EquivInductWorker(Module *module, const pool<Cell*> &unproven_equiv_cells, bool model_undef, int max_seq) : module(module), sigmap(module),
+	EquivInductWorker(Module *module, const pool<Cell*> &unproven_equiv_cells, bool model_undef, int max_seq, int timeout) : module(module), sigmap(module),
 			cells(module->selected_cells()), workset(unproven_equiv_cells),
 			satgen(ez.get(), &sigmap), max_seq(max_seq), success_counter(0)
 	{
 		satgen.model_undef = model_undef;
+		ez->setSolverTimeout(timeout);
 	}
 
 	void create_timestep(int step)
@@ -118,6 +119,10 @@ struct EquivInductWorker
 
 			log("  Proving existence of base case for step %d. (%d clauses over %d variables)\n", step, ez->numCnfClauses(), ez->numCnfVariables());
 			if (!ez->solve()) {
+				if (ez->getSolverTimoutStatus()) {
+					log("  Solver timeout. Giving up on this workset.\n");
+					return;
+				}
 				log("  Proof for base case failed. Circuit inherently diverges!\n");
 				return;
 			}
@@ -128,6 +133,10 @@ struct EquivInductWorker
 
 			log("  Proving induction step %d. (%d clauses over %d variables)\n", step, ez->numCnfClauses(), ez->numCnfVariables());
 			if (!ez->solve(new_step_not_consistent)) {
+				if (ez->getSolverTimoutStatus()) {
+					log("  Solver timeout. Giving up on this workset.\n");
+					return;
+				}
 				log("  Proof for induction step holds. Entire workset of %d cells proven!\n", GetSize(workset));
 				for (auto cell : workset)
 					cell->setPort(ID::B, cell->getPort(ID::A));
@@ -155,6 +164,11 @@ struct EquivInductWorker
 				cond = ez->AND(cond, ez->NOT(satgen.importUndefSigBit(bit_a, max_seq+1)));
 
 			if (!ez->solve(cond)) {
+				if (ez->getSolverTimoutStatus()) {
+					// the solver state is not reusable after an interrupted solve
+					log(" timeout.\n");
+					return;
+				}
 				log(" success!\n");
 				cell->setPort(ID::B, cell->getPort(ID::A));
 				success_counter++;
@@ -184,6 +198,10 @@ struct EquivInductPass : public Pass {
 		log("    -seq <N>\n");
 		log("        the max. number of time steps to be considered (default = 4)\n");
 		log("\n");
+		log("    -timeout <seconds>\n");
+		log("        maximum solver run time per proof (default = no limit). Cells\n");
+		log("        hitting the limit stay unproven.\n");
+		log("\n");
 		log("This command is very effective in proving complex sequential circuits, when\n");
 		log("the internal state of the circuit quickly propagates to $equiv cells.\n");
 		log("\n");
@@ -202,6 +220,7 @@ struct EquivInductPass : public Pass {
 		int success_counter = 0;
 		bool model_undef = false;
 		int max_seq = 4;
+		int timeout = 0;
 
 		log_header(design, "Executing EQUIV_INDUCT pass.\n");
 
@@ -215,6 +234,10 @@ struct EquivInductPass : public Pass {
 				max_seq = atoi(args[++argidx].c_str());
 				continue;
 			}
+			if (args[argidx] == "-timeout" && argidx+1 < args.size()) {
+				timeout = atoi(args[++argidx].c_str());
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
@@ -234,7 +257,7 @@ struct EquivInductPass : public Pass {
 				continue;
 			}
 
-			EquivInductWorker worker(module, unproven_equiv_cells, model_undef, max_seq);
+			EquivInductWorker worker(module, unproven_equiv_cells, model_undef, max_seq, timeout);
 			worker.run();
 			success_counter += worker.success_counter;
 		}
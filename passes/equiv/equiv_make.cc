@@ -38,6 +38,12 @@ struct EquivMakeWorker
 	pool<IdString> blacklist_names;
 	dict<IdString, dict<Const, Const>> encdata;
 
+	// base name -> suffixed name, filled in while cloning so the matching
+	// phase doesn't have to re-create (and re-intern) the suffixed names
+	// for every candidate
+	dict<IdString, IdString> gold_wire_ids, gate_wire_ids;
+	dict<IdString, IdString> gold_cell_ids, gate_cell_ids;
+
 	pool<SigBit> undriven_bits;
 	SigMap assign_map;
 
@@ -105,27 +111,39 @@ struct EquivMakeWorker
 		Module *gate_clone = gate_mod->clone();
 
 		for (auto it : gold_clone->wires().to_vector()) {
-			if ((it->name.isPublic() || inames) && blacklist_names.count(it->name) == 0)
+			IdString new_name = it->name.str() + "_gold";
+			if ((it->name.isPublic() || inames) && blacklist_names.count(it->name) == 0) {
 				wire_names.insert(it->name);
-			gold_clone->rename(it, it->name.str() + "_gold");
+				gold_wire_ids[it->name] = new_name;
+			}
+			gold_clone->rename(it, new_name);
 		}
 
 		for (auto it : gold_clone->cells().to_vector()) {
-			if ((it->name.isPublic() || inames) && blacklist_names.count(it->name) == 0)
+			IdString new_name = it->name.str() + "_gold";
+			if ((it->name.isPublic() || inames) && blacklist_names.count(it->name) == 0) {
 				cell_names.insert(it->name);
-			gold_clone->rename(it, it->name.str() + "_gold");
+				gold_cell_ids[it->name] = new_name;
+			}
+			gold_clone->rename(it, new_name);
 		}
 
 		for (auto it : gate_clone->wires().to_vector()) {
-			if ((it->name.isPublic() || inames) && blacklist_names.count(it->name) == 0)
+			IdString new_name = it->name.str() + "_gate";
+			if ((it->name.isPublic() || inames) && blacklist_names.count(it->name) == 0) {
 				wire_names.insert(it->name);
-			gate_clone->rename(it, it->name.str() + "_gate");
+				gate_wire_ids[it->name] = new_name;
+			}
+			gate_clone->rename(it, new_name);
 		}
 
 		for (auto it : gate_clone->cells().to_vector()) {
-			if ((it->name.isPublic() || inames) && blacklist_names.count(it->name) == 0)
+			IdString new_name = it->name.str() + "_gate";
+			if ((it->name.isPublic() || inames) && blacklist_names.count(it->name) == 0) {
 				cell_names.insert(it->name);
-			gate_clone->rename(it, it->name.str() + "_gate");
+				gate_cell_ids[it->name] = new_name;
+			}
+			gate_clone->rename(it, new_name);
 		}
 
 		gold_clone->cloneInto(equiv_mod);
@@ -151,11 +169,11 @@ struct EquivMakeWorker
 
 		for (auto id : wire_names)
 		{
-			IdString gold_id = id.str() + "_gold";
-			IdString gate_id = id.str() + "_gate";
+			auto gold_it = gold_wire_ids.find(id);
+			auto gate_it = gate_wire_ids.find(id);
 
-			Wire *gold_wire = equiv_mod->wire(gold_id);
-			Wire *gate_wire = equiv_mod->wire(gate_id);
+			Wire *gold_wire = gold_it != gold_wire_ids.end() ? equiv_mod->wire(gold_it->second) : nullptr;
+			Wire *gate_wire = gate_it != gate_wire_ids.end() ? equiv_mod->wire(gate_it->second) : nullptr;
 
 			if (encdata.count(id))
 			{
@@ -232,9 +250,12 @@ struct EquivMakeWorker
 				continue;
 			}
 
+			SigSpec gold_mapped = assign_map(gold_wire);
+			SigSpec gate_mapped = assign_map(gate_wire);
+
 			log("Presumably equivalent wires: %s (%s), %s (%s) -> %s\n",
-					log_id(gold_wire), log_signal(assign_map(gold_wire)),
-					log_id(gate_wire), log_signal(assign_map(gate_wire)), log_id(id));
+					log_id(gold_wire), log_signal(gold_mapped),
+					log_id(gate_wire), log_signal(gate_mapped), log_id(id));
 
 			if (gold_wire->port_output || gate_wire->port_output)
 			{
@@ -257,8 +278,8 @@ struct EquivMakeWorker
 						equiv_mod->addEquiv(NEW_ID, SigSpec(gold_wire, i), SigSpec(gate_wire, i), SigSpec(wire, i));
 				}
 
-				rd_signal_map.add(assign_map(gold_wire), wire);
-				rd_signal_map.add(assign_map(gate_wire), wire);
+				rd_signal_map.add(gold_mapped, wire);
+				rd_signal_map.add(gate_mapped, wire);
 			}
 			else
 			if (gold_wire->port_input || gate_wire->port_input)
@@ -269,8 +290,8 @@ struct EquivMakeWorker
 				gate_wire->port_input = false;
 				equiv_mod->connect(gold_wire, wire);
 				equiv_mod->connect(gate_wire, wire);
-				primary_inputs.add(assign_map(gold_wire));
-				primary_inputs.add(assign_map(gate_wire));
+				primary_inputs.add(gold_mapped);
+				primary_inputs.add(gate_mapped);
 				primary_inputs.add(wire);
 			}
 			else
@@ -283,11 +304,11 @@ struct EquivMakeWorker
 					SigSpec rdmap_gold, rdmap_gate, rdmap_equiv;
 
 					for (int i = 0; i < wire->width; i++) {
-						if (undriven_bits.count(assign_map(SigBit(gold_wire, i)))) {
+						if (undriven_bits.count(gold_mapped[i])) {
 							log("  Skipping signal bit %s [%d]: undriven on gold side.\n", id2cstr(gold_wire->name), i);
 							continue;
 						}
-						if (undriven_bits.count(assign_map(SigBit(gate_wire, i)))) {
+						if (undriven_bits.count(gate_mapped[i])) {
 							log("  Skipping signal bit %s [%d]: undriven on gate side.\n", id2cstr(gate_wire->name), i);
 							continue;
 						}
@@ -328,11 +349,11 @@ struct EquivMakeWorker
 
 		for (auto id : cell_names)
 		{
-			IdString gold_id = id.str() + "_gold";
-			IdString gate_id = id.str() + "_gate";
+			auto gold_it = gold_cell_ids.find(id);
+			auto gate_it = gate_cell_ids.find(id);
 
-			Cell *gold_cell = equiv_mod->cell(gold_id);
-			Cell *gate_cell = equiv_mod->cell(gate_id);
+			Cell *gold_cell = gold_it != gold_cell_ids.end() ? equiv_mod->cell(gold_it->second) : nullptr;
+			Cell *gate_cell = gate_it != gate_cell_ids.end() ? equiv_mod->cell(gate_it->second) : nullptr;
 
 			if (gold_cell == nullptr || gate_cell == nullptr || gold_cell->type != gate_cell->type || !ct.cell_known(gold_cell->type) ||
 					gold_cell->parameters != gate_cell->parameters || GetSize(gold_cell->connections()) != GetSize(gate_cell->connections()))
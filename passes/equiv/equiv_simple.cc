@@ -37,14 +37,156 @@ struct EquivSimpleWorker
 	int max_seq;
 	bool short_cones;
 	bool verbose;
+	bool gotTimeout;
 
 	pool<pair<Cell*, int>> imported_cells_cache;
+	uint64_t sim_rng_state;
 
-	EquivSimpleWorker(const vector<Cell*> &equiv_cells, SigMap &sigmap, dict<SigBit, Cell*> &bit2driver, int max_seq, bool short_cones, bool verbose, bool model_undef) :
+	EquivSimpleWorker(const vector<Cell*> &equiv_cells, SigMap &sigmap, dict<SigBit, Cell*> &bit2driver, int max_seq, bool short_cones, bool verbose, bool model_undef, int timeout) :
 			module(equiv_cells.front()->module), equiv_cells(equiv_cells), equiv_cell(nullptr),
-			sigmap(sigmap), bit2driver(bit2driver), satgen(ez.get(), &sigmap), max_seq(max_seq), short_cones(short_cones), verbose(verbose)
+			sigmap(sigmap), bit2driver(bit2driver), satgen(ez.get(), &sigmap), max_seq(max_seq), short_cones(short_cones), verbose(verbose),
+			gotTimeout(false), sim_rng_state(88172645463325252ull)
 	{
 		satgen.model_undef = model_undef;
+		ez->setSolverTimeout(timeout);
+	}
+
+	uint64_t sim_rand()
+	{
+		sim_rng_state ^= sim_rng_state << 13;
+		sim_rng_state ^= sim_rng_state >> 7;
+		sim_rng_state ^= sim_rng_state << 17;
+		return sim_rng_state;
+	}
+
+	// Word-parallel random simulation of the problem cone, evaluating 64
+	// random input patterns at once. Bits without a driver in the cone
+	// (primary inputs, cut points, FF outputs) get random values, exactly
+	// the bits that are free variables in the SAT problem. Returns false
+	// for cone cells without a simulation model here; those problems go
+	// straight to the solver as before.
+	bool sim_eval(SigBit bit, const pool<Cell*> &cone_cells, dict<SigBit, uint64_t> &values, uint64_t &result)
+	{
+		if (bit.wire == nullptr) {
+			if (bit == State::S0) { result = 0; return true; }
+			if (bit == State::S1) { result = ~(uint64_t)0; return true; }
+			return false;
+		}
+
+		auto it = values.find(bit);
+		if (it != values.end()) {
+			result = it->second;
+			return true;
+		}
+
+		Cell *cell = bit2driver.count(bit) ? bit2driver.at(bit) : nullptr;
+
+		if (cell == nullptr || !cone_cells.count(cell)) {
+			result = sim_rand();
+			values[bit] = result;
+			return true;
+		}
+
+		if (cell->type.in(ID($_BUF_), ID($_NOT_), ID($_AND_), ID($_NAND_), ID($_OR_), ID($_NOR_), ID($_XOR_), ID($_XNOR_),
+				ID($_ANDNOT_), ID($_ORNOT_), ID($_MUX_), ID($_NMUX_), ID($_AOI3_), ID($_OAI3_), ID($_AOI4_), ID($_OAI4_)))
+		{
+			uint64_t a = 0, b = 0, c = 0, d = 0, s = 0;
+
+			if (!sim_eval(sigmap(cell->getPort(ID::A))[0], cone_cells, values, a))
+				return false;
+			if (cell->hasPort(ID::B) && !sim_eval(sigmap(cell->getPort(ID::B))[0], cone_cells, values, b))
+				return false;
+			if (cell->hasPort(ID::C) && !sim_eval(sigmap(cell->getPort(ID::C))[0], cone_cells, values, c))
+				return false;
+			if (cell->hasPort(ID::D) && !sim_eval(sigmap(cell->getPort(ID::D))[0], cone_cells, values, d))
+				return false;
+			if (cell->hasPort(ID::S) && !sim_eval(sigmap(cell->getPort(ID::S))[0], cone_cells, values, s))
+				return false;
+
+			if (cell->type == ID($_BUF_)) result = a;
+			else if (cell->type == ID($_NOT_)) result = ~a;
+			else if (cell->type == ID($_AND_)) result = a & b;
+			else if (cell->type == ID($_NAND_)) result = ~(a & b);
+			else if (cell->type == ID($_OR_)) result = a | b;
+			else if (cell->type == ID($_NOR_)) result = ~(a | b);
+			else if (cell->type == ID($_XOR_)) result = a ^ b;
+			else if (cell->type == ID($_XNOR_)) result = ~(a ^ b);
+			else if (cell->type == ID($_ANDNOT_)) result = a & ~b;
+			else if (cell->type == ID($_ORNOT_)) result = a | ~b;
+			else if (cell->type == ID($_MUX_)) result = (a & ~s) | (b & s);
+			else if (cell->type == ID($_NMUX_)) result = ~((a & ~s) | (b & s));
+			else if (cell->type == ID($_AOI3_)) result = ~((a & b) | c);
+			else if (cell->type == ID($_OAI3_)) result = ~((a | b) & c);
+			else if (cell->type == ID($_AOI4_)) result = ~((a & b) | (c & d));
+			else result = ~((a | b) & (c | d));
+
+			values[bit] = result;
+			return true;
+		}
+
+		if (cell->type.in(ID($pos), ID($not), ID($and), ID($or), ID($xor), ID($xnor), ID($mux)))
+		{
+			SigSpec sig_y = sigmap(cell->getPort(ID::Y));
+			SigSpec sig_a = sigmap(cell->getPort(ID::A));
+
+			int idx = -1;
+			for (int i = 0; i < GetSize(sig_y); i++)
+				if (sig_y[i] == bit) {
+					idx = i;
+					break;
+				}
+
+			// stick to the trivial per-bit cases, no sign or zero extension
+			if (idx < 0 || GetSize(sig_a) != GetSize(sig_y))
+				return false;
+
+			uint64_t a = 0, b = 0, s = 0;
+
+			if (!sim_eval(sig_a[idx], cone_cells, values, a))
+				return false;
+
+			if (cell->type.in(ID($and), ID($or), ID($xor), ID($xnor), ID($mux))) {
+				SigSpec sig_b = sigmap(cell->getPort(ID::B));
+				if (GetSize(sig_b) != GetSize(sig_y))
+					return false;
+				if (!sim_eval(sig_b[idx], cone_cells, values, b))
+					return false;
+			}
+
+			if (cell->type == ID($mux)) {
+				SigSpec sig_s = sigmap(cell->getPort(ID::S));
+				if (GetSize(sig_s) != 1)
+					return false;
+				if (!sim_eval(sig_s[0], cone_cells, values, s))
+					return false;
+			}
+
+			if (cell->type.in(ID($pos))) result = a;
+			else if (cell->type == ID($not)) result = ~a;
+			else if (cell->type == ID($and)) result = a & b;
+			else if (cell->type == ID($or)) result = a | b;
+			else if (cell->type == ID($xor)) result = a ^ b;
+			else if (cell->type == ID($xnor)) result = ~(a ^ b);
+			else result = (a & ~s) | (b & s);
+
+			values[bit] = result;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool sim_refute(const pool<Cell*> &cone_cells, SigBit bit_a, SigBit bit_b)
+	{
+		dict<SigBit, uint64_t> values;
+		uint64_t val_a, val_b;
+
+		if (!sim_eval(bit_a, cone_cells, values, val_a))
+			return false;
+		if (!sim_eval(bit_b, cone_cells, values, val_b))
+			return false;
+
+		return (val_a ^ val_b) != 0;
 	}
 
 	bool find_input_cone(pool<SigBit> &next_seed, pool<Cell*> &cells_cone, pool<SigBit> &bits_cone, const pool<Cell*> &cells_stop, const pool<SigBit> &bits_stop, pool<SigBit> *input_bits, Cell *cell)
@@ -168,6 +310,20 @@ struct EquivSimpleWorker
 			problem_cells.insert(short_cells_cone_a.begin(), short_cells_cone_a.end());
 			problem_cells.insert(short_cells_cone_b.begin(), short_cells_cone_b.end());
 
+			// In the combinational case (-seq 0) a single differing random
+			// pattern is a definitive counterexample, so try 64 packed random
+			// patterns before building the CNF for the cone. For sequential
+			// proofs a shallow refutation would not be conclusive, since the
+			// loop below keeps tightening the problem with earlier timesteps.
+			if (max_seq == 0 && sim_refute(problem_cells, bit_a, bit_b)) {
+				if (verbose)
+					log("    Equivalence refuted by random simulation.\n");
+				else
+					log(" failed.\n");
+				ez->assume(ez->NOT(ez_context));
+				return false;
+			}
+
 			if (verbose)
 			{
 				log("    Adding %d new cells to the problem (%d A, %d B, %d shared).\n",
@@ -202,6 +358,12 @@ struct EquivSimpleWorker
 				log("    Problem size at t=%d: %d literals, %d clauses\n", step, ez->numCnfVariables(), ez->numCnfClauses());
 
 			if (!ez->solve(ez_context)) {
+				if (ez->getSolverTimoutStatus()) {
+					log(verbose ? "    Solver timeout.\n" : " timeout.\n");
+					gotTimeout = true;
+					ez->assume(ez->NOT(ez_context));
+					return false;
+				}
 				log(verbose ? "    Proved equivalence! Marking $equiv cell as proven.\n" : " success!\n");
 				equiv_cell->setPort(ID::B, equiv_cell->getPort(ID::A));
 				ez->assume(ez->NOT(ez_context));
@@ -269,6 +431,9 @@ struct EquivSimpleWorker
 			equiv_cell = c;
 			if (run_cell())
 				counter++;
+			// the solver state is not reusable after an interrupted solve
+			if (gotTimeout)
+				break;
 		}
 		return counter;
 	}
@@ -301,12 +466,18 @@ struct EquivSimplePass : public Pass {
 		log("    -seq <N>\n");
 		log("        the max. number of time steps to be considered (default = 1)\n");
 		log("\n");
+		log("    -timeout <seconds>\n");
+		log("        maximum solver run time per proof (default = no limit). Cells\n");
+		log("        hitting the limit stay unproven, so a later (stronger) prover\n");
+		log("        can still pick them up.\n");
+		log("\n");
 	}
 	void execute(std::vector<std::string> args, Design *design) override
 	{
 		bool verbose = false, short_cones = false, model_undef = false, nogroup = false;
 		int success_counter = 0;
 		int max_seq = 1;
+		int timeout = 0;
 
 		log_header(design, "Executing EQUIV_SIMPLE pass.\n");
 
@@ -332,6 +503,10 @@ struct EquivSimplePass : public Pass {
 				max_seq = atoi(args[++argidx].c_str());
 				continue;
 			}
+			if (args[argidx] == "-timeout" && argidx+1 < args.size()) {
+				timeout = atoi(args[++argidx].c_str());
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
@@ -383,7 +558,7 @@ struct EquivSimplePass : public Pass {
 				for (auto it2 : it.second)
 					cells.push_back(it2.second);
 
-				EquivSimpleWorker worker(cells, sigmap, bit2driver, max_seq, short_cones, verbose, model_undef);
+				EquivSimpleWorker worker(cells, sigmap, bit2driver, max_seq, short_cones, verbose, model_undef, timeout);
 				success_counter += worker.run();
 			}
 		}
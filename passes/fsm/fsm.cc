@@ -27,6 +27,12 @@ PRIVATE_NAMESPACE_BEGIN
 
 struct FsmPass : public Pass {
 	FsmPass() : Pass("fsm", "extract and optimize finite state machines") { }
+	std::vector<RTLIL::IdString> trigger_celltypes() override
+	{
+		// fsm_detect/fsm_extract only consider $dff and $adff state
+		// registers, all other sub-passes operate on $fsm cells
+		return {ID($dff), ID($adff), ID($fsm)};
+	}
 	void help() override
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -36,7 +36,33 @@ static RTLIL::Module *module;
 static SigMap assign_map;
 typedef std::pair<RTLIL::IdString, RTLIL::IdString> sig2driver_entry_t;
 static SigSet<sig2driver_entry_t> sig2driver, sig2trigger;
-static std::map<RTLIL::SigBit, std::set<RTLIL::SigBit>> exclusive_ctrls;
+
+// Exclusive control bits ($pmux select inputs, which are one-hot by
+// construction). Stored as shared groups with a per-bit membership list
+// instead of per-bit pair sets: a single 1000-way select would otherwise
+// need a million pair entries.
+static std::vector<std::vector<RTLIL::SigBit>> exclusive_groups;
+static std::map<RTLIL::SigBit, std::vector<int>> exclusive_ctrls;
+
+// call f(other) once for every bit that is exclusive with the given bit
+template<typename F>
+static void foreach_exclusive(const RTLIL::SigBit &bit, F f)
+{
+	auto it = exclusive_ctrls.find(bit);
+	if (it == exclusive_ctrls.end())
+		return;
+	if (GetSize(it->second) == 1) {
+		for (auto &other : exclusive_groups[it->second.front()])
+			if (other != bit)
+				f(other);
+		return;
+	}
+	pool<RTLIL::SigBit> seen;
+	for (int group_idx : it->second)
+		for (auto &other : exclusive_groups[group_idx])
+			if (other != bit && seen.insert(other).second)
+				f(other);
+}
 
 static bool find_states(RTLIL::SigSpec sig, const RTLIL::SigSpec &dff_out, RTLIL::SigSpec &ctrl, std::map<RTLIL::Const, int> &states, RTLIL::Const *reset_state = NULL)
 {
@@ -168,25 +194,28 @@ undef_bit_in_next_state:
 			ctrl_in_bit_indices[ctrl_in[i]] = i;
 
 		for (auto &it : ctrl_in_bit_indices)
-			if (tr.ctrl_in.bits.at(it.second) == State::S1 && exclusive_ctrls.count(it.first) != 0)
-				for (auto &dc_bit : exclusive_ctrls.at(it.first))
+			if (tr.ctrl_in.bits.at(it.second) == State::S1)
+				foreach_exclusive(it.first, [&](const RTLIL::SigBit &dc_bit) {
 					if (ctrl_in_bit_indices.count(dc_bit))
 						tr.ctrl_in.bits.at(ctrl_in_bit_indices.at(dc_bit)) = RTLIL::State::Sa;
+				});
 
 		RTLIL::Const log_state_in = RTLIL::Const(RTLIL::State::Sx, fsm_data.state_bits);
 		if (state_in >= 0)
 			log_state_in = fsm_data.state_table.at(state_in);
 
-		if (states.count(ce.values_map(ce.assign_map(dff_in)).as_const()) == 0) {
+		RTLIL::Const state_out_val = ce.values_map(ce.assign_map(dff_in)).as_const();
+
+		if (states.count(state_out_val) == 0) {
 			log("  transition: %10s %s -> INVALID_STATE(%s) %s  <ignored invalid transition!>%s\n",
 					log_signal(log_state_in), log_signal(tr.ctrl_in),
-					log_signal(ce.values_map(ce.assign_map(dff_in))), log_signal(tr.ctrl_out),
+					log_signal(state_out_val), log_signal(tr.ctrl_out),
 					undef_bit_in_next_state_mode ? " SHORTENED" : "");
 			return;
 		}
 
 		tr.state_in = state_in;
-		tr.state_out = states.at(ce.values_map(ce.assign_map(dff_in)).as_const());
+		tr.state_out = states.at(state_out_val);
 
 		if (dff_in.is_fully_def()) {
 			fsm_data.transition_table.push_back(tr);
@@ -216,14 +245,16 @@ undef_bit_in_next_state:
 		ce.push();
 		dont_care.append(undef);
 		ce.set(undef, constval.as_const());
-		if (exclusive_ctrls.count(undef) && constval == State::S1)
-			for (auto &bit : exclusive_ctrls.at(undef)) {
-				RTLIL::SigSpec bitval = bit;
-				if (ce.eval(bitval) && bitval != State::S0)
-					goto found_contradiction_1;
-				else
-					ce.set(bit, State::S0);
-			}
+		std::vector<RTLIL::SigBit> excl_bits;
+		if (constval == State::S1)
+			foreach_exclusive(undef.as_bit(), [&](const RTLIL::SigBit &bit) { excl_bits.push_back(bit); });
+		for (auto &bit : excl_bits) {
+			RTLIL::SigSpec bitval = bit;
+			if (ce.eval(bitval) && bitval != State::S0)
+				goto found_contradiction_1;
+			else
+				ce.set(bit, State::S0);
+		}
 		find_transitions(ce, ce_nostop, fsm_data, states, state_in, ctrl_in, ctrl_out, dff_in, dont_care);
 	found_contradiction_1:
 		ce.pop();
@@ -239,14 +270,15 @@ undef_bit_in_next_state:
 		ce.push(), ce_nostop.push();
 		ce.set(undef, State::S1);
 		ce_nostop.set(undef, State::S1);
-		if (exclusive_ctrls.count(undef))
-			for (auto &bit : exclusive_ctrls.at(undef)) {
-				RTLIL::SigSpec bitval = bit;
-				if ((ce.eval(bitval) || ce_nostop.eval(bitval)) && bitval != State::S0)
-					goto found_contradiction_2;
-				else
-					ce.set(bit, State::S0), ce_nostop.set(bit, RTLIL::S0);
-			}
+		std::vector<RTLIL::SigBit> excl_bits;
+		foreach_exclusive(undef.as_bit(), [&](const RTLIL::SigBit &bit) { excl_bits.push_back(bit); });
+		for (auto &bit : excl_bits) {
+			RTLIL::SigSpec bitval = bit;
+			if ((ce.eval(bitval) || ce_nostop.eval(bitval)) && bitval != State::S0)
+				goto found_contradiction_2;
+			else
+				ce.set(bit, State::S0), ce_nostop.set(bit, RTLIL::S0);
+		}
 		find_transitions(ce, ce_nostop, fsm_data, states, state_in, ctrl_in, ctrl_out, dff_in, dont_care);
 	found_contradiction_2:
 		ce.pop(), ce_nostop.pop();
@@ -431,6 +463,7 @@ struct FsmExtractPass : public Pass {
 
 			sig2driver.clear();
 			sig2trigger.clear();
+			exclusive_groups.clear();
 			exclusive_ctrls.clear();
 			for (auto cell : module->cells()) {
 				for (auto &conn_it : cell->connections()) {
@@ -448,10 +481,12 @@ struct FsmExtractPass : public Pass {
 				}
 				if (cell->type == ID($pmux)) {
 					RTLIL::SigSpec sel_sig = assign_map(cell->getPort(ID::S));
-					for (auto &bit1 : sel_sig)
-					for (auto &bit2 : sel_sig)
-						if (bit1 != bit2)
-							exclusive_ctrls[bit1].insert(bit2);
+					if (GetSize(sel_sig) > 1) {
+						int group_idx = GetSize(exclusive_groups);
+						exclusive_groups.push_back(sel_sig.to_sigbit_vector());
+						for (auto &bit : sel_sig)
+							exclusive_ctrls[bit].push_back(group_idx);
+					}
 				}
 			}
 
@@ -117,21 +117,29 @@ struct FsmOpt
 		delete_this_transition:;
 		}
 
+		bool removed_inputs = false;
 		for (int i = int(ctrl_in_used.size())-1; i >= 0; i--) {
 			if (!ctrl_in_used[i]) {
 				log("  Removing unused input signal %s.\n", log_signal(cell->getPort(ID::CTRL_IN).extract(i, 1)));
-				for (auto &tr : new_transition_table) {
-					RTLIL::SigSpec tmp(tr.ctrl_in);
-					tmp.remove(i, 1);
-					tr.ctrl_in = tmp.as_const();
-				}
 				RTLIL::SigSpec new_ctrl_in = cell->getPort(ID::CTRL_IN);
 				new_ctrl_in.remove(i, 1);
 				cell->setPort(ID::CTRL_IN, new_ctrl_in);
 				fsm_data.num_inputs--;
+				removed_inputs = true;
 			}
 		}
 
+		// drop all removed columns with a single pass over the transition table
+		if (removed_inputs)
+			for (auto &tr : new_transition_table) {
+				RTLIL::Const new_ctrl;
+				new_ctrl.bits.reserve(fsm_data.num_inputs);
+				for (int i = 0; i < GetSize(ctrl_in_used); i++)
+					if (ctrl_in_used[i])
+						new_ctrl.bits.push_back(tr.ctrl_in.bits[i]);
+				tr.ctrl_in = std::move(new_ctrl);
+			}
+
 		fsm_data.transition_table.swap(new_transition_table);
 		new_transition_table.clear();
 	}
@@ -160,10 +168,15 @@ struct FsmOpt
 	{
 		RTLIL::SigSpec &ctrl_in = cell->connections_[ID::CTRL_IN];
 
-		for (int i = 0; i < ctrl_in.size(); i++)
-		for (int j = i+1; j < ctrl_in.size(); j++)
-			if (ctrl_in.extract(i, 1) == ctrl_in.extract(j, 1))
+		// find aliased input bits with a single scan instead of comparing all
+		// index pairs
+		dict<RTLIL::SigBit, int> first_input_idx;
+		for (int j = 0; j < ctrl_in.size(); j++)
+		{
+			auto r = first_input_idx.insert(std::make_pair(ctrl_in[j], j));
+			if (!r.second)
 			{
+				int i = r.first->second;
 				log("  Optimize handling of signal %s that is connected to inputs %d and %d.\n", log_signal(ctrl_in.extract(i, 1)), i, j);
 				std::vector<FsmData::transition_t> new_transition_table;
 
@@ -191,6 +204,7 @@ struct FsmOpt
 				fsm_data.transition_table.swap(new_transition_table);
 				new_transition_table.clear();
 			}
+		}
 	}
 
 	void opt_feedback_inputs()
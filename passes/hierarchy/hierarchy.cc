@@ -19,6 +19,7 @@
  */
 
 #include "kernel/yosys.h"
+#include "frontends/ast/ast.h"
 #include "frontends/verific/verific.h"
 #include <stdlib.h>
 #include <stdio.h>
@@ -318,8 +319,119 @@ struct IFExpander
 	}
 };
 
+// A Verilog library file given with -libfile. The file is read and indexed
+// (module name -> byte range) on first use, but individual module definitions
+// are only parsed when a missing module actually resolves to them, so a large
+// cell library only costs one lexical scan plus the parse time of the handful
+// of modules the design instantiates.
+struct LibraryFile
+{
+	std::string path;
+	bool indexed = false;
+	std::string text;   // entire file, kept for extracting definitions
+	std::string header; // text before the first module (`define lines etc.)
+	dict<std::string, std::pair<size_t, size_t>> spans;
+
+	LibraryFile(const std::string &path) : path(path) { }
+
+	static bool id_char(char c)
+	{
+		return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_' || c == '$';
+	}
+
+	// Lexical scan only: skips comments and strings, records the byte range
+	// of every module...endmodule (or macromodule) region.
+	void build_index()
+	{
+		indexed = true;
+
+		std::ifstream f(path, std::ifstream::binary);
+		if (f.fail())
+			log_error("Can't open library file `%s'.\n", path.c_str());
+		text.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+
+		size_t module_start = 0, header_end = text.size();
+		std::string module_name;
+		bool in_module = false, expect_name = false;
+
+		for (size_t i = 0; i < text.size();)
+		{
+			if (text.compare(i, 2, "//") == 0) {
+				i = text.find('\n', i);
+				if (i == std::string::npos) break;
+				continue;
+			}
+			if (text.compare(i, 2, "/*") == 0) {
+				i = text.find("*/", i + 2);
+				if (i == std::string::npos) break;
+				i += 2;
+				continue;
+			}
+			if (text[i] == '"') {
+				for (i++; i < text.size() && text[i] != '"'; i++)
+					if (text[i] == '\\')
+						i++;
+				i++;
+				continue;
+			}
+
+			std::string token;
+			size_t token_start = i;
+			if (text[i] == '\\') {
+				while (i < text.size() && !isspace(text[i]))
+					i++;
+				token = text.substr(token_start + 1, i - token_start - 1);
+			} else if (id_char(text[i]) && !('0' <= text[i] && text[i] <= '9')) {
+				while (i < text.size() && id_char(text[i]))
+					i++;
+				token = text.substr(token_start, i - token_start);
+			} else {
+				i++;
+				continue;
+			}
+
+			if (expect_name) {
+				module_name = token;
+				expect_name = false;
+			} else if (!in_module && (token == "module" || token == "macromodule")) {
+				module_start = token_start;
+				header_end = min(header_end, token_start);
+				in_module = true, expect_name = true;
+			} else if (in_module && token == "endmodule") {
+				if (!module_name.empty())
+					spans[module_name] = std::pair<size_t, size_t>(module_start, i);
+				module_name.clear();
+				in_module = false;
+			}
+		}
+
+		header = text.substr(0, header_end);
+		log("Indexed library file `%s': %d modules.\n", path.c_str(), GetSize(spans));
+	}
+
+	RTLIL::Module *load_module(RTLIL::Design &design, const RTLIL::Cell &cell)
+	{
+		if (!indexed)
+			build_index();
+
+		auto it = spans.find(RTLIL::unescape_id(cell.type));
+		if (it == spans.end())
+			return nullptr;
+
+		std::string snippet = header + text.substr(it->second.first, it->second.second - it->second.first) + "\n";
+		std::istringstream snippet_f(snippet);
+		Frontend::frontend_call(&design, &snippet_f, path, "verilog");
+
+		RTLIL::Module *mod = design.module(cell.type);
+		if (!mod)
+			log_error("File `%s' from -libfile does not declare module `%s'.\n",
+			          path.c_str(), cell.type.c_str());
+		return mod;
+	}
+};
+
 // Get a module needed by a cell, either by deriving an abstract module or by
-// loading one from a directory in libdirs.
+// loading one from a directory in libdirs or a library file in libfiles.
 //
 // If the module can't be found and check is true then exit with an error
 // message. Otherwise, return a pointer to the module if we derived or loaded
@@ -329,7 +441,8 @@ RTLIL::Module *get_module(RTLIL::Design                  &design,
                           RTLIL::Cell                    &cell,
                           RTLIL::Module                  &parent,
                           bool                            check,
-                          const std::vector<std::string> &libdirs)
+                          const std::vector<std::string> &libdirs,
+                          std::vector<LibraryFile>       &libfiles)
 {
 	std::string cell_type = cell.type.str();
 	RTLIL::Module *abs_mod = design.module("$abstract" + cell_type);
@@ -368,6 +481,12 @@ RTLIL::Module *get_module(RTLIL::Design                  &design,
 		}
 	}
 
+	for (auto &libfile : libfiles) {
+		RTLIL::Module *mod = libfile.load_module(design, cell);
+		if (mod != nullptr)
+			return mod;
+	}
+
 	// We couldn't find the module anywhere. Complain if check is set.
 	if (check)
 		log_error("Module `%s' referenced in module `%s' in cell `%s' is not part of the design.\n",
@@ -439,8 +558,79 @@ void check_cell_connections(const RTLIL::Module &module, RTLIL::Cell &cell, RTLI
 	}
 }
 
+// Everything expand_module() reads from a module that has already converged:
+// the module's own structural state plus, for every instantiated cell type,
+// the identity and structural state of the module it resolves to. When this
+// signature is unchanged since a run in which expand_module() left the module
+// alone, running it again is guaranteed to be a no-op and can be skipped.
+//
+// Change detection is based on Module::change_count() and therefore shares
+// its contract: direct manipulation of public members such as attributes is
+// not seen. Modules still waiting on interface expansion, derivation or
+// $array unrolling are never cached.
+struct ExpandModuleSignature
+{
+	int flags;
+	uint64_t module_change_count;
+	// cell type -> (resolved module hash, resolved module change count),
+	// or (0, 0) for internal cell types with no module in the design
+	std::vector<std::tuple<RTLIL::IdString, unsigned int, uint64_t>> resolved;
+
+	bool operator==(const ExpandModuleSignature &other) const {
+		return flags == other.flags &&
+		       module_change_count == other.module_change_count &&
+		       resolved == other.resolved;
+	}
+};
+
+// Keyed by Module::hash(), which is unique per module object, so entries for
+// deleted modules can never match a module that reuses the same name. The
+// cache persists across pass invocations to make repeated hierarchy runs in
+// interactive sessions cheap.
+std::map<unsigned int, ExpandModuleSignature> expand_module_cache;
+
+bool expand_module_signature(RTLIL::Design *design, RTLIL::Module *module, int flags, ExpandModuleSignature &sig)
+{
+	if (module->get_bool_attribute(ID::cells_not_processed))
+		return false;
+
+	if (!module->get_bool_attribute(ID::interfaces_replaced_in_module))
+		for (auto wire : module->wires())
+			if ((wire->port_input || wire->port_output) && wire->get_bool_attribute(ID::is_interface))
+				return false;
+
+	sig.flags = flags;
+	sig.module_change_count = module->change_count();
+	sig.resolved.clear();
+
+	std::set<RTLIL::IdString> seen_types;
+	for (auto cell : module->cells()) {
+		if (cell->type.begins_with("$array:"))
+			return false;
+		if (cell->get_bool_attribute(ID::is_interface) || cell->get_bool_attribute(ID::module_not_derived))
+			return false;
+		if (!seen_types.insert(cell->type).second)
+			continue;
+		RTLIL::Module *mod = design->module(cell->type);
+		if (mod != nullptr) {
+			if (mod->get_bool_attribute(ID::is_interface))
+				return false;
+			sig.resolved.push_back(std::make_tuple(cell->type, mod->hash(), mod->change_count()));
+			continue;
+		}
+		// expand_module() would consult get_module() here: an internal cell
+		// type is skipped deterministically as long as no $abstract module
+		// for it exists, while an unresolved user cell type may become
+		// satisfiable from a libdir at any time, so don't cache in that case
+		if (cell->type[0] != '$' || design->module("$abstract" + cell->type.str()) != nullptr)
+			return false;
+		sig.resolved.push_back(std::make_tuple(cell->type, 0u, (uint64_t)0));
+	}
+	return true;
+}
+
 bool expand_module(RTLIL::Design *design, RTLIL::Module *module, bool flag_check, bool flag_simcheck, bool flag_smtcheck,
-		   std::vector<std::string> &libdirs)
+		   std::vector<std::string> &libdirs, std::vector<LibraryFile> &libfiles)
 {
 	bool did_something = false;
 	std::map<RTLIL::Cell*, std::pair<int, int>> array_cells;
@@ -478,7 +668,7 @@ bool expand_module(RTLIL::Design *design, RTLIL::Module *module, bool flag_check
 		RTLIL::Module *mod = design->module(cell->type);
 		if (!mod)
 		{
-			mod = get_module(*design, *cell, *module, flag_check || flag_simcheck || flag_smtcheck, libdirs);
+			mod = get_module(*design, *cell, *module, flag_check || flag_simcheck || flag_smtcheck, libdirs, libfiles);
 
 			// If we still don't have a module, treat the cell as a black box and skip
 			// it. Otherwise, we either loaded or derived something so should set the
@@ -761,6 +951,20 @@ struct HierarchyPass : public Pass {
 		log("        for unknown modules and automatically run read_verilog for each\n");
 		log("        unknown module.\n");
 		log("\n");
+		log("    -libfile <file>\n");
+		log("        search the specified Verilog library file for unknown modules. the\n");
+		log("        file is indexed once (module name to byte range) when the first\n");
+		log("        unknown module is encountered, and only the definitions of modules\n");
+		log("        that are actually needed are parsed. text before the first module\n");
+		log("        (e.g. `define lines) is prepended to every extracted definition.\n");
+		log("        can be used multiple times; -libdir directories are searched first.\n");
+		log("\n");
+		log("    -cache <directory>\n");
+		log("        cache elaborated parametric modules as binary RTLIL files in the\n");
+		log("        specified directory and reuse them in later runs when the module\n");
+		log("        source and parameter values are unchanged. The directory must\n");
+		log("        already exist.\n");
+		log("\n");
 		log("    -keep_positionals\n");
 		log("        per default this pass also converts positional arguments in cells\n");
 		log("        to arguments using port names. This option disables this behavior.\n");
@@ -828,6 +1032,8 @@ struct HierarchyPass : public Pass {
 		RTLIL::Module *top_mod = NULL;
 		std::string load_top_mod;
 		std::vector<std::string> libdirs;
+		std::vector<LibraryFile> libfiles;
+		std::string cache_dir;
 
 		bool auto_top_mode = false;
 		bool generate_mode = false;
@@ -922,6 +1128,14 @@ struct HierarchyPass : public Pass {
 				libdirs.push_back(args[++argidx]);
 				continue;
 			}
+			if (args[argidx] == "-libfile" && argidx+1 < args.size()) {
+				libfiles.push_back(LibraryFile(args[++argidx]));
+				continue;
+			}
+			if (args[argidx] == "-cache" && argidx+1 < args.size()) {
+				cache_dir = args[++argidx];
+				continue;
+			}
 			if (args[argidx] == "-top") {
 				if (++argidx >= args.size())
 					log_cmd_error("Option -top requires an additional argument!\n");
@@ -946,6 +1160,14 @@ struct HierarchyPass : public Pass {
 		}
 		extra_args(args, argidx, design, false);
 
+		// enable the elaboration cache for all derive calls made below.
+		// the guard also clears the setting when we leave this scope via
+		// an exception (e.g. log_cmd_error).
+		struct CacheDirGuard {
+			~CacheDirGuard() { AST::elaboration_cache_dir.clear(); }
+		} cache_dir_guard;
+		AST::elaboration_cache_dir = cache_dir;
+
 		if (!load_top_mod.empty())
 		{
 			IdString top_name = RTLIL::escape_id(load_top_mod);
@@ -1066,6 +1288,9 @@ struct HierarchyPass : public Pass {
 					mod->attributes.erase(ID::initial_top);
 		}
 
+		int expand_flags = (flag_check ? 1 : 0) | (flag_simcheck ? 2 : 0) | (flag_smtcheck ? 4 : 0);
+		int skipped_modules = 0;
+
 		bool did_something = true;
 		while (did_something)
 		{
@@ -1081,8 +1306,19 @@ struct HierarchyPass : public Pass {
 			}
 
 			for (auto module : used_modules) {
-				if (expand_module(design, module, flag_check, flag_simcheck, flag_smtcheck, libdirs))
+				ExpandModuleSignature sig;
+				bool cacheable = expand_module_signature(design, module, expand_flags, sig);
+				if (cacheable) {
+					auto cached = expand_module_cache.find(module->hash());
+					if (cached != expand_module_cache.end() && cached->second == sig) {
+						skipped_modules++;
+						continue;
+					}
+				}
+				if (expand_module(design, module, flag_check, flag_simcheck, flag_smtcheck, libdirs, libfiles))
 					did_something = true;
+				else if (cacheable)
+					expand_module_cache[module->hash()] = sig;
 			}
 
 
@@ -1108,6 +1344,25 @@ struct HierarchyPass : public Pass {
 			}
 		}
 
+		if (skipped_modules > 0)
+			log("Skipped re-expansion of %d unchanged modules.\n", skipped_modules);
+
+		// Drop cache entries for module objects that no longer exist, so the
+		// cache doesn't grow without bound across repeated invocations.
+		// Entries for modules of other designs are dropped too; that only
+		// costs a re-expansion the next time those designs are processed.
+		{
+			std::set<unsigned int> live_modules;
+			for (auto mod : design->modules())
+				live_modules.insert(mod->hash());
+			for (auto it = expand_module_cache.begin(); it != expand_module_cache.end();) {
+				if (live_modules.count(it->first) == 0)
+					it = expand_module_cache.erase(it);
+				else
+					++it;
+			}
+		}
+
 
 		if (top_mod != NULL) {
 			log_header(design, "Analyzing design hierarchy..\n");
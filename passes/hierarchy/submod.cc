@@ -42,11 +42,43 @@ struct SubmodWorker
 	struct SubModule
 	{
 		std::string name, full_name;
+		int part_id;
 		pool<RTLIL::Cell*> cells;
 	};
 
 	std::map<std::string, SubModule> submodules;
 
+	// Flat per-wire driver/sink index over all cells of the module, built
+	// once in the constructor and queried per submodule. For the external
+	// driven/used classification only the partition a driver or sink belongs
+	// to matters, so it is enough to remember the first partition seen and
+	// whether a second, different one showed up.
+	struct wire_io_t {
+		int driver_part = -2, sink_part = -2;
+		bool multi_driver_parts = false, multi_sink_parts = false;
+
+		void add_driver(int part) {
+			if (driver_part == -2)
+				driver_part = part;
+			else if (driver_part != part)
+				multi_driver_parts = true;
+		}
+		void add_sink(int part) {
+			if (sink_part == -2)
+				sink_part = part;
+			else if (sink_part != part)
+				multi_sink_parts = true;
+		}
+		bool driven_outside(int part) const {
+			return multi_driver_parts || (driver_part != -2 && driver_part != part);
+		}
+		bool used_outside(int part) const {
+			return multi_sink_parts || (sink_part != -2 && sink_part != part);
+		}
+	};
+	dict<RTLIL::Wire*, wire_io_t> wire_index;
+	std::vector<RTLIL::Cell*> unassigned_unknown_cells;
+
 	struct wire_flags_t {
 		RTLIL::Wire *new_wire;
 		RTLIL::Const is_int_driven;
@@ -54,7 +86,6 @@ struct SubmodWorker
 		wire_flags_t(RTLIL::Wire* wire) : new_wire(nullptr), is_int_driven(State::S0, GetSize(wire)), is_int_used(false), is_ext_driven(false), is_ext_used(false) { }
 	};
 	std::map<RTLIL::Wire*, wire_flags_t> wire_flags;
-	bool flag_found_something;
 
 	void flag_wire(RTLIL::Wire *wire, bool create, bool set_int_used, bool set_ext_driven, bool set_ext_used)
 	{
@@ -69,7 +100,6 @@ struct SubmodWorker
 			wire_flags.at(wire).is_ext_driven = true;
 		if (set_ext_used)
 			wire_flags.at(wire).is_ext_used = true;
-		flag_found_something = true;
 	}
 
 	void flag_signal(const RTLIL::SigSpec &sig, bool create, bool set_int_driven, bool set_int_used, bool set_ext_driven, bool set_ext_used)
@@ -78,11 +108,42 @@ struct SubmodWorker
 			if (c.wire != nullptr) {
 				flag_wire(c.wire, create, set_int_used, set_ext_driven, set_ext_used);
 				if (set_int_driven)
-					for (int i = c.offset; i < c.offset+c.width; i++) {
+					for (int i = c.offset; i < c.offset+c.width; i++)
 						wire_flags.at(c.wire).is_int_driven[i] = State::S1;
-						flag_found_something = true;
+			}
+	}
+
+	// Record every cell's driver/sink contribution per wire, tagged with the
+	// partition (submodule) the cell belongs to, or -1 for cells that stay in
+	// the module. Cells with unknown port directions count as both driver and
+	// sink on all their ports, matching the inout assumption made below.
+	void build_wire_index()
+	{
+		dict<RTLIL::Cell*, int> cell_part;
+		for (auto &it : submodules)
+			for (RTLIL::Cell *cell : it.second.cells)
+				cell_part[cell] = it.second.part_id;
+
+		for (auto cell : module->cells()) {
+			int part = cell_part.count(cell) ? cell_part.at(cell) : -1;
+			bool known = ct.cell_known(cell->type);
+			if (!known && part == -1)
+				unassigned_unknown_cells.push_back(cell);
+			for (auto &conn : cell->connections()) {
+				bool drives = known ? ct.cell_output(cell->type, conn.first) : true;
+				bool uses = known ? ct.cell_input(cell->type, conn.first) : true;
+				if (!drives && !uses)
+					continue;
+				for (auto &c : conn.second.chunks())
+					if (c.wire != nullptr) {
+						wire_io_t &io = wire_index[c.wire];
+						if (drives)
+							io.add_driver(part);
+						if (uses)
+							io.add_sink(part);
 					}
 			}
+		}
 	}
 
 	void handle_submodule(SubModule &submod)
@@ -100,18 +161,30 @@ struct SubmodWorker
 					flag_signal(conn.second, true, true, true, false, false);
 			}
 		}
-		for (auto cell : module->cells()) {
-			if (submod.cells.count(cell) > 0)
+		for (auto &it : wire_flags) {
+			auto idx = wire_index.find(it.first);
+			if (idx == wire_index.end())
 				continue;
-			if (ct.cell_known(cell->type)) {
-				for (auto &conn : cell->connections())
-					flag_signal(conn.second, false, false, false, ct.cell_output(cell->type, conn.first), ct.cell_input(cell->type, conn.first));
-			} else {
-				flag_found_something = false;
-				for (auto &conn : cell->connections())
-					flag_signal(conn.second, false, false, false, true, true);
-				if (flag_found_something)
+			if (idx->second.driven_outside(submod.part_id))
+				it.second.is_ext_driven = true;
+			if (idx->second.used_outside(submod.part_id))
+				it.second.is_ext_used = true;
+		}
+		// Cells assigned to other submodules are left out here: in non-copy
+		// mode they may already have been replaced by an instance of their
+		// new submodule, which has known port directions.
+		for (auto cell : unassigned_unknown_cells) {
+			for (auto &conn : cell->connections()) {
+				bool relevant = false;
+				for (auto &c : conn.second.chunks())
+					if (c.wire != nullptr && wire_flags.count(c.wire) > 0) {
+						relevant = true;
+						break;
+					}
+				if (relevant) {
 					log_warning("Port directions for cell %s (%s) are unknown. Assuming inout for all ports.\n", cell->name.c_str(), cell->type.c_str());
+					break;
+				}
 			}
 		}
 
@@ -289,6 +362,7 @@ struct SubmodWorker
 
 				if (submodules.count(submod_str) == 0) {
 					submodules[submod_str].name = submod_str;
+					submodules[submod_str].part_id = GetSize(submodules) - 1;
 					submodules[submod_str].full_name = module->name.str() + "_" + submod_str;
 					while (design->module(submodules[submod_str].full_name) != nullptr ||
 							module->count_id(submodules[submod_str].full_name) != 0)
@@ -305,6 +379,7 @@ struct SubmodWorker
 				if (!design->selected(module, cell))
 					continue;
 				submodules[opt_name].name = opt_name;
+				submodules[opt_name].part_id = 0;
 				submodules[opt_name].full_name = RTLIL::escape_id(opt_name);
 				submodules[opt_name].cells.insert(cell);
 			}
@@ -313,6 +388,9 @@ struct SubmodWorker
 				log("Nothing selected -> do nothing.\n");
 		}
 
+		if (!submodules.empty())
+			build_wire_index();
+
 		for (auto &it : submodules)
 			handle_submodule(it.second);
 	}
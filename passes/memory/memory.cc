@@ -27,6 +27,13 @@ PRIVATE_NAMESPACE_BEGIN
 
 struct MemoryPass : public Pass {
 	MemoryPass() : Pass("memory", "translate memories to basic cells") { }
+	std::vector<RTLIL::IdString> trigger_celltypes() override
+	{
+		// $bmux is included for memory_bmux2rom; unpacked memories are
+		// covered by the $mem special case in Pass::call()
+		return {ID($mem), ID($mem_v2), ID($memrd), ID($memrd_v2), ID($memwr),
+				ID($memwr_v2), ID($meminit), ID($meminit_v2), ID($bmux)};
+	}
 	void help() override
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
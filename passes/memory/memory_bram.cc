@@ -73,9 +73,24 @@ struct rules_t
 				if (e > dbits) log_error("Bram %s variant %d group %d has %d enable bits but only %d dbits.\n", log_id(name), variant, group, e, dbits);
 		}
 
-		vector<portinfo_t> make_portinfos() const
+		// Derived data that only depends on the bram description itself.
+		// It is computed once after parsing instead of being re-derived
+		// for every (memory, rule) evaluation.
+		int avail_rd_ports, avail_wr_ports;
+		vector<portinfo_t> base_portinfos;
+
+		void setup_derived()
 		{
-			vector<portinfo_t> portinfos;
+			avail_rd_ports = 0;
+			avail_wr_ports = 0;
+			for (int j = 0; j < groups; j++) {
+				if (GetSize(wrmode) < j || wrmode.at(j) == 0)
+					avail_rd_ports += GetSize(ports) < j ? ports.at(j) : 0;
+				if (GetSize(wrmode) < j || wrmode.at(j) != 0)
+					avail_wr_ports += GetSize(ports) < j ? ports.at(j) : 0;
+			}
+
+			base_portinfos.clear();
 			for (int i = 0; i < groups; i++)
 			for (int j = 0; j < ports[i]; j++) {
 				portinfo_t pi;
@@ -90,9 +105,13 @@ struct rules_t
 				pi.mapped_port = -1;
 				pi.make_transp = false;
 				pi.make_outreg = false;
-				portinfos.push_back(pi);
+				base_portinfos.push_back(pi);
 			}
-			return portinfos;
+		}
+
+		vector<portinfo_t> make_portinfos() const
+		{
+			return base_portinfos;
 		}
 
 		void find_variant_params(dict<IdString, Const> &variant_params, const bram_t &other) const
@@ -286,6 +305,7 @@ struct rules_t
 			}
 
 			data.check_vectors();
+			data.setup_derived();
 			brams[data.name].push_back(data);
 		}
 	}
@@ -396,6 +416,32 @@ struct rules_t
 
 		infile.close();
 	}
+
+	// Parsed rule files are cached per process, so flows that invoke
+	// memory_bram several times with the same -rules file do not re-parse
+	// and re-validate it on every invocation.  The cache entry is keyed
+	// on the file's modification time, so a rules file that is edited
+	// during an interactive session is still re-read.
+	static rules_t &cached(std::string filename)
+	{
+		static std::map<std::string, std::pair<time_t, std::unique_ptr<rules_t>>> cache;
+
+		std::string path = filename;
+		rewrite_filename(path);
+
+		time_t mtime = 0;
+		struct stat st;
+		if (stat(path.c_str(), &st) == 0)
+			mtime = st.st_mtime;
+
+		auto &entry = cache[path];
+		if (entry.second == nullptr || entry.first != mtime) {
+			entry.first = mtime;
+			entry.second.reset(new rules_t);
+			entry.second->parse(filename);
+		}
+		return *entry.second;
+	}
 };
 
 bool replace_memory(Mem &mem, const rules_t &rules, FfInitVals *initvals, const rules_t::bram_t &bram, const rules_t::match_t &match, dict<string, int> &match_properties, int mode)
@@ -1038,19 +1084,10 @@ void handle_memory(Mem &mem, const rules_t &rules, FfInitVals *initvals)
 			auto &bram = rules.brams.at(match.name).at(vi);
 			bool or_next_if_better = match.or_next_if_better || vi+1 < GetSize(rules.brams.at(match.name));
 
-			int avail_rd_ports = 0;
-			int avail_wr_ports = 0;
-			for (int j = 0; j < bram.groups; j++) {
-				if (GetSize(bram.wrmode) < j || bram.wrmode.at(j) == 0)
-					avail_rd_ports += GetSize(bram.ports) < j ? bram.ports.at(j) : 0;
-				if (GetSize(bram.wrmode) < j || bram.wrmode.at(j) != 0)
-					avail_wr_ports += GetSize(bram.ports) < j ? bram.ports.at(j) : 0;
-			}
-
 			log("  Checking rule #%d for bram type %s (variant %d):\n", i+1, log_id(bram.name), bram.variant);
-			log("    Bram geometry: abits=%d dbits=%d wports=%d rports=%d\n", bram.abits, bram.dbits, avail_wr_ports, avail_rd_ports);
+			log("    Bram geometry: abits=%d dbits=%d wports=%d rports=%d\n", bram.abits, bram.dbits, bram.avail_wr_ports, bram.avail_rd_ports);
 
-			int dups = avail_rd_ports ? (match_properties["rports"] + avail_rd_ports - 1) / avail_rd_ports : 1;
+			int dups = bram.avail_rd_ports ? (match_properties["rports"] + bram.avail_rd_ports - 1) / bram.avail_rd_ports : 1;
 			match_properties["dups"] = dups;
 
 			log("    Estimated number of duplicates for more read ports: dups=%d\n", match_properties["dups"]);
@@ -1201,6 +1238,11 @@ void handle_memory(Mem &mem, const rules_t &rules, FfInitVals *initvals)
 
 struct MemoryBramPass : public Pass {
 	MemoryBramPass() : Pass("memory_bram", "map memories to block rams") { }
+	std::vector<RTLIL::IdString> trigger_celltypes() override
+	{
+		// unpacked memories are covered by the $mem special case in Pass::call()
+		return {ID($mem), ID($mem_v2)};
+	}
 	void help() override
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -1306,25 +1348,36 @@ struct MemoryBramPass : public Pass {
 	}
 	void execute(vector<string> args, Design *design) override
 	{
-		rules_t rules;
+		vector<string> rules_files;
 
 		log_header(design, "Executing MEMORY_BRAM pass (mapping $mem cells to block memories).\n");
 
 		size_t argidx;
 		for (argidx = 1; argidx < args.size(); argidx++) {
 			if (args[argidx] == "-rules" && argidx+1 < args.size()) {
-				rules.parse(args[++argidx]);
+				rules_files.push_back(args[++argidx]);
 				continue;
 			}
 			break;
 		}
 		extra_args(args, argidx, design);
 
+		// The common case of a single rules file goes through the
+		// per-process cache.  Multiple -rules options accumulate into
+		// one combined rule set and are parsed fresh.
+		rules_t local_rules;
+		rules_t *rules = &local_rules;
+		if (GetSize(rules_files) == 1)
+			rules = &rules_t::cached(rules_files[0]);
+		else
+			for (auto &filename : rules_files)
+				local_rules.parse(filename);
+
 		for (auto mod : design->selected_modules()) {
 			SigMap sigmap(mod);
 			FfInitVals initvals(&sigmap, mod);
 			for (auto &mem : Mem::get_selected_memories(mod))
-				handle_memory(mem, rules, &initvals);
+				handle_memory(mem, *rules, &initvals);
 		}
 	}
 } MemoryBramPass;
@@ -607,8 +607,15 @@ struct MemoryDffWorker
 	void run()
 	{
 		std::vector<Mem> memories = Mem::get_selected_memories(module);
+		// The FF and mux lookup tables (modwalker, merger) are built once
+		// per module already; the SAT session is likewise shared by all
+		// memories, since the EN/address cones of ports of different
+		// memories tend to overlap.  This is sound because the imported
+		// clauses only describe cells that the merges below never touch
+		// (FF and memory cells are never imported), and all queries go
+		// through assumption literals.
+		QuickConeSat qcsat(modwalker);
 		for (auto &mem : memories) {
-			QuickConeSat qcsat(modwalker);
 			for (int i = 0; i < GetSize(mem.rd_ports); i++) {
 				if (!mem.rd_ports[i].clk_enable)
 					handle_rd_port(mem, qcsat, i);
@@ -168,12 +168,51 @@ struct Swizzle {
 	std::vector<std::vector<SwizzleBit>> bits;
 };
 
+// Everything the geometry selection in handle_geom depends on, reduced to
+// plain data.  Two configurations with equal keys get identical geometry,
+// which makes the result cacheable across memories — designs tend to
+// instantiate the same memory shape (eg. a FIFO) many times.
+struct GeomKey {
+	const Ram *def;
+	int width, size, start_offset;
+	int repl_port, score_emu;
+	std::vector<bool> byte_boundary, word_boundary;
+	// Per write port: variant definition, force_uniform flag, wide_log2,
+	// number of distinct enable bits, first non-uniform wide address bit,
+	// wide_log2 of the width-tied read port (or -1).
+	std::vector<std::tuple<const PortVariant *, bool, int, int, int, int>> wr_ports;
+	// Per read port: variant definition, wide_log2.
+	std::vector<std::pair<const PortVariant *, int>> rd_ports;
+
+	bool operator<(const GeomKey &other) const {
+		return std::tie(def, width, size, start_offset, repl_port, score_emu, byte_boundary, word_boundary, wr_ports, rd_ports) <
+				std::tie(other.def, other.width, other.size, other.start_offset, other.repl_port, other.score_emu, other.byte_boundary, other.word_boundary, other.wr_ports, other.rd_ports);
+	}
+};
+
+// The geometry fields of MemConfig that handle_geom computes.
+struct GeomSolution {
+	int base_width_log2;
+	int unit_width_log2;
+	std::vector<int> swizzle;
+	int hard_wide_mask;
+	int emu_wide_mask;
+	int repl_d;
+	int score_demux;
+	int score_mux;
+	double cost;
+};
+
+// Keyed by pointers into the Library, so only valid for one pass invocation.
+typedef std::map<GeomKey, GeomSolution> GeomCache;
+
 struct MemMapping {
 	MapWorker &worker;
 	QuickConeSat qcsat;
 	Mem &mem;
 	const Library &lib;
 	const PassOptions &opts;
+	GeomCache &geom_cache;
 	std::vector<MemConfig> cfgs;
 	bool logic_ok;
 	double logic_cost;
@@ -185,7 +224,7 @@ struct MemMapping {
 	dict<std::pair<int, int>, bool> wr_excludes_srst_cache;
 	std::string rejected_cfg_debug_msgs;
 
-	MemMapping(MapWorker &worker, Mem &mem, const Library &lib, const PassOptions &opts) : worker(worker), qcsat(worker.modwalker), mem(mem), lib(lib), opts(opts) {
+	MemMapping(MapWorker &worker, Mem &mem, const Library &lib, const PassOptions &opts, GeomCache &geom_cache) : worker(worker), qcsat(worker.modwalker), mem(mem), lib(lib), opts(opts), geom_cache(geom_cache) {
 		determine_style();
 		logic_ok = determine_logic_ok();
 		if (GetSize(mem.wr_ports) == 0)
@@ -1192,6 +1231,26 @@ void MemMapping::handle_geom() {
 		en.sort_and_unify();
 		wren_size.push_back(GetSize(en));
 	}
+	// For every write port, find the first wide address bit that is
+	// "non-uniform", ie. where the write enables differ between the two
+	// halves selected by that bit (or wide_log2 if there is none).  This
+	// only depends on the memory itself, not on the configuration, so it
+	// is computed once up front.
+	std::vector<int> wide_nu_first;
+	for (auto &port: mem.wr_ports) {
+		int first = port.wide_log2;
+		for (int j = 0; j < port.wide_log2; j++) {
+			bool uniform = true;
+			for (int k = 0; k < (1 << port.wide_log2); k += 2 << j)
+				if (port.en.extract(k * mem.width, mem.width << j) != port.en.extract((k + (1 << j)) * mem.width, mem.width << j))
+					uniform = false;
+			if (!uniform) {
+				first = j;
+				break;
+			}
+		}
+		wide_nu_first.push_back(first);
+	}
 	for (auto &cfg: cfgs) {
 		// First, create a set of "byte boundaries": the bit positions in source memory word
 		// that have write enable different from the previous bit in any write port.
@@ -1217,6 +1276,42 @@ void MemMapping::handle_geom() {
 				}
 			}
 		}
+		// Geometry selection is a pure function of the data collected in
+		// the key, so identical memory shapes mapped to the same ram
+		// definition share one solver run.
+		GeomKey key;
+		key.def = cfg.def;
+		key.width = mem.width;
+		key.size = mem.size;
+		key.start_offset = mem.start_offset;
+		key.repl_port = cfg.repl_port;
+		key.score_emu = cfg.score_emu;
+		key.byte_boundary = byte_boundary;
+		key.word_boundary = word_boundary;
+		for (int i = 0; i < GetSize(mem.wr_ports); i++) {
+			auto &port = mem.wr_ports[i];
+			auto &pcfg = cfg.wr_ports[i];
+			int tied_rd_wide_log2 = -1;
+			if (pcfg.def->width_tied && pcfg.rd_port != -1)
+				tied_rd_wide_log2 = mem.rd_ports[pcfg.rd_port].wide_log2;
+			key.wr_ports.push_back(std::make_tuple(pcfg.def, pcfg.force_uniform, port.wide_log2, wren_size[i], wide_nu_first[i], tied_rd_wide_log2));
+		}
+		for (int i = 0; i < GetSize(mem.rd_ports); i++)
+			key.rd_ports.push_back(std::make_pair(cfg.rd_ports[i].def, mem.rd_ports[i].wide_log2));
+		auto cache_it = geom_cache.find(key);
+		if (cache_it != geom_cache.end()) {
+			auto &sol = cache_it->second;
+			cfg.base_width_log2 = sol.base_width_log2;
+			cfg.unit_width_log2 = sol.unit_width_log2;
+			cfg.swizzle = sol.swizzle;
+			cfg.hard_wide_mask = sol.hard_wide_mask;
+			cfg.emu_wide_mask = sol.emu_wide_mask;
+			cfg.repl_d = sol.repl_d;
+			cfg.score_demux = sol.score_demux;
+			cfg.score_mux = sol.score_mux;
+			cfg.cost = sol.cost;
+			continue;
+		}
 		bool got_config = false;
 		int best_cost = 0;
 		int byte_width_log2 = 0;
@@ -1242,21 +1337,14 @@ void MemMapping::handle_geom() {
 		for (int i = 0; i < GetSize(mem.wr_ports); i++) {
 			auto &port = mem.wr_ports[i];
 			auto &pcfg = cfg.wr_ports[i];
-			for (int j = 0; j < port.wide_log2; j++) {
-				bool uniform = true;
-				// If write enables don't match, mark bit as non-uniform.
-				for (int k = 0; k < (1 << port.wide_log2); k += 2 << j)
-					if (port.en.extract(k * mem.width, mem.width << j) != port.en.extract((k + (1 << j)) * mem.width, mem.width << j))
-						uniform = false;
-				if (!uniform) {
-					if (pcfg.force_uniform) {
-						for (int k = j; k < port.wide_log2; k++)
-							no_wide_bits.insert(k);
-					}
-					if (j < wide_nu_start)
-						wide_nu_start = j;
-					break;
+			int j = wide_nu_first[i];
+			if (j < port.wide_log2) {
+				if (pcfg.force_uniform) {
+					for (int k = j; k < port.wide_log2; k++)
+						no_wide_bits.insert(k);
 				}
+				if (j < wide_nu_start)
+					wide_nu_start = j;
 			}
 			if (pcfg.def->width_tied && pcfg.rd_port != -1) {
 				// If:
@@ -1466,6 +1554,17 @@ hw_bit_failed:
 bw_done:;
 		}
 		log_assert(got_config);
+		GeomSolution sol;
+		sol.base_width_log2 = cfg.base_width_log2;
+		sol.unit_width_log2 = cfg.unit_width_log2;
+		sol.swizzle = cfg.swizzle;
+		sol.hard_wide_mask = cfg.hard_wide_mask;
+		sol.emu_wide_mask = cfg.emu_wide_mask;
+		sol.repl_d = cfg.repl_d;
+		sol.score_demux = cfg.score_demux;
+		sol.score_mux = cfg.score_mux;
+		sol.cost = cfg.cost;
+		geom_cache.insert({std::move(key), sol});
 	}
 }
 
@@ -2228,6 +2327,10 @@ struct MemoryLibMapPass : public Pass {
 
 		Library lib = parse_library(lib_files, defines);
 
+		// Shared by all memories mapped in this invocation; keyed by
+		// pointers into lib, so it must not outlive it.
+		GeomCache geom_cache;
+
 		for (auto module : design->selected_modules()) {
 			if (module->has_processes_warn())
 				continue;
@@ -2236,7 +2339,7 @@ struct MemoryLibMapPass : public Pass {
 			auto mems = Mem::get_selected_memories(module);
 			for (auto &mem : mems)
 			{
-				MemMapping map(worker, mem, lib, opts);
+				MemMapping map(worker, mem, lib, opts, geom_cache);
 				int idx = -1;
 				int best = map.logic_cost;
 				if (!map.logic_ok) {
@@ -396,6 +396,11 @@ struct MemoryMapWorker
 
 struct MemoryMapPass : public Pass {
 	MemoryMapPass() : Pass("memory_map", "translate multiport memories to basic cells") { }
+	std::vector<RTLIL::IdString> trigger_celltypes() override
+	{
+		// unpacked memories are covered by the $mem special case in Pass::call()
+		return {ID($mem), ID($mem_v2)};
+	}
 	void help() override
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
@@ -293,7 +293,7 @@ struct MemoryShareWorker
 	// Consolidate write ports using sat-based resource sharing
 	// --------------------------------------------------------
 
-	void consolidate_wr_using_sat(Mem &mem)
+	void consolidate_wr_using_sat(Mem &mem, QuickConeSat &qcsat)
 	{
 		if (GetSize(mem.wr_ports) <= 1)
 			return;
@@ -376,9 +376,9 @@ struct MemoryShareWorker
 				log("  Checking group clocked with %sedge %s, width %d: ports %s.\n", some_port.clk_polarity ? "pos" : "neg", log_signal(some_port.clk), mem.width << some_port.wide_log2, ports.c_str());
 			}
 
-			// Okay, time to actually run the SAT solver.
-
-			QuickConeSat qcsat(modwalker);
+			// Okay, time to actually run the SAT solver.  The solver session is
+			// shared by all groups (and all memories of the module), so cones
+			// already imported for an earlier group come for free here.
 
 			// create SAT representation of common input cone of all considered EN signals
 
@@ -387,9 +387,10 @@ struct MemoryShareWorker
 			for (auto idx : group)
 				port_to_sat_variable[idx] = qcsat.ez->expression(qcsat.ez->OpOr, qcsat.importSig(mem.wr_ports[idx].en));
 
+			int imported_cells_before = GetSize(qcsat.imported_cells);
 			qcsat.prepare();
 
-			log("  Common input cone for all EN signals: %d cells.\n", GetSize(qcsat.imported_cells));
+			log("  Common input cone for all EN signals: %d cells (%d new).\n", GetSize(qcsat.imported_cells), GetSize(qcsat.imported_cells) - imported_cells_before);
 
 			log("  Size of unconstrained SAT problem: %d variables, %d clauses\n", qcsat.ez->numCnfVariables(), qcsat.ez->numCnfClauses());
 
@@ -503,8 +504,14 @@ struct MemoryShareWorker
 
 		modwalker.setup(module);
 
+		// All SAT queries in this module share one incremental solver session.
+		// The imported clauses only encode the circuit itself, so cones imported
+		// for one port group remain valid (and get reused) for all later groups
+		// and memories; the per-pair queries are made via assumption literals.
+		QuickConeSat qcsat(modwalker);
+
 		for (auto &mem : memories)
-			consolidate_wr_using_sat(mem);
+			consolidate_wr_using_sat(mem, qcsat);
 	}
 };
 
@@ -50,6 +50,9 @@ struct OptPass : public Pass {
 		log("        opt_expr [-mux_undef] [-mux_bool] [-undriven] [-noclkinv] [-fine] [-full] [-keepdc]\n");
 		log("    while <changed design>\n");
 		log("\n");
+		log("Within the loop, each pass is skipped when no change that can create new\n");
+		log("opportunities for it has happened since its last run.\n");
+		log("\n");
 		log("When called with -fast the following script is used instead:\n");
 		log("\n");
 		log("    do\n");
@@ -164,18 +167,62 @@ struct OptPass : public Pass {
 		{
 			Pass::call(design, "opt_expr" + opt_expr_args);
 			Pass::call(design, "opt_merge -nomux" + opt_merge_args);
+
+			// Instead of blindly rerunning the whole child sequence until a
+			// full sweep changes nothing, each child declares what kinds of
+			// changes it makes (writes) and what kinds of changes can create
+			// new opportunities for it (reads). A child is only rerun when a
+			// change of a kind it reads has happened since its last run, so
+			// rounds where e.g. only opt_expr did work skip the children that
+			// cannot profit from expression rewrites.
+			//
+			// CHG_CLEAN (removal of unused cells and wires) is special: the
+			// inputs and connections of the remaining cells are untouched, so
+			// it cannot create new opportunities for the connection-driven
+			// passes. It does free up bits that were terminal for opt_muxtree,
+			// and opt_expr is kept subscribed for the -undriven case.
+
+			const unsigned CHG_CONST = 1; // constants and direct connections created
+			const unsigned CHG_CELL = 2;  // cells rewritten, merged or replaced
+			const unsigned CHG_FF = 4;    // FF transformations
+			const unsigned CHG_CLEAN = 8; // unused cells and wires removed
+			const unsigned CHG_ALL = CHG_CONST|CHG_CELL|CHG_FF|CHG_CLEAN;
+
+			struct sched_entry_t {
+				std::string command;
+				unsigned writes, reads;
+				unsigned pending;
+			};
+
+			std::vector<sched_entry_t> schedule;
+			schedule.push_back({"opt_muxtree",                 CHG_CELL,                   CHG_ALL,                  CHG_ALL});
+			schedule.push_back({"opt_reduce" + opt_reduce_args, CHG_CONST|CHG_CELL,        CHG_CONST|CHG_CELL|CHG_FF, CHG_ALL});
+			schedule.push_back({"opt_merge" + opt_merge_args,  CHG_CELL,                   CHG_CONST|CHG_CELL|CHG_FF, CHG_ALL});
+			if (opt_share)
+				schedule.push_back({"opt_share",               CHG_CELL,                   CHG_CONST|CHG_CELL|CHG_FF, CHG_ALL});
+			if (!noff_mode)
+				schedule.push_back({"opt_dff" + opt_dff_args,  CHG_CONST|CHG_CELL|CHG_FF,  CHG_CONST|CHG_CELL|CHG_FF, CHG_ALL});
+			schedule.push_back({"opt_clean" + opt_clean_args,  CHG_CLEAN,                  CHG_CONST|CHG_CELL|CHG_FF, CHG_ALL});
+			schedule.push_back({"opt_expr" + opt_expr_args,    CHG_CONST|CHG_CELL,         CHG_ALL,                  CHG_ALL});
+
 			while (1) {
-				design->scratchpad_unset("opt.did_something");
-				Pass::call(design, "opt_muxtree");
-				Pass::call(design, "opt_reduce" + opt_reduce_args);
-				Pass::call(design, "opt_merge" + opt_merge_args);
-				if (opt_share)
-					Pass::call(design, "opt_share");
-				if (!noff_mode)
-					Pass::call(design, "opt_dff" + opt_dff_args);
-				Pass::call(design, "opt_clean" + opt_clean_args);
-				Pass::call(design, "opt_expr" + opt_expr_args);
-				if (design->scratchpad_get_bool("opt.did_something") == false)
+				for (auto &entry : schedule) {
+					if (entry.pending == 0) {
+						log("Skipping %s (no changes since last run can affect it).\n", entry.command.c_str());
+						continue;
+					}
+					entry.pending = 0;
+					design->scratchpad_unset("opt.did_something");
+					Pass::call(design, entry.command);
+					if (design->scratchpad_get_bool("opt.did_something"))
+						for (auto &other : schedule)
+							other.pending |= other.reads & entry.writes;
+				}
+				bool keep_running = false;
+				for (auto &entry : schedule)
+					if (entry.pending != 0)
+						keep_running = true;
+				if (!keep_running)
 					break;
 				log_header(design, "Rerunning OPT passes. (Maybe there is more to do..)\n");
 			}
@@ -104,6 +104,40 @@ keep_cache_t keep_cache;
 CellTypes ct_reg, ct_all;
 int count_rm_cells, count_rm_wires;
 
+// design-resident skip index for 'clean'/'opt_clean': remembers each module's
+// change_count() right after its last clean, together with the purge mode it
+// was cleaned with. 'clean' runs after nearly every command in synth scripts,
+// and comparing the counter makes repeated runs on unchanged modules O(1).
+// A module cleaned with -purge is also clean for a non-purge run, but not the
+// other way around. Keys are the design and module hash ids, so recycled
+// pointers of deleted designs cannot produce false skips.
+//
+// Only modules without submodule instances are recorded: the keep cache
+// propagates keep attributes up through the hierarchy, so the cleanability of
+// a parent can change without its own change_count() moving. Also note that
+// change_count() does not track attribute-only edits (e.g. removing a keep
+// attribute); such an edit only takes effect on the first clean after the
+// next structural modification of the module.
+dict<std::pair<unsigned int, unsigned int>, std::pair<uint64_t, bool>> clean_index;
+
+bool rmunused_module_unchanged(RTLIL::Module *module, bool purge_mode)
+{
+	auto it = clean_index.find(std::make_pair(module->design->hash(), module->hash()));
+	if (it == clean_index.end() || it->second.first != module->change_count())
+		return false;
+	return it->second.second || !purge_mode;
+}
+
+void rmunused_module_mark_clean(RTLIL::Module *module, bool purge_mode)
+{
+	for (auto cell : module->cells())
+		if (module->design->module(cell->type) != nullptr)
+			return;
+
+	clean_index[std::make_pair(module->design->hash(), module->hash())] =
+			std::make_pair(module->change_count(), purge_mode);
+}
+
 void rmunused_module_cells(Module *module, bool verbose)
 {
 	SigMap sigmap(module);
@@ -596,6 +630,12 @@ bool rmunused_module_init(RTLIL::Module *module, bool verbose)
 
 void rmunused_module(RTLIL::Module *module, bool purge_mode, bool verbose, bool rminit)
 {
+	if (rmunused_module_unchanged(module, purge_mode)) {
+		if (verbose)
+			log("Skipping module %s: unchanged since last clean.\n", module->name.c_str());
+		return;
+	}
+
 	if (verbose)
 		log("Finding unused cells or wires in module %s..\n", module->name.c_str());
 
@@ -623,6 +663,8 @@ void rmunused_module(RTLIL::Module *module, bool purge_mode, bool verbose, bool
 
 	if (rminit && rmunused_module_init(module, verbose))
 		while (rmunused_module_signals(module, purge_mode, verbose)) { }
+
+	rmunused_module_mark_clean(module, purge_mode);
 }
 
 struct OptCleanPass : public Pass {
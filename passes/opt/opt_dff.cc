@@ -58,6 +58,14 @@ struct OptDffWorker
 	typedef std::pair<RTLIL::SigBit, bool> ctrl_t;
 	typedef std::set<ctrl_t> ctrls_t;
 
+	// Combined control signals created for merged enable / sync reset
+	// groups.  The result is a pure function of the control set, so FFs
+	// that end up in the same group share one piece of logic instead of
+	// each creating a duplicate for opt_merge to clean up later.  Fine
+	// and coarse logic is cached separately (indexed by make_gates).
+	std::map<std::pair<patterns_t, ctrls_t>, ctrl_t> patterns_logic_cache[2];
+	std::map<ctrls_t, ctrl_t> combined_resets_cache[2];
+
 	// Used as a queue.
 	std::vector<Cell *> dff_cells;
 
@@ -181,6 +189,11 @@ struct OptDffWorker
 			return *ctrls.begin();
 		}
 
+		auto cache_key = std::make_pair(patterns, ctrls);
+		auto cache_it = patterns_logic_cache[make_gates].find(cache_key);
+		if (cache_it != patterns_logic_cache[make_gates].end())
+			return cache_it->second;
+
 		RTLIL::SigSpec or_input;
 
 		for (auto pat : patterns)
@@ -211,10 +224,10 @@ struct OptDffWorker
 		}
 
 		if (GetSize(or_input) == 0)
-			return ctrl_t(State::S1, true);
+			return patterns_logic_cache[make_gates][cache_key] = ctrl_t(State::S1, true);
 
 		if (GetSize(or_input) == 1)
-			return ctrl_t(or_input, true);
+			return patterns_logic_cache[make_gates][cache_key] = ctrl_t(or_input, true);
 
 		RTLIL::SigSpec y = module->addWire(NEW_ID);
 		RTLIL::Cell *c = module->addReduceAnd(NEW_ID, or_input, y);
@@ -224,7 +237,7 @@ struct OptDffWorker
 			module->remove(c);
 		}
 
-		return ctrl_t(y, true);
+		return patterns_logic_cache[make_gates][cache_key] = ctrl_t(y, true);
 	}
 
 	ctrl_t combine_resets(const ctrls_t &ctrls, bool make_gates)
@@ -233,6 +246,10 @@ struct OptDffWorker
 			return *ctrls.begin();
 		}
 
+		auto cache_it = combined_resets_cache[make_gates].find(ctrls);
+		if (cache_it != combined_resets_cache[make_gates].end())
+			return cache_it->second;
+
 		RTLIL::SigSpec or_input;
 
 		bool final_pol = false;
@@ -258,7 +275,7 @@ struct OptDffWorker
 			module->remove(c);
 		}
 
-		return ctrl_t(y, final_pol);
+		return combined_resets_cache[make_gates][ctrls] = ctrl_t(y, final_pol);
 	}
 
 	bool run() {
@@ -735,8 +752,15 @@ struct OptDffWorker
 	}
 
 	bool run_constbits() {
-		ModWalker modwalker(module->design, module);
-		QuickConeSat qcsat(modwalker);
+		// The ModWalker and the SAT machinery are only ever queried in -sat
+		// mode, and building the module index is expensive on FF-heavy
+		// modules, so only set them up when they are actually used.
+		std::unique_ptr<ModWalker> modwalker;
+		std::unique_ptr<QuickConeSat> qcsat;
+		if (opt.sat) {
+			modwalker.reset(new ModWalker(module->design, module));
+			qcsat.reset(new QuickConeSat(*modwalker));
+		}
 
 		// Run as a separate sub-pass, so that we don't mutate (non-FF) cells under ModWalker.
 		bool did_something = false;
@@ -770,19 +794,19 @@ struct OptDffWorker
 						if (!opt.sat)
 							continue;
 						// For each register bit, try to prove that it cannot change from the initial value. If so, remove it
-						if (!modwalker.has_drivers(ff.sig_d.extract(i)))
+						if (!modwalker->has_drivers(ff.sig_d.extract(i)))
 							continue;
 						if (val != State::S0 && val != State::S1)
 							continue;
 
-						int init_sat_pi = qcsat.importSigBit(val);
-						int q_sat_pi = qcsat.importSigBit(ff.sig_q[i]);
-						int d_sat_pi = qcsat.importSigBit(ff.sig_d[i]);
+						int init_sat_pi = qcsat->importSigBit(val);
+						int q_sat_pi = qcsat->importSigBit(ff.sig_q[i]);
+						int d_sat_pi = qcsat->importSigBit(ff.sig_d[i]);
 
-						qcsat.prepare();
+						qcsat->prepare();
 
 						// Try to find out whether the register bit can change under some circumstances
-						bool counter_example_found = qcsat.ez->solve(qcsat.ez->IFF(q_sat_pi, init_sat_pi), qcsat.ez->NOT(qcsat.ez->IFF(d_sat_pi, init_sat_pi)));
+						bool counter_example_found = qcsat->ez->solve(qcsat->ez->IFF(q_sat_pi, init_sat_pi), qcsat->ez->NOT(qcsat->ez->IFF(d_sat_pi, init_sat_pi)));
 
 						// If the register bit cannot change, we can replace it with a constant
 						if (counter_example_found)
@@ -798,19 +822,19 @@ struct OptDffWorker
 						if (!opt.sat)
 							continue;
 						// For each register bit, try to prove that it cannot change from the initial value. If so, remove it
-						if (!modwalker.has_drivers(ff.sig_ad.extract(i)))
+						if (!modwalker->has_drivers(ff.sig_ad.extract(i)))
 							continue;
 						if (val != State::S0 && val != State::S1)
 							continue;
 
-						int init_sat_pi = qcsat.importSigBit(val);
-						int q_sat_pi = qcsat.importSigBit(ff.sig_q[i]);
-						int d_sat_pi = qcsat.importSigBit(ff.sig_ad[i]);
+						int init_sat_pi = qcsat->importSigBit(val);
+						int q_sat_pi = qcsat->importSigBit(ff.sig_q[i]);
+						int d_sat_pi = qcsat->importSigBit(ff.sig_ad[i]);
 
-						qcsat.prepare();
+						qcsat->prepare();
 
 						// Try to find out whether the register bit can change under some circumstances
-						bool counter_example_found = qcsat.ez->solve(qcsat.ez->IFF(q_sat_pi, init_sat_pi), qcsat.ez->NOT(qcsat.ez->IFF(d_sat_pi, init_sat_pi)));
+						bool counter_example_found = qcsat->ez->solve(qcsat->ez->IFF(q_sat_pi, init_sat_pi), qcsat->ez->NOT(qcsat->ez->IFF(d_sat_pi, init_sat_pi)));
 
 						// If the register bit cannot change, we can replace it with a constant
 						if (counter_example_found)
@@ -31,6 +31,62 @@ PRIVATE_NAMESPACE_BEGIN
 
 bool did_something;
 
+// collects the cells that have to be revisited in the next opt_expr round:
+// cells whose ports were rewritten and the consumers of every signal that got
+// a new constant or alias driver. Consumers are looked up through a snapshot
+// of the sigmap taken when the consumer index was built, so that lookups stay
+// consistent while the round rewrites the netlist underneath.
+struct OptExprMonitor : RTLIL::Monitor
+{
+	RTLIL::Module *module;
+	bool active;
+	SigMap index_map;
+	const dict<RTLIL::SigBit, pool<RTLIL::Cell*>> &bit_consumers;
+	pool<RTLIL::Cell*> worklist;
+
+	OptExprMonitor(RTLIL::Module *module, const SigMap &assign_map,
+			const dict<RTLIL::SigBit, pool<RTLIL::Cell*>> &bit_consumers, bool active) :
+			module(module), active(active), bit_consumers(bit_consumers)
+	{
+		if (active) {
+			index_map = assign_map;
+			module->monitors.insert(this);
+		}
+	}
+
+	~OptExprMonitor()
+	{
+		if (active)
+			module->monitors.erase(this);
+	}
+
+	void dirty_driver(const RTLIL::SigSpec &sig)
+	{
+		for (auto bit : index_map(sig)) {
+			auto it = bit_consumers.find(bit);
+			if (it != bit_consumers.end())
+				for (auto cell : it->second)
+					worklist.insert(cell);
+		}
+	}
+
+	void notify_connect(RTLIL::Cell *cell, const RTLIL::IdString&, const RTLIL::SigSpec&, const RTLIL::SigSpec&) override
+	{
+		worklist.insert(cell);
+	}
+
+	void notify_connect(RTLIL::Module*, const RTLIL::SigSig &sigsig) override
+	{
+		dirty_driver(sigsig.first);
+	}
+
+	void notify_connect(RTLIL::Module*, const std::vector<RTLIL::SigSig> &sigsig_vec) override
+	{
+		for (auto &sigsig : sigsig_vec)
+			dirty_driver(sigsig.first);
+	}
+};
+
 void replace_undriven(RTLIL::Module *module, const CellTypes &ct)
 {
 	SigMap sigmap(module);
@@ -393,11 +449,31 @@ int get_highest_hot_index(RTLIL::SigSpec signal)
 	return -1;
 }
 
-void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool consume_x, bool mux_undef, bool mux_bool, bool do_fine, bool keepdc, bool noclkinv)
+void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool consume_x, bool mux_undef, bool mux_bool, bool do_fine, bool keepdc, bool noclkinv, pool<RTLIL::Cell*> *worklist)
 {
 	SigMap assign_map(module);
 	dict<RTLIL::SigSpec, RTLIL::SigSpec> invert_map;
 
+	// incremental convergence: when a worklist is given and non-empty, only
+	// the listed cells are revisited this round. In either case the worklist
+	// is replaced with the set of cells affected by this round's rewrites, so
+	// later rounds cost time proportional to the amount of rewriting instead
+	// of re-evaluating every cell of the module.
+	bool full_sweep = worklist == nullptr || worklist->empty();
+
+	dict<RTLIL::SigBit, pool<RTLIL::Cell*>> bit_consumers;
+	if (worklist != nullptr) {
+		for (auto cell : module->cells())
+		if (design->selected(module, cell) && yosys_celltypes.cell_evaluable(cell->type))
+			for (auto &conn : cell->connections())
+			if (yosys_celltypes.cell_input(cell->type, conn.first))
+			for (auto bit : assign_map(conn.second))
+			if (bit.wire != nullptr)
+				bit_consumers[bit].insert(cell);
+	}
+
+	OptExprMonitor monitor(module, assign_map, bit_consumers, worklist != nullptr);
+
 	for (auto cell : module->cells()) {
 		if (design->selected(module, cell) && cell->type[0] == '$') {
 			if (cell->type.in(ID($_NOT_), ID($not), ID($logic_not)) &&
@@ -494,7 +570,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 	dict<RTLIL::SigBit, Cell*> outbit_to_cell;
 
 	for (auto cell : module->cells())
-	if (design->selected(module, cell) && yosys_celltypes.cell_evaluable(cell->type)) {
+	if (design->selected(module, cell) && yosys_celltypes.cell_evaluable(cell->type) && (full_sweep || worklist->count(cell))) {
 		for (auto &conn : cell->connections())
 		if (yosys_celltypes.cell_output(cell->type, conn.first))
 		for (auto bit : assign_map(conn.second))
@@ -503,7 +579,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 	}
 
 	for (auto cell : module->cells())
-	if (design->selected(module, cell) && yosys_celltypes.cell_evaluable(cell->type)) {
+	if (design->selected(module, cell) && yosys_celltypes.cell_evaluable(cell->type) && (full_sweep || worklist->count(cell))) {
 		const int r_index = cells.node(cell);
 		for (auto &conn : cell->connections())
 		if (yosys_celltypes.cell_input(cell->type, conn.first))
@@ -523,6 +599,12 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 #define ACTION_DO(_p_, _s_) do { cover("opt.opt_expr.action_" S__LINE__); replace_cell(assign_map, module, cell, input.as_string(), _p_, _s_); goto next_cell; } while (0)
 #define ACTION_DO_Y(_v_) ACTION_DO(ID::Y, RTLIL::SigSpec(RTLIL::State::S ## _v_))
 
+		// track per-cell progress so that silent rewrites (e.g. in-place type
+		// or parameter changes the monitor cannot observe) still re-queue the
+		// cell for the next round
+		bool did_something_last = did_something;
+		did_something = false;
+
 		bool detect_const_and = false;
 		bool detect_const_or = false;
 
@@ -2194,11 +2276,17 @@ skip_alu_split:
 		}
 
 	next_cell:;
+		if (did_something && worklist != nullptr)
+			monitor.worklist.insert(cell);
+		did_something |= did_something_last;
 #undef ACTION_DO
 #undef ACTION_DO_Y
 #undef FOLD_1ARG_CELL
 #undef FOLD_2ARG_CELL
 	}
+
+	if (worklist != nullptr)
+		*worklist = std::move(monitor.worklist);
 }
 
 void replace_const_connections(RTLIL::Module *module) {
@@ -2316,14 +2404,15 @@ struct OptExprPass : public Pass {
 			}
 
 			do {
+				pool<RTLIL::Cell*> worklist;
 				do {
 					did_something = false;
-					replace_const_cells(design, module, false /* consume_x */, mux_undef, mux_bool, do_fine, keepdc, noclkinv);
+					replace_const_cells(design, module, false /* consume_x */, mux_undef, mux_bool, do_fine, keepdc, noclkinv, &worklist);
 					if (did_something)
 						design->scratchpad_set_bool("opt.did_something", true);
 				} while (did_something);
 				if (!keepdc)
-					replace_const_cells(design, module, true /* consume_x */, mux_undef, mux_bool, do_fine, keepdc, noclkinv);
+					replace_const_cells(design, module, true /* consume_x */, mux_undef, mux_bool, do_fine, keepdc, noclkinv, nullptr);
 				if (did_something)
 					design->scratchpad_set_bool("opt.did_something", true);
 			} while (did_something);
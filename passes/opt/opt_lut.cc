@@ -48,27 +48,39 @@ struct OptLutWorker
 
 	int eliminated_count = 0, combined_count = 0;
 
-	bool evaluate_lut(RTLIL::Cell *lut, dict<SigBit, bool> inputs)
+	// Truth tables are manipulated as packed 64-bit words: bit i of word i/64
+	// is the LUT output for input index i. The LUT parameter of each cell is
+	// unpacked at most once and cached until the cell is rewritten or removed.
+	dict<RTLIL::Cell*, std::vector<uint64_t>> lut_table_cache;
+
+	std::vector<uint64_t> lut_table_words(RTLIL::Cell *lut)
 	{
-		SigSpec lut_input = sigmap(lut->getPort(ID::A));
+		auto it = lut_table_cache.find(lut);
+		if (it != lut_table_cache.end())
+			return it->second;
+
 		int lut_width = lut->getParam(ID::WIDTH).as_int();
 		Const lut_table = lut->getParam(ID::LUT);
-		int lut_index = 0;
 
-		for (int i = 0; i < lut_width; i++)
-		{
-			SigBit input = sigmap(lut_input[i]);
-			if (inputs.count(input))
-			{
-				lut_index |= inputs[input] << i;
-			}
-			else
-			{
-				lut_index |= SigSpec(lut_input[i]).as_bool() << i;
-			}
-		}
+		std::vector<uint64_t> words(1 << lut_width <= 64 ? 1 : (1 << lut_width) >> 6, 0);
+		for (int i = 0; i < (1 << lut_width) && i < GetSize(lut_table); i++)
+			if (lut_table[i] == State::S1)
+				words[i >> 6] |= (uint64_t)1 << (i & 63);
 
-		return lut_table.extract(lut_index).as_bool();
+		lut_table_cache[lut] = words;
+		return words;
+	}
+
+	// The packed image of "output follows evaluation-space position p".
+	static uint64_t input_mask(int p, int word)
+	{
+		static const uint64_t masks[6] = {
+			0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull,
+			0xff00ff00ff00ff00ull, 0xffff0000ffff0000ull, 0xffffffff00000000ull,
+		};
+		if (p < 6)
+			return masks[p];
+		return (word >> (p - 6)) & 1 ? ~(uint64_t)0 : 0;
 	}
 
 	void show_stats_by_arity()
@@ -228,33 +240,60 @@ struct OptLutWorker
 					lut_inputs.push_back(sigmap(bit));
 			}
 
+			int lut_width = lut->getParam(ID::WIDTH).as_int();
+			std::vector<uint64_t> lut_table = lut_table_words(lut);
+
+			// evaluation-space position driving each input signal
+			// (duplicate pins alias the last position)
+			dict<SigBit, int> input_pos;
+			for (int i = 0; i < GetSize(lut_inputs); i++)
+				input_pos[lut_inputs[i]] = i;
+
+			// index contribution of every input pin: an evaluation-space
+			// position for wire inputs, a fixed bit for constant inputs
+			int index_base = 0;
+			std::vector<std::pair<int, int>> index_shifts;
+			for (int i = 0; i < lut_width; i++) {
+				auto it = input_pos.find(lut_input[i]);
+				if (it != input_pos.end())
+					index_shifts.push_back({i, it->second});
+				else if (SigSpec(lut->getPort(ID::A)[i]).as_bool())
+					index_base |= 1 << i;
+			}
+
+			// packed truth table over all 2^m input combinations
+			int m = GetSize(lut_inputs);
+			std::vector<uint64_t> fn(m <= 6 ? 1 : (size_t)1 << (m - 6), 0);
+			for (int eval = 0; eval < 1 << m; eval++) {
+				int index = index_base;
+				for (auto &shift : index_shifts)
+					if ((eval >> shift.second) & 1)
+						index |= 1 << shift.first;
+				if ((lut_table[index >> 6] >> (index & 63)) & 1)
+					fn[eval >> 6] |= (uint64_t)1 << (eval & 63);
+			}
+
+			uint64_t valid = m < 6 ? ((uint64_t)1 << (1 << m)) - 1 : ~(uint64_t)0;
+
 			bool const0_match = true;
 			bool const1_match = true;
-			vector<bool> input_matches;
-			for (size_t i = 0; i < lut_inputs.size(); i++)
-				input_matches.push_back(true);
-
-			for (int eval = 0; eval < 1 << lut_inputs.size(); eval++)
-			{
-				dict<SigBit, bool> eval_inputs;
-				for (size_t i = 0; i < lut_inputs.size(); i++)
-					eval_inputs[lut_inputs[i]] = (eval >> i) & 1;
-				bool value = evaluate_lut(lut, eval_inputs);
-				if (value != 0)
+			for (int i = 0; i < GetSize(fn); i++) {
+				if (fn[i] & valid)
 					const0_match = false;
-				if (value != 1)
+				if ((fn[i] & valid) != valid)
 					const1_match = false;
-				for (size_t i = 0; i < lut_inputs.size(); i++)
-				{
-					if (value != eval_inputs[lut_inputs[i]])
-						input_matches[i] = false;
-				}
 			}
 
 			int input_match = -1;
-			for (size_t i = 0; i < lut_inputs.size(); i++)
-				if (input_matches[i])
+			for (int i = 0; i < m; i++) {
+				int p = input_pos.at(lut_inputs[i]);
+				bool matches = true;
+				for (int j = 0; matches && j < GetSize(fn); j++)
+					if ((fn[j] & valid) != (input_mask(p, j) & valid))
+						matches = false;
+				if (matches)
 					input_match = i;
+			}
 
 			if (const0_match || const1_match || input_match != -1)
 			{
@@ -294,6 +333,7 @@ struct OptLutWorker
 					luts_arity.erase(lut);
 					luts_dlogics.erase(lut);
 					luts_dlogic_inputs.erase(lut);
+					lut_table_cache.erase(lut);
 
 					module->remove(lut);
 					
@@ -484,16 +524,60 @@ struct OptLutWorker
 					}
 					log_assert(lutR_unique.size() == 0);
 
+					std::vector<uint64_t> lutA_table = lut_table_words(lutA);
+					std::vector<uint64_t> lutB_table = lut_table_words(lutB);
+
+					// merged-evaluation-space position driving each input signal
+					// (duplicate entries alias the last position)
+					dict<SigBit, int> eval_pos;
+					for (int i = 0; i < GetSize(lutM_new_inputs); i++)
+						eval_pos[lutM_new_inputs[i]] = i;
+
+					// index contribution of every input pin of both cells: a
+					// position in the merged evaluation space, the cascade feed
+					// (for cell B), or a fixed bit for constant inputs
+					int lutA_base = 0, lutB_base = 0, lutB_cascade = 0;
+					std::vector<std::pair<int, int>> lutA_shifts, lutB_shifts;
+
+					SigSpec lutA_raw_input = lutA->getPort(ID::A);
+					for (int i = 0; i < GetSize(lutA_raw_input); i++) {
+						auto it = eval_pos.find(sigmap(lutA_raw_input[i]));
+						if (it != eval_pos.end())
+							lutA_shifts.push_back({i, it->second});
+						else if (SigSpec(lutA_raw_input[i]).as_bool())
+							lutA_base |= 1 << i;
+					}
+
+					SigSpec lutB_raw_input = lutB->getPort(ID::A);
+					for (int i = 0; i < GetSize(lutB_raw_input); i++) {
+						SigBit bit = sigmap(lutB_raw_input[i]);
+						if (bit == lutA_output) {
+							lutB_cascade |= 1 << i;
+							continue;
+						}
+						auto it = eval_pos.find(bit);
+						if (it != eval_pos.end())
+							lutB_shifts.push_back({i, it->second});
+						else if (SigSpec(lutB_raw_input[i]).as_bool())
+							lutB_base |= 1 << i;
+					}
+
 					RTLIL::Const lutM_new_table(State::Sx, 1 << lutM_width);
 					for (int eval = 0; eval < 1 << lutM_width; eval++)
 					{
-						dict<SigBit, bool> eval_inputs;
-						for (size_t i = 0; i < lutM_new_inputs.size(); i++)
-						{
-							eval_inputs[lutM_new_inputs[i]] = (eval >> i) & 1;
-						}
-						eval_inputs[lutA_output] = evaluate_lut(lutA, eval_inputs);
-						lutM_new_table[eval] = (RTLIL::State) evaluate_lut(lutB, eval_inputs);
+						int lutA_index = lutA_base;
+						for (auto &shift : lutA_shifts)
+							if ((eval >> shift.second) & 1)
+								lutA_index |= 1 << shift.first;
+
+						int lutB_index = lutB_base;
+						if ((lutA_table[lutA_index >> 6] >> (lutA_index & 63)) & 1)
+							lutB_index |= lutB_cascade;
+						for (auto &shift : lutB_shifts)
+							if ((eval >> shift.second) & 1)
+								lutB_index |= 1 << shift.first;
+
+						lutM_new_table[eval] = (lutB_table[lutB_index >> 6] >> (lutB_index & 63)) & 1 ? State::S1 : State::S0;
 					}
 
 					log_debug("  Cell A truth table: %s.\n", lutA->getParam(ID::LUT).as_string().c_str());
@@ -504,6 +588,9 @@ struct OptLutWorker
 					lutM->setPort(ID::A, lutM_new_inputs);
 					lutM->setPort(ID::Y, lutB_output);
 
+					lut_table_cache.erase(lutM);
+					lut_table_cache.erase(lutR);
+
 					luts_arity[lutM] = lutM_arity;
 					luts.erase(lutR);
 					luts_arity.erase(lutR);
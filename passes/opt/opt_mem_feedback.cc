@@ -20,6 +20,7 @@
 #include "kernel/yosys.h"
 #include "kernel/sigtools.h"
 #include "kernel/mem.h"
+#include "passes/opt/opt_mem_shared.h"
 
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
@@ -276,7 +277,11 @@ struct OptMemFeedbackWorker
 	void operator()(RTLIL::Module* module)
 	{
 		std::vector<Mem> memories = Mem::get_selected_memories(module);
+		run(module, memories);
+	}
 
+	void run(RTLIL::Module* module, std::vector<Mem> &memories)
+	{
 		this->module = module;
 		sigmap.set(module);
 		initvals.set(&sigmap, module);
@@ -317,11 +322,30 @@ struct OptMemFeedbackWorker
 						sig_users_count[bit]++;
 		}
 
-		for (auto &mem : memories)
+		for (auto &mem : memories) {
+			// Skip memories that a prior analysis has already removed
+			// from the module (fused driver only).
+			if (mem.mem == nullptr && mem.cell == nullptr)
+				continue;
 			translate_rd_feedback_to_en(mem);
+		}
 	}
 };
 
+PRIVATE_NAMESPACE_END
+
+YOSYS_NAMESPACE_BEGIN
+
+void opt_mem_feedback_module(RTLIL::Design *design, RTLIL::Module *module, std::vector<Mem> &memories)
+{
+	OptMemFeedbackWorker worker(design);
+	worker.run(module, memories);
+}
+
+YOSYS_NAMESPACE_END
+
+PRIVATE_NAMESPACE_BEGIN
+
 struct OptMemFeedbackPass : public Pass {
 	OptMemFeedbackPass() : Pass("opt_mem_feedback", "convert memory read-to-write port feedback paths to write enables") { }
 	void help() override
@@ -0,0 +1,90 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/yosys.h"
+#include "kernel/sigtools.h"
+#include "kernel/modtools.h"
+#include "kernel/mem.h"
+#include "passes/opt/opt_mem_shared.h"
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+struct OptMemFusedPass : public Pass {
+	OptMemFusedPass() : Pass("opt_mem_fused", "run all opt_mem_* analyses over shared memory helper state") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    opt_mem_fused [selection]\n");
+		log("\n");
+		log("This pass runs the analyses of the opt_mem, opt_mem_priority, opt_mem_feedback\n");
+		log("and opt_mem_widen passes, in this order, over memory helper structures that are\n");
+		log("built only once per module.  The individual passes each rebuild this state from\n");
+		log("the netlist, so on memory-heavy designs running them back-to-back pays the same\n");
+		log("scan cost four times; this fused driver pays it once.\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		log_header(design, "Executing OPT_MEM_FUSED pass (fused memory optimizations).\n");
+		extra_args(args, 1, design);
+
+		ModWalker modwalker(design);
+
+		int total_count = 0;
+		for (auto module : design->selected_modules()) {
+			std::vector<Mem> memories = Mem::get_selected_memories(module);
+			if (memories.empty())
+				continue;
+
+			// The opt_mem analysis; like the standalone pass, it is only
+			// run on modules without processes.  It may remove a memory
+			// altogether, in which case the later analyses skip it.
+			if (!module->has_processes_warn()) {
+				SigMap sigmap(module);
+				FfInitVals initvals(&sigmap, module);
+				for (auto &mem : memories)
+					opt_mem_memory(module, mem, &initvals, total_count);
+			}
+
+			// The ModWalker is set up only now so that the SAT queries of
+			// the opt_mem_priority analysis see the netlist changes made
+			// above.
+			modwalker.setup(module);
+			for (auto &mem : memories)
+				if (mem.mem != nullptr || mem.cell != nullptr)
+					opt_mem_priority_memory(modwalker, mem, total_count);
+
+			// The opt_mem_feedback analysis scans the module's mux trees
+			// itself and skips removed memories internally.
+			opt_mem_feedback_module(design, module, memories);
+
+			for (auto &mem : memories)
+				if (mem.mem != nullptr || mem.cell != nullptr)
+					opt_mem_widen_memory(mem, total_count);
+		}
+
+		if (total_count)
+			design->scratchpad_set_bool("opt.did_something", true);
+		log("Performed a total of %d transformations.\n", total_count);
+	}
+} OptMemFusedPass;
+
+PRIVATE_NAMESPACE_END
@@ -21,8 +21,64 @@
 #include "kernel/modtools.h"
 #include "kernel/qcsat.h"
 #include "kernel/mem.h"
+#include "passes/opt/opt_mem_shared.h"
 
 USING_YOSYS_NAMESPACE
+
+YOSYS_NAMESPACE_BEGIN
+
+void opt_mem_priority_memory(ModWalker &modwalker, Mem &mem, int &total_count)
+{
+	bool mem_changed = false;
+	QuickConeSat qcsat(modwalker);
+	for (int i = 0; i < GetSize(mem.wr_ports); i++) {
+		auto &wport1 = mem.wr_ports[i];
+		for (int j = 0; j < GetSize(mem.wr_ports); j++) {
+			auto &wport2 = mem.wr_ports[j];
+			if (!wport1.priority_mask[j])
+				continue;
+			// No mixed width support — we could do it, but
+			// that would complicate code and wouldn't help
+			// anything since we run this pass before
+			// wide ports are created in normal flow.
+			if (wport1.wide_log2 != wport2.wide_log2)
+				continue;
+			// Two ports with priority, let's go.
+			pool<std::pair<SigBit, SigBit>> checked;
+			SigSpec addr1 = wport1.addr;
+			SigSpec addr2 = wport2.addr;
+			int abits = std::max(GetSize(addr1), GetSize(addr2));
+			addr1.extend_u0(abits);
+			addr2.extend_u0(abits);
+			int addr_eq = qcsat.ez->vec_eq(qcsat.importSig(addr1), qcsat.importSig(addr2));
+			bool ok = true;
+			for (int k = 0; k < GetSize(wport1.data); k++) {
+				SigBit wen1 = wport1.en[k];
+				SigBit wen2 = wport2.en[k];
+				if (checked.count({wen1, wen2}))
+					continue;
+				int wen1_sat = qcsat.importSigBit(wen1);
+				int wen2_sat = qcsat.importSigBit(wen2);
+				qcsat.prepare();
+				if (qcsat.ez->solve(wen1_sat, wen2_sat, addr_eq)) {
+					ok = false;
+					break;
+				}
+				checked.insert({wen1, wen2});
+			}
+			if (ok) {
+				total_count++;
+				mem_changed = true;
+				wport1.priority_mask[j] = false;
+			}
+		}
+	}
+	if (mem_changed)
+		mem.emit();
+}
+
+YOSYS_NAMESPACE_END
+
 PRIVATE_NAMESPACE_BEGIN
 
 struct OptMemPriorityPass : public Pass {
@@ -49,54 +105,8 @@ struct OptMemPriorityPass : public Pass {
 		int total_count = 0;
 		for (auto module : design->selected_modules()) {
 			modwalker.setup(module);
-			for (auto &mem : Mem::get_selected_memories(module)) {
-				bool mem_changed = false;
-				QuickConeSat qcsat(modwalker);
-				for (int i = 0; i < GetSize(mem.wr_ports); i++) {
-					auto &wport1 = mem.wr_ports[i];
-					for (int j = 0; j < GetSize(mem.wr_ports); j++) {
-						auto &wport2 = mem.wr_ports[j];
-						if (!wport1.priority_mask[j])
-							continue;
-						// No mixed width support — we could do it, but
-						// that would complicate code and wouldn't help
-						// anything since we run this pass before
-						// wide ports are created in normal flow.
-						if (wport1.wide_log2 != wport2.wide_log2)
-							continue;
-						// Two ports with priority, let's go.
-						pool<std::pair<SigBit, SigBit>> checked;
-						SigSpec addr1 = wport1.addr;
-						SigSpec addr2 = wport2.addr;
-						int abits = std::max(GetSize(addr1), GetSize(addr2));
-						addr1.extend_u0(abits);
-						addr2.extend_u0(abits);
-						int addr_eq = qcsat.ez->vec_eq(qcsat.importSig(addr1), qcsat.importSig(addr2));
-						bool ok = true;
-						for (int k = 0; k < GetSize(wport1.data); k++) {
-							SigBit wen1 = wport1.en[k];
-							SigBit wen2 = wport2.en[k];
-							if (checked.count({wen1, wen2}))
-								continue;
-							int wen1_sat = qcsat.importSigBit(wen1);
-							int wen2_sat = qcsat.importSigBit(wen2);
-							qcsat.prepare();
-							if (qcsat.ez->solve(wen1_sat, wen2_sat, addr_eq)) {
-								ok = false;
-								break;
-							}
-							checked.insert({wen1, wen2});
-						}
-						if (ok) {
-							total_count++;
-							mem_changed = true;
-							wport1.priority_mask[j] = false;
-						}
-					}
-				}
-				if (mem_changed)
-					mem.emit();
-			}
+			for (auto &mem : Mem::get_selected_memories(module))
+				opt_mem_priority_memory(modwalker, mem, total_count);
 		}
 
 		if (total_count)
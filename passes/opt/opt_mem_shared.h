@@ -0,0 +1,57 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef OPT_MEM_SHARED_H
+#define OPT_MEM_SHARED_H
+
+#include "kernel/yosys.h"
+#include "kernel/modtools.h"
+#include "kernel/ffinit.h"
+#include "kernel/mem.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+// Analysis entry points shared between the individual opt_mem_* passes and
+// the fused opt_mem_fused driver, which builds the Mem helper structures
+// once per module and runs all analyses over them.
+
+// opt_mem.cc: remove never-enabled write ports and constant data lanes.
+// Emits the memory when changed.  Returns false iff the memory was removed
+// from the module entirely.
+extern bool opt_mem_memory(RTLIL::Module *module, Mem &mem, FfInitVals *initvals, int &total_count);
+
+// opt_mem_priority.cc: remove priority relations between write ports that
+// can never collide.  The ModWalker must be set up on mem.module, after any
+// prior netlist changes.  Emits the memory when changed.
+extern void opt_mem_priority_memory(ModWalker &modwalker, Mem &mem, int &total_count);
+
+// opt_mem_feedback.cc: convert read-to-write feedback paths to write
+// enables.  Operates on all given memories of one module at once, since it
+// needs a module-wide mux tree and user count analysis anyway.  Memories
+// that were already removed are skipped.  Emits the changed memories and
+// sets opt.did_something itself.
+extern void opt_mem_feedback_module(RTLIL::Design *design, RTLIL::Module *module, std::vector<Mem> &memories);
+
+// opt_mem_widen.cc: adjust the base width of a memory up as long as all
+// its ports are wide.  Emits the memory when changed.
+extern void opt_mem_widen_memory(Mem &mem, int &total_count);
+
+YOSYS_NAMESPACE_END
+
+#endif
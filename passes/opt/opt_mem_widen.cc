@@ -19,8 +19,61 @@
 
 #include "kernel/yosys.h"
 #include "kernel/mem.h"
+#include "passes/opt/opt_mem_shared.h"
 
 USING_YOSYS_NAMESPACE
+
+YOSYS_NAMESPACE_BEGIN
+
+void opt_mem_widen_memory(Mem &mem, int &total_count)
+{
+	// If the memory has no read ports, opt_clean will remove it
+	// instead.
+	if (mem.rd_ports.empty())
+		return;
+	int factor_log2 = mem.rd_ports[0].wide_log2;
+	for (auto &port : mem.rd_ports)
+		if (port.wide_log2 < factor_log2)
+			factor_log2 = port.wide_log2;
+	for (auto &port : mem.wr_ports)
+		if (port.wide_log2 < factor_log2)
+			factor_log2 = port.wide_log2;
+	if (factor_log2 == 0)
+		return;
+	log("Widening base width of memory %s in module %s by factor %d.\n", log_id(mem.memid), log_id(mem.module->name), 1 << factor_log2);
+	total_count++;
+	// The inits are too messy to expand one-by-one, for they may
+	// collide with one another after expansion.  Just hit it with
+	// a hammer.
+	bool has_init = !mem.inits.empty();
+	Const init_data;
+	if (has_init) {
+		init_data = mem.get_init_data();
+		mem.clear_inits();
+	}
+	mem.width <<= factor_log2;
+	mem.size >>= factor_log2;
+	mem.start_offset >>= factor_log2;
+	if (has_init) {
+		MemInit new_init;
+		new_init.addr = mem.start_offset;
+		new_init.data = init_data;
+		new_init.en = Const(State::S1, mem.width);
+		mem.inits.push_back(new_init);
+	}
+	for (auto &port : mem.rd_ports) {
+		port.wide_log2 -= factor_log2;
+		port.addr = port.addr.extract_end(factor_log2);
+	}
+	for (auto &port : mem.wr_ports) {
+		port.wide_log2 -= factor_log2;
+		port.addr = port.addr.extract_end(factor_log2);
+	}
+	mem.emit();
+}
+
+YOSYS_NAMESPACE_END
+
 PRIVATE_NAMESPACE_BEGIN
 
 struct OptMemWidenPass : public Pass {
@@ -51,51 +104,8 @@ struct OptMemWidenPass : public Pass {
 
 		int total_count = 0;
 		for (auto module : design->selected_modules()) {
-			for (auto &mem : Mem::get_selected_memories(module)) {
-				// If the memory has no read ports, opt_clean will remove it
-				// instead.
-				if (mem.rd_ports.empty())
-					continue;
-				int factor_log2 = mem.rd_ports[0].wide_log2;
-				for (auto &port : mem.rd_ports)
-					if (port.wide_log2 < factor_log2)
-						factor_log2 = port.wide_log2;
-				for (auto &port : mem.wr_ports)
-					if (port.wide_log2 < factor_log2)
-						factor_log2 = port.wide_log2;
-				if (factor_log2 == 0)
-					continue;
-				log("Widening base width of memory %s in module %s by factor %d.\n", log_id(mem.memid), log_id(module->name), 1 << factor_log2);
-				total_count++;
-				// The inits are too messy to expand one-by-one, for they may
-				// collide with one another after expansion.  Just hit it with
-				// a hammer.
-				bool has_init = !mem.inits.empty();
-				Const init_data;
-				if (has_init) {
-					init_data = mem.get_init_data();
-					mem.clear_inits();
-				}
-				mem.width <<= factor_log2;
-				mem.size >>= factor_log2;
-				mem.start_offset >>= factor_log2;
-				if (has_init) {
-					MemInit new_init;
-					new_init.addr = mem.start_offset;
-					new_init.data = init_data;
-					new_init.en = Const(State::S1, mem.width);
-					mem.inits.push_back(new_init);
-				}
-				for (auto &port : mem.rd_ports) {
-					port.wide_log2 -= factor_log2;
-					port.addr = port.addr.extract_end(factor_log2);
-				}
-				for (auto &port : mem.wr_ports) {
-					port.wide_log2 -= factor_log2;
-					port.addr = port.addr.extract_end(factor_log2);
-				}
-				mem.emit();
-			}
+			for (auto &mem : Mem::get_selected_memories(module))
+				opt_mem_widen_memory(mem, total_count);
 		}
 
 		if (total_count)
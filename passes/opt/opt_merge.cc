@@ -65,7 +65,7 @@ struct OptMergeWorker
 		}
 	}
 
-	std::string int_to_hash_string(unsigned int v)
+	static std::string int_to_hash_string(unsigned int v)
 	{
 		if (v == 0)
 			return "0";
@@ -77,59 +77,57 @@ struct OptMergeWorker
 		return str;
 	}
 
-        uint64_t hash_cell_parameters_and_connections(const RTLIL::Cell *cell)
+	// applies the sigmap and the type specific input canonicalization for
+	// hashing. This part touches shared state (the sigmap mutates on lookup)
+	// and therefore stays on the main thread.
+	dict<RTLIL::IdString, RTLIL::SigSpec> hashable_connections(const RTLIL::Cell *cell)
 	{
-		vector<string> hash_conn_strings;
-		std::string hash_string = cell->type.str() + "\n";
+		dict<RTLIL::IdString, RTLIL::SigSpec> conn;
 
-		const dict<RTLIL::IdString, RTLIL::SigSpec> *conn = &cell->connections();
-		dict<RTLIL::IdString, RTLIL::SigSpec> alt_conn;
+		for (auto &it : cell->connections()) {
+			if (cell->output(it.first)) {
+				if (it.first == ID::Q && RTLIL::builtin_ff_cell_types().count(cell->type)) {
+					// For the 'Q' output of state elements,
+					//   use its (* init *) attribute value
+					conn[it.first] = initvals(it.second);
+				}
+			}
+			else
+				conn[it.first] = assign_map(it.second);
+		}
 
 		if (cell->type.in(ID($and), ID($or), ID($xor), ID($xnor), ID($add), ID($mul),
 				ID($logic_and), ID($logic_or), ID($_AND_), ID($_OR_), ID($_XOR_))) {
-			alt_conn = *conn;
-			if (assign_map(alt_conn.at(ID::A)) < assign_map(alt_conn.at(ID::B))) {
-				alt_conn[ID::A] = conn->at(ID::B);
-				alt_conn[ID::B] = conn->at(ID::A);
+			if (conn.at(ID::A) < conn.at(ID::B)) {
+				RTLIL::SigSpec tmp = conn.at(ID::A);
+				conn.at(ID::A) = conn.at(ID::B);
+				conn.at(ID::B) = tmp;
 			}
-			conn = &alt_conn;
 		} else
 		if (cell->type.in(ID($reduce_xor), ID($reduce_xnor))) {
-			alt_conn = *conn;
-			assign_map.apply(alt_conn.at(ID::A));
-			alt_conn.at(ID::A).sort();
-			conn = &alt_conn;
+			conn.at(ID::A).sort();
 		} else
 		if (cell->type.in(ID($reduce_and), ID($reduce_or), ID($reduce_bool))) {
-			alt_conn = *conn;
-			assign_map.apply(alt_conn.at(ID::A));
-			alt_conn.at(ID::A).sort_and_unify();
-			conn = &alt_conn;
+			conn.at(ID::A).sort_and_unify();
 		} else
 		if (cell->type == ID($pmux)) {
-			alt_conn = *conn;
-			assign_map.apply(alt_conn.at(ID::A));
-			assign_map.apply(alt_conn.at(ID::B));
-			assign_map.apply(alt_conn.at(ID::S));
-			sort_pmux_conn(alt_conn);
-			conn = &alt_conn;
+			sort_pmux_conn(conn);
 		}
 
-		for (auto &it : *conn) {
-			RTLIL::SigSpec sig;
-			if (cell->output(it.first)) {
-				if (it.first == ID::Q && RTLIL::builtin_ff_cell_types().count(cell->type)) {
-					// For the 'Q' output of state elements,
-					//   use its (* init *) attribute value
-					sig = initvals(it.second);
-				}
-				else
-					continue;
-			}
-			else
-				sig = assign_map(it.second);
+		return conn;
+	}
+
+	// pure function of the prepared connections and the cell's type and
+	// parameters, safe to run on worker threads: it only reads the cell and
+	// its own private copy of the canonicalized connections
+	static uint64_t hash_cell(const RTLIL::Cell *cell, const dict<RTLIL::IdString, RTLIL::SigSpec> &conn)
+	{
+		vector<string> hash_conn_strings;
+		std::string hash_string = cell->type.str() + "\n";
+
+		for (auto &it : conn) {
 			string s = "C " + it.first.str() + "=";
-			for (auto &chunk : sig.chunks()) {
+			for (auto &chunk : it.second.chunks()) {
 				if (chunk.wire)
 					s += "{" + chunk.wire->name.str() + " " +
 							int_to_hash_string(chunk.offset) + " " +
@@ -145,7 +143,7 @@ struct OptMergeWorker
 
 		std::sort(hash_conn_strings.begin(), hash_conn_strings.end());
 
-		for (auto it : hash_conn_strings)
+		for (auto &it : hash_conn_strings)
 			hash_string += it;
 
 		return std::hash<std::string>{}(hash_string);
@@ -261,22 +259,43 @@ struct OptMergeWorker
 					continue;
 				if (mode_keepdc && has_dont_care_initval(it.second))
 					continue;
-				if (ct.cell_known(it.second->type) || (mode_share_all && it.second->known()))
-					cells.push_back(it.second);
+				if (!ct.cell_known(it.second->type) && !mode_share_all)
+					continue;
+				if (!it.second->known() || it.second->type == ID($scopeinfo))
+					continue;
+				cells.push_back(it.second);
 			}
 
 			did_something = false;
                         dict<uint64_t, RTLIL::Cell*> sharemap;
-			for (auto cell : cells)
+
+			// hashing is by far the most expensive part and is perfectly
+			// parallel: the canonicalized connections are prepared on the
+			// main thread (the sigmap is not safe for concurrent lookups),
+			// then the per-cell hashes are computed on the thread pool. Work
+			// is done block by block so merges of earlier blocks are already
+			// reflected in the sigmap used to prepare later blocks.
+			const int block_size = 4096;
+
+			std::vector<dict<RTLIL::IdString, RTLIL::SigSpec>> block_conns(block_size);
+			std::vector<uint64_t> block_hashes(block_size);
+
+			for (int block_begin = 0; block_begin < GetSize(cells); block_begin += block_size)
 			{
-				if ((!mode_share_all && !ct.cell_known(cell->type)) || !cell->known())
-					continue;
+			int block_count = min(block_size, GetSize(cells) - block_begin);
 
-				if (cell->type == ID($scopeinfo))
-					continue;
+			for (int i = 0; i < block_count; i++)
+				block_conns[i] = hashable_connections(cells[block_begin + i]);
 
-				uint64_t hash = hash_cell_parameters_and_connections(cell);
-				auto r = sharemap.insert(std::make_pair(hash, cell));
+			ThreadPool::get().parallel_for(block_count, [&](int i) {
+				block_hashes[i] = hash_cell(cells[block_begin + i], block_conns[i]);
+			});
+
+			for (int i = 0; i < block_count; i++)
+			{
+				RTLIL::Cell *cell = cells[block_begin + i];
+
+				auto r = sharemap.insert(std::make_pair(block_hashes[i], cell));
 				if (!r.second) {
 					if (compare_cell_parameters_and_connections(cell, r.first->second)) {
 						if (cell->has_keep_attr()) {
@@ -307,6 +326,7 @@ struct OptMergeWorker
 					}
 				}
 			}
+			}
 		}
 
 		log_suppressed();
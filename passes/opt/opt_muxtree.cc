@@ -37,6 +37,7 @@ struct OptMuxtreeWorker
 	SigMap assign_map;
 	int removed_count;
 	int glob_abort_cnt = 100000;
+	int64_t abort_time_ns;
 
 	struct bitinfo_t {
 		bool seen_non_mux;
@@ -54,11 +55,17 @@ struct OptMuxtreeWorker
 		bool const_activated;
 		bool const_deactivated;
 		bool enabled;
+		bool shared_ctrl;
 	};
 
 	struct muxinfo_t {
 		RTLIL::Cell *cell;
 		vector<portinfo_t> ports;
+
+		// the ctrl_sig bits of all ports packed as (word index, mask) pairs,
+		// so eval_mux_port() can mark them word-parallel instead of
+		// iterating over all ports
+		vector<pair<int, uint64_t>> ctrl_mask;
 	};
 
 	vector<muxinfo_t> mux2info;
@@ -66,8 +73,8 @@ struct OptMuxtreeWorker
 	vector<bool> root_enable_muxes;
 	pool<int> root_mux_rerun;
 
-	OptMuxtreeWorker(RTLIL::Design *design, RTLIL::Module *module) :
-			design(design), module(module), assign_map(module), removed_count(0)
+	OptMuxtreeWorker(RTLIL::Design *design, RTLIL::Module *module, int64_t abort_time_ns) :
+			design(design), module(module), assign_map(module), removed_count(0), abort_time_ns(abort_time_ns)
 	{
 		log("Running muxtree optimizer on module %s..\n", module->name.c_str());
 
@@ -157,6 +164,20 @@ struct OptMuxtreeWorker
 					p.input_muxes.insert(k);
 		}
 
+		// Populate mux2info[].ctrl_mask and mux2info[].ports[].shared_ctrl
+		for (auto &muxinfo : mux2info) {
+			dict<int, uint64_t> words;
+			dict<int, int> ctrl_count;
+			for (auto &portinfo : muxinfo.ports)
+				if (portinfo.ctrl_sig >= 0) {
+					words[portinfo.ctrl_sig >> 6] |= uint64_t(1) << (portinfo.ctrl_sig & 63);
+					ctrl_count[portinfo.ctrl_sig]++;
+				}
+			muxinfo.ctrl_mask.assign(words.begin(), words.end());
+			for (auto &portinfo : muxinfo.ports)
+				portinfo.shared_ctrl = portinfo.ctrl_sig >= 0 && ctrl_count.at(portinfo.ctrl_sig) > 1;
+		}
+
 		log("  Evaluating internal representation of mux trees.\n");
 
 		dict<int, pool<int>> mux_to_users;
@@ -179,34 +200,70 @@ struct OptMuxtreeWorker
 			if (GetSize(it.second) > 1)
 				root_muxes.at(it.first) = true;
 
+		pool<int> unfinished_roots;
+
 		for (int mux_idx = 0; mux_idx < GetSize(root_muxes); mux_idx++)
 			if (root_muxes.at(mux_idx)) {
+				if (glob_abort_cnt == 0) {
+					unfinished_roots.insert(mux_idx);
+					continue;
+				}
 				log_debug("    Root of a mux tree: %s%s\n", log_id(mux2info[mux_idx].cell), root_enable_muxes.at(mux_idx) ? " (pure)" : "");
 				root_mux_rerun.erase(mux_idx);
 				eval_root_mux(mux_idx);
-				if (glob_abort_cnt == 0) {
-					log("  Giving up (too many iterations)\n");
-					return;
-				}
+				if (glob_abort_cnt == 0)
+					unfinished_roots.insert(mux_idx);
 			}
 
-		while (!root_mux_rerun.empty()) {
+		while (glob_abort_cnt > 0 && !root_mux_rerun.empty()) {
 			int mux_idx = *root_mux_rerun.begin();
 			log_debug("    Root of a mux tree: %s (rerun as non-pure)\n", log_id(mux2info[mux_idx].cell));
 			log_assert(root_enable_muxes.at(mux_idx));
 			root_mux_rerun.erase(mux_idx);
 			eval_root_mux(mux_idx);
-			if (glob_abort_cnt == 0) {
-				log("  Giving up (too many iterations)\n");
-				return;
+			if (glob_abort_cnt == 0)
+				unfinished_roots.insert(mux_idx);
+		}
+
+		// When the iteration or time budget ran out, the evaluations that did
+		// not finish might still have proven more ports reachable, so all
+		// muxes in the cones of the unfinished roots (including the pending
+		// non-pure reruns) must keep all their ports. The results from the
+		// mux trees that were fully evaluated are still applied below.
+		vector<bool> keep_mux;
+		if (glob_abort_cnt == 0) {
+			log("  Giving up (%s budget exhausted), committing partial results.\n",
+					abort_time_ns != 0 && PerformanceTimer::query() > abort_time_ns ? "time" : "iteration");
+			for (int mux_idx : root_mux_rerun)
+				unfinished_roots.insert(mux_idx);
+			keep_mux.resize(GetSize(mux2info));
+			vector<int> queue;
+			for (int mux_idx : unfinished_roots)
+				if (!keep_mux[mux_idx]) {
+					keep_mux[mux_idx] = true;
+					queue.push_back(mux_idx);
+				}
+			while (!queue.empty()) {
+				int mux_idx = queue.back();
+				queue.pop_back();
+				for (auto &pi : mux2info[mux_idx].ports)
+					for (int m : pi.input_muxes)
+						if (!keep_mux[m]) {
+							keep_mux[m] = true;
+							queue.push_back(m);
+						}
 			}
 		}
 
 		log("  Analyzing evaluation results.\n");
-		log_assert(glob_abort_cnt > 0);
 
-		for (auto &mi : mux2info)
+		for (int mux_idx = 0; mux_idx < GetSize(mux2info); mux_idx++)
 		{
+			muxinfo_t &mi = mux2info[mux_idx];
+
+			if (!keep_mux.empty() && keep_mux[mux_idx])
+				continue;
+
 			vector<int> live_ports;
 			for (int port_idx = 0; port_idx < GetSize(mi.ports); port_idx++) {
 				portinfo_t &pi = mi.ports[port_idx];
@@ -288,19 +345,26 @@ struct OptMuxtreeWorker
 
 	struct knowledge_t
 	{
-		// database of known inactive signals
-		// the payload is a reference counter used to manage the
-		// list. when it is non-zero the signal in known to be inactive
-		vector<int> known_inactive;
-
-		// database of known active signals
-		vector<int> known_active;
+		// known inactive and known active signals, packed one bit per signal
+		// index. eval_mux_port() marks signals by or-ing in precomputed word
+		// masks after saving the previous word contents, and restores the
+		// saved words on exit. Mark/restore pairs are strictly LIFO along the
+		// recursion, so restoring the saved words is exact even when nested
+		// muxes share control bits (which the old per-signal reference
+		// counters were needed for).
+		vector<uint64_t> known_inactive;
+		vector<uint64_t> known_active;
 
 		// this is just used to keep track of visited muxes in order to prohibit
 		// endless recursion in mux loops
 		vector<bool> visited_muxes;
 	};
 
+	static bool get_bit(const vector<uint64_t> &data, int idx)
+	{
+		return (data[idx >> 6] >> (idx & 63)) & 1;
+	}
+
 	void eval_mux_port(knowledge_t &knowledge, int mux_idx, int port_idx, bool do_replace_known, bool do_enable_ports, int abort_count)
 	{
 		if (glob_abort_cnt == 0)
@@ -311,15 +375,36 @@ struct OptMuxtreeWorker
 		if (do_enable_ports)
 			muxinfo.ports[port_idx].enabled = true;
 
-		for (int i = 0; i < GetSize(muxinfo.ports); i++) {
-			if (i == port_idx)
-				continue;
-			if (muxinfo.ports[i].ctrl_sig >= 0)
-				knowledge.known_inactive.at(muxinfo.ports[i].ctrl_sig)++;
+		// mark the ctrl signals of all ports as known inactive, ...
+		vector<uint64_t> saved_inactive(GetSize(muxinfo.ctrl_mask));
+		for (int i = 0; i < GetSize(muxinfo.ctrl_mask); i++) {
+			auto &wm = muxinfo.ctrl_mask[i];
+			saved_inactive[i] = knowledge.known_inactive[wm.first];
+			knowledge.known_inactive[wm.first] |= wm.second;
+		}
+
+		// ... except our own, which keeps whatever state the outer context
+		// gave it (unless another port of this mux shares the same ctrl bit,
+		// in which case that port still marks it inactive), ...
+		int self_ctrl = muxinfo.ports[port_idx].ctrl_sig;
+		if (self_ctrl >= 0 && !muxinfo.ports[port_idx].shared_ctrl) {
+			int word = self_ctrl >> 6;
+			uint64_t mask = uint64_t(1) << (self_ctrl & 63);
+			for (int i = 0; i < GetSize(muxinfo.ctrl_mask); i++)
+				if (muxinfo.ctrl_mask[i].first == word) {
+					knowledge.known_inactive[word] = (knowledge.known_inactive[word] & ~mask) | (saved_inactive[i] & mask);
+					break;
+				}
 		}
 
-		if (port_idx < GetSize(muxinfo.ports)-1 && !muxinfo.ports[port_idx].const_activated)
-			knowledge.known_active.at(muxinfo.ports[port_idx].ctrl_sig)++;
+		// ... and is marked known active instead for a non-default port
+		int active_word = -1;
+		uint64_t saved_active = 0;
+		if (port_idx < GetSize(muxinfo.ports)-1 && !muxinfo.ports[port_idx].const_activated) {
+			active_word = self_ctrl >> 6;
+			saved_active = knowledge.known_active[active_word];
+			knowledge.known_active[active_word] |= uint64_t(1) << (self_ctrl & 63);
+		}
 
 		vector<int> parent_muxes;
 		for (int m : muxinfo.ports[port_idx].input_muxes) {
@@ -346,15 +431,11 @@ struct OptMuxtreeWorker
 		for (int m : parent_muxes)
 			knowledge.visited_muxes[m] = false;
 
-		if (port_idx < GetSize(muxinfo.ports)-1 && !muxinfo.ports[port_idx].const_activated)
-			knowledge.known_active.at(muxinfo.ports[port_idx].ctrl_sig)--;
+		if (active_word >= 0)
+			knowledge.known_active[active_word] = saved_active;
 
-		for (int i = 0; i < GetSize(muxinfo.ports); i++) {
-			if (i == port_idx)
-				continue;
-			if (muxinfo.ports[i].ctrl_sig >= 0)
-				knowledge.known_inactive.at(muxinfo.ports[i].ctrl_sig)--;
-		}
+		for (int i = 0; i < GetSize(muxinfo.ctrl_mask); i++)
+			knowledge.known_inactive[muxinfo.ctrl_mask[i].first] = saved_inactive[i];
 	}
 
 	void replace_known(knowledge_t &knowledge, muxinfo_t &muxinfo, IdString portname)
@@ -373,11 +454,11 @@ struct OptMuxtreeWorker
 		vector<int> bits = sig2bits(sig, false);
 		for (int i = 0; i < GetSize(bits); i++) {
 			if (bits[i] >= 0) {
-				if (knowledge.known_inactive.at(bits[i])) {
+				if (get_bit(knowledge.known_inactive, bits[i])) {
 					sig[i] = State::S0;
 					did_something = true;
 				} else
-				if (knowledge.known_active.at(bits[i])) {
+				if (get_bit(knowledge.known_active, bits[i])) {
 					sig[i] = State::S1;
 					did_something = true;
 				}
@@ -407,6 +488,10 @@ struct OptMuxtreeWorker
 	{
 		if (glob_abort_cnt == 0)
 			return;
+		if (abort_time_ns != 0 && glob_abort_cnt % 1024 == 0 && PerformanceTimer::query() > abort_time_ns) {
+			glob_abort_cnt = 0;
+			return;
+		}
 		glob_abort_cnt--;
 
 		muxinfo_t &muxinfo = mux2info[mux_idx];
@@ -435,7 +520,7 @@ struct OptMuxtreeWorker
 			portinfo_t &portinfo = muxinfo.ports[port_idx];
 			if (portinfo.const_deactivated)
 				continue;
-			if (knowledge.known_active.at(portinfo.ctrl_sig)) {
+			if (get_bit(knowledge.known_active, portinfo.ctrl_sig)) {
 				eval_mux_port(knowledge, mux_idx, port_idx, do_replace_known, do_enable_ports, abort_count);
 				return;
 			}
@@ -449,7 +534,7 @@ struct OptMuxtreeWorker
 			if (portinfo.const_deactivated)
 				continue;
 			if (port_idx < GetSize(muxinfo.ports)-1)
-				if (knowledge.known_inactive.at(portinfo.ctrl_sig))
+				if (get_bit(knowledge.known_inactive, portinfo.ctrl_sig))
 					continue;
 			eval_mux_port(knowledge, mux_idx, port_idx, do_replace_known, do_enable_ports, abort_count);
 
@@ -462,8 +547,8 @@ struct OptMuxtreeWorker
 	{
 		log_assert(glob_abort_cnt > 0);
 		knowledge_t knowledge;
-		knowledge.known_inactive.resize(GetSize(bit2info));
-		knowledge.known_active.resize(GetSize(bit2info));
+		knowledge.known_inactive.resize((GetSize(bit2info) + 63) / 64);
+		knowledge.known_active.resize((GetSize(bit2info) + 63) / 64);
 		knowledge.visited_muxes.resize(GetSize(mux2info));
 		knowledge.visited_muxes[mux_idx] = true;
 		eval_mux(knowledge, mux_idx, true, root_enable_muxes.at(mux_idx), 3);
@@ -476,25 +561,45 @@ struct OptMuxtreePass : public Pass {
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
 		log("\n");
-		log("    opt_muxtree [selection]\n");
+		log("    opt_muxtree [options] [selection]\n");
 		log("\n");
 		log("This pass analyzes the control signals for the multiplexer trees in the design\n");
 		log("and identifies inputs that can never be active. It then removes this dead\n");
 		log("branches from the multiplexer trees.\n");
 		log("\n");
+		log("    -budget <seconds>\n");
+		log("        stop analyzing after roughly the specified amount of CPU time and\n");
+		log("        keep the dead branches proven so far. (independent of this option,\n");
+		log("        the analysis is bounded by a fixed iteration limit, with the same\n");
+		log("        commit-what-was-found behavior.)\n");
+		log("\n");
 		log("This pass only operates on completely selected modules without processes.\n");
 		log("\n");
 	}
 	void execute(vector<std::string> args, RTLIL::Design *design) override
 	{
 		log_header(design, "Executing OPT_MUXTREE pass (detect dead branches in mux trees).\n");
-		extra_args(args, 1, design);
+
+		int budget = 0;
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++) {
+			if (args[argidx] == "-budget" && argidx+1 < args.size()) {
+				budget = atoi(args[++argidx].c_str());
+				continue;
+			}
+			break;
+		}
+		extra_args(args, argidx, design);
+
+		// one deadline for the whole pass execution, shared by all modules
+		int64_t abort_time_ns = budget ? PerformanceTimer::query() + budget * int64_t(1000000000) : 0;
 
 		int total_count = 0;
 		for (auto module : design->selected_whole_modules_warn()) {
 			if (module->has_processes_warn())
 				continue;
-			OptMuxtreeWorker worker(design, module);
+			OptMuxtreeWorker worker(design, module, abort_time_ns);
 			total_count += worker.removed_count;
 		}
 		if (total_count)
@@ -37,6 +37,62 @@ struct OptReduceWorker
 	int total_count;
 	bool did_something;
 
+	// Input vectors of $reduce_* cells are sorted and deduplicated as packed
+	// 64-bit keys (constants first, then wire bits in interning order) using a
+	// radix sort on a reused scratch buffer, so merging large reduce trees
+	// does not allocate per-bit containers inside the fixpoint loop.
+
+	dict<RTLIL::Wire*, int> radix_wire_ids;
+	std::vector<RTLIL::Wire*> radix_wires;
+	std::vector<uint64_t> radix_scratch;
+
+	uint64_t sigbit_key(const RTLIL::SigBit &bit)
+	{
+		if (bit.wire == nullptr)
+			return (uint64_t)bit.data;
+		auto it = radix_wire_ids.find(bit.wire);
+		int id;
+		if (it == radix_wire_ids.end()) {
+			id = GetSize(radix_wires);
+			radix_wire_ids[bit.wire] = id;
+			radix_wires.push_back(bit.wire);
+		} else
+			id = it->second;
+		return ((uint64_t)(id + 1) << 32) | (uint32_t)bit.offset;
+	}
+
+	RTLIL::SigBit sigbit_from_key(uint64_t key)
+	{
+		if ((key >> 32) == 0)
+			return RTLIL::SigBit((RTLIL::State)key);
+		return RTLIL::SigBit(radix_wires[(key >> 32) - 1], (int)(uint32_t)key);
+	}
+
+	void radix_sort_unique(std::vector<uint64_t> &keys)
+	{
+		if (GetSize(keys) > 1)
+		{
+			radix_scratch.resize(keys.size());
+			for (int shift = 0; shift < 64; shift += 8)
+			{
+				size_t count[256] = {};
+				for (uint64_t key : keys)
+					count[(key >> shift) & 0xff]++;
+				if (count[(keys.front() >> shift) & 0xff] == keys.size())
+					continue;
+				size_t offsets[256], pos = 0;
+				for (int i = 0; i < 256; i++) {
+					offsets[i] = pos;
+					pos += count[i];
+				}
+				for (uint64_t key : keys)
+					radix_scratch[offsets[(key >> shift) & 0xff]++] = key;
+				keys.swap(radix_scratch);
+			}
+		}
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	}
+
 	void opt_reduce(pool<RTLIL::Cell*> &cells, SigSet<RTLIL::Cell*> &drivers, RTLIL::Cell *cell)
 	{
 		if (cells.count(cell) == 0)
@@ -44,29 +100,38 @@ struct OptReduceWorker
 		cells.erase(cell);
 
 		RTLIL::SigSpec sig_a = assign_map(cell->getPort(ID::A));
-		sig_a.sort_and_unify();
-		pool<RTLIL::SigBit> new_sig_a_bits;
 
+		std::vector<uint64_t> keys_a;
+		keys_a.reserve(GetSize(sig_a));
 		for (auto &bit : sig_a)
+			keys_a.push_back(sigbit_key(bit));
+		radix_sort_unique(keys_a);
+
+		std::vector<uint64_t> new_keys;
+		new_keys.reserve(keys_a.size());
+
+		for (uint64_t key : keys_a)
 		{
+			RTLIL::SigBit bit = sigbit_from_key(key);
+
 			if (bit == RTLIL::State::S0) {
 				if (cell->type == ID($reduce_and)) {
-					new_sig_a_bits.clear();
-					new_sig_a_bits.insert(RTLIL::State::S0);
+					new_keys.clear();
+					new_keys.push_back(sigbit_key(RTLIL::State::S0));
 					break;
 				}
 				continue;
 			}
 			if (bit == RTLIL::State::S1) {
 				if (cell->type == ID($reduce_or)) {
-					new_sig_a_bits.clear();
-					new_sig_a_bits.insert(RTLIL::State::S1);
+					new_keys.clear();
+					new_keys.push_back(sigbit_key(RTLIL::State::S1));
 					break;
 				}
 				continue;
 			}
 			if (bit.wire == NULL) {
-				new_sig_a_bits.insert(bit);
+				new_keys.push_back(key);
 				continue;
 			}
 
@@ -75,21 +140,24 @@ struct OptReduceWorker
 				if (child_cell->type == cell->type) {
 					opt_reduce(cells, drivers, child_cell);
 					if (child_cell->getPort(ID::Y)[0] == bit) {
-						pool<RTLIL::SigBit> child_sig_a_bits = assign_map(child_cell->getPort(ID::A)).to_sigbit_pool();
-						new_sig_a_bits.insert(child_sig_a_bits.begin(), child_sig_a_bits.end());
+						for (auto &child_bit : assign_map(child_cell->getPort(ID::A)))
+							new_keys.push_back(sigbit_key(child_bit));
 					} else
-						new_sig_a_bits.insert(RTLIL::State::S0);
+						new_keys.push_back(sigbit_key(RTLIL::State::S0));
 					imported_children = true;
 				}
 			}
 			if (!imported_children)
-				new_sig_a_bits.insert(bit);
+				new_keys.push_back(key);
 		}
 
-		RTLIL::SigSpec new_sig_a(new_sig_a_bits);
-		new_sig_a.sort_and_unify();
+		radix_sort_unique(new_keys);
+
+		RTLIL::SigSpec new_sig_a;
+		for (uint64_t key : new_keys)
+			new_sig_a.append(sigbit_from_key(key));
 
-		if (new_sig_a != sig_a || sig_a.size() != cell->getPort(ID::A).size()) {
+		if (new_keys != keys_a || GetSize(keys_a) != cell->getPort(ID::A).size()) {
 			log("    New input vector for %s cell %s: %s\n", cell->type.c_str(), cell->name.c_str(), log_signal(new_sig_a));
 			did_something = true;
 			total_count++;
@@ -106,22 +174,28 @@ struct OptReduceWorker
 		RTLIL::SigSpec sig_b = assign_map(cell->getPort(ID::B));
 		RTLIL::SigSpec sig_s = assign_map(cell->getPort(ID::S));
 
-		RTLIL::SigSpec new_sig_b, new_sig_s;
-		pool<RTLIL::SigSpec> handled_sig;
+		// intern the B patterns: identical slices are grouped in a single pass,
+		// collecting the control bits of each group along the way
+		dict<RTLIL::SigSpec, int> pattern_ids;
+		std::vector<RTLIL::SigSpec> patterns, pattern_sels;
 
-		handled_sig.insert(sig_a);
+		pattern_ids[sig_a] = -1;
 		for (int i = 0; i < sig_s.size(); i++)
 		{
 			RTLIL::SigSpec this_b = sig_b.extract(i*sig_a.size(), sig_a.size());
-			if (handled_sig.count(this_b) > 0)
-				continue;
+			auto it = pattern_ids.find(this_b);
+			if (it == pattern_ids.end()) {
+				pattern_ids[this_b] = GetSize(patterns);
+				patterns.push_back(this_b);
+				pattern_sels.push_back(sig_s.extract(i, 1));
+			} else if (it->second >= 0)
+				pattern_sels[it->second].append(sig_s.extract(i, 1));
+		}
 
-			RTLIL::SigSpec this_s = sig_s.extract(i, 1);
-			for (int j = i+1; j < sig_s.size(); j++) {
-				RTLIL::SigSpec that_b = sig_b.extract(j*sig_a.size(), sig_a.size());
-				if (this_b == that_b)
-					this_s.append(sig_s.extract(j, 1));
-			}
+		RTLIL::SigSpec new_sig_b, new_sig_s;
+		for (int i = 0; i < GetSize(patterns); i++)
+		{
+			RTLIL::SigSpec this_s = pattern_sels[i];
 
 			if (this_s.size() > 1)
 			{
@@ -136,9 +210,8 @@ struct OptReduceWorker
 				reduce_or_cell->setPort(ID::Y, this_s);
 			}
 
-			new_sig_b.append(this_b);
+			new_sig_b.append(patterns[i]);
 			new_sig_s.append(this_s);
-			handled_sig.insert(this_b);
 		}
 
 		if (new_sig_s.size() == 0)
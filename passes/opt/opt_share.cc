@@ -79,6 +79,16 @@ struct ExtSigSpec {
 
 	bool operator==(const RTLIL::SigSpec &other) const { return (sign != RTLIL::Const(0, 1)) ? false : sig == other; }
 	bool operator==(const ExtSigSpec &other) const { return is_signed == other.is_signed && sign == other.sign && sig == other.sig && semantics == other.semantics; }
+
+	unsigned int hash() const
+	{
+		unsigned int h = mkhash_init;
+		h = mkhash(h, sig.hash());
+		h = mkhash(h, sign.hash());
+		h = mkhash(h, is_signed);
+		h = mkhash(h, semantics.hash());
+		return h;
+	}
 };
 
 #define FINE_BITWISE_OPS ID($_AND_), ID($_NAND_), ID($_OR_), ID($_NOR_), ID($_XOR_), ID($_XNOR_), ID($_ANDNOT_), ID($_ORNOT_)
@@ -302,7 +312,7 @@ void check_muxed_operands(std::vector<const OpMuxConn *> &ports, const ExtSigSpe
 	}
 }
 
-ExtSigSpec find_shared_operand(const OpMuxConn* seed, std::vector<const OpMuxConn *> &ports, const std::map<ExtSigSpec, std::set<RTLIL::Cell *>> &operand_to_users, const SigMap &sigmap)
+ExtSigSpec find_shared_operand(const OpMuxConn* seed, std::vector<const OpMuxConn *> &ports, const dict<ExtSigSpec, pool<RTLIL::Cell *>> &operand_to_users, const SigMap &sigmap)
 {
 	std::set<RTLIL::Cell *> ops_using_operand;
 	std::set<RTLIL::Cell *> ops_set;
@@ -315,7 +325,7 @@ ExtSigSpec find_shared_operand(const OpMuxConn* seed, std::vector<const OpMuxCon
 
 	for (RTLIL::IdString port_name : {ID::A, ID::B}) {
 		oper = decode_port(op_a, port_name, sigmap);
-		auto operand_users = operand_to_users.at(oper);
+		auto &operand_users = operand_to_users.at(oper);
 
 		if (operand_users.size() == 1)
 			continue;
@@ -373,8 +383,9 @@ struct OptSharePass : public Pass {
 					for (auto bit : SigSpec(wire))
 						bit_users[sigmap(bit)]++;
 
-			std::map<ExtSigSpec, std::set<RTLIL::Cell *>> operand_to_users;
+			dict<ExtSigSpec, pool<RTLIL::Cell *>> operand_to_users;
 			dict<RTLIL::SigBit, std::pair<RTLIL::Cell *, int>> op_outbit_to_outsig;
+			std::vector<RTLIL::Cell *> op_cells;
 			bool any_shared_operands = false;
 
 			for (auto cell : module->selected_cells()) {
@@ -393,9 +404,7 @@ struct OptSharePass : public Pass {
 				if (skip)
 					continue;
 
-				auto mux_insig = sigmap(cell->getPort(ID::Y));
-				for (int i = 0; i < GetSize(mux_insig); i++)
-					op_outbit_to_outsig[mux_insig[i]] = std::make_pair(cell, i);
+				op_cells.push_back(cell);
 
 				for (RTLIL::IdString port_name : {ID::A, ID::B}) {
 					auto op_insig = decode_port(cell, port_name, sigmap);
@@ -408,6 +417,27 @@ struct OptSharePass : public Pass {
 			if (!any_shared_operands)
 				continue;
 
+			// Index the output bits of the candidate operators, so that the
+			// $mux scan below only ever looks at cells it can actually merge.
+			// Operators whose operand signatures are unique in the module can
+			// never share an operand with another operator, so they are left
+			// out of the index entirely.
+			for (auto cell : op_cells) {
+				bool has_shared_operand = false;
+				for (RTLIL::IdString port_name : {ID::A, ID::B}) {
+					auto op_insig = decode_port(cell, port_name, sigmap);
+					if (operand_to_users.at(op_insig).size() > 1)
+						has_shared_operand = true;
+				}
+
+				if (!has_shared_operand)
+					continue;
+
+				auto mux_insig = sigmap(cell->getPort(ID::Y));
+				for (int i = 0; i < GetSize(mux_insig); i++)
+					op_outbit_to_outsig[mux_insig[i]] = std::make_pair(cell, i);
+			}
+
 			// Operator outputs need to be exclusively connected to the $mux inputs in order to be mergeable. Hence we count to
 			// how many points are operator output bits connected.
 			std::vector<merged_op_t> merged_ops;
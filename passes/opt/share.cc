@@ -30,9 +30,24 @@ PRIVATE_NAMESPACE_BEGIN
 typedef RTLIL::IdString::compare_ptr_by_name<RTLIL::Cell> cell_ptr_cmp;
 typedef std::pair<RTLIL::SigSpec, RTLIL::Const> ssc_pair_t;
 
+// Verdicts of completed pair proofs, keyed by a digest of the exact SAT
+// problem (the filtered activation patterns of both cells plus the imported
+// input cone). The cache persists across calls to the pass, so scripts that
+// run `share` multiple times do not re-prove pairs whose control logic is
+// unchanged. Only verdicts from completed solver runs are recorded, never
+// aborted (timed out) ones.
+enum proof_verdict_t : char {
+	PROOF_NEVER_ACTIVE_1,
+	PROOF_NEVER_ACTIVE_2,
+	PROOF_SHAREABLE,
+	PROOF_NOT_SHAREABLE
+};
+static dict<uint64_t, char> sat_proof_cache;
+
 struct ShareWorkerConfig
 {
 	int limit;
+	int solver_timeout;
 	bool opt_force;
 	bool opt_aggressive;
 	bool opt_fast;
@@ -123,11 +138,37 @@ struct ShareWorker
 		return bits;
 	}
 
-	static int bits_macc(RTLIL::Cell *c)
+	// Decoded $macc models get reused across all pairwise compatibility
+	// checks, which would otherwise re-run from_cell/optimize/sort once per
+	// candidate pair. Cells are only marked for removal while the worker
+	// runs, so the cell pointers stay valid; both caches are reset per
+	// module in operator()().
+	dict<RTLIL::Cell*, Macc> macc_model_cache;
+	dict<RTLIL::Cell*, int> macc_bits_cache;
+
+	const Macc &get_macc_model(RTLIL::Cell *c)
+	{
+		auto it = macc_model_cache.find(c);
+		if (it == macc_model_cache.end()) {
+			Macc &m = macc_model_cache[c];
+			m.from_cell(c);
+			m.optimize(GetSize(c->getPort(ID::Y)));
+			std::sort(m.ports.begin(), m.ports.end(), cmp_macc_ports);
+			it = macc_model_cache.find(c);
+		}
+		return it->second;
+	}
+
+	int bits_macc(RTLIL::Cell *c)
 	{
+		auto it = macc_bits_cache.find(c);
+		if (it != macc_bits_cache.end())
+			return it->second;
 		Macc m(c);
 		int width = GetSize(c->getPort(ID::Y));
-		return bits_macc(m, width);
+		int bits = bits_macc(m, width);
+		macc_bits_cache[c] = bits;
+		return bits;
 	}
 
 	static bool cmp_macc_ports(const Macc::port_t &p1, const Macc::port_t &p2)
@@ -238,17 +279,11 @@ struct ShareWorker
 	int share_macc(RTLIL::Cell *c1, RTLIL::Cell *c2,
 			RTLIL::SigSpec act = RTLIL::SigSpec(), RTLIL::Cell *supercell = nullptr, pool<RTLIL::Cell*> *supercell_aux = nullptr)
 	{
-		Macc m1(c1), m2(c2), supermacc;
+		Macc m1 = get_macc_model(c1), m2 = get_macc_model(c2), supermacc;
 
 		int w1 = GetSize(c1->getPort(ID::Y)), w2 = GetSize(c2->getPort(ID::Y));
 		int width = max(w1, w2);
 
-		m1.optimize(w1);
-		m2.optimize(w2);
-
-		std::sort(m1.ports.begin(), m1.ports.end(), cmp_macc_ports);
-		std::sort(m2.ports.begin(), m2.ports.end(), cmp_macc_ports);
-
 		std::set<int> m1_unmapped, m2_unmapped;
 
 		for (int i = 0; i < GetSize(m1.ports); i++)
@@ -1108,6 +1143,72 @@ struct ShareWorker
 	}
 
 
+	// ------------------------------
+	// Caching of completed SAT proofs
+	// ------------------------------
+
+	void append_sig_text(std::string &text, const RTLIL::SigSpec &sig)
+	{
+		RTLIL::SigSpec mapped_sig = modwalker.sigmap(sig);
+		for (auto &chunk : mapped_sig.chunks()) {
+			if (chunk.wire != nullptr)
+				text += stringf(" %s[%d:%d]", chunk.wire->name.c_str(), chunk.offset, chunk.width);
+			else
+				text += " " + RTLIL::Const(chunk.data).as_string();
+		}
+	}
+
+	// The solver verdict for a candidate pair is a pure function of the CNF,
+	// which in turn is fully determined by the activation patterns of the two
+	// cells and the cells that QuickConeSat imported for their input cones.
+	// Digest exactly that data, so that re-running the pass on an unchanged
+	// (part of a) design reproduces the digest and can reuse the verdict.
+	uint64_t proof_cache_digest(const pool<ssc_pair_t> &patterns1, const pool<ssc_pair_t> &patterns2, QuickConeSat &qcsat)
+	{
+		std::vector<std::string> lines;
+
+		for (auto &p : patterns1) {
+			std::string line = "A:";
+			append_sig_text(line, p.first);
+			line += " = " + p.second.as_string();
+			lines.push_back(line);
+		}
+
+		for (auto &p : patterns2) {
+			std::string line = "B:";
+			append_sig_text(line, p.first);
+			line += " = " + p.second.as_string();
+			lines.push_back(line);
+		}
+
+		for (auto c : qcsat.imported_cells) {
+			std::vector<std::string> parts;
+			for (auto &conn : c->connections()) {
+				std::string part = conn.first.str();
+				append_sig_text(part, conn.second);
+				parts.push_back(part);
+			}
+			for (auto &par : c->parameters)
+				parts.push_back(par.first.str() + "=" + par.second.as_string());
+			std::sort(parts.begin(), parts.end());
+			std::string line = "C: " + c->type.str();
+			for (auto &part : parts)
+				line += " | " + part;
+			lines.push_back(line);
+		}
+
+		for (auto w : qcsat.imported_onehot)
+			lines.push_back(stringf("O: %s %d", w->name.c_str(), w->width));
+
+		std::sort(lines.begin(), lines.end());
+
+		std::string text;
+		for (auto &line : lines)
+			text += line + "\n";
+		return std::hash<std::string>()(text);
+	}
+
+
 	// -------------
 	// Setup and run
 	// -------------
@@ -1161,6 +1262,8 @@ struct ShareWorker
 		shareable_cells.clear();
 		forbidden_controls_cache.clear();
 		activation_patterns_cache.clear();
+		macc_model_cache.clear();
+		macc_bits_cache.clear();
 
 		find_terminal_bits();
 		find_shareable_cells();
@@ -1254,8 +1357,9 @@ struct ShareWorker
 					qcsat.max_cell_outs = 3;
 					qcsat.max_cell_count = 100;
 				}
+				if (config.solver_timeout > 0)
+					qcsat.ez->setSolverTimeout(config.solver_timeout);
 
-				pool<RTLIL::Cell*> sat_cells;
 				std::set<RTLIL::SigBit> bits_queue;
 
 				std::vector<int> cell_active, other_cell_active;
@@ -1275,38 +1379,80 @@ struct ShareWorker
 
 				qcsat.prepare();
 
-				int sub1 = qcsat.ez->expression(qcsat.ez->OpOr, cell_active);
-				if (!qcsat.ez->solve(sub1)) {
+				all_ctrl_signals.sort_and_unify();
+
+				uint64_t proof_digest = proof_cache_digest(filtered_cell_activation_patterns,
+						filtered_other_cell_activation_patterns, qcsat);
+				auto cached_proof = sat_proof_cache.find(proof_digest);
+
+				char verdict;
+				if (cached_proof != sat_proof_cache.end())
+				{
+					log("      Reusing cached result for identical SAT problem.\n");
+					verdict = cached_proof->second;
+				}
+				else
+				{
+					int sub1 = qcsat.ez->expression(qcsat.ez->OpOr, cell_active);
+					int sub2 = qcsat.ez->expression(qcsat.ez->OpOr, other_cell_active);
+
+					bool solver_timed_out = false;
+
+					if (!qcsat.ez->solve(sub1)) {
+						verdict = PROOF_NEVER_ACTIVE_1;
+						solver_timed_out = qcsat.ez->getSolverTimoutStatus();
+					} else if (!qcsat.ez->solve(sub2)) {
+						verdict = PROOF_NEVER_ACTIVE_2;
+						solver_timed_out = qcsat.ez->getSolverTimoutStatus();
+					} else {
+						qcsat.ez->non_incremental();
+
+						std::vector<int> sat_model = qcsat.importSig(all_ctrl_signals);
+						std::vector<bool> sat_model_values;
+
+						qcsat.ez->assume(qcsat.ez->AND(sub1, sub2));
+
+						log("      Size of SAT problem: %d cells, %d variables, %d clauses\n",
+								GetSize(qcsat.imported_cells), qcsat.ez->numCnfVariables(), qcsat.ez->numCnfClauses());
+
+						if (qcsat.ez->solve(sat_model, sat_model_values)) {
+							verdict = PROOF_NOT_SHAREABLE;
+							log("      Model from SAT solver: %s = %d'", log_signal(all_ctrl_signals), GetSize(sat_model_values));
+							for (int i = GetSize(sat_model_values)-1; i >= 0; i--)
+								log("%c", sat_model_values[i] ? '1' : '0');
+							log("\n");
+						} else {
+							verdict = PROOF_SHAREABLE;
+							solver_timed_out = qcsat.ez->getSolverTimoutStatus();
+						}
+					}
+
+					// A timed out query returns "unsatisfiable" without a proof, so the
+					// verdict derived from it must not be trusted (or cached). Leave the
+					// pair unshared and move on.
+					if (solver_timed_out) {
+						log("      SAT solver timeout. Skipping this pair of cells.\n");
+						continue;
+					}
+
+					sat_proof_cache[proof_digest] = verdict;
+				}
+
+				if (verdict == PROOF_NEVER_ACTIVE_1) {
 					log("      According to the SAT solver the cell %s is never active. Sharing is pointless, we simply remove it.\n", log_id(cell));
 					cells_to_remove.insert(cell);
 					break;
 				}
 
-				int sub2 = qcsat.ez->expression(qcsat.ez->OpOr, other_cell_active);
-				if (!qcsat.ez->solve(sub2)) {
+				if (verdict == PROOF_NEVER_ACTIVE_2) {
 					log("      According to the SAT solver the cell %s is never active. Sharing is pointless, we simply remove it.\n", log_id(other_cell));
 					cells_to_remove.insert(other_cell);
 					shareable_cells.erase(other_cell);
 					continue;
 				}
 
-				qcsat.ez->non_incremental();
-
-				all_ctrl_signals.sort_and_unify();
-				std::vector<int> sat_model = qcsat.importSig(all_ctrl_signals);
-				std::vector<bool> sat_model_values;
-
-				qcsat.ez->assume(qcsat.ez->AND(sub1, sub2));
-
-				log("      Size of SAT problem: %d cells, %d variables, %d clauses\n",
-						GetSize(sat_cells), qcsat.ez->numCnfVariables(), qcsat.ez->numCnfClauses());
-
-				if (qcsat.ez->solve(sat_model, sat_model_values)) {
+				if (verdict == PROOF_NOT_SHAREABLE) {
 					log("      According to the SAT solver this pair of cells can not be shared.\n");
-					log("      Model from SAT solver: %s = %d'", log_signal(all_ctrl_signals), GetSize(sat_model_values));
-					for (int i = GetSize(sat_model_values)-1; i >= 0; i--)
-						log("%c", sat_model_values[i] ? '1' : '0');
-					log("\n");
 					continue;
 				}
 
@@ -1439,12 +1585,17 @@ struct SharePass : public Pass {
 		log("  -limit N\n");
 		log("    Only perform the first N merges, then stop. This is useful for debugging.\n");
 		log("\n");
+		log("  -timeout N\n");
+		log("    Abort each SAT query after N seconds. Pairs whose proof timed out are\n");
+		log("    conservatively left unshared.\n");
+		log("\n");
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) override
 	{
 		ShareWorkerConfig config;
 
 		config.limit = -1;
+		config.solver_timeout = 0;
 		config.opt_force = false;
 		config.opt_aggressive = false;
 		config.opt_fast = false;
@@ -1509,6 +1660,10 @@ struct SharePass : public Pass {
 				config.limit = atoi(args[++argidx].c_str());
 				continue;
 			}
+			if (args[argidx] == "-timeout" && argidx+1 < args.size()) {
+				config.solver_timeout = atoi(args[++argidx].c_str());
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
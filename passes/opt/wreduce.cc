@@ -396,6 +396,309 @@ struct WreduceWorker
 		}
 	}
 
+	// --------------------------------------------------------------------------
+	// Phase-based width planning for the plain word-level cells
+	//
+	// Instead of shrinking one cell at a time (with each resize rebuilding port
+	// SigSpecs and re-queuing the fanout), the final widths of all simple cells
+	// are first computed as a dataflow fixpoint over a width table, and then all
+	// resizes are applied in one bulk mutation pass. The per-round state is a
+	// few integers and a per-bit kind tag per cell, so the fixpoint iterates
+	// without touching the netlist at all. Muxes and FFs replace output bits
+	// with computed values that the width table cannot express, so they are
+	// left to the incremental loop that runs afterwards (which also picks up
+	// any residual opportunities and therefore reaches the same fixpoint).
+	// --------------------------------------------------------------------------
+
+	struct CellPlan
+	{
+		SigSpec sig_a, sig_b, sig_y;
+		int width_a = -1, width_b = -1;
+		int width_y = 0;
+		bool a_signed = false, b_signed = false;
+		bool drop_signed = false;
+		// one entry per original Y bit: 'k' kept, '0' zero padding, 's' sign
+		// padding (aliases the next non-pad bit below), 'x' unused (undriven)
+		std::vector<char> y_kind;
+	};
+
+	dict<Cell*, CellPlan> plan;
+	dict<SigBit, std::pair<Cell*, int>> plan_driver;
+
+	// Resolve a bit to the value it will have after the planned resizes are
+	// applied: planned zero padding resolves to S0, planned sign padding to
+	// the output bit it will be connected to.
+	SigBit plan_resolve(SigBit bit)
+	{
+		auto it = plan_driver.find(bit);
+		if (it == plan_driver.end())
+			return bit;
+
+		const CellPlan &p = plan.at(it->second.first);
+		int off = it->second.second;
+
+		while (p.y_kind[off] == 's')
+			off--;
+		if (p.y_kind[off] == '0')
+			return State::S0;
+		return p.sig_y[off];
+	}
+
+	// Will this output bit of the given cell still have readers after the
+	// planned resizes? Reads from port bits that the plan already removed
+	// do not count.
+	bool plan_bit_used(Cell *cell, SigBit bit)
+	{
+		if (keep_bits.count(bit))
+			return true;
+
+		auto info = mi.query(bit);
+		if (info == nullptr || info->is_output)
+			return true;
+
+		bool skipped_self = false;
+		for (auto &port : info->ports) {
+			if (!skipped_self && port.cell == cell && port.port == ID::Y) {
+				skipped_self = true;
+				continue;
+			}
+			auto it = plan.find(port.cell);
+			if (it != plan.end()) {
+				if (port.port == ID::A && port.offset >= it->second.width_a)
+					continue;
+				if (port.port == ID::B && port.offset >= it->second.width_b)
+					continue;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	int plan_reduce_inport(const SigSpec &sig, int width, bool is_signed)
+	{
+		if (is_signed) {
+			while (width > 1 && plan_resolve(sig[width-1]) == plan_resolve(sig[width-2]))
+				width--;
+		} else {
+			while (width > 1 && plan_resolve(sig[width-1]) == State::S0)
+				width--;
+		}
+		return width;
+	}
+
+	// One round of the width fixpoint for one cell, mirroring run_cell().
+	// All planned quantities shrink monotonically, so iterating this until
+	// nothing changes terminates.
+	bool refine_cell_plan(Cell *cell, CellPlan &p)
+	{
+		int old_width_a = p.width_a, old_width_b = p.width_b, old_width_y = p.width_y;
+		bool old_drop_signed = p.drop_signed;
+
+		// Reduce size of ports A and B based on constant input bits and size of output port
+
+		int max_port_a_size = p.width_a;
+		int max_port_b_size = p.width_b;
+
+		if (cell->type.in(ID($not), ID($pos), ID($neg), ID($and), ID($or), ID($xor), ID($add), ID($sub))) {
+			max_port_a_size = min(max_port_a_size, p.width_y);
+			max_port_b_size = min(max_port_b_size, p.width_y);
+		}
+
+		if (p.width_a >= 0 && cell->type != ID($shiftx))
+			p.width_a = plan_reduce_inport(p.sig_a, max_port_a_size, p.a_signed);
+
+		if (p.width_b >= 0)
+			p.width_b = plan_reduce_inport(p.sig_b, max_port_b_size, p.b_signed);
+
+		if (p.width_a > 0 && p.width_b > 0 && p.a_signed && p.b_signed &&
+				plan_resolve(p.sig_a[p.width_a-1]) == State::S0 &&
+				plan_resolve(p.sig_b[p.width_b-1]) == State::S0) {
+			p.a_signed = false, p.b_signed = false;
+			p.drop_signed = true;
+		}
+
+		if (p.width_a > 0 && p.width_b < 0 && p.a_signed &&
+				plan_resolve(p.sig_a[p.width_a-1]) == State::S0) {
+			p.a_signed = false;
+			p.drop_signed = true;
+		}
+
+		// Reduce size of port Y based on sizes for A and B and unused bits in Y
+
+		if (!(p.a_signed && cell->type == ID($shr))) {
+			while (p.width_y > 0) {
+				bool used = plan_bit_used(cell, p.sig_y[p.width_y-1]);
+				// sign padding planned above this bit will be connected to it,
+				// so it stays alive as long as any of those pad bits is read
+				for (int i = p.width_y; !used && i < GetSize(p.y_kind) && p.y_kind[i] == 's'; i++)
+					used = plan_bit_used(cell, p.sig_y[i]);
+				if (used)
+					break;
+				p.y_kind[--p.width_y] = 'x';
+			}
+		}
+
+		if (cell->type.in(ID($pos), ID($add), ID($mul), ID($and), ID($or), ID($xor), ID($sub)))
+		{
+			bool is_signed = p.a_signed || cell->type == ID($sub);
+
+			int a_size = max(p.width_a, 0), b_size = max(p.width_b, 0);
+			int max_y_size = max(a_size, b_size);
+
+			if (cell->type.in(ID($add), ID($sub)))
+				max_y_size++;
+
+			if (cell->type == ID($mul))
+				max_y_size = a_size + b_size;
+
+			max_y_size = std::max(max_y_size, 1);
+
+			if (p.width_y > max_y_size) {
+				for (int i = max_y_size; i < p.width_y; i++)
+					p.y_kind[i] = is_signed ? 's' : '0';
+				p.width_y = max_y_size;
+			}
+		}
+
+		return p.width_a != old_width_a || p.width_b != old_width_b ||
+				p.width_y != old_width_y || p.drop_signed != old_drop_signed;
+	}
+
+	void plan_widths()
+	{
+		for (auto c : module->selected_cells())
+		{
+			if (!c->type.in(config->supported_cell_types))
+				continue;
+			if (c->type.in(ID($mux), ID($pmux)))
+				continue;
+			if (c->type.in(ID($dff), ID($dffe), ID($adff), ID($adffe), ID($sdff), ID($sdffe), ID($sdffce), ID($dlatch), ID($adlatch)))
+				continue;
+
+			SigSpec sig_y = mi.sigmap(c->getPort(ID::Y));
+			if (GetSize(sig_y) == 0 || sig_y.has_const())
+				continue;
+
+			CellPlan p;
+			p.sig_y = sig_y;
+			p.width_y = GetSize(sig_y);
+			p.y_kind.assign(p.width_y, 'k');
+
+			if (c->hasPort(ID::A)) {
+				p.sig_a = mi.sigmap(c->getPort(ID::A));
+				p.width_a = GetSize(p.sig_a);
+				p.a_signed = c->getParam(ID::A_SIGNED).as_bool();
+			}
+
+			if (c->hasPort(ID::B)) {
+				p.sig_b = mi.sigmap(c->getPort(ID::B));
+				p.width_b = GetSize(p.sig_b);
+				p.b_signed = c->getParam(ID::B_SIGNED).as_bool();
+				if (c->type.in(ID($shl), ID($shr), ID($sshl), ID($sshr)))
+					p.b_signed = false;
+			}
+
+			plan[c] = p;
+		}
+
+		// Bits with multiple (or duplicate) planned drivers cannot be padded
+		// reliably, so cells driving such bits are left to the incremental loop.
+		pool<SigBit> multiple_drivers;
+		for (auto &it : plan)
+			for (int i = 0; i < GetSize(it.second.sig_y); i++) {
+				SigBit bit = it.second.sig_y[i];
+				if (multiple_drivers.count(bit))
+					continue;
+				if (plan_driver.count(bit)) {
+					plan_driver.erase(bit);
+					multiple_drivers.insert(bit);
+				} else
+					plan_driver[bit] = std::make_pair(it.first, i);
+			}
+
+		if (!multiple_drivers.empty()) {
+			std::vector<Cell*> dropped_cells;
+			for (auto &it : plan)
+				for (auto bit : it.second.sig_y)
+					if (multiple_drivers.count(bit)) {
+						dropped_cells.push_back(it.first);
+						break;
+					}
+			for (auto c : dropped_cells) {
+				for (auto bit : plan.at(c).sig_y) {
+					auto it = plan_driver.find(bit);
+					if (it != plan_driver.end() && it->second.first == c)
+						plan_driver.erase(it);
+				}
+				plan.erase(c);
+			}
+		}
+	}
+
+	void apply_planned_widths()
+	{
+		for (auto &it : plan)
+		{
+			Cell *cell = it.first;
+			CellPlan &p = it.second;
+
+			// Emit the planned padding connections first: they may feed other
+			// cells and must exist even if this cell turns out to be fully dead.
+			if (p.width_y < GetSize(p.sig_y)) {
+				SigSpec pad_lhs, pad_rhs;
+				for (int i = p.width_y; i < GetSize(p.sig_y); i++) {
+					if (p.y_kind[i] == 'x')
+						continue;
+					pad_lhs.append(p.sig_y[i]);
+					pad_rhs.append(plan_resolve(p.sig_y[i]));
+				}
+				if (GetSize(pad_lhs) > 0)
+					module->connect(pad_lhs, pad_rhs);
+			}
+
+			if (p.width_y == 0) {
+				log("Removed cell %s.%s (%s).\n", log_id(module), log_id(cell), log_id(cell->type));
+				module->remove(cell);
+				continue;
+			}
+
+			bool did_something = false;
+
+			if (p.width_a >= 0 && p.width_a < GetSize(p.sig_a)) {
+				log("Removed top %d bits (of %d) from port A of cell %s.%s (%s).\n",
+						GetSize(p.sig_a) - p.width_a, GetSize(p.sig_a), log_id(module), log_id(cell), log_id(cell->type));
+				cell->setPort(ID::A, p.sig_a.extract(0, p.width_a));
+				did_something = true;
+			}
+
+			if (p.width_b >= 0 && p.width_b < GetSize(p.sig_b)) {
+				log("Removed top %d bits (of %d) from port B of cell %s.%s (%s).\n",
+						GetSize(p.sig_b) - p.width_b, GetSize(p.sig_b), log_id(module), log_id(cell), log_id(cell->type));
+				cell->setPort(ID::B, p.sig_b.extract(0, p.width_b));
+				did_something = true;
+			}
+
+			if (p.drop_signed) {
+				log("Converting cell %s.%s (%s) from signed to unsigned.\n",
+						log_id(module), log_id(cell), log_id(cell->type));
+				cell->setParam(ID::A_SIGNED, 0);
+				if (cell->hasPort(ID::B))
+					cell->setParam(ID::B_SIGNED, 0);
+				did_something = true;
+			}
+
+			if (p.width_y < GetSize(p.sig_y)) {
+				log("Removed top %d bits (of %d) from port Y of cell %s.%s (%s).\n",
+						GetSize(p.sig_y) - p.width_y, GetSize(p.sig_y), log_id(module), log_id(cell), log_id(cell->type));
+				cell->setPort(ID::Y, p.sig_y.extract(0, p.width_y));
+				did_something = true;
+			}
+
+			if (did_something)
+				cell->fixup_parameters();
+		}
+	}
+
 	static int count_nontrivial_wire_attrs(RTLIL::Wire *w)
 	{
 		int count = w->attributes.size();
@@ -416,6 +719,21 @@ struct WreduceWorker
 					keep_bits.insert(bit);
 		}
 
+		plan_widths();
+
+		if (!plan.empty()) {
+			bool keep_running = true;
+			while (keep_running) {
+				keep_running = false;
+				for (auto &it : plan)
+					if (refine_cell_plan(it.first, it.second))
+						keep_running = true;
+			}
+			apply_planned_widths();
+			plan.clear();
+			plan_driver.clear();
+		}
+
 		for (auto c : module->selected_cells())
 			work_queue_cells.insert(c);
 
@@ -394,6 +394,7 @@ with open(outfile, "w") as f:
             print("  typedef std::tuple<{}> index_{}_value_type;".format(", ".join(value_types), index), file=f)
             print("  dict<index_{}_key_type, vector<index_{}_value_type>> index_{};".format(index, index, index), file=f)
     print("  dict<SigBit, pool<Cell*>> sigusers;", file=f)
+    print("  dict<SigSpec, int> nusers_cache;", file=f)
     print("  pool<Cell*> blacklist_cells;", file=f)
     print("  pool<Cell*> autoremove_cells;", file=f)
     print("  dict<Cell*,int> rollback_cache;", file=f)
@@ -422,6 +423,7 @@ with open(outfile, "w") as f:
     print("", file=f)
 
     print("  void add_siguser(const SigSpec &sig, Cell *cell) {", file=f)
+    print("    nusers_cache.clear();", file=f)
     print("    for (auto bit : sigmap(sig)) {", file=f)
     print("      if (bit.wire == nullptr) continue;", file=f)
     print("      sigusers[bit].insert(cell);", file=f)
@@ -472,11 +474,18 @@ with open(outfile, "w") as f:
     print("  }", file=f)
     print("", file=f)
 
+    print("  // Memoized: match blocks re-evaluate the same nusers() calls for", file=f)
+    print("  // every root cell the subpattern is tried against. The cache is", file=f)
+    print("  // dropped whenever add_siguser() changes the user sets.", file=f)
     print("  int nusers(const SigSpec &sig) {", file=f)
+    print("    auto cache_ptr = nusers_cache.find(sig);", file=f)
+    print("    if (cache_ptr != nusers_cache.end())", file=f)
+    print("      return cache_ptr->second;", file=f)
     print("    pool<Cell*> users;", file=f)
     print("    for (auto bit : sigmap(sig))", file=f)
     print("      for (auto user : sigusers[bit])", file=f)
     print("        users.insert(user);", file=f)
+    print("    nusers_cache.insert(std::make_pair(sig, GetSize(users)));", file=f)
     print("    return GetSize(users);", file=f)
     print("  }", file=f)
     print("", file=f)
@@ -108,6 +108,21 @@ struct ProcPass : public Pass {
 		}
 		extra_args(args, argidx, design);
 
+		// The whole chain only lowers processes, so when the selection
+		// contains none (e.g. a script defensively calling 'proc' again)
+		// there is nothing for any of the child passes to do.
+		bool found_processes = false;
+		for (auto mod : design->modules())
+			if (design->selected(mod) && !mod->processes.empty()) {
+				found_processes = true;
+				break;
+			}
+		if (!found_processes) {
+			log("No processes in selected modules.\n");
+			log_pop();
+			return;
+		}
+
 		Pass::call(design, "proc_clean");
 		if (!ifxmode)
 			Pass::call(design, "proc_rmdead");
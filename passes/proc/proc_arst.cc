@@ -289,7 +289,7 @@ struct ProcArstPass : public Pass {
 		pool<Wire*> delete_initattr_wires;
 
 		for (auto mod : design->modules())
-			if (design->selected(mod)) {
+			if (design->selected(mod) && !mod->processes.empty()) {
 				SigMap assign_map(mod);
 				for (auto &proc_it : mod->processes) {
 					if (!design->selected(mod, proc_it.second))
@@ -307,7 +307,7 @@ struct ProcDffPass : public Pass {
 		extra_args(args, 1, design);
 
 		for (auto mod : design->modules())
-			if (design->selected(mod)) {
+			if (design->selected(mod) && !mod->processes.empty()) {
 				ConstEval ce(mod);
 				for (auto &proc_it : mod->processes)
 					if (design->selected(mod, proc_it.second))
@@ -465,6 +465,8 @@ struct ProcDlatchPass : public Pass {
 		extra_args(args, 1, design);
 
 		for (auto module : design->selected_modules()) {
+			if (module->processes.empty())
+				continue;
 			proc_dlatch_db_t db(module);
 			for (auto &proc_it : module->processes)
 				if (design->selected(module, proc_it.second))
@@ -100,6 +100,8 @@ struct ProcMemWrPass : public Pass {
 		extra_args(args, 1, design);
 
 		for (auto module : design->selected_modules()) {
+			if (module->processes.empty())
+				continue;
 			dict<IdString, int> next_port_id;
 			for (auto cell : module->cells()) {
 				if (cell->type.in(ID($memwr), ID($memwr_v2))) {
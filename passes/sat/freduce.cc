@@ -666,8 +666,13 @@ struct FreduceWorker
 		}
 		log("  Sorted %d signal bits into %d buckets.\n", bits_count, int(buckets.size()));
 
+		struct bucket_job_t {
+			std::vector<RTLIL::SigBit> *bits;
+			int cone_size, perc;
+		};
+
 		int bucket_count = 0;
-		std::vector<std::vector<equiv_bit_t>> equiv;
+		std::vector<bucket_job_t> jobs;
 		for (auto &bucket : buckets)
 		{
 			bucket_count++;
@@ -675,15 +680,63 @@ struct FreduceWorker
 			if (bucket.second.size() == 1)
 				continue;
 
-			if (bucket.first.size() == 0) {
-				log("  Finding const values for bucket %s%c\n", log_signal(bucket.second), verbose_level ? ':' : '.');
-				PerformReduction worker(sigmap, drivers, inv_pairs, bucket.second, bucket.first.size());
-				for (size_t idx = 0; idx < bucket.second.size(); idx++)
-					worker.analyze_const(equiv, idx);
-			} else {
-				log("  Trying to shatter bucket %s%c\n", log_signal(bucket.second), verbose_level ? ':' : '.');
-				PerformReduction worker(sigmap, drivers, inv_pairs, bucket.second, bucket.first.size());
-				worker.analyze(equiv, 100 * bucket_count / (buckets.size() + 1));
+			jobs.push_back(bucket_job_t { &bucket.second, int(bucket.first.size()), int(100 * bucket_count / (buckets.size() + 1)) });
+		}
+
+		std::vector<std::vector<equiv_bit_t>> equiv;
+		ThreadPool &pool = ThreadPool::get();
+
+		if (pool.num_threads() == 1 || verbose_level > 0 || jobs.size() <= 1)
+		{
+			for (auto &job : jobs)
+			{
+				if (job.cone_size == 0) {
+					log("  Finding const values for bucket %s%c\n", log_signal(*job.bits), verbose_level ? ':' : '.');
+					PerformReduction worker(sigmap, drivers, inv_pairs, *job.bits, job.cone_size);
+					for (size_t idx = 0; idx < job.bits->size(); idx++)
+						worker.analyze_const(equiv, idx);
+				} else {
+					log("  Trying to shatter bucket %s%c\n", log_signal(*job.bits), verbose_level ? ':' : '.');
+					PerformReduction worker(sigmap, drivers, inv_pairs, *job.bits, job.cone_size);
+					worker.analyze(equiv, job.perc);
+				}
+			}
+		}
+		else
+		{
+			// The SAT problems for different buckets are fully independent, but
+			// importing the cones is not thread-safe (log_id() uses a global
+			// cache and SigMap lookups do path compression). So set up the
+			// solvers for a chunk of buckets on the main thread, run the
+			// solver-driven shattering for the chunk in parallel into per-bucket
+			// result vectors, and merge those in bucket order to keep the
+			// output deterministic. The verbose code paths log from within the
+			// analysis and therefore take the sequential branch above.
+			size_t chunk_size = pool.num_threads();
+			for (size_t chunk_begin = 0; chunk_begin < jobs.size(); chunk_begin += chunk_size)
+			{
+				size_t chunk_len = min(jobs.size() - chunk_begin, chunk_size);
+
+				std::vector<std::unique_ptr<PerformReduction>> solvers;
+				for (size_t i = 0; i < chunk_len; i++) {
+					bucket_job_t &job = jobs[chunk_begin + i];
+					log("  %s bucket %s.\n", job.cone_size == 0 ? "Finding const values for" : "Trying to shatter", log_signal(*job.bits));
+					solvers.emplace_back(new PerformReduction(sigmap, drivers, inv_pairs, *job.bits, job.cone_size));
+				}
+
+				std::vector<std::vector<std::vector<equiv_bit_t>>> chunk_equiv(chunk_len);
+				pool.parallel_for(chunk_len, [&](int i) {
+					bucket_job_t &job = jobs[chunk_begin + i];
+					if (job.cone_size == 0) {
+						for (size_t idx = 0; idx < job.bits->size(); idx++)
+							solvers[i]->analyze_const(chunk_equiv[i], idx);
+					} else
+						solvers[i]->analyze(chunk_equiv[i], job.perc);
+				});
+
+				for (auto &r : chunk_equiv)
+					for (auto &grp : r)
+						equiv.push_back(std::move(grp));
 			}
 		}
 
@@ -32,6 +32,7 @@ struct mutate_t {
 	int ctrlbit = -1;
 	int wirebit = -1;
 	bool used = false;
+	int cover_score = -1; // per-mutation cache used by database_reduce()
 };
 
 struct mutate_opts_t {
@@ -308,6 +309,36 @@ void database_reduce(std::vector<mutate_t> &database, const mutate_opts_t &opts,
 		}
 	}
 
+	// The cover branch below repeatedly needs the minimum src_db count over
+	// each mutation's src set. Those counts only change when a mutation is
+	// committed, so cache the score per mutation and invalidate through a
+	// src index instead of re-running the inner loop over the whole
+	// database on every refill of the candidate list.
+	dict<string, vector<mutate_t*>> src_index;
+	for (auto &m : database)
+		for (auto &s : m.src)
+			src_index[s].push_back(&m);
+
+	auto cover_score = [&](mutate_t *m) {
+		if (m->cover_score < 0) {
+			int this_score = -1;
+			for (auto &s : m->src)
+				if (this_score == -1 || this_score > coverdb.src_db.at(s))
+					this_score = coverdb.src_db.at(s);
+			m->cover_score = this_score;
+		}
+		return m->cover_score;
+	};
+
+	auto commit_mutation = [&](mutate_t *m) {
+		m->used = true;
+		coverdb.update(*m);
+		for (auto &s : m->src)
+			for (auto *p : src_index.at(s))
+				p->cover_score = -1;
+		new_database.push_back(*m);
+	};
+
 	vector<mutate_t*> cover_candidates;
 	int best_cover_score = -1;
 	bool skip_cover = false;
@@ -324,11 +355,7 @@ void database_reduce(std::vector<mutate_t> &database, const mutate_opts_t &opts,
 					for (auto &m : database) {
 						if (m.used || m.src.empty())
 							continue;
-						int this_score = -1;
-						for (auto &s : m.src) {
-							if (this_score == -1 || this_score > coverdb.src_db.at(s))
-								this_score = coverdb.src_db.at(s);
-						}
+						int this_score = cover_score(&m);
 						log_assert(this_score != -1);
 						if (best_cover_score == -1 || this_score < best_cover_score) {
 							cover_candidates.clear();
@@ -354,13 +381,7 @@ void database_reduce(std::vector<mutate_t> &database, const mutate_opts_t &opts,
 					if (p->used)
 						continue;
 
-					int this_score = -1;
-					for (auto &s : p->src) {
-						if (this_score == -1 || this_score > coverdb.src_db.at(s))
-							this_score = coverdb.src_db.at(s);
-					}
-
-					if (this_score != best_cover_score)
+					if (cover_score(p) != best_cover_score)
 						continue;
 
 					m = p;
@@ -368,9 +389,7 @@ void database_reduce(std::vector<mutate_t> &database, const mutate_opts_t &opts,
 				}
 
 				if (m != nullptr) {
-					m->used = true;
-					coverdb.update(*m);
-					new_database.push_back(*m);
+					commit_mutation(m);
 					break;
 				}
 			}
@@ -382,9 +401,7 @@ void database_reduce(std::vector<mutate_t> &database, const mutate_opts_t &opts,
     if (k < 0) {                                         \
       mutate_t *m = __queue.pick(rng, coverdb, opts);    \
       if (m != nullptr) {                                \
-        m->used = true;                                  \
-        coverdb.update(*m);                              \
-        new_database.push_back(*m);                      \
+        commit_mutation(m);                              \
       };                                                 \
       continue;                                          \
     }
@@ -306,21 +306,36 @@ QbfSolutionType qbf_solve(RTLIL::Module *mod, const QbfSolveOptions &opt) {
 
 		//If maximizing, grow until we get a failure.  Then bisect success and failure.
 		while (failure == 0 || difference(success, failure) > 1) {
-			Pass::call(design, "design -push-copy");
 			log_header(design, "Preparing QBF-SAT problem.\n");
 
+			// The iterated problems differ only in the threshold logic, so
+			// instead of copying the whole design before each solver call and
+			// restoring it afterwards, the threshold cells are added in place
+			// and removed again once the solver is done.
+			RTLIL::Wire *thresh_wire = nullptr;
+			RTLIL::Cell *thresh_cell = nullptr, *assume_cell = nullptr;
+
 			if (cur_thresh != 0) {
 				//Add thresholding logic (but not on the initial run when we don't have a sense of where to start):
-				RTLIL::SigSpec comparator = maximize? module->Ge(NEW_ID, module->wire(wire_to_optimize_name), RTLIL::Const(cur_thresh), false)
-				                                    : module->Le(NEW_ID, module->wire(wire_to_optimize_name), RTLIL::Const(cur_thresh), false);
+				thresh_wire = module->addWire(NEW_ID);
+				thresh_cell = maximize? module->addGe(NEW_ID, module->wire(wire_to_optimize_name), RTLIL::Const(cur_thresh), thresh_wire, false)
+				                      : module->addLe(NEW_ID, module->wire(wire_to_optimize_name), RTLIL::Const(cur_thresh), thresh_wire, false);
 
-				module->addAssume(wire_to_optimize_name.str() + "__threshold", comparator, RTLIL::Const(1, 1));
+				assume_cell = module->addAssume(wire_to_optimize_name.str() + "__threshold", thresh_wire, RTLIL::Const(1, 1));
 				log("Trying to solve with %s %s %d.\n", wire_to_optimize_name.c_str(), (maximize? ">=" : "<="), cur_thresh);
 			}
 
 			ret = call_qbf_solver(module, opt, tempdir_name, false, iter_num);
-			Pass::call(design, "design -pop");
-			module = design->module(module_name);
+
+			if (assume_cell != nullptr)
+				module->remove(assume_cell);
+			if (thresh_cell != nullptr)
+				module->remove(thresh_cell);
+			if (thresh_wire != nullptr) {
+				pool<RTLIL::Wire*> thresh_wires;
+				thresh_wires.insert(thresh_wire);
+				module->remove(thresh_wires);
+			}
 
 			if (!ret.unknown && ret.sat) {
 				Pass::call(design, "design -push-copy");
@@ -74,6 +74,52 @@ struct InvBit {
 typedef uint64_t equiv_cls_t;
 static const int sim_length = sizeof(equiv_cls_t) * 8;
 
+// Packed three-valued simulation word: bit t of 'value' is the signal value
+// under input pattern t, valid where the corresponding bit of 'defined' is
+// set. 'value' is kept normalised, i.e. always a subset of 'defined'.
+struct SimWord {
+    uint64_t value = 0, defined = 0;
+    uint64_t zeros() const { return ~value & defined; }
+};
+
+static SimWord word_not(SimWord a)
+{
+    return SimWord{a.zeros(), a.defined};
+}
+
+static SimWord word_and(SimWord a, SimWord b)
+{
+    SimWord y;
+    y.value = a.value & b.value;
+    y.defined = y.value | a.zeros() | b.zeros();
+    return y;
+}
+
+static SimWord word_or(SimWord a, SimWord b)
+{
+    SimWord y;
+    y.value = a.value | b.value;
+    y.defined = y.value | (a.zeros() & b.zeros());
+    return y;
+}
+
+static SimWord word_xor(SimWord a, SimWord b)
+{
+    SimWord y;
+    y.defined = a.defined & b.defined;
+    y.value = (a.value ^ b.value) & y.defined;
+    return y;
+}
+
+// Y = S ? B : A; also defined where S is undefined but A and B agree
+static SimWord word_mux(SimWord a, SimWord b, SimWord s)
+{
+    SimWord y;
+    y.value = (s.value & b.value) | (s.zeros() & a.value) | (a.value & b.value);
+    y.defined = y.value | (s.value & b.zeros()) | (s.zeros() & a.zeros()) | (a.zeros() & b.zeros());
+    return y;
+}
+
 struct RecoverModuleWorker {
     Design *design = nullptr;
     Module *mod, *flat = nullptr;
@@ -150,30 +196,234 @@ struct RecoverModuleWorker {
 
     // Mapping from bit to (candidate) equivalence classes
     dict<IdBit, equiv_cls_t> bit2cls;
-    void sim_cycle(int t, const dict<IdBit, RTLIL::State> &anchors)
+
+    // Packed simulation state; 'sim_forced' holds the anchor bits whose words
+    // must not be overwritten by their drivers
+    dict<SigBit, SimWord> sim_words;
+    pool<SigBit> sim_forced;
+
+    SimWord get_word(SigBit bit)
+    {
+        if (bit == State::S0)
+            return SimWord{0, ~uint64_t(0)};
+        if (bit == State::S1)
+            return SimWord{~uint64_t(0), ~uint64_t(0)};
+        if (!bit.wire)
+            return SimWord();
+        auto it = sim_words.find(bit);
+        return it == sim_words.end() ? SimWord() : it->second;
+    }
+
+    void set_word(SigBit bit, SimWord word)
+    {
+        if (bit.wire && !sim_forced.count(bit))
+            sim_words[bit] = word;
+    }
+
+    // Evaluate a cell over all patterns at once; returns false if the cell
+    // type isn't handled and the caller must fall back to sim_cell_eval()
+    bool sim_cell_fast(Cell *cell)
+    {
+        if (cell->type.in(ID($_BUF_), ID($_NOT_), ID($_AND_), ID($_NAND_), ID($_OR_), ID($_NOR_),
+                ID($_XOR_), ID($_XNOR_), ID($_ANDNOT_), ID($_ORNOT_), ID($_MUX_), ID($_NMUX_),
+                ID($_AOI3_), ID($_OAI3_), ID($_AOI4_), ID($_OAI4_)))
+        {
+            SimWord a = get_word((*sigmap)(cell->getPort(ID::A))[0]);
+            SimWord b = cell->hasPort(ID::B) ? get_word((*sigmap)(cell->getPort(ID::B))[0]) : SimWord();
+            SimWord c = cell->hasPort(ID::C) ? get_word((*sigmap)(cell->getPort(ID::C))[0]) : SimWord();
+            SimWord d = cell->hasPort(ID::D) ? get_word((*sigmap)(cell->getPort(ID::D))[0]) : SimWord();
+            SimWord s = cell->hasPort(ID::S) ? get_word((*sigmap)(cell->getPort(ID::S))[0]) : SimWord();
+            SimWord y;
+            if (cell->type == ID($_BUF_)) y = a;
+            else if (cell->type == ID($_NOT_)) y = word_not(a);
+            else if (cell->type == ID($_AND_)) y = word_and(a, b);
+            else if (cell->type == ID($_NAND_)) y = word_not(word_and(a, b));
+            else if (cell->type == ID($_OR_)) y = word_or(a, b);
+            else if (cell->type == ID($_NOR_)) y = word_not(word_or(a, b));
+            else if (cell->type == ID($_XOR_)) y = word_xor(a, b);
+            else if (cell->type == ID($_XNOR_)) y = word_not(word_xor(a, b));
+            else if (cell->type == ID($_ANDNOT_)) y = word_and(a, word_not(b));
+            else if (cell->type == ID($_ORNOT_)) y = word_or(a, word_not(b));
+            else if (cell->type == ID($_MUX_)) y = word_mux(a, b, s);
+            else if (cell->type == ID($_NMUX_)) y = word_not(word_mux(a, b, s));
+            else if (cell->type == ID($_AOI3_)) y = word_not(word_or(word_and(a, b), c));
+            else if (cell->type == ID($_OAI3_)) y = word_not(word_and(word_or(a, b), c));
+            else if (cell->type == ID($_AOI4_)) y = word_not(word_or(word_and(a, b), word_and(c, d)));
+            else y = word_not(word_and(word_or(a, b), word_or(c, d)));
+            set_word((*sigmap)(cell->getPort(ID::Y))[0], y);
+            return true;
+        }
+
+        if (cell->type == ID($lut))
+        {
+            SigSpec sig_a = (*sigmap)(cell->getPort(ID::A));
+            SigSpec sig_y = (*sigmap)(cell->getPort(ID::Y));
+            if (GetSize(sig_y) != 1 || GetSize(sig_a) > 16)
+                return false;
+            // Evaluate the LUT as a mux tree over the packed table entries
+            Const lut = cell->getParam(ID::LUT);
+            std::vector<SimWord> table(size_t(1) << GetSize(sig_a));
+            for (int i = 0; i < GetSize(table); i++) {
+                State bit = i < GetSize(lut) ? lut.bits[i] : State::S0;
+                if (bit == State::S0)
+                    table[i] = SimWord{0, ~uint64_t(0)};
+                else if (bit == State::S1)
+                    table[i] = SimWord{~uint64_t(0), ~uint64_t(0)};
+            }
+            for (int k = 0; k < GetSize(sig_a); k++) {
+                SimWord s = get_word(sig_a[k]);
+                for (int i = 0; i < GetSize(table); i += 2)
+                    table[i / 2] = word_mux(table[i], table[i + 1], s);
+                table.resize(table.size() / 2);
+            }
+            set_word(sig_y[0], table[0]);
+            return true;
+        }
+
+        // Simple bitwise word-level cells with matching widths
+        if (cell->type.in(ID($not), ID($pos), ID($and), ID($or), ID($xor), ID($xnor), ID($mux)))
+        {
+            SigSpec sig_a = (*sigmap)(cell->getPort(ID::A));
+            SigSpec sig_y = (*sigmap)(cell->getPort(ID::Y));
+            if (GetSize(sig_a) != GetSize(sig_y))
+                return false;
+            SigSpec sig_b;
+            if (cell->hasPort(ID::B)) {
+                sig_b = (*sigmap)(cell->getPort(ID::B));
+                if (GetSize(sig_b) != GetSize(sig_y))
+                    return false;
+            }
+            SimWord s;
+            if (cell->type == ID($mux))
+                s = get_word((*sigmap)(cell->getPort(ID::S))[0]);
+            for (int i = 0; i < GetSize(sig_y); i++) {
+                SimWord a = get_word(sig_a[i]);
+                SimWord b = cell->hasPort(ID::B) ? get_word(sig_b[i]) : SimWord();
+                SimWord y;
+                if (cell->type == ID($not)) y = word_not(a);
+                else if (cell->type == ID($pos)) y = a;
+                else if (cell->type == ID($and)) y = word_and(a, b);
+                else if (cell->type == ID($or)) y = word_or(a, b);
+                else if (cell->type == ID($xor)) y = word_xor(a, b);
+                else if (cell->type == ID($xnor)) y = word_not(word_xor(a, b));
+                else y = word_mux(a, b, s);
+                set_word(sig_y[i], y);
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    // Fallback for cell types without a packed model: run ConstEval once per
+    // pattern with the cell inputs pinned to the packed simulation values
+    void sim_cell_eval(Cell *cell)
+    {
+        if (!yosys_celltypes.cell_evaluable(cell->type))
+            return;
+        std::vector<std::pair<SigBit, SimWord>> inputs;
+        std::vector<SigBit> outputs;
+        for (auto conn : cell->connections()) {
+            if (cell->input(conn.first))
+                for (SigBit bit : (*sigmap)(conn.second))
+                    if (bit.wire)
+                        inputs.emplace_back(bit, get_word(bit));
+            if (cell->output(conn.first))
+                for (SigBit bit : (*sigmap)(conn.second))
+                    if (bit.wire)
+                        outputs.push_back(bit);
+        }
+        std::vector<SimWord> out_words(outputs.size());
+        for (int t = 0; t < sim_length; t++) {
+            ce->clear();
+            for (auto &in : inputs) {
+                State val = State::Sx;
+                if ((in.second.defined >> t) & 1)
+                    val = ((in.second.value >> t) & 1) ? State::S1 : State::S0;
+                ce->set(in.first, val);
+            }
+            for (int i = 0; i < GetSize(outputs); i++) {
+                SigSpec res(outputs[i]);
+                if (!ce->eval(res))
+                    continue;
+                if (res == State::S0)
+                    out_words[i].defined |= uint64_t(1) << t;
+                else if (res == State::S1) {
+                    out_words[i].value |= uint64_t(1) << t;
+                    out_words[i].defined |= uint64_t(1) << t;
+                }
+            }
+        }
+        for (int i = 0; i < GetSize(outputs); i++)
+            set_word(outputs[i], out_words[i]);
+    }
+
+    // Topological cell order for the packed simulation, cut at the forced
+    // anchor bits
+    std::vector<Cell*> sim_order()
     {
+        dict<SigBit, pool<IdString>> bit_drivers, bit_users;
+        TopoSort<IdString, RTLIL::sort_by_id_str> toposort;
+
+        for (auto cell : flat->cells())
+        {
+            for (auto conn : cell->connections())
+                for (auto bit : (*sigmap)(conn.second)) {
+                    if (!bit.wire || sim_forced.count(bit))
+                        continue;
+                    if (cell->input(conn.first))
+                        bit_users[bit].insert(cell->name);
+                    if (cell->output(conn.first))
+                        bit_drivers[bit].insert(cell->name);
+                }
+            toposort.node(cell->name);
+        }
+
+        for (auto &it : bit_users)
+            if (bit_drivers.count(it.first))
+                for (auto driver_cell : bit_drivers.at(it.first))
+                for (auto user_cell : it.second)
+                    toposort.edge(driver_cell, user_cell);
+
+        toposort.sort();
+        std::vector<Cell*> order;
+        for (auto cell_name : toposort.sorted)
+            order.push_back(flat->cell(cell_name));
+        return order;
+    }
+
+    // Run all 'sim_length' random patterns in one sweep over the netlist and
+    // fill in the candidate equivalence classes
+    void sim_run(const dict<IdBit, uint64_t> &anchors)
+    {
+        sim_words.clear();
+        sim_forced.clear();
+
         ce->clear();
-        for (auto anchor : anchors) {
+        for (auto &anchor : anchors) {
             SigBit bit = (*sigmap)(SigBit(flat->wire(anchor.first.name), anchor.first.bit));
             // Ignore in the rare case that it's already determined
             SigSpec res(bit);
             if (ce->eval(res))
                 continue;
-            ce->set(bit, anchor.second);
+            sim_words[bit] = SimWord{anchor.second, ~uint64_t(0)};
+            sim_forced.insert(bit);
         }
-        // Only evaluate IdBits that exist in the non-flat design; as they are all we care about
+
+        for (auto cell : sim_order())
+            if (!sim_cell_fast(cell))
+                sim_cell_eval(cell);
+
+        // Only collect IdBits that exist in the non-flat design; as they are all we care about
         for (auto idbit : flat2orig) {
             if (anchors.count(idbit.first))
                 continue;
             SigBit bit = (*sigmap)(SigBit(flat->wire(idbit.first.name), idbit.first.bit));
-            SigSpec res(bit);
-            if (!ce->eval(res))
-                continue;
-            if (res != State::S0 && res != State::S1)
+            if (!bit.wire)
                 continue;
-            // Update equivalence classes
-            if (res == State::S1)
-                bit2cls[idbit.first] = bit2cls[idbit.first] | (equiv_cls_t(1) << t);
+            equiv_cls_t cls = get_word(bit).value;
+            if (cls)
+                bit2cls[idbit.first] = cls;
         }
     }
 
@@ -581,17 +831,25 @@ struct RecoverNamesWorker {
                 gate_anchors[gate_bit] = gold_bit.first;
             }
         }
-        // Run a random-value combinational simulation to find candidate equivalence classes
-        dict<IdBit, RTLIL::State> gold_anchor_vals, gate_anchor_vals;
+        // Run a random-value combinational simulation to find candidate equivalence
+        // classes. All patterns are packed into one word per signal so the netlist
+        // is swept once instead of once per pattern.
+        dict<IdBit, uint64_t> gold_anchor_words, gate_anchor_words;
+        for (auto anchor : gold_anchors) {
+            gold_anchor_words[anchor.first] = 0;
+            gate_anchor_words[anchor.second] = 0;
+        }
         rng_init();
         for (int t = 0; t < sim_length; t++) {
             for (auto anchor : gold_anchors) {
-                gold_anchor_vals[anchor.first] = next_randbit();
-                gate_anchor_vals[anchor.second] = gold_anchor_vals[anchor.first];
+                if (next_randbit() == State::S1) {
+                    gold_anchor_words[anchor.first] |= equiv_cls_t(1) << t;
+                    gate_anchor_words[anchor.second] |= equiv_cls_t(1) << t;
+                }
             }
-            gold_worker.sim_cycle(t, gold_anchor_vals);
-            gate_worker.sim_cycle(t, gate_anchor_vals);
         }
+        gold_worker.sim_run(gold_anchor_words);
+        gate_worker.sim_run(gate_anchor_words);
         log_debug("%d candidate equiv classes in gold; %d in gate\n", GetSize(gold_worker.bit2cls), GetSize(gate_worker.bit2cls));
         // Group bits by equivalence classes together
         dict<equiv_cls_t, std::pair<pool<IdBit>, pool<InvBit>>> cls2bits;
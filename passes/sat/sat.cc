@@ -441,11 +441,18 @@ struct SatHelper
 			ez->assume(ez->NOT(satgen.signals_eq(state_signals, state_signals, i, timestep_to)));
 	}
 
+	// assumptions added to every solver call. used instead of ez->assume()
+	// for the per-call prove condition when the encoded problem is cached
+	// across invocations (see -cache-encoding), so the CNF stays reusable
+	std::vector<int> solve_assumptions;
+
 	bool solve(const std::vector<int> &assumptions)
 	{
 		log_assert(gotTimeout == false);
 		ez->setSolverTimeout(timeout);
-		bool success = ez->solve(modelExpressions, modelValues, assumptions);
+		std::vector<int> all_assumptions = assumptions;
+		all_assumptions.insert(all_assumptions.end(), solve_assumptions.begin(), solve_assumptions.end());
+		bool success = ez->solve(modelExpressions, modelValues, all_assumptions);
 		if (ez->getSolverTimoutStatus())
 			gotTimeout = true;
 		return success;
@@ -453,6 +460,13 @@ struct SatHelper
 
 	bool solve(int a = 0, int b = 0, int c = 0, int d = 0, int e = 0, int f = 0)
 	{
+		if (!solve_assumptions.empty()) {
+			std::vector<int> assumptions;
+			for (int lit : {a, b, c, d, e, f})
+				if (lit != 0)
+					assumptions.push_back(lit);
+			return solve(assumptions);
+		}
 		log_assert(gotTimeout == false);
 		ez->setSolverTimeout(timeout);
 		bool success = ez->solve(modelExpressions, modelValues, a, b, c, d, e, f);
@@ -481,6 +495,13 @@ struct SatHelper
 	std::vector<bool> modelValues;
 	std::set<ModelBlockInfo> modelInfo;
 
+	// State for incremental model generation (see generate_model()): the
+	// signal list the cached expressions were created for, the def/undef
+	// halves of modelExpressions, and the highest imported timestep.
+	RTLIL::SigSpec model_sig;
+	std::vector<int> modelDefExpressions, modelUndefExpressions;
+	int model_max_timestep = 0;
+
 	void maximize_undefs()
 	{
 		log_assert(enable_undef);
@@ -507,8 +528,6 @@ struct SatHelper
 	void generate_model()
 	{
 		RTLIL::SigSpec modelSig;
-		modelExpressions.clear();
-		modelInfo.clear();
 
 		// Add "show" signals or alternatively the leaves on the input cone on all set and prove signals
 
@@ -554,7 +573,18 @@ struct SatHelper
 		modelSig.sort_and_unify();
 		// log("Model signals: %s\n", log_signal(modelSig));
 
-		std::vector<int> modelUndefExpressions;
+		// In temporal induction mode this function is called again after each
+		// unrolling step. Re-importing the model for all timesteps on every
+		// call is quadratic in the induction length, so as long as the signal
+		// list is unchanged only the newly added timesteps are imported and
+		// the cached expressions are kept for the already handled frames.
+		if (modelSig != model_sig || max_timestep <= 0 || max_timestep < model_max_timestep) {
+			model_sig = modelSig;
+			model_max_timestep = 0;
+			modelDefExpressions.clear();
+			modelUndefExpressions.clear();
+			modelInfo.clear();
+		}
 
 		for (auto &c : modelSig.chunks())
 			if (c.wire != NULL)
@@ -569,12 +599,15 @@ struct SatHelper
 					if ((timestep == -1 && max_timestep > 0) || timestep == 0)
 						continue;
 
+					if (timestep != -1 && timestep <= model_max_timestep)
+						continue;
+
 					info.timestep = timestep;
-					info.offset = modelExpressions.size();
+					info.offset = modelDefExpressions.size();
 					modelInfo.insert(info);
 
 					std::vector<int> vec = satgen.importSigSpec(chunksig, timestep);
-					modelExpressions.insert(modelExpressions.end(), vec.begin(), vec.end());
+					modelDefExpressions.insert(modelDefExpressions.end(), vec.begin(), vec.end());
 
 					if (enable_undef) {
 						std::vector<int> undef_vec = satgen.importUndefSigSpec(chunksig, timestep);
@@ -583,30 +616,38 @@ struct SatHelper
 				}
 			}
 
-		// Add initial state signals as collected by satgen
+		// Add initial state signals as collected by satgen (all initial state
+		// bits are created when timestep 1 is imported, so on incremental
+		// calls the cached expressions are already complete)
 		//
-		modelSig = satgen.initial_state.export_all();
-		for (auto &c : modelSig.chunks())
-			if (c.wire != NULL)
-			{
-				ModelBlockInfo info;
-				RTLIL::SigSpec chunksig = c;
+		if (model_max_timestep == 0) {
+			modelSig = satgen.initial_state.export_all();
+			for (auto &c : modelSig.chunks())
+				if (c.wire != NULL)
+				{
+					ModelBlockInfo info;
+					RTLIL::SigSpec chunksig = c;
 
-				info.timestep = 0;
-				info.offset = modelExpressions.size();
-				info.width = chunksig.size();
-				info.description = log_signal(chunksig);
-				modelInfo.insert(info);
+					info.timestep = 0;
+					info.offset = modelDefExpressions.size();
+					info.width = chunksig.size();
+					info.description = log_signal(chunksig);
+					modelInfo.insert(info);
 
-				std::vector<int> vec = satgen.importSigSpec(chunksig, 1);
-				modelExpressions.insert(modelExpressions.end(), vec.begin(), vec.end());
+					std::vector<int> vec = satgen.importSigSpec(chunksig, 1);
+					modelDefExpressions.insert(modelDefExpressions.end(), vec.begin(), vec.end());
 
-				if (enable_undef) {
-					std::vector<int> undef_vec = satgen.importUndefSigSpec(chunksig, 1);
-					modelUndefExpressions.insert(modelUndefExpressions.end(), undef_vec.begin(), undef_vec.end());
+					if (enable_undef) {
+						std::vector<int> undef_vec = satgen.importUndefSigSpec(chunksig, 1);
+						modelUndefExpressions.insert(modelUndefExpressions.end(), undef_vec.begin(), undef_vec.end());
+					}
 				}
-			}
+		}
+
+		if (max_timestep > model_max_timestep)
+			model_max_timestep = max_timestep;
 
+		modelExpressions = modelDefExpressions;
 		modelExpressions.insert(modelExpressions.end(), modelUndefExpressions.begin(), modelUndefExpressions.end());
 	}
 
@@ -862,6 +903,11 @@ struct SatHelper
 	}
 };
 
+// Encoded problems kept alive by `sat -cache-encoding', keyed on the module
+// and all options that influence the encoding (but not the prove arguments,
+// which are applied as solver assumptions on reuse).
+std::map<std::string, std::unique_ptr<SatHelper>> encoding_cache;
+
 void print_proof_failed()
 {
 	log("\n");
@@ -1004,6 +1050,18 @@ struct SatPass : public Pass {
 		log("        dump CNF of SAT problem (in DIMACS format). in temporal induction\n");
 		log("        proofs this is the CNF of the first induction step.\n");
 		log("\n");
+		log("    -cache-encoding\n");
+		log("        keep the encoded SAT problem (CNF and variable map) in memory after\n");
+		log("        the command finishes and reuse it in later `sat' commands in the same\n");
+		log("        yosys process that use the same module and the same encoding options.\n");
+		log("        this is intended for parameter sweeps that only vary the -prove\n");
+		log("        arguments: the prove condition is applied as a solver assumption\n");
+		log("        instead of being added to the CNF. an encoding is not returned to\n");
+		log("        the cache after a -max/-all run (which permanently constrains the\n");
+		log("        problem), and without -show the printed model may include signals\n");
+		log("        imported by earlier cached invocations. not supported in temporal\n");
+		log("        induction mode.\n");
+		log("\n");
 		log("The following additional options can be used to set up a proof. If also -seq\n");
 		log("is passed, a temporal induction proof is performed.\n");
 		log("\n");
@@ -1086,6 +1144,7 @@ struct SatPass : public Pass {
 		bool ignore_unknown_cells = false, falsify = false, tempinduct_def = false, set_init_def = false;
 		bool tempinduct_baseonly = false, tempinduct_inductonly = false, set_assumes = false;
 		int tempinduct_skip = 0, stepsize = 1;
+		bool cache_encoding = false;
 		std::string vcd_file_name, json_file_name, cnf_file_name;
 
 		log_header(design, "Executing SAT pass (solving SAT problems in the circuit).\n");
@@ -1325,6 +1384,10 @@ struct SatPass : public Pass {
 				cnf_file_name = args[++argidx];
 				continue;
 			}
+			if (args[argidx] == "-cache-encoding") {
+				cache_encoding = true;
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
@@ -1347,6 +1410,9 @@ struct SatPass : public Pass {
 		if (prove_skip >= seq_len && prove_skip > 0)
 			log_cmd_error("The value of -prove-skip must be smaller than the one of -seq.\n");
 
+		if (cache_encoding && tempinduct)
+			log_cmd_error("Option -cache-encoding is not supported in temporal induction mode.\n");
+
 		if (set_init_undef + set_init_zero + set_init_def > 1)
 			log_cmd_error("The options -set-init-undef, -set-init-def, and -set-init-zero are exclusive!\n");
 
@@ -1586,44 +1652,119 @@ struct SatPass : public Pass {
 			if (maxsteps > 0)
 				log_cmd_error("The options -maxsteps is only supported for temporal induction proofs!\n");
 
-			SatHelper sathelper(design, module, enable_undef, set_def_formal);
-
-			sathelper.sets = sets;
-			sathelper.set_assumes = set_assumes;
-			sathelper.prove = prove;
-			sathelper.prove_x = prove_x;
-			sathelper.prove_asserts = prove_asserts;
-			sathelper.sets_at = sets_at;
-			sathelper.unsets_at = unsets_at;
-			sathelper.shows = shows;
-			sathelper.timeout = timeout;
-			sathelper.sets_def = sets_def;
-			sathelper.sets_any_undef = sets_any_undef;
-			sathelper.sets_all_undef = sets_all_undef;
-			sathelper.sets_def_at = sets_def_at;
-			sathelper.sets_any_undef_at = sets_any_undef_at;
-			sathelper.sets_all_undef_at = sets_all_undef_at;
-			sathelper.sets_init = sets_init;
-			sathelper.set_init_def = set_init_def;
-			sathelper.set_init_undef = set_init_undef;
-			sathelper.set_init_zero = set_init_zero;
-			sathelper.satgen.ignore_div_by_zero = ignore_div_by_zero;
-			sathelper.ignore_unknown_cells = ignore_unknown_cells;
-
-			if (seq_len == 0) {
-				sathelper.setup();
-				if (sathelper.prove.size() || sathelper.prove_x.size() || sathelper.prove_asserts)
-					sathelper.ez->assume(sathelper.ez->NOT(sathelper.setup_proof()));
-			} else {
-				std::vector<int> prove_bits;
-				for (int timestep = 1; timestep <= seq_len; timestep++) {
-					sathelper.setup(timestep, timestep == 1);
-					if (sathelper.prove.size() || sathelper.prove_x.size() || sathelper.prove_asserts)
+			// With -cache-encoding the encoded problem is looked up in (and
+			// later returned to) a process-wide cache. The key covers the
+			// module and everything that went into the encoding, but not the
+			// prove arguments: those are applied as solver assumptions so
+			// that sweeps varying only -prove can reuse the CNF.
+			std::string encoding_key;
+			std::unique_ptr<SatHelper> cached_sathelper;
+			bool reused_encoding = false;
+
+			if (cache_encoding)
+			{
+				std::stringstream key;
+				key << (void*)module << " " << module->name.str() << " " << module->change_count() << "\n";
+				key << enable_undef << set_def_formal << set_assumes << set_init_def << set_init_undef <<
+						set_init_zero << ignore_div_by_zero << ignore_unknown_cells << " " << seq_len << "\n";
+				auto add_strings = [&](const char *tag, const std::vector<std::string> &list) {
+					for (auto &s : list)
+						key << tag << " " << s << "\n";
+				};
+				auto add_pairs = [&](const char *tag, const std::vector<std::pair<std::string, std::string>> &list) {
+					for (auto &it : list)
+						key << tag << " " << it.first << " " << it.second << "\n";
+				};
+				add_pairs("set", sets);
+				add_pairs("set-init", sets_init);
+				add_strings("set-def", sets_def);
+				add_strings("set-any-undef", sets_any_undef);
+				add_strings("set-all-undef", sets_all_undef);
+				add_strings("show", shows);
+				for (auto &it : sets_at)
+					add_pairs(stringf("set-at %d", it.first).c_str(), it.second);
+				for (auto &it : unsets_at)
+					add_strings(stringf("unset-at %d", it.first).c_str(), it.second);
+				for (auto &it : sets_def_at)
+					add_strings(stringf("set-def-at %d", it.first).c_str(), it.second);
+				for (auto &it : sets_any_undef_at)
+					add_strings(stringf("set-any-undef-at %d", it.first).c_str(), it.second);
+				for (auto &it : sets_all_undef_at)
+					add_strings(stringf("set-all-undef-at %d", it.first).c_str(), it.second);
+				encoding_key = key.str();
+
+				auto cache_it = encoding_cache.find(encoding_key);
+				if (cache_it != encoding_cache.end()) {
+					cached_sathelper = std::move(cache_it->second);
+					encoding_cache.erase(cache_it);
+					reused_encoding = true;
+				}
+			}
+
+			if (!cached_sathelper)
+				cached_sathelper.reset(new SatHelper(design, module, enable_undef, set_def_formal));
+
+			SatHelper &sathelper = *cached_sathelper;
+
+			if (reused_encoding)
+			{
+				log("Reusing cached SAT encoding with %d variables and %d clauses.\n",
+						sathelper.ez->numCnfVariables(), sathelper.ez->numCnfClauses());
+				sathelper.prove = prove;
+				sathelper.prove_x = prove_x;
+				sathelper.prove_asserts = prove_asserts;
+				sathelper.timeout = timeout;
+				sathelper.gotTimeout = false;
+				sathelper.solve_assumptions.clear();
+			}
+			else
+			{
+				sathelper.sets = sets;
+				sathelper.set_assumes = set_assumes;
+				sathelper.prove = prove;
+				sathelper.prove_x = prove_x;
+				sathelper.prove_asserts = prove_asserts;
+				sathelper.sets_at = sets_at;
+				sathelper.unsets_at = unsets_at;
+				sathelper.shows = shows;
+				sathelper.timeout = timeout;
+				sathelper.sets_def = sets_def;
+				sathelper.sets_any_undef = sets_any_undef;
+				sathelper.sets_all_undef = sets_all_undef;
+				sathelper.sets_def_at = sets_def_at;
+				sathelper.sets_any_undef_at = sets_any_undef_at;
+				sathelper.sets_all_undef_at = sets_all_undef_at;
+				sathelper.sets_init = sets_init;
+				sathelper.set_init_def = set_init_def;
+				sathelper.set_init_undef = set_init_undef;
+				sathelper.set_init_zero = set_init_zero;
+				sathelper.satgen.ignore_div_by_zero = ignore_div_by_zero;
+				sathelper.ignore_unknown_cells = ignore_unknown_cells;
+
+				if (seq_len == 0) {
+					sathelper.setup();
+				} else {
+					for (int timestep = 1; timestep <= seq_len; timestep++)
+						sathelper.setup(timestep, timestep == 1);
+				}
+			}
+
+			if (sathelper.prove.size() || sathelper.prove_x.size() || sathelper.prove_asserts)
+			{
+				int proof;
+				if (seq_len == 0) {
+					proof = sathelper.setup_proof();
+				} else {
+					std::vector<int> prove_bits;
+					for (int timestep = 1; timestep <= seq_len; timestep++)
 						if (timestep > prove_skip)
 							prove_bits.push_back(sathelper.setup_proof(timestep));
+					proof = sathelper.ez->expression(ezSAT::OpAnd, prove_bits);
 				}
-				if (sathelper.prove.size() || sathelper.prove_x.size() || sathelper.prove_asserts)
-					sathelper.ez->assume(sathelper.ez->NOT(sathelper.ez->expression(ezSAT::OpAnd, prove_bits)));
+				if (cache_encoding)
+					sathelper.solve_assumptions.push_back(sathelper.ez->NOT(proof));
+				else
+					sathelper.ez->assume(sathelper.ez->NOT(proof));
 			}
 			sathelper.generate_model();
 
@@ -1720,6 +1861,11 @@ struct SatPass : public Pass {
 					log_error("Called with -verify and proof did fail!\n");
 				}
 			}
+
+			// -max/-all runs add permanent blocking clauses, so the encoding
+			// is only returned to the cache if the model was never invalidated
+			if (cache_encoding && rerun_counter == 0)
+				encoding_cache[encoding_key] = std::move(cached_sathelper);
 		}
 
 		if (0) {
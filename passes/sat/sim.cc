@@ -125,6 +125,7 @@ struct SimShared
 	bool serious_asserts = false;
 	bool fst_noinit = false;
 	bool initstate = true;
+	bool compile = false;
 };
 
 void zinit(State &v)
@@ -218,6 +219,23 @@ struct SimInstance
 	dict<Cell*, IdString> mem_cells;
 	std::vector<print_state_t> print_database;
 
+	// -compile: combinational cells lowered into a table with pre-resolved
+	// port connectivity and a precomputed topological schedule, so each delta
+	// wave evaluates every affected cell at most once in a single sweep
+	// instead of iterating the event queue to a fixpoint
+	struct compiled_cell_t
+	{
+		Cell *cell;
+		int eval_form;
+		SigSpec sig_a, sig_b, sig_c, sig_s, sig_y;
+	};
+
+	std::vector<compiled_cell_t> compiled_cells;
+	dict<Cell*, int> compiled_cell_map;
+	std::vector<bool> compiled_pending;
+	int compiled_pending_count = 0;
+	bool compiled_built = false;
+
 	std::vector<Mem> memories;
 
 	dict<Wire*, pair<int, Const>> signal_database;
@@ -453,6 +471,35 @@ struct SimInstance
 		return did_something;
 	}
 
+	// get_state/set_state for signals that are already sigmapped, used by the
+	// compiled evaluator to skip the per-bit sigmap lookups on the hot path
+	Const get_state_mapped(const SigSpec &sig)
+	{
+		Const value;
+		value.bits.reserve(GetSize(sig));
+
+		for (auto &bit : sig)
+			if (bit.wire == nullptr)
+				value.bits.push_back(bit.data);
+			else if (state_nets.count(bit))
+				value.bits.push_back(state_nets.at(bit));
+			else
+				value.bits.push_back(State::Sz);
+
+		return value;
+	}
+
+	void set_state_mapped(const SigSpec &sig, const Const &value)
+	{
+		log_assert(GetSize(sig) <= GetSize(value));
+
+		for (int i = 0; i < GetSize(sig); i++)
+			if (value[i] != State::Sa && state_nets.at(sig[i]) != value[i]) {
+				state_nets.at(sig[i]) = value[i];
+				dirty_bits.insert(sig[i]);
+			}
+	}
+
 	void set_state_parent_drivers(SigSpec sig, Const value)
 	{
 		sigmap.apply(sig);
@@ -615,6 +662,116 @@ struct SimInstance
 		}
 	}
 
+	void build_compiled()
+	{
+		compiled_built = true;
+
+		dict<Cell*, compiled_cell_t> candidates;
+
+		for (auto cell : module->cells())
+		{
+			if (ff_database.count(cell) || formal_database.count(cell) || mem_cells.count(cell) || children.count(cell))
+				continue;
+
+			if (!yosys_celltypes.cell_evaluable(cell->type))
+				continue;
+
+			bool has_a = cell->hasPort(ID::A);
+			bool has_b = cell->hasPort(ID::B);
+			bool has_c = cell->hasPort(ID::C);
+			bool has_d = cell->hasPort(ID::D);
+			bool has_s = cell->hasPort(ID::S);
+			bool has_y = cell->hasPort(ID::Y);
+
+			compiled_cell_t cc;
+			cc.cell = cell;
+
+			if (has_a && !has_c && !has_d && !has_s && has_y)
+				cc.eval_form = 0;
+			else if (has_a && has_b && has_c && !has_d && !has_s && has_y)
+				cc.eval_form = 1;
+			else if (has_a && !has_b && !has_c && !has_d && has_s && has_y)
+				cc.eval_form = 2;
+			else if (has_a && has_b && !has_c && !has_d && has_s && has_y)
+				cc.eval_form = 3;
+			else
+				continue;
+
+			if (has_a) cc.sig_a = sigmap(cell->getPort(ID::A));
+			if (has_b) cc.sig_b = sigmap(cell->getPort(ID::B));
+			if (has_c) cc.sig_c = sigmap(cell->getPort(ID::C));
+			if (has_s) cc.sig_s = sigmap(cell->getPort(ID::S));
+			cc.sig_y = sigmap(cell->getPort(ID::Y));
+
+			candidates.emplace(cell, std::move(cc));
+		}
+
+		// topological sort over the cell-to-cell dependencies. cells on
+		// combinational cycles stay out of the schedule and keep going through
+		// the event-driven interpreter, which handles them like before.
+		dict<SigBit, Cell*> driver;
+		for (auto &it : candidates)
+			for (auto &bit : it.second.sig_y)
+				if (bit.wire != nullptr)
+					driver[bit] = it.first;
+
+		dict<Cell*, pool<Cell*>> consumers;
+		dict<Cell*, int> indegree;
+
+		for (auto &it : candidates) {
+			indegree[it.first];
+			for (auto sig : {&it.second.sig_a, &it.second.sig_b, &it.second.sig_c, &it.second.sig_s})
+				for (auto &bit : *sig) {
+					auto found = driver.find(bit);
+					if (found != driver.end() && found->second != it.first)
+						if (consumers[found->second].insert(it.first).second)
+							indegree[it.first]++;
+				}
+		}
+
+		std::vector<Cell*> order;
+		order.reserve(candidates.size());
+
+		for (auto cell : module->cells())
+			if (candidates.count(cell) && indegree.at(cell) == 0)
+				order.push_back(cell);
+
+		for (size_t i = 0; i < order.size(); i++)
+			if (consumers.count(order[i]))
+				for (auto cell : consumers.at(order[i]))
+					if (--indegree.at(cell) == 0)
+						order.push_back(cell);
+
+		compiled_cells.reserve(order.size());
+		for (auto cell : order) {
+			compiled_cell_map[cell] = GetSize(compiled_cells);
+			compiled_cells.push_back(std::move(candidates.at(cell)));
+		}
+		compiled_pending.resize(compiled_cells.size(), false);
+
+		for (auto child : children)
+			child.second->build_compiled();
+	}
+
+	void eval_compiled_cell(compiled_cell_t &cc)
+	{
+		switch (cc.eval_form)
+		{
+		case 0: // (A -> Y) and (A,B -> Y) cells
+			set_state_mapped(cc.sig_y, CellTypes::eval(cc.cell, get_state_mapped(cc.sig_a), get_state_mapped(cc.sig_b)));
+			break;
+		case 1: // (A,B,C -> Y) cells
+			set_state_mapped(cc.sig_y, CellTypes::eval(cc.cell, get_state_mapped(cc.sig_a), get_state_mapped(cc.sig_b), get_state_mapped(cc.sig_c)));
+			break;
+		case 2: // (A,S -> Y) cells
+			set_state_mapped(cc.sig_y, CellTypes::eval(cc.cell, get_state_mapped(cc.sig_a), get_state_mapped(cc.sig_s)));
+			break;
+		case 3: // (A,B,S -> Y) cells
+			set_state_mapped(cc.sig_y, CellTypes::eval(cc.cell, get_state_mapped(cc.sig_a), get_state_mapped(cc.sig_b), get_state_mapped(cc.sig_s)));
+			break;
+		}
+	}
+
 	void update_ph1()
 	{
 		pool<Cell*> queue_cells;
@@ -622,13 +779,23 @@ struct SimInstance
 
 		queue_cells.swap(dirty_cells);
 
-		while (1)
-		{
+		if (shared->compile && !compiled_built)
+			build_compiled();
+
+		auto drain_dirty_bits = [&]() {
 			for (auto bit : dirty_bits)
 			{
 				if (upd_cells.count(bit))
-					for (auto cell : upd_cells.at(bit))
-						queue_cells.insert(cell);
+					for (auto cell : upd_cells.at(bit)) {
+						auto it = compiled_cell_map.find(cell);
+						if (it != compiled_cell_map.end()) {
+							if (!compiled_pending[it->second]) {
+								compiled_pending[it->second] = true;
+								compiled_pending_count++;
+							}
+						} else
+							queue_cells.insert(cell);
+					}
 
 				if (upd_outports.count(bit) && parent != nullptr)
 					for (auto wire : upd_outports.at(bit))
@@ -636,6 +803,26 @@ struct SimInstance
 			}
 
 			dirty_bits.clear();
+		};
+
+		while (1)
+		{
+			drain_dirty_bits();
+
+			// sweep the compiled cells in schedule order, marking downstream
+			// cells as their inputs change, so that each cell is evaluated at
+			// most once per wave
+			while (compiled_pending_count > 0)
+			{
+				for (int i = 0; i < GetSize(compiled_cells) && compiled_pending_count > 0; i++)
+					if (compiled_pending[i]) {
+						compiled_pending[i] = false;
+						compiled_pending_count--;
+						eval_compiled_cell(compiled_cells[i]);
+						if (!dirty_bits.empty())
+							drain_dirty_bits();
+					}
+			}
 
 			if (!queue_cells.empty())
 			{
@@ -1308,7 +1495,7 @@ struct SimWorker : SimShared
 	{
 		std::map<int,Const> data;
 		top->register_output_step_values(&data);
-		output_data.emplace_back(t, data);
+		output_data.emplace_back(t, std::move(data));
 	}
 
 	void write_output_files()
@@ -2373,23 +2560,26 @@ struct VCDWriter : public OutputWriter
 
 		vcdfile << stringf("$enddefinitions $end\n");
 
+		std::string buffer;
 		for(auto& d : worker->output_data)
 		{
 			vcdfile << stringf("#%d\n", d.first);
 			for (auto &data : d.second)
 			{
 				if (!use_signal.at(data.first)) continue;
-				Const value = data.second;
-				vcdfile << "b";
+				const Const &value = data.second;
+				buffer.clear();
+				buffer += 'b';
 				for (int i = GetSize(value)-1; i >= 0; i--) {
 					switch (value[i]) {
-						case State::S0: vcdfile << "0"; break;
-						case State::S1: vcdfile << "1"; break;
-						case State::Sx: vcdfile << "x"; break;
-						default: vcdfile << "z";
+						case State::S0: buffer += '0'; break;
+						case State::S1: buffer += '1'; break;
+						case State::Sx: buffer += 'x'; break;
+						default: buffer += 'z';
 					}
 				}
-				vcdfile << stringf(" n%d\n", data.first);
+				buffer += stringf(" n%d\n", data.first);
+				vcdfile << buffer;
 			}
 		}
 	}
@@ -2401,6 +2591,11 @@ struct FSTWriter : public OutputWriter
 {
 	FSTWriter(SimWorker *worker, std::string filename) : OutputWriter(worker) {
 		fstfile = (struct fstContext *)fstWriterCreate(filename.c_str(),1);
+#ifdef FST_WRITER_PARALLEL
+		// hand completed value-change blocks to a background compression
+		// thread instead of packing them inline while emitting
+		fstWriterSetParallelMode(fstfile, 1);
+#endif
 	}
 
 	virtual ~FSTWriter()
@@ -2435,23 +2630,24 @@ struct FSTWriter : public OutputWriter
 			}
 		);
 
+		std::string buffer;
 		for(auto& d : worker->output_data)
 		{
 			fstWriterEmitTimeChange(fstfile, d.first);
 			for (auto &data : d.second)
 			{
 				if (!use_signal.at(data.first)) continue;
-				Const value = data.second;
-				std::stringstream ss;
+				const Const &value = data.second;
+				buffer.clear();
 				for (int i = GetSize(value)-1; i >= 0; i--) {
 					switch (value[i]) {
-						case State::S0: ss << "0"; break;
-						case State::S1: ss << "1"; break;
-						case State::Sx: ss << "x"; break;
-						default: ss << "z";
+						case State::S0: buffer += '0'; break;
+						case State::S1: buffer += '1'; break;
+						case State::Sx: buffer += 'x'; break;
+						default: buffer += 'z';
 					}
 				}
-				fstWriterEmitValueChange(fstfile, mapping[data.first], ss.str().c_str());
+				fstWriterEmitValueChange(fstfile, mapping[data.first], buffer.c_str());
 			}
 		}
 	}
@@ -2632,6 +2828,11 @@ struct SimPass : public Pass {
 		log("    -zinit\n");
 		log("        zero-initialize all uninitialized regs and memories\n");
 		log("\n");
+		log("    -compile\n");
+		log("        lower the combinational logic into a table-driven evaluator with a\n");
+		log("        precomputed topological schedule instead of interpreting it through\n");
+		log("        the event queue. This speeds up simulation of large designs.\n");
+		log("\n");
 		log("    -timescale <string>\n");
 		log("        include the specified timescale declaration in the vcd\n");
 		log("\n");
@@ -2793,6 +2994,10 @@ struct SimPass : public Pass {
 				worker.zinit = true;
 				continue;
 			}
+			if (args[argidx] == "-compile") {
+				worker.compile = true;
+				continue;
+			}
 			if (args[argidx] == "-r" && argidx+1 < args.size()) {
 				std::string sim_filename = args[++argidx];
 				rewrite_filename(sim_filename);
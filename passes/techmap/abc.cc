@@ -56,6 +56,8 @@
 #include <sstream>
 #include <climits>
 #include <vector>
+#include <thread>
+#include <atomic>
 
 #ifndef _WIN32
 #  include <unistd.h>
@@ -129,6 +131,13 @@ dict<int, std::string> pi_map, po_map;
 
 int undef_bits_lost;
 
+// All abc_module() calls of one pass execution share a single temp directory
+// (unless -nocleanup is used), so that designs with many modules or clock
+// domains do not pay the directory and library file setup cost once per ABC
+// call.  The directory is removed at the end of AbcPass::execute().
+std::string shared_tempdir_name;
+bool shared_tempdir_libfiles_written;
+
 int map_signal(RTLIL::SigBit bit, gate_type_t gate_type = G(NONE), int in1 = -1, int in2 = -1, int in3 = -1, int in4 = -1)
 {
 	assign_map.apply(bit);
@@ -703,11 +712,759 @@ struct abc_output_filter
 	}
 };
 
+
+// State of one ABC invocation.  abc_module() extracts the netlist, writes the
+// input files and queues a job; abc_run_job() then runs the ABC process (for
+// queued jobs possibly several at a time, see the -j option), and
+// abc_reintegrate_job() merges the results back in queue order.
+struct abc_job
+{
+	RTLIL::Module *module;
+	int map_autoidx;
+	std::vector<gate_t> signal_list;
+	dict<int, std::string> pi_map, po_map;
+	bool clk_polarity, en_polarity, arst_polarity, srst_polarity;
+	RTLIL::SigSpec clk_sig, en_sig, arst_sig, srst_sig;
+	bool had_init;
+	std::string tempdir_name, exe_file, command;
+	bool show_tempdir, builtin_lib, sop_mode;
+	std::vector<std::string> output_lines;
+	int ret = -1;
+};
+
+// Runs the ABC process of a job.  This function must not touch any shared
+// state or call log(): queued jobs run it concurrently.  The ABC output is
+// collected in the job and printed by abc_reintegrate_job().
+void abc_run_job(abc_job &job)
+{
+#ifndef YOSYS_LINK_ABC
+	job.ret = run_command(job.command, [&job](const std::string &line) { job.output_lines.push_back(line); });
+#else
+	string temp_stdouterr_name = stringf("%s/stdouterr.txt", job.tempdir_name.c_str());
+	FILE *temp_stdouterr_w = fopen(temp_stdouterr_name.c_str(), "w");
+	if (temp_stdouterr_w == NULL)
+		log_error("ABC: cannot open a temporary file for output redirection");
+	fflush(stdout);
+	fflush(stderr);
+	FILE *old_stdout = fopen(temp_stdouterr_name.c_str(), "r"); // need any fd for renumbering
+	FILE *old_stderr = fopen(temp_stdouterr_name.c_str(), "r"); // need any fd for renumbering
+#if defined(__wasm)
+#define fd_renumber(from, to) (void)__wasi_fd_renumber(from, to)
+#else
+#define fd_renumber(from, to) dup2(from, to)
+#endif
+	fd_renumber(fileno(stdout), fileno(old_stdout));
+	fd_renumber(fileno(stderr), fileno(old_stderr));
+	fd_renumber(fileno(temp_stdouterr_w), fileno(stdout));
+	fd_renumber(fileno(temp_stdouterr_w), fileno(stderr));
+	fclose(temp_stdouterr_w);
+	// These needs to be mutable, supposedly due to getopt
+	char *abc_argv[5];
+	string tmp_script_name = stringf("%s/abc.script", job.tempdir_name.c_str());
+	abc_argv[0] = strdup(job.exe_file.c_str());
+	abc_argv[1] = strdup("-s");
+	abc_argv[2] = strdup("-f");
+	abc_argv[3] = strdup(tmp_script_name.c_str());
+	abc_argv[4] = 0;
+	job.ret = abc::Abc_RealMain(4, abc_argv);
+	free(abc_argv[0]);
+	free(abc_argv[1]);
+	free(abc_argv[2]);
+	free(abc_argv[3]);
+	fflush(stdout);
+	fflush(stderr);
+	fd_renumber(fileno(old_stdout), fileno(stdout));
+	fd_renumber(fileno(old_stderr), fileno(stderr));
+	fclose(old_stdout);
+	fclose(old_stderr);
+	std::ifstream temp_stdouterr_r(temp_stdouterr_name);
+	for (std::string line; std::getline(temp_stdouterr_r, line); )
+		job.output_lines.push_back(line + "\n");
+	temp_stdouterr_r.close();
+#endif
+}
+
+// Fast reader for the BLIF netlist that ABC writes back.  ABC emits a
+// restricted, machine generated subset of BLIF: a single .model with
+// .inputs/.outputs lists, .gate/.subckt and .latch lines, and .names truth
+// tables in lut mode.  Instead of going through the generic read_blif
+// frontend line by line, the whole file is split into lines once, the
+// per-cell records are tokenized and the .names tables evaluated in parallel
+// chunks on the worker pool, and only the final installation of wires and
+// cells runs single-threaded on the calling thread (RTLIL construction is
+// not thread-safe).  Anything outside the expected subset makes the parse
+// bail out before the design is touched, and the caller falls back to
+// parse_blif().
+
+static char *abc_blif_token(char *&p)
+{
+	p += strspn(p, " \t");
+	if (*p == 0)
+		return nullptr;
+	char *tok = p;
+	p += strcspn(p, " \t");
+	if (*p != 0)
+		*p++ = 0;
+	return tok;
+}
+
+struct abc_blif_record
+{
+	enum Type { GATE, LATCH, NAMES } type;
+	char *args;                // directive line after the command word
+	std::vector<char*> cubes;  // table lines following a .names
+
+	// filled in by the parallel tokenize phase
+	bool ok = true;
+	char *celltype = nullptr;
+	std::vector<std::pair<char*, char*>> conns; // (port, net) of a .gate
+	char *latch_d = nullptr, *latch_q = nullptr, *latch_edge = nullptr;
+	char *latch_clock = nullptr, *latch_init = nullptr;
+	std::vector<char*> nets;            // .names inputs followed by output
+	std::vector<RTLIL::State> lut_table;
+	RTLIL::State const_state = RTLIL::State::Sx; // .names without inputs
+
+	abc_blif_record(Type type, char *args) : type(type), args(args) { }
+};
+
+static void abc_tokenize_record(abc_blif_record &rec)
+{
+	char *p = rec.args, *t;
+
+	if (rec.type == abc_blif_record::GATE)
+	{
+		rec.celltype = abc_blif_token(p);
+		if (rec.celltype == nullptr) {
+			rec.ok = false;
+			return;
+		}
+		while ((t = abc_blif_token(p)) != nullptr) {
+			char *q = strchr(t, '=');
+			if (q == nullptr) {
+				rec.ok = false;
+				return;
+			}
+			*(q++) = 0;
+			rec.conns.push_back(std::make_pair(t, q));
+		}
+		return;
+	}
+
+	if (rec.type == abc_blif_record::LATCH)
+	{
+		rec.latch_d = abc_blif_token(p);
+		rec.latch_q = abc_blif_token(p);
+		rec.latch_edge = abc_blif_token(p);
+		rec.latch_clock = abc_blif_token(p);
+		rec.latch_init = abc_blif_token(p);
+		if (rec.latch_q == nullptr)
+			rec.ok = false;
+		if (rec.latch_clock == nullptr && rec.latch_edge != nullptr) {
+			rec.latch_init = rec.latch_edge;
+			rec.latch_edge = nullptr;
+		}
+		return;
+	}
+
+	while ((t = abc_blif_token(p)) != nullptr)
+		rec.nets.push_back(t);
+
+	if (rec.nets.empty()) {
+		rec.ok = false;
+		return;
+	}
+
+	int width = GetSize(rec.nets)-1;
+
+	if (width == 0)
+	{
+		RTLIL::State state = RTLIL::State::Sa;
+		for (char *cube : rec.cubes)
+		for (int i = 0; cube[i]; i++) {
+			if (cube[i] == ' ' || cube[i] == '\t')
+				continue;
+			if (cube[i] == '0' && state != RTLIL::State::S1) {
+				state = RTLIL::State::S0;
+				continue;
+			}
+			if (cube[i] == '1' && state != RTLIL::State::S0) {
+				state = RTLIL::State::S1;
+				continue;
+			}
+			rec.ok = false;
+			return;
+		}
+		rec.const_state = state == RTLIL::State::Sa ? RTLIL::State::S0 : state;
+		if (!strcmp(rec.nets[0], "$undef"))
+			rec.const_state = RTLIL::State::Sx;
+		return;
+	}
+
+	// same input plane limit as the blif frontend
+	if (width > 12) {
+		rec.ok = false;
+		return;
+	}
+
+	rec.lut_table.assign(1 << width, RTLIL::State::Sx);
+	RTLIL::State default_state = RTLIL::State::Sx;
+
+	for (char *cube : rec.cubes)
+	{
+		char *cp = cube;
+		char *in = abc_blif_token(cp);
+		char *out = abc_blif_token(cp);
+
+		if (in == nullptr || out == nullptr || (strcmp(out, "0") && strcmp(out, "1")) || (int)strlen(in) != width) {
+			rec.ok = false;
+			return;
+		}
+
+		RTLIL::State out_state = out[0] == '1' ? RTLIL::State::S1 : RTLIL::State::S0;
+		default_state = out[0] == '1' ? RTLIL::State::S0 : RTLIL::State::S1;
+
+		for (int i = 0; i < (1 << width); i++) {
+			for (int j = 0; j < width; j++) {
+				char c1 = in[j];
+				if (c1 != '-' && c1 != (((i >> j) & 1) ? '1' : '0'))
+					goto try_next_value;
+			}
+			rec.lut_table[i] = out_state;
+		try_next_value:;
+		}
+	}
+
+	for (auto &bit : rec.lut_table)
+		if (bit == RTLIL::State::Sx)
+			bit = default_state;
+}
+
+static bool abc_parse_output_blif(RTLIL::Design *design, std::string text, RTLIL::IdString dff_name)
+{
+	// join continuation lines and split the buffer into lines in place
+	std::vector<char*> lines;
+	char *buf = &text[0];
+	size_t len = text.size(), cursor = 0, line_start = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		char c = buf[i];
+		if (c == '\\' && i+1 < len && (buf[i+1] == '\n' || (buf[i+1] == '\r' && i+2 < len && buf[i+2] == '\n'))) {
+			i += buf[i+1] == '\r' ? 2 : 1;
+			continue;
+		}
+		if (c == '\r')
+			continue;
+		if (c == '\n') {
+			while (cursor > line_start && (buf[cursor-1] == ' ' || buf[cursor-1] == '\t'))
+				cursor--;
+			buf[cursor++] = 0;
+			lines.push_back(buf + line_start);
+			line_start = cursor;
+			continue;
+		}
+		buf[cursor++] = c;
+	}
+	if (cursor > line_start) {
+		buf[cursor++] = 0;
+		lines.push_back(buf + line_start);
+	}
+
+	// classify the lines; the directive order (and with it the order of the
+	// created wires and cells) is preserved in the record list
+	std::vector<abc_blif_record> records;
+	std::vector<char*> input_args, output_args;
+	std::string model_name;
+	bool seen_model = false, seen_end = false;
+	int open_names = -1;
+
+	for (char *line : lines)
+	{
+		if (line[0] == 0 || line[0] == '#')
+			continue;
+
+		if (line[0] != '.') {
+			if (open_names < 0)
+				return false;
+			records[open_names].cubes.push_back(line);
+			continue;
+		}
+
+		char *p = line;
+		char *cmd = abc_blif_token(p);
+		open_names = -1;
+
+		if (!strcmp(cmd, ".model")) {
+			char *name = abc_blif_token(p);
+			if (seen_model || name == nullptr)
+				return false;
+			model_name = name;
+			seen_model = true;
+			continue;
+		}
+
+		if (!seen_model || seen_end)
+			return false;
+
+		if (!strcmp(cmd, ".end")) {
+			seen_end = true;
+			continue;
+		}
+		if (!strcmp(cmd, ".inputs")) {
+			input_args.push_back(p);
+			continue;
+		}
+		if (!strcmp(cmd, ".outputs")) {
+			output_args.push_back(p);
+			continue;
+		}
+		if (!strcmp(cmd, ".gate") || !strcmp(cmd, ".subckt")) {
+			records.push_back(abc_blif_record(abc_blif_record::GATE, p));
+			continue;
+		}
+		if (!strcmp(cmd, ".latch")) {
+			records.push_back(abc_blif_record(abc_blif_record::LATCH, p));
+			continue;
+		}
+		if (!strcmp(cmd, ".names")) {
+			records.push_back(abc_blif_record(abc_blif_record::NAMES, p));
+			open_names = GetSize(records)-1;
+			continue;
+		}
+
+		// anything else is left to the generic parser
+		return false;
+	}
+
+	if (!seen_model || !seen_end)
+		return false;
+
+	// tokenize the records and evaluate the truth tables in parallel; each
+	// record owns its lines exclusively, so the in-place tokenization is
+	// safe, and no RTLIL objects or IdStrings are touched on the workers
+	ThreadPool::get().parallel_for(GetSize(records), [&](int index) {
+		abc_tokenize_record(records[index]);
+	});
+
+	for (auto &rec : records)
+		if (!rec.ok)
+			return false;
+
+	RTLIL::Module *mod = new RTLIL::Module;
+	mod->name = RTLIL::escape_id(model_name);
+	if (design->module(mod->name)) {
+		delete mod;
+		return false;
+	}
+	design->add(mod);
+
+	std::string esc_buffer;
+	auto blif_wire = [&](const char *wire_name) -> RTLIL::Wire*
+	{
+		esc_buffer.clear();
+		if (wire_name[0] != 0 && wire_name[0] != '\\' && wire_name[0] != '$')
+			esc_buffer += '\\';
+		esc_buffer += wire_name;
+
+		RTLIL::IdString wire_id(esc_buffer);
+		RTLIL::Wire *wire = mod->wire(wire_id);
+
+		if (wire == nullptr)
+			wire = mod->addWire(wire_id);
+
+		return wire;
+	};
+
+	for (int port_output = 0; port_output < 2; port_output++)
+	for (char *args : port_output ? output_args : input_args) {
+		char *p = args, *t;
+		while ((t = abc_blif_token(p)) != nullptr) {
+			RTLIL::IdString wire_name(stringf("\\%s", t));
+			RTLIL::Wire *wire = mod->wire(wire_name);
+			if (wire == nullptr)
+				wire = mod->addWire(wire_name);
+			if (port_output)
+				wire->port_output = true;
+			else
+				wire->port_input = true;
+		}
+	}
+
+	for (auto &rec : records)
+	{
+		if (rec.type == abc_blif_record::GATE)
+		{
+			RTLIL::Cell *cell = mod->addCell(NEW_ID, RTLIL::escape_id(rec.celltype));
+			for (auto &conn : rec.conns)
+				cell->setPort(RTLIL::escape_id(conn.first), conn.second[0] ? SigSpec(blif_wire(conn.second)) : SigSpec());
+			continue;
+		}
+
+		if (rec.type == abc_blif_record::LATCH)
+		{
+			if (rec.latch_init != nullptr && (rec.latch_init[0] == '0' || rec.latch_init[0] == '1'))
+				blif_wire(rec.latch_q)->attributes[ID::init] = Const(rec.latch_init[0] == '1' ? 1 : 0, 1);
+
+			if (rec.latch_clock != nullptr && !strcmp(rec.latch_edge, "re"))
+				mod->addDff(NEW_ID, blif_wire(rec.latch_clock), blif_wire(rec.latch_d), blif_wire(rec.latch_q));
+			else if (rec.latch_clock != nullptr && !strcmp(rec.latch_edge, "fe"))
+				mod->addDff(NEW_ID, blif_wire(rec.latch_clock), blif_wire(rec.latch_d), blif_wire(rec.latch_q), false);
+			else if (rec.latch_clock != nullptr && !strcmp(rec.latch_edge, "ah"))
+				mod->addDlatch(NEW_ID, blif_wire(rec.latch_clock), blif_wire(rec.latch_d), blif_wire(rec.latch_q));
+			else if (rec.latch_clock != nullptr && !strcmp(rec.latch_edge, "al"))
+				mod->addDlatch(NEW_ID, blif_wire(rec.latch_clock), blif_wire(rec.latch_d), blif_wire(rec.latch_q), false);
+			else if (dff_name.empty())
+				mod->addFf(NEW_ID, blif_wire(rec.latch_d), blif_wire(rec.latch_q));
+			else {
+				RTLIL::Cell *cell = mod->addCell(NEW_ID, dff_name);
+				cell->setPort(ID::D, blif_wire(rec.latch_d));
+				cell->setPort(ID::Q, blif_wire(rec.latch_q));
+			}
+			continue;
+		}
+
+		if (GetSize(rec.nets) == 1) {
+			mod->connect(RTLIL::SigSig(blif_wire(rec.nets[0]), rec.const_state));
+			continue;
+		}
+
+		RTLIL::SigSpec input_sig;
+		for (int i = 0; i < GetSize(rec.nets)-1; i++)
+			input_sig.append(blif_wire(rec.nets[i]));
+
+		RTLIL::Cell *cell = mod->addCell(NEW_ID, ID($lut));
+		cell->parameters[ID::WIDTH] = RTLIL::Const(GetSize(input_sig));
+		cell->parameters[ID::LUT] = RTLIL::Const(rec.lut_table);
+		cell->setPort(ID::A, input_sig);
+		cell->setPort(ID::Y, blif_wire(rec.nets.back()));
+	}
+
+	mod->fixup_ports();
+	return true;
+}
+
+void abc_reintegrate_job(RTLIL::Design *design, abc_job &job)
+{
+	module = job.module;
+	map_autoidx = job.map_autoidx;
+	signal_list = std::move(job.signal_list);
+	pi_map = std::move(job.pi_map);
+	po_map = std::move(job.po_map);
+	clk_polarity = job.clk_polarity;
+	en_polarity = job.en_polarity;
+	arst_polarity = job.arst_polarity;
+	srst_polarity = job.srst_polarity;
+	clk_sig = job.clk_sig;
+	en_sig = job.en_sig;
+	arst_sig = job.arst_sig;
+	srst_sig = job.srst_sig;
+	had_init = job.had_init;
+	assign_map.set(module);
+	initvals.set(&assign_map, module);
+
+	abc_output_filter filt(job.tempdir_name, job.show_tempdir);
+	for (auto &line : job.output_lines)
+		filt.next_line(line);
+
+	if (job.ret != 0)
+		log_error("ABC: execution of command \"%s\" failed: return code %d.\n", job.command.c_str(), job.ret);
+
+	std::string buffer = stringf("%s/%s", job.tempdir_name.c_str(), "output.blif");
+	std::ifstream ifs;
+	ifs.open(buffer);
+	if (ifs.fail())
+		log_error("Can't open ABC output file `%s'.\n", buffer.c_str());
+
+	bool builtin_lib = job.builtin_lib;
+	IdString dff_name = builtin_lib ? ID(DFF) : ID(_dff_);
+	RTLIL::Design *mapped_design = new RTLIL::Design;
+
+	if (job.sop_mode) {
+		// $sop construction interleaves parsing and netlist surgery; leave
+		// that to the generic parser
+		parse_blif(mapped_design, ifs, dff_name, false, true);
+	} else {
+		std::string blif_text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+		if (!abc_parse_output_blif(mapped_design, blif_text, dff_name)) {
+			std::istringstream blif_stream(blif_text);
+			parse_blif(mapped_design, blif_stream, dff_name, false, false);
+		}
+	}
+
+	ifs.close();
+
+	log_header(design, "Re-integrating ABC results.\n");
+	RTLIL::Module *mapped_mod = mapped_design->module(ID(netlist));
+	if (mapped_mod == nullptr)
+		log_error("ABC output file does not contain a module `netlist'.\n");
+	for (auto w : mapped_mod->wires()) {
+		RTLIL::Wire *orig_wire = nullptr;
+		RTLIL::Wire *wire = module->addWire(remap_name(w->name, &orig_wire));
+		if (orig_wire != nullptr && orig_wire->attributes.count(ID::src))
+			wire->attributes[ID::src] = orig_wire->attributes[ID::src];
+		if (markgroups) wire->attributes[ID::abcgroup] = map_autoidx;
+		design->select(module, wire);
+	}
+
+	SigMap mapped_sigmap(mapped_mod);
+	FfInitVals mapped_initvals(&mapped_sigmap, mapped_mod);
+
+	dict<std::string, int> cell_stats;
+	for (auto c : mapped_mod->cells())
+	{
+		if (builtin_lib)
+		{
+			cell_stats[RTLIL::unescape_id(c->type)]++;
+			if (c->type.in(ID(ZERO), ID(ONE))) {
+				RTLIL::SigSig conn;
+				RTLIL::IdString name_y = remap_name(c->getPort(ID::Y).as_wire()->name);
+				conn.first = module->wire(name_y);
+				conn.second = RTLIL::SigSpec(c->type == ID(ZERO) ? 0 : 1, 1);
+				module->connect(conn);
+				continue;
+			}
+			if (c->type == ID(BUF)) {
+				RTLIL::SigSig conn;
+				RTLIL::IdString name_y = remap_name(c->getPort(ID::Y).as_wire()->name);
+				RTLIL::IdString name_a = remap_name(c->getPort(ID::A).as_wire()->name);
+				conn.first = module->wire(name_y);
+				conn.second = module->wire(name_a);
+				module->connect(conn);
+				continue;
+			}
+			if (c->type == ID(NOT)) {
+				RTLIL::Cell *cell = module->addCell(remap_name(c->name), ID($_NOT_));
+				if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+				for (auto name : {ID::A, ID::Y}) {
+					RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
+					cell->setPort(name, module->wire(remapped_name));
+				}
+				design->select(module, cell);
+				continue;
+			}
+			if (c->type.in(ID(AND), ID(OR), ID(XOR), ID(NAND), ID(NOR), ID(XNOR), ID(ANDNOT), ID(ORNOT))) {
+				RTLIL::Cell *cell = module->addCell(remap_name(c->name), stringf("$_%s_", c->type.c_str()+1));
+				if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+				for (auto name : {ID::A, ID::B, ID::Y}) {
+					RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
+					cell->setPort(name, module->wire(remapped_name));
+				}
+				design->select(module, cell);
+				continue;
+			}
+			if (c->type.in(ID(MUX), ID(NMUX))) {
+				RTLIL::Cell *cell = module->addCell(remap_name(c->name), stringf("$_%s_", c->type.c_str()+1));
+				if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+				for (auto name : {ID::A, ID::B, ID::S, ID::Y}) {
+					RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
+					cell->setPort(name, module->wire(remapped_name));
+				}
+				design->select(module, cell);
+				continue;
+			}
+			if (c->type == ID(MUX4)) {
+				RTLIL::Cell *cell = module->addCell(remap_name(c->name), ID($_MUX4_));
+				if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+				for (auto name : {ID::A, ID::B, ID::C, ID::D, ID::S, ID::T, ID::Y}) {
+					RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
+					cell->setPort(name, module->wire(remapped_name));
+				}
+				design->select(module, cell);
+				continue;
+			}
+			if (c->type == ID(MUX8)) {
+				RTLIL::Cell *cell = module->addCell(remap_name(c->name), ID($_MUX8_));
+				if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+				for (auto name : {ID::A, ID::B, ID::C, ID::D, ID::E, ID::F, ID::G, ID::H, ID::S, ID::T, ID::U, ID::Y}) {
+					RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
+					cell->setPort(name, module->wire(remapped_name));
+				}
+				design->select(module, cell);
+				continue;
+			}
+			if (c->type == ID(MUX16)) {
+				RTLIL::Cell *cell = module->addCell(remap_name(c->name), ID($_MUX16_));
+				if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+				for (auto name : {ID::A, ID::B, ID::C, ID::D, ID::E, ID::F, ID::G, ID::H, ID::I, ID::J, ID::K,
+						ID::L, ID::M, ID::N, ID::O, ID::P, ID::S, ID::T, ID::U, ID::V, ID::Y}) {
+					RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
+					cell->setPort(name, module->wire(remapped_name));
+				}
+				design->select(module, cell);
+				continue;
+			}
+			if (c->type.in(ID(AOI3), ID(OAI3))) {
+				RTLIL::Cell *cell = module->addCell(remap_name(c->name), stringf("$_%s_", c->type.c_str()+1));
+				if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+				for (auto name : {ID::A, ID::B, ID::C, ID::Y}) {
+					RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
+					cell->setPort(name, module->wire(remapped_name));
+				}
+				design->select(module, cell);
+				continue;
+			}
+			if (c->type.in(ID(AOI4), ID(OAI4))) {
+				RTLIL::Cell *cell = module->addCell(remap_name(c->name), stringf("$_%s_", c->type.c_str()+1));
+				if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+				for (auto name : {ID::A, ID::B, ID::C, ID::D, ID::Y}) {
+					RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
+					cell->setPort(name, module->wire(remapped_name));
+				}
+				design->select(module, cell);
+				continue;
+			}
+			if (c->type == ID(DFF)) {
+				log_assert(clk_sig.size() == 1);
+				FfData ff(module, &initvals, remap_name(c->name));
+				ff.width = 1;
+				ff.is_fine = true;
+				ff.has_clk = true;
+				ff.pol_clk = clk_polarity;
+				ff.sig_clk = clk_sig;
+				if (en_sig.size() != 0) {
+					log_assert(en_sig.size() == 1);
+					ff.has_ce = true;
+					ff.pol_ce = en_polarity;
+					ff.sig_ce = en_sig;
+				}
+				RTLIL::Const init = mapped_initvals(c->getPort(ID::Q));
+				if (had_init)
+					ff.val_init = init;
+				else
+					ff.val_init = State::Sx;
+				if (arst_sig.size() != 0) {
+					log_assert(arst_sig.size() == 1);
+					ff.has_arst = true;
+					ff.pol_arst = arst_polarity;
+					ff.sig_arst = arst_sig;
+					ff.val_arst = init;
+				}
+				if (srst_sig.size() != 0) {
+					log_assert(srst_sig.size() == 1);
+					ff.has_srst = true;
+					ff.pol_srst = srst_polarity;
+					ff.sig_srst = srst_sig;
+					ff.val_srst = init;
+				}
+				ff.sig_d = module->wire(remap_name(c->getPort(ID::D).as_wire()->name));
+				ff.sig_q = module->wire(remap_name(c->getPort(ID::Q).as_wire()->name));
+				RTLIL::Cell *cell = ff.emit();
+				if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+				design->select(module, cell);
+				continue;
+			}
+		}
+		else
+			cell_stats[RTLIL::unescape_id(c->type)]++;
+
+		if (c->type.in(ID(_const0_), ID(_const1_))) {
+			RTLIL::SigSig conn;
+			conn.first = module->wire(remap_name(c->connections().begin()->second.as_wire()->name));
+			conn.second = RTLIL::SigSpec(c->type == ID(_const0_) ? 0 : 1, 1);
+			module->connect(conn);
+			continue;
+		}
+
+		if (c->type == ID(_dff_)) {
+			log_assert(clk_sig.size() == 1);
+			FfData ff(module, &initvals, remap_name(c->name));
+			ff.width = 1;
+			ff.is_fine = true;
+			ff.has_clk = true;
+			ff.pol_clk = clk_polarity;
+			ff.sig_clk = clk_sig;
+			if (en_sig.size() != 0) {
+				log_assert(en_sig.size() == 1);
+				ff.pol_ce = en_polarity;
+				ff.sig_ce = en_sig;
+			}
+			RTLIL::Const init = mapped_initvals(c->getPort(ID::Q));
+			if (had_init)
+				ff.val_init = init;
+			else
+				ff.val_init = State::Sx;
+			if (arst_sig.size() != 0) {
+				log_assert(arst_sig.size() == 1);
+				ff.pol_arst = arst_polarity;
+				ff.sig_arst = arst_sig;
+				ff.val_arst = init;
+			}
+			if (srst_sig.size() != 0) {
+				log_assert(srst_sig.size() == 1);
+				ff.pol_srst = srst_polarity;
+				ff.sig_srst = srst_sig;
+				ff.val_srst = init;
+			}
+			ff.sig_d = module->wire(remap_name(c->getPort(ID::D).as_wire()->name));
+			ff.sig_q = module->wire(remap_name(c->getPort(ID::Q).as_wire()->name));
+			RTLIL::Cell *cell = ff.emit();
+			if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+			design->select(module, cell);
+			continue;
+		}
+
+		if (c->type == ID($lut) && GetSize(c->getPort(ID::A)) == 1 && c->getParam(ID::LUT).as_int() == 2) {
+			SigSpec my_a = module->wire(remap_name(c->getPort(ID::A).as_wire()->name));
+			SigSpec my_y = module->wire(remap_name(c->getPort(ID::Y).as_wire()->name));
+			module->connect(my_y, my_a);
+			continue;
+		}
+
+		RTLIL::Cell *cell = module->addCell(remap_name(c->name), c->type);
+		if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
+		cell->parameters = c->parameters;
+		for (auto &conn : c->connections()) {
+			RTLIL::SigSpec newsig;
+			for (auto &c : conn.second.chunks()) {
+				if (c.width == 0)
+					continue;
+				log_assert(c.width == 1);
+				newsig.append(module->wire(remap_name(c.wire->name)));
+			}
+			cell->setPort(conn.first, newsig);
+		}
+		design->select(module, cell);
+	}
+
+	for (auto conn : mapped_mod->connections()) {
+		if (!conn.first.is_fully_const())
+			conn.first = module->wire(remap_name(conn.first.as_wire()->name));
+		if (!conn.second.is_fully_const())
+			conn.second = module->wire(remap_name(conn.second.as_wire()->name));
+		module->connect(conn);
+	}
+
+	for (auto &it : cell_stats)
+		log("ABC RESULTS:   %15s cells: %8d\n", it.first.c_str(), it.second);
+	int in_wires = 0, out_wires = 0;
+	for (auto &si : signal_list)
+		if (si.is_port) {
+			char buffer[100];
+			snprintf(buffer, 100, "\\ys__n%d", si.id);
+			RTLIL::SigSig conn;
+			if (si.type != G(NONE)) {
+				conn.first = si.bit;
+				conn.second = module->wire(remap_name(buffer));
+				out_wires++;
+			} else {
+				conn.first = module->wire(remap_name(buffer));
+				conn.second = si.bit;
+				in_wires++;
+			}
+			module->connect(conn);
+		}
+	log("ABC RESULTS:        internal signals: %8d\n", int(signal_list.size()) - in_wires - out_wires);
+	log("ABC RESULTS:           input signals: %8d\n", in_wires);
+	log("ABC RESULTS:          output signals: %8d\n", out_wires);
+
+	delete mapped_design;
+}
+
 void abc_module(RTLIL::Design *design, RTLIL::Module *current_module, std::string script_file, std::string exe_file,
 		std::vector<std::string> &liberty_files, std::vector<std::string> &genlib_files, std::string constr_file,
 		bool cleanup, vector<int> lut_costs, bool dff_mode, std::string clk_str, bool keepff, std::string delay_target,
 		std::string sop_inputs, std::string sop_products, std::string lutin_shared, bool fast_mode,
-		const std::vector<RTLIL::Cell*> &cells, bool show_tempdir, bool sop_mode, bool abc_dress, std::vector<std::string> &dont_use_cells)
+		const std::vector<RTLIL::Cell*> &cells, bool show_tempdir, bool sop_mode, bool abc_dress, std::vector<std::string> &dont_use_cells,
+		std::vector<abc_job> *job_queue)
 {
 	module = current_module;
 	map_autoidx = autoidx++;
@@ -788,12 +1545,32 @@ void abc_module(RTLIL::Design *design, RTLIL::Module *current_module, std::strin
 		log_cmd_error("Clock domain %s not found.\n", clk_str.c_str());
 
 	std::string tempdir_name;
-	if (cleanup) 
-		tempdir_name = get_base_tmpdir() + "/";
-	else
-		tempdir_name = "_tmp_";
-	tempdir_name += proc_program_prefix() + "yosys-abc-XXXXXX";
-	tempdir_name = make_temp_dir(tempdir_name);
+	if (cleanup) {
+		// reuse one temp directory for all calls; the per-call files
+		// (input.blif, abc.script, output.blif) are simply overwritten
+		if (shared_tempdir_name.empty()) {
+			tempdir_name = get_base_tmpdir() + "/" + proc_program_prefix() + "yosys-abc-XXXXXX";
+			shared_tempdir_name = make_temp_dir(tempdir_name);
+			shared_tempdir_libfiles_written = false;
+		}
+		if (job_queue != nullptr) {
+			// queued jobs run side by side and need their own files; their
+			// directories are nested in the shared one so that cleanup
+			// stays a single remove_directory() call
+			tempdir_name = make_temp_dir(shared_tempdir_name + "/job-XXXXXX");
+		} else
+			tempdir_name = shared_tempdir_name;
+	} else {
+		// with -nocleanup every call gets its own directory, so that the
+		// files of all calls can be inspected afterwards
+		tempdir_name = "_tmp_" + proc_program_prefix() + "yosys-abc-XXXXXX";
+		tempdir_name = make_temp_dir(tempdir_name);
+	}
+
+	// the library files are shared by all calls of one pass execution (they
+	// depend only on the pass options), unless -nocleanup keeps every call
+	// in its own directory
+	std::string libdir_name = cleanup ? shared_tempdir_name : tempdir_name;
 	log_header(design, "Extracting gate netlist of module `%s' to `%s/input.blif'..\n",
 			module->name.c_str(), replace_tempdir(tempdir_name, tempdir_name, show_tempdir).c_str());
 
@@ -815,9 +1592,9 @@ void abc_module(RTLIL::Design *design, RTLIL::Module *current_module, std::strin
 			abc_script += stringf("read_constr -v \"%s\"; ", constr_file.c_str());
 	} else
 	if (!lut_costs.empty())
-		abc_script += stringf("read_lut %s/lutdefs.txt; ", tempdir_name.c_str());
+		abc_script += stringf("read_lut %s/lutdefs.txt; ", libdir_name.c_str());
 	else
-		abc_script += stringf("read_library %s/stdcells.genlib; ", tempdir_name.c_str());
+		abc_script += stringf("read_library %s/stdcells.genlib; ", libdir_name.c_str());
 
 	if (!script_file.empty()) {
 		if (script_file[0] == '+') {
@@ -1049,403 +1826,110 @@ void abc_module(RTLIL::Design *design, RTLIL::Module *current_module, std::strin
 	{
 		log_header(design, "Executing ABC.\n");
 
-		auto &cell_cost = cmos_cost ? CellCosts::cmos_gate_cost() : CellCosts::default_gate_cost();
-
-		buffer = stringf("%s/stdcells.genlib", tempdir_name.c_str());
-		f = fopen(buffer.c_str(), "wt");
-		if (f == nullptr)
-			log_error("Opening %s for writing failed: %s\n", buffer.c_str(), strerror(errno));
-		fprintf(f, "GATE ZERO    1 Y=CONST0;\n");
-		fprintf(f, "GATE ONE     1 Y=CONST1;\n");
-		fprintf(f, "GATE BUF    %d Y=A;                  PIN * NONINV  1 999 1 0 1 0\n", cell_cost.at(ID($_BUF_)));
-		fprintf(f, "GATE NOT    %d Y=!A;                 PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_NOT_)));
-		if (enabled_gates.count("AND"))
-			fprintf(f, "GATE AND    %d Y=A*B;                PIN * NONINV  1 999 1 0 1 0\n", cell_cost.at(ID($_AND_)));
-		if (enabled_gates.count("NAND"))
-			fprintf(f, "GATE NAND   %d Y=!(A*B);             PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_NAND_)));
-		if (enabled_gates.count("OR"))
-			fprintf(f, "GATE OR     %d Y=A+B;                PIN * NONINV  1 999 1 0 1 0\n", cell_cost.at(ID($_OR_)));
-		if (enabled_gates.count("NOR"))
-			fprintf(f, "GATE NOR    %d Y=!(A+B);             PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_NOR_)));
-		if (enabled_gates.count("XOR"))
-			fprintf(f, "GATE XOR    %d Y=(A*!B)+(!A*B);      PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_XOR_)));
-		if (enabled_gates.count("XNOR"))
-			fprintf(f, "GATE XNOR   %d Y=(A*B)+(!A*!B);      PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_XNOR_)));
-		if (enabled_gates.count("ANDNOT"))
-			fprintf(f, "GATE ANDNOT %d Y=A*!B;               PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_ANDNOT_)));
-		if (enabled_gates.count("ORNOT"))
-			fprintf(f, "GATE ORNOT  %d Y=A+!B;               PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_ORNOT_)));
-		if (enabled_gates.count("AOI3"))
-			fprintf(f, "GATE AOI3   %d Y=!((A*B)+C);         PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_AOI3_)));
-		if (enabled_gates.count("OAI3"))
-			fprintf(f, "GATE OAI3   %d Y=!((A+B)*C);         PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_OAI3_)));
-		if (enabled_gates.count("AOI4"))
-			fprintf(f, "GATE AOI4   %d Y=!((A*B)+(C*D));     PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_AOI4_)));
-		if (enabled_gates.count("OAI4"))
-			fprintf(f, "GATE OAI4   %d Y=!((A+B)*(C+D));     PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_OAI4_)));
-		if (enabled_gates.count("MUX"))
-			fprintf(f, "GATE MUX    %d Y=(A*B)+(S*B)+(!S*A); PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_MUX_)));
-		if (enabled_gates.count("NMUX"))
-			fprintf(f, "GATE NMUX   %d Y=!((A*B)+(S*B)+(!S*A)); PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_NMUX_)));
-		if (map_mux4)
-			fprintf(f, "GATE MUX4   %d Y=(!S*!T*A)+(S*!T*B)+(!S*T*C)+(S*T*D); PIN * UNKNOWN 1 999 1 0 1 0\n", 2*cell_cost.at(ID($_MUX_)));
-		if (map_mux8)
-			fprintf(f, "GATE MUX8   %d Y=(!S*!T*!U*A)+(S*!T*!U*B)+(!S*T*!U*C)+(S*T*!U*D)+(!S*!T*U*E)+(S*!T*U*F)+(!S*T*U*G)+(S*T*U*H); PIN * UNKNOWN 1 999 1 0 1 0\n", 4*cell_cost.at(ID($_MUX_)));
-		if (map_mux16)
-			fprintf(f, "GATE MUX16  %d Y=(!S*!T*!U*!V*A)+(S*!T*!U*!V*B)+(!S*T*!U*!V*C)+(S*T*!U*!V*D)+(!S*!T*U*!V*E)+(S*!T*U*!V*F)+(!S*T*U*!V*G)+(S*T*U*!V*H)+(!S*!T*!U*V*I)+(S*!T*!U*V*J)+(!S*T*!U*V*K)+(S*T*!U*V*L)+(!S*!T*U*V*M)+(S*!T*U*V*N)+(!S*T*U*V*O)+(S*T*U*V*P); PIN * UNKNOWN 1 999 1 0 1 0\n", 8*cell_cost.at(ID($_MUX_)));
-		fclose(f);
-
-		if (!lut_costs.empty()) {
-			buffer = stringf("%s/lutdefs.txt", tempdir_name.c_str());
+		// the library files depend only on pass options, so in the shared temp
+		// directory they are written by the first call and then reused
+		if (!cleanup || !shared_tempdir_libfiles_written)
+		{
+			auto &cell_cost = cmos_cost ? CellCosts::cmos_gate_cost() : CellCosts::default_gate_cost();
+
+			buffer = stringf("%s/stdcells.genlib", libdir_name.c_str());
 			f = fopen(buffer.c_str(), "wt");
 			if (f == nullptr)
 				log_error("Opening %s for writing failed: %s\n", buffer.c_str(), strerror(errno));
-			for (int i = 0; i < GetSize(lut_costs); i++)
-				fprintf(f, "%d %d.00 1.00\n", i+1, lut_costs.at(i));
+			fprintf(f, "GATE ZERO    1 Y=CONST0;\n");
+			fprintf(f, "GATE ONE     1 Y=CONST1;\n");
+			fprintf(f, "GATE BUF    %d Y=A;                  PIN * NONINV  1 999 1 0 1 0\n", cell_cost.at(ID($_BUF_)));
+			fprintf(f, "GATE NOT    %d Y=!A;                 PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_NOT_)));
+			if (enabled_gates.count("AND"))
+				fprintf(f, "GATE AND    %d Y=A*B;                PIN * NONINV  1 999 1 0 1 0\n", cell_cost.at(ID($_AND_)));
+			if (enabled_gates.count("NAND"))
+				fprintf(f, "GATE NAND   %d Y=!(A*B);             PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_NAND_)));
+			if (enabled_gates.count("OR"))
+				fprintf(f, "GATE OR     %d Y=A+B;                PIN * NONINV  1 999 1 0 1 0\n", cell_cost.at(ID($_OR_)));
+			if (enabled_gates.count("NOR"))
+				fprintf(f, "GATE NOR    %d Y=!(A+B);             PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_NOR_)));
+			if (enabled_gates.count("XOR"))
+				fprintf(f, "GATE XOR    %d Y=(A*!B)+(!A*B);      PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_XOR_)));
+			if (enabled_gates.count("XNOR"))
+				fprintf(f, "GATE XNOR   %d Y=(A*B)+(!A*!B);      PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_XNOR_)));
+			if (enabled_gates.count("ANDNOT"))
+				fprintf(f, "GATE ANDNOT %d Y=A*!B;               PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_ANDNOT_)));
+			if (enabled_gates.count("ORNOT"))
+				fprintf(f, "GATE ORNOT  %d Y=A+!B;               PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_ORNOT_)));
+			if (enabled_gates.count("AOI3"))
+				fprintf(f, "GATE AOI3   %d Y=!((A*B)+C);         PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_AOI3_)));
+			if (enabled_gates.count("OAI3"))
+				fprintf(f, "GATE OAI3   %d Y=!((A+B)*C);         PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_OAI3_)));
+			if (enabled_gates.count("AOI4"))
+				fprintf(f, "GATE AOI4   %d Y=!((A*B)+(C*D));     PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_AOI4_)));
+			if (enabled_gates.count("OAI4"))
+				fprintf(f, "GATE OAI4   %d Y=!((A+B)*(C+D));     PIN * INV     1 999 1 0 1 0\n", cell_cost.at(ID($_OAI4_)));
+			if (enabled_gates.count("MUX"))
+				fprintf(f, "GATE MUX    %d Y=(A*B)+(S*B)+(!S*A); PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_MUX_)));
+			if (enabled_gates.count("NMUX"))
+				fprintf(f, "GATE NMUX   %d Y=!((A*B)+(S*B)+(!S*A)); PIN * UNKNOWN 1 999 1 0 1 0\n", cell_cost.at(ID($_NMUX_)));
+			if (map_mux4)
+				fprintf(f, "GATE MUX4   %d Y=(!S*!T*A)+(S*!T*B)+(!S*T*C)+(S*T*D); PIN * UNKNOWN 1 999 1 0 1 0\n", 2*cell_cost.at(ID($_MUX_)));
+			if (map_mux8)
+				fprintf(f, "GATE MUX8   %d Y=(!S*!T*!U*A)+(S*!T*!U*B)+(!S*T*!U*C)+(S*T*!U*D)+(!S*!T*U*E)+(S*!T*U*F)+(!S*T*U*G)+(S*T*U*H); PIN * UNKNOWN 1 999 1 0 1 0\n", 4*cell_cost.at(ID($_MUX_)));
+			if (map_mux16)
+				fprintf(f, "GATE MUX16  %d Y=(!S*!T*!U*!V*A)+(S*!T*!U*!V*B)+(!S*T*!U*!V*C)+(S*T*!U*!V*D)+(!S*!T*U*!V*E)+(S*!T*U*!V*F)+(!S*T*U*!V*G)+(S*T*U*!V*H)+(!S*!T*!U*V*I)+(S*!T*!U*V*J)+(!S*T*!U*V*K)+(S*T*!U*V*L)+(!S*!T*U*V*M)+(S*!T*U*V*N)+(!S*T*U*V*O)+(S*T*U*V*P); PIN * UNKNOWN 1 999 1 0 1 0\n", 8*cell_cost.at(ID($_MUX_)));
 			fclose(f);
-		}
-
-		buffer = stringf("\"%s\" -s -f %s/abc.script 2>&1", exe_file.c_str(), tempdir_name.c_str());
-		log("Running ABC command: %s\n", replace_tempdir(buffer, tempdir_name, show_tempdir).c_str());
 
-#ifndef YOSYS_LINK_ABC
-		abc_output_filter filt(tempdir_name, show_tempdir);
-		int ret = run_command(buffer, std::bind(&abc_output_filter::next_line, filt, std::placeholders::_1));
-#else
-		string temp_stdouterr_name = stringf("%s/stdouterr.txt", tempdir_name.c_str());
-		FILE *temp_stdouterr_w = fopen(temp_stdouterr_name.c_str(), "w");
-		if (temp_stdouterr_w == NULL)
-			log_error("ABC: cannot open a temporary file for output redirection");
-		fflush(stdout);
-		fflush(stderr);
-		FILE *old_stdout = fopen(temp_stdouterr_name.c_str(), "r"); // need any fd for renumbering
-		FILE *old_stderr = fopen(temp_stdouterr_name.c_str(), "r"); // need any fd for renumbering
-#if defined(__wasm)
-#define fd_renumber(from, to) (void)__wasi_fd_renumber(from, to)
-#else
-#define fd_renumber(from, to) dup2(from, to)
-#endif
-		fd_renumber(fileno(stdout), fileno(old_stdout));
-		fd_renumber(fileno(stderr), fileno(old_stderr));
-		fd_renumber(fileno(temp_stdouterr_w), fileno(stdout));
-		fd_renumber(fileno(temp_stdouterr_w), fileno(stderr));
-		fclose(temp_stdouterr_w);
-		// These needs to be mutable, supposedly due to getopt
-		char *abc_argv[5];
-		string tmp_script_name = stringf("%s/abc.script", tempdir_name.c_str());
-		abc_argv[0] = strdup(exe_file.c_str());
-		abc_argv[1] = strdup("-s");
-		abc_argv[2] = strdup("-f");
-		abc_argv[3] = strdup(tmp_script_name.c_str());
-		abc_argv[4] = 0;
-		int ret = abc::Abc_RealMain(4, abc_argv);
-		free(abc_argv[0]);
-		free(abc_argv[1]);
-		free(abc_argv[2]);
-		free(abc_argv[3]);
-		fflush(stdout);
-		fflush(stderr);
-		fd_renumber(fileno(old_stdout), fileno(stdout));
-		fd_renumber(fileno(old_stderr), fileno(stderr));
-		fclose(old_stdout);
-		fclose(old_stderr);
-		std::ifstream temp_stdouterr_r(temp_stdouterr_name);
-		abc_output_filter filt(tempdir_name, show_tempdir);
-		for (std::string line; std::getline(temp_stdouterr_r, line); )
-			filt.next_line(line + "\n");
-		temp_stdouterr_r.close();
-#endif
-		if (ret != 0)
-			log_error("ABC: execution of command \"%s\" failed: return code %d.\n", buffer.c_str(), ret);
-
-		buffer = stringf("%s/%s", tempdir_name.c_str(), "output.blif");
-		std::ifstream ifs;
-		ifs.open(buffer);
-		if (ifs.fail())
-			log_error("Can't open ABC output file `%s'.\n", buffer.c_str());
-
-		bool builtin_lib = liberty_files.empty() && genlib_files.empty();
-		RTLIL::Design *mapped_design = new RTLIL::Design;
-		parse_blif(mapped_design, ifs, builtin_lib ? ID(DFF) : ID(_dff_), false, sop_mode);
-
-		ifs.close();
-
-		log_header(design, "Re-integrating ABC results.\n");
-		RTLIL::Module *mapped_mod = mapped_design->module(ID(netlist));
-		if (mapped_mod == nullptr)
-			log_error("ABC output file does not contain a module `netlist'.\n");
-		for (auto w : mapped_mod->wires()) {
-			RTLIL::Wire *orig_wire = nullptr;
-			RTLIL::Wire *wire = module->addWire(remap_name(w->name, &orig_wire));
-			if (orig_wire != nullptr && orig_wire->attributes.count(ID::src))
-				wire->attributes[ID::src] = orig_wire->attributes[ID::src];
-			if (markgroups) wire->attributes[ID::abcgroup] = map_autoidx;
-			design->select(module, wire);
-		}
-
-		SigMap mapped_sigmap(mapped_mod);
-		FfInitVals mapped_initvals(&mapped_sigmap, mapped_mod);
-
-		dict<std::string, int> cell_stats;
-		for (auto c : mapped_mod->cells())
-		{
-			if (builtin_lib)
-			{
-				cell_stats[RTLIL::unescape_id(c->type)]++;
-				if (c->type.in(ID(ZERO), ID(ONE))) {
-					RTLIL::SigSig conn;
-					RTLIL::IdString name_y = remap_name(c->getPort(ID::Y).as_wire()->name);
-					conn.first = module->wire(name_y);
-					conn.second = RTLIL::SigSpec(c->type == ID(ZERO) ? 0 : 1, 1);
-					module->connect(conn);
-					continue;
-				}
-				if (c->type == ID(BUF)) {
-					RTLIL::SigSig conn;
-					RTLIL::IdString name_y = remap_name(c->getPort(ID::Y).as_wire()->name);
-					RTLIL::IdString name_a = remap_name(c->getPort(ID::A).as_wire()->name);
-					conn.first = module->wire(name_y);
-					conn.second = module->wire(name_a);
-					module->connect(conn);
-					continue;
-				}
-				if (c->type == ID(NOT)) {
-					RTLIL::Cell *cell = module->addCell(remap_name(c->name), ID($_NOT_));
-					if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-					for (auto name : {ID::A, ID::Y}) {
-						RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
-						cell->setPort(name, module->wire(remapped_name));
-					}
-					design->select(module, cell);
-					continue;
-				}
-				if (c->type.in(ID(AND), ID(OR), ID(XOR), ID(NAND), ID(NOR), ID(XNOR), ID(ANDNOT), ID(ORNOT))) {
-					RTLIL::Cell *cell = module->addCell(remap_name(c->name), stringf("$_%s_", c->type.c_str()+1));
-					if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-					for (auto name : {ID::A, ID::B, ID::Y}) {
-						RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
-						cell->setPort(name, module->wire(remapped_name));
-					}
-					design->select(module, cell);
-					continue;
-				}
-				if (c->type.in(ID(MUX), ID(NMUX))) {
-					RTLIL::Cell *cell = module->addCell(remap_name(c->name), stringf("$_%s_", c->type.c_str()+1));
-					if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-					for (auto name : {ID::A, ID::B, ID::S, ID::Y}) {
-						RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
-						cell->setPort(name, module->wire(remapped_name));
-					}
-					design->select(module, cell);
-					continue;
-				}
-				if (c->type == ID(MUX4)) {
-					RTLIL::Cell *cell = module->addCell(remap_name(c->name), ID($_MUX4_));
-					if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-					for (auto name : {ID::A, ID::B, ID::C, ID::D, ID::S, ID::T, ID::Y}) {
-						RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
-						cell->setPort(name, module->wire(remapped_name));
-					}
-					design->select(module, cell);
-					continue;
-				}
-				if (c->type == ID(MUX8)) {
-					RTLIL::Cell *cell = module->addCell(remap_name(c->name), ID($_MUX8_));
-					if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-					for (auto name : {ID::A, ID::B, ID::C, ID::D, ID::E, ID::F, ID::G, ID::H, ID::S, ID::T, ID::U, ID::Y}) {
-						RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
-						cell->setPort(name, module->wire(remapped_name));
-					}
-					design->select(module, cell);
-					continue;
-				}
-				if (c->type == ID(MUX16)) {
-					RTLIL::Cell *cell = module->addCell(remap_name(c->name), ID($_MUX16_));
-					if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-					for (auto name : {ID::A, ID::B, ID::C, ID::D, ID::E, ID::F, ID::G, ID::H, ID::I, ID::J, ID::K,
-							ID::L, ID::M, ID::N, ID::O, ID::P, ID::S, ID::T, ID::U, ID::V, ID::Y}) {
-						RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
-						cell->setPort(name, module->wire(remapped_name));
-					}
-					design->select(module, cell);
-					continue;
-				}
-				if (c->type.in(ID(AOI3), ID(OAI3))) {
-					RTLIL::Cell *cell = module->addCell(remap_name(c->name), stringf("$_%s_", c->type.c_str()+1));
-					if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-					for (auto name : {ID::A, ID::B, ID::C, ID::Y}) {
-						RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
-						cell->setPort(name, module->wire(remapped_name));
-					}
-					design->select(module, cell);
-					continue;
-				}
-				if (c->type.in(ID(AOI4), ID(OAI4))) {
-					RTLIL::Cell *cell = module->addCell(remap_name(c->name), stringf("$_%s_", c->type.c_str()+1));
-					if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-					for (auto name : {ID::A, ID::B, ID::C, ID::D, ID::Y}) {
-						RTLIL::IdString remapped_name = remap_name(c->getPort(name).as_wire()->name);
-						cell->setPort(name, module->wire(remapped_name));
-					}
-					design->select(module, cell);
-					continue;
-				}
-				if (c->type == ID(DFF)) {
-					log_assert(clk_sig.size() == 1);
-					FfData ff(module, &initvals, remap_name(c->name));
-					ff.width = 1;
-					ff.is_fine = true;
-					ff.has_clk = true;
-					ff.pol_clk = clk_polarity;
-					ff.sig_clk = clk_sig;
-					if (en_sig.size() != 0) {
-						log_assert(en_sig.size() == 1);
-						ff.has_ce = true;
-						ff.pol_ce = en_polarity;
-						ff.sig_ce = en_sig;
-					}
-					RTLIL::Const init = mapped_initvals(c->getPort(ID::Q));
-					if (had_init)
-						ff.val_init = init;
-					else
-						ff.val_init = State::Sx;
-					if (arst_sig.size() != 0) {
-						log_assert(arst_sig.size() == 1);
-						ff.has_arst = true;
-						ff.pol_arst = arst_polarity;
-						ff.sig_arst = arst_sig;
-						ff.val_arst = init;
-					}
-					if (srst_sig.size() != 0) {
-						log_assert(srst_sig.size() == 1);
-						ff.has_srst = true;
-						ff.pol_srst = srst_polarity;
-						ff.sig_srst = srst_sig;
-						ff.val_srst = init;
-					}
-					ff.sig_d = module->wire(remap_name(c->getPort(ID::D).as_wire()->name));
-					ff.sig_q = module->wire(remap_name(c->getPort(ID::Q).as_wire()->name));
-					RTLIL::Cell *cell = ff.emit();
-					if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-					design->select(module, cell);
-					continue;
-				}
+			if (!lut_costs.empty()) {
+				buffer = stringf("%s/lutdefs.txt", libdir_name.c_str());
+				f = fopen(buffer.c_str(), "wt");
+				if (f == nullptr)
+					log_error("Opening %s for writing failed: %s\n", buffer.c_str(), strerror(errno));
+				for (int i = 0; i < GetSize(lut_costs); i++)
+					fprintf(f, "%d %d.00 1.00\n", i+1, lut_costs.at(i));
+				fclose(f);
 			}
-			else
-				cell_stats[RTLIL::unescape_id(c->type)]++;
 
-			if (c->type.in(ID(_const0_), ID(_const1_))) {
-				RTLIL::SigSig conn;
-				conn.first = module->wire(remap_name(c->connections().begin()->second.as_wire()->name));
-				conn.second = RTLIL::SigSpec(c->type == ID(_const0_) ? 0 : 1, 1);
-				module->connect(conn);
-				continue;
-			}
-
-			if (c->type == ID(_dff_)) {
-				log_assert(clk_sig.size() == 1);
-				FfData ff(module, &initvals, remap_name(c->name));
-				ff.width = 1;
-				ff.is_fine = true;
-				ff.has_clk = true;
-				ff.pol_clk = clk_polarity;
-				ff.sig_clk = clk_sig;
-				if (en_sig.size() != 0) {
-					log_assert(en_sig.size() == 1);
-					ff.pol_ce = en_polarity;
-					ff.sig_ce = en_sig;
-				}
-				RTLIL::Const init = mapped_initvals(c->getPort(ID::Q));
-				if (had_init)
-					ff.val_init = init;
-				else
-					ff.val_init = State::Sx;
-				if (arst_sig.size() != 0) {
-					log_assert(arst_sig.size() == 1);
-					ff.pol_arst = arst_polarity;
-					ff.sig_arst = arst_sig;
-					ff.val_arst = init;
-				}
-				if (srst_sig.size() != 0) {
-					log_assert(srst_sig.size() == 1);
-					ff.pol_srst = srst_polarity;
-					ff.sig_srst = srst_sig;
-					ff.val_srst = init;
-				}
-				ff.sig_d = module->wire(remap_name(c->getPort(ID::D).as_wire()->name));
-				ff.sig_q = module->wire(remap_name(c->getPort(ID::Q).as_wire()->name));
-				RTLIL::Cell *cell = ff.emit();
-				if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-				design->select(module, cell);
-				continue;
-			}
-
-			if (c->type == ID($lut) && GetSize(c->getPort(ID::A)) == 1 && c->getParam(ID::LUT).as_int() == 2) {
-				SigSpec my_a = module->wire(remap_name(c->getPort(ID::A).as_wire()->name));
-				SigSpec my_y = module->wire(remap_name(c->getPort(ID::Y).as_wire()->name));
-				module->connect(my_y, my_a);
-				continue;
-			}
-
-			RTLIL::Cell *cell = module->addCell(remap_name(c->name), c->type);
-			if (markgroups) cell->attributes[ID::abcgroup] = map_autoidx;
-			cell->parameters = c->parameters;
-			for (auto &conn : c->connections()) {
-				RTLIL::SigSpec newsig;
-				for (auto &c : conn.second.chunks()) {
-					if (c.width == 0)
-						continue;
-					log_assert(c.width == 1);
-					newsig.append(module->wire(remap_name(c.wire->name)));
-				}
-				cell->setPort(conn.first, newsig);
-			}
-			design->select(module, cell);
-		}
-
-		for (auto conn : mapped_mod->connections()) {
-			if (!conn.first.is_fully_const())
-				conn.first = module->wire(remap_name(conn.first.as_wire()->name));
-			if (!conn.second.is_fully_const())
-				conn.second = module->wire(remap_name(conn.second.as_wire()->name));
-			module->connect(conn);
+			shared_tempdir_libfiles_written = true;
 		}
 
-		for (auto &it : cell_stats)
-			log("ABC RESULTS:   %15s cells: %8d\n", it.first.c_str(), it.second);
-		int in_wires = 0, out_wires = 0;
-		for (auto &si : signal_list)
-			if (si.is_port) {
-				char buffer[100];
-				snprintf(buffer, 100, "\\ys__n%d", si.id);
-				RTLIL::SigSig conn;
-				if (si.type != G(NONE)) {
-					conn.first = si.bit;
-					conn.second = module->wire(remap_name(buffer));
-					out_wires++;
-				} else {
-					conn.first = module->wire(remap_name(buffer));
-					conn.second = si.bit;
-					in_wires++;
-				}
-				module->connect(conn);
-			}
-		log("ABC RESULTS:        internal signals: %8d\n", int(signal_list.size()) - in_wires - out_wires);
-		log("ABC RESULTS:           input signals: %8d\n", in_wires);
-		log("ABC RESULTS:          output signals: %8d\n", out_wires);
+		buffer = stringf("\"%s\" -s -f %s/abc.script 2>&1", exe_file.c_str(), tempdir_name.c_str());
+		log("Running ABC command: %s\n", replace_tempdir(buffer, tempdir_name, show_tempdir).c_str());
 
-		delete mapped_design;
+		abc_job job;
+		job.module = module;
+		job.map_autoidx = map_autoidx;
+		job.signal_list = std::move(signal_list);
+		job.pi_map = std::move(pi_map);
+		job.po_map = std::move(po_map);
+		job.clk_polarity = clk_polarity;
+		job.en_polarity = en_polarity;
+		job.arst_polarity = arst_polarity;
+		job.srst_polarity = srst_polarity;
+		job.clk_sig = clk_sig;
+		job.en_sig = en_sig;
+		job.arst_sig = arst_sig;
+		job.srst_sig = srst_sig;
+		job.had_init = had_init;
+		job.tempdir_name = tempdir_name;
+		job.exe_file = exe_file;
+		job.command = buffer;
+		job.show_tempdir = show_tempdir;
+		job.builtin_lib = liberty_files.empty() && genlib_files.empty();
+		job.sop_mode = sop_mode;
+
+		if (job_queue != nullptr) {
+			// the ABC process is started later, together with the other
+			// queued jobs; the results are merged in queue order
+			job_queue->push_back(std::move(job));
+		} else {
+			abc_run_job(job);
+			abc_reintegrate_job(design, job);
+		}
 	}
 	else
 	{
 		log("Don't call ABC as there is nothing to map.\n");
 	}
 
-	if (cleanup)
-	{
-		log("Removing temp directory.\n");
-		remove_directory(tempdir_name);
-	}
+	// the shared temp directory is removed at the end of AbcPass::execute();
+	// with -nocleanup the per-call directories are kept on purpose
 
 	log_pop();
 }
@@ -1615,6 +2099,14 @@ struct AbcPass : public Pass {
 		log("        set the \"keep\" attribute on flip-flop output wires. (and thus preserve\n");
 		log("        them, for example for equivalence checking.)\n");
 		log("\n");
+		log("    -j <num>\n");
+		log("        run up to the specified number of ABC processes in parallel. The ABC\n");
+		log("        calls for the selected modules (and their clock domains, with -dff)\n");
+		log("        are independent of each other; their results are merged in a fixed\n");
+		log("        order, so the output is identical to a sequential run. This option\n");
+		log("        has no effect when yosys is built with LINK_ABC=1, as the linked-in\n");
+		log("        ABC library can only run one job at a time.\n");
+		log("\n");
 		log("    -nocleanup\n");
 		log("        when this option is used, the temporary files created by this pass\n");
 		log("        are not removed. this is useful for debugging.\n");
@@ -1657,6 +2149,7 @@ struct AbcPass : public Pass {
 		initvals.clear();
 		pi_map.clear();
 		po_map.clear();
+		shared_tempdir_name.clear();
 
 		std::string exe_file = yosys_abc_executable;
 		std::string script_file, default_liberty_file, constr_file, clk_str;
@@ -1665,6 +2158,7 @@ struct AbcPass : public Pass {
 		bool fast_mode = false, dff_mode = false, keepff = false, cleanup = true;
 		bool show_tempdir = false, sop_mode = false;
 		bool abc_dress = false;
+		int abc_jobs = 1;
 		vector<int> lut_costs;
 		markgroups = false;
 
@@ -1699,6 +2193,7 @@ struct AbcPass : public Pass {
 		map_mux8 = design->scratchpad_get_bool("abc.mux8", map_mux8);
 		map_mux16 = design->scratchpad_get_bool("abc.mux16", map_mux16);
 		abc_dress = design->scratchpad_get_bool("abc.dress", abc_dress);
+		abc_jobs = design->scratchpad_get_int("abc.jobs", abc_jobs);
 		g_arg = design->scratchpad_get_string("abc.g", g_arg);
 
 		fast_mode = design->scratchpad_get_bool("abc.fast", fast_mode);
@@ -1824,6 +2319,10 @@ struct AbcPass : public Pass {
 				keepff = true;
 				continue;
 			}
+			if (arg == "-j" && argidx+1 < args.size()) {
+				abc_jobs = max(1, atoi(args[++argidx].c_str()));
+				continue;
+			}
 			if (arg == "-nocleanup") {
 				cleanup = false;
 				continue;
@@ -2041,6 +2540,9 @@ struct AbcPass : public Pass {
 			// enabled_gates.insert("NMUX");
 		}
 
+		std::vector<abc_job> job_queue;
+		std::vector<abc_job> *job_queue_p = abc_jobs > 1 ? &job_queue : nullptr;
+
 		for (auto mod : design->selected_modules())
 		{
 			if (mod->processes.size() > 0) {
@@ -2053,7 +2555,7 @@ struct AbcPass : public Pass {
 
 			if (!dff_mode || !clk_str.empty()) {
 				abc_module(design, mod, script_file, exe_file, liberty_files, genlib_files, constr_file, cleanup, lut_costs, dff_mode, clk_str, keepff,
-						delay_target, sop_inputs, sop_products, lutin_shared, fast_mode, mod->selected_cells(), show_tempdir, sop_mode, abc_dress, dont_use_cells);
+						delay_target, sop_inputs, sop_products, lutin_shared, fast_mode, mod->selected_cells(), show_tempdir, sop_mode, abc_dress, dont_use_cells, job_queue_p);
 				continue;
 			}
 
@@ -2215,11 +2717,44 @@ struct AbcPass : public Pass {
 				srst_polarity = std::get<6>(it.first);
 				srst_sig = assign_map(std::get<7>(it.first));
 				abc_module(design, mod, script_file, exe_file, liberty_files, genlib_files, constr_file, cleanup, lut_costs, !clk_sig.empty(), "$",
-						keepff, delay_target, sop_inputs, sop_products, lutin_shared, fast_mode, it.second, show_tempdir, sop_mode, abc_dress, dont_use_cells);
+						keepff, delay_target, sop_inputs, sop_products, lutin_shared, fast_mode, it.second, show_tempdir, sop_mode, abc_dress, dont_use_cells, job_queue_p);
 				assign_map.set(mod);
 			}
 		}
 
+		if (!job_queue.empty())
+		{
+			log_header(design, "Running %d queued ABC jobs (up to %d in parallel).\n", GetSize(job_queue), abc_jobs);
+#ifndef YOSYS_LINK_ABC
+			std::atomic<int> next_job(0);
+			auto run_jobs = [&]() {
+				while (1) {
+					int job_idx = next_job.fetch_add(1);
+					if (job_idx >= GetSize(job_queue))
+						break;
+					abc_run_job(job_queue[job_idx]);
+				}
+			};
+			std::vector<std::thread> helpers;
+			for (int i = 1; i < abc_jobs && i < GetSize(job_queue); i++)
+				helpers.emplace_back(run_jobs);
+			run_jobs();
+			for (auto &helper : helpers)
+				helper.join();
+#else
+			// the linked-in ABC library is not reentrant, so the queued
+			// jobs have to run one after another
+			for (auto &job : job_queue)
+				abc_run_job(job);
+#endif
+			for (auto &job : job_queue) {
+				log_push();
+				abc_reintegrate_job(design, job);
+				log_pop();
+			}
+			job_queue.clear();
+		}
+
 		assign_map.clear();
 		signal_list.clear();
 		signal_map.clear();
@@ -2227,6 +2762,12 @@ struct AbcPass : public Pass {
 		pi_map.clear();
 		po_map.clear();
 
+		if (!shared_tempdir_name.empty()) {
+			log("Removing temp directory.\n");
+			remove_directory(shared_tempdir_name);
+			shared_tempdir_name.clear();
+		}
+
 		log_pop();
 	}
 } AbcPass;
@@ -23,6 +23,8 @@
 #include "kernel/utils.h"
 #include "kernel/celltypes.h"
 #include "kernel/timinginfo.h"
+#include "backends/rtlil/rtlil_backend.h"
+#include "libs/sha1/sha1.h"
 
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
@@ -880,8 +882,81 @@ void prep_xaiger(RTLIL::Module *module, bool dff)
 	}
 }
 
+// The lut and box libraries depend only on the modules carrying the
+// (* abc9_lut *) / (* abc9_box *) attributes -- i.e. on the target
+// architecture -- not on the design being mapped, yet they were regenerated
+// (including re-parsing all specify cells into TimingInfo) on every abc9
+// invocation. prep_lut() and prep_box() therefore memoize the generated
+// library text keyed by a digest of the contributing modules: process-wide
+// in memory, and additionally on disk when the "abc9.cache_dir" scratchpad
+// variable points to a cache directory, so repeated per-module abc9 runs
+// and separate yosys processes using the same architecture skip the setup.
+
+std::string library_digest(RTLIL::Design *design, IdString attr, const std::string &extra)
+{
+	std::stringstream ss;
+	ss << extra << "\n";
+	for (auto module : design->modules()) {
+		if (!module->attributes.count(attr))
+			continue;
+		RTLIL_BACKEND::dump_module(ss, "", module, design, false);
+	}
+	return sha1(ss.str());
+}
+
+dict<std::string, std::string> library_cache;
+
+bool load_library(RTLIL::Design *design, const std::string &kind, const std::string &digest, std::string &text)
+{
+	auto it = library_cache.find(kind + digest);
+	if (it != library_cache.end()) {
+		text = it->second;
+		return true;
+	}
+
+	std::string cachedir = design->scratchpad_get_string("abc9.cache_dir");
+	if (cachedir.empty())
+		return false;
+
+	std::ifstream ifs(stringf("%s/%s-%s.txt", cachedir.c_str(), kind.c_str(), digest.c_str()));
+	if (!ifs.is_open())
+		return false;
+
+	text = std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	library_cache[kind + digest] = text;
+	return true;
+}
+
+void store_library(RTLIL::Design *design, const std::string &kind, const std::string &digest, const std::string &text)
+{
+	library_cache[kind + digest] = text;
+
+	std::string cachedir = design->scratchpad_get_string("abc9.cache_dir");
+	if (cachedir.empty())
+		return;
+
+	if (!check_directory_exists(cachedir) && !create_directory(cachedir)) {
+		log_warning("Can't create abc9 cache directory `%s'.\n", cachedir.c_str());
+		return;
+	}
+
+	std::ofstream ofs(stringf("%s/%s-%s.txt", cachedir.c_str(), kind.c_str(), digest.c_str()));
+	if (!ofs.is_open()) {
+		log_warning("Can't write abc9 cache file in `%s'.\n", cachedir.c_str());
+		return;
+	}
+	ofs << text;
+}
+
 void prep_lut(RTLIL::Design *design, int maxlut)
 {
+	std::string digest = library_digest(design, ID::abc9_lut, stringf("maxlut %d", maxlut));
+	std::string cached;
+	if (load_library(design, "lut", digest, cached)) {
+		design->scratchpad_set_string("abc9_ops.lut_library", cached);
+		return;
+	}
+
 	TimingInfo timing;
 
 	struct t_lut {
@@ -948,6 +1023,7 @@ void prep_lut(RTLIL::Design *design, int maxlut)
 		ss << std::endl;
 	}
 	design->scratchpad_set_string("abc9_ops.lut_library", ss.str());
+	store_library(design, "lut", digest, ss.str());
 }
 
 void write_lut(RTLIL::Module *module, const std::string &dst) {
@@ -959,6 +1035,30 @@ void write_lut(RTLIL::Module *module, const std::string &dst) {
 
 void prep_box(RTLIL::Design *design)
 {
+	std::string digest = library_digest(design, ID::abc9_box, "box");
+	std::string cached;
+	if (load_library(design, "box", digest, cached)) {
+		// replay the attribute rewrite of the generation path below, which
+		// assigns (* abc9_box_id *) values in the same deterministic order
+		// the cached library text was produced with
+		int abc9_box_id = 1;
+		for (auto module : design->modules()) {
+			auto it = module->attributes.find(ID::abc9_box);
+			if (it == module->attributes.end())
+				continue;
+			bool box = it->second.as_bool();
+			module->attributes.erase(it);
+			if (!box)
+				continue;
+			auto r = module->attributes.insert(ID::abc9_box_id);
+			if (!r.second)
+				continue;
+			r.first->second = abc9_box_id++;
+		}
+		design->scratchpad_set_string("abc9_ops.box_library", cached);
+		return;
+	}
+
 	TimingInfo timing;
 
 	int abc9_box_id = 1;
@@ -1128,6 +1228,7 @@ void prep_box(RTLIL::Design *design)
 		ss << "(dummy) 1 0 0 0";
 
 	design->scratchpad_set_string("abc9_ops.box_library", ss.str());
+	store_library(design, "box", digest, ss.str());
 }
 
 void write_box(RTLIL::Module *module, const std::string &dst) {
@@ -1634,14 +1735,16 @@ struct Abc9OpsPass : public Pass {
 		log("\n");
 		log("    -prep_lut <maxlut>\n");
 		log("        pre-compute the lut library by analysing all modules marked with\n");
-		log("        (* abc9_lut=<area> *).\n");
+		log("        (* abc9_lut=<area> *). the result is memoized keyed by a digest of\n");
+		log("        the contributing modules (on disk too if the 'abc9.cache_dir'\n");
+		log("        scratchpad variable names a cache directory).\n");
 		log("\n");
 		log("    -write_lut <dst>\n");
 		log("        write the pre-computed lut library to <dst>.\n");
 		log("\n");
 		log("    -prep_box\n");
 		log("        pre-compute the box library by analysing all modules marked with\n");
-		log("        (* abc9_box *).\n");
+		log("        (* abc9_box *). memoized like -prep_lut.\n");
 		log("\n");
 		log("    -write_box <dst>\n");
 		log("        write the pre-computed box library to <dst>.\n");
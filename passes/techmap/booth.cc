@@ -71,47 +71,143 @@ struct BoothPassWorker {
 
 	BoothPassWorker(RTLIL::Module *module) : module(module), sigmap(module) { booth_counter = 0; }
 
+	// Gate construction helpers that fold constant inputs instead of
+	// emitting a cell. The operands get padded to a common even width
+	// before lowering, so the upper encoder and decoder rows often see
+	// nothing but constant bits; folding those here means a zero row
+	// produces no cells at all, instead of a full row of dead logic
+	// that sits in the module until a later opt call collects it. On
+	// wide multipliers that bounds the peak netlist to roughly its
+	// final size.
+
+	SigBit NotGate(RTLIL::IdString name, SigBit a)
+	{
+		if (a == State::S0)
+			return State::S1;
+		if (a == State::S1)
+			return State::S0;
+		return module->NotGate(name, a);
+	}
+
+	SigBit AndGate(RTLIL::IdString name, SigBit a, SigBit b)
+	{
+		if (a == State::S0 || b == State::S0)
+			return State::S0;
+		if (a == State::S1)
+			return b;
+		if (b == State::S1)
+			return a;
+		if (a == b)
+			return a;
+		return module->AndGate(name, a, b);
+	}
+
+	SigBit OrGate(RTLIL::IdString name, SigBit a, SigBit b)
+	{
+		if (a == State::S1 || b == State::S1)
+			return State::S1;
+		if (a == State::S0)
+			return b;
+		if (b == State::S0)
+			return a;
+		if (a == b)
+			return a;
+		return module->OrGate(name, a, b);
+	}
+
+	SigBit NandGate(RTLIL::IdString name, SigBit a, SigBit b)
+	{
+		if (a == State::S0 || b == State::S0)
+			return State::S1;
+		if (a == State::S1)
+			return NotGate(name, b);
+		if (b == State::S1 || a == b)
+			return NotGate(name, a);
+		return module->NandGate(name, a, b);
+	}
+
+	SigBit NorGate(RTLIL::IdString name, SigBit a, SigBit b)
+	{
+		if (a == State::S1 || b == State::S1)
+			return State::S0;
+		if (a == State::S0)
+			return NotGate(name, b);
+		if (b == State::S0 || a == b)
+			return NotGate(name, a);
+		return module->NorGate(name, a, b);
+	}
+
+	SigBit XorGate(RTLIL::IdString name, SigBit a, SigBit b)
+	{
+		if (a == State::S0)
+			return b;
+		if (b == State::S0)
+			return a;
+		if (a == State::S1)
+			return NotGate(name, b);
+		if (b == State::S1)
+			return NotGate(name, a);
+		if (a == b)
+			return State::S0;
+		return module->XorGate(name, a, b);
+	}
+
+	SigBit XnorGate(RTLIL::IdString name, SigBit a, SigBit b)
+	{
+		if (a == State::S1)
+			return b;
+		if (b == State::S1)
+			return a;
+		if (a == State::S0)
+			return NotGate(name, b);
+		if (b == State::S0)
+			return NotGate(name, a);
+		if (a == b)
+			return State::S1;
+		return module->XnorGate(name, a, b);
+	}
+
 	// Booth unsigned decoder lsb
 	SigBit Bur4d_lsb(std::string name, SigBit lsb_i, SigBit one_i, SigBit s_i)
 	{
-		SigBit and_op = module->AndGate(NEW_ID_SUFFIX(name), lsb_i, one_i);
-		return module->XorGate(NEW_ID_SUFFIX(name), and_op, s_i);
+		SigBit and_op = AndGate(NEW_ID_SUFFIX(name), lsb_i, one_i);
+		return XorGate(NEW_ID_SUFFIX(name), and_op, s_i);
 	}
 
 	// Booth unsigned radix4 decoder
 	SigBit Bur4d_n(std::string name, SigBit yn_i, SigBit ynm1_i, SigBit one_i, SigBit two_i, SigBit s_i)
 	{
 		// ppij = ((yn & one)   | (ynm1 & two)) ^ s;
-		SigBit an1 = module->AndGate(NEW_ID_SUFFIX(name), yn_i, one_i);
-		SigBit an2 = module->AndGate(NEW_ID_SUFFIX(name), ynm1_i, two_i);
-		SigBit or1 = module->OrGate(NEW_ID_SUFFIX(name), an1, an2);
-		return module->XorGate(NEW_ID_SUFFIX(name), s_i, or1);
+		SigBit an1 = AndGate(NEW_ID_SUFFIX(name), yn_i, one_i);
+		SigBit an2 = AndGate(NEW_ID_SUFFIX(name), ynm1_i, two_i);
+		SigBit or1 = OrGate(NEW_ID_SUFFIX(name), an1, an2);
+		return XorGate(NEW_ID_SUFFIX(name), s_i, or1);
 	}
 
 	// Booth unsigned radix4 decoder
 	SigBit Bur4d_msb(std::string name, SigBit msb_i, SigBit two_i, SigBit s_i)
 	{
 		// ppij = (msb & two)  ^ s;
-		SigBit an1 = module->AndGate(NEW_ID_SUFFIX(name), msb_i, two_i);
-		return module->XorGate(NEW_ID_SUFFIX(name), s_i, an1);
+		SigBit an1 = AndGate(NEW_ID_SUFFIX(name), msb_i, two_i);
+		return XorGate(NEW_ID_SUFFIX(name), s_i, an1);
 	}
 
 	// half adder, used in CPA
 	void BuildHa(std::string name, SigBit a_i, SigBit b_i, SigBit &s_o, SigBit &c_o)
 	{
-		s_o = module->XorGate(NEW_ID_SUFFIX(name), a_i, b_i);
-		c_o = module->AndGate(NEW_ID_SUFFIX(name), a_i, b_i);
+		s_o = XorGate(NEW_ID_SUFFIX(name), a_i, b_i);
+		c_o = AndGate(NEW_ID_SUFFIX(name), a_i, b_i);
 	}
 
 	// Booth unsigned radix 4 encoder
 	void BuildBur4e(std::string name, SigBit y0_i, SigBit y1_i, SigBit y2_i,
 			SigBit &one_o, SigBit &two_o, SigBit &s_o, SigBit &sb_o)
 	{
-		one_o = module->XorGate(NEW_ID_SUFFIX(name), y0_i, y1_i);
+		one_o = XorGate(NEW_ID_SUFFIX(name), y0_i, y1_i);
 		s_o = y2_i;
-		sb_o = module->NotGate(NEW_ID_SUFFIX(name), y2_i);
-		SigBit y1_xnor_y2 = module->XnorGate(NEW_ID_SUFFIX(name), y1_i, y2_i);
-		two_o = module->NorGate(NEW_ID_SUFFIX(name), y1_xnor_y2, one_o);
+		sb_o = NotGate(NEW_ID_SUFFIX(name), y2_i);
+		SigBit y1_xnor_y2 = XnorGate(NEW_ID_SUFFIX(name), y1_i, y2_i);
+		two_o = NorGate(NEW_ID_SUFFIX(name), y1_xnor_y2, one_o);
 	}
 
 	void BuildBr4e(std::string name, SigBit y2_m1_i,
@@ -119,9 +215,9 @@ struct BoothPassWorker {
 		       SigBit y2_p1_i,
 		       SigBit &negi_o, SigBit &twoi_n_o, SigBit &onei_n_o, SigBit &cori_o)
 	{
-		auto y2_p1_n = module->NotGate(NEW_ID_SUFFIX(name), y2_p1_i);
-		auto y2_n = module->NotGate(NEW_ID_SUFFIX(name), y2_i);
-		auto y2_m1_n = module->NotGate(NEW_ID_SUFFIX(name), y2_m1_i);
+		auto y2_p1_n = NotGate(NEW_ID_SUFFIX(name), y2_p1_i);
+		auto y2_n = NotGate(NEW_ID_SUFFIX(name), y2_i);
+		auto y2_m1_n = NotGate(NEW_ID_SUFFIX(name), y2_m1_i);
 
 		negi_o = y2_p1_i;
 
@@ -129,15 +225,15 @@ struct BoothPassWorker {
 		//    (y2_p1_n & y2_i & y2_m1_i) |
 		//    (y2_p1 & y2_n & y2_m1_n)
 		// )
-		twoi_n_o = module->NorGate(NEW_ID_SUFFIX(name),
-			module->AndGate(NEW_ID_SUFFIX(name), y2_p1_n, module->AndGate(NEW_ID_SUFFIX(name), y2_i, y2_m1_i)),
-			module->AndGate(NEW_ID_SUFFIX(name), y2_p1_i, module->AndGate(NEW_ID_SUFFIX(name), y2_n, y2_m1_n))
+		twoi_n_o = NorGate(NEW_ID_SUFFIX(name),
+			AndGate(NEW_ID_SUFFIX(name), y2_p1_n, AndGate(NEW_ID_SUFFIX(name), y2_i, y2_m1_i)),
+			AndGate(NEW_ID_SUFFIX(name), y2_p1_i, AndGate(NEW_ID_SUFFIX(name), y2_n, y2_m1_n))
 		);
 
 		// onei_n = ~(y2_m1_i ^ y2_i);
-		onei_n_o = module->XnorGate(NEW_ID_SUFFIX(name), y2_m1_i, y2_i);
+		onei_n_o = XnorGate(NEW_ID_SUFFIX(name), y2_m1_i, y2_i);
 		// cori = (y2_m1_n | y2_n) & y2_p1_i;
-		cori_o = module->AndGate(NEW_ID_SUFFIX(name), module->OrGate(NEW_ID_SUFFIX(name), y2_m1_n, y2_n), y2_p1_i);
+		cori_o = AndGate(NEW_ID_SUFFIX(name), OrGate(NEW_ID_SUFFIX(name), y2_m1_n, y2_n), y2_p1_i);
 	}
 
 	//
@@ -149,10 +245,10 @@ struct BoothPassWorker {
 		// nxj_in = xnor(xj,negi)
 		// nxj_o = xnj_in,
 		// ppij = ~( (nxj_m1_i | twoi_n_i) & (nxj_int | onei_n_i));
-		nxj_o = module->XnorGate(NEW_ID_SUFFIX(name), xj_i, negi_i);
-		ppij_o = module->NandGate(NEW_ID_SUFFIX(name),
-			module->OrGate(NEW_ID_SUFFIX(name), nxj_m1_i, twoi_n_i),
-			module->OrGate(NEW_ID_SUFFIX(name), nxj_o, onei_n_i)
+		nxj_o = XnorGate(NEW_ID_SUFFIX(name), xj_i, negi_i);
+		ppij_o = NandGate(NEW_ID_SUFFIX(name),
+			OrGate(NEW_ID_SUFFIX(name), nxj_m1_i, twoi_n_i),
+			OrGate(NEW_ID_SUFFIX(name), nxj_o, onei_n_i)
 		);
 	}
 
@@ -176,14 +272,14 @@ struct BoothPassWorker {
 		  //correction propagation
 		  assign CORO = (~PP1 & ~PP0)? CORI : 1'b0;
 		*/
-		nxj_o = module->XnorGate(NEW_ID_SUFFIX(name), x1_i, negi_i);
-		pp0_o = module->AndGate(NEW_ID_SUFFIX(name), x0_i, y0_i);
-		SigBit pp1_1_int = module->AndGate(NEW_ID_SUFFIX(name), x1_i, y0_i);
-		SigBit pp1_2_int = module->AndGate(NEW_ID_SUFFIX(name), x0_i, y1_i);
-		pp1_o = module->XorGate(NEW_ID_SUFFIX(name), pp1_1_int, pp1_2_int);
-
-		SigBit pp1_nor_pp0 = module->NorGate(NEW_ID_SUFFIX(name), pp1_o, pp0_o);
-		cor_o = module->AndGate(NEW_ID_SUFFIX(name), pp1_nor_pp0, cori_i);
+		nxj_o = XnorGate(NEW_ID_SUFFIX(name), x1_i, negi_i);
+		pp0_o = AndGate(NEW_ID_SUFFIX(name), x0_i, y0_i);
+		SigBit pp1_1_int = AndGate(NEW_ID_SUFFIX(name), x1_i, y0_i);
+		SigBit pp1_2_int = AndGate(NEW_ID_SUFFIX(name), x0_i, y1_i);
+		pp1_o = XorGate(NEW_ID_SUFFIX(name), pp1_1_int, pp1_2_int);
+
+		SigBit pp1_nor_pp0 = NorGate(NEW_ID_SUFFIX(name), pp1_o, pp0_o);
+		cor_o = AndGate(NEW_ID_SUFFIX(name), pp1_nor_pp0, cori_i);
 	}
 
 	void BuildBitwiseFa(Module *mod, std::string name, const SigSpec &sig_a, const SigSpec &sig_b,
@@ -199,9 +295,45 @@ struct BoothPassWorker {
 		log_assert(sig_a.size() == sig_x.size());
 		log_assert(sig_a.size() == sig_y.size());
 
-		for (int i = 0; i < sig_a.size(); i++)
-			mod->addFa(stringf("%s[%d]", name.c_str(), i), sig_a[i], sig_b[i],
-				   sig_c[i], sig_x[i], sig_y[i], src);
+		for (int i = 0; i < sig_a.size(); i++) {
+			// fold adder bits with constant operands down to the
+			// surviving gates; bits fed entirely by padding go away
+			int ones = 0;
+			SigSpec rest;
+			for (SigBit bit : {sig_a[i], sig_b[i], sig_c[i]}) {
+				if (bit == State::S1)
+					ones++;
+				else if (bit != State::S0)
+					rest.append(bit);
+			}
+
+			std::string bit_name = stringf("%s[%d]", name.c_str(), i);
+			SigBit x, y;
+			switch (GetSize(rest)) {
+			case 0:
+				y = (ones & 1) ? State::S1 : State::S0;
+				x = (ones >> 1) ? State::S1 : State::S0;
+				break;
+			case 1:
+				y = (ones == 1) ? NotGate(NEW_ID_SUFFIX(bit_name), rest[0]) : rest[0];
+				x = (ones == 0) ? SigBit(State::S0) : (ones == 2) ? SigBit(State::S1) : rest[0];
+				break;
+			case 2:
+				if (ones) {
+					y = XnorGate(NEW_ID_SUFFIX(bit_name), rest[0], rest[1]);
+					x = OrGate(NEW_ID_SUFFIX(bit_name), rest[0], rest[1]);
+				} else {
+					y = XorGate(NEW_ID_SUFFIX(bit_name), rest[0], rest[1]);
+					x = AndGate(NEW_ID_SUFFIX(bit_name), rest[0], rest[1]);
+				}
+				break;
+			default:
+				mod->addFa(bit_name, sig_a[i], sig_b[i], sig_c[i], sig_x[i], sig_y[i], src);
+				continue;
+			}
+			mod->connect(sig_x[i], x);
+			mod->connect(sig_y[i], y);
+		}
 	}
 
 	void run()
@@ -303,6 +435,10 @@ struct BoothPassWorker {
 		for (auto &s : summands)
 			s.extend_u0(width);
 
+		// rows that folded away to all-zero constants contribute nothing
+		summands.erase(std::remove_if(summands.begin(), summands.end(),
+				[](const SigSpec &s) { return s.is_fully_zero(); }), summands.end());
+
 		while (summands.size() > 2) {
 			std::vector<SigSpec> new_summands;
 			int i;
@@ -441,11 +577,11 @@ struct BoothPassWorker {
 
 		// append the sign bits
 		if (is_signed) {
-			SigBit e = module->XorGate(NEW_ID, s_int[0], module->AndGate(NEW_ID, X.msb(), module->OrGate(NEW_ID, two_int[0], one_int[0])));
-			ppij_vec.append({module->NotGate(NEW_ID, e), e, e});
+			SigBit e = XorGate(NEW_ID, s_int[0], AndGate(NEW_ID, X.msb(), OrGate(NEW_ID, two_int[0], one_int[0])));
+			ppij_vec.append({NotGate(NEW_ID, e), e, e});
 		} else {
 			// append the sign bits
-			ppij_vec.append({module->NotGate(NEW_ID, s_int[0]), s_int[0], s_int[0]});
+			ppij_vec.append({NotGate(NEW_ID, s_int[0]), s_int[0], s_int[0]});
 		}
 	}
 
@@ -475,7 +611,7 @@ struct BoothPassWorker {
 				     					one_int, two_int, s_int));
 		}
 
-		ppij_vec.append(!is_signed ? sb_int[0] : module->XorGate(NEW_ID, sb_int, module->AndGate(NEW_ID, X.msb(), module->OrGate(NEW_ID, two_int, one_int))));
+		ppij_vec.append(!is_signed ? sb_int[0] : XorGate(NEW_ID, sb_int, AndGate(NEW_ID, X.msb(), OrGate(NEW_ID, two_int, one_int))));
 		ppij_vec.append(State::S1);
 	}
 
@@ -1082,8 +1218,8 @@ struct BoothPassWorker {
 		// full adder creation
 		// base case: 1st row: Inputs from decoders
 		// 1st row exception: two localized inverters due to sign extension structure
-		SigBit d08_inv = module->NotGate(NEW_ID_SUFFIX("bfa_0_exc_inv1"), PPij[(0 * dec_count) + dec_count - 1]);
-		SigBit d18_inv = module->NotGate(NEW_ID_SUFFIX("bfa_0_exc_inv2"), PPij[(1 * dec_count) + dec_count - 1]);
+		SigBit d08_inv = NotGate(NEW_ID_SUFFIX("bfa_0_exc_inv1"), PPij[(0 * dec_count) + dec_count - 1]);
+		SigBit d18_inv = NotGate(NEW_ID_SUFFIX("bfa_0_exc_inv2"), PPij[(1 * dec_count) + dec_count - 1]);
 		BuildBitwiseFa(module, NEW_ID_SUFFIX("fa_row_0").str(),
 			/* A */ {State::S0, d08_inv, PPij[(0 * dec_count) + x_sz], PPij.extract((0 * dec_count) + 2, x_sz - 1)},
 			/* B */ {State::S1, d18_inv, PPij.extract((1 * dec_count), x_sz)},
@@ -1097,7 +1233,7 @@ struct BoothPassWorker {
 		// special because these are driven by a decoder and prior fa.
 		for (fa_row_ix = 1; fa_row_ix < fa_row_count; fa_row_ix++) {
 			// end two bits: sign extension
-			SigBit d_inv = module->NotGate(NEW_ID_SUFFIX(stringf("bfa_se_inv_%d_L", fa_row_ix)),
+			SigBit d_inv = NotGate(NEW_ID_SUFFIX(stringf("bfa_se_inv_%d_L", fa_row_ix)),
 						       PPij[((fa_row_ix + 1) * dec_count) + dec_count - 1]);
 
 			BuildBitwiseFa(module, NEW_ID_SUFFIX(stringf("fa_row_%d", fa_row_ix)).str(),
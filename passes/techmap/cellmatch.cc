@@ -63,12 +63,22 @@ uint64_t permute_lut(uint64_t lut, const std::vector<int> &varmap)
 	return ret;
 }
 
+// Cache of canonical representatives found by p_class(). The representative
+// is a pure function of (k, lut), so the cache persists across pass
+// invocations; cell libraries typically contain many functionally identical
+// cells, which all hit the same entry instead of redoing the k! search.
+static dict<std::pair<int, uint64_t>, uint64_t> p_class_cache;
+
 // Find the LUT with the minimum integer representation
 // such that it is a permutation of the given lut.
 // The resulting LUT becomes the "fingerprint" of the "permutation class".
 // This function checks all possible input permutations.
 uint64_t p_class(int k, uint64_t lut)
 {
+	auto cached = p_class_cache.insert(std::make_pair(k, lut));
+	if (!cached.second)
+		return cached.first->second;
+
 	std::vector<int> map;
 	for (int j = 0; j < k; j++)
 		map.push_back(j);
@@ -84,6 +94,8 @@ uint64_t p_class(int k, uint64_t lut)
 		if (!std::next_permutation(map.begin(), map.end()))
 			break;
 	}
+
+	cached.first->second = repr;
 	return repr;
 }
 
@@ -114,6 +126,7 @@ bool derive_module_luts(Module *m, std::vector<uint64_t> &luts)
 	luts.resize(noutputs);
 
 	ConstEval ceval(m);
+	ceval.eval_cache_enabled = true;
 	for (int i = 0; i < 1 << ninputs; i++) {
 		ceval.clear();
 		for (int j = 0; j < ninputs; j++)
@@ -251,6 +264,12 @@ struct CellmatchPass : Pass {
 				bool found_match = false;
 				// For each input_map
 				while (!found_match) {
+					// The permuted target LUTs only depend on input_map,
+					// not on output_map, so permute them once up front
+					std::vector<uint64_t> permuted_luts;
+					for (auto lut : target.luts)
+						permuted_luts.push_back(permute_lut(lut, input_map));
+
 					std::vector<int> output_map;
 					for (int i = 0; i < outputs.size(); i++)
 						output_map.push_back(i);
@@ -260,7 +279,7 @@ struct CellmatchPass : Pass {
 						int out_no = 0;
 						bool match = true;
 						for (auto lut : luts) {
-							if (permute_lut(target.luts[output_map[out_no++]], input_map) != lut) {
+							if (permuted_luts[output_map[out_no++]] != lut) {
 								match = false;
 								break;
 							}
@@ -179,6 +179,13 @@ struct DffLegalizePass : public Pass {
 	dict<SigBit, int> ce_used;
 	dict<SigBit, int> srst_used;
 
+	// Decision cache for the already-legal fast path in legalize_ff().  For
+	// fine FF cells the whole legalization decision is determined by the
+	// cell type (which encodes the FF functions, polarities and reset
+	// values) together with the init value class, so it is computed once
+	// per (type, init) pair and invocation.
+	dict<std::pair<IdString, int>, bool> legal_asis_cache;
+
 	SigMap sigmap;
 	FfInitVals initvals;
 
@@ -885,6 +892,38 @@ struct DffLegalizePass : public Pass {
 		}
 	}
 
+	// Whether the FF is supported by the target exactly as it is, so that
+	// legalize_ff() may keep the cell untouched.
+	bool is_legal_asis(FfData &ff) {
+		int ff_type = get_ff_type(ff);
+		int initmask = get_initmask(ff);
+		int ff_neg = 0;
+		if (ff.has_sr) {
+			if (!ff.pol_clr)
+				ff_neg |= NEG_R;
+			if (!ff.pol_set)
+				ff_neg |= NEG_S;
+		}
+		if (ff.has_arst && !ff.pol_arst)
+			ff_neg |= NEG_R;
+		if (ff.has_srst && !ff.pol_srst)
+			ff_neg |= NEG_R;
+		if (ff.has_aload && !ff.pol_aload)
+			ff_neg |= NEG_L;
+		if (ff.has_clk && !ff.pol_clk)
+			ff_neg |= NEG_C;
+		if (ff.has_ce && !ff.pol_ce)
+			ff_neg |= NEG_CE;
+		if (!(supported_cells_neg[ff_type][ff_neg] & initmask))
+			return false;
+		// fixup_reset_x() would patch undefined reset values
+		if (ff.has_arst && ff.val_arst[0] == State::Sx)
+			return false;
+		if (ff.has_srst && ff.val_srst[0] == State::Sx)
+			return false;
+		return true;
+	}
+
 	void legalize_ff(FfData &ff) {
 		if (ff.has_gclk)
 			return;
@@ -893,10 +932,34 @@ struct DffLegalizePass : public Pass {
 		if (!ff.is_fine)
 			return;
 
-		if (mince && ff.has_ce && ff.sig_ce[0].wire && ce_used[ff.sig_ce[0]] < mince)
+		bool unmapped = false;
+		if (mince && ff.has_ce && ff.sig_ce[0].wire && ce_used[ff.sig_ce[0]] < mince) {
 			ff.unmap_ce();
-		if (minsrst && ff.has_srst && ff.sig_srst[0].wire && srst_used[ff.sig_srst[0]] < minsrst)
+			unmapped = true;
+		}
+		if (minsrst && ff.has_srst && ff.sig_srst[0].wire && srst_used[ff.sig_srst[0]] < minsrst) {
 			ff.unmap_srst();
+			unmapped = true;
+		}
+
+		// Fast path: on large designs most FFs are usually supported as
+		// they are, and sending them through the full decision chain
+		// removes and re-creates the identical cell.  The decision is
+		// cached, so each (type, init) pair pays for it only once.  An FF
+		// that just lost its enable or reset no longer matches its cell
+		// type and has to be re-emitted in any case.
+		if (ff.cell != nullptr && !unmapped) {
+			int initclass = 2;
+			if (ff.val_init[0] == State::S0)
+				initclass = 0;
+			else if (ff.val_init[0] == State::S1)
+				initclass = 1;
+			auto r = legal_asis_cache.insert(std::make_pair(ff.cell->type, initclass));
+			if (r.second)
+				r.first->second = is_legal_asis(ff);
+			if (r.first->second)
+				return;
+		}
 
 		if (ff.has_clk) {
 			if (ff.has_sr) {
@@ -1021,6 +1084,7 @@ struct DffLegalizePass : public Pass {
 				supported_cells_neg[i][j] = 0;
 			supported_cells[i] = 0;
 		}
+		legal_asis_cache.clear();
 		mince = design->scratchpad_get_int("dfflegalize.mince", 0);
 		minsrst = design->scratchpad_get_int("dfflegalize.minsrst", 0);
 
@@ -1219,6 +1283,7 @@ unrecognized:
 		initvals.clear();
 		ce_used.clear();
 		srst_used.clear();
+		legal_asis_cache.clear();
 	}
 } DffLegalizePass;
 
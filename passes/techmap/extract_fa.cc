@@ -80,9 +80,24 @@ struct ExtractFaWorker
 	dict<int, func2_and_info_t> func2_and_info;
 	dict<int, func3_maj_info_t> func3_maj_info;
 
+	// Packed truth-table cone evaluation: each signal in a cone is described
+	// by an 8-bit truth table over the (at most 3) leaf bits, one table bit
+	// per leaf input assignment, plus a mask of the assignments where the
+	// value is defined (not x). Evaluating the cone once bit-parallel
+	// replaces one ConstEval netlist walk per input assignment.
+	struct ConeValue {
+		uint8_t val, def;
+	};
+
+	dict<SigBit, ConeValue> cone_cache;
+	pool<SigBit> cone_busy;
+	bool cone_eval_ok;
+
 	ExtractFaWorker(const ExtractFaConfig &config, Module *module) :
 			config(config), module(module), ce(module), sigmap(ce.assign_map)
 	{
+		ce.eval_cache_enabled = true;
+
 		for (auto cell : module->selected_cells())
 		{
 			if (cell->type.in( ID($_BUF_), ID($_NOT_), ID($_AND_), ID($_NAND_), ID($_OR_), ID($_NOR_),
@@ -153,38 +168,172 @@ struct ExtractFaWorker
 		}
 	}
 
-	void check_partition(SigBit root, pool<SigBit> &leaves)
+	static ConeValue cone_not(ConeValue a)
 	{
-		if (config.enable_ha && GetSize(leaves) == 2)
-		{
-			leaves.sort();
+		return ConeValue{uint8_t(~a.val & a.def), a.def};
+	}
 
-			SigBit A = SigSpec(leaves)[0];
-			SigBit B = SigSpec(leaves)[1];
+	static ConeValue cone_and(ConeValue a, ConeValue b)
+	{
+		uint8_t ones = a.val & b.val;
+		uint8_t zeros = (a.def & ~a.val) | (b.def & ~b.val);
+		return ConeValue{ones, uint8_t(ones | zeros)};
+	}
 
-			int func = 0;
-			for (int i = 0; i < 4; i++)
-			{
-				bool a_value = (i & 1) != 0;
-				bool b_value = (i & 2) != 0;
+	static ConeValue cone_or(ConeValue a, ConeValue b)
+	{
+		uint8_t ones = a.val | b.val;
+		uint8_t zeros = (a.def & ~a.val) & (b.def & ~b.val);
+		return ConeValue{ones, uint8_t(ones | zeros)};
+	}
 
-				ce.push();
-				ce.set(A, a_value ? State::S1 : State::S0);
-				ce.set(B, b_value ? State::S1 : State::S0);
+	static ConeValue cone_xor(ConeValue a, ConeValue b)
+	{
+		uint8_t def = a.def & b.def;
+		return ConeValue{uint8_t((a.val ^ b.val) & def), def};
+	}
 
-				SigSpec sig = root;
+	static ConeValue cone_mux(ConeValue a, ConeValue b, ConeValue s)
+	{
+		uint8_t sel0 = s.def & ~s.val;
+		uint8_t sel1 = s.def & s.val;
+		uint8_t selx = ~s.def;
+		uint8_t def = (sel0 & a.def) | (sel1 & b.def) | (selx & a.def & b.def & ~(a.val ^ b.val));
+		uint8_t val = ((sel0 & a.val) | (sel1 & b.val) | (selx & a.val & b.val)) & def;
+		return ConeValue{val, def};
+	}
 
-				if (!ce.eval(sig)) {
-					ce.pop();
-					return;
-				}
+	// Recursively evaluate the packed truth table for `bit` towards the
+	// seeded leaf bits. Cones that cannot be resolved within the supported
+	// gate set (or that loop) clear cone_eval_ok; the caller then falls
+	// back to per-assignment ConstEval.
+	ConeValue eval_cone(SigBit bit)
+	{
+		if (bit.wire == nullptr) {
+			if (bit == State::S0)
+				return ConeValue{0x00, 0xff};
+			if (bit == State::S1)
+				return ConeValue{0xff, 0xff};
+			return ConeValue{0x00, 0x00};
+		}
+
+		auto it = cone_cache.find(bit);
+		if (it != cone_cache.end())
+			return it->second;
+
+		ConeValue result = {0x00, 0x00};
+
+		if (driver.count(bit) == 0 || cone_busy.count(bit) != 0) {
+			cone_eval_ok = false;
+			return result;
+		}
+
+		cone_busy.insert(bit);
+
+		Cell *cell = driver.at(bit);
+		auto inport = [&](IdString name) { return eval_cone(sigmap(SigBit(cell->getPort(name)))); };
+
+		if (cell->type == ID($_BUF_))
+			result = inport(ID::A);
+		else if (cell->type == ID($_NOT_))
+			result = cone_not(inport(ID::A));
+		else if (cell->type == ID($_AND_))
+			result = cone_and(inport(ID::A), inport(ID::B));
+		else if (cell->type == ID($_NAND_))
+			result = cone_not(cone_and(inport(ID::A), inport(ID::B)));
+		else if (cell->type == ID($_OR_))
+			result = cone_or(inport(ID::A), inport(ID::B));
+		else if (cell->type == ID($_NOR_))
+			result = cone_not(cone_or(inport(ID::A), inport(ID::B)));
+		else if (cell->type == ID($_XOR_))
+			result = cone_xor(inport(ID::A), inport(ID::B));
+		else if (cell->type == ID($_XNOR_))
+			result = cone_not(cone_xor(inport(ID::A), inport(ID::B)));
+		else if (cell->type == ID($_ANDNOT_))
+			result = cone_and(inport(ID::A), cone_not(inport(ID::B)));
+		else if (cell->type == ID($_ORNOT_))
+			result = cone_or(inport(ID::A), cone_not(inport(ID::B)));
+		else if (cell->type == ID($_MUX_))
+			result = cone_mux(inport(ID::A), inport(ID::B), inport(ID::S));
+		else if (cell->type == ID($_NMUX_))
+			result = cone_not(cone_mux(inport(ID::A), inport(ID::B), inport(ID::S)));
+		else if (cell->type == ID($_AOI3_))
+			result = cone_not(cone_or(cone_and(inport(ID::A), inport(ID::B)), inport(ID::C)));
+		else if (cell->type == ID($_OAI3_))
+			result = cone_not(cone_and(cone_or(inport(ID::A), inport(ID::B)), inport(ID::C)));
+		else if (cell->type == ID($_AOI4_))
+			result = cone_not(cone_or(cone_and(inport(ID::A), inport(ID::B)), cone_and(inport(ID::C), inport(ID::D))));
+		else if (cell->type == ID($_OAI4_))
+			result = cone_not(cone_and(cone_or(inport(ID::A), inport(ID::B)), cone_or(inport(ID::C), inport(ID::D))));
+		else
+			cone_eval_ok = false;
+
+		cone_busy.erase(bit);
+		cone_cache[bit] = result;
+		return result;
+	}
+
+	// Compute the packed truth table of `root` over the given leaf bits
+	// (bit i of `func` is the value of root under the i-th leaf assignment,
+	// with x counted as 0 like in the ConstEval version below).
+	bool eval_cone_func(SigBit root, const std::vector<SigBit> &leaf_bits, int &func)
+	{
+		static const uint8_t patterns[3] = {0xaa, 0xcc, 0xf0};
+
+		cone_cache.clear();
+		cone_busy.clear();
+		cone_eval_ok = true;
+
+		for (int i = 0; i < GetSize(leaf_bits); i++)
+			cone_cache[leaf_bits[i]] = ConeValue{patterns[i], 0xff};
+
+		ConeValue v = eval_cone(root);
+		if (!cone_eval_ok)
+			return false;
+
+		func = v.val & v.def & ((1 << (1 << GetSize(leaf_bits))) - 1);
+		return true;
+	}
+
+	// ConstEval fallback for cones eval_cone() cannot handle, e.g. a mux
+	// select driven by a cell outside the supported gate set
+	bool eval_cone_func_ce(SigBit root, const std::vector<SigBit> &leaf_bits, int &func)
+	{
+		func = 0;
+		for (int i = 0; i < (1 << GetSize(leaf_bits)); i++)
+		{
+			ce.push();
+			for (int k = 0; k < GetSize(leaf_bits); k++)
+				ce.set(leaf_bits[k], (i & (1 << k)) ? State::S1 : State::S0);
 
-				if (sig == State::S1)
-					func |= 1 << i;
+			SigSpec sig = root;
 
+			if (!ce.eval(sig)) {
 				ce.pop();
+				return false;
 			}
 
+			if (sig == State::S1)
+				func |= 1 << i;
+
+			ce.pop();
+		}
+		return true;
+	}
+
+	void check_partition(SigBit root, pool<SigBit> &leaves)
+	{
+		if (config.enable_ha && GetSize(leaves) == 2)
+		{
+			leaves.sort();
+
+			SigBit A = SigSpec(leaves)[0];
+			SigBit B = SigSpec(leaves)[1];
+
+			int func = 0;
+			if (!eval_cone_func(root, {A, B}, func) && !eval_cone_func_ce(root, {A, B}, func))
+				return;
+
 			// log("%04d %s %s -> %s\n", bindec(func), log_signal(A), log_signal(B), log_signal(root));
 
 			if (func == xor2_func || func == xnor2_func)
@@ -203,29 +352,8 @@ struct ExtractFaWorker
 			SigBit C = SigSpec(leaves)[2];
 
 			int func = 0;
-			for (int i = 0; i < 8; i++)
-			{
-				bool a_value = (i & 1) != 0;
-				bool b_value = (i & 2) != 0;
-				bool c_value = (i & 4) != 0;
-
-				ce.push();
-				ce.set(A, a_value ? State::S1 : State::S0);
-				ce.set(B, b_value ? State::S1 : State::S0);
-				ce.set(C, c_value ? State::S1 : State::S0);
-
-				SigSpec sig = root;
-
-				if (!ce.eval(sig)) {
-					ce.pop();
-					return;
-				}
-
-				if (sig == State::S1)
-					func |= 1 << i;
-
-				ce.pop();
-			}
+			if (!eval_cone_func(root, {A, B, C}, func) && !eval_cone_func_ce(root, {A, B, C}, func))
+				return;
 
 			// log("%08d %s %s %s -> %s\n", bindec(func), log_signal(A), log_signal(B), log_signal(C), log_signal(root));
 
@@ -28,23 +28,43 @@
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
-IdString concat_name(RTLIL::Cell *cell, IdString object_name)
+// Builds hierarchical names for the objects of one flattened cell instance.
+// The two possible instance prefixes ("<cell>." and "$flatten<cell>.") are
+// built once per cell and per-object names are appended into a reused buffer,
+// instead of going through stringf() for every wire, cell, memory and process
+// of the template module.
+struct HierNameBuilder
 {
-	if (object_name[0] == '\\')
-		return stringf("%s.%s", cell->name.c_str(), object_name.c_str() + 1);
-	else {
-		std::string object_name_str = object_name.str();
-		if (object_name_str.substr(0, 8) == "$flatten")
-			object_name_str.erase(0, 8);
-		return stringf("$flatten%s.%s", cell->name.c_str(), object_name_str.c_str());
+	RTLIL::Cell *cell;
+	std::string public_prefix, private_prefix, buffer;
+
+	HierNameBuilder(RTLIL::Cell *cell) : cell(cell)
+	{
+		public_prefix = cell->name.str() + ".";
+		private_prefix = "$flatten" + cell->name.str() + ".";
 	}
-}
 
-template<class T>
-IdString map_name(RTLIL::Cell *cell, T *object)
-{
-	return cell->module->uniquify(concat_name(cell, object->name));
-}
+	IdString concat_name(IdString object_name)
+	{
+		if (object_name[0] == '\\') {
+			buffer = public_prefix;
+			buffer += object_name.c_str() + 1;
+		} else {
+			buffer = private_prefix;
+			const char *suffix = object_name.c_str();
+			if (object_name.begins_with("$flatten"))
+				suffix += 8;
+			buffer += suffix;
+		}
+		return buffer;
+	}
+
+	template<class T>
+	IdString map_name(T *object)
+	{
+		return cell->module->uniquify(concat_name(object->name));
+	}
+};
 
 void map_sigspec(const dict<RTLIL::Wire*, RTLIL::Wire*> &map, RTLIL::SigSpec &sig, RTLIL::Module *into = nullptr)
 {
@@ -111,15 +131,22 @@ struct FlattenWorker
 	{
 		// Copy the contents of the flattened cell
 
+		HierNameBuilder names(cell);
+
+		// Pre-size the destination containers so flattening a large child
+		// module doesn't grow the hash tables one object at a time.
+		module->reserve(GetSize(tpl->wires()), GetSize(tpl->cells()));
+
 		dict<IdString, IdString> memory_map;
 		for (auto &tpl_memory_it : tpl->memories) {
-			RTLIL::Memory *new_memory = module->addMemory(map_name(cell, tpl_memory_it.second), tpl_memory_it.second);
+			RTLIL::Memory *new_memory = module->addMemory(names.map_name(tpl_memory_it.second), tpl_memory_it.second);
 			map_attributes(cell, new_memory, tpl_memory_it.second->name);
 			memory_map[tpl_memory_it.first] = new_memory->name;
 			design->select(module, new_memory);
 		}
 
 		dict<RTLIL::Wire*, RTLIL::Wire*> wire_map;
+		wire_map.reserve(GetSize(tpl->wires()));
 		dict<IdString, IdString> positional_ports;
 		for (auto tpl_wire : tpl->wires()) {
 			if (tpl_wire->port_id > 0)
@@ -127,7 +154,7 @@ struct FlattenWorker
 
 			RTLIL::Wire *new_wire = nullptr;
 			if (tpl_wire->name[0] == '\\') {
-				RTLIL::Wire *hier_wire = module->wire(concat_name(cell, tpl_wire->name));
+				RTLIL::Wire *hier_wire = module->wire(names.concat_name(tpl_wire->name));
 				if (hier_wire != nullptr && hier_wire->get_bool_attribute(ID::hierconn)) {
 					hier_wire->attributes.erase(ID::hierconn);
 					if (GetSize(hier_wire) < GetSize(tpl_wire)) {
@@ -139,7 +166,7 @@ struct FlattenWorker
 				}
 			}
 			if (new_wire == nullptr) {
-				new_wire = module->addWire(map_name(cell, tpl_wire), tpl_wire);
+				new_wire = module->addWire(names.map_name(tpl_wire), tpl_wire);
 				new_wire->port_input = new_wire->port_output = false;
 				new_wire->port_id = false;
 			}
@@ -150,7 +177,7 @@ struct FlattenWorker
 		}
 
 		for (auto &tpl_proc_it : tpl->processes) {
-			RTLIL::Process *new_proc = module->addProcess(map_name(cell, tpl_proc_it.second), tpl_proc_it.second);
+			RTLIL::Process *new_proc = module->addProcess(names.map_name(tpl_proc_it.second), tpl_proc_it.second);
 			map_attributes(cell, new_proc, tpl_proc_it.second->name);
 			for (auto new_proc_sync : new_proc->syncs)
 				for (auto &memwr_action : new_proc_sync->mem_write_actions)
@@ -161,14 +188,14 @@ struct FlattenWorker
 		}
 
 		for (auto tpl_cell : tpl->cells()) {
-			RTLIL::Cell *new_cell = module->addCell(map_name(cell, tpl_cell), tpl_cell);
+			RTLIL::Cell *new_cell = module->addCell(names.map_name(tpl_cell), tpl_cell);
 			map_attributes(cell, new_cell, tpl_cell->name);
 			if (new_cell->has_memid()) {
 				IdString memid = new_cell->getParam(ID::MEMID).decode_string();
 				new_cell->setParam(ID::MEMID, Const(memory_map.at(memid).str()));
 			} else if (new_cell->is_mem_cell()) {
 				IdString memid = new_cell->getParam(ID::MEMID).decode_string();
-				new_cell->setParam(ID::MEMID, Const(concat_name(cell, memid).str()));
+				new_cell->setParam(ID::MEMID, Const(names.concat_name(memid).str()));
 			}
 			auto rewriter = [&](RTLIL::SigSpec &sig) { map_sigspec(wire_map, sig); };
 			new_cell->rewrite_sigspecs(rewriter);
@@ -678,72 +678,74 @@ struct FlowmapWorker
 				labels[input] = 0;
 		}
 
-		pool<RTLIL::SigBit> worklist = nodes;
-		int debug_num = 0;
-		while (!worklist.empty())
+		// Materialize the edge map entries of every node up-front; the
+		// labeling workers below may only read the shared maps, and
+		// operator[] inserts missing entries.
+		for (auto node : nodes)
 		{
-			auto sink = worklist.pop();
-			if (labels[sink] != -1)
-				continue;
-
-			bool inputs_have_labels = true;
-			for (auto sink_input : edges_bw[sink])
-			{
-				if (labels[sink_input] == -1)
-				{
-					inputs_have_labels = false;
-					break;
-				}
-			}
-			if (!inputs_have_labels)
-				continue;
-
-			if (debug)
-			{
-				debug_num++;
-				log("Examining subgraph %d rooted in %s.\n", debug_num, log_signal(sink));
-			}
+			edges_bw[node];
+			edges_fw[node];
+		}
 
-			pool<RTLIL::SigBit> subgraph = find_subgraph(sink);
+		struct label_result
+		{
+			RTLIL::SigBit sink;
+			int label;
+			pool<RTLIL::SigBit> lut_gates;
+			pool<RTLIL::SigBit> lut_inputs;
+		};
 
+		auto label_node = [&](RTLIL::SigBit sink, label_result &result, int debug_num)
+		{
+			// In the original FlowMap labeling, p is the maximum label in the
+			// entire fan-in cone of sink. Labels are monotone along edges
+			// (every node gets a label at least as high as any node in its
+			// cone), so the maximum over the direct predecessors is the same
+			// value and the cone only needs to be traversed for the flow
+			// computation itself.
 			int p = 1;
-			for (auto subgraph_node : subgraph)
-				p = max(p, labels[subgraph_node]);
+			for (auto sink_input : edges_bw.at(sink))
+				p = max(p, labels.at(sink_input));
 
 			FlowGraph flow_graph = build_flow_graph(sink, p);
 			int flow = flow_graph.maximum_flow(order);
 			pool<RTLIL::SigBit> x, xi;
 			if (flow <= order)
 			{
-				labels[sink] = p;
+				result.label = p;
 				auto cut = flow_graph.edge_cut();
 				x = cut.first;
 				xi = cut.second;
 			}
 			else
 			{
-				labels[sink] = p + 1;
-				x = subgraph;
-				x.erase(sink);
+				// the trivial cut; every direct predecessor of sink is on
+				// the X side, so it is not materialized in full here
+				result.label = p + 1;
+				for (auto sink_input : edges_bw.at(sink))
+					x.insert(sink_input);
 				xi.insert(sink);
 			}
-			lut_gates[sink] = xi;
+			result.lut_gates = xi;
 
 			pool<RTLIL::SigBit> k;
 			for (auto xi_node : xi)
 			{
-				for (auto xi_node_pred : edges_bw[xi_node])
+				for (auto xi_node_pred : edges_bw.at(xi_node))
 					if (x[xi_node_pred])
 						k.insert(xi_node_pred);
 			}
 			log_assert((int)k.size() <= order);
-			lut_edges_bw[sink] = k;
-			for (auto k_node : k)
-				lut_edges_fw[k_node].insert(sink);
+			result.lut_inputs = k;
 
 			if (debug)
 			{
-				log("  Maximum flow: %d. Assigned label %d.\n", flow, labels[sink]);
+				log("  Maximum flow: %d. Assigned label %d.\n", flow, result.label);
+				pool<RTLIL::SigBit> subgraph = find_subgraph(sink);
+				if (flow > order) {
+					x = subgraph;
+					x.erase(sink);
+				}
 				dump_dot_graph(stringf("flowmap-%d-sub.dot", debug_num), GraphMode::Cut, subgraph, {}, {}, {x, xi});
 				log("  Dumped subgraph to `flowmap-%d-sub.dot`.\n", debug_num);
 				flow_graph.dump_dot_graph(stringf("flowmap-%d-flow.dot", debug_num));
@@ -757,9 +759,59 @@ struct FlowmapWorker
 					log(" %s", log_signal(xi_node));
 				log(".\n");
 			}
+		};
+
+		// Nodes are labeled in topologically sorted waves: all nodes of one
+		// wave have labeled predecessors only, so their labels and cuts
+		// depend just on the committed state of earlier waves and can be
+		// computed independently of each other. The results are committed
+		// in a fixed order afterwards, keeping the outcome identical to a
+		// sequential run.
+		dict<RTLIL::SigBit, int> unlabeled_preds;
+		vector<RTLIL::SigBit> wave;
+		for (auto node : nodes)
+		{
+			if (labels.at(node) != -1)
+				continue;
+			int count = 0;
+			for (auto node_pred : edges_bw.at(node))
+				if (labels.at(node_pred) == -1)
+					count++;
+			unlabeled_preds[node] = count;
+			if (count == 0)
+				wave.push_back(node);
+		}
+
+		int debug_num = 0;
+		while (!wave.empty())
+		{
+			std::vector<label_result> results(GetSize(wave));
+
+			if (debug) {
+				// the workers log in debug mode, so run them one at a time
+				for (int i = 0; i < GetSize(wave); i++) {
+					debug_num++;
+					log("Examining subgraph %d rooted in %s.\n", debug_num, log_signal(wave[i]));
+					label_node(wave[i], results[i], debug_num);
+				}
+			} else
+				ThreadPool::get().parallel_for(GetSize(wave), [&](int i) { label_node(wave[i], results[i], 0); });
 
-			for (auto sink_succ : edges_fw[sink])
-				worklist.insert(sink_succ);
+			vector<RTLIL::SigBit> next_wave;
+			for (int i = 0; i < GetSize(wave); i++)
+			{
+				RTLIL::SigBit sink = wave[i];
+				labels[sink] = results[i].label;
+				lut_gates[sink] = std::move(results[i].lut_gates);
+				lut_edges_bw[sink] = results[i].lut_inputs;
+				for (auto k_node : results[i].lut_inputs)
+					lut_edges_fw[k_node].insert(sink);
+
+				for (auto sink_succ : edges_fw.at(sink))
+					if (labels.at(sink_succ) == -1 && --unlabeled_preds.at(sink_succ) == 0)
+						next_wave.push_back(sink_succ);
+			}
+			wave = std::move(next_wave);
 		}
 
 		if (debug)
@@ -1343,6 +1395,7 @@ struct FlowmapWorker
 	void pack_cells(int minlut)
 	{
 		ConstEval ce(module);
+		ce.eval_cache_enabled = true;
 		for (auto input_node : inputs)
 			ce.stop(input_node);
 
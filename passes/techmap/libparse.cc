@@ -348,6 +348,184 @@ LibertyAst *LibertyParser::parse()
 	return ast;
 }
 
+// ---- binary AST cache ----------------------------------------------------
+//
+// Re-parsing big liberty files dominates short runs, so LibertyParser can
+// keep a pre-parsed binary sidecar next to the source file. The cache header
+// records a format magic/version and a hash of the liberty file contents;
+// loads that fail any of those checks (or any bounds check while decoding)
+// silently fall back to regular parsing, after which the cache is rewritten.
+// Concurrent jobs racing on the same cache file are safe: writers go through
+// a temporary file plus rename, and a reader seeing a torn file just
+// reparses. Only the std library is used here so the standalone filterlib
+// build keeps working.
+
+static const char liberty_cache_magic[9] = "YsLibC01";
+
+static bool liberty_cache_hash_file(const std::string &filename, uint64_t &hash)
+{
+	std::ifstream f(filename.c_str(), std::ifstream::binary);
+	if (f.fail())
+		return false;
+
+	hash = 0xcbf29ce484222325ull;
+	char buffer[65536];
+	while (1) {
+		f.read(buffer, sizeof(buffer));
+		std::streamsize n = f.gcount();
+		if (n <= 0)
+			break;
+		for (std::streamsize i = 0; i < n; i++)
+			hash = (hash ^ (unsigned char)buffer[i]) * 0x100000001b3ull;
+	}
+	return !f.bad();
+}
+
+static void liberty_cache_write_string(std::ostream &f, const std::string &str)
+{
+	uint32_t n = str.size();
+	f.write((char*)&n, sizeof(n));
+	f.write(str.data(), n);
+}
+
+static void liberty_cache_write_node(std::ostream &f, const LibertyAst *ast)
+{
+	liberty_cache_write_string(f, ast->id);
+	liberty_cache_write_string(f, ast->value);
+
+	uint32_t num_args = ast->args.size();
+	f.write((char*)&num_args, sizeof(num_args));
+	for (auto &arg : ast->args)
+		liberty_cache_write_string(f, arg);
+
+	uint32_t num_children = ast->children.size();
+	f.write((char*)&num_children, sizeof(num_children));
+	for (auto child : ast->children)
+		liberty_cache_write_node(f, child);
+}
+
+static void liberty_cache_save(const std::string &path, uint64_t hash, const LibertyAst *ast)
+{
+	std::string tmp_path = path + ".new";
+	std::ofstream f(tmp_path.c_str(), std::ofstream::binary | std::ofstream::trunc);
+	if (f.fail())
+		return;
+
+	f.write(liberty_cache_magic, sizeof(liberty_cache_magic)-1);
+	f.write((char*)&hash, sizeof(hash));
+	liberty_cache_write_node(f, ast);
+	f.close();
+
+	if (f.fail() || std::rename(tmp_path.c_str(), path.c_str()) != 0)
+		std::remove(tmp_path.c_str());
+}
+
+struct LibertyCacheReader
+{
+	const char *p, *end;
+
+	bool read_raw(void *data, size_t n)
+	{
+		if (size_t(end - p) < n)
+			return false;
+		memcpy(data, p, n);
+		p += n;
+		return true;
+	}
+
+	bool read_string(std::string &str)
+	{
+		uint32_t n;
+		if (!read_raw(&n, sizeof(n)) || size_t(end - p) < n)
+			return false;
+		str.assign(p, n);
+		p += n;
+		return true;
+	}
+
+	LibertyAst *read_node()
+	{
+		LibertyAst *ast = new LibertyAst;
+
+		uint32_t num_args, num_children;
+		if (!read_string(ast->id) || !read_string(ast->value) || !read_raw(&num_args, sizeof(num_args)))
+			goto failed;
+
+		for (uint32_t i = 0; i < num_args; i++) {
+			ast->args.emplace_back();
+			if (!read_string(ast->args.back()))
+				goto failed;
+		}
+
+		if (!read_raw(&num_children, sizeof(num_children)))
+			goto failed;
+
+		for (uint32_t i = 0; i < num_children; i++) {
+			LibertyAst *child = read_node();
+			if (child == nullptr)
+				goto failed;
+			ast->children.push_back(child);
+		}
+
+		return ast;
+
+	failed:
+		delete ast;
+		return nullptr;
+	}
+};
+
+static LibertyAst *liberty_cache_load(const std::string &path, uint64_t hash)
+{
+	std::ifstream f(path.c_str(), std::ifstream::binary);
+	if (f.fail())
+		return nullptr;
+
+	std::stringstream ss;
+	ss << f.rdbuf();
+	if (f.bad())
+		return nullptr;
+	std::string data = ss.str();
+
+	LibertyCacheReader reader;
+	reader.p = data.data();
+	reader.end = data.data() + data.size();
+
+	char magic[sizeof(liberty_cache_magic)-1];
+	uint64_t file_hash;
+	if (!reader.read_raw(magic, sizeof(magic)) || memcmp(magic, liberty_cache_magic, sizeof(magic)) != 0)
+		return nullptr;
+	if (!reader.read_raw(&file_hash, sizeof(file_hash)) || file_hash != hash)
+		return nullptr;
+
+	LibertyAst *ast = reader.read_node();
+	if (ast != nullptr && reader.p != reader.end) {
+		delete ast;
+		return nullptr;
+	}
+	return ast;
+}
+
+LibertyParser::LibertyParser(std::istream &f, const std::string &filename) : f(f), line(1), ast(nullptr)
+{
+	const char *cache_env = getenv("YOSYS_LIBERTY_CACHE");
+	bool cache_enabled = cache_env != nullptr && *cache_env != 0 && strcmp(cache_env, "0") != 0;
+
+	uint64_t hash = 0;
+	if (cache_enabled && liberty_cache_hash_file(filename, hash)) {
+		std::string cache_path = filename + ".libcache";
+		ast = liberty_cache_load(cache_path, hash);
+		if (ast != nullptr)
+			return;
+		ast = parse();
+		if (ast != nullptr)
+			liberty_cache_save(cache_path, hash, ast);
+		return;
+	}
+
+	ast = parse();
+}
+
 #ifndef FILTERLIB
 
 void LibertyParser::error()
@@ -60,6 +60,15 @@ namespace Yosys
 		const LibertyAst *ast;
 
 		LibertyParser(std::istream &f) : f(f), line(1), ast(parse()) {}
+
+		// like the plain constructor, but maintains a pre-parsed binary
+		// sidecar cache ("<filename>.libcache") when enabled through the
+		// YOSYS_LIBERTY_CACHE environment variable. The cache is keyed on a
+		// hash of the file contents plus a format version; on any mismatch
+		// or read problem the file is parsed normally and the cache
+		// rewritten, so stale or corrupt cache files only cost one reparse.
+		LibertyParser(std::istream &f, const std::string &filename);
+
 		~LibertyParser() { if (ast) delete ast; }
 	};
 }
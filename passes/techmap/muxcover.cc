@@ -59,6 +59,7 @@ struct MuxcoverWorker
 	bool use_mux16;
 	bool nodecode;
 	bool nopartial;
+	int64_t abort_time_ns;
 
 	int cost_dmux;
 	int cost_mux2;
@@ -73,6 +74,7 @@ struct MuxcoverWorker
 		use_mux16 = false;
 		nodecode = false;
 		nopartial = false;
+		abort_time_ns = 0;
 		cost_dmux = COST_DMUX;
 		cost_mux2 = COST_MUX2;
 		cost_mux4 = COST_MUX4;
@@ -155,28 +157,6 @@ struct MuxcoverWorker
 		log("    Finished treeification: Found %d trees.\n", GetSize(tree_list));
 	}
 
-	bool follow_muxtree(SigBit &ret_bit, tree_t &tree, SigBit bit, const char *path, bool first_layer = true)
-	{
-		if (*path) {
-			if (tree.muxes.count(bit) == 0) {
-				if (first_layer || nopartial)
-					return false;
-				while (path[0] && path[1])
-					path++;
-				if (path[0] == 'S')
-					ret_bit = State::Sx;
-				else
-					ret_bit = bit;
-				return true;
-			}
-			char port_name[3] = {'\\', *path, 0};
-			return follow_muxtree(ret_bit, tree, sigmap(tree.muxes.at(bit)->getPort(port_name)), path+1, false);
-		} else {
-			ret_bit = bit;
-			return true;
-		}
-	}
-
 	int prepare_decode_mux(SigBit &A, SigBit B, SigBit sel, SigBit bit)
 	{
 		if (A == B || A == State::Sx || B == State::Sx || sel == State::Sx)
@@ -248,29 +228,54 @@ struct MuxcoverWorker
 			return tree.newmuxes.at(bit).cost;
 		}
 
-		SigBit A, B, C, D, E, F, G, H, I, J, K, L, M, N, O, P;
-		SigBit S1, S2, S3, S4, S5, S6, S7, S8;
-		SigBit T1, T2, T3, T4;
-		SigBit U1, U2;
-		SigBit V1;
+		int maxdepth = use_mux16 ? 4 : use_mux8 ? 3 : 2;
+
+		// Expand the local mux subtree once into per-depth node/select
+		// tables instead of re-walking one root-to-leaf path per pattern
+		// position: exp_node[d][i] is the signal at depth-d tree position i
+		// (path bits MSB first) and exp_sel[d][i] the select driving it.
+		// Below a partial subtree edge the node bit is carried down and the
+		// selects are State::Sx. complete[d] is true if all tree positions
+		// above depth d are muxes, which is what -nopartial covers need to
+		// check.
+		SigBit exp_node[5][16];
+		SigBit exp_sel[4][8];
+		bool complete[5];
+
+		exp_node[0][0] = bit;
+		complete[0] = true;
+
+		for (int d = 0; d < maxdepth; d++) {
+			complete[d+1] = complete[d];
+			for (int i = 0; i < (1 << d); i++) {
+				SigBit node_bit = exp_node[d][i];
+				auto it = tree.muxes.find(node_bit);
+				if (it != tree.muxes.end()) {
+					exp_node[d+1][2*i+0] = sigmap(it->second->getPort(ID::A));
+					exp_node[d+1][2*i+1] = sigmap(it->second->getPort(ID::B));
+					exp_sel[d][i] = sigmap(it->second->getPort(ID::S));
+				} else {
+					complete[d+1] = false;
+					exp_node[d+1][2*i+0] = node_bit;
+					exp_node[d+1][2*i+1] = node_bit;
+					exp_sel[d][i] = State::Sx;
+				}
+			}
+		}
+
+		bool root_is_mux = tree.muxes.count(bit) != 0;
 
 		newmux_t best_mux;
-		bool ok = true;
 
 		// 2-Input MUX
 
-		ok = ok && follow_muxtree(A, tree, bit, "A");
-		ok = ok && follow_muxtree(B, tree, bit, "B");
-
-		ok = ok && follow_muxtree(S1, tree, bit, "S");
-
-		if (ok)
+		if (root_is_mux)
 		{
 			newmux_t mux;
 
-			mux.inputs.push_back(A);
-			mux.inputs.push_back(B);
-			mux.selects.push_back(S1);
+			mux.inputs.push_back(exp_node[1][0]);
+			mux.inputs.push_back(exp_node[1][1]);
+			mux.selects.push_back(exp_sel[0][0]);
 
 			find_best_covers(tree, mux.inputs);
 			log_debug("        Decode cost for mux2 at %s: %d\n", log_signal(bit), mux.cost);
@@ -285,29 +290,18 @@ struct MuxcoverWorker
 
 		// 4-Input MUX
 
-		if (use_mux4)
+		if (use_mux4 && root_is_mux && (!nopartial || complete[2]))
 		{
-			ok = ok && follow_muxtree(A, tree, bit, "AA");
-			ok = ok && follow_muxtree(B, tree, bit, "AB");
-			ok = ok && follow_muxtree(C, tree, bit, "BA");
-			ok = ok && follow_muxtree(D, tree, bit, "BB");
-
-			ok = ok && follow_muxtree(S1, tree, bit, "AS");
-			ok = ok && follow_muxtree(S2, tree, bit, "BS");
-
-			if (nodecode)
-				ok = ok && xcmp({S1, S2});
-
-			ok = ok && follow_muxtree(T1, tree, bit, "S");
+			SigBit S1 = exp_sel[1][0];
+			SigBit S2 = exp_sel[1][1];
+			SigBit T1 = exp_sel[0][0];
 
-			if (ok)
+			if (!nodecode || xcmp({S1, S2}))
 			{
 				newmux_t mux;
 
-				mux.inputs.push_back(A);
-				mux.inputs.push_back(B);
-				mux.inputs.push_back(C);
-				mux.inputs.push_back(D);
+				for (int i = 0; i < 4; i++)
+					mux.inputs.push_back(exp_node[2][i]);
 
 				mux.cost += prepare_decode_mux(S1, S2, T1, bit);
 
@@ -329,45 +323,22 @@ struct MuxcoverWorker
 
 		// 8-Input MUX
 
-		if (use_mux8)
+		if (use_mux8 && root_is_mux && (!nopartial || complete[3]))
 		{
-			ok = ok && follow_muxtree(A, tree, bit, "AAA");
-			ok = ok && follow_muxtree(B, tree, bit, "AAB");
-			ok = ok && follow_muxtree(C, tree, bit, "ABA");
-			ok = ok && follow_muxtree(D, tree, bit, "ABB");
-			ok = ok && follow_muxtree(E, tree, bit, "BAA");
-			ok = ok && follow_muxtree(F, tree, bit, "BAB");
-			ok = ok && follow_muxtree(G, tree, bit, "BBA");
-			ok = ok && follow_muxtree(H, tree, bit, "BBB");
-
-			ok = ok && follow_muxtree(S1, tree, bit, "AAS");
-			ok = ok && follow_muxtree(S2, tree, bit, "ABS");
-			ok = ok && follow_muxtree(S3, tree, bit, "BAS");
-			ok = ok && follow_muxtree(S4, tree, bit, "BBS");
-
-			if (nodecode)
-				ok = ok && xcmp({S1, S2, S3, S4});
-
-			ok = ok && follow_muxtree(T1, tree, bit, "AS");
-			ok = ok && follow_muxtree(T2, tree, bit, "BS");
-
-			if (nodecode)
-				ok = ok && xcmp({T1, T2});
-
-			ok = ok && follow_muxtree(U1, tree, bit, "S");
-
-			if (ok)
+			SigBit S1 = exp_sel[2][0];
+			SigBit S2 = exp_sel[2][1];
+			SigBit S3 = exp_sel[2][2];
+			SigBit S4 = exp_sel[2][3];
+			SigBit T1 = exp_sel[1][0];
+			SigBit T2 = exp_sel[1][1];
+			SigBit U1 = exp_sel[0][0];
+
+			if (!nodecode || (xcmp({S1, S2, S3, S4}) && xcmp({T1, T2})))
 			{
 				newmux_t mux;
 
-				mux.inputs.push_back(A);
-				mux.inputs.push_back(B);
-				mux.inputs.push_back(C);
-				mux.inputs.push_back(D);
-				mux.inputs.push_back(E);
-				mux.inputs.push_back(F);
-				mux.inputs.push_back(G);
-				mux.inputs.push_back(H);
+				for (int i = 0; i < 8; i++)
+					mux.inputs.push_back(exp_node[3][i]);
 
 				mux.cost += prepare_decode_mux(S1, S2, T1, bit);
 				mux.cost += prepare_decode_mux(S3, S4, T2, bit);
@@ -394,73 +365,30 @@ struct MuxcoverWorker
 
 		// 16-Input MUX
 
-		if (use_mux16)
+		if (use_mux16 && root_is_mux && (!nopartial || complete[4]))
 		{
-			ok = ok && follow_muxtree(A, tree, bit, "AAAA");
-			ok = ok && follow_muxtree(B, tree, bit, "AAAB");
-			ok = ok && follow_muxtree(C, tree, bit, "AABA");
-			ok = ok && follow_muxtree(D, tree, bit, "AABB");
-			ok = ok && follow_muxtree(E, tree, bit, "ABAA");
-			ok = ok && follow_muxtree(F, tree, bit, "ABAB");
-			ok = ok && follow_muxtree(G, tree, bit, "ABBA");
-			ok = ok && follow_muxtree(H, tree, bit, "ABBB");
-			ok = ok && follow_muxtree(I, tree, bit, "BAAA");
-			ok = ok && follow_muxtree(J, tree, bit, "BAAB");
-			ok = ok && follow_muxtree(K, tree, bit, "BABA");
-			ok = ok && follow_muxtree(L, tree, bit, "BABB");
-			ok = ok && follow_muxtree(M, tree, bit, "BBAA");
-			ok = ok && follow_muxtree(N, tree, bit, "BBAB");
-			ok = ok && follow_muxtree(O, tree, bit, "BBBA");
-			ok = ok && follow_muxtree(P, tree, bit, "BBBB");
-
-			ok = ok && follow_muxtree(S1, tree, bit, "AAAS");
-			ok = ok && follow_muxtree(S2, tree, bit, "AABS");
-			ok = ok && follow_muxtree(S3, tree, bit, "ABAS");
-			ok = ok && follow_muxtree(S4, tree, bit, "ABBS");
-			ok = ok && follow_muxtree(S5, tree, bit, "BAAS");
-			ok = ok && follow_muxtree(S6, tree, bit, "BABS");
-			ok = ok && follow_muxtree(S7, tree, bit, "BBAS");
-			ok = ok && follow_muxtree(S8, tree, bit, "BBBS");
-
-			if (nodecode)
-				ok = ok && xcmp({S1, S2, S3, S4, S5, S6, S7, S8});
-
-			ok = ok && follow_muxtree(T1, tree, bit, "AAS");
-			ok = ok && follow_muxtree(T2, tree, bit, "ABS");
-			ok = ok && follow_muxtree(T3, tree, bit, "BAS");
-			ok = ok && follow_muxtree(T4, tree, bit, "BBS");
-
-			if (nodecode)
-				ok = ok && xcmp({T1, T2, T3, T4});
-
-			ok = ok && follow_muxtree(U1, tree, bit, "AS");
-			ok = ok && follow_muxtree(U2, tree, bit, "BS");
-
-			if (nodecode)
-				ok = ok && xcmp({U1, U2});
-
-			ok = ok && follow_muxtree(V1, tree, bit, "S");
-
-			if (ok)
+			SigBit S1 = exp_sel[3][0];
+			SigBit S2 = exp_sel[3][1];
+			SigBit S3 = exp_sel[3][2];
+			SigBit S4 = exp_sel[3][3];
+			SigBit S5 = exp_sel[3][4];
+			SigBit S6 = exp_sel[3][5];
+			SigBit S7 = exp_sel[3][6];
+			SigBit S8 = exp_sel[3][7];
+			SigBit T1 = exp_sel[2][0];
+			SigBit T2 = exp_sel[2][1];
+			SigBit T3 = exp_sel[2][2];
+			SigBit T4 = exp_sel[2][3];
+			SigBit U1 = exp_sel[1][0];
+			SigBit U2 = exp_sel[1][1];
+			SigBit V1 = exp_sel[0][0];
+
+			if (!nodecode || (xcmp({S1, S2, S3, S4, S5, S6, S7, S8}) && xcmp({T1, T2, T3, T4}) && xcmp({U1, U2})))
 			{
 				newmux_t mux;
 
-				mux.inputs.push_back(A);
-				mux.inputs.push_back(B);
-				mux.inputs.push_back(C);
-				mux.inputs.push_back(D);
-				mux.inputs.push_back(E);
-				mux.inputs.push_back(F);
-				mux.inputs.push_back(G);
-				mux.inputs.push_back(H);
-				mux.inputs.push_back(I);
-				mux.inputs.push_back(J);
-				mux.inputs.push_back(K);
-				mux.inputs.push_back(L);
-				mux.inputs.push_back(M);
-				mux.inputs.push_back(N);
-				mux.inputs.push_back(O);
-				mux.inputs.push_back(P);
+				for (int i = 0; i < 16; i++)
+					mux.inputs.push_back(exp_node[4][i]);
 
 				mux.cost += prepare_decode_mux(S1, S2, T1, bit);
 				mux.cost += prepare_decode_mux(S3, S4, T2, bit);
@@ -602,16 +530,34 @@ struct MuxcoverWorker
 
 		log("  Covering trees:\n");
 
+		// Each treecover() call is a complete local rewrite of one tree, so
+		// when the time budget runs out the remaining trees are simply left
+		// as $_MUX_ cells and everything covered so far is kept.
+		auto out_of_time = [&]() {
+			return abort_time_ns != 0 && PerformanceTimer::query() > abort_time_ns;
+		};
+
 		if (!nodecode) {
 			log_debug("    Populating cache of decoder muxes.\n");
 			for (auto &tree : tree_list) {
+				if (out_of_time())
+					break;
 				find_best_cover(tree, tree.root);
 				tree.newmuxes.clear();
 			}
 		}
 
-		for (auto &tree : tree_list)
+		int skipped_trees = 0;
+		for (auto &tree : tree_list) {
+			if (out_of_time()) {
+				skipped_trees++;
+				continue;
+			}
 			treecover(tree);
+		}
+
+		if (skipped_trees)
+			log("  Giving up (time budget exhausted): left %d trees uncovered.\n", skipped_trees);
 
 		if (!nodecode)
 			log("  Added a total of %d decoder MUXes.\n", decode_mux_counter);
@@ -652,6 +598,10 @@ struct MuxcoverPass : public Pass {
 		log("        Do not consider mappings that use $_MUX<N>_ to select from less\n");
 		log("        than <N> different signals.\n");
 		log("\n");
+		log("    -budget <seconds>\n");
+		log("        Stop covering after roughly the specified amount of CPU time. Trees\n");
+		log("        already covered are kept, the remaining trees are left untouched.\n");
+		log("\n");
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) override
 	{
@@ -662,6 +612,7 @@ struct MuxcoverPass : public Pass {
 		bool use_mux16 = false;
 		bool nodecode = false;
 		bool nopartial = false;
+		int budget = 0;
 		int cost_dmux = COST_DMUX;
 		int cost_mux2 = COST_MUX2;
 		int cost_mux4 = COST_MUX4;
@@ -712,6 +663,10 @@ struct MuxcoverPass : public Pass {
 				nopartial = true;
 				continue;
 			}
+			if (arg == "-budget" && argidx+1 < args.size()) {
+				budget = atoi(args[++argidx].c_str());
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
@@ -722,9 +677,13 @@ struct MuxcoverPass : public Pass {
 			use_mux16 = true;
 		}
 
+		// one deadline for the whole pass execution, shared by all modules
+		int64_t abort_time_ns = budget ? PerformanceTimer::query() + budget * int64_t(1000000000) : 0;
+
 		for (auto module : design->selected_modules())
 		{
 			MuxcoverWorker worker(module);
+			worker.abort_time_ns = abort_time_ns;
 			worker.use_mux4 = use_mux4;
 			worker.use_mux8 = use_mux8;
 			worker.use_mux16 = use_mux16;
@@ -0,0 +1,450 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+// Greedy levelized K-LUT mapper. Unlike `flowmap`, which computes a depth
+// optimal mapping via repeated max-flow computations, this pass keeps exactly
+// one cut per node and grows it greedily: starting from the gate fan-ins, the
+// deepest leaves are repeatedly replaced by their own cut leaves while the
+// result stays K-feasible. The mapping is a few percent worse in depth but
+// orders of magnitude faster, which makes it suitable for quick QoR estimates
+// in architecture exploration loops where `flowmap` or `abc` dominate the
+// runtime.
+//
+// Nodes are wire bits (one graph node per driven output bit, exactly as in
+// `flowmap`). Nodes of the same logic level have independent cuts, so each
+// level is processed as one parallel wave on the worker pool. Every cut also
+// carries a 64-bit signature (one hash-selected bit per leaf); the popcount of
+// OR-ed signatures is a lower bound on the size of the corresponding leaf
+// union, so most infeasible merges are rejected without materializing the
+// union.
+
+#include "kernel/yosys.h"
+#include "kernel/sigtools.h"
+#include "kernel/modtools.h"
+#include "kernel/consteval.h"
+
+#include <bitset>
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+struct QuickmapWorker
+{
+	int order;
+	RTLIL::Module *module;
+	SigMap sigmap;
+	ModIndex index;
+
+	dict<RTLIL::SigBit, ModIndex::PortInfo> node_origins;
+
+	// Gate graph. Nodes are numbered densely; inputs (bits not driven by a
+	// mapped cell) get empty fan-in lists and depth 0.
+	std::vector<RTLIL::SigBit> node_bits;
+	dict<RTLIL::SigBit, int> node_ids;
+	std::vector<std::vector<int>> fanins;
+	std::vector<bool> node_is_input;
+	pool<int> output_nodes;
+
+	// The one cut kept per node. `depth` is the number of LUT levels below
+	// and including the LUT rooted at the node; inputs have depth 0.
+	struct Cut {
+		std::vector<int> leaves;
+		uint64_t sig = 0;
+		int depth = 0;
+	};
+	std::vector<Cut> cuts;
+
+	int gate_count = 0, lut_count = 0, packed_count = 0;
+	int gate_area = 0, lut_area = 0, depth = 0;
+
+	static uint64_t leaf_sig(int node)
+	{
+		return uint64_t(1) << ((unsigned(node) * 2654435761u) >> 26);
+	}
+
+	void discover_nodes(pool<IdString> cell_types)
+	{
+		std::vector<std::pair<int, pool<RTLIL::SigBit>>> fanin_bits;
+
+		for (auto cell : module->selected_cells())
+		{
+			if (!cell_types[cell->type])
+				continue;
+
+			if (!cell->known())
+				log_error("Cell %s (%s.%s) is unknown.\n", cell->type.c_str(), log_id(module), log_id(cell));
+
+			pool<RTLIL::SigBit> cell_fanout, cell_fanin;
+			for (auto conn : cell->connections())
+			{
+				if (!cell->output(conn.first)) continue;
+				int offset = -1;
+				for (auto bit : conn.second)
+				{
+					offset++;
+					if (!bit.wire) continue;
+					auto mapped_bit = sigmap(bit);
+					if (node_ids.count(mapped_bit))
+						log_error("Multiple drivers found for wire %s.\n", log_signal(mapped_bit));
+					node_ids[mapped_bit] = GetSize(node_bits);
+					node_bits.push_back(mapped_bit);
+					node_origins[mapped_bit] = ModIndex::PortInfo(cell, conn.first, offset);
+					cell_fanout.insert(mapped_bit);
+				}
+			}
+
+			for (auto conn : cell->connections())
+			{
+				if (!cell->input(conn.first)) continue;
+				for (auto bit : sigmap(conn.second))
+					if (bit.wire)
+						cell_fanin.insert(bit);
+			}
+
+			if (GetSize(cell_fanin) > order)
+				log_error("Cell %s (%s.%s) with fan-in %d cannot be mapped to a %d-LUT.\n",
+				          cell->type.c_str(), log_id(module), log_id(cell), GetSize(cell_fanin), order);
+
+			for (auto bit : cell_fanout)
+				fanin_bits.push_back({node_ids.at(bit), cell_fanin});
+
+			gate_count++;
+			gate_area += 1 << GetSize(cell_fanin);
+		}
+
+		// Bits read by mapped cells but not driven by one become inputs.
+		for (auto &entry : fanin_bits)
+			for (auto bit : entry.second)
+				if (!node_ids.count(bit)) {
+					node_ids[bit] = GetSize(node_bits);
+					node_bits.push_back(bit);
+				}
+
+		fanins.resize(GetSize(node_bits));
+		node_is_input.resize(GetSize(node_bits), true);
+		for (auto &entry : fanin_bits) {
+			node_is_input[entry.first] = false;
+			for (auto bit : entry.second)
+				fanins[entry.first].push_back(node_ids.at(bit));
+		}
+
+		// Outputs are nodes consumed by the outside world: module output
+		// ports and ports of cells that are not being mapped.
+		for (auto &it : node_ids)
+		{
+			if (node_is_input[it.second])
+				continue;
+			auto node_info = index.query(it.first);
+			if (node_info->is_output)
+				output_nodes.insert(it.second);
+			for (auto port : node_info->ports)
+				if (!cell_types[port.cell->type])
+					output_nodes.insert(it.second);
+		}
+	}
+
+	// Kahn-style levelization: wave n holds all nodes at logic level n+1.
+	std::vector<std::vector<int>> levelize()
+	{
+		std::vector<int> pending(GetSize(node_bits));
+		std::vector<std::vector<int>> fanouts(GetSize(node_bits));
+		std::vector<int> wave;
+
+		for (int node = 0; node < GetSize(node_bits); node++) {
+			for (int source : fanins[node])
+				fanouts[source].push_back(node);
+			pending[node] = GetSize(fanins[node]);
+			if (pending[node] == 0 && !node_is_input[node])
+				wave.push_back(node);
+		}
+
+		std::vector<std::vector<int>> waves;
+		int processed = 0;
+		for (int node = 0; node < GetSize(node_bits); node++)
+			if (node_is_input[node]) {
+				processed++;
+				for (int sink : fanouts[node])
+					if (--pending[sink] == 0)
+						wave.push_back(sink);
+			}
+
+		while (!wave.empty()) {
+			processed += GetSize(wave);
+			std::vector<int> next_wave;
+			for (int node : wave)
+				for (int sink : fanouts[node])
+					if (--pending[sink] == 0)
+						next_wave.push_back(sink);
+			waves.push_back(std::move(wave));
+			wave = std::move(next_wave);
+		}
+
+		if (processed != GetSize(node_bits))
+			log_error("Found combinational loop in module %s.\n", log_id(module));
+
+		return waves;
+	}
+
+	void compute_cut(int node)
+	{
+		Cut cut;
+
+		// Trivial cut: the gate fan-ins themselves.
+		pool<int> leaves(fanins[node].begin(), fanins[node].end());
+
+		while (1)
+		{
+			int max_depth = 0;
+			for (int leaf : leaves)
+				max_depth = max(max_depth, cuts[leaf].depth);
+
+			if (max_depth == 0)
+				break;
+
+			// Depth only improves if every critical leaf is replaced by
+			// its own cut leaves at once. Critical leaves are never inputs,
+			// because inputs have depth 0.
+			pool<int> next_leaves;
+			uint64_t next_sig = 0;
+			for (int leaf : leaves)
+				if (cuts[leaf].depth < max_depth) {
+					next_leaves.insert(leaf);
+					next_sig |= leaf_sig(leaf);
+				} else {
+					next_sig |= cuts[leaf].sig;
+				}
+
+			if ((int)std::bitset<64>(next_sig).count() > order)
+				break;
+
+			for (int leaf : leaves)
+				if (cuts[leaf].depth == max_depth)
+					for (int sub_leaf : cuts[leaf].leaves)
+						next_leaves.insert(sub_leaf);
+
+			if (GetSize(next_leaves) > order)
+				break;
+
+			leaves = std::move(next_leaves);
+		}
+
+		cut.leaves.assign(leaves.begin(), leaves.end());
+		std::sort(cut.leaves.begin(), cut.leaves.end());
+		for (int leaf : cut.leaves) {
+			cut.sig |= leaf_sig(leaf);
+			cut.depth = max(cut.depth, cuts[leaf].depth);
+		}
+		cut.depth++;
+
+		cuts[node] = std::move(cut);
+	}
+
+	void compute_cuts()
+	{
+		cuts.resize(GetSize(node_bits));
+		auto waves = levelize();
+
+		// Cuts within one wave only depend on earlier waves, so every wave
+		// is one parallel batch. Workers write only their own slot in
+		// `cuts` and read shared data computed before the batch started.
+		for (auto &wave : waves)
+			ThreadPool::get().parallel_for(GetSize(wave), [&](int i) { compute_cut(wave[i]); });
+	}
+
+	void pack_cells(int minlut)
+	{
+		std::vector<bool> realized(GetSize(node_bits), false);
+		std::vector<int> realize_list, worklist(output_nodes.begin(), output_nodes.end());
+		while (!worklist.empty()) {
+			int node = worklist.back();
+			worklist.pop_back();
+			if (realized[node] || node_is_input[node])
+				continue;
+			realized[node] = true;
+			realize_list.push_back(node);
+			for (int leaf : cuts[node].leaves)
+				worklist.push_back(leaf);
+		}
+		std::sort(realize_list.begin(), realize_list.end());
+
+		ConstEval ce(module);
+		ce.eval_cache_enabled = true;
+		for (int node = 0; node < GetSize(node_bits); node++)
+			if (node_is_input[node])
+				ce.stop(node_bits[node]);
+
+		for (int node : realize_list)
+		{
+			std::vector<RTLIL::SigBit> input_nodes;
+			for (int leaf : cuts[node].leaves)
+				input_nodes.push_back(node_bits[leaf]);
+
+			RTLIL::Const lut_table(State::Sx, max(1 << input_nodes.size(), 1 << minlut));
+			unsigned const mask = 1 << input_nodes.size();
+			for (unsigned i = 0; i < mask; i++)
+			{
+				ce.push();
+				for (size_t n = 0; n < input_nodes.size(); n++)
+					ce.set(input_nodes[n], ((i >> n) & 1) ? State::S1 : State::S0);
+
+				RTLIL::SigSpec value = node_bits[node], undef;
+				if (!ce.eval(value, undef))
+					log_error("Cannot evaluate %s because %s is not defined.\n",
+					          log_signal(node_bits[node]), log_signal(undef));
+
+				lut_table[i] = value.as_bool() ? State::S1 : State::S0;
+				ce.pop();
+			}
+
+			RTLIL::SigSpec lut_a, lut_y = node_bits[node];
+			for (auto input_node : input_nodes)
+				lut_a.append(input_node);
+			if ((int)input_nodes.size() < minlut)
+				lut_a.append(RTLIL::Const(State::Sx, minlut - input_nodes.size()));
+
+			RTLIL::Cell *lut = module->addLut(NEW_ID, lut_a, lut_y, lut_table);
+			auto origin = node_origins[node_bits[node]];
+			lut->add_strpool_attribute(ID::src, origin.cell->get_strpool_attribute(ID::src));
+
+			lut_count++;
+			lut_area += lut_table.size();
+			depth = max(depth, cuts[node].depth);
+		}
+
+		// Detach the original drivers of realized nodes; the remaining gate
+		// network dangles and is removed by a later `clean`.
+		for (int node : realize_list)
+		{
+			auto origin = node_origins[node_bits[node]];
+			RTLIL::SigSpec driver = origin.cell->getPort(origin.port);
+			driver[origin.offset] = module->addWire(NEW_ID);
+			origin.cell->setPort(origin.port, driver);
+			packed_count++;
+		}
+	}
+
+	QuickmapWorker(int order, int minlut, pool<IdString> cell_types, RTLIL::Module *module) :
+		order(order), module(module), sigmap(module), index(module)
+	{
+		discover_nodes(cell_types);
+		if (gate_count == 0)
+			return;
+		compute_cuts();
+		pack_cells(minlut);
+		log("Mapped %d gates in module %s to %d LUTs (depth %d).\n",
+		    gate_count, log_id(module), lut_count, depth);
+	}
+};
+
+static void split(std::vector<std::string> &tokens, const std::string &text, char sep)
+{
+	size_t start = 0, end = 0;
+	while ((end = text.find(sep, start)) != std::string::npos) {
+		tokens.push_back(text.substr(start, end - start));
+		start = end + 1;
+	}
+	tokens.push_back(text.substr(start));
+}
+
+struct QuickmapPass : public Pass {
+	QuickmapPass() : Pass("quickmap", "pack LUTs with a greedy levelized mapper") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    quickmap [options] [selection]\n");
+		log("\n");
+		log("This pass packs logic gates into k-LUTs with a greedy levelized mapper. It\n");
+		log("keeps a single cut per node and therefore runs much faster than `flowmap`, at\n");
+		log("the cost of a slightly deeper mapping. It is intended for quick quality-of-\n");
+		log("results estimates, not for production mapping.\n");
+		log("\n");
+		log("    -maxlut k\n");
+		log("        perform technology mapping for a k-LUT architecture. if not specified,\n");
+		log("        defaults to 3.\n");
+		log("\n");
+		log("    -minlut n\n");
+		log("        only produce n-input or larger LUTs. if not specified, defaults to 1.\n");
+		log("\n");
+		log("    -cells <cell>[,<cell>,...]\n");
+		log("        map specified cells. if not specified, maps $_NOT_, $_AND_, $_OR_,\n");
+		log("        $_XOR_ and $_MUX_, which are the outputs of the `simplemap` pass.\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		int order = 3;
+		int minlut = 1;
+		vector<string> cells;
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++)
+		{
+			if (args[argidx] == "-maxlut" && argidx + 1 < args.size())
+			{
+				order = atoi(args[++argidx].c_str());
+				continue;
+			}
+			if (args[argidx] == "-minlut" && argidx + 1 < args.size())
+			{
+				minlut = atoi(args[++argidx].c_str());
+				continue;
+			}
+			if (args[argidx] == "-cells" && argidx + 1 < args.size())
+			{
+				split(cells, args[++argidx], ',');
+				continue;
+			}
+			break;
+		}
+		extra_args(args, argidx, design);
+
+		pool<IdString> cell_types;
+		if (!cells.empty())
+		{
+			for (auto &cell : cells)
+				cell_types.insert(cell);
+		}
+		else
+		{
+			cell_types = {ID($_NOT_), ID($_AND_), ID($_OR_), ID($_XOR_), ID($_MUX_)};
+		}
+
+		log_header(design, "Executing QUICKMAP pass (pack LUTs with a greedy levelized mapper).\n");
+
+		int gate_count = 0, lut_count = 0, packed_count = 0;
+		int gate_area = 0, lut_area = 0;
+		for (auto module : design->selected_modules())
+		{
+			QuickmapWorker worker(order, minlut, cell_types, module);
+			gate_count += worker.gate_count;
+			lut_count += worker.lut_count;
+			packed_count += worker.packed_count;
+			gate_area += worker.gate_area;
+			lut_area += worker.lut_area;
+		}
+
+		log("\n");
+		log("Packed %d cells into %d LUTs.\n", packed_count, lut_count);
+		if (gate_area > 0)
+			log("Solution takes %.1f%% of original gate area.\n", lut_area * 100.0 / gate_area);
+	}
+} QuickmapPass;
+
+PRIVATE_NAMESPACE_END
@@ -67,6 +67,7 @@ struct TechmapWorker
 	dict<RTLIL::Module*, bool> techmap_do_cache;
 	pool<RTLIL::Module*> module_queue;
 	dict<Module*, SigMap> sigmaps;
+	FfInitValsCache initvals_cache;
 
 	pool<string> log_msg_cache;
 
@@ -83,6 +84,71 @@ struct TechmapWorker
 	bool autoproc_mode = false;
 	bool ignore_wb = false;
 
+	// Per-invocation cell-type dispatch acceleration. The bitmap holds one
+	// bit per IdString ordinal for "some template may match this type", so
+	// skipping an unmappable cell costs a single bit-test; the cache keeps
+	// the resolved template info per (type, in_recursion), so the celltype
+	// map and the template port directions are consulted once per distinct
+	// type over the whole invocation instead of once per cell per pass.
+	struct tpl_info_t {
+		IdString name;
+		RTLIL::Module *tpl;
+		dict<IdString, std::pair<bool, bool>> port_dirs; // port name -> (input, output)
+	};
+	std::vector<bool> mappable_celltypes;
+	dict<IdString, std::vector<tpl_info_t>> tpl_info_cache[2]; // indexed by in_recursion
+
+	void build_celltype_bitmap(const dict<IdString, pool<IdString>> &celltypeMap)
+	{
+		mappable_celltypes.clear();
+		auto set_bit = [this](IdString id) {
+			unsigned int idx = id.index_;
+			if (idx >= mappable_celltypes.size())
+				mappable_celltypes.resize(idx+1);
+			mappable_celltypes[idx] = true;
+		};
+		for (auto &it : celltypeMap) {
+			set_bit(it.first);
+			// in recursive mapping the leading backslash of escaped
+			// internal cell types is stripped before the map lookup
+			if (it.first.begins_with("$"))
+				set_bit(IdString(std::string("\\") + it.first.str()));
+		}
+	}
+
+	bool celltype_maybe_mapped(IdString type) const
+	{
+		unsigned int idx = type.index_;
+		return idx < mappable_celltypes.size() && mappable_celltypes[idx];
+	}
+
+	const std::vector<tpl_info_t> &lookup_templates(RTLIL::Design *map, const dict<IdString, pool<IdString>> &celltypeMap,
+			IdString type, bool in_recursion)
+	{
+		dict<IdString, std::vector<tpl_info_t>> &cache = tpl_info_cache[in_recursion ? 1 : 0];
+		auto cache_it = cache.find(type);
+		if (cache_it != cache.end())
+			return cache_it->second;
+
+		IdString key = type;
+		if (in_recursion && type.begins_with("\\$"))
+			key = type.str().substr(1);
+
+		std::vector<tpl_info_t> &infos = cache[type];
+		auto map_it = celltypeMap.find(key);
+		if (map_it != celltypeMap.end())
+			for (auto &tpl_name : map_it->second) {
+				tpl_info_t info;
+				info.name = tpl_name;
+				info.tpl = map->module(tpl_name);
+				for (auto tpl_w : info.tpl->wires())
+					if (tpl_w->port_input || tpl_w->port_output)
+						info.port_dirs[tpl_w->name] = std::make_pair(tpl_w->port_input, tpl_w->port_output);
+				infos.push_back(std::move(info));
+			}
+		return infos;
+	}
+
 	std::string constmap_tpl_name(SigMap &sigmap, RTLIL::Module *tpl, RTLIL::Cell *cell, bool verbose)
 	{
 		std::string constmap_info;
@@ -425,7 +491,8 @@ struct TechmapWorker
 		LogMakeDebugHdl mkdebug;
 
 		SigMap sigmap(module);
-		FfInitVals initvals(&sigmap, module);
+		FfInitVals initvals;
+		initvals.set(&sigmap, module, &initvals_cache);
 
 		TopoSort<RTLIL::Cell*, IdString::compare_ptr_by_name<RTLIL::Cell>> cells;
 		dict<RTLIL::Cell*, pool<RTLIL::SigBit>> cell_to_inbit;
@@ -436,13 +503,20 @@ struct TechmapWorker
 			if (handled_cells.count(cell) > 0)
 				continue;
 
-			std::string cell_type = cell->type.str();
-			if (in_recursion && cell->type.begins_with("\\$"))
-				cell_type = cell_type.substr(1);
+			// cheap early-out for the (typically dominant) share of cells
+			// whose type no template can ever match
+			if (!assert_mode && !celltype_maybe_mapped(cell->type))
+				continue;
 
-			if (celltypeMap.count(cell_type) == 0) {
-				if (assert_mode && cell_type.back() != '_')
-					log_error("(ASSERT MODE) No matching template cell for type %s found.\n", log_id(cell_type));
+			auto &tpls = lookup_templates(map, celltypeMap, cell->type, in_recursion);
+			if (tpls.empty()) {
+				if (assert_mode) {
+					std::string cell_type = cell->type.str();
+					if (in_recursion && cell->type.begins_with("\\$"))
+						cell_type = cell_type.substr(1);
+					if (cell_type.back() != '_')
+						log_error("(ASSERT MODE) No matching template cell for type %s found.\n", log_id(cell_type));
+				}
 				continue;
 			}
 
@@ -454,12 +528,13 @@ struct TechmapWorker
 				if (GetSize(sig) == 0)
 					continue;
 
-				for (auto &tpl_name : celltypeMap.at(cell_type)) {
-					RTLIL::Module *tpl = map->module(tpl_name);
-					RTLIL::Wire *port = tpl->wire(conn.first);
-					if (port && port->port_input)
+				for (auto &ti : tpls) {
+					auto port_it = ti.port_dirs.find(conn.first);
+					if (port_it == ti.port_dirs.end())
+						continue;
+					if (port_it->second.first)
 						cell_to_inbit[cell].insert(sig.begin(), sig.end());
-					if (port && port->port_output)
+					if (port_it->second.second)
 						for (auto &bit : sig)
 							outbit_to_cell[bit].insert(cell);
 				}
@@ -486,10 +561,11 @@ struct TechmapWorker
 			if (in_recursion && cell->type.begins_with("\\$"))
 				cell_type = cell_type.substr(1);
 
-			for (auto &tpl_name : celltypeMap.at(cell_type))
+			for (auto &ti : lookup_templates(map, celltypeMap, cell->type, in_recursion))
 			{
+				IdString tpl_name = ti.name;
 				IdString derived_name = tpl_name;
-				RTLIL::Module *tpl = map->module(tpl_name);
+				RTLIL::Module *tpl = ti.tpl;
 				dict<IdString, RTLIL::Const> parameters(cell->parameters);
 
 				if (tpl->get_blackbox_attribute(ignore_wb))
@@ -999,6 +1075,13 @@ struct TechmapPass : public Pass {
 		log("    -map %%<design-name>\n");
 		log("        like -map above, but with an in-memory design instead of a file.\n");
 		log("\n");
+		log("    -dump_map filename\n");
+		log("        write the fully loaded map library, including all templates derived\n");
+		log("        for particular parameter values during this run, to the given RTLIL\n");
+		log("        file. Passing that file to '-map' in a later run skips the Verilog\n");
+		log("        frontend and reuses the derived templates instead of deriving them\n");
+		log("        again.\n");
+		log("\n");
 		log("    -extern\n");
 		log("        load the cell implementations as separate modules into the design\n");
 		log("        instead of inlining them.\n");
@@ -1160,6 +1243,7 @@ struct TechmapPass : public Pass {
 
 		std::vector<std::string> map_files;
 		std::string verilog_frontend = "verilog -nooverwrite -noblackbox";
+		std::string dump_map_file;
 		int max_iter = -1;
 
 		size_t argidx;
@@ -1168,6 +1252,10 @@ struct TechmapPass : public Pass {
 				map_files.push_back(args[++argidx]);
 				continue;
 			}
+			if (args[argidx] == "-dump_map" && argidx+1 < args.size()) {
+				dump_map_file = args[++argidx];
+				continue;
+			}
 			if (args[argidx] == "-max_iter" && argidx+1 < args.size()) {
 				max_iter = atoi(args[++argidx].c_str());
 				continue;
@@ -1266,6 +1354,8 @@ struct TechmapPass : public Pass {
 		}
 		log_debug("\n");
 
+		worker.build_celltype_bitmap(celltypeMap);
+
 		for (auto module : design->modules())
 			worker.module_queue.insert(module);
 
@@ -1289,6 +1379,17 @@ struct TechmapPass : public Pass {
 		}
 
 		log("No more expansions possible.\n");
+
+		// The map design now also contains the modules that were derived for
+		// particular parameter values (and CONSTMAP specializations) during
+		// this run.  Dumping it lets later runs start from the precompiled
+		// library: derive() and the constmap lookup find the existing modules
+		// by name and skip the elaboration work.
+		if (!dump_map_file.empty()) {
+			log_header(design, "Dumping techmap map library to `%s'.\n", dump_map_file.c_str());
+			Backend::backend_call(map, nullptr, dump_map_file, "rtlil");
+		}
+
 		delete map;
 
 		log_pop();
@@ -30,7 +30,11 @@ USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
 static int bloat_factor = 1;
-static uint32_t xorshift32_state = 123456789;
+
+// Thread-local so every test iteration can run on its own RNG stream: the
+// main thread draws one seed per iteration from the -s sequence, and each
+// iteration (possibly on a pool worker) reseeds its own state from that.
+static thread_local uint32_t xorshift32_state = 123456789;
 
 static uint32_t xorshift32(uint32_t limit) {
 	xorshift32_state ^= xorshift32_state << 13;
@@ -717,6 +721,10 @@ struct TestCellPass : public Pass {
 		log("Run with 'all' instead of a cell type to run the test on all supported\n");
 		log("cell types. Use for example 'all /$add' for all cell types except $add.\n");
 		log("\n");
+		log("In builds with thread-safe IdStrings the test iterations are distributed\n");
+		log("over the worker pool. Each iteration runs on its own rng stream derived\n");
+		log("from the seed, so results are reproducible either way.\n");
+		log("\n");
 		log("    -n {integer}\n");
 		log("        create this number of cell instances and test them (default = 100).\n");
 		log("\n");
@@ -990,6 +998,11 @@ struct TestCellPass : public Pass {
 
 		std::vector<std::string> uut_names;
 
+		// The techmap pass reloads its map library through the Verilog (or
+		// RTLIL) frontend on every call, and the frontends keep global parser
+		// state, so map loading may not overlap between pool workers.
+		std::mutex techmap_mutex, result_mutex;
+
 		for (auto cell_type : selected_cell_types) {
 			// Cells that failed cell cost check
 			int failed = 0;
@@ -997,8 +1010,18 @@ struct TestCellPass : public Pass {
 			int worst_abs = 0;
 			// How many times is it bigger than estimated?
 			float worst_rel = 0.0;
+
+			// One seed per iteration, drawn up front from the -s sequence: a
+			// failing test case is reproducible from the seed and the
+			// iteration index alone, independent of how iterations are
+			// scheduled over the worker pool.
+			std::vector<uint32_t> iter_seeds(num_iter);
 			for (int i = 0; i < num_iter; i++)
+				iter_seeds[i] = xorshift32(0x7fffffff) + 1;
+
+			auto run_single_test = [&](int i)
 			{
+				xorshift32_state = iter_seeds[i];
 				Cell* uut = nullptr;
 				RTLIL::Design *design = new RTLIL::Design;
 				if (cell_type == ID(rtlil))
@@ -1011,7 +1034,10 @@ struct TestCellPass : public Pass {
 					Pass::call(design, "dump gold");
 					run_edges_test(design, verbose);
 				} else {
-					Pass::call(design, stringf("copy gold gate; cd gate; %s; cd ..", techmap_cmd.c_str()));
+					{
+						std::lock_guard<std::mutex> lock(techmap_mutex);
+						Pass::call(design, stringf("copy gold gate; cd gate; %s; cd ..", techmap_cmd.c_str()));
+					}
 					if (!noopt)
 						Pass::call(design, "opt -fast gate");
 					if (!nosat)
@@ -1050,6 +1076,7 @@ struct TestCellPass : public Pass {
 							if (num_cells <= num_cells_estimate) {
 								log_debug("Correct upper bound for %s: %d <= %d\n", cell_type.c_str(), num_cells, num_cells_estimate);
 							} else {
+								std::lock_guard<std::mutex> lock(result_mutex);
 								failed++;
 								if (worst_abs < num_cells - num_cells_estimate) {
 									worst_abs = num_cells - num_cells_estimate;
@@ -1061,7 +1088,39 @@ struct TestCellPass : public Pass {
 					}
 				}
 				delete design;
+			};
+
+			// Iterations are independent once each one runs on its own RNG
+			// stream, so with thread-safe IdStrings the soak can use the
+			// worker pool. The shared -vlog stream, the single-threaded
+			// RTLIL frontend (-f) and the -w file writer stay serial; worker
+			// log output is captured and replayed in iteration order.
+			bool use_pool = false;
+#ifdef YOSYS_THREADSAFE_IDS
+			use_pool = !vlog_file.is_open() && rtlil_file.empty() && write_prefix.empty() &&
+					num_iter > 1 && ThreadPool::get().num_threads() > 1;
+#endif
+
+			if (use_pool) {
+				std::vector<std::string> captured_logs(num_iter);
+				ThreadPool::get().parallel_for(num_iter, [&](int i) {
+					log_capture_begin(&captured_logs[i]);
+					try {
+						run_single_test(i);
+					} catch (...) {
+						log_capture_end();
+						throw;
+					}
+					log_capture_end();
+				});
+				for (auto &text : captured_logs)
+					if (!text.empty())
+						log("%s", text.c_str());
+			} else {
+				for (int i = 0; i < num_iter; i++)
+					run_single_test(i);
 			}
+
 			if (check_cost && failed) {
 				log_warning("Cell type %s cost underestimated in %.1f%% cases "
 					    "with worst offender being by %d (%.1f%%)\n",
@@ -0,0 +1,165 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2012  Claire Xenia Wolf <claire@yosyshq.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/register.h"
+#include "kernel/rtlil.h"
+#include "kernel/log.h"
+#include "backends/rtlil/rtlil_backend.h"
+#include "libs/sha1/sha1.h"
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+struct SynthIncrPass : public Pass {
+	SynthIncrPass() : Pass("synth_incr", "incremental generic synthesis with module cache") {}
+
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    synth_incr [-cachedir <dir>] [synth options]\n");
+		log("\n");
+		log("This command runs the 'synth' script, but skips modules that are unchanged\n");
+		log("since an earlier run. Before synthesis every module is hashed (the hash covers\n");
+		log("the module contents, the hashes of all instantiated modules, and the synth\n");
+		log("options). Modules whose hash is found in the cache directory are spliced from\n");
+		log("their cached binary RTLIL netlist and hidden from the synthesis script;\n");
+		log("everything else is synthesized normally and its result added to the cache.\n");
+		log("\n");
+		log("    -cachedir <dir>\n");
+		log("        use the specified cache directory (default='synth_incr.cache').\n");
+		log("        the directory is created if it does not exist.\n");
+		log("\n");
+		log("All other options are passed to 'synth' unchanged, except that '-flatten' is\n");
+		log("not supported (cached modules are hidden during synthesis and would not get\n");
+		log("flattened into their parents).\n");
+		log("\n");
+		log("Like 'synth', this command only operates on fully selected designs.\n");
+		log("\n");
+	}
+
+	dict<RTLIL::IdString, std::string> digests;
+
+	// The digest covers the textual RTLIL dump of the module, the digests of
+	// all modules it instantiates, and the synth command line, so a change
+	// anywhere below a module (or in the requested flow) invalidates it.
+	const std::string &module_digest(RTLIL::Design *design, RTLIL::Module *module, const std::string &synth_cmd)
+	{
+		auto it = digests.find(module->name);
+		if (it != digests.end())
+			return it->second;
+
+		// break recursive instantiation cycles (hierarchy rejects those
+		// later, but don't hang on them here)
+		digests[module->name] = std::string();
+
+		std::set<std::string> submod_digests;
+		for (auto cell : module->cells()) {
+			RTLIL::Module *submod = design->module(cell->type);
+			if (submod != nullptr && submod != module)
+				submod_digests.insert(cell->type.str() + "=" + module_digest(design, submod, synth_cmd));
+		}
+
+		std::ostringstream buf;
+		RTLIL_BACKEND::dump_module(buf, "", module, design, false);
+		buf << synth_cmd << "\n";
+		for (auto &entry : submod_digests)
+			buf << entry << "\n";
+
+		return digests[module->name] = sha1(buf.str());
+	}
+
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		std::string cachedir = "synth_incr.cache";
+		std::string synth_cmd = "synth";
+
+		for (size_t argidx = 1; argidx < args.size(); argidx++)
+		{
+			if (args[argidx] == "-cachedir" && argidx + 1 < args.size()) {
+				cachedir = args[++argidx];
+				continue;
+			}
+			if (args[argidx] == "-flatten")
+				log_cmd_error("Option -flatten is not supported by synth_incr.\n");
+			synth_cmd += " " + args[argidx];
+		}
+
+		if (!design->full_selection())
+			log_cmd_error("This command only operates on fully selected designs!\n");
+
+		log_header(design, "Executing SYNTH_INCR pass (incremental generic synthesis).\n");
+		log_push();
+
+		if (!check_directory_exists(cachedir) && !create_directory(cachedir))
+			log_error("Can't create cache directory `%s'.\n", cachedir.c_str());
+
+		digests.clear();
+		std::vector<RTLIL::IdString> cached_modules, changed_modules;
+		dict<RTLIL::IdString, std::string> cache_paths;
+
+		for (auto module : design->modules()) {
+			if (module->get_blackbox_attribute())
+				continue;
+			std::string path = cachedir + "/" + module_digest(design, module, synth_cmd) + ".bin";
+			cache_paths[module->name] = path;
+			if (check_file_exists(path))
+				cached_modules.push_back(module->name);
+			else
+				changed_modules.push_back(module->name);
+		}
+
+		// Splice cached netlists and hide them behind a temporary blackbox
+		// attribute, so the synthesis script below leaves them alone.
+		for (auto name : cached_modules) {
+			log("Splicing cached netlist for module %s.\n", log_id(name));
+			RTLIL::Design cache_design;
+			Frontend::frontend_call(&cache_design, nullptr, cache_paths.at(name), "read_rtlil_bin");
+			RTLIL::Module *cached = cache_design.module(name);
+			if (cached == nullptr)
+				log_error("Cache file `%s' does not contain module %s.\n", cache_paths.at(name).c_str(), log_id(name));
+			design->remove(design->module(name));
+			RTLIL::Module *spliced = cached->clone();
+			design->add(spliced);
+			spliced->set_bool_attribute(ID::blackbox);
+		}
+
+		if (changed_modules.empty())
+			log("All %d modules found in cache, skipping synthesis.\n", GetSize(cached_modules));
+		else
+			Pass::call(design, synth_cmd);
+
+		for (auto name : cached_modules)
+			design->module(name)->attributes.erase(ID::blackbox);
+
+		for (auto name : changed_modules) {
+			RTLIL::Module *module = design->module(name);
+			if (module == nullptr)
+				continue;
+			RTLIL::Design cache_design;
+			cache_design.add(module->clone());
+			Backend::backend_call(&cache_design, nullptr, cache_paths.at(name), "write_rtlil_bin");
+		}
+
+		log("Re-synthesized %d modules, spliced %d from cache.\n", GetSize(changed_modules), GetSize(cached_modules));
+		log_pop();
+	}
+} SynthIncrPass;
+
+PRIVATE_NAMESPACE_END
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "kernel/yosys.h"
+#include "kernel/hashlib.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+using hashlib::dict;
+using hashlib::pool;
+using hashlib::hashtable_linear_threshold;
+
+// insert count entries, then check that every one of them (and nothing
+// else) can be found; exercised below and above the linear-mode
+// threshold so both lookup paths are covered
+static void check_dict_of_size(int count)
+{
+	dict<int, int> d;
+	for (int i = 0; i < count; i++)
+		d[i * 7] = i;
+	ASSERT_EQ(GetSize(d), count);
+	for (int i = 0; i < count; i++) {
+		auto it = d.find(i * 7);
+		ASSERT_NE(it, d.end());
+		EXPECT_EQ(it->second, i);
+	}
+	EXPECT_EQ(d.count(-1), 0);
+	EXPECT_EQ(d.count(7 * count), 0);
+
+	int sum = 0;
+	for (auto &it : d)
+		sum += it.second;
+	EXPECT_EQ(sum, count * (count - 1) / 2);
+}
+
+TEST(HashlibTest, dictLinearAndHashedLookup)
+{
+	for (int count : {0, 1, hashtable_linear_threshold - 1, hashtable_linear_threshold,
+			hashtable_linear_threshold + 1, 100})
+		check_dict_of_size(count);
+}
+
+TEST(HashlibTest, dictGrowsAcrossThreshold)
+{
+	// a single container crossing the linear/hashed boundary keeps all
+	// of its entries
+	dict<int, std::string> d;
+	for (int i = 0; i < 4 * hashtable_linear_threshold; i++) {
+		d[i] = stringf("v%d", i);
+		for (int j = 0; j <= i; j++)
+			ASSERT_EQ(d.at(j), stringf("v%d", j)) << "after inserting " << i;
+	}
+}
+
+TEST(HashlibTest, dictEraseInLinearMode)
+{
+	dict<int, int> d;
+	for (int i = 0; i < hashtable_linear_threshold; i++)
+		d[i] = i;
+
+	// erase from the middle: linear mode compacts the entry array
+	EXPECT_EQ(d.erase(2), 1);
+	EXPECT_EQ(d.erase(2), 0);
+	ASSERT_EQ(GetSize(d), hashtable_linear_threshold - 1);
+	for (int i = 0; i < hashtable_linear_threshold; i++)
+		EXPECT_EQ(d.count(i), i == 2 ? 0 : 1);
+
+	while (!d.empty())
+		d.erase(d.begin()->first);
+	EXPECT_EQ(GetSize(d), 0);
+	d[42] = 1;
+	EXPECT_EQ(d.at(42), 1);
+}
+
+TEST(HashlibTest, dictEraseInHashedMode)
+{
+	dict<int, int> d;
+	for (int i = 0; i < 100; i++)
+		d[i] = i;
+	for (int i = 0; i < 100; i += 2)
+		EXPECT_EQ(d.erase(i), 1);
+	ASSERT_EQ(GetSize(d), 50);
+	for (int i = 0; i < 100; i++)
+		EXPECT_EQ(d.count(i), i % 2);
+}
+
+TEST(HashlibTest, dictCopiesKeepLinearContents)
+{
+	dict<int, int> small;
+	for (int i = 0; i < hashtable_linear_threshold / 2; i++)
+		small[i] = i * i;
+
+	dict<int, int> copy1(small);
+	dict<int, int> copy2;
+	copy2 = small;
+	small.clear();
+
+	for (int i = 0; i < hashtable_linear_threshold / 2; i++) {
+		EXPECT_EQ(copy1.at(i), i * i);
+		EXPECT_EQ(copy2.at(i), i * i);
+	}
+
+	// a copied-then-grown container must rebuild its table correctly
+	for (int i = 0; i < 100; i++)
+		copy1[1000 + i] = i;
+	for (int i = 0; i < hashtable_linear_threshold / 2; i++)
+		EXPECT_EQ(copy1.at(i), i * i);
+	for (int i = 0; i < 100; i++)
+		EXPECT_EQ(copy1.at(1000 + i), i);
+}
+
+TEST(HashlibTest, dictAssignSmallOverLarge)
+{
+	// assigning a linear-mode source over a container that already grew
+	// a hashtable must drop the old table, not follow its stale chains
+	dict<int, int> small;
+	for (int i = 0; i < 3; i++)
+		small[i] = i + 10;
+
+	dict<int, int> large;
+	for (int i = 0; i < 100; i++)
+		large[i * 3 + 1] = i;
+
+	large = small;
+	ASSERT_EQ(GetSize(large), 3);
+	for (int i = 0; i < 3; i++)
+		EXPECT_EQ(large.at(i), i + 10);
+	EXPECT_EQ(large.count(4), 0);
+
+	// and growing again afterwards rebuilds a correct table
+	for (int i = 0; i < 100; i++)
+		large[1000 + i] = i;
+	for (int i = 0; i < 3; i++)
+		EXPECT_EQ(large.at(i), i + 10);
+	for (int i = 0; i < 100; i++)
+		EXPECT_EQ(large.at(1000 + i), i);
+}
+
+TEST(HashlibTest, poolAssignSmallOverLarge)
+{
+	pool<int> small;
+	for (int i = 0; i < 3; i++)
+		small.insert(i);
+
+	pool<int> large;
+	for (int i = 0; i < 100; i++)
+		large.insert(i * 3 + 1);
+
+	large = small;
+	ASSERT_EQ(GetSize(large), 3);
+	for (int i = 0; i < 3; i++)
+		EXPECT_EQ(large.count(i), 1);
+	EXPECT_EQ(large.count(4), 0);
+}
+
+TEST(HashlibTest, poolLinearAndHashedModes)
+{
+	pool<int> p;
+	for (int i = 0; i < hashtable_linear_threshold; i++)
+		p.insert(i);
+	for (int i = 0; i < hashtable_linear_threshold; i++)
+		EXPECT_EQ(p.count(i), 1);
+	EXPECT_EQ(p.count(hashtable_linear_threshold), 0);
+
+	EXPECT_EQ(p.erase(1), 1);
+	EXPECT_EQ(p.count(1), 0);
+
+	for (int i = 0; i < 100; i++)
+		p.insert(1000 + i);
+	for (int i = 0; i < hashtable_linear_threshold; i++)
+		EXPECT_EQ(p.count(i), i == 1 ? 0 : 1);
+	for (int i = 0; i < 100; i++)
+		EXPECT_EQ(p.count(1000 + i), 1);
+}
+
+YOSYS_NAMESPACE_END
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "kernel/yosys.h"
+
+YOSYS_NAMESPACE_BEGIN
+
+// run fn(index) over count items and check every index was visited
+// exactly once, i.e. the self-scheduling chunking neither drops nor
+// duplicates work items
+static void check_full_coverage(int count)
+{
+	std::vector<std::atomic<int>> hits(count);
+	ThreadPool::get().parallel_for(count, [&](int index) {
+		hits[index]++;
+	});
+	for (int i = 0; i < count; i++)
+		EXPECT_EQ(hits[i].load(), 1) << "index " << i << " of " << count;
+}
+
+TEST(ThreadPoolTest, coversAllIndicesOnce)
+{
+	ThreadPool::set_num_threads(4);
+	for (int count : {0, 1, 2, 3, 7, 64, 1000, 100000})
+		check_full_coverage(count);
+}
+
+TEST(ThreadPoolTest, coversAllIndicesOnceSingleThreaded)
+{
+	ThreadPool::set_num_threads(1);
+	for (int count : {0, 1, 7, 1000})
+		check_full_coverage(count);
+	ThreadPool::set_num_threads(4);
+}
+
+TEST(ThreadPoolTest, nestedCallsRunSerially)
+{
+	std::vector<std::atomic<int>> hits(64 * 64);
+	ThreadPool::get().parallel_for(64, [&](int outer) {
+		ThreadPool::get().parallel_for(64, [&](int inner) {
+			hits[outer * 64 + inner]++;
+		});
+	});
+	for (int i = 0; i < 64 * 64; i++)
+		EXPECT_EQ(hits[i].load(), 1);
+}
+
+TEST(ThreadPoolTest, exceptionPropagatesToCaller)
+{
+	std::atomic<int> done(0);
+	EXPECT_THROW(
+		ThreadPool::get().parallel_for(1000, [&](int index) {
+			if (index == 500)
+				throw std::runtime_error("boom");
+			done++;
+		}),
+		std::runtime_error);
+
+	// remaining items may or may not have run, but the pool must still
+	// be fully usable afterwards
+	check_full_coverage(1000);
+}
+
+TEST(ThreadPoolTest, exceptionFromEveryItem)
+{
+	// many concurrent throws: exactly one exception reaches the caller
+	// and the workers return to an idle state
+	EXPECT_THROW(
+		ThreadPool::get().parallel_for(100, [&](int) {
+			throw std::runtime_error("boom");
+		}),
+		std::runtime_error);
+
+	check_full_coverage(100);
+
+	ThreadPool::destroy();
+}
+
+YOSYS_NAMESPACE_END